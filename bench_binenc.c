@@ -0,0 +1,158 @@
+/* bench_binenc.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program measures the speed of the Text-to-Binary transcoder. It
+** builds about 32 megabytes of DSD/Text the same way bench_textlex does and
+** transcodes it several times into a 64 kilobyte output buffer whose flush
+** callback just counts octets. It prints the throughput measured against
+** the size of the text.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_INPUT_SIZE  ( 32 * 1024 * 1024 )
+#define BENCH_CHUNK_SIZE  ( 64 * 1024 )
+#define BENCH_OUTPUT_SIZE ( 64 * 1024 )
+#define BENCH_PASSES      5
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "binenc.h"
+
+/* Function Prototypes */
+
+static unsigned char * load_input( char * path, size_t * length );
+static tTextLexErr flush_handler( tBinEncContext * context );
+
+/* Global Variables */
+
+static size_t flushed = 0;
+
+int main( int argc, char * argv [] ) {
+  unsigned char output[ BENCH_OUTPUT_SIZE ];
+  unsigned char * input;
+  size_t length, offset, chunk;
+  tBinEncContext encoder;
+  tTextBinContext transcoder;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  struct timespec start, stop;
+  double seconds;
+  unsigned int pass;
+  char * path = ( argc > 1 ) ? argv[ 1 ] : "example.dsd";
+
+  if( NULL == ( input = load_input( path, & length ) ) ) {
+    fprintf( stderr, "%%BENCH-F-INPUT; Can't read input from %s.\n", path );
+    return( 1 );
+  }
+
+  printf( "; BEGIN BENCHMARK %s (%zu octets)\n", path, length );
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( pass = 0; pass < BENCH_PASSES; pass++ ) {
+    flushed = 0;
+    binenc_init( & encoder, output, BENCH_OUTPUT_SIZE );
+    encoder.flush = flush_handler;
+
+    if( TEXTLEX_E_NOERR != ( err = textbin_init( & transcoder, & encoder ) ) ) {
+      break;
+    }
+
+    for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += chunk ) {
+      chunk = ( ( length - offset ) < BENCH_CHUNK_SIZE ) ? ( length - offset ) : BENCH_CHUNK_SIZE;
+      err = textbin_update( & transcoder, input + offset, chunk );
+    }
+
+    if( TEXTLEX_E_NOERR == err ) {
+      err = textbin_final( & transcoder );
+    } else {
+      textbin_final( & transcoder );
+    }
+
+    if( TEXTLEX_E_NOERR != err ) {
+      break;
+    }
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+
+  if( TEXTLEX_E_NOERR != err ) {
+    fprintf( stderr, "%%BENCH-F-UPDATE; Error %d at line %d, octet %d.\n", err, transcoder.text.line, transcoder.text.octet );
+    return( 2 );
+  }
+
+  seconds = ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9;
+
+  printf( "; TRANSCODE  %8.3f GB/s (%zu octets binary)\n", ( (double) length * BENCH_PASSES ) / seconds / 1e9, flushed );
+  printf( "; END BENCHMARK\n" );
+
+  free( input );
+
+  return( 0 );
+}
+
+static unsigned char * load_input( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * seed = NULL;
+  unsigned char * input = NULL;
+  size_t seed_length = 0;
+  size_t seed_size = 4096;
+  size_t bytes_read;
+
+  do {
+    if( NULL == ( file = fopen( path, "rb" ) ) ) {
+      break;
+    }
+
+    if( NULL == ( seed = malloc( seed_size ) ) ) {
+      break;
+    }
+
+    while( 0 != ( bytes_read = fread( seed + seed_length, 1, seed_size - seed_length, file ) ) ) {
+      seed_length += bytes_read;
+      if( seed_length == seed_size ) {
+        seed_size *= 2;
+        if( NULL == ( seed = realloc( seed, seed_size ) ) ) {
+          break;
+        }
+      }
+    }
+
+    if( ( NULL == seed ) || ( 0 == seed_length ) ) {
+      break;
+    }
+
+    if( NULL == ( input = malloc( BENCH_INPUT_SIZE + seed_length + 1 ) ) ) {
+      break;
+    }
+
+    for( * length = 0; * length < BENCH_INPUT_SIZE; * length += seed_length + 1 ) {
+      memcpy( input + * length, seed, seed_length );
+      input[ * length + seed_length ] = '\n';
+    }
+  } while( 0 );
+
+  if( NULL != file ) {
+    fclose( file );
+  }
+
+  if( NULL != seed ) {
+    free( seed );
+  }
+
+  return( input );
+}
+
+static tTextLexErr flush_handler( tBinEncContext * context ) {
+  flushed += context->index;
+  context->index = 0;
+  return( TEXTLEX_E_NOERR );
+}
@@ -0,0 +1,512 @@
+/* bench_binlex.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program compares the speed of the DSD Binary Lexxer with the DSD Text
+** Lexxer. It builds about 32 megabytes of DSD/Text the same way bench_textlex
+** does, converts it to the equivalent DSD/Binary and then lexes each of them
+** several times. Since the two documents aren't the same size, and the
+** binary one has no comments and no '=' in it, it prints the number of
+** tokens per second as well as the throughput.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_INPUT_SIZE  ( 32 * 1024 * 1024 )
+#define BENCH_CHUNK_SIZE  ( 64 * 1024 )
+#define BENCH_BUFFER_SIZE 4096
+#define BENCH_PASSES      5
+#define BENCH_NUMBER_TEXT 32
+#define BENCH_NO_STRING   ( (size_t) -1 )
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "binlex.h"
+
+/* Function Prototypes */
+
+static unsigned char * load_input( char * path, size_t * length );
+static unsigned char * convert( unsigned char * input, size_t length, size_t * converted );
+static double run_passes( unsigned char * input, size_t length, int binary, int spanning );
+static void report( char * name, size_t length, double seconds );
+static tTextLexErr token_handler( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr span_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr convert_token( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr convert_decoded( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr convert_overflow( tTextLexContext * context );
+static tTextLexErr end_string( void );
+static tTextLexErr finish( size_t start );
+static void put_item( unsigned int type, unsigned char * data, size_t length );
+static void put_signed( long long value );
+static void put_unsigned( unsigned long long value );
+static void put_integer( unsigned long long value, unsigned int width );
+static size_t header_for( unsigned int type, size_t length, unsigned char * header );
+static unsigned char * room( size_t length );
+
+/* Global Variables */
+
+static unsigned long tokens = 0;
+
+static unsigned char * output = NULL;
+static size_t output_length = 0;
+static size_t output_size = 0;
+static size_t opened[ BINLEX_C_DEPTH ];
+static unsigned int depth = 0;
+static size_t string = BENCH_NO_STRING;
+static int ended = 0;
+
+int main( int argc, char * argv [] ) {
+  unsigned char * text;
+  unsigned char * binary;
+  size_t text_length, binary_length;
+  char * path = ( argc > 1 ) ? argv[ 1 ] : "example.dsd";
+
+  if( NULL == ( text = load_input( path, & text_length ) ) ) {
+    fprintf( stderr, "%%BENCH-F-INPUT; Can't read input from %s.\n", path );
+    return( 1 );
+  }
+
+  if( NULL == ( binary = convert( text, text_length, & binary_length ) ) ) {
+    fprintf( stderr, "%%BENCH-F-CONVERT; Can't convert %s to DSD/Binary.\n", path );
+    return( 1 );
+  }
+
+  printf( "; BEGIN BENCHMARK %s (%zu octets text, %zu octets binary)\n", path, text_length, binary_length );
+
+  report( "TEXT  TOKEN", text_length, run_passes( text, text_length, 0, 0 ) );
+  report( "TEXT  SPAN", text_length, run_passes( text, text_length, 0, 1 ) );
+  report( "BINARY TOKEN", binary_length, run_passes( binary, binary_length, 1, 0 ) );
+  report( "BINARY SPAN", binary_length, run_passes( binary, binary_length, 1, 1 ) );
+
+  printf( "; END BENCHMARK\n" );
+
+  free( binary );
+  free( text );
+
+  return( 0 );
+}
+
+static unsigned char * load_input( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * seed = NULL;
+  unsigned char * input = NULL;
+  size_t seed_length = 0;
+  size_t seed_size = 4096;
+  size_t bytes_read;
+
+  do {
+    if( NULL == ( file = fopen( path, "rb" ) ) ) {
+      break;
+    }
+
+    if( NULL == ( seed = malloc( seed_size ) ) ) {
+      break;
+    }
+
+    while( 0 != ( bytes_read = fread( seed + seed_length, 1, seed_size - seed_length, file ) ) ) {
+      seed_length += bytes_read;
+      if( seed_length == seed_size ) {
+        seed_size *= 2;
+        if( NULL == ( seed = realloc( seed, seed_size ) ) ) {
+          break;
+        }
+      }
+    }
+
+    if( ( NULL == seed ) || ( 0 == seed_length ) ) {
+      break;
+    }
+
+    if( NULL == ( input = malloc( BENCH_INPUT_SIZE + seed_length + 1 ) ) ) {
+      break;
+    }
+
+    for( * length = 0; * length < BENCH_INPUT_SIZE; * length += seed_length + 1 ) {
+      memcpy( input + * length, seed, seed_length );
+      input[ * length + seed_length ] = '\n';
+    }
+  } while( 0 );
+
+  if( NULL != file ) {
+    fclose( file );
+  }
+
+  if( NULL != seed ) {
+    free( seed );
+  }
+
+  return( input );
+}
+
+/* convert()
+**
+** Lexes the text and writes each value out as a DSD/Binary item. Arrays,
+** maps and decoded base16 and base64 strings get a one octet placeholder
+** for their tag when they start, which finish() fills in when they end
+** (moving what follows up if the length needs more room.) Integers are
+** written in the fewest octets that hold them, floats as 64 bit floats
+** and $ hex numbers as integers. Comments and '=' aren't written at all.
+*/
+
+static unsigned char * convert( unsigned char * input, size_t length, size_t * converted ) {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexErr err;
+
+  output_size = length;
+  output_length = 0;
+  depth = 0;
+  string = BENCH_NO_STRING;
+  ended = 0;
+  if( NULL == ( output = malloc( output_size ) ) ) {
+    return( NULL );
+  }
+
+  textlex_init( & context, malloc( BENCH_BUFFER_SIZE ), BENCH_BUFFER_SIZE );
+  textlex_extend( & context, & extension );
+  context.token = convert_token;
+  context.overflow = convert_overflow;
+  extension.decoded = convert_decoded;
+
+  if( TEXTLEX_E_NOERR == ( err = textlex_update( & context, input, length ) ) ) {
+    if( TEXTLEX_E_NOERR == ( err = textlex_final( & context ) ) ) {
+      err = end_string();
+    }
+  }
+
+  free( context.buffer );
+
+  if( ( TEXTLEX_E_NOERR != err ) || ( 0 != depth ) || ( BENCH_NO_STRING != string ) ) {
+    free( output );
+    return( NULL );
+  }
+
+  * converted = output_length;
+  return( output );
+}
+
+static double run_passes( unsigned char * input, size_t length, int binary, int spanning ) {
+  tTextLexContext text;
+  tBinLexContext bin;
+  tTextLexExtension extension;
+  tTextLexContext * context = binary ? & bin.text : & text;
+  tTextLexBuffer buffer[ BENCH_BUFFER_SIZE ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  struct timespec start, stop;
+  size_t offset, chunk;
+  unsigned int pass;
+
+  tokens = 0;
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( pass = 0; pass < BENCH_PASSES; pass++ ) {
+    if( binary ) {
+      binlex_init( & bin, buffer, BENCH_BUFFER_SIZE );
+    } else {
+      textlex_init( & text, buffer, BENCH_BUFFER_SIZE );
+      textlex_extend( & text, & extension );
+    }
+
+    if( spanning ) {
+      context->extension->span = span_handler;
+    } else {
+      context->token = token_handler;
+    }
+
+    for( offset = 0; offset < length; offset += chunk ) {
+      chunk = ( ( length - offset ) < BENCH_CHUNK_SIZE ) ? ( length - offset ) : BENCH_CHUNK_SIZE;
+      err = binary ? binlex_update( & bin, input + offset, chunk ) : textlex_update( & text, input + offset, chunk );
+      if( TEXTLEX_E_NOERR != err ) {
+        fprintf( stderr, "%%BENCH-F-UPDATE; Error %d at line %d, octet %d.\n", err, context->line, context->octet );
+        exit( 2 );
+      }
+    }
+
+    if( binary ) {
+      binlex_final( & bin );
+    } else {
+      textlex_final( & text );
+    }
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+
+  return( ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9 );
+}
+
+static void report( char * name, size_t length, double seconds ) {
+  printf( "; %-12s %8.3f GB/s %8.2f Mtokens/s %10lu tokens\n", name,
+          ( (double) length * BENCH_PASSES ) / seconds / 1e9, tokens / seconds / 1e6, tokens / BENCH_PASSES );
+}
+
+static tTextLexErr token_handler( tTextLexContext * context, tTextLexCount token ) {
+  tokens++;
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr span_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  tokens++;
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr convert_token( tTextLexContext * context, tTextLexCount token ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t length = context->index;
+  unsigned long long value;
+  double real;
+  char text[ BENCH_NUMBER_TEXT ];
+
+  /* A comment in a base16 string means there's more of the string to come. */
+
+  if( ( TEXTLEX_T_COMMENT == token ) && ( TEXTLEX_S_BASE16_COMMENT == context->state ) ) {
+    ended = -1;
+    return( TEXTLEX_E_NOERR );
+  }
+
+  if( TEXTLEX_T_END == token ) {
+    ended = ( ended < 0 ) ? 0 : 1;
+    return( TEXTLEX_E_NOERR );
+  }
+
+  if( TEXTLEX_E_NOERR != ( err = end_string() ) ) {
+    return( err );
+  }
+
+  if( NULL == room( length + 16 ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  switch( token ) {
+  case TEXTLEX_T_ARRAY_OPEN:
+  case TEXTLEX_T_MAP_OPEN:
+    if( BINLEX_C_DEPTH == depth ) {
+      return( BINLEX_E_DEPTH );
+    }
+    opened[ depth++ ] = output_length;
+    output[ output_length++ ] = ( TEXTLEX_T_MAP_OPEN == token ) ? BINLEX_TYPE_MAP : BINLEX_TYPE_ARRAY;
+    break;
+
+  case TEXTLEX_T_ARRAY_CLOSE:
+  case TEXTLEX_T_MAP_CLOSE:
+    if( 0 == depth ) {
+      return( TEXTLEX_E_ERROR );
+    }
+    err = finish( opened[ --depth ] );
+    break;
+
+  case TEXTLEX_T_INTEGER:
+  case TEXTLEX_T_HEX:
+  case TEXTLEX_T_FLOAT:
+    if( ( 0 == length ) || ( length >= BENCH_NUMBER_TEXT ) ) {
+      return( TEXTLEX_E_ERROR );
+    }
+    memcpy( text, context->buffer, length );
+    text[ length ] = '\0';
+
+    if( TEXTLEX_T_FLOAT == token ) {
+      real = strtod( text, NULL );
+      memcpy( & value, & real, sizeof( value ) );
+      output[ output_length++ ] = BINLEX_TYPE_FLOAT | 7;
+      put_integer( value, 8 );
+    } else if( '-' == text[ 0 ] ) {
+      put_signed( (long long) strtoll( text, NULL, 10 ) );
+    } else {
+      put_unsigned( strtoull( text, NULL, ( TEXTLEX_T_HEX == token ) ? 16 : 10 ) );
+    }
+    break;
+
+  case TEXTLEX_T_ANNOTATION:
+    if( ( 1 == length ) && ( 't' == context->buffer[ 0 ] ) ) {
+      output[ output_length++ ] = BINLEX_TAG_TINY;
+    } else if( ( 1 == length ) && ( 's' == context->buffer[ 0 ] ) ) {
+      output[ output_length++ ] = BINLEX_TAG_SMALL;
+    } else if( ( 1 == length ) && ( 'm' == context->buffer[ 0 ] ) ) {
+      output[ output_length++ ] = BINLEX_TAG_MEDIUM;
+    } else {
+      put_item( BINLEX_TYPE_ANNOTATION, context->buffer, length );
+    }
+    break;
+
+  case TEXTLEX_T_LITERAL:
+    put_item( BINLEX_TYPE_LITERAL, context->buffer, length );
+    break;
+
+  case TEXTLEX_T_STRING:
+    put_item( BINLEX_TYPE_STRING, context->buffer, length );
+    break;
+
+  default:
+    break;
+  }
+
+  return( err );
+}
+
+/* convert_decoded()
+**
+** Appends the octets of a base16 or base64 string to the string item it's
+** building. A base16 string with a comment in it arrives in pieces, each
+** followed by a TEXTLEX_T_END, so the item isn't finished until something
+** other than a comment in the string comes after the TEXTLEX_T_END.
+*/
+
+static tTextLexErr convert_decoded( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  tTextLexErr err;
+
+  if( TEXTLEX_E_NOERR != ( err = end_string() ) ) {
+    return( err );
+  }
+
+  if( NULL == room( length + 16 ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  if( BENCH_NO_STRING == string ) {
+    string = output_length;
+    output[ output_length++ ] = BINLEX_TYPE_STRING;
+  }
+
+  memcpy( output + output_length, data, length );
+  output_length += length;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr end_string( void ) {
+  size_t start = string;
+
+  if( ( BENCH_NO_STRING == string ) || ! ended ) {
+    return( TEXTLEX_E_NOERR );
+  }
+
+  string = BENCH_NO_STRING;
+
+  return( finish( start ) );
+}
+
+/* finish()
+**
+** Replaces the placeholder tag at start, which has the item's type in it,
+** with the tag and length of everything written after it.
+*/
+
+static tTextLexErr finish( size_t start ) {
+  unsigned char header[ 9 ];
+  size_t body = output_length - start - 1;
+  size_t count = header_for( output[ start ], body, header );
+
+  if( NULL == room( count ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  memmove( output + start + count, output + start + 1, body );
+  memcpy( output + start, header, count );
+  output_length += count - 1;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static void put_item( unsigned int type, unsigned char * data, size_t length ) {
+  output_length += header_for( type, length, output + output_length );
+  memcpy( output + output_length, data, length );
+  output_length += length;
+}
+
+/* put_signed() and put_unsigned()
+**
+** Write an integer item in the fewest octets that hold the value in two's
+** complement. Unsigned values with the top bit set need nine, the first
+** of them zero.
+*/
+
+static void put_signed( long long value ) {
+  unsigned int width = 1;
+
+  while( ( width < 8 ) && ( value < -( 1LL << ( width * 8 - 1 ) ) ) ) {
+    width++;
+  }
+
+  output[ output_length++ ] = BINLEX_TYPE_INTEGER | ( width - 1 );
+  put_integer( (unsigned long long) value, width );
+}
+
+static void put_unsigned( unsigned long long value ) {
+  unsigned int width = 1;
+
+  if( value >> 63 ) {
+    output[ output_length++ ] = BINLEX_TYPE_INTEGER | BINLEX_LEN_U8;
+    output[ output_length++ ] = 0;
+    output[ output_length++ ] = 0;
+    put_integer( value, 8 );
+    return;
+  }
+
+  while( ( width < 8 ) && ( value >= ( 1ULL << ( width * 8 - 1 ) ) ) ) {
+    width++;
+  }
+
+  output[ output_length++ ] = BINLEX_TYPE_INTEGER | ( width - 1 );
+  put_integer( value, width );
+}
+
+static void put_integer( unsigned long long value, unsigned int width ) {
+  unsigned int i;
+
+  for( i = width; i > 0; i-- ) {
+    output[ output_length + i - 1 ] = (unsigned char) ( value & 0xFF );
+    value >>= 8;
+  }
+
+  output_length += width;
+}
+
+static size_t header_for( unsigned int type, size_t length, unsigned char * header ) {
+  if( 0 == length ) {
+    header[ 0 ] = type | BINLEX_LEN_EMPTY;
+    return( 1 );
+  } else if( length <= 8 ) {
+    header[ 0 ] = type | ( length - 1 );
+    return( 1 );
+  } else if( length <= 9 + 255 ) {
+    header[ 0 ] = type | BINLEX_LEN_U8;
+    header[ 1 ] = length - 9;
+    return( 2 );
+  }
+
+  header[ 0 ] = type | BINLEX_LEN_U32;
+  header[ 1 ] = ( length >> 24 ) & 0xFF;
+  header[ 2 ] = ( length >> 16 ) & 0xFF;
+  header[ 3 ] = ( length >> 8 ) & 0xFF;
+  header[ 4 ] = length & 0xFF;
+  return( 5 );
+}
+
+static unsigned char * room( size_t length ) {
+  if( output_length + length > output_size ) {
+    output_size = ( output_length + length ) * 2;
+    output = realloc( output, output_size );
+  }
+
+  return( output );
+}
+
+static tTextLexErr convert_overflow( tTextLexContext * context ) {
+  tTextLexBuffer * buffer;
+
+  if( NULL == ( buffer = realloc( context->buffer, context->size * 2 ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  context->buffer = buffer;
+  context->size *= 2;
+
+  return( TEXTLEX_E_NOERR );
+}
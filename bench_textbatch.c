@@ -0,0 +1,224 @@
+/* bench_textbatch.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program measures what batch mode saves on documents made mostly of
+** small values, where the cost of calling a callback for every token adds
+** up. It builds a big array of short integers and floats, like
+**
+**   [ 1 -1 2.3 17 -0.5 ... ]
+**
+** and a map of them ({ *a = 1 *b = -2.5 ... }), and lexes each of them with
+** the token callback, the span callback and the batch callback (with a few
+** batch sizes), printing how many tokens per second each one gets through.
+** Before timing anything, it checks they all see the same tokens.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_VALUES      2000000
+#define BENCH_CHUNK_SIZE  ( 64 * 1024 )
+#define BENCH_BUFFER_SIZE 4096
+#define BENCH_PASSES      5
+#define BENCH_VALUE_TEXT  16
+
+#define BENCH_M_TOKEN     0
+#define BENCH_M_SPAN      1
+#define BENCH_M_BATCH     2
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "textlex.h"
+
+/* Function Prototypes */
+
+static unsigned char * build_input( int map, size_t * length );
+static double run_passes( unsigned char * input, size_t length, unsigned int mode, tTextLexCount capacity );
+static tTextLexErr token_handler( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr span_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr batch_handler( tTextLexContext * context, tTextLexToken * tokens, tTextLexCount count );
+
+/* Global Variables */
+
+static const char * modes [] = { "token", "span", "batch" };
+static unsigned long tokens_seen = 0;
+static unsigned long long octets = 0;
+
+int main( int argc, char * argv [] ) {
+  static const tTextLexCount capacities [] = { 16, 256, 4096 };
+  unsigned char * input;
+  size_t length;
+  double seconds;
+  unsigned long counts[ 3 ];
+  unsigned long long sums[ 3 ];
+  unsigned int mode, k;
+  int map;
+
+  printf( "; BEGIN BENCHMARK\n" );
+
+  for( map = 0; map <= 1; map++ ) {
+    if( NULL == ( input = build_input( map, & length ) ) ) {
+      fprintf( stderr, "%%BENCH-F-MEMORY; Can't allocate the input.\n" );
+      return( 1 );
+    }
+
+    for( mode = BENCH_M_TOKEN; mode <= BENCH_M_BATCH; mode++ ) {
+      run_passes( input, length, mode, 256 );
+      counts[ mode ] = tokens_seen;
+      sums[ mode ] = octets;
+    }
+
+    if( ( counts[ BENCH_M_TOKEN ] != counts[ BENCH_M_BATCH ] ) || ( counts[ BENCH_M_SPAN ] != counts[ BENCH_M_BATCH ] ) ||
+        ( sums[ BENCH_M_TOKEN ] != sums[ BENCH_M_BATCH ] ) || ( sums[ BENCH_M_SPAN ] != sums[ BENCH_M_BATCH ] ) ) {
+      fprintf( stderr, "%%BENCH-F-MISMATCH; The token, span and batch modes disagree.\n" );
+      return( 2 );
+    }
+
+    for( mode = BENCH_M_TOKEN; mode <= BENCH_M_BATCH; mode++ ) {
+      for( k = 0; k < ( ( BENCH_M_BATCH == mode ) ? 3 : 1 ); k++ ) {
+        seconds = run_passes( input, length, mode, capacities[ k ] );
+        printf( "; %-5s %-5s %5u %10zu octets %10lu tokens %8.2f Mtokens/s %8.3f GB/s\n", map ? "map" : "array", modes[ mode ],
+                ( BENCH_M_BATCH == mode ) ? (unsigned int) capacities[ k ] : 0, length, tokens_seen,
+                ( (double) tokens_seen * BENCH_PASSES ) / seconds / 1e6, ( (double) length * BENCH_PASSES ) / seconds / 1e9 );
+      }
+    }
+
+    free( input );
+  }
+
+  printf( "; END BENCHMARK\n" );
+
+  return( 0 );
+}
+
+/* build_input()
+**
+** Makes an array (or a map) of BENCH_VALUES short random numbers, about
+** half of them floats, twenty to a line.
+*/
+
+static unsigned char * build_input( int map, size_t * length ) {
+  unsigned long long state = 88172645463325252ULL;
+  unsigned char * input;
+  char * out;
+  unsigned long i;
+
+  if( NULL == ( input = malloc( (size_t) BENCH_VALUES * BENCH_VALUE_TEXT ) ) ) {
+    return( NULL );
+  }
+
+  out = (char *) input;
+  out += sprintf( out, "%c\n", map ? '{' : '[' );
+
+  for( i = 0; i < BENCH_VALUES; i++ ) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    if( map ) {
+      out += sprintf( out, "*%c = ", 'a' + (int) ( i % 26 ) );
+    }
+
+    if( state & 0x100 ) {
+      out += sprintf( out, "%s%u.%u", ( state & 0x200 ) ? "-" : "", (unsigned int) ( ( state >> 10 ) % 100 ), (unsigned int) ( ( state >> 20 ) % 10 ) );
+    } else {
+      out += sprintf( out, "%s%u", ( state & 0x200 ) ? "-" : "", (unsigned int) ( ( state >> 10 ) % 1000 ) );
+    }
+
+    * out++ = ( 19 == i % 20 ) ? '\n' : ' ';
+  }
+
+  out += sprintf( out, "%c\n", map ? '}' : ']' );
+  * length = out - (char *) input;
+
+  return( input );
+}
+
+/* run_passes()
+**
+** Lexes the input BENCH_PASSES times and returns how many seconds it took.
+*/
+
+static double run_passes( unsigned char * input, size_t length, unsigned int mode, tTextLexCount capacity ) {
+  static tTextLexToken tokens[ 4096 ];
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ BENCH_BUFFER_SIZE ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  struct timespec start, stop;
+  size_t offset, chunk;
+  unsigned int pass;
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( pass = 0; pass < BENCH_PASSES; pass++ ) {
+    tokens_seen = 0;
+    octets = 0;
+
+    textlex_init( & context, buffer, BENCH_BUFFER_SIZE );
+    textlex_extend( & context, & extension );
+    switch( mode ) {
+    case BENCH_M_TOKEN:
+      context.token = token_handler;
+      break;
+
+    case BENCH_M_SPAN:
+      extension.span = span_handler;
+      break;
+
+    default:
+      extension.tokens = tokens;
+      extension.capacity = capacity;
+      extension.batch = batch_handler;
+      break;
+    }
+
+    for( offset = 0; offset < length; offset += chunk ) {
+      chunk = ( ( length - offset ) < BENCH_CHUNK_SIZE ) ? ( length - offset ) : BENCH_CHUNK_SIZE;
+      if( TEXTLEX_E_NOERR != ( err = textlex_update( & context, input + offset, chunk ) ) ) {
+        fprintf( stderr, "%%BENCH-F-UPDATE; Error %d at line %d, octet %d.\n", err, context.line, context.octet );
+        exit( 2 );
+      }
+    }
+
+    textlex_final( & context );
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+
+  return( ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9 );
+}
+
+/* The handlers count the tokens and add up the lexeme lengths, which is
+** about the least a real program could do with them.
+*/
+
+static tTextLexErr token_handler( tTextLexContext * context, tTextLexCount token ) {
+  tokens_seen++;
+  octets += context->index;
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr span_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  tokens_seen++;
+  octets += length;
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr batch_handler( tTextLexContext * context, tTextLexToken * tokens, tTextLexCount count ) {
+  tTextLexCount i;
+
+  for( i = 0; i < count; i++ ) {
+    octets += tokens[ i ].length;
+  }
+  tokens_seen += count;
+
+  return( TEXTLEX_E_NOERR );
+}
@@ -0,0 +1,111 @@
+/* bench_textbind.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program measures how long it takes to parse the messages in
+** example_struct.c into a struct, once with the hand written parse_this()
+** from that file and once with the code textgen writes for
+** example_bind.dsd. Both start from a zeroed struct, the way the example
+** does. Before timing anything, it checks they agree.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_MESSAGES  1000000
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "example_bind.h"
+
+/* parse_this() is benchmarked exactly as it's written in example_struct.c,
+** so the example is compiled right into this program with its main()
+** renamed.
+*/
+
+#define main example_struct_main
+#include "example_struct.c"
+#undef main
+
+/* Function Prototypes */
+
+static double run( unsigned int fixture, int generated, unsigned long count );
+
+int main( int argc, char * argv [] ) {
+  tBindStruct bound;
+  tTestStruct parsed;
+  unsigned int i;
+  size_t length;
+  double hand, generated;
+
+  for( i = 0; NULL != input_fixtures[ i ]; i++ ) {
+    length = strlen( (char *) input_fixtures[ i ] );
+    memset( & parsed, 0, sizeof( tTestStruct ) );
+    if( ( 0 != parse_this( input_fixtures[ i ], & parsed ) ) ||
+        ( TEXTLEX_E_NOERR != example_bind_parse( & bound, input_fixtures[ i ], length ) ) ||
+        ( parsed.iterations != bound.iterations ) || ( 0 != memcmp( parsed.salt, bound.salt, sizeof( parsed.salt ) ) ) ||
+        ( 0 != memcmp( parsed.secret, bound.secret, sizeof( parsed.secret ) ) ) ) {
+      fprintf( stderr, "%%BENCH-F-MISMATCH; The parsers disagree about fixture %u.\n", i );
+      return( 2 );
+    }
+  }
+
+  printf( "; BEGIN BENCHMARK\n" );
+
+  for( i = 0; NULL != input_fixtures[ i ]; i++ ) {
+    length = strlen( (char *) input_fixtures[ i ] );
+    hand = run( i, 0, BENCH_MESSAGES );
+    generated = run( i, 1, BENCH_MESSAGES );
+
+    printf( "; parse_this/%u %6zu octets %10.3f us/message %8.3f GB/s\n", i, length, hand * 1e6 / BENCH_MESSAGES,
+            (double) length * BENCH_MESSAGES / hand / 1e9 );
+    printf( "; textbind/%u   %6zu octets %10.3f us/message %8.3f GB/s (%.1fx)\n", i, length, generated * 1e6 / BENCH_MESSAGES,
+            (double) length * BENCH_MESSAGES / generated / 1e9, hand / generated );
+  }
+
+  printf( "; END BENCHMARK\n" );
+
+  return( 0 );
+}
+
+/* run()
+**
+** Parses a fixture count times and returns how many seconds it took.
+*/
+
+static double run( unsigned int fixture, int generated, unsigned long count ) {
+  unsigned char * message = input_fixtures[ fixture ];
+  size_t length = strlen( (char *) message );
+  struct timespec start, stop;
+  tBindStruct bound;
+  tTestStruct parsed;
+  unsigned long i, sum = 0;
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( i = 0; i < count; i++ ) {
+    if( generated ) {
+      example_bind_parse( & bound, message, length );
+      sum += bound.iterations;
+    } else {
+      memset( & parsed, 0, sizeof( tTestStruct ) );
+      parse_this( message, & parsed );
+      sum += parsed.iterations;
+    }
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+
+  if( sum != 12 * count ) {
+    fprintf( stderr, "%%BENCH-F-PARSE; Fixture %u didn't parse.\n", fixture );
+    exit( 2 );
+  }
+
+  return( ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9 );
+}
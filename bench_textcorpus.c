@@ -0,0 +1,282 @@
+/* bench_textcorpus.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program measures the lexxer on the files textcorpus writes (or any
+** other DSD/Text files.) It reads each file into memory and lexes it with
+** the token callback, handing it to textlex_update() 1 octet, 80 octets
+** (like example_simple.c) and 64 kilobytes at a time and then all at once,
+** repeating each until it has taken at least a quarter of a second. `make
+** bench` writes a corpus of each shape and runs this over them.
+**
+** So the results can be kept and compared from one commit to the next,
+** they're written as DSD/Text, one map to a line (wrapped here):
+**
+**   {"corpus"="corpus_deep""chunk"=80"octets"=4194466"tokens"=2337913"passes"=3
+**    "seconds"=0.262"mb_per_second"=96.05"tokens_per_second"=36010000
+**    "ticks_per_octet"=25.9"clock"="tsc"}
+**
+** chunk is 0 for the whole file at once. ticks_per_octet is cycles per
+** octet when clock is "tsc" (the time stamp counter, which counts at
+** about the CPU's nominal clock rate) and nanoseconds per octet when it's
+** "ns" (see textstat.h.) A megabyte is a million octets.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_BUFFER_SIZE 4096
+#define BENCH_MIN_SECONDS 0.25
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "textstat.h"
+
+/* Function Prototypes */
+
+static unsigned char * load_input( char * path, size_t * length );
+static double run_passes( unsigned char * input, size_t length, size_t chunk_size, unsigned long * passes, unsigned long long * ticks );
+static tTextLexErr write_result( tTextEncContext * writer, char * path, size_t chunk_size, size_t length, unsigned long passes,
+                                 double seconds, unsigned long long ticks );
+static tTextLexErr key( tTextEncContext * writer, const char * name );
+static double rounded( double value );
+static tTextLexErr token_handler( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr overflow_handler( tTextLexContext * context );
+static tTextLexErr flush( tTextEncContext * context );
+
+/* Global Variables */
+
+static const size_t chunk_sizes [] = { 1, 80, 64 * 1024, 0 };
+static unsigned long long tokens = 0;
+
+int main( int argc, char * argv [] ) {
+  unsigned char buffer[ 256 ];
+  tTextEncContext writer;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  unsigned char * input;
+  unsigned long long ticks, expected;
+  unsigned long passes;
+  size_t length;
+  double seconds;
+  unsigned int k;
+  int i;
+
+  if( argc < 2 ) {
+    fprintf( stderr, "%%BENCH-F-USAGE; Usage: %s <file> ...\n", argv[ 0 ] );
+    return( 1 );
+  }
+
+  textenc_init( & writer, buffer, sizeof( buffer ), TEXTENC_M_COMPACT );
+  writer.flush = flush;
+
+  for( i = 1; ( i < argc ) && ( TEXTLEX_E_NOERR == err ); i++ ) {
+    if( NULL == ( input = load_input( argv[ i ], & length ) ) ) {
+      fprintf( stderr, "%%BENCH-F-INPUT; Can't read input from %s.\n", argv[ i ] );
+      return( 1 );
+    }
+
+    for( k = 0, expected = 0; ( k < sizeof( chunk_sizes ) / sizeof( chunk_sizes[ 0 ] ) ) && ( TEXTLEX_E_NOERR == err ); k++ ) {
+      seconds = run_passes( input, length, chunk_sizes[ k ], & passes, & ticks );
+
+      /* Every chunk size has to see the same tokens. */
+
+      if( ( 0 != expected ) && ( expected != tokens ) ) {
+        fprintf( stderr, "%%BENCH-F-COUNT; %s has %llu tokens in %zu octet chunks, not %llu.\n", argv[ i ], tokens,
+                 chunk_sizes[ k ], expected );
+        return( 2 );
+      }
+      expected = tokens;
+
+      err = write_result( & writer, argv[ i ], chunk_sizes[ k ], length, passes, seconds, ticks );
+    }
+
+    free( input );
+  }
+
+  if( TEXTLEX_E_NOERR != err ) {
+    fprintf( stderr, "%%BENCH-F-OUTPUT; Error %d writing the results.\n", err );
+    return( 1 );
+  }
+
+  return( 0 );
+}
+
+static unsigned char * load_input( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * input = NULL;
+  size_t size = 64 * 1024;
+  size_t bytes_read;
+
+  * length = 0;
+
+  if( NULL == ( file = fopen( path, "rb" ) ) ) {
+    return( NULL );
+  }
+
+  while( NULL != ( input = realloc( input, size ) ) ) {
+    if( 0 == ( bytes_read = fread( input + * length, 1, size - * length, file ) ) ) {
+      break;
+    }
+    * length += bytes_read;
+    if( * length == size ) {
+      size *= 2;
+    }
+  }
+
+  fclose( file );
+
+  return( input );
+}
+
+/* run_passes()
+**
+** Lexes the input chunk_size octets at a time (or all at once if it's 0)
+** until BENCH_MIN_SECONDS have gone by. Returns how many seconds it took;
+** passes gets the number of passes and ticks the clock ticks. tokens is
+** left with the number of tokens in one pass.
+*/
+
+static double run_passes( unsigned char * input, size_t length, size_t chunk_size, unsigned long * passes, unsigned long long * ticks ) {
+  tTextLexContext context;
+  tTextLexBuffer * buffer = NULL;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  struct timespec start, stop;
+  unsigned long long first;
+  size_t offset, chunk;
+  double seconds;
+
+  if( 0 == chunk_size ) {
+    chunk_size = length;
+  }
+
+  * passes = 0;
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+  first = TEXTSTAT_TICKS();
+
+  do {
+    /* The buffer grows to fit the longest lexeme, so long strings are
+    ** tokens rather than pieces whatever the chunk size.
+    */
+
+    if( NULL == ( buffer = malloc( BENCH_BUFFER_SIZE ) ) ) {
+      fprintf( stderr, "%%BENCH-F-MEMORY; Can't allocate the buffer.\n" );
+      exit( 1 );
+    }
+
+    tokens = 0;
+    textlex_init( & context, buffer, BENCH_BUFFER_SIZE );
+    context.token = token_handler;
+    context.overflow = overflow_handler;
+
+    for( offset = 0; offset < length; offset += chunk ) {
+      chunk = ( ( length - offset ) < chunk_size ) ? ( length - offset ) : chunk_size;
+      if( TEXTLEX_E_NOERR != ( err = textlex_update( & context, input + offset, (tTextLexCount) chunk ) ) ) {
+        break;
+      }
+    }
+
+    if( ( TEXTLEX_E_NOERR != err ) || ( TEXTLEX_E_NOERR != ( err = textlex_final( & context ) ) ) ) {
+      fprintf( stderr, "%%BENCH-F-UPDATE; Error %d at line %d, octet %d.\n", err, context.line, context.octet );
+      exit( 2 );
+    }
+
+    free( context.buffer );
+    ( * passes )++;
+
+    clock_gettime( CLOCK_MONOTONIC, & stop );
+    seconds = ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9;
+  } while( seconds < BENCH_MIN_SECONDS );
+
+  * ticks = TEXTSTAT_TICKS() - first;
+
+  return( seconds );
+}
+
+static tTextLexErr write_result( tTextEncContext * writer, char * path, size_t chunk_size, size_t length, unsigned long passes,
+                                 double seconds, unsigned long long ticks ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  const char * name = ( NULL == ( name = strrchr( path, '/' ) ) ) ? path : name + 1;
+  size_t name_length = strcspn( name, "." );
+  double octets = (double) length * passes;
+
+  err |= textenc_token( writer, TEXTLEX_T_MAP_OPEN );
+  err |= key( writer, "corpus" );
+  err |= textenc_text( writer, TEXTLEX_T_STRING, (const unsigned char *) name, name_length );
+  err |= key( writer, "chunk" );
+  err |= textenc_unsigned( writer, chunk_size );
+  err |= key( writer, "octets" );
+  err |= textenc_unsigned( writer, length );
+  err |= key( writer, "tokens" );
+  err |= textenc_unsigned( writer, tokens );
+  err |= key( writer, "passes" );
+  err |= textenc_unsigned( writer, passes );
+  err |= key( writer, "seconds" );
+  err |= textenc_float( writer, rounded( seconds ) );
+  err |= key( writer, "mb_per_second" );
+  err |= textenc_float( writer, rounded( octets / seconds / 1e6 ) );
+  err |= key( writer, "tokens_per_second" );
+  err |= textenc_unsigned( writer, (unsigned long long) ( (double) tokens * passes / seconds ) );
+  err |= key( writer, "ticks_per_octet" );
+  err |= textenc_float( writer, rounded( (double) ticks / octets ) );
+  err |= key( writer, "clock" );
+  err |= textenc_text( writer, TEXTLEX_T_STRING, (const unsigned char *) TEXTSTAT_CLOCK, strlen( TEXTSTAT_CLOCK ) );
+  err |= textenc_token( writer, TEXTLEX_T_MAP_CLOSE );
+
+  /* One result to a line, so they can be compared with diff or grep. */
+
+  err |= flush( writer );
+  putchar( '\n' );
+
+  return( err );
+}
+
+static tTextLexErr key( tTextEncContext * writer, const char * name ) {
+  tTextLexErr err = textenc_text( writer, TEXTLEX_T_STRING, (const unsigned char *) name, strlen( name ) );
+
+  return( err | textenc_token( writer, TEXTLEX_T_EQUALS ) );
+}
+
+/* rounded()
+**
+** Rounds to three places, so the floats aren't written with 17 digits.
+*/
+
+static double rounded( double value ) {
+  return( (double) (unsigned long long) ( value * 1000.0 + 0.5 ) / 1000.0 );
+}
+
+static tTextLexErr token_handler( tTextLexContext * context, tTextLexCount token ) {
+  tokens++;
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr overflow_handler( tTextLexContext * context ) {
+  tTextLexCount new_size = context->size * 2;
+  tTextLexBuffer * new_buffer;
+
+  if( ( new_size < context->size ) || ( NULL == ( new_buffer = realloc( context->buffer, new_size ) ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  context->buffer = new_buffer;
+  context->size = new_size;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr flush( tTextEncContext * context ) {
+  if( context->index != fwrite( context->buffer, 1, context->index, stdout ) ) {
+    return( TEXTLEX_E_ERROR );
+  }
+
+  context->index = 0;
+
+  return( TEXTLEX_E_NOERR );
+}
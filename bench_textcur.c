@@ -0,0 +1,142 @@
+/* bench_textcur.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program measures how long it takes the cursor to pull a few values
+** out of a message, for the same messages bench_textdom.c builds trees
+** for. For the small message it reads two of its three keys; for
+** example.dsd it reads three keys from near the start and one from a map
+** at the very end, so most of the document is skipped.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_SMALL_MESSAGES  1000000
+#define BENCH_LARGE_MESSAGES  50000
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "textcur.h"
+
+/* Function Prototypes */
+
+static unsigned char * load_file( char * path, size_t * length );
+static void run( char * name, unsigned char * message, size_t length, unsigned long count, char ** keys );
+
+/* Global Variables */
+
+static char * small_message =
+  "@m{\"iterations\"=12 \"salt\"=\"01234567\" \"secret\"=(8a 4d 21 92 03 82 3c f8 6a 05 c5 ea 0c 40 be f4 c8 02 76 33)}";
+
+static char * small_keys[] = { "iterations", "secret", NULL };
+static char * large_keys[] = { "revision", "magic number", "percent complete", "yet another dictionary", NULL };
+
+int main( int argc, char * argv [] ) {
+  unsigned char * example;
+  size_t length;
+  char * path = ( argc > 1 ) ? argv[ 1 ] : "example.dsd";
+
+  if( NULL == ( example = load_file( path, & length ) ) ) {
+    fprintf( stderr, "%%BENCH-F-INPUT; Can't read input from %s.\n", path );
+    return( 1 );
+  }
+
+  printf( "; BEGIN BENCHMARK\n" );
+
+  run( "SMALL", (unsigned char *) small_message, strlen( small_message ), BENCH_SMALL_MESSAGES, small_keys );
+  run( path, example, length, BENCH_LARGE_MESSAGES, large_keys );
+
+  printf( "; END BENCHMARK\n" );
+
+  free( example );
+
+  return( 0 );
+}
+
+/* run()
+**
+** Finds each of keys in the first map in the message. Integers are
+** converted and binary strings decoded; anything else is just found.
+*/
+
+static void run( char * name, unsigned char * message, size_t length, unsigned long count, char ** keys ) {
+  struct timespec start, stop;
+  tTextCurCursor root, map;
+  tTextCurValue value;
+  unsigned char octets[ 64 ];
+  long long integer, sum = 0;
+  unsigned long i;
+  unsigned int k;
+  tTextLexErr err;
+  double seconds;
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( i = 0; i < count; i++ ) {
+    textcur_init( & root, message, length );
+
+    if( ( TEXTLEX_E_NOERR != ( err = textcur_next( & root, NULL, & value ) ) ) ||
+        ( TEXTLEX_E_NOERR != ( err = textcur_enter( & map, & value ) ) ) ) {
+      fprintf( stderr, "%%BENCH-F-CURSOR; Error %d.\n", err );
+      exit( 2 );
+    }
+
+    for( k = 0; NULL != keys[ k ]; k++ ) {
+      if( TEXTLEX_E_NOERR != ( err = textcur_find( & map, keys[ k ], & value ) ) ) {
+        fprintf( stderr, "%%BENCH-F-CURSOR; Error %d.\n", err );
+        exit( 2 );
+      }
+      if( textcur_integer( & value, & integer ) ) {
+        sum += integer;
+      } else {
+        sum += textcur_octets( & value, octets, sizeof( octets ) );
+      }
+    }
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+
+  seconds = ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9;
+
+  printf( "; %-12s %6zu octets %10.3f us/message %8.3f GB/s (%lld)\n", name, length,
+          seconds * 1e6 / count, (double) length * count / seconds / 1e9, sum / (long long) count );
+}
+
+static unsigned char * load_file( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * data = NULL;
+  long size;
+
+  if( NULL == ( file = fopen( path, "rb" ) ) ) {
+    return( NULL );
+  }
+
+  do {
+    if( ( 0 != fseek( file, 0, SEEK_END ) ) || ( ( size = ftell( file ) ) <= 0 ) || ( 0 != fseek( file, 0, SEEK_SET ) ) ) {
+      break;
+    }
+
+    if( NULL == ( data = malloc( size ) ) ) {
+      break;
+    }
+
+    if( (size_t) size != fread( data, 1, size, file ) ) {
+      free( data );
+      data = NULL;
+      break;
+    }
+
+    * length = size;
+  } while( 0 );
+
+  fclose( file );
+
+  return( data );
+}
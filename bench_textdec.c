@@ -0,0 +1,274 @@
+/* bench_textdec.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program measures the lexxer's decoded binary mode against decoding
+** binary strings the usual way, a character at a time in a span callback.
+** It builds a big array of base16 strings and another of base64 strings
+** (each a few hundred octets of random data, with the base16 ones broken
+** into lines) and lexes each of them three ways:
+**
+**   lex     : span callback only; what lexing costs without decoding
+**   scalar  : span callback decoding each string one character at a time
+**   decoded : decoded callback, with the strings decoded by the lexxer
+**
+** The last one runs once for each decoder in textscan.c the CPU supports.
+** Before timing anything, it checks the last two get the same octets.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_STRINGS     20000
+#define BENCH_OCTETS      768
+#define BENCH_CHUNK_SIZE  ( 64 * 1024 )
+#define BENCH_BUFFER_SIZE 4096
+#define BENCH_PASSES      5
+
+#define BENCH_M_LEX       0
+#define BENCH_M_SCALAR    1
+#define BENCH_M_DECODED   2
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "textlex.h"
+#include "textscan.h"
+
+/* Function Prototypes */
+
+static unsigned char * build_input( int base64, size_t * length );
+static double run_passes( unsigned char * input, size_t length, unsigned int mode );
+static tTextLexErr lex_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr scalar_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr decoded_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+
+/* Global Variables */
+
+static const char * modes [] = { "lex", "scalar", "decoded" };
+static unsigned long strings = 0;
+static unsigned long long octets = 0;
+static unsigned long long sum = 0;
+
+int main( int argc, char * argv [] ) {
+  unsigned char * input;
+  size_t length;
+  double seconds;
+  unsigned long long sums[ 3 ];
+  unsigned int mode, isa, selected;
+  int base64;
+
+  printf( "; BEGIN BENCHMARK\n" );
+
+  for( base64 = 0; base64 <= 1; base64++ ) {
+    if( NULL == ( input = build_input( base64, & length ) ) ) {
+      fprintf( stderr, "%%BENCH-F-MEMORY; Can't allocate the input.\n" );
+      return( 1 );
+    }
+
+    for( mode = BENCH_M_LEX; mode <= BENCH_M_DECODED; mode++ ) {
+      run_passes( input, length, mode );
+      sums[ mode ] = sum;
+    }
+
+    if( sums[ BENCH_M_SCALAR ] != sums[ BENCH_M_DECODED ] ) {
+      fprintf( stderr, "%%BENCH-F-MISMATCH; The scalar and decoded modes disagree.\n" );
+      return( 2 );
+    }
+
+    for( mode = BENCH_M_LEX; mode <= BENCH_M_DECODED; mode++ ) {
+      for( isa = TEXTSCAN_ISA_SCALAR; isa < TEXTSCAN_C_ISAS; isa++ ) {
+        if( isa != ( selected = textscan_select( isa ) ) ) {
+          continue;
+        }
+        seconds = run_passes( input, length, mode );
+        printf( "; %-6s %-7s %-6s %10zu octets %8.3f GB/s in %8.3f GB/s out\n", base64 ? "base64" : "base16", modes[ mode ],
+                textscan_name( selected ), length, ( (double) length * BENCH_PASSES ) / seconds / 1e9,
+                ( (double) octets * BENCH_PASSES ) / seconds / 1e9 );
+      }
+    }
+
+    free( input );
+  }
+
+  textscan_select( TEXTSCAN_ISA_AUTO );
+
+  printf( "; END BENCHMARK\n" );
+
+  return( 0 );
+}
+
+/* build_input()
+**
+** Makes an array of BENCH_STRINGS random base16 or base64 strings, one to a
+** line (or, for base16, 32 octets to a line.)
+*/
+
+static unsigned char * build_input( int base64, size_t * length ) {
+  static const char alphabet [] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  static const char digits [] = "0123456789ABCDEF";
+  unsigned long long state = 88172645463325252ULL;
+  unsigned char * input;
+  char * out;
+  unsigned long i, quad;
+  unsigned int k, size;
+
+  if( NULL == ( input = malloc( (size_t) BENCH_STRINGS * ( 3 * BENCH_OCTETS + 8 ) ) ) ) {
+    return( NULL );
+  }
+
+  out = (char *) input;
+  out += sprintf( out, "[\n" );
+
+  for( i = 0; i < BENCH_STRINGS; i++ ) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    size = BENCH_OCTETS / 2 + (unsigned int) ( state % ( BENCH_OCTETS / 2 ) );
+
+    if( base64 ) {
+      size -= size % 3;
+      * out++ = '\'';
+      for( k = 0; k < size; k += 3 ) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        quad = (unsigned long) ( state & 0xFFFFFF );
+        * out++ = alphabet[ ( quad >> 18 ) & 63 ];
+        * out++ = alphabet[ ( quad >> 12 ) & 63 ];
+        * out++ = alphabet[ ( quad >> 6 ) & 63 ];
+        * out++ = alphabet[ quad & 63 ];
+      }
+      * out++ = '\'';
+    } else {
+      * out++ = '(';
+      for( k = 0; k < size; k++ ) {
+        state ^= state << 13;
+        state ^= state >> 7;
+        state ^= state << 17;
+        * out++ = digits[ ( state >> 4 ) & 15 ];
+        * out++ = digits[ state & 15 ];
+        if( 31 == k % 32 ) {
+          * out++ = '\n';
+        }
+      }
+      * out++ = ')';
+    }
+
+    * out++ = '\n';
+  }
+
+  out += sprintf( out, "]\n" );
+  * length = out - (char *) input;
+
+  return( input );
+}
+
+/* run_passes()
+**
+** Lexes the input BENCH_PASSES times and returns how many seconds it took.
+*/
+
+static double run_passes( unsigned char * input, size_t length, unsigned int mode ) {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ BENCH_BUFFER_SIZE ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  struct timespec start, stop;
+  size_t offset, chunk;
+  unsigned int pass;
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( pass = 0; pass < BENCH_PASSES; pass++ ) {
+    strings = 0;
+    octets = 0;
+    sum = 0;
+
+    textlex_init( & context, buffer, BENCH_BUFFER_SIZE );
+    textlex_extend( & context, & extension );
+    extension.span = ( BENCH_M_SCALAR == mode ) ? scalar_handler : lex_handler;
+    if( BENCH_M_DECODED == mode ) {
+      extension.decoded = decoded_handler;
+    }
+
+    for( offset = 0; offset < length; offset += chunk ) {
+      chunk = ( ( length - offset ) < BENCH_CHUNK_SIZE ) ? ( length - offset ) : BENCH_CHUNK_SIZE;
+      if( TEXTLEX_E_NOERR != ( err = textlex_update( & context, input + offset, chunk ) ) ) {
+        fprintf( stderr, "%%BENCH-F-UPDATE; Error %d at line %d, octet %d.\n", err, context.line, context.octet );
+        exit( 2 );
+      }
+    }
+
+    textlex_final( & context );
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+
+  if( BENCH_STRINGS != strings ) {
+    fprintf( stderr, "%%BENCH-F-COUNT; Lexed %lu strings, not %d.\n", strings, BENCH_STRINGS );
+    exit( 2 );
+  }
+
+  return( ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9 );
+}
+
+static tTextLexErr lex_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  if( ( TEXTLEX_T_HEX == token ) || ( TEXTLEX_T_BASE64 == token ) ) {
+    strings++;
+  }
+  return( TEXTLEX_E_NOERR );
+}
+
+/* scalar_handler()
+**
+** Decodes a string the way most programs would, one character at a time,
+** and adds up the octets so the compiler can't skip the work.
+*/
+
+static tTextLexErr scalar_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  unsigned long quad;
+  unsigned int i, k, c, value;
+
+  if( TEXTLEX_T_HEX == token ) {
+    for( i = 0; i + 2 <= length; i += 2 ) {
+      for( k = 0, value = 0; k < 2; k++ ) {
+        c = data[ i + k ];
+        value = ( value << 4 ) | ( ( c <= '9' ) ? ( c - '0' ) : ( ( c | 0x20 ) - 'a' + 10 ) );
+      }
+      sum += value;
+    }
+    octets += length / 2;
+    strings++;
+  } else if( TEXTLEX_T_BASE64 == token ) {
+    for( i = 0; i + 4 <= length; i += 4 ) {
+      for( k = 0, quad = 0; k < 4; k++ ) {
+        c = data[ i + k ];
+        value = ( c >= 'a' ) ? ( c - 71 ) : ( c >= 'A' ) ? ( c - 65 ) : ( c >= '0' ) ? ( c + 4 ) : ( '+' == c ) ? 62 : 63;
+        quad = ( quad << 6 ) | value;
+      }
+      sum += ( quad >> 16 ) + ( ( quad >> 8 ) & 255 ) + ( quad & 255 );
+    }
+    octets += 3 * ( length / 4 );
+    strings++;
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr decoded_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  tTextLexCount i;
+
+  for( i = 0; i < length; i++ ) {
+    sum += data[ i ];
+  }
+  octets += length;
+  strings++;
+
+  return( TEXTLEX_E_NOERR );
+}
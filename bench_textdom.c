@@ -0,0 +1,134 @@
+/* bench_textdom.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program measures how long it takes to lex a message, build its
+** tree, look a value up and throw the tree away again, for a small message
+** like the ones example_struct.c parses and for example.dsd. The builder and
+** arena are reused from one message to the next, the way a server would use
+** them.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_SMALL_MESSAGES  1000000
+#define BENCH_LARGE_MESSAGES  5000
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "textdom.h"
+
+/* Function Prototypes */
+
+static unsigned char * load_file( char * path, size_t * length );
+static void run( char * name, unsigned char * message, size_t length, unsigned long count, char * key );
+
+/* Global Variables */
+
+static char * small_message =
+  "@m{\"iterations\"=12 \"salt\"=\"01234567\" \"secret\"=(8a 4d 21 92 03 82 3c f8 6a 05 c5 ea 0c 40 be f4 c8 02 76 33)}";
+
+static tTextDomArena arena;
+static tTextDomContext context;
+
+int main( int argc, char * argv [] ) {
+  unsigned char * example;
+  size_t length;
+  char * path = ( argc > 1 ) ? argv[ 1 ] : "example.dsd";
+
+  if( NULL == ( example = load_file( path, & length ) ) ) {
+    fprintf( stderr, "%%BENCH-F-INPUT; Can't read input from %s.\n", path );
+    return( 1 );
+  }
+
+  textdom_arena_init( & arena );
+  if( TEXTLEX_E_NOERR != textdom_init( & context, & arena ) ) {
+    fprintf( stderr, "%%BENCH-F-MEMORY; Can't initialize the builder.\n" );
+    return( 1 );
+  }
+
+  printf( "; BEGIN BENCHMARK\n" );
+
+  run( "SMALL", (unsigned char *) small_message, strlen( small_message ), BENCH_SMALL_MESSAGES, "iterations" );
+  run( path, example, length, BENCH_LARGE_MESSAGES, "revision" );
+
+  printf( "; END BENCHMARK\n" );
+
+  textdom_free( & context );
+  textdom_arena_free( & arena );
+  free( example );
+
+  return( 0 );
+}
+
+static void run( char * name, unsigned char * message, size_t length, unsigned long count, char * key ) {
+  const tTextDomNode * root;
+  struct timespec start, stop;
+  long long value, sum = 0;
+  unsigned long i;
+  tTextLexErr err;
+  double seconds;
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( i = 0; i < count; i++ ) {
+    textdom_arena_reset( & arena );
+    textdom_reset( & context );
+
+    if( ( TEXTLEX_E_NOERR != ( err = textdom_update( & context, message, length ) ) ) ||
+        ( TEXTLEX_E_NOERR != ( err = textdom_final( & context, & root ) ) ) ) {
+      fprintf( stderr, "%%BENCH-F-BUILD; Error %d.\n", err );
+      exit( 2 );
+    }
+
+    if( textdom_integer( textdom_find( textdom_index( root, 0 ), key ), & value ) ) {
+      sum += value;
+    }
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+
+  seconds = ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9;
+
+  printf( "; %-12s %6zu octets %10.3f us/message %8.3f GB/s (%lld)\n", name, length,
+          seconds * 1e6 / count, (double) length * count / seconds / 1e9, sum / (long long) count );
+}
+
+static unsigned char * load_file( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * data = NULL;
+  long size;
+
+  if( NULL == ( file = fopen( path, "rb" ) ) ) {
+    return( NULL );
+  }
+
+  do {
+    if( ( 0 != fseek( file, 0, SEEK_END ) ) || ( ( size = ftell( file ) ) <= 0 ) || ( 0 != fseek( file, 0, SEEK_SET ) ) ) {
+      break;
+    }
+
+    if( NULL == ( data = malloc( size ) ) ) {
+      break;
+    }
+
+    if( (size_t) size != fread( data, 1, size, file ) ) {
+      free( data );
+      data = NULL;
+      break;
+    }
+
+    * length = size;
+  } while( 0 );
+
+  fclose( file );
+
+  return( data );
+}
@@ -0,0 +1,235 @@
+/* bench_textenc.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program measures the speed of the DSD Text Writer. It builds about
+** 32 megabytes of DSD/Text the same way bench_textlex does and rewrites it
+** (textlex feeding the writer) in compact and pretty mode. Then it writes a
+** few million integers and floats and writes the input out again as hex and
+** base64. Output goes to a 64 kilobyte buffer whose flush callback just
+** counts octets.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_INPUT_SIZE  ( 32 * 1024 * 1024 )
+#define BENCH_CHUNK_SIZE  ( 64 * 1024 )
+#define BENCH_OUTPUT_SIZE ( 64 * 1024 )
+#define BENCH_BUFFER_SIZE 4096
+#define BENCH_NUMBERS     ( 4 * 1024 * 1024 )
+#define BENCH_PASSES      5
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "textenc.h"
+
+/* Function Prototypes */
+
+static unsigned char * load_input( char * path, size_t * length );
+static double now( void );
+static double rewrite( unsigned char * input, size_t length, unsigned int mode );
+static double numbers( int floats );
+static double octets( unsigned char * input, size_t length, int base64 );
+static tTextLexErr flush_handler( tTextEncContext * context );
+static tTextLexErr span_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static void check( tTextLexErr err );
+
+/* Global Variables */
+
+static unsigned char output[ BENCH_OUTPUT_SIZE ];
+static tTextEncContext writer;
+static size_t flushed = 0;
+
+int main( int argc, char * argv [] ) {
+  unsigned char * input;
+  size_t length;
+  double seconds;
+  char * path = ( argc > 1 ) ? argv[ 1 ] : "example.dsd";
+
+  if( NULL == ( input = load_input( path, & length ) ) ) {
+    fprintf( stderr, "%%BENCH-F-INPUT; Can't read input from %s.\n", path );
+    return( 1 );
+  }
+
+  printf( "; BEGIN BENCHMARK %s (%zu octets)\n", path, length );
+
+  seconds = rewrite( input, length, TEXTENC_M_COMPACT );
+  printf( "; COMPACT    %8.3f GB/s in %8.3f GB/s out\n", length * BENCH_PASSES / seconds / 1e9, flushed * BENCH_PASSES / seconds / 1e9 );
+  seconds = rewrite( input, length, TEXTENC_M_PRETTY );
+  printf( "; PRETTY     %8.3f GB/s in %8.3f GB/s out\n", length * BENCH_PASSES / seconds / 1e9, flushed * BENCH_PASSES / seconds / 1e9 );
+
+  seconds = numbers( 0 );
+  printf( "; INTEGERS   %8.2f Mitems/s\n", (double) BENCH_NUMBERS * BENCH_PASSES / seconds / 1e6 );
+  seconds = numbers( 1 );
+  printf( "; FLOATS     %8.2f Mitems/s\n", (double) BENCH_NUMBERS * BENCH_PASSES / seconds / 1e6 );
+
+  seconds = octets( input, length, 0 );
+  printf( "; HEX        %8.3f GB/s in\n", length * BENCH_PASSES / seconds / 1e9 );
+  seconds = octets( input, length, 1 );
+  printf( "; BASE64     %8.3f GB/s in\n", length * BENCH_PASSES / seconds / 1e9 );
+
+  printf( "; END BENCHMARK\n" );
+
+  free( input );
+
+  return( 0 );
+}
+
+static unsigned char * load_input( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * seed = NULL;
+  unsigned char * input = NULL;
+  size_t seed_length = 0;
+  size_t seed_size = 4096;
+  size_t bytes_read;
+
+  do {
+    if( NULL == ( file = fopen( path, "rb" ) ) ) {
+      break;
+    }
+
+    if( NULL == ( seed = malloc( seed_size ) ) ) {
+      break;
+    }
+
+    while( 0 != ( bytes_read = fread( seed + seed_length, 1, seed_size - seed_length, file ) ) ) {
+      seed_length += bytes_read;
+      if( seed_length == seed_size ) {
+        seed_size *= 2;
+        if( NULL == ( seed = realloc( seed, seed_size ) ) ) {
+          break;
+        }
+      }
+    }
+
+    if( ( NULL == seed ) || ( 0 == seed_length ) ) {
+      break;
+    }
+
+    if( NULL == ( input = malloc( BENCH_INPUT_SIZE + seed_length + 1 ) ) ) {
+      break;
+    }
+
+    for( * length = 0; * length < BENCH_INPUT_SIZE; * length += seed_length + 1 ) {
+      memcpy( input + * length, seed, seed_length );
+      input[ * length + seed_length ] = '\n';
+    }
+  } while( 0 );
+
+  if( NULL != file ) {
+    fclose( file );
+  }
+
+  if( NULL != seed ) {
+    free( seed );
+  }
+
+  return( input );
+}
+
+static double now( void ) {
+  struct timespec ts;
+
+  clock_gettime( CLOCK_MONOTONIC, & ts );
+
+  return( ts.tv_sec + ts.tv_nsec / 1e9 );
+}
+
+static double rewrite( unsigned char * input, size_t length, unsigned int mode ) {
+  tTextLexBuffer buffer[ BENCH_BUFFER_SIZE ];
+  tTextLexContext lexxer;
+  tTextLexExtension extension;
+  size_t offset, chunk;
+  unsigned int pass;
+  double start = now();
+
+  for( pass = 0; pass < BENCH_PASSES; pass++ ) {
+    flushed = 0;
+    textenc_init( & writer, output, BENCH_OUTPUT_SIZE, mode );
+    writer.flush = flush_handler;
+    textlex_init( & lexxer, buffer, BENCH_BUFFER_SIZE );
+    textlex_extend( & lexxer, & extension );
+    extension.span = span_handler;
+
+    for( offset = 0; offset < length; offset += chunk ) {
+      chunk = ( ( length - offset ) < BENCH_CHUNK_SIZE ) ? ( length - offset ) : BENCH_CHUNK_SIZE;
+      check( textlex_update( & lexxer, input + offset, chunk ) );
+    }
+
+    check( textlex_final( & lexxer ) );
+    check( textenc_final( & writer ) );
+  }
+
+  return( now() - start );
+}
+
+static double numbers( int floats ) {
+  unsigned long long seed = 88172645463325252ULL;
+  unsigned int pass, i;
+  double start = now();
+
+  for( pass = 0; pass < BENCH_PASSES; pass++ ) {
+    textenc_init( & writer, output, BENCH_OUTPUT_SIZE, TEXTENC_M_COMPACT );
+    writer.flush = flush_handler;
+
+    check( textenc_token( & writer, TEXTLEX_T_ARRAY_OPEN ) );
+    for( i = 0; i < BENCH_NUMBERS; i++ ) {
+      seed ^= seed << 13;
+      seed ^= seed >> 7;
+      seed ^= seed << 17;
+      if( floats ) {
+        check( textenc_float( & writer, (double) ( seed % 10000000 ) / 1000.0 ) );
+      } else {
+        check( textenc_integer( & writer, (long long) ( seed >> ( seed & 63 ) ) ) );
+      }
+    }
+    check( textenc_token( & writer, TEXTLEX_T_ARRAY_CLOSE ) );
+    check( textenc_final( & writer ) );
+  }
+
+  return( now() - start );
+}
+
+static double octets( unsigned char * input, size_t length, int base64 ) {
+  unsigned int pass;
+  double start = now();
+
+  for( pass = 0; pass < BENCH_PASSES; pass++ ) {
+    textenc_init( & writer, output, BENCH_OUTPUT_SIZE, TEXTENC_M_COMPACT );
+    writer.flush = flush_handler;
+    check( base64 ? textenc_base64( & writer, input, length ) : textenc_octets( & writer, input, length, 1 ) );
+    check( textenc_final( & writer ) );
+  }
+
+  return( now() - start );
+}
+
+static tTextLexErr flush_handler( tTextEncContext * context ) {
+  flushed += context->index;
+  context->index = 0;
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr span_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  if( TEXTLEX_T_END == token ) {
+    return( TEXTLEX_E_NOERR );
+  } else if( token >= TEXTLEX_T_ARRAY_OPEN ) {
+    return( textenc_token( & writer, token ) );
+  }
+
+  return( textenc_text( & writer, token, data, length ) );
+}
+
+static void check( tTextLexErr err ) {
+  if( TEXTLEX_E_NOERR != err ) {
+    fprintf( stderr, "%%BENCH-F-WRITE; Error %d.\n", err );
+    exit( 2 );
+  }
+}
@@ -0,0 +1,347 @@
+/* bench_textio.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program is a load generator for the stream ingestion layer. It opens
+** a socket pair for each of a lot of streams (10,000 unless you say
+** otherwise) and forks a generator process that gets the other ends. The
+** generator takes turns writing a message like
+**
+**   { "t" = 1234567890123 "seq" = 7 "values" = [ 1 2 3 4 ] }
+**
+** to each stream, where t is when it was written (CLOCK_MONOTONIC, in
+** nanoseconds). The ingestion side picks t out of the tokens and, at the
+** '}', works out how long the message took to get through. It reports
+** messages per second and the median and 99th percentile latency, with
+** io_uring and with epoll.
+**
+**   bench_textio [streams [messages per stream]]
+**
+** The generator is its own process so that each side only needs one file
+** descriptor per stream; the ends are passed over a unix domain socket.
+*/
+
+/* Macro Definitions */
+
+#define _GNU_SOURCE
+
+#define BENCH_STREAMS     10000
+#define BENCH_MESSAGES    20
+#define BENCH_BUFFER_SIZE 64
+#define BENCH_C_PASS      64
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include "textio.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  tTextIoStream        stream;
+  tTextLexBuffer       buffer[ BENCH_BUFFER_SIZE ];
+  int                  want;
+  unsigned long long   sent;
+  unsigned int         count;
+  unsigned long long * latencies;
+} tConnection;
+
+/* Function Prototypes */
+
+static void run( unsigned int flags );
+static void generate( int control );
+static void pass( int control, int * fds, unsigned int count );
+static unsigned int receive( int control, int * fds );
+static unsigned long long now( void );
+static int compare( const void * a, const void * b );
+static tTextLexErr _token( tTextLexContext * context, tTextLexCount token );
+static void _done( tTextIoStream * stream, tTextLexErr err );
+
+/* Global Variables */
+
+static unsigned int streams = BENCH_STREAMS;
+static unsigned int messages = BENCH_MESSAGES;
+static tConnection * connections;
+static unsigned long long * latencies;
+static unsigned int failures;
+
+int main( int argc, char * argv [] ) {
+  struct rlimit limit;
+
+  if( argc > 1 ) {
+    streams = (unsigned int) atoi( argv[ 1 ] );
+  }
+  if( argc > 2 ) {
+    messages = (unsigned int) atoi( argv[ 2 ] );
+  }
+
+  if( 0 == getrlimit( RLIMIT_NOFILE, & limit ) ) {
+    limit.rlim_cur = limit.rlim_max;
+    setrlimit( RLIMIT_NOFILE, & limit );
+  }
+
+  connections = malloc( streams * sizeof( tConnection ) );
+  latencies = malloc( (size_t) streams * messages * sizeof( unsigned long long ) );
+  if( ( NULL == connections ) || ( NULL == latencies ) ) {
+    fprintf( stderr, "%%BENCH-F-MEMORY; Can't allocate the streams.\n" );
+    return( 1 );
+  }
+
+  printf( "; BEGIN BENCHMARK\n" );
+
+  run( 0 );
+  run( TEXTIO_F_EPOLL );
+
+  printf( "; END BENCHMARK\n" );
+
+  free( latencies );
+  free( connections );
+
+  return( 0 );
+}
+
+/* run()
+**
+** Forks the generator, hands it its ends of the streams and lexes until
+** they're all closed.
+*/
+
+static void run( unsigned int flags ) {
+  static const char * backends [] = { "none", "uring", "epoll" };
+  tTextIoContext context;
+  int control[ 2 ], fds[ 2 ], ends[ BENCH_C_PASS ];
+  unsigned long long start, stop, total;
+  unsigned int i, count = 0;
+  pid_t child;
+
+  if( TEXTLEX_E_NOERR != textio_init( & context, 0, flags ) ) {
+    fprintf( stderr, "%%BENCH-F-INIT; Can't start the ingestion layer.\n" );
+    exit( 2 );
+  }
+
+  if( ( 0 != socketpair( AF_UNIX, SOCK_STREAM, 0, control ) ) || ( 0 > ( child = fork() ) ) ) {
+    fprintf( stderr, "%%BENCH-F-FORK; Can't start the generator.\n" );
+    exit( 2 );
+  }
+
+  if( 0 == child ) {
+    close( control[ 0 ] );
+    generate( control[ 1 ] );
+    _exit( 0 );
+  }
+
+  close( control[ 1 ] );
+  failures = 0;
+
+  for( i = 0; i < streams; i++ ) {
+    tConnection * connection = & connections[ i ];
+
+    if( 0 != socketpair( AF_UNIX, SOCK_STREAM, 0, fds ) ) {
+      fprintf( stderr, "%%BENCH-F-SOCKET; Can't make stream %u.\n", i );
+      exit( 2 );
+    }
+
+    connection->want = 0;
+    connection->count = 0;
+    connection->latencies = latencies + (size_t) i * messages;
+
+    textlex_init( & connection->stream.lexxer, connection->buffer, BENCH_BUFFER_SIZE );
+    connection->stream.lexxer.token = _token;
+    connection->stream.done = _done;
+    connection->stream.user = connection;
+    textio_add( & context, & connection->stream, fds[ 0 ] );
+
+    ends[ count++ ] = fds[ 1 ];
+    if( ( BENCH_C_PASS == count ) || ( i + 1 == streams ) ) {
+      pass( control[ 0 ], ends, count );
+      for( ; 0 < count; count-- ) {
+        close( ends[ count - 1 ] );
+      }
+    }
+  }
+
+  close( control[ 0 ] );
+
+  start = now();
+  textio_run( & context );
+  stop = now();
+
+  waitpid( child, NULL, 0 );
+  textio_free( & context );
+
+  for( i = 0, total = 0; i < streams; i++ ) {
+    total += connections[ i ].count;
+  }
+
+  if( ( failures > 0 ) || ( total != (unsigned long long) streams * messages ) ) {
+    fprintf( stderr, "%%BENCH-F-LOST; %u streams failed and %llu of %llu messages got through.\n", failures, total,
+             (unsigned long long) streams * messages );
+    exit( 2 );
+  }
+
+  qsort( latencies, total, sizeof( unsigned long long ), compare );
+
+  printf( "; %-5s %6u streams %8llu messages %10.0f messages/s p50 %9.1f us p99 %9.1f us\n", backends[ context.backend ], streams,
+          total, (double) total * 1e9 / (double) ( stop - start ), latencies[ total / 2 ] / 1e3, latencies[ ( total * 99 ) / 100 ] / 1e3 );
+}
+
+/* generate()
+**
+** The generator process. Collects its ends of the streams and writes a
+** message to each in turn, then closes them all.
+*/
+
+static void generate( int control ) {
+  char message[ 128 ];
+  int * fds;
+  unsigned int i, m, count = 0;
+  ssize_t length;
+
+  if( NULL == ( fds = malloc( streams * sizeof( int ) ) ) ) {
+    _exit( 2 );
+  }
+
+  while( count < streams ) {
+    count += receive( control, fds + count );
+  }
+  close( control );
+
+  for( m = 0; m < messages; m++ ) {
+    for( i = 0; i < streams; i++ ) {
+      length = sprintf( message, "{ \"t\" = %llu \"seq\" = %u \"values\" = [ 1 2 3 4 ] }\n", now(), m );
+      if( length != write( fds[ i ], message, (size_t) length ) ) {
+        _exit( 2 );
+      }
+    }
+  }
+
+  for( i = 0; i < streams; i++ ) {
+    close( fds[ i ] );
+  }
+
+  free( fds );
+}
+
+static void pass( int control, int * fds, unsigned int count ) {
+  union {
+    struct cmsghdr header;
+    char           space[ CMSG_SPACE( sizeof( int ) * BENCH_C_PASS ) ];
+  } data;
+  struct msghdr message;
+  struct cmsghdr * header;
+  struct iovec vector;
+  char byte = 0;
+
+  memset( & message, 0, sizeof( message ) );
+  memset( & data, 0, sizeof( data ) );
+  vector.iov_base = & byte;
+  vector.iov_len = 1;
+  message.msg_iov = & vector;
+  message.msg_iovlen = 1;
+  message.msg_control = data.space;
+  message.msg_controllen = CMSG_SPACE( sizeof( int ) * count );
+
+  header = CMSG_FIRSTHDR( & message );
+  header->cmsg_level = SOL_SOCKET;
+  header->cmsg_type = SCM_RIGHTS;
+  header->cmsg_len = CMSG_LEN( sizeof( int ) * count );
+  memcpy( CMSG_DATA( header ), fds, sizeof( int ) * count );
+
+  if( 1 != sendmsg( control, & message, 0 ) ) {
+    fprintf( stderr, "%%BENCH-F-PASS; Can't pass streams to the generator.\n" );
+    exit( 2 );
+  }
+}
+
+static unsigned int receive( int control, int * fds ) {
+  union {
+    struct cmsghdr header;
+    char           space[ CMSG_SPACE( sizeof( int ) * BENCH_C_PASS ) ];
+  } data;
+  struct msghdr message;
+  struct cmsghdr * header;
+  struct iovec vector;
+  char byte;
+  unsigned int count;
+
+  memset( & message, 0, sizeof( message ) );
+  vector.iov_base = & byte;
+  vector.iov_len = 1;
+  message.msg_iov = & vector;
+  message.msg_iovlen = 1;
+  message.msg_control = data.space;
+  message.msg_controllen = sizeof( data.space );
+
+  if( ( 1 != recvmsg( control, & message, 0 ) ) || ( NULL == ( header = CMSG_FIRSTHDR( & message ) ) ) ) {
+    _exit( 2 );
+  }
+
+  count = (unsigned int) ( ( header->cmsg_len - CMSG_LEN( 0 ) ) / sizeof( int ) );
+  memcpy( fds, CMSG_DATA( header ), sizeof( int ) * count );
+
+  return( count );
+}
+
+static unsigned long long now( void ) {
+  struct timespec time;
+
+  clock_gettime( CLOCK_MONOTONIC, & time );
+
+  return( (unsigned long long) time.tv_sec * 1000000000ULL + (unsigned long long) time.tv_nsec );
+}
+
+static int compare( const void * a, const void * b ) {
+  unsigned long long x = * (const unsigned long long *) a;
+  unsigned long long y = * (const unsigned long long *) b;
+
+  return( ( x > y ) - ( x < y ) );
+}
+
+/* _token()
+**
+** Runs on a worker. Watches for the "t" key, remembers the integer after
+** it and works out the message's latency at the closing brace.
+*/
+
+static tTextLexErr _token( tTextLexContext * context, tTextLexCount token ) {
+  tConnection * connection = (tConnection *) ( (tTextIoStream *) context )->user;
+  tTextLexCount i;
+
+  switch( token ) {
+  case TEXTLEX_T_STRING:
+    connection->want = ( 1 == context->index ) && ( 't' == context->buffer[ 0 ] );
+    break;
+
+  case TEXTLEX_T_INTEGER:
+    if( connection->want ) {
+      for( i = 0, connection->sent = 0; i < context->index; i++ ) {
+        connection->sent = connection->sent * 10 + ( context->buffer[ i ] - '0' );
+      }
+      connection->want = 0;
+    }
+    break;
+
+  case TEXTLEX_T_MAP_CLOSE:
+    if( connection->count < messages ) {
+      connection->latencies[ connection->count++ ] = now() - connection->sent;
+    }
+    break;
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static void _done( tTextIoStream * stream, tTextLexErr err ) {
+  if( TEXTLEX_E_NOERR != err ) {
+    __atomic_add_fetch( & failures, 1, __ATOMIC_RELAXED );
+  }
+  close( stream->fd );
+}
@@ -0,0 +1,260 @@
+/* bench_textlex.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program measures how fast textlex_update() chews through DSD text.
+** It reads a DSD file (example.dsd by default), repeats it until it has
+** about 32 megabytes of input and then lexes that input several times,
+** printing the throughput in gigabytes per second.
+**
+** When compiled normally, it runs once for each bulk scanner implementation
+** the CPU supports, with the token callback, with the zero-copy span
+** callback and with the token callback and comments and annotations masked
+** out (see Token Mask in textlex.h). When compiled with -DTEXTLEX_NO_SCAN
+** (and linked against a textlex.o compiled the same way) it measures the
+** octet-at-a-time loop instead. Compile it with -DTEXTLEX_DFA (and link it against a
+** textlex.o compiled the same way) to measure the table driven engine.
+** Compile it with -DTEXTLEX_STATS (ditto) to see what the statistics cost;
+** it writes out the statistics from the last pass at the end, or with
+** -DTEXTLEX_LAZY_LINES (ditto) to see what counting lines lazily saves.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_INPUT_SIZE  ( 32 * 1024 * 1024 )
+#define BENCH_CHUNK_SIZE  ( 64 * 1024 )
+#define BENCH_BUFFER_SIZE 4096
+#define BENCH_PASSES      5
+
+#define BENCH_M_TOKEN     0
+#define BENCH_M_SPAN      1
+#define BENCH_M_SKIP      2
+
+#ifdef TEXTLEX_DFA
+#define BENCH_ENGINE "dfa"
+#else
+#define BENCH_ENGINE "switch"
+#endif
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "textlex.h"
+
+#ifndef TEXTLEX_NO_SCAN
+#include "textscan.h"
+#endif
+
+#ifdef TEXTLEX_STATS
+#include "textstat.h"
+#endif
+
+/* Function Prototypes */
+
+static unsigned char * load_input( char * path, size_t * length );
+static double run_passes( unsigned char * input, size_t length, int mode );
+static tTextLexErr token_handler( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr span_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+
+#ifdef TEXTLEX_STATS
+static void write_stats( void );
+static tTextLexErr flush_stats( tTextEncContext * context );
+#endif
+
+/* Global Variables */
+
+static unsigned long tokens = 0;
+
+#ifdef TEXTLEX_STATS
+static tTextLexStats stats;
+#endif
+
+int main( int argc, char * argv [] ) {
+  unsigned char * input;
+  size_t length;
+  double seconds;
+  char * path = ( argc > 1 ) ? argv[ 1 ] : "example.dsd";
+#ifndef TEXTLEX_NO_SCAN
+  unsigned int isa, selected;
+#endif
+
+  if( NULL == ( input = load_input( path, & length ) ) ) {
+    fprintf( stderr, "%%BENCH-F-INPUT; Can't read input from %s.\n", path );
+    return( 1 );
+  }
+
+  printf( "; BEGIN BENCHMARK %s (%zu octets) ENGINE %s\n", path, length, BENCH_ENGINE );
+
+#ifndef TEXTLEX_NO_SCAN
+  for( isa = TEXTSCAN_ISA_SCALAR; isa < TEXTSCAN_C_ISAS; isa++ ) {
+    if( isa != ( selected = textscan_select( isa ) ) ) {
+      continue;
+    }
+    seconds = run_passes( input, length, BENCH_M_TOKEN );
+    printf( "; SCAN %-12s %8.3f GB/s %10lu tokens\n", textscan_name( selected ),
+            ( (double) length * BENCH_PASSES ) / seconds / 1e9, tokens / BENCH_PASSES );
+    seconds = run_passes( input, length, BENCH_M_SPAN );
+    printf( "; SPAN %-12s %8.3f GB/s %10lu tokens\n", textscan_name( selected ),
+            ( (double) length * BENCH_PASSES ) / seconds / 1e9, tokens / BENCH_PASSES );
+    seconds = run_passes( input, length, BENCH_M_SKIP );
+    printf( "; SKIP %-12s %8.3f GB/s %10lu tokens\n", textscan_name( selected ),
+            ( (double) length * BENCH_PASSES ) / seconds / 1e9, tokens / BENCH_PASSES );
+  }
+#else
+  seconds = run_passes( input, length, BENCH_M_TOKEN );
+  printf( "; SCAN %-12s %8.3f GB/s %10lu tokens\n", "byte-loop",
+          ( (double) length * BENCH_PASSES ) / seconds / 1e9, tokens / BENCH_PASSES );
+  seconds = run_passes( input, length, BENCH_M_SKIP );
+  printf( "; SKIP %-12s %8.3f GB/s %10lu tokens\n", "byte-loop",
+          ( (double) length * BENCH_PASSES ) / seconds / 1e9, tokens / BENCH_PASSES );
+#endif
+
+#ifdef TEXTLEX_STATS
+  write_stats();
+#endif
+
+  printf( "; END BENCHMARK\n" );
+
+  free( input );
+
+  return( 0 );
+}
+
+static unsigned char * load_input( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * seed = NULL;
+  unsigned char * input = NULL;
+  size_t seed_length = 0;
+  size_t seed_size = 4096;
+  size_t bytes_read;
+
+  do {
+    if( NULL == ( file = fopen( path, "rb" ) ) ) {
+      break;
+    }
+
+    if( NULL == ( seed = malloc( seed_size ) ) ) {
+      break;
+    }
+
+    while( 0 != ( bytes_read = fread( seed + seed_length, 1, seed_size - seed_length, file ) ) ) {
+      seed_length += bytes_read;
+      if( seed_length == seed_size ) {
+        seed_size *= 2;
+        if( NULL == ( seed = realloc( seed, seed_size ) ) ) {
+          break;
+        }
+      }
+    }
+
+    if( ( NULL == seed ) || ( 0 == seed_length ) ) {
+      break;
+    }
+
+    /* Repeat the seed document until we have enough input. Separating the
+    ** copies with a line feed keeps a trailing comment or number in the
+    ** seed from running into the start of the next copy.
+    */
+
+    if( NULL == ( input = malloc( BENCH_INPUT_SIZE + seed_length + 1 ) ) ) {
+      break;
+    }
+
+    for( * length = 0; * length < BENCH_INPUT_SIZE; * length += seed_length + 1 ) {
+      memcpy( input + * length, seed, seed_length );
+      input[ * length + seed_length ] = '\n';
+    }
+  } while( 0 );
+
+  if( NULL != file ) {
+    fclose( file );
+  }
+
+  if( NULL != seed ) {
+    free( seed );
+  }
+
+  return( input );
+}
+
+static double run_passes( unsigned char * input, size_t length, int mode ) {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ BENCH_BUFFER_SIZE ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  struct timespec start, stop;
+  size_t offset, chunk;
+  unsigned int pass;
+
+  tokens = 0;
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( pass = 0; pass < BENCH_PASSES; pass++ ) {
+    textlex_init( & context, buffer, BENCH_BUFFER_SIZE );
+    if( BENCH_M_SPAN == mode ) {
+      textlex_extend( & context, & extension );
+      extension.span = span_handler;
+    } else {
+      context.token = token_handler;
+    }
+    if( BENCH_M_SKIP == mode ) {
+      textlex_extend( & context, & extension );
+      extension.wanted &= ~ ( TEXTLEX_M( TEXTLEX_T_COMMENT ) | TEXTLEX_M( TEXTLEX_T_ANNOTATION ) );
+    }
+
+    for( offset = 0; offset < length; offset += chunk ) {
+      chunk = ( ( length - offset ) < BENCH_CHUNK_SIZE ) ? ( length - offset ) : BENCH_CHUNK_SIZE;
+      if( TEXTLEX_E_NOERR != ( err = textlex_update( & context, input + offset, chunk ) ) ) {
+        fprintf( stderr, "%%BENCH-F-UPDATE; Error %d at line %d, octet %d.\n", err, context.line, context.octet );
+        exit( 2 );
+      }
+    }
+
+    textlex_final( & context );
+  }
+
+#ifdef TEXTLEX_STATS
+  stats = context.stats;
+#endif
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+
+  return( ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9 );
+}
+
+static tTextLexErr token_handler( tTextLexContext * context, tTextLexCount token ) {
+  tokens++;
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr span_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  tokens++;
+  return( TEXTLEX_E_NOERR );
+}
+
+#ifdef TEXTLEX_STATS
+
+static void write_stats( void ) {
+  tTextEncContext writer;
+  unsigned char buffer[ 256 ];
+
+  textenc_init( & writer, buffer, sizeof( buffer ), TEXTENC_M_PRETTY );
+  writer.flush = flush_stats;
+  textstat_write( & writer, & stats );
+  textenc_final( & writer );
+}
+
+static tTextLexErr flush_stats( tTextEncContext * context ) {
+  fwrite( context->buffer, 1, context->index, stdout );
+  context->index = 0;
+  return( TEXTLEX_E_NOERR );
+}
+
+#endif
@@ -0,0 +1,272 @@
+/* bench_textlexpp.cpp
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program measures dsd::TextLexer against the C lexxer it was ported
+** from. It builds a big array of short numbers and a map of commented
+** records, like
+**
+**   # record 17
+**   *record = { *name = "item 4211" *size = 17 *ratio = 0.25 @t *flag = *true }
+**
+** and lexes each of them three ways:
+**
+**   c       : textlex_update() with a span callback
+**   cpp     : TextLexer with a handler that wants every token
+**   quiet   : TextLexer with a handler that leaves out on_comment() and
+**             on_annotation(), so they're skipped
+**
+** printing how many tokens per second each gets through. Before timing
+** anything, it checks the first two see the same tokens.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_VALUES      2000000
+#define BENCH_RECORDS     200000
+#define BENCH_CHUNK_SIZE  ( 64 * 1024 )
+#define BENCH_BUFFER_SIZE 4096
+#define BENCH_PASSES      5
+#define BENCH_VALUE_TEXT  16
+#define BENCH_RECORD_TEXT 128
+
+#define BENCH_M_C         0
+#define BENCH_M_CPP       1
+#define BENCH_M_QUIET     2
+
+/* File Includes */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <time.h>
+#include "textlex.hpp"
+
+/* Structs, Typedefs, Unions & Enums */
+
+/* The handlers count the tokens and add up the lexeme lengths, like the
+** span callback in bench_textbatch.c.
+*/
+
+struct CountHandler {
+  unsigned long tokens = 0;
+  unsigned long long octets = 0;
+
+  tTextLexErr value( tTextLexCount length ) { tokens++; octets += length; return( TEXTLEX_E_NOERR ); }
+
+  tTextLexErr on_comment( const tTextLexBuffer * data, tTextLexCount length ) { return( value( length ) ); }
+  tTextLexErr on_annotation( const tTextLexBuffer * data, tTextLexCount length ) { return( value( length ) ); }
+  tTextLexErr on_literal( const tTextLexBuffer * data, tTextLexCount length ) { return( value( length ) ); }
+  tTextLexErr on_integer( const tTextLexBuffer * data, tTextLexCount length ) { return( value( length ) ); }
+  tTextLexErr on_float( const tTextLexBuffer * data, tTextLexCount length ) { return( value( length ) ); }
+  tTextLexErr on_hex( const tTextLexBuffer * data, tTextLexCount length ) { return( value( length ) ); }
+  tTextLexErr on_string( const tTextLexBuffer * data, tTextLexCount length ) { return( value( length ) ); }
+  tTextLexErr on_base64( const tTextLexBuffer * data, tTextLexCount length ) { return( value( length ) ); }
+  tTextLexErr on_end() { return( value( 0 ) ); }
+  tTextLexErr on_array_open() { return( value( 0 ) ); }
+  tTextLexErr on_array_close() { return( value( 0 ) ); }
+  tTextLexErr on_map_open() { return( value( 0 ) ); }
+  tTextLexErr on_map_close() { return( value( 0 ) ); }
+  tTextLexErr on_equals() { return( value( 0 ) ); }
+};
+
+struct QuietHandler {
+  unsigned long tokens = 0;
+  unsigned long long octets = 0;
+
+  tTextLexErr value( tTextLexCount length ) { tokens++; octets += length; return( TEXTLEX_E_NOERR ); }
+
+  tTextLexErr on_literal( const tTextLexBuffer * data, tTextLexCount length ) { return( value( length ) ); }
+  tTextLexErr on_integer( const tTextLexBuffer * data, tTextLexCount length ) { return( value( length ) ); }
+  tTextLexErr on_float( const tTextLexBuffer * data, tTextLexCount length ) { return( value( length ) ); }
+  tTextLexErr on_hex( const tTextLexBuffer * data, tTextLexCount length ) { return( value( length ) ); }
+  tTextLexErr on_string( const tTextLexBuffer * data, tTextLexCount length ) { return( value( length ) ); }
+  tTextLexErr on_base64( const tTextLexBuffer * data, tTextLexCount length ) { return( value( length ) ); }
+  tTextLexErr on_end() { return( value( 0 ) ); }
+  tTextLexErr on_array_open() { return( value( 0 ) ); }
+  tTextLexErr on_array_close() { return( value( 0 ) ); }
+  tTextLexErr on_map_open() { return( value( 0 ) ); }
+  tTextLexErr on_map_close() { return( value( 0 ) ); }
+  tTextLexErr on_equals() { return( value( 0 ) ); }
+};
+
+/* Function Prototypes */
+
+static unsigned char * build_input( int map, size_t * length );
+static double run_passes( unsigned char * input, size_t length, unsigned int mode );
+template< class Handler > static void run_cpp( Handler & handler, unsigned char * input, size_t length );
+static tTextLexErr span_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+
+/* Global Variables */
+
+static const char * modes [] = { "c", "cpp", "quiet" };
+static unsigned long tokens_seen = 0;
+static unsigned long long octets = 0;
+
+int main( int argc, char * argv [] ) {
+  unsigned char * input;
+  size_t length;
+  double seconds;
+  unsigned long counts[ 3 ];
+  unsigned long long sums[ 3 ];
+  unsigned int mode;
+  int map;
+
+  printf( "; BEGIN BENCHMARK\n" );
+
+  for( map = 0; map <= 1; map++ ) {
+    if( nullptr == ( input = build_input( map, & length ) ) ) {
+      fprintf( stderr, "%%BENCH-F-MEMORY; Can't allocate the input.\n" );
+      return( 1 );
+    }
+
+    for( mode = BENCH_M_C; mode <= BENCH_M_QUIET; mode++ ) {
+      run_passes( input, length, mode );
+      counts[ mode ] = tokens_seen;
+      sums[ mode ] = octets;
+    }
+
+    if( ( counts[ BENCH_M_C ] != counts[ BENCH_M_CPP ] ) || ( sums[ BENCH_M_C ] != sums[ BENCH_M_CPP ] ) ) {
+      fprintf( stderr, "%%BENCH-F-MISMATCH; The C and C++ lexxers disagree.\n" );
+      return( 2 );
+    }
+
+    for( mode = BENCH_M_C; mode <= BENCH_M_QUIET; mode++ ) {
+      seconds = run_passes( input, length, mode );
+      printf( "; %-5s %-5s %10zu octets %10lu tokens %8.2f Mtokens/s %8.3f GB/s\n", map ? "map" : "array", modes[ mode ],
+              length, tokens_seen, ( (double) tokens_seen * BENCH_PASSES ) / seconds / 1e6,
+              ( (double) length * BENCH_PASSES ) / seconds / 1e9 );
+    }
+
+    free( input );
+  }
+
+  printf( "; END BENCHMARK\n" );
+
+  return( 0 );
+}
+
+/* build_input()
+**
+** Makes an array of BENCH_VALUES short random numbers (about half of them
+** floats, twenty to a line) or a map of BENCH_RECORDS commented records.
+*/
+
+static unsigned char * build_input( int map, size_t * length ) {
+  unsigned long long state = 88172645463325252ULL;
+  unsigned char * input;
+  char * out;
+  unsigned long i;
+
+  if( nullptr == ( input = (unsigned char *) malloc( map ? (size_t) BENCH_RECORDS * BENCH_RECORD_TEXT : (size_t) BENCH_VALUES * BENCH_VALUE_TEXT ) ) ) {
+    return( nullptr );
+  }
+
+  out = (char *) input;
+  out += sprintf( out, "%c\n", map ? '{' : '[' );
+
+  for( i = 0; i < ( map ? BENCH_RECORDS : BENCH_VALUES ); i++ ) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    if( map ) {
+      out += sprintf( out, "# record %lu\n*record = { *name = \"item %u\" *size = %u *ratio = 0.%u @t *flag = *%s }\n", i,
+                      (unsigned int) ( state % 100000 ), (unsigned int) ( ( state >> 20 ) % 1000 ), (unsigned int) ( ( state >> 30 ) % 100 ),
+                      ( state & 0x100 ) ? "true" : "false" );
+    } else {
+      if( state & 0x100 ) {
+        out += sprintf( out, "%s%u.%u", ( state & 0x200 ) ? "-" : "", (unsigned int) ( ( state >> 10 ) % 100 ), (unsigned int) ( ( state >> 20 ) % 10 ) );
+      } else {
+        out += sprintf( out, "%s%u", ( state & 0x200 ) ? "-" : "", (unsigned int) ( ( state >> 10 ) % 1000 ) );
+      }
+      * out++ = ( 19 == i % 20 ) ? '\n' : ' ';
+    }
+  }
+
+  out += sprintf( out, "%c\n", map ? '}' : ']' );
+  * length = out - (char *) input;
+
+  return( input );
+}
+
+/* run_passes()
+**
+** Lexes the input BENCH_PASSES times and returns how many seconds it took.
+*/
+
+static double run_passes( unsigned char * input, size_t length, unsigned int mode ) {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ BENCH_BUFFER_SIZE ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  struct timespec start, stop;
+  size_t offset, chunk;
+  unsigned int pass;
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( pass = 0; pass < BENCH_PASSES; pass++ ) {
+    tokens_seen = 0;
+    octets = 0;
+
+    if( BENCH_M_CPP == mode ) {
+      CountHandler handler;
+      run_cpp( handler, input, length );
+      tokens_seen = handler.tokens;
+      octets = handler.octets;
+      continue;
+    } else if( BENCH_M_QUIET == mode ) {
+      QuietHandler handler;
+      run_cpp( handler, input, length );
+      tokens_seen = handler.tokens;
+      octets = handler.octets;
+      continue;
+    }
+
+    textlex_init( & context, buffer, BENCH_BUFFER_SIZE );
+    textlex_extend( & context, & extension );
+    extension.span = span_handler;
+
+    for( offset = 0; offset < length; offset += chunk ) {
+      chunk = ( ( length - offset ) < BENCH_CHUNK_SIZE ) ? ( length - offset ) : BENCH_CHUNK_SIZE;
+      if( TEXTLEX_E_NOERR != ( err = textlex_update( & context, input + offset, chunk ) ) ) {
+        fprintf( stderr, "%%BENCH-F-UPDATE; Error %d at line %d, octet %d.\n", err, context.line, context.octet );
+        exit( 2 );
+      }
+    }
+
+    textlex_final( & context );
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+
+  return( ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9 );
+}
+
+template< class Handler >
+static void run_cpp( Handler & handler, unsigned char * input, size_t length ) {
+  tTextLexBuffer buffer[ BENCH_BUFFER_SIZE ];
+  dsd::TextLexer< Handler > lexer( handler, buffer, BENCH_BUFFER_SIZE );
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t offset, chunk;
+
+  for( offset = 0; offset < length; offset += chunk ) {
+    chunk = ( ( length - offset ) < BENCH_CHUNK_SIZE ) ? ( length - offset ) : BENCH_CHUNK_SIZE;
+    if( TEXTLEX_E_NOERR != ( err = lexer.update( input + offset, chunk ) ) ) {
+      fprintf( stderr, "%%BENCH-F-UPDATE; Error %d at line %d, octet %d.\n", err, lexer.line(), lexer.octet() );
+      exit( 2 );
+    }
+  }
+
+  lexer.final();
+}
+
+static tTextLexErr span_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  tokens_seen++;
+  octets += length;
+  return( TEXTLEX_E_NOERR );
+}
@@ -0,0 +1,232 @@
+/* bench_textnum.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program measures the lexxer's typed number mode against converting
+** numbers the usual way, with strtod() and strtoll() in a span callback. It
+** builds two big arrays, one of random floats (with between 1 and 17 digits
+** after the point, half of them with an exponent) and one of random
+** integers, then lexes each of them three ways:
+**
+**   lex    : span callback only; what lexing costs without converting
+**   strtod : span callback copying each number out and calling strtod()
+**            (or strtoll() for the integers)
+**   typed  : number callback, with the digits added up by the lexxer
+**
+** Before timing anything, it checks the last two get the same numbers.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_NUMBERS     1000000
+#define BENCH_CHUNK_SIZE  ( 64 * 1024 )
+#define BENCH_BUFFER_SIZE 4096
+#define BENCH_PASSES      5
+#define BENCH_NUMBER_TEXT 64
+
+#define BENCH_M_LEX       0
+#define BENCH_M_STRTOD    1
+#define BENCH_M_TYPED     2
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "textlex.h"
+
+/* Function Prototypes */
+
+static unsigned char * build_input( int floats, size_t * length );
+static double run_passes( unsigned char * input, size_t length, unsigned int mode );
+static tTextLexErr lex_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr strtod_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr number_handler( tTextLexContext * context, tTextLexCount token, tTextNumValue * value, tTextLexBuffer * data, tTextLexCount length );
+
+/* Global Variables */
+
+static const char * modes [] = { "lex", "strtod", "typed" };
+static unsigned long numbers = 0;
+static double real_sum = 0.0;
+static long long integer_sum = 0;
+
+int main( int argc, char * argv [] ) {
+  unsigned char * input;
+  size_t length;
+  double seconds, sums[ 3 ];
+  long long integers[ 3 ];
+  unsigned int mode;
+  int floats;
+
+  printf( "; BEGIN BENCHMARK\n" );
+
+  for( floats = 1; floats >= 0; floats-- ) {
+    if( NULL == ( input = build_input( floats, & length ) ) ) {
+      fprintf( stderr, "%%BENCH-F-MEMORY; Can't allocate the input.\n" );
+      return( 1 );
+    }
+
+    for( mode = BENCH_M_LEX; mode <= BENCH_M_TYPED; mode++ ) {
+      run_passes( input, length, mode );
+      sums[ mode ] = real_sum;
+      integers[ mode ] = integer_sum;
+    }
+
+    if( ( sums[ BENCH_M_STRTOD ] != sums[ BENCH_M_TYPED ] ) || ( integers[ BENCH_M_STRTOD ] != integers[ BENCH_M_TYPED ] ) ) {
+      fprintf( stderr, "%%BENCH-F-MISMATCH; strtod() and the typed number mode disagree.\n" );
+      return( 2 );
+    }
+
+    for( mode = BENCH_M_LEX; mode <= BENCH_M_TYPED; mode++ ) {
+      seconds = run_passes( input, length, mode );
+      printf( "; %-8s %-6s %10zu octets %8.3f ns/number %8.3f GB/s\n", floats ? "floats" : "integers", modes[ mode ], length,
+              seconds * 1e9 / ( (double) BENCH_NUMBERS * BENCH_PASSES ), ( (double) length * BENCH_PASSES ) / seconds / 1e9 );
+    }
+
+    free( input );
+  }
+
+  printf( "; END BENCHMARK\n" );
+
+  return( 0 );
+}
+
+/* build_input()
+**
+** Makes an array of BENCH_NUMBERS random floats or integers, ten to a line.
+*/
+
+static unsigned char * build_input( int floats, size_t * length ) {
+  unsigned long long state = 88172645463325252ULL;
+  unsigned char * input;
+  char * out;
+  unsigned long long scale, fraction;
+  unsigned long i;
+  unsigned int places, k;
+
+  if( NULL == ( input = malloc( (size_t) BENCH_NUMBERS * BENCH_NUMBER_TEXT ) ) ) {
+    return( NULL );
+  }
+
+  out = (char *) input;
+  out += sprintf( out, "[\n" );
+
+  for( i = 0; i < BENCH_NUMBERS; i++ ) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    if( floats ) {
+      places = 1 + (unsigned int) ( state % 17 );
+      for( k = 0, scale = 1; k < places; k++ ) {
+        scale *= 10;
+      }
+      fraction = state;
+      fraction ^= fraction << 13;
+      fraction ^= fraction >> 7;
+      fraction ^= fraction << 17;
+      out += sprintf( out, "%s%u.%0*llu", ( state & 0x100 ) ? "-" : "", (unsigned int) ( ( state >> 9 ) % 100000 ),
+                      (int) places, fraction % scale );
+      if( state & 0x200 ) {
+        out += sprintf( out, "e%s%u", ( state & 0x400 ) ? "-" : "", (unsigned int) ( ( state >> 40 ) % 300 ) );
+      }
+    } else {
+      out += sprintf( out, "%lld", (long long) ( state >> ( 1 + state % 48 ) ) * ( ( state & 0x100 ) ? -1 : 1 ) );
+    }
+
+    * out++ = ( 9 == i % 10 ) ? '\n' : ' ';
+  }
+
+  out += sprintf( out, "]\n" );
+  * length = out - (char *) input;
+
+  return( input );
+}
+
+/* run_passes()
+**
+** Lexes the input BENCH_PASSES times and returns how many seconds it took.
+*/
+
+static double run_passes( unsigned char * input, size_t length, unsigned int mode ) {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ BENCH_BUFFER_SIZE ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  struct timespec start, stop;
+  size_t offset, chunk;
+  unsigned int pass;
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( pass = 0; pass < BENCH_PASSES; pass++ ) {
+    numbers = 0;
+    real_sum = 0.0;
+    integer_sum = 0;
+
+    textlex_init( & context, buffer, BENCH_BUFFER_SIZE );
+    textlex_extend( & context, & extension );
+    extension.span = ( BENCH_M_STRTOD == mode ) ? strtod_handler : lex_handler;
+    if( BENCH_M_TYPED == mode ) {
+      extension.number = number_handler;
+    }
+
+    for( offset = 0; offset < length; offset += chunk ) {
+      chunk = ( ( length - offset ) < BENCH_CHUNK_SIZE ) ? ( length - offset ) : BENCH_CHUNK_SIZE;
+      if( TEXTLEX_E_NOERR != ( err = textlex_update( & context, input + offset, chunk ) ) ) {
+        fprintf( stderr, "%%BENCH-F-UPDATE; Error %d at line %d, octet %d.\n", err, context.line, context.octet );
+        exit( 2 );
+      }
+    }
+
+    textlex_final( & context );
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+
+  if( BENCH_NUMBERS != numbers ) {
+    fprintf( stderr, "%%BENCH-F-COUNT; Lexed %lu numbers, not %d.\n", numbers, BENCH_NUMBERS );
+    exit( 2 );
+  }
+
+  return( ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9 );
+}
+
+static tTextLexErr lex_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  if( ( TEXTLEX_T_INTEGER == token ) || ( TEXTLEX_T_FLOAT == token ) ) {
+    numbers++;
+  }
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr strtod_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  char text[ BENCH_NUMBER_TEXT ];
+
+  if( ( TEXTLEX_T_INTEGER == token ) || ( TEXTLEX_T_FLOAT == token ) ) {
+    memcpy( text, data, length );
+    text[ length ] = '\0';
+    if( TEXTLEX_T_INTEGER == token ) {
+      integer_sum += strtoll( text, NULL, 10 );
+    } else {
+      real_sum += strtod( text, NULL );
+    }
+    numbers++;
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr number_handler( tTextLexContext * context, tTextLexCount token, tTextNumValue * value, tTextLexBuffer * data, tTextLexCount length ) {
+  if( TEXTLEX_T_INTEGER == token ) {
+    integer_sum += value->integer;
+  } else {
+    real_sum += value->real;
+  }
+  numbers++;
+
+  return( TEXTLEX_E_NOERR );
+}
@@ -0,0 +1,242 @@
+/* bench_textpar.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program measures how fast textpar_update() lexes DSD text with
+** different numbers of threads. Like bench_textlex, it repeats a DSD file
+** (example.dsd by default) until it has about 32 megabytes of input. It
+** also builds a document of the same size that's one big multi-line base16
+** string, so every chunk but the first starts inside it. It lexes each
+** with a single call to textlex_update() and then with textpar_update()
+** using 1, 2, 4, 8 and 16 threads, printing the throughput of each.
+**
+** The speedup over textlex_update() is only as good as the number of CPUs
+** allows, so it also prints how much of the CPU time was spent on the
+** calling thread, which does its own chunk and delivers all the tokens.
+** With n threads that's a bit more than 1/n if the work is shared out
+** evenly, and 1 / that share is about the best speedup to expect with
+** enough CPUs.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_INPUT_SIZE  ( 32 * 1024 * 1024 )
+#define BENCH_BUFFER_SIZE 4096
+#define BENCH_PASSES      5
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "textpar.h"
+
+/* Function Prototypes */
+
+static unsigned char * load_input( char * path, size_t * length );
+static unsigned char * build_blob( size_t * length );
+static void run_all( char * name, unsigned char * input, size_t length );
+static double run_passes( unsigned char * input, size_t length, unsigned int threads, double * share );
+static double cpu_seconds( clockid_t clock );
+static tTextLexErr token_handler( tTextLexContext * context, tTextLexCount token );
+
+/* Global Variables */
+
+static unsigned long tokens = 0;
+
+int main( int argc, char * argv [] ) {
+  unsigned char * input;
+  size_t length;
+  char * path = ( argc > 1 ) ? argv[ 1 ] : "example.dsd";
+
+  if( NULL == ( input = load_input( path, & length ) ) ) {
+    fprintf( stderr, "%%BENCH-F-INPUT; Can't read input from %s.\n", path );
+    return( 1 );
+  }
+
+  run_all( path, input, length );
+  free( input );
+
+  if( NULL == ( input = build_blob( & length ) ) ) {
+    fprintf( stderr, "%%BENCH-F-MEMORY; Can't allocate the blob.\n" );
+    return( 1 );
+  }
+
+  run_all( "base16 blob", input, length );
+  free( input );
+
+  return( 0 );
+}
+
+static void run_all( char * name, unsigned char * input, size_t length ) {
+  static unsigned int threads [] = { 1, 2, 4, 8, 16 };
+  double seconds, sequential, share;
+  unsigned int i;
+
+  printf( "; BEGIN BENCHMARK %s (%zu octets)\n", name, length );
+
+  sequential = run_passes( input, length, 0, & share );
+  printf( "; SEQUENTIAL    %8.3f GB/s %10lu tokens\n",
+          ( (double) length * BENCH_PASSES ) / sequential / 1e9, tokens / BENCH_PASSES );
+
+  for( i = 0; i < sizeof( threads ) / sizeof( threads[ 0 ] ); i++ ) {
+    seconds = run_passes( input, length, threads[ i ], & share );
+    printf( "; THREADS %3u   %8.3f GB/s %10lu tokens %6.2fx %5.1f%% calling thread\n", threads[ i ],
+            ( (double) length * BENCH_PASSES ) / seconds / 1e9, tokens / BENCH_PASSES, sequential / seconds, share * 100.0 );
+  }
+
+  printf( "; END BENCHMARK\n" );
+}
+
+static unsigned char * load_input( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * seed = NULL;
+  unsigned char * input = NULL;
+  size_t seed_length = 0;
+  size_t seed_size = 4096;
+  size_t bytes_read;
+
+  do {
+    if( NULL == ( file = fopen( path, "rb" ) ) ) {
+      break;
+    }
+
+    if( NULL == ( seed = malloc( seed_size ) ) ) {
+      break;
+    }
+
+    while( 0 != ( bytes_read = fread( seed + seed_length, 1, seed_size - seed_length, file ) ) ) {
+      seed_length += bytes_read;
+      if( seed_length == seed_size ) {
+        seed_size *= 2;
+        if( NULL == ( seed = realloc( seed, seed_size ) ) ) {
+          break;
+        }
+      }
+    }
+
+    if( ( NULL == seed ) || ( 0 == seed_length ) ) {
+      break;
+    }
+
+    if( NULL == ( input = malloc( BENCH_INPUT_SIZE + seed_length + 1 ) ) ) {
+      break;
+    }
+
+    for( * length = 0; * length < BENCH_INPUT_SIZE; * length += seed_length + 1 ) {
+      memcpy( input + * length, seed, seed_length );
+      input[ * length + seed_length ] = '\n';
+    }
+  } while( 0 );
+
+  if( NULL != file ) {
+    fclose( file );
+  }
+
+  if( NULL != seed ) {
+    free( seed );
+  }
+
+  return( input );
+}
+
+/* build_blob()
+**
+** Makes a map holding a single base16 string about BENCH_INPUT_SIZE octets
+** long, 32 octets to a line.
+*/
+
+static unsigned char * build_blob( size_t * length ) {
+  static const char digits [] = "0123456789abcdef";
+  unsigned long state = 1;
+  unsigned char * input;
+  char * out;
+  unsigned int i;
+
+  if( NULL == ( input = malloc( BENCH_INPUT_SIZE + 256 ) ) ) {
+    return( NULL );
+  }
+
+  out = (char *) input;
+  out += sprintf( out, "{ \"blob\" = (\n" );
+
+  while( out - (char *) input < BENCH_INPUT_SIZE ) {
+    for( i = 0; i < 32; i++ ) {
+      state = state * 1103515245 + 12345;
+      * out++ = digits[ ( state >> 16 ) & 15 ];
+      * out++ = digits[ ( state >> 20 ) & 15 ];
+      * out++ = ( 31 == i ) ? '\n' : ' ';
+    }
+  }
+
+  out += sprintf( out, ") }\n" );
+  * length = out - (char *) input;
+
+  return( input );
+}
+
+/* run_passes()
+**
+** Lexes the input BENCH_PASSES times, with textlex_update() if threads is
+** zero or textpar_update() if it isn't, and returns the time it took. share
+** gets the calling thread's share of the CPU time.
+*/
+
+static double run_passes( unsigned char * input, size_t length, unsigned int threads, double * share ) {
+  tTextLexContext context;
+  tTextLexBuffer buffer[ BENCH_BUFFER_SIZE ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  struct timespec start, stop;
+  unsigned int pass;
+
+  double thread_cpu, process_cpu;
+
+  tokens = 0;
+
+  thread_cpu = cpu_seconds( CLOCK_THREAD_CPUTIME_ID );
+  process_cpu = cpu_seconds( CLOCK_PROCESS_CPUTIME_ID );
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( pass = 0; pass < BENCH_PASSES; pass++ ) {
+    textlex_init( & context, buffer, BENCH_BUFFER_SIZE );
+    context.token = token_handler;
+
+    if( 0 == threads ) {
+      err = textlex_update( & context, input, length );
+    } else {
+      err = textpar_update( & context, input, length, threads );
+    }
+
+    if( TEXTLEX_E_NOERR != err ) {
+      fprintf( stderr, "%%BENCH-F-UPDATE; Error %d at line %d, octet %d.\n", err, context.line, context.octet );
+      exit( 2 );
+    }
+
+    textlex_final( & context );
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+  thread_cpu = cpu_seconds( CLOCK_THREAD_CPUTIME_ID ) - thread_cpu;
+  process_cpu = cpu_seconds( CLOCK_PROCESS_CPUTIME_ID ) - process_cpu;
+
+  * share = ( process_cpu > 0.0 ) ? thread_cpu / process_cpu : 1.0;
+
+  return( ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9 );
+}
+
+static double cpu_seconds( clockid_t clock ) {
+  struct timespec now;
+
+  clock_gettime( clock, & now );
+
+  return( now.tv_sec + now.tv_nsec / 1e9 );
+}
+
+static tTextLexErr token_handler( tTextLexContext * context, tTextLexCount token ) {
+  tokens++;
+  return( TEXTLEX_E_NOERR );
+}
@@ -0,0 +1,453 @@
+/* bench_textpull.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program measures the lexxer's pull mode against its token callback
+** on the job example_struct.c does: binding messages like
+**
+**   @m { "iterations" = 12 "salt" = "01234567" "secret" = ( 8a 4d ... 33 ) }
+**
+** into a struct. It builds a big array of them and parses it two ways:
+**
+**   push : a state machine in the token callback, the way example_struct.c
+**          does it (one state for each thing it could be waiting for)
+**   pull : a recursive descent parser calling textlex_next(), with the
+**          same state kept in local variables and the program counter
+**
+** Both bind every field of every message and add them up. Before timing
+** anything, it checks the two get the same sums.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_MESSAGES    200000
+#define BENCH_CHUNK_SIZE  ( 64 * 1024 )
+#define BENCH_BUFFER_SIZE 256
+#define BENCH_PASSES      5
+#define BENCH_TEXT        160
+
+#define BENCH_M_PUSH      0
+#define BENCH_M_PULL      1
+
+#define PARSE_S_START     0
+#define PARSE_S_INARRAY   1
+#define PARSE_S_INMAP     2
+#define PARSE_S_EEQUALS   3
+#define PARSE_S_EVALUE    4
+#define PARSE_S_END       5
+
+#define PARSE_K_NONE      0
+#define PARSE_K_ITERATIONS 1
+#define PARSE_K_SALT      2
+#define PARSE_K_SECRET    3
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "textlex.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  unsigned char secret[ 20 ];
+  unsigned char salt[ 8 ];
+  unsigned int iterations;
+} tTestStruct;
+
+typedef struct {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  unsigned char * input;
+  size_t length;
+  size_t offset;
+  int finished;
+} tPullSource;
+
+/* Function Prototypes */
+
+static unsigned char * build_input( size_t * length );
+static double run_passes( unsigned char * input, size_t length, unsigned int mode );
+static int key_of( const tTextLexBuffer * data, tTextLexCount length );
+static void bind_value( tTestStruct * record, int key, tTextLexCount token, const tTextLexBuffer * data, tTextLexCount length );
+static void hex_to_bytes( unsigned char * out, size_t size, const tTextLexBuffer * data, tTextLexCount length );
+static void add_up( const tTestStruct * record );
+static tTextLexErr push_token( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr next( tPullSource * source, tTextLexToken * token );
+static tTextLexErr pull_document( tPullSource * source );
+static tTextLexErr pull_message( tPullSource * source, tTextLexToken * token, tTestStruct * record );
+
+/* Global Variables */
+
+static const char * modes [] = { "push", "pull" };
+static unsigned long messages = 0;
+static unsigned long long sum = 0;
+
+static unsigned int push_state;
+static int push_key;
+static tTestStruct push_record;
+
+int main( int argc, char * argv [] ) {
+  unsigned char * input;
+  size_t length;
+  double seconds;
+  unsigned long long sums[ 2 ];
+  unsigned int mode;
+
+  if( NULL == ( input = build_input( & length ) ) ) {
+    fprintf( stderr, "%%BENCH-F-MEMORY; Can't allocate the input.\n" );
+    return( 1 );
+  }
+
+  for( mode = BENCH_M_PUSH; mode <= BENCH_M_PULL; mode++ ) {
+    run_passes( input, length, mode );
+    sums[ mode ] = sum;
+    if( BENCH_MESSAGES != messages ) {
+      fprintf( stderr, "%%BENCH-F-COUNT; %s parsed %lu messages, not %d.\n", modes[ mode ], messages, BENCH_MESSAGES );
+      return( 2 );
+    }
+  }
+
+  if( sums[ BENCH_M_PUSH ] != sums[ BENCH_M_PULL ] ) {
+    fprintf( stderr, "%%BENCH-F-MISMATCH; The push and pull parsers disagree.\n" );
+    return( 2 );
+  }
+
+  printf( "; BEGIN BENCHMARK\n" );
+
+  for( mode = BENCH_M_PUSH; mode <= BENCH_M_PULL; mode++ ) {
+    seconds = run_passes( input, length, mode );
+    printf( "; %-4s %10zu octets %8lu messages %8.3f us/message %8.3f GB/s\n", modes[ mode ], length, messages,
+            seconds * 1e6 / ( (double) messages * BENCH_PASSES ), ( (double) length * BENCH_PASSES ) / seconds / 1e9 );
+  }
+
+  printf( "; END BENCHMARK\n" );
+
+  free( input );
+
+  return( 0 );
+}
+
+/* build_input()
+**
+** Makes an array of BENCH_MESSAGES messages with random values, laid out
+** a few different ways.
+*/
+
+static unsigned char * build_input( size_t * length ) {
+  unsigned long long state = 88172645463325252ULL;
+  unsigned char * input;
+  char * out;
+  unsigned long i;
+  unsigned int k;
+
+  if( NULL == ( input = malloc( (size_t) BENCH_MESSAGES * BENCH_TEXT ) ) ) {
+    return( NULL );
+  }
+
+  out = (char *) input;
+  out += sprintf( out, "[\n" );
+
+  for( i = 0; i < BENCH_MESSAGES; i++ ) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    out += sprintf( out, "@m{\"iterations\"=%u \"salt\"=", (unsigned int) ( state % 100000 ) );
+    if( state & 0x10000 ) {
+      out += sprintf( out, "\"%08u\"", (unsigned int) ( ( state >> 20 ) % 100000000 ) );
+    } else {
+      out += sprintf( out, "(%016llx)", state );
+    }
+    out += sprintf( out, " \"secret\"=(" );
+    for( k = 0; k < 20; k++ ) {
+      out += sprintf( out, "%s%02x", k ? " " : "", (unsigned int) ( ( state >> ( k * 3 ) ) & 0xFF ) );
+    }
+    out += sprintf( out, ")}\n" );
+  }
+
+  out += sprintf( out, "]\n" );
+  * length = out - (char *) input;
+
+  return( input );
+}
+
+/* run_passes()
+**
+** Parses the input BENCH_PASSES times and returns how many seconds it took.
+*/
+
+static double run_passes( unsigned char * input, size_t length, unsigned int mode ) {
+  static tPullSource source;
+  tTextLexContext context;
+  tTextLexBuffer buffer[ BENCH_BUFFER_SIZE ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  struct timespec start, stop;
+  size_t offset, chunk;
+  unsigned int pass;
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( pass = 0; pass < BENCH_PASSES; pass++ ) {
+    messages = 0;
+    sum = 0;
+
+    if( BENCH_M_PULL == mode ) {
+      textlex_init( & source.context, buffer, BENCH_BUFFER_SIZE );
+      textlex_extend( & source.context, & source.extension );
+      source.input = input;
+      source.length = length;
+      source.offset = 0;
+      source.finished = 0;
+
+      if( TEXTLEX_E_NOERR != ( err = pull_document( & source ) ) ) {
+        fprintf( stderr, "%%BENCH-F-PULL; Error %d at line %d, octet %d.\n", err, source.context.line, source.context.octet );
+        exit( 2 );
+      }
+      continue;
+    }
+
+    textlex_init( & context, buffer, BENCH_BUFFER_SIZE );
+    context.token = push_token;
+    push_state = PARSE_S_START;
+
+    for( offset = 0; offset < length; offset += chunk ) {
+      chunk = ( ( length - offset ) < BENCH_CHUNK_SIZE ) ? ( length - offset ) : BENCH_CHUNK_SIZE;
+      if( TEXTLEX_E_NOERR != ( err = textlex_update( & context, input + offset, chunk ) ) ) {
+        fprintf( stderr, "%%BENCH-F-UPDATE; Error %d at line %d, octet %d.\n", err, context.line, context.octet );
+        exit( 2 );
+      }
+    }
+
+    textlex_final( & context );
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+
+  return( ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9 );
+}
+
+/* These are shared by both parsers, so the only difference between them
+** is how they get their tokens.
+*/
+
+static int key_of( const tTextLexBuffer * data, tTextLexCount length ) {
+  if( ( 10 == length ) && ( 0 == memcmp( data, "iterations", 10 ) ) ) {
+    return( PARSE_K_ITERATIONS );
+  } else if( ( 4 == length ) && ( 0 == memcmp( data, "salt", 4 ) ) ) {
+    return( PARSE_K_SALT );
+  } else if( ( 6 == length ) && ( 0 == memcmp( data, "secret", 6 ) ) ) {
+    return( PARSE_K_SECRET );
+  }
+  return( PARSE_K_NONE );
+}
+
+static void bind_value( tTestStruct * record, int key, tTextLexCount token, const tTextLexBuffer * data, tTextLexCount length ) {
+  tTextLexCount i;
+
+  switch( key ) {
+  case PARSE_K_ITERATIONS:
+    if( TEXTLEX_T_INTEGER == token ) {
+      for( i = 0, record->iterations = 0; i < length; i++ ) {
+        record->iterations = record->iterations * 10 + ( data[ i ] - '0' );
+      }
+    }
+    break;
+
+  case PARSE_K_SALT:
+    if( TEXTLEX_T_STRING == token ) {
+      memcpy( record->salt, data, ( length < sizeof( record->salt ) ) ? length : sizeof( record->salt ) );
+    } else if( TEXTLEX_T_HEX == token ) {
+      hex_to_bytes( record->salt, sizeof( record->salt ), data, length );
+    }
+    break;
+
+  case PARSE_K_SECRET:
+    if( TEXTLEX_T_HEX == token ) {
+      hex_to_bytes( record->secret, sizeof( record->secret ), data, length );
+    }
+    break;
+  }
+}
+
+static void hex_to_bytes( unsigned char * out, size_t size, const tTextLexBuffer * data, tTextLexCount length ) {
+  size_t i;
+  unsigned int c, hi, lo;
+
+  for( i = 0; ( i < size ) && ( 2 * i + 1 < length ); i++ ) {
+    c = data[ 2 * i ];
+    hi = ( c <= '9' ) ? ( c - '0' ) : ( ( c | 0x20 ) - 'a' + 10 );
+    c = data[ 2 * i + 1 ];
+    lo = ( c <= '9' ) ? ( c - '0' ) : ( ( c | 0x20 ) - 'a' + 10 );
+    out[ i ] = (unsigned char) ( ( hi << 4 ) | lo );
+  }
+}
+
+static void add_up( const tTestStruct * record ) {
+  size_t i;
+
+  sum += record->iterations;
+  for( i = 0; i < sizeof( record->salt ); i++ ) {
+    sum += (unsigned long long) record->salt[ i ] << ( i % 8 );
+  }
+  for( i = 0; i < sizeof( record->secret ); i++ ) {
+    sum += (unsigned long long) record->secret[ i ] << ( i % 8 );
+  }
+  messages++;
+}
+
+/* push_token()
+**
+** The push parser. Every token comes in here, so where it is in the
+** document has to be kept in push_state between calls.
+*/
+
+static tTextLexErr push_token( tTextLexContext * context, tTextLexCount token ) {
+  if( TEXTLEX_T_END == token ) {
+    return( TEXTLEX_E_NOERR );
+  }
+
+  switch( push_state ) {
+  case PARSE_S_START:
+    if( TEXTLEX_T_ARRAY_OPEN == token ) {
+      push_state = PARSE_S_INARRAY;
+    }
+    break;
+
+  case PARSE_S_INARRAY:
+    if( TEXTLEX_T_MAP_OPEN == token ) {
+      memset( & push_record, 0, sizeof( tTestStruct ) );
+      push_state = PARSE_S_INMAP;
+    } else if( TEXTLEX_T_ARRAY_CLOSE == token ) {
+      push_state = PARSE_S_END;
+    }
+    break;
+
+  case PARSE_S_INMAP:
+    if( TEXTLEX_T_MAP_CLOSE == token ) {
+      add_up( & push_record );
+      push_state = PARSE_S_INARRAY;
+    } else if( TEXTLEX_T_STRING == token ) {
+      push_key = key_of( context->buffer, context->index );
+      push_state = PARSE_S_EEQUALS;
+    }
+    break;
+
+  case PARSE_S_EEQUALS:
+    if( TEXTLEX_T_EQUALS == token ) {
+      push_state = PARSE_S_EVALUE;
+    }
+    break;
+
+  case PARSE_S_EVALUE:
+    bind_value( & push_record, push_key, token, context->buffer, context->index );
+    push_state = PARSE_S_INMAP;
+    break;
+
+  case PARSE_S_END:
+    break;
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* next()
+**
+** Gets the pull parser its next token, feeding the lexxer another chunk of
+** input (or calling textlex_final()) when it runs out. END tokens are
+** skipped, like push_token() skips them. TEXTLEX_E_MORE means the document
+** is over.
+*/
+
+static tTextLexErr next( tPullSource * source, tTextLexToken * token ) {
+  tTextLexErr err;
+  size_t chunk;
+
+  while( 1 ) {
+    err = textlex_next( & source->context, token );
+
+    if( TEXTLEX_E_NOERR == err ) {
+      if( TEXTLEX_T_END != token->token ) {
+        return( err );
+      }
+    } else if( TEXTLEX_E_MORE != err ) {
+      return( err );
+    } else if( source->offset < source->length ) {
+      chunk = ( ( source->length - source->offset ) < BENCH_CHUNK_SIZE ) ? ( source->length - source->offset ) : BENCH_CHUNK_SIZE;
+      textlex_feed( & source->context, source->input + source->offset, chunk );
+      source->offset += chunk;
+    } else if( ! source->finished ) {
+      source->finished = 1;
+      if( TEXTLEX_E_NOERR != ( err = textlex_final( & source->context ) ) ) {
+        return( err );
+      }
+    } else {
+      return( TEXTLEX_E_MORE );
+    }
+  }
+}
+
+/* pull_document()
+**
+** The pull parser: an array of messages, each of which is an annotation
+** followed by a map.
+*/
+
+static tTextLexErr pull_document( tPullSource * source ) {
+  tTextLexToken token;
+  tTestStruct record;
+  tTextLexErr err;
+
+  if( TEXTLEX_E_NOERR != ( err = next( source, & token ) ) ) {
+    return( err );
+  }
+  if( TEXTLEX_T_ARRAY_OPEN != token.token ) {
+    return( TEXTLEX_E_ERROR );
+  }
+
+  while( TEXTLEX_E_NOERR == ( err = next( source, & token ) ) ) {
+    if( TEXTLEX_T_ARRAY_CLOSE == token.token ) {
+      break;
+    } else if( TEXTLEX_T_MAP_OPEN == token.token ) {
+      memset( & record, 0, sizeof( tTestStruct ) );
+      if( TEXTLEX_E_NOERR != ( err = pull_message( source, & token, & record ) ) ) {
+        return( err );
+      }
+      add_up( & record );
+    }
+  }
+
+  return( err );
+}
+
+static tTextLexErr pull_message( tPullSource * source, tTextLexToken * token, tTestStruct * record ) {
+  tTextLexErr err;
+  int key;
+
+  while( TEXTLEX_E_NOERR == ( err = next( source, token ) ) ) {
+    if( TEXTLEX_T_MAP_CLOSE == token->token ) {
+      break;
+    } else if( TEXTLEX_T_STRING != token->token ) {
+      return( TEXTLEX_E_ERROR );
+    }
+
+    key = key_of( token->data, token->length );
+
+    if( ( TEXTLEX_E_NOERR != ( err = next( source, token ) ) ) || ( TEXTLEX_T_EQUALS != token->token ) ) {
+      return( ( TEXTLEX_E_NOERR != err ) ? err : TEXTLEX_E_ERROR );
+    }
+
+    if( TEXTLEX_E_NOERR != ( err = next( source, token ) ) ) {
+      return( err );
+    }
+
+    bind_value( record, key, token->token, token->data, token->length );
+  }
+
+  return( err );
+}
@@ -0,0 +1,212 @@
+/* bench_textrec.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program measures record mode splitting a big stream of messages
+** like
+**
+**   @m { "seq" = 12 "name" = "sensor-12" "values" = [ 1 2 3 ] "key" = ( 8a 4d ... ) }
+**
+** into documents. The stream is a gigabyte unless you say otherwise:
+**
+**   bench_textrec [megabytes]
+**
+** It's lexed a megabyte at a time, like it was being read from a file or
+** a socket, two ways:
+**
+**   count  : the span callback keeps track of the '{'s and '}'s itself,
+**            the way programs had to before record mode (it only counts
+**            the documents; it doesn't work out where they are)
+**   record : the record callback gets each document's offsets and there
+**            isn't a token or span callback at all
+**
+** Both check they found every message, and record checks the documents'
+** lengths add up to the messages' lengths.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_MEGABYTES   1024
+#define BENCH_CHUNK_SIZE  ( 1024 * 1024 )
+#define BENCH_BUFFER_SIZE 256
+#define BENCH_TEXT        256
+
+#define BENCH_M_COUNT     0
+#define BENCH_M_RECORD    1
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "textlex.h"
+
+/* Function Prototypes */
+
+static unsigned char * build_input( size_t size, size_t * length );
+static double run( unsigned char * input, size_t length, unsigned int mode );
+static tTextLexErr count_span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr record_callback( tTextLexContext * context, unsigned long long start, unsigned long long end );
+
+/* Global Variables */
+
+static const char * modes [] = { "count", "record" };
+static unsigned long long built;
+static unsigned long long built_octets;
+static unsigned long long documents;
+static unsigned long long document_octets;
+static unsigned int depth;
+
+int main( int argc, char * argv [] ) {
+  unsigned char * input;
+  size_t size = (size_t) BENCH_MEGABYTES * 1024 * 1024;
+  size_t length;
+  double seconds;
+  unsigned int mode;
+
+  if( argc > 1 ) {
+    size = (size_t) atol( argv[ 1 ] ) * 1024 * 1024;
+  }
+
+  if( NULL == ( input = build_input( size, & length ) ) ) {
+    fprintf( stderr, "%%BENCH-F-MEMORY; Can't allocate the input.\n" );
+    return( 1 );
+  }
+
+  printf( "; BEGIN BENCHMARK\n" );
+
+  for( mode = BENCH_M_COUNT; mode <= BENCH_M_RECORD; mode++ ) {
+    seconds = run( input, length, mode );
+
+    if( ( built != documents ) || ( ( BENCH_M_RECORD == mode ) && ( built_octets != document_octets ) ) ) {
+      fprintf( stderr, "%%BENCH-F-COUNT; %s found %llu documents (%llu octets), not %llu (%llu octets).\n", modes[ mode ],
+               documents, document_octets, built, built_octets );
+      return( 2 );
+    }
+
+    printf( "; %-6s %11zu octets %9llu documents %8.3f s %8.3f GB/s %10.0f documents/s\n", modes[ mode ], length, documents,
+            seconds, (double) length / seconds / 1e9, (double) documents / seconds );
+  }
+
+  printf( "; END BENCHMARK\n" );
+
+  free( input );
+
+  return( 0 );
+}
+
+/* build_input()
+**
+** Fills size octets with messages, some on a line of their own and some
+** run together.
+*/
+
+static unsigned char * build_input( size_t size, size_t * length ) {
+  unsigned long long state = 88172645463325252ULL;
+  unsigned char * input;
+  char * out, * message;
+  unsigned int k;
+
+  if( NULL == ( input = malloc( size + BENCH_TEXT ) ) ) {
+    return( NULL );
+  }
+
+  out = (char *) input;
+
+  for( built = 0, built_octets = 0; (size_t) ( out - (char *) input ) < size; built++ ) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    message = out;
+    out += sprintf( out, "@m { \"seq\" = %llu \"name\" = \"sensor-%u\" \"values\" = [ %u %d %u.%02u ] \"key\" = (",
+                    built, (unsigned int) ( state % 1000 ), (unsigned int) ( state >> 40 ) & 0xFFFF,
+                    -(int) ( ( state >> 24 ) & 0xFF ), (unsigned int) ( state >> 50 ) & 0x3FF, (unsigned int) ( state >> 8 ) % 100 );
+    for( k = 0; k < 12; k++ ) {
+      out += sprintf( out, " %02x", (unsigned int) ( ( state >> ( k * 5 ) ) & 0xFF ) );
+    }
+    out += sprintf( out, " ) }" );
+    built_octets += (unsigned long long) ( out - message );
+
+    out += sprintf( out, "%s", ( state & 0x300 ) ? "\n" : "" );
+  }
+
+  * length = (size_t) ( out - (char *) input );
+
+  return( input );
+}
+
+/* run()
+**
+** Splits the input and returns how many seconds it took.
+*/
+
+static double run( unsigned char * input, size_t length, unsigned int mode ) {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ BENCH_BUFFER_SIZE ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  struct timespec start, stop;
+  size_t offset, chunk;
+
+  documents = 0;
+  document_octets = 0;
+  depth = 0;
+
+  textlex_init( & context, buffer, BENCH_BUFFER_SIZE );
+  textlex_extend( & context, & extension );
+  if( BENCH_M_COUNT == mode ) {
+    extension.span = count_span;
+  } else {
+    extension.record = record_callback;
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += chunk ) {
+    chunk = ( length - offset < BENCH_CHUNK_SIZE ) ? length - offset : BENCH_CHUNK_SIZE;
+    err = textlex_update( & context, input + offset, (tTextLexCount) chunk );
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textlex_final( & context );
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+
+  if( TEXTLEX_E_NOERR != err ) {
+    fprintf( stderr, "%%BENCH-F-LEX; %s got error %u at line %u.\n", modes[ mode ], err, context.line );
+    exit( 2 );
+  }
+
+  return( (double) ( stop.tv_sec - start.tv_sec ) + (double) ( stop.tv_nsec - start.tv_nsec ) / 1e9 );
+}
+
+static tTextLexErr count_span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  switch( token ) {
+  case TEXTLEX_T_ARRAY_OPEN:
+  case TEXTLEX_T_MAP_OPEN:
+    depth++;
+    break;
+
+  case TEXTLEX_T_ARRAY_CLOSE:
+  case TEXTLEX_T_MAP_CLOSE:
+    if( 0 == --depth ) {
+      documents++;
+    }
+    break;
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr record_callback( tTextLexContext * context, unsigned long long start, unsigned long long end ) {
+  documents++;
+  document_octets += end - start;
+
+  return( TEXTLEX_E_NOERR );
+}
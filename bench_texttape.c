@@ -0,0 +1,159 @@
+/* bench_texttape.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program measures how long it takes to lex a message, build its tape
+** and look a value up, for the same messages bench_textdom.c uses, so the
+** two builders can be compared. It also times looking up the last key in
+** example.dsd's top level map on a tape that's already built, which skips
+** over every value in front of it.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_SMALL_MESSAGES  1000000
+#define BENCH_LARGE_MESSAGES  5000
+#define BENCH_LOOKUPS         10000000
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "texttape.h"
+
+/* Function Prototypes */
+
+static unsigned char * load_file( char * path, size_t * length );
+static void run( char * name, unsigned char * message, size_t length, unsigned long count, char * key );
+static void lookup( unsigned long count, char * key );
+
+/* Global Variables */
+
+static char * small_message =
+  "@m{\"iterations\"=12 \"salt\"=\"01234567\" \"secret\"=(8a 4d 21 92 03 82 3c f8 6a 05 c5 ea 0c 40 be f4 c8 02 76 33)}";
+
+static tTextTapeContext context;
+
+int main( int argc, char * argv [] ) {
+  unsigned char * example;
+  size_t length;
+  char * path = ( argc > 1 ) ? argv[ 1 ] : "example.dsd";
+
+  if( NULL == ( example = load_file( path, & length ) ) ) {
+    fprintf( stderr, "%%BENCH-F-INPUT; Can't read input from %s.\n", path );
+    return( 1 );
+  }
+
+  if( TEXTLEX_E_NOERR != texttape_init( & context ) ) {
+    fprintf( stderr, "%%BENCH-F-MEMORY; Can't initialize the builder.\n" );
+    return( 1 );
+  }
+
+  printf( "; BEGIN BENCHMARK\n" );
+
+  run( "SMALL", (unsigned char *) small_message, strlen( small_message ), BENCH_SMALL_MESSAGES, "iterations" );
+  run( path, example, length, BENCH_LARGE_MESSAGES, "revision" );
+  lookup( BENCH_LOOKUPS, "yet another dictionary" );
+
+  printf( "; END BENCHMARK\n" );
+
+  texttape_free( & context );
+  free( example );
+
+  return( 0 );
+}
+
+static void run( char * name, unsigned char * message, size_t length, unsigned long count, char * key ) {
+  struct timespec start, stop;
+  long long value, sum = 0;
+  unsigned long i;
+  tTextLexErr err;
+  double seconds;
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( i = 0; i < count; i++ ) {
+    texttape_reset( & context );
+
+    if( ( TEXTLEX_E_NOERR != ( err = texttape_update( & context, message, length ) ) ) ||
+        ( TEXTLEX_E_NOERR != ( err = texttape_final( & context ) ) ) ) {
+      fprintf( stderr, "%%BENCH-F-BUILD; Error %d.\n", err );
+      exit( 2 );
+    }
+
+    if( texttape_integer( & context, texttape_find( & context, texttape_index( & context, TEXTTAPE_ROOT, 0 ), key ), & value ) ) {
+      sum += value;
+    }
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+
+  seconds = ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9;
+
+  printf( "; %-12s %6zu octets %10.3f us/message %8.3f GB/s (%lld)\n", name, length,
+          seconds * 1e6 / count, (double) length * count / seconds / 1e9, sum / (long long) count );
+}
+
+/* lookup()
+**
+** Looks key up in the first value on the tape left by the last message
+** run() built, count times.
+*/
+
+static void lookup( unsigned long count, char * key ) {
+  struct timespec start, stop;
+  size_t map = texttape_index( & context, TEXTTAPE_ROOT, 0 );
+  size_t found = 0;
+  unsigned long i;
+  double seconds;
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( i = 0; i < count; i++ ) {
+    found += texttape_find( & context, map, key );
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+
+  seconds = ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9;
+
+  printf( "; %-12s %6zu words  %10.3f ns/lookup (%zu)\n", "LOOKUP", context.count,
+          seconds * 1e9 / count, found / count );
+}
+
+static unsigned char * load_file( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * data = NULL;
+  long size;
+
+  if( NULL == ( file = fopen( path, "rb" ) ) ) {
+    return( NULL );
+  }
+
+  do {
+    if( ( 0 != fseek( file, 0, SEEK_END ) ) || ( ( size = ftell( file ) ) <= 0 ) || ( 0 != fseek( file, 0, SEEK_SET ) ) ) {
+      break;
+    }
+
+    if( NULL == ( data = malloc( size ) ) ) {
+      break;
+    }
+
+    if( (size_t) size != fread( data, 1, size, file ) ) {
+      free( data );
+      data = NULL;
+      break;
+    }
+
+    * length = size;
+  } while( 0 );
+
+  fclose( file );
+
+  return( data );
+}
@@ -0,0 +1,244 @@
+/* bench_texttype.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program measures the typed decoder against the lexxer's number
+** mode. It builds two big arrays of numbers that fit the tiny type system,
+** one of integers and one of floats, each led by a type system annotation,
+** then decodes each of them three ways:
+**
+**   number : the lexxer's number callback, which adds the digits up in 64
+**            bits, then a range check and a cast to int16_t or float
+**   medium : the typed decoder with the array marked @m
+**   tiny   : the typed decoder with the array marked @t, which adds the
+**            digits up in 16 bits and checks the range as it goes
+**
+** Before timing anything, it checks number and tiny get the same numbers.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define BENCH_NUMBERS     1000000
+#define BENCH_CHUNK_SIZE  ( 64 * 1024 )
+#define BENCH_BUFFER_SIZE 4096
+#define BENCH_PASSES      5
+#define BENCH_NUMBER_TEXT 32
+
+#define BENCH_M_NUMBER    0
+#define BENCH_M_MEDIUM    1
+#define BENCH_M_TINY      2
+
+/* File Includes */
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "texttype.h"
+
+/* Function Prototypes */
+
+static unsigned char * build_input( int floats, size_t * length );
+static double run_passes( unsigned char * input, size_t length, unsigned int mode );
+static tTextLexErr number_handler( tTextLexContext * context, tTextLexCount token, tTextNumValue * value, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr value_handler( tTextTypeContext * context, tTextLexCount token, const tTextTypeValue * value );
+
+/* Global Variables */
+
+static const char * modes [] = { "number", "medium", "tiny" };
+static unsigned long numbers = 0;
+static double real_sum = 0.0;
+static long long integer_sum = 0;
+
+int main( int argc, char * argv [] ) {
+  unsigned char * input;
+  size_t length;
+  double seconds, sums[ 3 ];
+  long long integers[ 3 ];
+  unsigned int mode;
+  int floats;
+
+  printf( "; BEGIN BENCHMARK\n" );
+
+  for( floats = 1; floats >= 0; floats-- ) {
+    if( NULL == ( input = build_input( floats, & length ) ) ) {
+      fprintf( stderr, "%%BENCH-F-MEMORY; Can't allocate the input.\n" );
+      return( 1 );
+    }
+
+    for( mode = BENCH_M_NUMBER; mode <= BENCH_M_TINY; mode++ ) {
+      run_passes( input, length, mode );
+      sums[ mode ] = real_sum;
+      integers[ mode ] = integer_sum;
+    }
+
+    if( ( sums[ BENCH_M_NUMBER ] != sums[ BENCH_M_TINY ] ) || ( integers[ BENCH_M_NUMBER ] != integers[ BENCH_M_TINY ] ) ) {
+      fprintf( stderr, "%%BENCH-F-MISMATCH; The number mode and the tiny type system disagree.\n" );
+      return( 2 );
+    }
+
+    for( mode = BENCH_M_NUMBER; mode <= BENCH_M_TINY; mode++ ) {
+      seconds = run_passes( input, length, mode );
+      printf( "; %-8s %-6s %10zu octets %8.3f ns/number %8.3f GB/s\n", floats ? "floats" : "integers", modes[ mode ], length,
+              seconds * 1e9 / ( (double) BENCH_NUMBERS * BENCH_PASSES ), ( (double) length * BENCH_PASSES ) / seconds / 1e9 );
+    }
+
+    free( input );
+  }
+
+  printf( "; END BENCHMARK\n" );
+
+  return( 0 );
+}
+
+/* build_input()
+**
+** Makes an array of BENCH_NUMBERS random integers between -32768 and 32767
+** or floats with up to 6 digits after the point, ten to a line. The array
+** is led by "@t " and run_passes() changes the t to an m for the medium
+** type system.
+*/
+
+static unsigned char * build_input( int floats, size_t * length ) {
+  unsigned long long state = 88172645463325252ULL;
+  unsigned char * input;
+  char * out;
+  unsigned long i;
+
+  if( NULL == ( input = malloc( (size_t) BENCH_NUMBERS * BENCH_NUMBER_TEXT ) ) ) {
+    return( NULL );
+  }
+
+  out = (char *) input;
+  out += sprintf( out, "@t [\n" );
+
+  for( i = 0; i < BENCH_NUMBERS; i++ ) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+
+    if( floats ) {
+      out += sprintf( out, "%s%u.%0*u", ( state & 0x100 ) ? "-" : "", (unsigned int) ( ( state >> 9 ) % 1000 ),
+                      1 + (int) ( state % 6 ), (unsigned int) ( ( state >> 20 ) % 1000000 ) );
+    } else {
+      out += sprintf( out, "%d", (int) ( ( state >> 9 ) % 65536 ) - 32768 );
+    }
+
+    * out++ = ( 9 == i % 10 ) ? '\n' : ' ';
+  }
+
+  out += sprintf( out, "]\n" );
+  * length = out - (char *) input;
+
+  return( input );
+}
+
+/* run_passes()
+**
+** Decodes the input BENCH_PASSES times and returns how many seconds it
+** took.
+*/
+
+static double run_passes( unsigned char * input, size_t length, unsigned int mode ) {
+  tTextLexContext text;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ BENCH_BUFFER_SIZE ];
+  tTextTypeContext context;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  struct timespec start, stop;
+  size_t offset, chunk;
+  unsigned int pass;
+
+  input[ 1 ] = ( BENCH_M_MEDIUM == mode ) ? 'm' : 't';
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( pass = 0; pass < BENCH_PASSES; pass++ ) {
+    numbers = 0;
+    real_sum = 0.0;
+    integer_sum = 0;
+
+    if( BENCH_M_NUMBER == mode ) {
+      textlex_init( & text, buffer, BENCH_BUFFER_SIZE );
+      textlex_extend( & text, & extension );
+      extension.number = number_handler;
+    } else {
+      texttype_init( & context );
+      context.value = value_handler;
+    }
+
+    for( offset = 0; offset < length; offset += chunk ) {
+      chunk = ( ( length - offset ) < BENCH_CHUNK_SIZE ) ? ( length - offset ) : BENCH_CHUNK_SIZE;
+      if( BENCH_M_NUMBER == mode ) {
+        err = textlex_update( & text, input + offset, chunk );
+      } else {
+        err = texttype_update( & context, input + offset, chunk );
+      }
+      if( TEXTLEX_E_NOERR != err ) {
+        fprintf( stderr, "%%BENCH-F-UPDATE; Error %d in mode %s.\n", err, modes[ mode ] );
+        exit( 2 );
+      }
+    }
+
+    if( BENCH_M_NUMBER == mode ) {
+      textlex_final( & text );
+    } else {
+      texttype_final( & context );
+    }
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+
+  if( BENCH_NUMBERS != numbers ) {
+    fprintf( stderr, "%%BENCH-F-COUNT; Decoded %lu numbers, not %d.\n", numbers, BENCH_NUMBERS );
+    exit( 2 );
+  }
+
+  return( ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9 );
+}
+
+/* number_handler()
+**
+** What a program that wanted tiny numbers would have to do with the
+** number mode's 64 bit ones.
+*/
+
+static tTextLexErr number_handler( tTextLexContext * context, tTextLexCount token, tTextNumValue * value, tTextLexBuffer * data, tTextLexCount length ) {
+  if( TEXTLEX_T_INTEGER == token ) {
+    if( value->overflow || ( value->integer < INT16_MIN ) || ( value->integer > INT16_MAX ) ) {
+      return( TEXTTYPE_E_RANGE );
+    }
+    integer_sum += (int16_t) value->integer;
+  } else {
+    if( value->overflow || ( value->real > FLT_MAX ) || ( value->real < - FLT_MAX ) ) {
+      return( TEXTTYPE_E_RANGE );
+    }
+    real_sum += (float) value->real;
+  }
+  numbers++;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr value_handler( tTextTypeContext * context, tTextLexCount token, const tTextTypeValue * value ) {
+  if( TEXTTYPE_S_TINY == value->system ) {
+    if( TEXTLEX_T_INTEGER == token ) {
+      integer_sum += value->as.i16;
+    } else {
+      real_sum += value->as.f32;
+    }
+  } else {
+    if( TEXTLEX_T_INTEGER == token ) {
+      integer_sum += value->as.i64;
+    } else {
+      real_sum += value->as.f64;
+    }
+  }
+  numbers++;
+
+  return( TEXTLEX_E_NOERR );
+}
@@ -0,0 +1,137 @@
+/* bench_textwidth.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program compares the 16, 32 and 64 bit lexxers, linked side by side
+** (see test_textwidth.c.) It reads a DSD file (example.dsd by default),
+** repeats it until it has about 32 megabytes of input, and prints the
+** size of each width's context and how fast it lexes the input with the
+** token callback. The input goes to textlex_update() 32 kilobytes at a
+** time, since that's as much as the 16 bit lexxer can take at once.
+*/
+
+/* Macro Definitions */
+
+#define BENCH_INPUT_SIZE  ( 32 * 1024 * 1024 )
+#define BENCH_CHUNK_SIZE  ( 32 * 1024 )
+#define BENCH_PASSES      5
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  unsigned int   width;
+  double      ( *run )( unsigned char * input, size_t length, size_t chunk_size, unsigned int passes, unsigned long * tokens );
+  size_t      ( *context )( void );
+} tWidth;
+
+/* Function Prototypes */
+
+double run16( unsigned char * input, size_t length, size_t chunk_size, unsigned int passes, unsigned long * tokens );
+double run32( unsigned char * input, size_t length, size_t chunk_size, unsigned int passes, unsigned long * tokens );
+double run64( unsigned char * input, size_t length, size_t chunk_size, unsigned int passes, unsigned long * tokens );
+size_t context16( void );
+size_t context32( void );
+size_t context64( void );
+static unsigned char * load_input( char * path, size_t * length );
+
+/* Global Variables */
+
+static const tWidth widths [] = {
+  { 16, run16, context16 },
+  { 32, run32, context32 },
+  { 64, run64, context64 }
+};
+
+int main( int argc, char * argv [] ) {
+  unsigned char * input;
+  size_t length;
+  unsigned long tokens;
+  double seconds;
+  unsigned int i;
+  char * path = ( argc > 1 ) ? argv[ 1 ] : "example.dsd";
+
+  if( NULL == ( input = load_input( path, & length ) ) ) {
+    fprintf( stderr, "%%BENCH-F-INPUT; Can't read input from %s.\n", path );
+    return( 1 );
+  }
+
+  printf( "; BEGIN BENCHMARK %s (%zu octets)\n", path, length );
+
+  for( i = 0; i < sizeof( widths ) / sizeof( widths[ 0 ] ); i++ ) {
+    widths[ i ].run( input, length, BENCH_CHUNK_SIZE, 1, & tokens );
+    seconds = widths[ i ].run( input, length, BENCH_CHUNK_SIZE, BENCH_PASSES, & tokens );
+    printf( "; WIDTH %2u %4zu octets of context %8.3f GB/s %10lu tokens\n", widths[ i ].width, widths[ i ].context(),
+            ( (double) length * BENCH_PASSES ) / seconds / 1e9, tokens );
+  }
+
+  printf( "; END BENCHMARK\n" );
+
+  free( input );
+
+  return( 0 );
+}
+
+/* load_input()
+**
+** Reads the file and repeats it, separated by line feeds, until there's
+** at least BENCH_INPUT_SIZE octets of it.
+*/
+
+static unsigned char * load_input( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * seed = NULL;
+  unsigned char * input = NULL;
+  size_t seed_length = 0;
+  size_t seed_size = 4096;
+  size_t bytes_read;
+
+  do {
+    if( NULL == ( file = fopen( path, "rb" ) ) ) {
+      break;
+    }
+
+    if( NULL == ( seed = malloc( seed_size ) ) ) {
+      break;
+    }
+
+    while( 0 != ( bytes_read = fread( seed + seed_length, 1, seed_size - seed_length, file ) ) ) {
+      seed_length += bytes_read;
+      if( seed_length == seed_size ) {
+        seed_size *= 2;
+        if( NULL == ( seed = realloc( seed, seed_size ) ) ) {
+          break;
+        }
+      }
+    }
+
+    if( ( NULL == seed ) || ( 0 == seed_length ) ) {
+      break;
+    }
+
+    if( NULL == ( input = malloc( BENCH_INPUT_SIZE + seed_length + 1 ) ) ) {
+      break;
+    }
+
+    for( * length = 0; * length < BENCH_INPUT_SIZE; * length += seed_length + 1 ) {
+      memcpy( input + * length, seed, seed_length );
+      input[ * length + seed_length ] = '\n';
+    }
+  } while( 0 );
+
+  if( NULL != file ) {
+    fclose( file );
+  }
+
+  if( NULL != seed ) {
+    free( seed );
+  }
+
+  return( input );
+}
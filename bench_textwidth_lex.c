@@ -0,0 +1,82 @@
+/* bench_textwidth_lex.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** The half of bench_textwidth that's compiled once for each width, with
+** -DTEXTLEX_WIDTH=16, 32 or 64, like test_textwidth_lex.c.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define WIDTH_PASTE( name, width ) name##width
+#define WIDTH_EXPAND( name, width ) WIDTH_PASTE( name, width )
+#define WIDTH_NAME( name ) WIDTH_EXPAND( name, TEXTLEX_WIDTH )
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "textlex.h"
+
+/* Function Prototypes */
+
+double WIDTH_NAME( run )( unsigned char * input, size_t length, size_t chunk_size, unsigned int passes, unsigned long * tokens );
+size_t WIDTH_NAME( context )( void );
+static tTextLexErr token_handler( tTextLexContext * context, tTextLexCount token );
+
+/* Global Variables */
+
+static unsigned long counted = 0;
+
+/* run()
+**
+** Lexes the input passes times, chunk_size octets at a time, and returns
+** how many seconds it took. tokens gets the number of tokens in one pass.
+*/
+
+double WIDTH_NAME( run )( unsigned char * input, size_t length, size_t chunk_size, unsigned int passes, unsigned long * tokens ) {
+  tTextLexContext context;
+  tTextLexBuffer buffer[ 4096 ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  struct timespec start, stop;
+  size_t offset, chunk;
+  unsigned int pass;
+
+  counted = 0;
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  for( pass = 0; pass < passes; pass++ ) {
+    textlex_init( & context, buffer, sizeof( buffer ) );
+    context.token = token_handler;
+
+    for( offset = 0; offset < length; offset += chunk ) {
+      chunk = ( ( length - offset ) < chunk_size ) ? ( length - offset ) : chunk_size;
+      if( TEXTLEX_E_NOERR != ( err = textlex_update( & context, input + offset, (tTextLexCount) chunk ) ) ) {
+        fprintf( stderr, "%%BENCH-F-UPDATE; Error %u in the %d bit lexxer.\n", (unsigned int) err, TEXTLEX_WIDTH );
+        exit( 2 );
+      }
+    }
+
+    textlex_final( & context );
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+
+  * tokens = counted / passes;
+
+  return( ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9 );
+}
+
+size_t WIDTH_NAME( context )( void ) {
+  return( sizeof( tTextLexContext ) );
+}
+
+static tTextLexErr token_handler( tTextLexContext * context, tTextLexCount token ) {
+  counted++;
+  return( TEXTLEX_E_NOERR );
+}
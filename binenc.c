@@ -0,0 +1,579 @@
+/* binenc.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file implements the DSD Binary Encoder and the Text-to-Binary
+** transcoder. Please see binenc.h and binlex.h for more info.
+*/
+
+/* File Includes */
+
+#include <float.h>
+#include <stdlib.h>
+#include <string.h>
+#include "binenc.h"
+
+/* Function Prototypes */
+
+static tTextLexErr _put( tBinEncContext * context, const unsigned char * data, size_t length );
+static tTextLexErr _room( tBinEncContext * context );
+static tTextLexErr _open( tBinEncContext * context, unsigned int type );
+static tTextLexErr _close( tBinEncContext * context );
+static size_t _header( unsigned char * header, unsigned int type, size_t length );
+static tTextLexErr _item( tBinEncContext * context, unsigned int type, const unsigned char * data, size_t length );
+static tTextLexErr _fixed( tBinEncContext * context, unsigned int tag, unsigned long long value, unsigned int width );
+static tTextLexErr _integer_text( tBinEncContext * context, const unsigned char * data, size_t length );
+static tTextLexErr _float_text( tBinEncContext * context, const unsigned char * data, size_t length );
+static tTextLexErr _hex_text( tBinEncContext * context, const unsigned char * data, size_t length );
+static tTextLexErr _span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr _decoded( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr _end_string( tTextBinContext * context );
+static tTextLexErr _grow( tTextLexContext * context );
+
+/* Function Definitions */
+
+tTextLexErr binenc_init( tBinEncContext * context, unsigned char * buffer, size_t size ) {
+  memset( context, 0, sizeof( tBinEncContext ) );
+  context->buffer = buffer;
+  context->size = size;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+tTextLexErr binenc_token( tBinEncContext * context, unsigned int token ) {
+  switch( token ) {
+  case TEXTLEX_T_ARRAY_OPEN:
+  case TEXTLEX_T_MAP_OPEN:
+    if( context->depth >= BINLEX_C_DEPTH ) {
+      return( BINLEX_E_DEPTH );
+    }
+    return( _open( context, ( TEXTLEX_T_MAP_OPEN == token ) ? BINLEX_TYPE_MAP : BINLEX_TYPE_ARRAY ) );
+
+  case TEXTLEX_T_ARRAY_CLOSE:
+  case TEXTLEX_T_MAP_CLOSE:
+    if( ( 0 == context->depth ) ||
+        ( context->buffer[ context->opened[ context->depth - 1 ] ] != ( ( TEXTLEX_T_MAP_CLOSE == token ) ? BINLEX_TYPE_MAP : BINLEX_TYPE_ARRAY ) ) ) {
+      return( TEXTLEX_E_ERROR );
+    }
+    return( _close( context ) );
+
+  case TEXTLEX_T_EQUALS:
+    return( TEXTLEX_E_NOERR );
+  }
+
+  return( TEXTLEX_E_ERROR );
+}
+
+tTextLexErr binenc_integer( tBinEncContext * context, long long value ) {
+  unsigned int width = 1;
+
+  while( ( width < 8 ) && ( ( value < -( 1LL << ( width * 8 - 1 ) ) ) || ( value >= ( 1LL << ( width * 8 - 1 ) ) ) ) ) {
+    width++;
+  }
+
+  return( _fixed( context, BINLEX_TYPE_INTEGER | ( width - 1 ), (unsigned long long) value, width ) );
+}
+
+tTextLexErr binenc_unsigned( tBinEncContext * context, unsigned long long value ) {
+  static const unsigned char prefix[ 3 ] = { BINLEX_TYPE_INTEGER | BINLEX_LEN_U8, 0, 0 };
+  tTextLexErr err;
+
+  if( value <= 9223372036854775807ULL ) {
+    return( binenc_integer( context, (long long) value ) );
+  }
+
+  /* Nine octets, the first of them zero so it isn't read as negative. */
+
+  if( TEXTLEX_E_NOERR != ( err = _put( context, prefix, 3 ) ) ) {
+    return( err );
+  }
+
+  return( _fixed( context, 0, value, 8 ) );
+}
+
+tTextLexErr binenc_float( tBinEncContext * context, double value ) {
+  unsigned long long bits;
+  unsigned int single;
+  float narrow;
+
+  if( ( value != value ) || ( value - value != 0.0 ) ) {
+    return( BINLEX_E_FLOAT );
+  }
+
+  narrow = ( ( value <= FLT_MAX ) && ( value >= -FLT_MAX ) ) ? (float) value : 0.0f;
+  if( (double) narrow == value ) {
+    memcpy( & single, & narrow, sizeof( single ) );
+    return( _fixed( context, BINLEX_TYPE_FLOAT | 3, single, 4 ) );
+  }
+
+  memcpy( & bits, & value, sizeof( bits ) );
+
+  return( _fixed( context, BINLEX_TYPE_FLOAT | 7, bits, 8 ) );
+}
+
+tTextLexErr binenc_text( tBinEncContext * context, unsigned int token, const unsigned char * data, size_t length ) {
+  unsigned char tag;
+
+  switch( token ) {
+  case TEXTLEX_T_INTEGER:
+    return( _integer_text( context, data, length ) );
+
+  case TEXTLEX_T_FLOAT:
+    return( _float_text( context, data, length ) );
+
+  case TEXTLEX_T_HEX:
+    return( _hex_text( context, data, length ) );
+
+  case TEXTLEX_T_COMMENT:
+    return( TEXTLEX_E_NOERR );
+
+  case TEXTLEX_T_ANNOTATION:
+    if( 1 == length ) {
+      tag = ( 't' == data[ 0 ] ) ? BINLEX_TAG_TINY : ( 's' == data[ 0 ] ) ? BINLEX_TAG_SMALL : ( 'm' == data[ 0 ] ) ? BINLEX_TAG_MEDIUM : 0;
+      if( 0 != tag ) {
+        return( _put( context, & tag, 1 ) );
+      }
+    }
+    return( _item( context, BINLEX_TYPE_ANNOTATION, data, length ) );
+
+  case TEXTLEX_T_LITERAL:
+    return( _item( context, BINLEX_TYPE_LITERAL, data, length ) );
+
+  case TEXTLEX_T_STRING:
+    return( _item( context, BINLEX_TYPE_STRING, data, length ) );
+  }
+
+  return( TEXTLEX_E_ERROR );
+}
+
+tTextLexErr binenc_octets( tBinEncContext * context, const unsigned char * data, size_t length ) {
+  return( _item( context, BINLEX_TYPE_STRING, data, length ) );
+}
+
+tTextLexErr binenc_final( tBinEncContext * context ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+
+  if( 0 != context->depth ) {
+    return( BINLEX_E_TRUNCATED );
+  }
+
+  if( ( context->index > 0 ) && ( NULL != context->flush ) ) {
+    err = context->flush( context );
+  }
+
+  return( err );
+}
+
+/* _put()
+**
+** Appends octets to the output buffer, making room whenever it fills up.
+*/
+
+static tTextLexErr _put( tBinEncContext * context, const unsigned char * data, size_t length ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t chunk;
+
+  context->written += length;
+
+  /* Most items fit in what's left of the buffer. */
+
+  if( length <= context->size - context->index ) {
+    memcpy( & context->buffer[ context->index ], data, length );
+    context->index += length;
+    return( TEXTLEX_E_NOERR );
+  }
+
+  while( length > 0 ) {
+    if( ( context->index >= context->size ) && ( TEXTLEX_E_NOERR != ( err = _room( context ) ) ) ) {
+      return( err );
+    }
+    chunk = context->size - context->index;
+    if( chunk > length ) {
+      chunk = length;
+    }
+    memcpy( & context->buffer[ context->index ], data, chunk );
+    context->index += chunk;
+    data += chunk;
+    length -= chunk;
+  }
+
+  return( err );
+}
+
+/* _room()
+**
+** Makes room in a full buffer. Everything before the first open array or
+** map is flushed and the rest is moved to the front of the buffer. If the
+** array or map is at the front already, the overflow callback has to make
+** the buffer bigger.
+*/
+
+static tTextLexErr _room( tBinEncContext * context ) {
+  tTextLexErr err;
+  size_t flushed = ( 0 == context->depth ) ? context->index : context->opened[ 0 ];
+  size_t rest = context->index - flushed;
+  size_t size = context->size;
+  unsigned int i;
+
+  if( 0 == flushed ) {
+    if( ( NULL == context->overflow ) || ( TEXTLEX_E_NOERR != ( err = context->overflow( context ) ) ) ) {
+      return( TEXTLEX_E_MEMORY );
+    }
+    return( ( context->size > size ) ? TEXTLEX_E_NOERR : TEXTLEX_E_MEMORY );
+  }
+
+  if( NULL == context->flush ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  context->index = flushed;
+  if( TEXTLEX_E_NOERR != ( err = context->flush( context ) ) ) {
+    return( err );
+  }
+  if( 0 != context->index ) {
+    return( TEXTLEX_E_ERROR );
+  }
+
+  memmove( context->buffer, & context->buffer[ flushed ], rest );
+  context->index = rest;
+  for( i = 0; i < context->depth; i++ ) {
+    context->opened[ i ] -= flushed;
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* _open() and _close()
+**
+** _open() writes a placeholder tag with just the type in it and remembers
+** where it is. _close() replaces it with the real tag and length, moving
+** the payload along if the length needs more than the one octet.
+*/
+
+static tTextLexErr _open( tBinEncContext * context, unsigned int type ) {
+  unsigned char tag = (unsigned char) type;
+  tTextLexErr err;
+
+  if( ( context->index >= context->size ) && ( TEXTLEX_E_NOERR != ( err = _room( context ) ) ) ) {
+    return( err );
+  }
+
+  context->opened[ context->depth++ ] = context->index;
+
+  return( _put( context, & tag, 1 ) );
+}
+
+static tTextLexErr _close( tBinEncContext * context ) {
+  unsigned char header[ 9 ];
+  tTextLexErr err;
+  size_t start = context->opened[ context->depth - 1 ];
+  size_t length = context->index - start - 1;
+  size_t count = _header( header, context->buffer[ start ], length );
+
+  while( context->index + count - 1 > context->size ) {
+    if( TEXTLEX_E_NOERR != ( err = _room( context ) ) ) {
+      return( err );
+    }
+    start = context->opened[ context->depth - 1 ];
+  }
+
+  memmove( & context->buffer[ start + count ], & context->buffer[ start + 1 ], length );
+  memcpy( & context->buffer[ start ], header, count );
+  context->index += count - 1;
+  context->written += count - 1;
+  context->depth--;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* _header()
+**
+** Fills in the tag (and, for longer payloads, the length) that starts an
+** item with a payload of length octets. Returns how many octets it is.
+*/
+
+static size_t _header( unsigned char * header, unsigned int type, size_t length ) {
+  unsigned long long value = length;
+  unsigned int count, i;
+
+  if( 0 == length ) {
+    header[ 0 ] = type | BINLEX_LEN_EMPTY;
+    return( 1 );
+  }
+
+  if( length <= 8 ) {
+    header[ 0 ] = type | ( length - 1 );
+    return( 1 );
+  }
+
+  if( length <= 9 + 255 ) {
+    header[ 0 ] = type | BINLEX_LEN_U8;
+    header[ 1 ] = (unsigned char) ( length - 9 );
+    return( 2 );
+  }
+
+  if( value <= 0xFFFFULL ) {
+    header[ 0 ] = type | BINLEX_LEN_U16;
+    count = 2;
+  } else if( value <= 0xFFFFFFFFULL ) {
+    header[ 0 ] = type | BINLEX_LEN_U32;
+    count = 4;
+  } else {
+    header[ 0 ] = type | BINLEX_LEN_U64;
+    count = 8;
+  }
+
+  for( i = count; i > 0; i-- ) {
+    header[ i ] = (unsigned char) ( value & 0xFF );
+    value >>= 8;
+  }
+
+  return( count + 1 );
+}
+
+static tTextLexErr _item( tBinEncContext * context, unsigned int type, const unsigned char * data, size_t length ) {
+  unsigned char header[ 9 ];
+  tTextLexErr err;
+
+  if( TEXTLEX_E_NOERR != ( err = _put( context, header, _header( header, type, length ) ) ) ) {
+    return( err );
+  }
+
+  return( _put( context, data, length ) );
+}
+
+/* _fixed()
+**
+** Writes a tag followed by the low width octets of value, big-endian. A
+** tag of zero writes just the octets.
+*/
+
+static tTextLexErr _fixed( tBinEncContext * context, unsigned int tag, unsigned long long value, unsigned int width ) {
+  unsigned char item[ 9 ];
+  unsigned int i, start = ( 0 == tag ) ? 0 : 1;
+
+  item[ 0 ] = (unsigned char) tag;
+  for( i = width; i > 0; i-- ) {
+    item[ start + i - 1 ] = (unsigned char) ( value & 0xFF );
+    value >>= 8;
+  }
+
+  return( _put( context, item, start + width ) );
+}
+
+/* _integer_text()
+**
+** Adds up the digits of a decimal integer. Leading zeros don't matter, so
+** 007 is written as 7, but integers that don't fit in 64 bits are a
+** BINLEX_E_NUMBER error.
+*/
+
+static tTextLexErr _integer_text( tBinEncContext * context, const unsigned char * data, size_t length ) {
+  unsigned long long magnitude = 0;
+  size_t i, start;
+  int negative;
+
+  negative = ( length > 0 ) && ( '-' == data[ 0 ] );
+  start = ( ( length > 0 ) && ( ( '-' == data[ 0 ] ) || ( '+' == data[ 0 ] ) ) ) ? 1 : 0;
+
+  if( length <= start ) {
+    return( BINLEX_E_NUMBER );
+  }
+
+  for( i = start; i < length; i++ ) {
+    if( ( data[ i ] < '0' ) || ( data[ i ] > '9' ) ||
+        ( magnitude > ( 18446744073709551615ULL - ( data[ i ] - '0' ) ) / 10 ) ) {
+      return( BINLEX_E_NUMBER );
+    }
+    magnitude = magnitude * 10 + ( data[ i ] - '0' );
+  }
+
+  if( ! negative ) {
+    return( binenc_unsigned( context, magnitude ) );
+  } else if( magnitude > 9223372036854775808ULL ) {
+    return( BINLEX_E_NUMBER );
+  }
+
+  return( binenc_integer( context, ( 9223372036854775808ULL == magnitude ) ? ( -9223372036854775807LL - 1 ) : -(long long) magnitude ) );
+}
+
+/* _float_text()
+**
+** Floats are converted with strtod(), which wants them terminated.
+*/
+
+static tTextLexErr _float_text( tBinEncContext * context, const unsigned char * data, size_t length ) {
+  char text[ TEXTNUM_C_TEXT ];
+  char * copy = text;
+  tTextLexErr err;
+
+  if( ( length >= TEXTNUM_C_TEXT ) && ( NULL == ( copy = malloc( length + 1 ) ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  memcpy( copy, data, length );
+  copy[ length ] = '\0';
+  err = binenc_float( context, strtod( copy, NULL ) );
+
+  if( copy != text ) {
+    free( copy );
+  }
+
+  return( err );
+}
+
+/* _hex_text()
+**
+** A $ hex number is written as an unsigned integer, so it can't have more
+** than 16 digits (not counting leading zeros.)
+*/
+
+static tTextLexErr _hex_text( tBinEncContext * context, const unsigned char * data, size_t length ) {
+  unsigned long long value = 0;
+  unsigned char digit;
+  size_t i;
+
+  if( 0 == length ) {
+    return( BINLEX_E_NUMBER );
+  }
+
+  for( i = 0; i < length; i++ ) {
+    digit = data[ i ];
+    if( ( value >> 60 ) || ! ( ( ( digit >= '0' ) && ( digit <= '9' ) ) || ( ( ( digit | 0x20 ) >= 'a' ) && ( ( digit | 0x20 ) <= 'f' ) ) ) ) {
+      return( BINLEX_E_NUMBER );
+    }
+    value = ( value << 4 ) | ( ( digit <= '9' ) ? ( digit - '0' ) : ( ( digit | 0x20 ) - 'a' + 10 ) );
+  }
+
+  return( binenc_unsigned( context, value ) );
+}
+
+tTextLexErr textbin_init( tTextBinContext * context, tBinEncContext * encoder ) {
+  tTextLexBuffer * buffer;
+
+  if( NULL == ( buffer = malloc( TEXTBIN_BUFFER_SIZE ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  textlex_init( & context->text, buffer, TEXTBIN_BUFFER_SIZE );
+  textlex_extend( & context->text, & context->extension );
+  context->extension.span = _span;
+  context->extension.decoded = _decoded;
+  context->text.overflow = _grow;
+  context->encoder = encoder;
+  context->string = 0;
+  context->ended = 0;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+tTextLexErr textbin_update( tTextBinContext * context, tTextLexBuffer * data, tTextLexCount length ) {
+  return( textlex_update( & context->text, data, length ) );
+}
+
+tTextLexErr textbin_final( tTextBinContext * context ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+
+  if( NULL != context->text.buffer ) {
+    err = textlex_final( & context->text );
+    free( context->text.buffer );
+    context->text.buffer = NULL;
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = _end_string( context );
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = binenc_final( context->encoder );
+  }
+
+  return( err );
+}
+
+/* _span()
+**
+** Sends each lexeme to the encoder. A comment inside a base16 string means
+** there's more of the string to come, so the string isn't finished until
+** something other than a comment comes after the TEXTLEX_T_END of its last
+** piece. The comment's own TEXTLEX_T_END doesn't count.
+*/
+
+static tTextLexErr _span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  tTextBinContext * transcoder = (tTextBinContext *) context;
+  tTextLexErr err;
+
+  if( TEXTLEX_T_END == token ) {
+    transcoder->ended = ( transcoder->ended < 0 ) ? 0 : 1;
+    return( TEXTLEX_E_NOERR );
+  }
+
+  if( ( TEXTLEX_T_COMMENT == token ) && ( TEXTLEX_S_BASE16_COMMENT == context->state ) ) {
+    transcoder->ended = -1;
+    return( TEXTLEX_E_NOERR );
+  }
+
+  if( TEXTLEX_E_NOERR != ( err = _end_string( transcoder ) ) ) {
+    return( err );
+  }
+
+  if( token >= TEXTLEX_T_ARRAY_OPEN ) {
+    return( binenc_token( transcoder->encoder, token ) );
+  }
+
+  return( binenc_text( transcoder->encoder, token, data, length ) );
+}
+
+/* _decoded()
+**
+** Appends the octets of a base16 or base64 string to the string item being
+** written, starting one if there isn't one.
+*/
+
+static tTextLexErr _decoded( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  tTextBinContext * transcoder = (tTextBinContext *) context;
+  tTextLexErr err;
+
+  if( TEXTLEX_E_NOERR != ( err = _end_string( transcoder ) ) ) {
+    return( err );
+  }
+
+  if( ! transcoder->string ) {
+    if( TEXTLEX_E_NOERR != ( err = _open( transcoder->encoder, BINLEX_TYPE_STRING ) ) ) {
+      return( err );
+    }
+    transcoder->string = 1;
+    transcoder->ended = 0;
+  }
+
+  return( _put( transcoder->encoder, data, length ) );
+}
+
+static tTextLexErr _end_string( tTextBinContext * context ) {
+  if( ! context->string || ! context->ended ) {
+    return( TEXTLEX_E_NOERR );
+  }
+
+  context->string = 0;
+
+  return( _close( context->encoder ) );
+}
+
+static tTextLexErr _grow( tTextLexContext * context ) {
+  tTextLexBuffer * buffer;
+  tTextLexCount size = context->size * 2;
+
+  if( size <= context->size ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  if( NULL == ( buffer = realloc( context->buffer, size ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  context->buffer = buffer;
+  context->size = size;
+
+  return( TEXTLEX_E_NOERR );
+}
@@ -0,0 +1,173 @@
+/* binenc.h
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file provides the interface to the DSD Binary Encoder and the
+** Text-to-Binary transcoder implemented in binenc.c. The encoder writes
+** DSD/Binary items (see binlex.h for the format) into a buffer you supply
+** and calls a flush callback whenever it fills up, so you can write a
+** document of any size without building it in memory first. The transcoder
+** hooks the encoder up to the text lexxer's callbacks and turns DSD/Text
+** into DSD/Binary in a single pass.
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_BINENC
+#define _H_BINENC
+
+/* The transcoder starts with a lexxer buffer this big and doubles it when a
+** lexeme that has to be copied doesn't fit.
+*/
+
+#define TEXTBIN_BUFFER_SIZE 4096
+
+/* File Includes */
+
+#include <stddef.h>
+#include "binlex.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+/* The encoder's context. buffer, size and index work like they do in the
+** lexxer's context: index is how much of buffer holds output that hasn't
+** been flushed yet. The flush callback should write out index octets from
+** buffer and set index back to zero. It's called whenever the buffer fills
+** and once more by binenc_final(). written counts all the octets the encoder
+** has produced, flushed or not.
+**
+** An array or a map can't be written out until it's closed, since its tag
+** says how long it is. opened holds where each open one starts in buffer,
+** and only the octets before the first of them are flushed. If an array or
+** map fills the whole buffer, the overflow callback is called; it can make
+** room by setting buffer and size to a bigger one with the same contents,
+** like the lexxer's overflow callback. Without one, that's a
+** TEXTLEX_E_MEMORY error.
+*/
+
+typedef struct _bin_enc_context {
+  unsigned char  * buffer;
+  size_t           size;
+  size_t           index;
+  size_t           written;
+  tTextLexErr    (*flush)( struct _bin_enc_context * context );
+  tTextLexErr    (*overflow)( struct _bin_enc_context * context );
+  unsigned int     depth;
+  size_t           opened[ BINLEX_C_DEPTH + 1 ];
+} tBinEncContext;
+
+/* The transcoder's context. The lexxer's context comes first so the lexxer
+** callbacks can find the encoder. string is set while a base16 or base64
+** string is being written and ended once the TEXTLEX_T_END after a piece
+** of it has been seen. ended is -1 from a comment inside the string to the
+** comment's TEXTLEX_T_END.
+*/
+
+typedef struct _text_bin_context {
+  tTextLexContext  text;
+  tTextLexExtension extension;
+  tBinEncContext * encoder;
+  int              string;
+  int              ended;
+} tTextBinContext;
+
+/* Function Prototypes */
+
+/* binenc_init()
+**
+** Initializes an encoder context to write into buffer. Set the flush (and
+** if you like, overflow) callback afterwards.
+*/
+
+tTextLexErr binenc_init( tBinEncContext * context, unsigned char * buffer, size_t size );
+
+/* binenc_token()
+**
+** Opens or closes an array or a map: TEXTLEX_T_ARRAY_OPEN,
+** TEXTLEX_T_ARRAY_CLOSE, TEXTLEX_T_MAP_OPEN or TEXTLEX_T_MAP_CLOSE. A close
+** that doesn't match the last open is a TEXTLEX_E_ERROR and nesting more
+** than BINLEX_C_DEPTH deep is a BINLEX_E_DEPTH. TEXTLEX_T_EQUALS is accepted
+** and writes nothing, since DSD/Binary maps don't need it.
+*/
+
+tTextLexErr binenc_token( tBinEncContext * context, unsigned int token );
+
+/* binenc_integer() and binenc_unsigned()
+**
+** Write an integer in the fewest two's complement octets that hold it.
+*/
+
+tTextLexErr binenc_integer( tBinEncContext * context, long long value );
+tTextLexErr binenc_unsigned( tBinEncContext * context, unsigned long long value );
+
+/* binenc_float()
+**
+** Writes a double, as a single if a single holds it exactly. Returns
+** BINLEX_E_FLOAT for infinities and NaNs, which have no DSD/Text
+** representation.
+*/
+
+tTextLexErr binenc_float( tBinEncContext * context, double value );
+
+/* binenc_text()
+**
+** Writes a lexeme the way textlex delivers it. TEXTLEX_T_INTEGER and
+** TEXTLEX_T_FLOAT lexemes are written as numbers and TEXTLEX_T_HEX ones as
+** unsigned integers, so they have to be $ hex numbers, not base16 strings
+** (write those with binenc_octets().) Integers that don't fit in 64 bits
+** are a BINLEX_E_NUMBER error. The @t, @s and @m annotations are written as
+** type system tags. Comments aren't written at all, and base64 strings are
+** a TEXTLEX_E_ERROR; decode them and use binenc_octets().
+*/
+
+tTextLexErr binenc_text( tBinEncContext * context, unsigned int token, const unsigned char * data, size_t length );
+
+/* binenc_octets()
+**
+** Writes length octets of binary data as a string.
+*/
+
+tTextLexErr binenc_octets( tBinEncContext * context, const unsigned char * data, size_t length );
+
+/* binenc_final()
+**
+** Flushes whatever is left in the buffer. Returns BINLEX_E_TRUNCATED if an
+** array or map is still open.
+*/
+
+tTextLexErr binenc_final( tBinEncContext * context );
+
+/* textbin_init()
+**
+** Sets up a transcoder that writes to encoder, which should already have
+** been set up with binenc_init(). This allocates TEXTBIN_BUFFER_SIZE octets
+** for the lexxer's buffer, so check for TEXTLEX_E_MEMORY.
+**
+** The lexxer is put in span mode, so lexemes are encoded straight out of
+** your input most of the time. Lexemes that have to be copied (because they
+** straddle a call to textbin_update() or contain escapes) grow the buffer
+** as needed, so every lexeme is encoded as a single item. Base16 and base64
+** strings are decoded by the lexxer and written as strings of octets; a
+** base16 string with comments in it is still a single string.
+*/
+
+tTextLexErr textbin_init( tTextBinContext * context, tBinEncContext * encoder );
+
+/* textbin_update()
+**
+** Transcodes the next length octets of DSD/Text. Errors are reported just
+** like textlex_update() reports them.
+*/
+
+tTextLexErr textbin_update( tTextBinContext * context, tTextLexBuffer * data, tTextLexCount length );
+
+/* textbin_final()
+**
+** Finishes off the document, flushes the encoder and frees the lexxer's
+** buffer. Call it even if textbin_update() returned an error.
+*/
+
+tTextLexErr textbin_final( tTextBinContext * context );
+
+#endif /* _H_BINENC */
@@ -0,0 +1,439 @@
+/* binlex.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file implements a DSD Binary Lexxer. Please see binlex.h or README.md
+** for more info.
+**
+** Unlike the text lexxer, this one doesn't look at every octet. It reads a
+** tag, works out how long the item is and then deals with the whole payload
+** (or as much of it as is in the current input) at once. The context only
+** needs to remember which part of an item it's in, how many octets of the
+** length or number it has collected, how much payload is left and where
+** each array and map it's in ends.
+*/
+
+/* Macro Definitions */
+
+#define BINLEX_P_TAG      0 /* Waiting for a tag */
+#define BINLEX_P_LENGTH   1 /* Collecting a multi-octet length */
+#define BINLEX_P_NUMBER   2 /* Collecting a number */
+#define BINLEX_P_PAYLOAD  3 /* Copying a payload */
+
+#define EMIT( x ) if( NULL != context->extension->span ) { err = context->extension->span( context, x, context->buffer, context->index ); } else if( NULL != context->token ) { err = context->token( context, x ); } context->index = 0
+
+/* File Includes */
+
+#include <float.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "binlex.h"
+
+/* Function Prototypes */
+
+static tTextLexErr _begin( tBinLexContext * binlex, unsigned int tag );
+static tTextLexErr _length( tBinLexContext * binlex, size_t length );
+static tTextLexErr _payload( tBinLexContext * binlex, tTextLexBuffer * data, size_t length );
+static tTextLexErr _number( tBinLexContext * binlex );
+static tTextLexErr _copy( tTextLexContext * context, const unsigned char * data, size_t length );
+static tTextLexErr _finish( tBinLexContext * binlex );
+static tTextLexErr _ended( tBinLexContext * binlex, int value );
+static unsigned long long _big_endian( const unsigned char * data, unsigned int length );
+
+/* Global Variables */
+
+/* The token and text lexxer state for each type nibble. The state is what the
+** text lexxer would be in while it copies that kind of lexeme, which is what
+** the overflow callback looks at.
+*/
+
+static const struct {
+  unsigned char token;
+  unsigned char state;
+} _types[ 16 ] = {
+  { TEXTLEX_T_ANNOTATION, TEXTLEX_S_START },    /* 0x0_ type systems */
+  { TEXTLEX_T_INTEGER,    TEXTLEX_S_NUMBER },
+  { TEXTLEX_T_FLOAT,      TEXTLEX_S_FLOAT },
+  { TEXTLEX_T_LITERAL,    TEXTLEX_S_LITERAL },
+  { TEXTLEX_T_STRING,     TEXTLEX_S_STRING },
+  { TEXTLEX_T_ANNOTATION, TEXTLEX_S_ANNOTATE },
+  { TEXTLEX_T_MAP_OPEN,   TEXTLEX_S_START },
+  { TEXTLEX_T_ARRAY_OPEN, TEXTLEX_S_START },
+  { TEXTLEX_T_END,        TEXTLEX_S_START },
+  { TEXTLEX_T_END,        TEXTLEX_S_START },
+  { TEXTLEX_T_END,        TEXTLEX_S_START },
+  { TEXTLEX_T_END,        TEXTLEX_S_START },
+  { TEXTLEX_T_END,        TEXTLEX_S_START },
+  { TEXTLEX_T_END,        TEXTLEX_S_START },
+  { TEXTLEX_T_END,        TEXTLEX_S_START },
+  { TEXTLEX_T_END,        TEXTLEX_S_START }
+};
+
+/* Function Definitions */
+
+tTextLexErr binlex_init( tBinLexContext * context, tTextLexBuffer * buffer, tTextLexCount size ) {
+  memset( context, 0, sizeof( tBinLexContext ) );
+  textlex_init( & context->text, buffer, size );
+  return( textlex_extend( & context->text, & context->extension ) );
+}
+
+tTextLexErr binlex_update( tBinLexContext * binlex, tTextLexBuffer * data, tTextLexCount length ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexContext * context = & binlex->text;
+  size_t i = 0;
+  size_t chunk;
+  unsigned long long value;
+
+  context->bytes_read = 0;
+
+  while( ( i < length ) && ( TEXTLEX_E_NOERR == err ) ) {
+    switch( binlex->phase ) {
+    case BINLEX_P_TAG:
+      chunk = 1;
+      binlex->position++;
+      err = _begin( binlex, data[ i ] );
+      break;
+
+    case BINLEX_P_LENGTH:
+    case BINLEX_P_NUMBER:
+      chunk = binlex->need - binlex->have;
+      if( chunk > length - i ) {
+        chunk = length - i;
+      }
+      binlex->position += chunk;
+      memcpy( & binlex->scratch[ binlex->have ], & data[ i ], chunk );
+      binlex->have += chunk;
+      if( binlex->have < binlex->need ) {
+        break;
+      }
+      if( BINLEX_P_NUMBER == binlex->phase ) {
+        err = _number( binlex );
+        break;
+      }
+      value = _big_endian( binlex->scratch, binlex->need );
+      if( 1 == binlex->need ) {
+        value += 9;
+      }
+      if( (size_t) value != value ) {
+        err = BINLEX_E_LENGTH;
+        break;
+      }
+      err = _length( binlex, (size_t) value );
+      break;
+
+    default:
+      chunk = ( binlex->remaining < length - i ) ? binlex->remaining : length - i;
+      binlex->position += chunk;
+      err = _payload( binlex, & data[ i ], chunk );
+      break;
+    }
+
+    /* Like textlex, octet is left pointing at the octet that caused an
+    ** error, but bytes_read includes it.
+    */
+
+    if( TEXTLEX_E_NOERR != err ) {
+      context->octet += chunk - 1;
+      context->bytes_read += chunk;
+      break;
+    }
+
+    i += chunk;
+    context->octet += chunk;
+    context->bytes_read += chunk;
+  }
+
+  return( err );
+}
+
+tTextLexErr binlex_final( tBinLexContext * binlex ) {
+  return( ( ( BINLEX_P_TAG == binlex->phase ) && ( 0 == binlex->depth ) ) ? TEXTLEX_E_NOERR : BINLEX_E_TRUNCATED );
+}
+
+/* _begin()
+**
+** Starts a new item. Type system annotations are sent right away;
+** everything else sets up the context to collect a length or goes on to
+** _length() with the length in the tag.
+*/
+
+static tTextLexErr _begin( tBinLexContext * binlex, unsigned int tag ) {
+  static const char _systems[ 9 ] = { 0, 0, 't', 0, 's', 0, 0, 0, 'm' };
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexContext * context = & binlex->text;
+  unsigned int code = tag & 0x0F;
+
+  binlex->tag = tag;
+  binlex->have = 0;
+  binlex->token = _types[ tag >> 4 ].token;
+
+  if( BINLEX_TYPE_SYSTEM == ( tag & 0xF0 ) ) {
+    if( ( code > 8 ) || ( 0 == _systems[ code ] ) ) {
+      return( BINLEX_E_TAG );
+    }
+    context->state = TEXTLEX_S_ANNOTATE;
+    if( TEXTLEX_E_NOERR != ( err = _copy( context, (const unsigned char *) & _systems[ code ], 1 ) ) ) {
+      return( err );
+    }
+    return( _finish( binlex ) );
+  }
+
+  if( TEXTLEX_T_END == binlex->token ) {
+    return( BINLEX_E_TAG );
+  }
+
+  if( code < BINLEX_LEN_U8 ) {
+    err = _length( binlex, code + 1 );
+  } else if( code <= BINLEX_LEN_U64 ) {
+    binlex->need = 1 << ( code - BINLEX_LEN_U8 );
+    binlex->phase = BINLEX_P_LENGTH;
+  } else if( BINLEX_LEN_EMPTY == code ) {
+    err = _length( binlex, 0 );
+  } else {
+    err = BINLEX_E_TAG;
+  }
+
+  return( err );
+}
+
+/* _length()
+**
+** Now that it knows how long the item is, checks it fits in the array or
+** map it's in. The check subtracts rather than adds so a huge length can't
+** wrap around past the end. Arrays and maps are opened, numbers are
+** collected in scratch and everything else is copied.
+*/
+
+static tTextLexErr _length( tBinLexContext * binlex, size_t length ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexContext * context = & binlex->text;
+  tBinLexLevel * level;
+  unsigned int type = binlex->tag & 0xF0;
+
+  if( ( binlex->depth > 0 ) && ( length > binlex->levels[ binlex->depth - 1 ].end - binlex->position ) ) {
+    return( BINLEX_E_OVERRUN );
+  }
+
+  switch( type ) {
+  case BINLEX_TYPE_MAP:
+  case BINLEX_TYPE_ARRAY:
+    if( BINLEX_C_DEPTH == binlex->depth ) {
+      return( BINLEX_E_DEPTH );
+    }
+    level = & binlex->levels[ binlex->depth++ ];
+    level->end = binlex->position + length;
+    level->map = ( BINLEX_TYPE_MAP == type );
+    level->count = 0;
+    binlex->phase = BINLEX_P_TAG;
+    EMIT( binlex->token );
+    if( TEXTLEX_E_NOERR == err ) {
+      err = _ended( binlex, 0 );
+    }
+    break;
+
+  case BINLEX_TYPE_INTEGER:
+  case BINLEX_TYPE_FLOAT:
+    if( ( BINLEX_TYPE_INTEGER == type ) ? ( ( length < 1 ) || ( length > 9 ) ) : ( ( 4 != length ) && ( 8 != length ) ) ) {
+      return( BINLEX_E_NUMBER );
+    }
+    binlex->need = (unsigned int) length;
+    binlex->have = 0;
+    binlex->phase = BINLEX_P_NUMBER;
+    break;
+
+  default:
+    context->state = _types[ type >> 4 ].state;
+    binlex->remaining = length;
+    binlex->phase = BINLEX_P_PAYLOAD;
+    if( 0 == length ) {
+      err = _finish( binlex );
+    }
+    break;
+  }
+
+  return( err );
+}
+
+/* _payload()
+**
+** Deals with the next length octets of a payload. In span mode, a payload
+** that's all there in one piece goes straight to the span callback.
+*/
+
+static tTextLexErr _payload( tBinLexContext * binlex, tTextLexBuffer * data, size_t length ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexContext * context = & binlex->text;
+
+  binlex->remaining -= length;
+
+  if( ( NULL != context->extension->span ) && ( 0 == context->index ) && ( 0 == binlex->remaining ) && ( (tTextLexCount) length == length ) ) {
+    err = context->extension->span( context, binlex->token, data, (tTextLexCount) length );
+    context->index = 0;
+    context->state = TEXTLEX_S_START;
+    binlex->phase = BINLEX_P_TAG;
+    if( TEXTLEX_E_NOERR == err ) {
+      EMIT( TEXTLEX_T_END );
+    }
+    if( TEXTLEX_E_NOERR == err ) {
+      err = _ended( binlex, TEXTLEX_T_ANNOTATION != binlex->token );
+    }
+    return( err );
+  }
+
+  err = _copy( context, data, length );
+
+  if( ( TEXTLEX_E_NOERR == err ) && ( 0 == binlex->remaining ) ) {
+    err = _finish( binlex );
+  }
+
+  return( err );
+}
+
+/* _number()
+**
+** Turns an integer or a float into text and sends it. A 9 octet integer
+** is an unsigned one with a zero in front.
+*/
+
+static tTextLexErr _number( tBinLexContext * binlex ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  unsigned long long value;
+  unsigned long long sign;
+  char text[ TEXTNUM_C_TEXT ];
+  size_t length;
+  unsigned int single;
+  float narrow;
+  double real;
+
+  if( BINLEX_TYPE_FLOAT == ( binlex->tag & 0xF0 ) ) {
+    value = _big_endian( binlex->scratch, binlex->need );
+    if( 4 == binlex->need ) {
+      single = (unsigned int) value;
+      memcpy( & narrow, & single, sizeof( narrow ) );
+      real = narrow;
+    } else {
+      memcpy( & real, & value, sizeof( real ) );
+    }
+    if( 0 == ( length = textnum_float_text( real, text ) ) ) {
+      return( BINLEX_E_FLOAT );
+    }
+  } else if( 9 == binlex->need ) {
+    if( 0 != binlex->scratch[ 0 ] ) {
+      return( BINLEX_E_NUMBER );
+    }
+    length = textnum_integer_text( _big_endian( & binlex->scratch[ 1 ], 8 ), 0, text );
+  } else {
+    value = _big_endian( binlex->scratch, binlex->need );
+    sign = 1ULL << ( binlex->need * 8 - 1 );
+    if( value & sign ) {
+      length = textnum_integer_text( ( ~value & ( sign - 1 ) ) + 1, 1, text );
+    } else {
+      length = textnum_integer_text( value, 0, text );
+    }
+  }
+
+  binlex->text.state = _types[ binlex->tag >> 4 ].state;
+  if( TEXTLEX_E_NOERR == ( err = _copy( & binlex->text, (unsigned char *) text, length ) ) ) {
+    err = _finish( binlex );
+  }
+
+  return( err );
+}
+
+/* _copy()
+**
+** Copies octets into the buffer, calling the overflow callback each time it
+** fills up, just like the text lexxer's COPY_RUN does.
+*/
+
+static tTextLexErr _copy( tTextLexContext * context, const unsigned char * data, size_t length ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t chunk;
+
+  while( ( length > 0 ) && ( TEXTLEX_E_NOERR == err ) ) {
+    if( context->index >= context->size ) {
+      err = TEXTLEX_E_ERROR;
+      break;
+    }
+    chunk = context->size - context->index;
+    if( chunk > length ) {
+      chunk = length;
+    }
+    memcpy( & context->buffer[ context->index ], data, chunk );
+    context->index += chunk;
+    data += chunk;
+    length -= chunk;
+    if( context->index >= context->size ) {
+      err = context->overflow( context );
+    }
+  }
+
+  return( err );
+}
+
+/* _finish()
+**
+** Sends the token for the item that just ended, followed by an END token,
+** and gets ready for the next tag.
+*/
+
+static tTextLexErr _finish( tBinLexContext * binlex ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexContext * context = & binlex->text;
+
+  EMIT( binlex->token );
+  if( TEXTLEX_E_NOERR == err ) {
+    EMIT( TEXTLEX_T_END );
+  }
+
+  context->state = TEXTLEX_S_START;
+  binlex->phase = BINLEX_P_TAG;
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = _ended( binlex, TEXTLEX_T_ANNOTATION != binlex->token );
+  }
+
+  return( err );
+}
+
+/* _ended()
+**
+** Called at the end of each item. If it was a value (annotations aren't)
+** and a key in a map, the map gets an '=' after it, unless it's the last
+** thing in the map. Then it closes every array and map that ends here;
+** each of those is a value in the one around it.
+*/
+
+static tTextLexErr _ended( tBinLexContext * binlex, int value ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexContext * context = & binlex->text;
+  tBinLexLevel * level;
+
+  while( ( binlex->depth > 0 ) && ( TEXTLEX_E_NOERR == err ) ) {
+    level = & binlex->levels[ binlex->depth - 1 ];
+    if( value && ( 0 == ( level->count++ & 1 ) ) && level->map && ( binlex->position < level->end ) ) {
+      EMIT( TEXTLEX_T_EQUALS );
+    }
+    if( ( TEXTLEX_E_NOERR != err ) || ( binlex->position < level->end ) ) {
+      break;
+    }
+    binlex->depth--;
+    EMIT( level->map ? TEXTLEX_T_MAP_CLOSE : TEXTLEX_T_ARRAY_CLOSE );
+    value = 1;
+  }
+
+  return( err );
+}
+
+static unsigned long long _big_endian( const unsigned char * data, unsigned int length ) {
+  unsigned long long value = 0;
+  unsigned int i;
+
+  for( i = 0; i < length; i++ ) {
+    value = ( value << 8 ) | data[ i ];
+  }
+
+  return( value );
+}
@@ -0,0 +1,152 @@
+/* binlex.h
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file provides the interface to the DSD Binary Lexxer implemented in
+** binlex.c. It turns DSD/Binary into the same sequence of TEXTLEX_T_* tokens
+** the DSD Text Lexxer produces for the equivalent DSD/Text, so the token,
+** span and overflow callbacks you wrote for textlex work unchanged. Since
+** DSD/Binary holds values rather than text, "the equivalent DSD/Text" is
+** the way binlex writes them: integers in decimal, floats as the shortest
+** text that reads back the same and every string quoted (DSD/Binary has no
+** comments, and base16 and base64 strings are just strings in it.)
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_BINLEX
+#define _H_BINLEX
+
+/* Macro Definitions : Error Codes
+**
+** These pick up where the DSD Text Lexxer's error codes leave off.
+*/
+
+#define BINLEX_E_NUMBER          92 /* Number payload that isn't a size we know */
+#define BINLEX_E_DEPTH           93 /* Arrays and maps nested too deep */
+#define BINLEX_E_OVERRUN         94 /* Item runs past the end of its array or map */
+#define BINLEX_E_TAG             96 /* Unknown tag octet */
+#define BINLEX_E_LENGTH          97 /* Length doesn't fit in a size_t */
+#define BINLEX_E_TRUNCATED       98 /* Input ended in the middle of an item */
+#define BINLEX_E_FLOAT           99 /* Infinity or NaN (no DSD/Text for them) */
+
+/* Macro Definitions : Tags
+**
+** Every item in a DSD/Binary document starts with a tag octet, with a type
+** in the high nibble and a length code in the low nibble: codes 0 through
+** 7 mean the payload is 1 through 8 octets long, BINLEX_LEN_U8 means the
+** length is 9 plus the value of the following octet, BINLEX_LEN_U16,
+** BINLEX_LEN_U32 and BINLEX_LEN_U64 mean the length follows in 2, 4 or 8
+** big-endian octets and BINLEX_LEN_EMPTY means there's no payload at all.
+** So "username" is 47 followed by its 8 octets and "OhMeadhbh" is 48 00
+** followed by its 9.
+**
+** Integers are big-endian two's complement, 1 to 8 octets long (or 9 with
+** a leading zero, for the unsigned ones that don't fit in 8), so 2 is
+** 10 02. Floats are big-endian IEEE 754 singles or doubles. Strings are
+** octets, whether they were quoted, base16 or base64 in DSD/Text; literals
+** and annotations are their names. The payload of an array or a map is
+** the items in it, so they don't need closing tags, and a map's items
+** alternate between keys and values without any '='. The type system
+** annotations have no payload: the tag's low nibble is how many octets
+** wide the type system's integers are.
+*/
+
+#define BINLEX_TAG_TINY         0x02 /* @t */
+#define BINLEX_TAG_SMALL        0x04 /* @s */
+#define BINLEX_TAG_MEDIUM       0x08 /* @m */
+
+#define BINLEX_TYPE_SYSTEM      0x00
+#define BINLEX_TYPE_INTEGER     0x10
+#define BINLEX_TYPE_FLOAT       0x20
+#define BINLEX_TYPE_LITERAL     0x30
+#define BINLEX_TYPE_STRING      0x40
+#define BINLEX_TYPE_ANNOTATION  0x50
+#define BINLEX_TYPE_MAP         0x60
+#define BINLEX_TYPE_ARRAY       0x70
+
+#define BINLEX_LEN_U8           0x08
+#define BINLEX_LEN_U16          0x09
+#define BINLEX_LEN_U32          0x0A
+#define BINLEX_LEN_U64          0x0B
+#define BINLEX_LEN_EMPTY        0x0F
+
+/* Arrays and maps can't be nested any deeper than this. */
+
+#define BINLEX_C_DEPTH          32
+
+/* File Includes */
+
+#include <stddef.h>
+#include "textlex.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+/* The binary lexxer's context. The text lexxer's context comes first, so
+** callbacks get a tTextLexContext pointer just like they do from textlex
+** (and can cast it back to a tBinLexContext pointer if they need to.) The
+** buffer, size, index, line, octet and bytes_read members mean what they do
+** for textlex, except that line is always zero and octet counts every octet
+** of the document. levels holds the end of each array or map the lexxer
+** is in (as a position in the document) and how many items it has seen in
+** it, so it knows when to close it and when a map needs an '='.
+*/
+
+typedef struct {
+  unsigned long long end;
+  unsigned int       map;
+  unsigned int       count;
+} tBinLexLevel;
+
+typedef struct _bin_lex_context {
+  tTextLexContext  text;
+  tTextLexExtension extension;
+  unsigned int     phase;
+  unsigned int     tag;
+  unsigned int     token;
+  unsigned int     need;
+  unsigned int     have;
+  size_t           remaining;
+  unsigned char    scratch[ 16 ];
+  unsigned long long position;
+  unsigned int     depth;
+  tBinLexLevel     levels[ BINLEX_C_DEPTH ];
+} tBinLexContext;
+
+/* Function Prototypes */
+
+/* binlex_init()
+**
+** Initializes a binlex context, just like textlex_init() does for a textlex
+** context. Set the token callback in context->text (or the span callback
+** in context->extension) afterwards.
+*/
+
+tTextLexErr binlex_init( tBinLexContext * context, tTextLexBuffer * buffer, tTextLexCount size );
+
+/* binlex_update()
+**
+** Lexes the next length octets of a DSD/Binary document. Like
+** textlex_update(), you can pass the whole document at once or split it up
+** any way you like; the context remembers where it was in the middle of an
+** item.
+**
+** String, literal and annotation payloads are copied into the buffer with
+** memcpy() (calling the overflow callback as it fills) and numbers are
+** converted to text. In span mode, payloads that are entirely inside data
+** are passed straight to the span callback.
+*/
+
+tTextLexErr binlex_update( tBinLexContext * context, tTextLexBuffer * data, tTextLexCount length );
+
+/* binlex_final()
+**
+** Call this once after the last call to binlex_update(). It returns
+** BINLEX_E_TRUNCATED if the document ended in the middle of an item (or
+** of an array or map.)
+*/
+
+tTextLexErr binlex_final( tBinLexContext * context );
+
+#endif /* _H_BINLEX */
@@ -0,0 +1,274 @@
+/* dsd.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program runs DSD/Text files through the lexxer with the file front
+** end in textfile.c:
+**
+**   dsd tokens [file ...]    prints each token, one to a line
+**   dsd validate [file ...]  checks each file lexes and its brackets match
+**   dsd stats [file ...]     counts tokens, lines and nesting depth
+**
+** With no files (or a file named "-") it reads standard input. After each
+** file it reports how long it took and how many MB/s that comes to; for
+** tokens the report goes to standard error so it doesn't get mixed in with
+** the tokens. It exits with 1 if any file had an error.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+#define DSD_BUFFER_SIZE   4096
+#define DSD_MAX_DEPTH     1024
+#define DSD_OUTPUT_SIZE   ( 1024 * 1024 )
+
+#define DSD_C_TOKENS      0
+#define DSD_C_VALIDATE    1
+#define DSD_C_STATS       2
+
+#define DSD_E_NESTING     105
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+#include "textfile.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  unsigned long long counts[ TEXTLEX_C_TOKENS ];
+  unsigned long long octets;
+  tTextLexCount depth;
+  tTextLexCount deepest;
+  tTextLexCount line;
+  tTextLexCount octet;
+  unsigned char stack[ DSD_MAX_DEPTH ];
+} tDsdStats;
+
+/* Function Prototypes */
+
+static int process( unsigned int command, char * path );
+static void report( FILE * out, char * path, unsigned long long length, tTextLexCount lines, double seconds );
+static tTextLexErr token_handler( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr span_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr overflow_handler( tTextLexContext * context );
+static const char * token_name( unsigned int token );
+
+/* Global Variables */
+
+static const char * commands [] = { "tokens", "validate", "stats", NULL };
+static tDsdStats stats;
+
+int main( int argc, char * argv [] ) {
+  static char output[ DSD_OUTPUT_SIZE ];
+  unsigned int command;
+  int i, failed = 0;
+
+  for( command = 0; NULL != commands[ command ]; command++ ) {
+    if( ( argc > 1 ) && ( 0 == strcmp( argv[ 1 ], commands[ command ] ) ) ) {
+      break;
+    }
+  }
+
+  if( NULL == commands[ command ] ) {
+    fprintf( stderr, "usage: dsd tokens|validate|stats [file ...]\n" );
+    return( 2 );
+  }
+
+  setvbuf( stdout, output, _IOFBF, DSD_OUTPUT_SIZE );
+
+  if( 2 == argc ) {
+    failed |= process( command, "-" );
+  }
+
+  for( i = 2; i < argc; i++ ) {
+    failed |= process( command, argv[ i ] );
+  }
+
+  return( failed );
+}
+
+/* process()
+**
+** Runs one file through the lexxer and prints what the command asked for.
+** Returns 1 if there was an error.
+*/
+
+static int process( unsigned int command, char * path ) {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer * buffer;
+  tTextLexErr err;
+  struct timespec start, stop;
+  unsigned long long length;
+  double seconds;
+  int fd;
+  unsigned int i;
+
+  if( 0 == strcmp( path, "-" ) ) {
+    fd = STDIN_FILENO;
+  } else if( 0 > ( fd = open( path, O_RDONLY ) ) ) {
+    fprintf( stderr, "%%DSD-E-OPEN; %s: %s\n", path, strerror( errno ) );
+    return( 1 );
+  }
+
+  if( NULL == ( buffer = malloc( DSD_BUFFER_SIZE ) ) ) {
+    fprintf( stderr, "%%DSD-F-MEMORY; Can't allocate the lexxer buffer.\n" );
+    exit( 2 );
+  }
+
+  memset( & stats, 0, sizeof( tDsdStats ) );
+
+  /* Tokens get printed whole, so they come from the buffer, which grows to
+  ** fit. Validating and counting don't need the lexemes copied anywhere.
+  */
+
+  textlex_init( & context, buffer, DSD_BUFFER_SIZE );
+  textlex_extend( & context, & extension );
+  context.overflow = overflow_handler;
+  if( DSD_C_TOKENS == command ) {
+    context.token = token_handler;
+  } else {
+    extension.span = span_handler;
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & start );
+
+  err = textfile_update( & context, fd, & length );
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textlex_final( & context );
+  }
+  if( ( TEXTLEX_E_NOERR == err ) && ( 0 != stats.depth ) ) {
+    err = DSD_E_NESTING;
+    stats.line = context.line;
+    stats.octet = context.octet;
+  }
+
+  clock_gettime( CLOCK_MONOTONIC, & stop );
+  seconds = ( stop.tv_sec - start.tv_sec ) + ( stop.tv_nsec - start.tv_nsec ) / 1e9;
+
+  fflush( stdout );
+
+  if( TEXTFILE_E_READ == err ) {
+    fprintf( stderr, "%%DSD-E-READ; %s: %s\n", path, strerror( errno ) );
+  } else if( TEXTLEX_E_MEMORY == err ) {
+    fprintf( stderr, "%%DSD-E-MEMORY; %s: Out of memory.\n", path );
+  } else if( DSD_E_NESTING == err ) {
+    fprintf( stderr, "%%DSD-E-NESTING; %s: Unmatched bracket at line %u, octet %u.\n", path, stats.line, stats.octet );
+  } else if( TEXTLEX_E_NOERR != err ) {
+    fprintf( stderr, "%%DSD-E-SYNTAX; %s: Error %u at line %u, octet %u.\n", path, err, context.line, context.octet );
+  }
+
+  if( DSD_C_STATS == command ) {
+    for( i = TEXTLEX_T_COMMENT; i < TEXTLEX_C_TOKENS; i++ ) {
+      printf( "; %-11s %12llu\n", token_name( i ), stats.counts[ i ] );
+    }
+    printf( "; %-11s %12llu\n", "LEXEMES", stats.octets );
+    printf( "; %-11s %12u\n", "DEPTH", stats.deepest );
+  }
+
+  report( ( DSD_C_TOKENS == command ) ? stderr : stdout, path, length, context.line, seconds );
+  fflush( stdout );
+
+  free( context.buffer );
+  if( STDIN_FILENO != fd ) {
+    close( fd );
+  }
+
+  return( ( TEXTLEX_E_NOERR == err ) ? 0 : 1 );
+}
+
+static void report( FILE * out, char * path, unsigned long long length, tTextLexCount lines, double seconds ) {
+  fprintf( out, "; %s: %llu octets %u lines %.3f seconds %.1f MB/s\n", path, length, lines, seconds,
+           ( seconds > 0 ) ? ( (double) length / seconds / 1e6 ) : 0.0 );
+}
+
+static tTextLexErr token_handler( tTextLexContext * context, tTextLexCount token ) {
+  printf( "%u:%u %s %.*s\n", context->line, context->octet, token_name( token ), (int) context->index, context->buffer );
+  return( TEXTLEX_E_NOERR );
+}
+
+/* span_handler()
+**
+** Counts tokens and keeps track of which brackets are open, so validate
+** can catch a ']' closing a '{'. Lexemes that were split across updates
+** come in more than one piece, so each piece is counted.
+*/
+
+static tTextLexErr span_handler( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  stats.counts[ token ]++;
+  stats.octets += length;
+
+  switch( token ) {
+  case TEXTLEX_T_ARRAY_OPEN:
+  case TEXTLEX_T_MAP_OPEN:
+    if( DSD_MAX_DEPTH == stats.depth ) {
+      break;
+    }
+    stats.stack[ stats.depth++ ] = (unsigned char) token;
+    if( stats.depth > stats.deepest ) {
+      stats.deepest = stats.depth;
+    }
+    return( TEXTLEX_E_NOERR );
+
+  case TEXTLEX_T_ARRAY_CLOSE:
+  case TEXTLEX_T_MAP_CLOSE:
+    if( ( 0 == stats.depth ) || ( token != (tTextLexCount) stats.stack[ stats.depth - 1 ] + 1 ) ) {
+      break;
+    }
+    stats.depth--;
+    return( TEXTLEX_E_NOERR );
+
+  default:
+    return( TEXTLEX_E_NOERR );
+  }
+
+  stats.line = context->line;
+  stats.octet = context->octet;
+
+  return( DSD_E_NESTING );
+}
+
+static tTextLexErr overflow_handler( tTextLexContext * context ) {
+  tTextLexCount new_size = context->size * 2;
+  tTextLexBuffer * new_buffer;
+
+  if( ( new_size < context->size ) || ( NULL == ( new_buffer = realloc( context->buffer, new_size ) ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  context->buffer = new_buffer;
+  context->size = new_size;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static const char * token_name( unsigned int token ) {
+  static const char * tokens [] = {
+    "END",
+    "COMMENT",
+    "ANNOTATION",
+    "LITERAL",
+    "INTEGER",
+    "FLOAT",
+    "HEX",
+    "STRING",
+    "BASE64",
+    "ARRAY_OPEN",
+    "ARRAY_CLOSE",
+    "MAP_OPEN",
+    "MAP_CLOSE",
+    "EQUALS",
+    "--UNDEFINED--"
+  };
+
+  return( ( token < TEXTLEX_C_TOKENS ) ? tokens[ token ] : tokens[ TEXTLEX_C_TOKENS ] );
+}
@@ -0,0 +1,128 @@
+/* example_bind.c
+**
+** This file was written by textgen from example_bind.dsd.
+** Change the schema and run textgen again rather than editing it.
+*/
+
+/* File Includes */
+
+#include <stddef.h>
+#include <string.h>
+#include "example_bind.h"
+
+/* Function Prototypes */
+
+static int _lookup_tBindOwner( const unsigned char * key, size_t length );
+static int _lookup_tBindPeer( const unsigned char * key, size_t length );
+static int _lookup_tBindStruct( const unsigned char * key, size_t length );
+
+/* Global Variables */
+
+static const tTextBindField _fields_tBindOwner[ 2 ] = {
+  { TEXTBIND_K_STRING, offsetof( tBindOwner, name ), 32, 0, 0, 0, NULL },
+  { TEXTBIND_K_UNSIGNED, offsetof( tBindOwner, uid ), 0, 0, 0, 0, NULL },
+};
+
+static const tTextBindMap _map_tBindOwner = { sizeof( tBindOwner ), _lookup_tBindOwner, _fields_tBindOwner };
+
+static const tTextBindField _fields_tBindPeer[ 3 ] = {
+  { TEXTBIND_K_STRING, offsetof( tBindPeer, host ), 63, 0, 0, 0, NULL },
+  { TEXTBIND_K_UNSIGNED, offsetof( tBindPeer, port ), 0, 0, 0, 0, NULL },
+  { TEXTBIND_K_OCTETS, offsetof( tBindPeer, key ), 32, offsetof( tBindPeer, key_length ), 0, 0, NULL },
+};
+
+static const tTextBindMap _map_tBindPeer = { sizeof( tBindPeer ), _lookup_tBindPeer, _fields_tBindPeer };
+
+static const tTextBindField _fields_tBindStruct[ 12 ] = {
+  { TEXTBIND_K_OCTETS, offsetof( tBindStruct, secret ), 20, offsetof( tBindStruct, secret_length ), 0, 0, NULL },
+  { TEXTBIND_K_OCTETS, offsetof( tBindStruct, salt ), 8, offsetof( tBindStruct, salt_length ), 0, 0, NULL },
+  { TEXTBIND_K_UNSIGNED, offsetof( tBindStruct, iterations ), 0, 0, 0, 0, NULL },
+  { TEXTBIND_K_STRING, offsetof( tBindStruct, name ), 32, 0, 0, 0, NULL },
+  { TEXTBIND_K_INT, offsetof( tBindStruct, offset ), 0, 0, 0, 0, NULL },
+  { TEXTBIND_K_LONG, offsetof( tBindStruct, serial ), 0, 0, 0, 0, NULL },
+  { TEXTBIND_K_DOUBLE, offsetof( tBindStruct, ratio ), 0, 0, 0, 0, NULL },
+  { TEXTBIND_K_BOOLEAN, offsetof( tBindStruct, enabled ), 0, 0, 0, 0, NULL },
+  { TEXTBIND_K_INT, offsetof( tBindStruct, rounds ), 0, offsetof( tBindStruct, rounds_count ), 8, sizeof( int ), NULL },
+  { TEXTBIND_K_STRING, offsetof( tBindStruct, tags ), 15, offsetof( tBindStruct, tags_count ), 4, 16, NULL },
+  { TEXTBIND_K_MAP, offsetof( tBindStruct, owner ), 0, 0, 0, 0, & _map_tBindOwner },
+  { TEXTBIND_K_MAP, offsetof( tBindStruct, peers ), 0, offsetof( tBindStruct, peers_count ), 4, sizeof( tBindPeer ), & _map_tBindPeer },
+};
+
+const tTextBindMap example_bind_map = { sizeof( tBindStruct ), _lookup_tBindStruct, _fields_tBindStruct };
+
+/* Function Definitions */
+
+tTextLexErr example_bind_parse( tBindStruct * output, const unsigned char * data, size_t length ) {
+  return( textbind_parse( & example_bind_map, output, data, length ) );
+}
+
+static int _lookup_tBindOwner( const unsigned char * key, size_t length ) {
+  switch( length ) {
+  case 3:
+    return( ( 0 == memcmp( key, "uid", 3 ) ) ? 1 : -1 );
+  case 4:
+    return( ( 0 == memcmp( key, "name", 4 ) ) ? 0 : -1 );
+  }
+
+  return( -1 );
+}
+
+static int _lookup_tBindPeer( const unsigned char * key, size_t length ) {
+  switch( length ) {
+  case 3:
+    return( ( 0 == memcmp( key, "key", 3 ) ) ? 2 : -1 );
+  case 4:
+    switch( key[ 0 ] ) {
+    case 'h':
+      return( ( 0 == memcmp( key, "host", 4 ) ) ? 0 : -1 );
+    case 'p':
+      return( ( 0 == memcmp( key, "port", 4 ) ) ? 1 : -1 );
+    }
+    break;
+  }
+
+  return( -1 );
+}
+
+static int _lookup_tBindStruct( const unsigned char * key, size_t length ) {
+  switch( length ) {
+  case 4:
+    switch( key[ 0 ] ) {
+    case 'n':
+      return( ( 0 == memcmp( key, "name", 4 ) ) ? 3 : -1 );
+    case 's':
+      return( ( 0 == memcmp( key, "salt", 4 ) ) ? 1 : -1 );
+    case 't':
+      return( ( 0 == memcmp( key, "tags", 4 ) ) ? 9 : -1 );
+    }
+    break;
+  case 5:
+    switch( key[ 0 ] ) {
+    case 'o':
+      return( ( 0 == memcmp( key, "owner", 5 ) ) ? 10 : -1 );
+    case 'p':
+      return( ( 0 == memcmp( key, "peers", 5 ) ) ? 11 : -1 );
+    case 'r':
+      return( ( 0 == memcmp( key, "ratio", 5 ) ) ? 6 : -1 );
+    }
+    break;
+  case 6:
+    switch( key[ 0 ] ) {
+    case 'o':
+      return( ( 0 == memcmp( key, "offset", 6 ) ) ? 4 : -1 );
+    case 'r':
+      return( ( 0 == memcmp( key, "rounds", 6 ) ) ? 8 : -1 );
+    case 's':
+      return( ( 0 == memcmp( key, "secret", 6 ) ) ? 0 : -1 );
+    }
+    break;
+  case 7:
+    return( ( 0 == memcmp( key, "enabled", 7 ) ) ? 7 : -1 );
+  case 10:
+    return( ( 0 == memcmp( key, "iterations", 10 ) ) ? 2 : -1 );
+  case 13:
+    return( ( 0 == memcmp( key, "serial number", 13 ) ) ? 5 : -1 );
+  }
+
+  return( -1 );
+}
@@ -0,0 +1,59 @@
+/* example_bind.h
+**
+** This file was written by textgen from example_bind.dsd.
+** Change the schema and run textgen again rather than editing it.
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_EXAMPLE_BIND
+#define _H_EXAMPLE_BIND
+
+/* File Includes */
+
+#include <stddef.h>
+#include "textbind.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  char name[ 33 ];
+  unsigned int uid;
+} tBindOwner;
+
+typedef struct {
+  char host[ 64 ];
+  unsigned int port;
+  unsigned char key[ 32 ];
+  size_t key_length;
+} tBindPeer;
+
+typedef struct {
+  unsigned char secret[ 20 ];
+  size_t secret_length;
+  unsigned char salt[ 8 ];
+  size_t salt_length;
+  unsigned int iterations;
+  char name[ 33 ];
+  int offset;
+  long long serial;
+  double ratio;
+  int enabled;
+  int rounds[ 8 ];
+  size_t rounds_count;
+  char tags[ 4 ][ 16 ];
+  size_t tags_count;
+  tBindOwner owner;
+  tBindPeer peers[ 4 ];
+  size_t peers_count;
+} tBindStruct;
+
+/* Global Variables */
+
+extern const tTextBindMap example_bind_map;
+
+/* Function Prototypes */
+
+tTextLexErr example_bind_parse( tBindStruct * output, const unsigned char * data, size_t length );
+
+#endif /* _H_EXAMPLE_BIND */
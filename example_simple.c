@@ -131,6 +131,12 @@ static tTextLexErr overflow_handler( tTextLexContext * context ) {
   if( NULL == new_buffer ) {
     error = TEXTLEX_E_ERROR;
   } else {
+    /* realloc() may have moved the buffer and freed the old one, so keep
+    ** lexxer_buffer pointing at the new one. The next overflow reallocs it
+    ** and main() frees it; either would free the old one a second time.
+    */
+
+    lexxer_buffer = new_buffer;
     context->buffer = new_buffer;
     context->size = new_size;
   }
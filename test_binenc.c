@@ -0,0 +1,402 @@
+/* test_binenc.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests the DSD Binary Encoder and the Text-to-Binary
+** transcoder. It first writes a few items with the encoder API and checks
+** the octets it gets. Then it transcodes each text fixture, prints the
+** DSD/Binary it gets and checks it against the fixture's; the last one is
+** the example in README.md. The broken fixtures have to produce their
+** error. Last, it transcodes example.dsd and checks binlex can read it.
+** The output buffer is tiny and the text is fed in small pieces, so
+** flushing, arrays and maps that outgrow the buffer and lexemes that
+** straddle calls to textbin_update() get a workout.
+*/
+
+/* Macro Definitions */
+
+#define _OUTPUT_SIZE     16
+#define _STEP             7
+#define _BUFFER_SIZE   4096
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "binenc.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  unsigned char * data;
+  size_t          length;
+  size_t          size;
+} tResult;
+
+typedef struct {
+  char          * text;
+  unsigned char * binary;
+  size_t          length;
+  tTextLexErr     err;
+} tFixture;
+
+/* Function Prototypes */
+
+static int test_api( void );
+static int test_limits( void );
+static int test_transcode( tFixture * fixture );
+static int test_example( void );
+static tTextLexErr transcode( unsigned char * text, size_t length, tResult * binary );
+static void append( tResult * result, const void * data, size_t length );
+static tTextLexErr _flush( tBinEncContext * context );
+static tTextLexErr _overflow( tBinEncContext * context );
+static tTextLexErr _token( tTextLexContext * context, tTextLexCount token );
+static unsigned char * load_file( char * path, size_t * length );
+
+/* Global Variables */
+
+#define FIXTURE( t, b ) { t, (unsigned char *) b, sizeof( b ) - 1, TEXTLEX_E_NOERR }
+#define BROKEN( t, e ) { t, NULL, 0, e }
+
+static tFixture fixtures [] = {
+  FIXTURE( "", "" ),
+  FIXTURE( "#Comment 01\n", "" ),
+  FIXTURE( "@t #Comment 04\n", "\x02" ),
+  FIXTURE( "*false #COMMENT XX", "\x34\x66\x61\x6C\x73\x65" ),
+  FIXTURE( "@m 90125", "\x08\x12\x01\x60\x0D" ),
+  FIXTURE( "3.14 #Hey! I'm a floating point value!", "\x27\x40\x09\x1E\xB8\x51\xEB\x85\x1F" ),
+  FIXTURE( "$CAFEB0EF #Comment 06", "\x14\x00\xCA\xFE\xB0\xEF" ),
+  FIXTURE( "$cafeb0ef $CaFeB0eF $ABC $0000000000000000001", "\x14\x00\xCA\xFE\xB0\xEF\x14\x00\xCA\xFE\xB0\xEF\x11\x0A\xBC\x10\x01" ),
+  FIXTURE( "\"This is a \\\"string\\\"\" #Comment 07", "\x48\x09\x54\x68\x69\x73\x20\x69\x73\x20\x61\x20\x22\x73\x74\x72\x69\x6E\x67\x22" ),
+  FIXTURE( "'OTyqgu7Aca5sDCBzEoR23A=='", "\x48\x07\x39\x3C\xAA\x82\xEE\xC0\x71\xAE\x6C\x0C\x20\x73\x12\x84\x76\xDC" ),
+  FIXTURE( "( 39 30 31 32 35 )", "\x44\x39\x30\x31\x32\x35" ),
+  FIXTURE( "(\n 41 42 43 44 # ABCD\n 45 46 47 48 # EFGH\n)", "\x47\x41\x42\x43\x44\x45\x46\x47\x48" ),
+  FIXTURE( "( 41 42 ) ( 43 ) # C\n ( 44 ) 'RQ=='", "\x41\x41\x42\x40\x43\x40\x44\x40\x45" ),
+  FIXTURE( "[ 1 -1 2.5 -2.5 3.14 -3.14 ]", "\x78\x17\x10\x01\x10\xFF\x23\x40\x20\x00\x00\x23\xC0\x20\x00\x00\x27\x40\x09\x1E\xB8\x51\xEB\x85\x1F\x27\xC0\x09\x1E\xB8\x51\xEB\x85\x1F" ),
+  FIXTURE( "[ 12.34e5 -6.78e90 1.0e20 0.000123456789 ]", "\x78\x17\x23\x49\x96\xA2\x80\x27\xD2\xCA\xA0\x7E\x05\xD8\x2A\x2B\x27\x44\x15\xAF\x1D\x78\xB5\x8C\x40\x27\x3F\x20\x2E\x85\xBE\x11\x18\x41" ),
+  FIXTURE( "[ 0 -0 007 127 128 -128 -129 32767 32768 2147483648 ]", "\x78\x14\x10\x00\x10\x00\x10\x07\x10\x7F\x11\x00\x80\x10\x80\x11\xFF\x7F\x11\x7F\xFF\x12\x00\x80\x00\x14\x00\x80\x00\x00\x00" ),
+  FIXTURE( "[ 9223372036854775807 9223372036854775808 -9223372036854775808 18446744073709551615 ]", "\x78\x1F\x17\x7F\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x18\x00\x00\x80\x00\x00\x00\x00\x00\x00\x00\x17\x80\x00\x00\x00\x00\x00\x00\x00\x18\x00\x00\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF" ),
+  FIXTURE( "@s { \"one\"=1 \"two\" = 2 \"3\" = \"three\" }", "\x04\x68\x0B\x42\x6F\x6E\x65\x10\x01\x42\x74\x77\x6F\x10\x02\x40\x33\x44\x74\x68\x72\x65\x65" ),
+  FIXTURE( "*undefined@t$ABBA 12$CD#0123456789012345678901", "\x38\x00\x75\x6E\x64\x65\x66\x69\x6E\x65\x64\x02\x12\x00\xAB\xBA\x10\x0C\x11\x00\xCD" ),
+  FIXTURE( "{ \"k\" = [ { } [ [ ] ] ] }", "\x65\x40\x6B\x72\x6F\x70\x7F" ),
+  FIXTURE( "\"a string that's long enough to need a one octet length after its tag\"", "\x48\x3B\x61\x20\x73\x74\x72\x69\x6E\x67\x20\x74\x68\x61\x74\x27\x73\x20\x6C\x6F\x6E\x67\x20\x65\x6E\x6F\x75\x67\x68\x20\x74\x6F\x20\x6E\x65\x65\x64\x20\x61\x20\x6F\x6E\x65\x20\x6F\x63\x74\x65\x74\x20\x6C\x65\x6E\x67\x74\x68\x20\x61\x66\x74\x65\x72\x20\x69\x74\x73\x20\x74\x61\x67" ),
+  FIXTURE( "# Login Authentication w/ No Iteration Count or Salt\n@t\n{\n  \"username\" = \"OhMeadhbh\"\n  \"secret\" = (\n"
+           "    b6:07:54:c4:ea:1a:fa:24:20:1e\n    af:02:4c:13:0d:94:cc:58:01:65\n  )\n  \"algorithm\" = \"sha1\"\n  \"version\" = 2\n}\n",
+           "\x02\x68\x42\x47" "username" "\x48\x00" "OhMeadhbh" "\x45" "secret" "\x48\x0B\xB6\x07\x54\xC4\xEA\x1A\xFA\x24\x20\x1E\xAF\x02\x4C\x13\x0D\x94\xCC\x58\x01\x65\x48\x00" "algorithm" "\x43" "sha1" "\x46" "version" "\x10\x02" ),
+  BROKEN( "18446744073709551616", BINLEX_E_NUMBER ),
+  BROKEN( "-9223372036854775809", BINLEX_E_NUMBER ),
+  BROKEN( "$11112222333344445", BINLEX_E_NUMBER ),
+  BROKEN( "[ }", TEXTLEX_E_ERROR ),
+  BROKEN( "{ \"k\" = [ 1 2 3 ]", BINLEX_E_TRUNCATED ),
+  BROKEN( "[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[[ ]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]]", BINLEX_E_DEPTH ),
+  { NULL, NULL, 0, 0 }
+};
+
+static tResult * current = NULL;
+static unsigned long tokens = 0;
+
+int main( int argc, char * argv [] ) {
+  unsigned int i;
+  int failed = 0;
+
+  printf( "; BEGIN TESTS\n" );
+
+  failed |= test_api();
+  failed |= test_limits();
+
+  for( i = 0; NULL != fixtures[ i ].text; i++ ) {
+    failed |= test_transcode( & fixtures[ i ] );
+  }
+
+  failed |= test_example();
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+static int test_api( void ) {
+  static const unsigned char expected [] = {
+    0x68, 0x26, 0x10, 0x00, 0x10, 0x80, 0x11, 0x01, 0x00, 0x13, 0x80, 0x00, 0x00, 0x00,
+    0x14, 0x01, 0x00, 0x00, 0x00, 0x00, 0x18, 0x00, 0x00, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0x27, 0x40, 0x09, 0x1E, 0xB8, 0x51, 0xEB, 0x85, 0x1F,
+    0x43, 'k', 'e', 'y', '!', 0x41, 0xCA, 0xFE, 0x4F
+  };
+  tBinEncContext context;
+  tResult binary;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  int failed;
+
+  memset( & binary, 0, sizeof( binary ) );
+  current = & binary;
+
+  binenc_init( & context, malloc( _OUTPUT_SIZE ), _OUTPUT_SIZE );
+  context.flush = _flush;
+  context.overflow = _overflow;
+
+  err |= binenc_token( & context, TEXTLEX_T_MAP_OPEN );
+  err |= binenc_integer( & context, 0 );
+  err |= binenc_integer( & context, -128 );
+  err |= binenc_integer( & context, 256 );
+  err |= binenc_integer( & context, -2147483647LL - 1 );
+  err |= binenc_integer( & context, 4294967296LL );
+  err |= binenc_unsigned( & context, 18446744073709551615ULL );
+  err |= binenc_float( & context, 3.14 );
+  err |= binenc_token( & context, TEXTLEX_T_EQUALS );
+  err |= binenc_text( & context, TEXTLEX_T_STRING, (unsigned char *) "key!", 4 );
+  err |= binenc_octets( & context, (unsigned char *) "\xCA\xFE", 2 );
+  err |= binenc_octets( & context, NULL, 0 );
+  err |= binenc_token( & context, TEXTLEX_T_MAP_CLOSE );
+  err |= binenc_final( & context );
+
+  failed = ( TEXTLEX_E_NOERR != err ) || ( sizeof( expected ) != binary.length ) ||
+           ( 0 != memcmp( expected, binary.data, binary.length ) ) || ( context.written != binary.length ) ||
+           ( BINLEX_E_FLOAT != binenc_float( & context, 1.0 / 0.0 ) ) ||
+           ( TEXTLEX_E_ERROR != binenc_token( & context, TEXTLEX_T_STRING ) ) ||
+           ( TEXTLEX_E_ERROR != binenc_token( & context, TEXTLEX_T_MAP_CLOSE ) ) ||
+           ( TEXTLEX_E_ERROR != binenc_text( & context, TEXTLEX_T_BASE64, (unsigned char *) "AA==", 4 ) );
+
+  printf( "; TEST API %s\n", failed ? "MISMATCH" : "OK" );
+
+  free( context.buffer );
+  free( binary.data );
+
+  return( failed );
+}
+
+/* test_limits()
+**
+** Without an overflow callback, an array that doesn't fit in the buffer is
+** a TEXTLEX_E_MEMORY error, but everything before it still gets flushed.
+*/
+
+static int test_limits( void ) {
+  unsigned char buffer[ _OUTPUT_SIZE ];
+  tBinEncContext context;
+  tResult binary;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  unsigned int i;
+  int failed;
+
+  memset( & binary, 0, sizeof( binary ) );
+  current = & binary;
+
+  binenc_init( & context, buffer, _OUTPUT_SIZE );
+  context.flush = _flush;
+
+  for( i = 0; ( i < 10 ) && ( TEXTLEX_E_NOERR == err ); i++ ) {
+    err = binenc_integer( & context, i );
+  }
+  for( i = 0; ( i < 10 ) && ( TEXTLEX_E_NOERR == err ); i++ ) {
+    err = ( 0 == i ) ? binenc_token( & context, TEXTLEX_T_ARRAY_OPEN ) : binenc_integer( & context, i );
+  }
+
+  failed = ( TEXTLEX_E_MEMORY != err ) || ( binary.length < 16 ) || ( 0x10 != binary.data[ 0 ] ) || ( 0x09 != binary.data[ 19 ] );
+
+  printf( "; TEST LIMITS %s\n", failed ? "MISMATCH" : "OK" );
+
+  free( binary.data );
+
+  return( failed );
+}
+
+static int test_transcode( tFixture * fixture ) {
+  tResult binary;
+  tTextLexErr err, expected;
+  size_t i;
+  int failed;
+
+  memset( & binary, 0, sizeof( binary ) );
+
+  printf( "; TEST (%03zu) %s\n", strlen( fixture->text ), fixture->text );
+
+  err = transcode( (unsigned char *) fixture->text, strlen( fixture->text ), & binary );
+  expected = fixture->err;
+
+  if( TEXTLEX_E_NOERR != err ) {
+    printf( ";  ERROR %d\n", err );
+    failed = ( err != expected );
+  } else {
+    printf( ";  BINARY (%03zu)", binary.length );
+    for( i = 0; i < binary.length; i++ ) {
+      printf( " %02x", binary.data[ i ] );
+    }
+    printf( "\n" );
+    failed = ( TEXTLEX_E_NOERR != expected ) || ( fixture->length != binary.length ) ||
+             ( ( 0 != binary.length ) && ( 0 != memcmp( fixture->binary, binary.data, binary.length ) ) );
+  }
+
+  if( failed ) {
+    printf( ";  MISMATCH\n" );
+  }
+
+  free( binary.data );
+
+  return( failed );
+}
+
+/* test_example()
+**
+** Transcodes example.dsd and lexes the result with binlex, which has to
+** find the same number of tokens however the result is divided up.
+*/
+
+static int test_example( void ) {
+  tTextLexBuffer buffer[ _BUFFER_SIZE ];
+  tBinLexContext context;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  unsigned char * example;
+  unsigned long whole = 0;
+  tResult binary;
+  size_t length, i;
+  int failed = 0;
+
+  memset( & binary, 0, sizeof( binary ) );
+
+  if( NULL == ( example = load_file( "example.dsd", & length ) ) ) {
+    printf( ";  ERROR can't read example.dsd\n" );
+    return( 1 );
+  }
+
+  printf( "; TEST (%zu) example.dsd\n", length );
+
+  if( TEXTLEX_E_NOERR != ( err = transcode( example, length, & binary ) ) ) {
+    printf( ";  ERROR %d\n", err );
+    free( example );
+    return( 1 );
+  }
+
+  printf( ";  BINARY (%zu)\n", binary.length );
+
+  for( i = 0; ( i < 2 ) && ! failed; i++ ) {
+    tokens = 0;
+    binlex_init( & context, buffer, _BUFFER_SIZE );
+    context.text.token = _token;
+    if( 0 == i ) {
+      err = binlex_update( & context, binary.data, binary.length );
+    } else {
+      for( length = 0; ( length < binary.length ) && ( TEXTLEX_E_NOERR == err ); length++ ) {
+        err = binlex_update( & context, binary.data + length, 1 );
+      }
+    }
+    if( TEXTLEX_E_NOERR == err ) {
+      err = binlex_final( & context );
+    }
+    if( 0 == i ) {
+      whole = tokens;
+    }
+    failed = ( TEXTLEX_E_NOERR != err ) || ( 0 == tokens ) || ( whole != tokens );
+  }
+
+  if( failed ) {
+    printf( ";  MISMATCH\n" );
+  }
+
+  free( example );
+  free( binary.data );
+
+  return( failed );
+}
+
+static tTextLexErr transcode( unsigned char * text, size_t length, tResult * binary ) {
+  tBinEncContext encoder;
+  tTextBinContext transcoder;
+  tTextLexErr err;
+  size_t offset, chunk;
+
+  current = binary;
+
+  binenc_init( & encoder, malloc( _OUTPUT_SIZE ), _OUTPUT_SIZE );
+  encoder.flush = _flush;
+  encoder.overflow = _overflow;
+
+  if( TEXTLEX_E_NOERR != ( err = textbin_init( & transcoder, & encoder ) ) ) {
+    free( encoder.buffer );
+    return( err );
+  }
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += chunk ) {
+    chunk = ( length - offset < _STEP ) ? length - offset : _STEP;
+    err = textbin_update( & transcoder, text + offset, chunk );
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textbin_final( & transcoder );
+  } else {
+    textbin_final( & transcoder );
+  }
+
+  free( encoder.buffer );
+
+  return( err );
+}
+
+static void append( tResult * result, const void * data, size_t length ) {
+  if( result->length + length > result->size ) {
+    result->size = ( result->length + length ) * 2;
+    if( NULL == ( result->data = realloc( result->data, result->size ) ) ) {
+      fprintf( stderr, "%%TEST-F-MEMORY; Can't grow result.\n" );
+      exit( 2 );
+    }
+  }
+
+  memcpy( result->data + result->length, data, length );
+  result->length += length;
+}
+
+static tTextLexErr _flush( tBinEncContext * context ) {
+  append( current, context->buffer, context->index );
+  context->index = 0;
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr _overflow( tBinEncContext * context ) {
+  unsigned char * buffer;
+
+  if( NULL == ( buffer = realloc( context->buffer, context->size * 2 ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  context->buffer = buffer;
+  context->size *= 2;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr _token( tTextLexContext * context, tTextLexCount token ) {
+  tokens++;
+  return( TEXTLEX_E_NOERR );
+}
+static unsigned char * load_file( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * data = NULL;
+  long size;
+
+  if( NULL == ( file = fopen( path, "rb" ) ) ) {
+    return( NULL );
+  }
+
+  do {
+    if( ( 0 != fseek( file, 0, SEEK_END ) ) || ( ( size = ftell( file ) ) <= 0 ) || ( 0 != fseek( file, 0, SEEK_SET ) ) ) {
+      break;
+    }
+
+    if( NULL == ( data = malloc( size ) ) ) {
+      break;
+    }
+
+    if( (size_t) size != fread( data, 1, size, file ) ) {
+      free( data );
+      data = NULL;
+      break;
+    }
+
+    * length = size;
+  } while( 0 );
+
+  fclose( file );
+
+  return( data );
+}
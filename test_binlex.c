@@ -0,0 +1,230 @@
+/* test_binlex.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program runs the DSD Binary Lexxer over a set of fixtures and prints
+** the tokens it finds, in the same format test_textlex uses. Each fixture is
+** lexed three times: all at once, one octet at a time and (if the fixture
+** has an equivalent bit of DSD/Text) with the text lexxer. All three have to
+** produce the same tokens. The broken fixtures have to produce an error.
+*/
+
+/* File Includes */
+
+#include <stdio.h>
+#include <string.h>
+#include "binlex.h"
+
+/* Macro Definitions */
+
+#ifndef _BUFFER_SIZE
+#define _BUFFER_SIZE 20
+#endif
+
+#define _TRANSCRIPT_SIZE 8192
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  char          * text;
+  unsigned char * binary;
+  size_t          length;
+  int             valid;
+} tFixture;
+
+/* Function Prototypes */
+
+static tTextLexErr lex_binary( tFixture * fixture, size_t step );
+static tTextLexErr lex_text( tFixture * fixture );
+static tTextLexErr _token( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr print_token( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static unsigned char * token_name( unsigned int token );
+
+/* Global Variables */
+
+#define FIXTURE( t, b ) { t, (unsigned char *) b, sizeof( b ) - 1, 1 }
+#define BINARY( b ) { NULL, (unsigned char *) b, sizeof( b ) - 1, 1 }
+#define BROKEN( b ) { NULL, (unsigned char *) b, sizeof( b ) - 1, 0 }
+
+/* The BINARY fixture is the example in README.md. Its secret is a string
+** of octets, which DSD/Text can only write in base16, so textlex gives a
+** HEX token for it where binlex gives a STRING.
+*/
+
+static tFixture fixtures [] = {
+  FIXTURE( "", "" ),
+  FIXTURE( "[ ] { }", "\x7F\x6F" ),
+  FIXTURE( "@t @s @m", "\x02\x04\x08" ),
+  FIXTURE( "@x", "\x50" "x" ),
+  FIXTURE( "*nil", "\x32" "nil" ),
+  FIXTURE( "\"\"", "\x4F" ),
+  FIXTURE( "\"username\"", "\x47" "username" ),
+  FIXTURE( "\"OhMeadhbh\"", "\x48\x00" "OhMeadhbh" ),
+  FIXTURE( "\"ABCDEFGHIJKLMNOPQRSTUVWXYZ\"", "\x48\x11" "ABCDEFGHIJKLMNOPQRSTUVWXYZ" ),
+  FIXTURE( "\"ABCDEFGHIJKLMNOPQRSTUVWXYZ\"", "\x49\x00\x1A" "ABCDEFGHIJKLMNOPQRSTUVWXYZ" ),
+  FIXTURE( "[ 0 2 -1 127 -128 ]", "\x78\x01\x10\x00\x10\x02\x10\xFF\x10\x7F\x10\x80" ),
+  FIXTURE( "[ 90125 -32768 -2147483648 ]", "\x78\x03\x12\x01\x60\x0D\x11\x80\x00\x13\x80\x00\x00\x00" ),
+  FIXTURE( "[ -9223372036854775808 18446744073709551615 ]", "\x78\x0B\x17\x80\x00\x00\x00\x00\x00\x00\x00\x18\x00\x00\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF" ),
+  FIXTURE( "[ 3.14 -2.5 0.0001 1.0e20 1.5e-7 ]", "\x78\x20\x27\x40\x09\x1E\xB8\x51\xEB\x85\x1F\x23\xC0\x20\x00\x00\x27\x3F\x1A\x36\xE2\xEB\x1C\x43\x2D\x27\x44\x15\xAF\x1D\x78\xB5\x8C\x40\x27\x3E\x84\x21\xF5\xF4\x0D\x83\x76" ),
+  FIXTURE( "{ \"a\" = 1 \"b\" = [ ] }", "\x66\x40" "a" "\x10\x01\x40" "b" "\x7F" ),
+  FIXTURE( "{ \"k\" = { \"x\" = [ 1 [ ] ] } }", "\x68\x00\x40" "k" "\x65\x40" "x" "\x72\x10\x01\x7F" ),
+  FIXTURE( "{ @m \"k\" = @t 7 }", "\x65\x08\x40" "k" "\x02\x10\x07" ),
+  FIXTURE( "@t { \"username\" = \"OhMeadhbh\" \"algorithm\" = \"sha1\" \"version\" = 2 }", "\x02\x68\x25\x47" "username" "\x48\x00" "OhMeadhbh" "\x48\x00" "algorithm" "\x43" "sha1" "\x46" "version" "\x10\x02" ),
+  BINARY( "\x02\x68\x42\x47" "username" "\x48\x00" "OhMeadhbh" "\x45" "secret" "\x48\x0B\xB6\x07\x54\xC4\xEA\x1A\xFA\x24\x20\x1E\xAF\x02\x4C\x13\x0D\x94\xCC\x58\x01\x65\x48\x00" "algorithm" "\x43" "sha1" "\x46" "version" "\x10\x02" ),
+  BROKEN( "\x00" ),
+  BROKEN( "\x03" ),
+  BROKEN( "\x15\x00" ),
+  BROKEN( "\x4C" ),
+  BROKEN( "\x1F" ),
+  BROKEN( "\x21\x00\x00" ),
+  BROKEN( "\x18\x00\x01\x00\x00\x00\x00\x00\x00\x00\x00" ),
+  BROKEN( "\x27\x7F\xF0\x00\x00\x00\x00\x00\x00" ),
+  BROKEN( "\x47" "user" ),
+  BROKEN( "\x71\x48\x00" ),
+  BROKEN( "\x72\x10" ),
+  BROKEN( "\x80" ),
+  BROKEN( "\x78\x02\x6B\xFF\xFF\xFF\xFF\xFF\xFF\xFF\xFF\x10\x05" ),
+  BROKEN( "\x78\x2E\x78\x2C\x78\x2A\x78\x28\x78\x26\x78\x24\x78\x22\x78\x20\x78\x1E\x78\x1C\x78\x1A\x78\x18\x78\x16\x78\x14\x78\x12\x78\x10\x78\x0E\x78\x0C\x78\x0A\x78\x08\x78\x06\x78\x04\x78\x02\x78\x00\x77\x76\x75\x74\x73\x72\x71\x70\x7F" ),
+
+  { NULL, NULL, 0, 0 }
+};
+
+static char transcript[ _TRANSCRIPT_SIZE ];
+static size_t used = 0;
+
+int main( int argc, char * argv [] ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  char expected[ _TRANSCRIPT_SIZE ];
+  unsigned int i;
+  int failed = 0;
+
+  printf( "; BEGIN TESTS\n" );
+
+  printf( "; SIZE OF CONTEXT: %zu\n", sizeof( tBinLexContext ) );
+
+  for( i = 0; NULL != fixtures[ i ].binary; i++ ) {
+    printf( "; TEST %3d (%03zu) %s\n", i, fixtures[ i ].length, fixtures[ i ].valid ? "" : "(error)" );
+
+    err = lex_binary( & fixtures[ i ], fixtures[ i ].length );
+    fputs( transcript, stdout );
+    strcpy( expected, transcript );
+
+    if( err != lex_binary( & fixtures[ i ], 1 ) || ( 0 != strcmp( expected, transcript ) ) ) {
+      printf( ";  MISMATCH ONE OCTET AT A TIME\n" );
+      failed = 1;
+    }
+
+    if( ! fixtures[ i ].valid ) {
+      failed |= ( TEXTLEX_E_NOERR == err );
+      continue;
+    }
+
+    if( NULL == fixtures[ i ].text ) {
+      failed |= ( TEXTLEX_E_NOERR != err );
+      continue;
+    }
+
+    if( ( TEXTLEX_E_NOERR != err ) || ( TEXTLEX_E_NOERR != lex_text( & fixtures[ i ] ) ) || ( 0 != strcmp( expected, transcript ) ) ) {
+      printf( ";  MISMATCH WITH TEXT\n" );
+      fputs( transcript, stdout );
+      failed = 1;
+    }
+  }
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+static tTextLexErr lex_binary( tFixture * fixture, size_t step ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexBuffer buffer[ _BUFFER_SIZE ];
+  tBinLexContext context;
+  size_t offset, chunk;
+
+  used = 0;
+  transcript[ 0 ] = '\0';
+
+  binlex_init( & context, buffer, _BUFFER_SIZE );
+
+  context.text.token = _token;
+
+  for( offset = 0; ( offset < fixture->length ) && ( TEXTLEX_E_NOERR == err ); offset += chunk ) {
+    chunk = ( fixture->length - offset < step ) ? fixture->length - offset : step;
+    err = binlex_update( & context, fixture->binary + offset, chunk );
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = binlex_final( & context );
+  }
+
+  if( TEXTLEX_E_NOERR != err ) {
+    used += snprintf( & transcript[ used ], _TRANSCRIPT_SIZE - used, ";  ERROR %d OCTET %d\n", err, context.text.octet );
+  }
+
+  return( err );
+}
+
+static tTextLexErr lex_text( tFixture * fixture ) {
+  tTextLexErr err;
+  tTextLexBuffer buffer[ _BUFFER_SIZE ];
+  tTextLexContext context;
+
+  used = 0;
+  transcript[ 0 ] = '\0';
+
+  textlex_init( & context, buffer, _BUFFER_SIZE );
+
+  context.token = _token;
+
+  if( TEXTLEX_E_NOERR == ( err = textlex_update( & context, (tTextLexBuffer *) fixture->text, strlen( fixture->text ) ) ) ) {
+    err = textlex_final( & context );
+  }
+
+  return( err );
+}
+
+static tTextLexErr _token( tTextLexContext * context, tTextLexCount token ) {
+  return( print_token( context, token, context->buffer, context->index ) );
+}
+
+/* print_token()
+**
+** Strings in DSD/Binary can hold any octets, so the ones that aren't
+** printable are shown as dots.
+*/
+
+static tTextLexErr print_token( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  tTextLexCount i;
+
+  used += snprintf( & transcript[ used ], _TRANSCRIPT_SIZE - used, ";  TOKEN %2d %15.15s (%2d) %1s ", token, token_name( token ),
+                    length, ( ( length == context->size ) ? "O" : " " ) );
+  for( i = 0; ( i < length ) && ( used < _TRANSCRIPT_SIZE - 2 ); i++ ) {
+    transcript[ used++ ] = ( ( data[ i ] < ' ' ) || ( data[ i ] > '~' ) ) ? '.' : data[ i ];
+  }
+  used += snprintf( & transcript[ used ], _TRANSCRIPT_SIZE - used, "\n" );
+  return( TEXTLEX_E_NOERR );
+}
+
+static unsigned char * token_name( unsigned int token ) {
+  static unsigned char * tokens [] = {
+    "END",
+    "COMMENT",
+    "ANNOTATION",
+    "LITERAL",
+    "INTEGER",
+    "FLOAT",
+    "HEX",
+    "STRING",
+    "BASE64",
+    "ARRAY_OPEN",
+    "ARRAY_CLOSE",
+    "MAP_OPEN",
+    "MAP_CLOSE",
+    "EQUALS",
+    "--UNDEFINED--"
+  };
+
+  return( ( token < TEXTLEX_C_TOKENS ) ? tokens[ token ] : tokens[ TEXTLEX_C_TOKENS ] );
+}
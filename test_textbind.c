@@ -0,0 +1,328 @@
+/* test_textbind.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests the DSD Struct Binder with the code textgen writes for
+** example_bind.dsd. It binds each fixture twice (once whole and once a few
+** octets at a time, reusing one binder) and prints the struct, checks the
+** fixtures example_struct.c parses come out the same way they do there,
+** checks the fixtures that should fail do and checks the key lookup
+** function turns away keys that are nearly right.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 200809L
+
+#define _STEP 7
+#define _LONG 600
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "example_bind.h"
+
+/* Function Prototypes */
+
+static int test_fixture( char * fixture, size_t length, tTextLexErr expected );
+static tTextLexErr bind_pieces( tBindStruct * output, unsigned char * text, size_t length );
+static void dump( FILE * output, const tBindStruct * s );
+static void octets( FILE * output, const unsigned char * data, size_t length );
+static int test_struct( void );
+static int test_long( void );
+static int test_lookup( void );
+
+/* Global Variables */
+
+static char * fixtures [] = {
+  "{ }",
+  "@m{\"iterations\"=12 \"salt\"=\"01234567\" \"secret\"=(8a 4d 21 92 03 82 3c f8 6a 05 c5 ea 0c 40 be f4 c8 02 76 33)}",
+  "@m {\n"
+  "  \"iterations\" = $3E8\n"
+  "  \"secret\" = 'ik0hkgOCPPhqBcXqDEC+9MgCdjM='\n"
+  "  \"salt\" = ( 37 36 3 # a comment in the middle of an octet\n 5 34 33 32 31 30 )\n"
+  "  \"name\" = \"A \\\"quoted\\\" name\"\n"
+  "  \"offset\" = -2147483648\n"
+  "  \"serial number\" = 9223372036854775807\n"
+  "  \"ratio\" = 0.125\n"
+  "  \"enabled\" = *TrUe\n"
+  "  \"rounds\" = [ 1 -2 3 *nil 5 ]\n"
+  "  \"tags\" = [ \"alpha\" \"beta\" ]\n"
+  "  \"owner\" = { \"uid\" = 1000 \"name\" = \"meadhbh\" \"extra\" = [ { } ] }\n"
+  "  \"peers\" = [ { \"host\" = \"example.com\" \"port\" = 443 \"key\" = 'SGVsbG8sIGJpbmFyeSE=' } { \"port\" = 80 \"key\" = $00112233 } ]\n"
+  "  \"unknown\" = { \"nested\" = [ 1 2 { \"x\" = ( 00 # } ]\n ) } ] }\n"
+  "  \"ratio\" = @why 2.5e-3\n"
+  "  \"name\" = *nil\n"
+  "}",
+  "{ \"serial number\" = -9223372036854775808 \"offset\" = $7FFFFFFF \"iterations\" = 4294967295 \"enabled\" = *false \"ratio\" = 42 }",
+  NULL
+};
+
+static struct {
+  char        * fixture;
+  tTextLexErr   err;
+} failures [] = {
+  { "{ \"iterations\" = \"12\" }", TEXTBIND_E_TYPE },
+  { "{ \"iterations\" = -1 }", TEXTBIND_E_RANGE },
+  { "{ \"iterations\" = 4294967296 }", TEXTBIND_E_RANGE },
+  { "{ \"offset\" = 2147483648 }", TEXTBIND_E_RANGE },
+  { "{ \"serial number\" = $8000000000000000 }", TEXTBIND_E_RANGE },
+  { "{ \"secret\" = ( 00 01 02 03 04 05 06 07 08 09 0a 0b 0c 0d 0e 0f 10 11 12 13 14 ) }", TEXTBIND_E_RANGE },
+  { "{ \"salt\" = $123 }", TEXTBIND_E_TYPE },
+  { "{ \"name\" = \"This is more than thirty two characters long\" }", TEXTBIND_E_RANGE },
+  { "{ \"rounds\" = [ 1 2 3 4 5 6 7 8 9 ] }", TEXTBIND_E_RANGE },
+  { "{ \"rounds\" = 1 }", TEXTBIND_E_TYPE },
+  { "{ \"rounds\" = [ [ 1 ] ] }", TEXTBIND_E_TYPE },
+  { "{ \"owner\" = [ ] }", TEXTBIND_E_TYPE },
+  { "{ \"enabled\" = *maybe }", TEXTBIND_E_TYPE },
+  { "{ \"name\" }", TEXTBIND_E_STRUCTURE },
+  { "{ \"name\" = \"x\"", TEXTBIND_E_UNCLOSED },
+  { "[ ]", TEXTBIND_E_STRUCTURE },
+  { "", TEXTBIND_E_STRUCTURE },
+  { "{ } { }", TEXTBIND_E_STRUCTURE },
+  { "{ \"unknown\" = [ } }", TEXTBIND_E_STRUCTURE },
+  { "{ \"peers\" = [ { \"port\" = 1 ] }", TEXTBIND_E_STRUCTURE },
+  { "{ \"ratio\" = 1.0 ? }", TEXTLEX_E_START },
+  { NULL, TEXTLEX_E_NOERR }
+};
+
+static tTextBindContext binder;
+
+int main( int argc, char * argv [] ) {
+  unsigned int i;
+  tBindStruct first;
+  int failed = 0;
+
+  printf( "; BEGIN TESTS\n" );
+
+  textbind_init( & binder, & example_bind_map, & first );
+
+  for( i = 0; NULL != fixtures[ i ]; i++ ) {
+    failed |= test_fixture( fixtures[ i ], strlen( fixtures[ i ] ), TEXTLEX_E_NOERR );
+  }
+
+  for( i = 0; NULL != failures[ i ].fixture; i++ ) {
+    failed |= test_fixture( failures[ i ].fixture, strlen( failures[ i ].fixture ), failures[ i ].err );
+  }
+
+  failed |= test_struct();
+  failed |= test_long();
+  failed |= test_lookup();
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+/* test_fixture()
+**
+** Binds a fixture whole and in pieces. The two structs have to print the
+** same way and both have to return the expected error.
+*/
+
+static int test_fixture( char * fixture, size_t length, tTextLexErr expected ) {
+  tBindStruct whole_struct, pieces_struct;
+  char * whole = NULL;
+  char * pieces = NULL;
+  size_t whole_length = 0, pieces_length = 0;
+  tTextLexErr err, err_pieces;
+  FILE * output;
+  int failed = 0;
+
+  printf( "; TEST (%03zu) %.*s\n", length, ( length > 120 ) ? 120 : (int) length, fixture );
+
+  err = example_bind_parse( & whole_struct, (unsigned char *) fixture, length );
+  output = open_memstream( & whole, & whole_length );
+  if( TEXTLEX_E_NOERR == err ) {
+    dump( output, & whole_struct );
+  }
+  fclose( output );
+
+  err_pieces = bind_pieces( & pieces_struct, (unsigned char *) fixture, length );
+  output = open_memstream( & pieces, & pieces_length );
+  if( TEXTLEX_E_NOERR == err_pieces ) {
+    dump( output, & pieces_struct );
+  }
+  fclose( output );
+
+  if( TEXTLEX_E_NOERR == err ) {
+    printf( "%s", whole );
+  } else {
+    printf( ";  ERROR %d\n", err );
+  }
+
+  if( ( expected != err ) || ( err != err_pieces ) || ( whole_length != pieces_length ) || ( 0 != memcmp( whole, pieces, whole_length ) ) ) {
+    printf( ";  MISMATCH\n" );
+    failed = 1;
+  }
+
+  free( whole );
+  free( pieces );
+
+  return( failed );
+}
+
+static tTextLexErr bind_pieces( tBindStruct * output, unsigned char * text, size_t length ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t offset, chunk;
+
+  textbind_reset( & binder, output );
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += chunk ) {
+    chunk = ( length - offset < _STEP ) ? length - offset : _STEP;
+    err = textbind_update( & binder, text + offset, chunk );
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textbind_final( & binder );
+  }
+
+  return( err );
+}
+
+static void dump( FILE * output, const tBindStruct * s ) {
+  size_t i;
+
+  fprintf( output, ";  secret " );
+  octets( output, s->secret, s->secret_length );
+  fprintf( output, ";  salt " );
+  octets( output, s->salt, s->salt_length );
+  fprintf( output, ";  iterations %u name \"%s\" offset %d serial %lld ratio %g enabled %d\n",
+           s->iterations, s->name, s->offset, s->serial, s->ratio, s->enabled );
+
+  fprintf( output, ";  rounds (%zu)", s->rounds_count );
+  for( i = 0; i < s->rounds_count; i++ ) {
+    fprintf( output, " %d", s->rounds[ i ] );
+  }
+  fprintf( output, "\n;  tags (%zu)", s->tags_count );
+  for( i = 0; i < s->tags_count; i++ ) {
+    fprintf( output, " \"%s\"", s->tags[ i ] );
+  }
+  fprintf( output, "\n;  owner name \"%s\" uid %u\n", s->owner.name, s->owner.uid );
+
+  fprintf( output, ";  peers (%zu)\n", s->peers_count );
+  for( i = 0; i < s->peers_count; i++ ) {
+    fprintf( output, ";   %zu host \"%s\" port %u key ", i, s->peers[ i ].host, s->peers[ i ].port );
+    octets( output, s->peers[ i ].key, s->peers[ i ].key_length );
+  }
+}
+
+static void octets( FILE * output, const unsigned char * data, size_t length ) {
+  size_t i;
+
+  fprintf( output, "(%zu)", length );
+  if( 0 != length ) {
+    fputc( ' ', output );
+  }
+  for( i = 0; i < length; i++ ) {
+    fprintf( output, "%02X", data[ i ] );
+  }
+  fputc( '\n', output );
+}
+
+/* test_struct()
+**
+** Binds the fixtures from example_struct.c and checks the members it fills
+** in match the struct it expects.
+*/
+
+static int test_struct( void ) {
+  static char * inputs [] = {
+    "@m{\"iterations\"=12 \"salt\"=\"01234567\" \"secret\"=(8a 4d 21 92 03 82 3c f8 6a 05 c5 ea 0c 40 be f4 c8 02 76 33)}",
+    "@m\n{\n  \"iterations\"=12\n  \"salt\"=\"01234567\"\n  \"secret\"=(8a 4d 21 92 03 82 3c f8 6a 05 c5 ea 0c 40 be f4 c8 02 76 33)\n}",
+    "@m\n{\n  \"iterations\"=12\n  \"salt\"=(37 36 35 34 33 32 31 30)\n  \"secret\"=(8a 4d 21 92 03 82 3c f8 6a 05 c5 ea 0c 40 be f4 c8 02 76 33)\n}",
+    NULL
+  };
+  static const char * salts [] = { "01234567", "01234567", "76543210" };
+  static const unsigned char secret[ 20 ] = {
+    0x8a, 0x4d, 0x21, 0x92, 0x03, 0x82, 0x3c, 0xf8, 0x6a, 0x05, 0xc5, 0xea, 0x0c, 0x40, 0xbe, 0xf4, 0xc8, 0x02, 0x76, 0x33
+  };
+  tBindStruct s;
+  unsigned int i;
+  int failed = 0;
+
+  for( i = 0; NULL != inputs[ i ]; i++ ) {
+    printf( "; TEST example_struct fixture %u\n", i );
+    if( ( TEXTLEX_E_NOERR != example_bind_parse( & s, (unsigned char *) inputs[ i ], strlen( inputs[ i ] ) ) ) ||
+        ( 12 != s.iterations ) || ( 8 != s.salt_length ) || ( 0 != memcmp( salts[ i ], s.salt, 8 ) ) ||
+        ( 20 != s.secret_length ) || ( 0 != memcmp( secret, s.secret, 20 ) ) ) {
+      printf( ";  MISMATCH\n" );
+      failed = 1;
+    }
+  }
+
+  return( failed );
+}
+
+/* test_long()
+**
+** Builds a document with lexemes too long for the lexxer's buffer, so they
+** arrive in pieces: an integer with a lot of leading zeros, a key that's
+** too long to be in the struct and a long string that gets skipped.
+*/
+
+static int test_long( void ) {
+  char * text;
+  char * p;
+  int failed;
+
+  if( NULL == ( text = malloc( 3 * _LONG + 100 ) ) ) {
+    return( 1 );
+  }
+
+  p = text;
+  p += sprintf( p, "{ \"iterations\" = " );
+  memset( p, '0', _LONG );
+  p += _LONG;
+  p += sprintf( p, "12 \"" );
+  memset( p, 'k', _LONG );
+  p += _LONG;
+  p += sprintf( p, "\" = 1 \"unknown\" = \"" );
+  memset( p, 's', _LONG );
+  p += _LONG;
+  p += sprintf( p, "\" \"offset\" = -3 }" );
+
+  failed = test_fixture( text, p - text, TEXTLEX_E_NOERR );
+
+  free( text );
+
+  return( failed );
+}
+
+/* test_lookup()
+**
+** Every key finds its own member and keys that are nearly right find
+** nothing.
+*/
+
+static int test_lookup( void ) {
+  static char * keys [] = {
+    "secret", "salt", "iterations", "name", "offset", "serial number", "ratio", "enabled", "rounds", "tags", "owner", "peers", NULL
+  };
+  static char * misses [] = {
+    "", "nam", "names", "Name", "salts", "serial", "serial numbers", "peer", "rounds\n", "iterationz", NULL
+  };
+  unsigned int i;
+  int failed = 0;
+
+  printf( "; TEST key lookup\n" );
+
+  for( i = 0; NULL != keys[ i ]; i++ ) {
+    if( (int) i != example_bind_map.lookup( (unsigned char *) keys[ i ], strlen( keys[ i ] ) ) ) {
+      printf( ";  MISSED %s\n", keys[ i ] );
+      failed = 1;
+    }
+  }
+
+  for( i = 0; NULL != misses[ i ]; i++ ) {
+    if( -1 != example_bind_map.lookup( (unsigned char *) misses[ i ], strlen( misses[ i ] ) ) ) {
+      printf( ";  FOUND %s\n", misses[ i ] );
+      failed = 1;
+    }
+  }
+
+  return( failed );
+}
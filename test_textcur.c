@@ -0,0 +1,418 @@
+/* test_textcur.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests the DSD Cursor. It walks each fixture (and
+** example.dsd) with the cursor, printing every value the way
+** test_textdom.c prints a tree, and checks the result against the tree the
+** document builder builds. Then it checks the fixtures that should fail do,
+** looks some values up in example.dsd, decodes its binary strings and
+** checks that the cursor doesn't look inside values it's not asked about.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 200809L
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "textcur.h"
+#include "textdom.h"
+
+/* Function Prototypes */
+
+static int test_fixture( char * fixture, size_t length, int quiet );
+static tTextLexErr walk( tTextCurCursor * cursor, unsigned int depth, FILE * output );
+static void print( const tTextCurValue * value, unsigned int depth, FILE * output );
+static void dump( const tTextDomNode * node, unsigned int depth, FILE * output );
+static int test_failure( char * fixture, tTextLexErr expected );
+static int test_example( unsigned char * example, size_t length );
+static int test_lazy( void );
+static unsigned char * load_file( char * path, size_t * length );
+
+/* Global Variables */
+
+static const char * names[ TEXTLEX_C_TOKENS ] = {
+  "END", "COMMENT", "ANNOTATION", "LITERAL", "INTEGER", "FLOAT", "HEX", "STRING", "BASE64",
+  "ARRAY", "ARRAY_CLOSE", "MAP", "MAP_CLOSE", "EQUALS"
+};
+
+static char * fixtures [] = {
+  "",
+  "#Comment 01\n",
+  "@t #Comment 04\n",
+  "*false #COMMENT XX",
+  "@m 90125",
+  "3.14 $CAFEB0EF \"This is a \\\"string\\\"\" 'OTyqgu7Aca5sDCBzEoR23A=='",
+  "(\n 41 42 43 44 # ABCD\n 45 46 47 48 # EFGH\n)",
+  "[ 1 -1 2.3 -2.3 4.56 -4.56 78.9 -78.9 6.02E23 -1.602e-19 ]",
+  "[[] {} [[1 2] [3 4]] { \"a\" = [] }]",
+  "@s { \"one\"=1 \"two\" = 2 \"3\" = \"three\" }",
+  "@t{\"a\"=1}",
+  "{ \"k\" = # why\n @x 1 \"j\" = [ @dangling ] \"l\" = @m { } }",
+  "{ \"]\" = \"}\" \"(\" = ( 5d # ] }\n 7d ) '[' = ' { ' }",
+  NULL
+};
+
+static struct {
+  char        * fixture;
+  tTextLexErr   err;
+} failures [] = {
+  { "{ \"a\" }", TEXTCUR_E_STRUCTURE },
+  { "{ = 1 }", TEXTCUR_E_STRUCTURE },
+  { "{ \"a\" \"b\" }", TEXTCUR_E_STRUCTURE },
+  { "{ \"a\" = }", TEXTCUR_E_STRUCTURE },
+  { "]", TEXTCUR_E_STRUCTURE },
+  { "[ 1 = 2 ]", TEXTCUR_E_STRUCTURE },
+  { "[ 1 [ 2 ]", TEXTCUR_E_UNCLOSED },
+  { "{ \"a\" = 1", TEXTCUR_E_UNCLOSED },
+  { "\"abc", TEXTCUR_E_UNCLOSED },
+  { "\"abc\\\"", TEXTCUR_E_UNCLOSED },
+  { "( 41 # )", TEXTCUR_E_UNCLOSED },
+  { "'QUJD", TEXTCUR_E_UNCLOSED },
+  { "[ 1 ? ]", TEXTLEX_E_START },
+  { NULL, TEXTLEX_E_NOERR }
+};
+
+static tTextDomArena arena;
+static tTextDomContext context;
+
+int main( int argc, char * argv [] ) {
+  unsigned char * example;
+  size_t length;
+  unsigned int i;
+  int failed = 0;
+
+  printf( "; BEGIN TESTS\n" );
+
+  textdom_arena_init( & arena );
+  if( TEXTLEX_E_NOERR != textdom_init( & context, & arena ) ) {
+    printf( ";  ERROR can't initialize the builder\n" );
+    return( 2 );
+  }
+
+  for( i = 0; NULL != fixtures[ i ]; i++ ) {
+    failed |= test_fixture( fixtures[ i ], strlen( fixtures[ i ] ), 0 );
+  }
+
+  for( i = 0; NULL != failures[ i ].fixture; i++ ) {
+    failed |= test_failure( failures[ i ].fixture, failures[ i ].err );
+  }
+
+  if( NULL == ( example = load_file( "example.dsd", & length ) ) ) {
+    printf( ";  ERROR can't read example.dsd\n" );
+    failed = 1;
+  } else {
+    failed |= test_example( example, length );
+    free( example );
+  }
+
+  failed |= test_lazy();
+
+  textdom_free( & context );
+  textdom_arena_free( & arena );
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+/* test_fixture()
+**
+** Walks a fixture with the cursor and builds it with the document builder.
+** Both have to print the same way. Big fixtures are quiet about it.
+*/
+
+static int test_fixture( char * fixture, size_t length, int quiet ) {
+  const tTextDomNode * root = NULL;
+  tTextCurCursor cursor;
+  char * walked = NULL;
+  char * built = NULL;
+  size_t walked_length = 0, built_length = 0;
+  tTextLexErr err;
+  FILE * output;
+  int failed = 0;
+
+  if( ! quiet ) {
+    printf( "; TEST (%03zu) %s\n", length, fixture );
+  }
+
+  textcur_init( & cursor, (unsigned char *) fixture, length );
+  output = open_memstream( & walked, & walked_length );
+  fprintf( output, "; " );
+  err = walk( & cursor, 1, output );
+  fclose( output );
+
+  textdom_arena_reset( & arena );
+  textdom_reset( & context );
+  output = open_memstream( & built, & built_length );
+  if( ( TEXTLEX_E_NOERR == textdom_update( & context, (unsigned char *) fixture, length ) ) &&
+      ( TEXTLEX_E_NOERR == textdom_final( & context, & root ) ) ) {
+    dump( root, 1, output );
+  }
+  fclose( output );
+
+  if( TEXTLEX_E_NOERR == err ) {
+    printf( "%s", quiet ? "" : walked );
+  } else {
+    printf( ";  ERROR %d\n", err );
+  }
+
+  if( ( TEXTLEX_E_NOERR != err ) || ( walked_length != built_length ) || ( 0 != memcmp( walked, built, walked_length ) ) ) {
+    printf( ";  MISMATCH\n" );
+    failed = 1;
+  }
+
+  free( walked );
+  free( built );
+
+  return( failed );
+}
+
+/* walk()
+**
+** Prints the container a cursor points at, then everything in it. It goes
+** through the container once to count what's in it, then rewinds.
+*/
+
+static tTextLexErr walk( tTextCurCursor * cursor, unsigned int depth, FILE * output ) {
+  tTextCurCursor inner;
+  tTextCurValue key, value;
+  size_t count = 0;
+  tTextLexErr err;
+
+  do {
+    if( TEXTLEX_E_NOERR != ( err = textcur_next( cursor, NULL, & value ) ) ) {
+      return( err );
+    }
+  } while( ( TEXTLEX_T_END != value.type ) && ++count );
+
+  fprintf( output, "%s (%zu)\n", ( TEXTLEX_T_MAP_OPEN == cursor->type ) ? "MAP" : "ARRAY", count );
+  textcur_rewind( cursor );
+
+  while( 1 ) {
+    if( TEXTLEX_E_NOERR != ( err = textcur_next( cursor, & key, & value ) ) ) {
+      return( err );
+    }
+
+    if( TEXTLEX_T_END == value.type ) {
+      return( TEXTLEX_E_NOERR );
+    }
+
+    if( TEXTLEX_T_MAP_OPEN == cursor->type ) {
+      print( & key, depth + 1, output );
+    }
+
+    print( & value, depth + 1, output );
+
+    if( ( TEXTLEX_T_ARRAY_OPEN == value.type ) || ( TEXTLEX_T_MAP_OPEN == value.type ) ) {
+      textcur_enter( & inner, & value );
+      if( TEXTLEX_E_NOERR != ( err = walk( & inner, depth + 1, output ) ) ) {
+        return( err );
+      }
+    }
+  }
+}
+
+static void print( const tTextCurValue * value, unsigned int depth, FILE * output ) {
+  unsigned char * text;
+  size_t length;
+
+  fprintf( output, ";%*s", (int) depth, "" );
+  if( NULL != value->annotation ) {
+    fprintf( output, "@%.*s ", (int) value->annotation_length, value->annotation );
+  }
+
+  if( ( TEXTLEX_T_ARRAY_OPEN == value->type ) || ( TEXTLEX_T_MAP_OPEN == value->type ) ) {
+    return;
+  }
+
+  /* Ask for the length first, then get the text. */
+
+  length = textcur_text( value, NULL, 0 );
+  text = malloc( length + 1 );
+  textcur_text( value, text, length );
+  text[ length ] = '\0';
+  fprintf( output, "%s (%03zu) %s\n", names[ value->type ], length, text );
+  free( text );
+}
+
+static void dump( const tTextDomNode * node, unsigned int depth, FILE * output ) {
+  size_t i;
+
+  fprintf( output, ";%*s", (int) depth, "" );
+  if( NULL != node->annotation ) {
+    fprintf( output, "@%s ", node->annotation );
+  }
+
+  if( TEXTDOM_T_ARRAY == node->type ) {
+    fprintf( output, "ARRAY (%zu)\n", node->count );
+    for( i = 0; i < node->count; i++ ) {
+      dump( & node->value.items[ i ], depth + 1, output );
+    }
+  } else if( TEXTDOM_T_MAP == node->type ) {
+    fprintf( output, "MAP (%zu)\n", node->count );
+    for( i = 0; i < node->count * 2; i++ ) {
+      dump( & node->value.items[ i ], depth + 1, output );
+    }
+  } else {
+    fprintf( output, "%s (%03zu) %s\n", names[ node->type ], node->count, node->value.text );
+  }
+}
+
+/* test_failure()
+**
+** Walks a fixture that should fail, all the way to the end.
+*/
+
+static int test_failure( char * fixture, tTextLexErr expected ) {
+  tTextCurCursor cursor;
+  tTextLexErr err;
+  FILE * output;
+
+  printf( "; TEST (%03zu) %s\n", strlen( fixture ), fixture );
+
+  textcur_init( & cursor, (unsigned char *) fixture, strlen( fixture ) );
+  output = fopen( "/dev/null", "w" );
+  err = walk( & cursor, 1, output );
+  fclose( output );
+
+  printf( ";  ERROR %d\n", err );
+
+  if( expected != err ) {
+    printf( ";  MISMATCH\n" );
+    return( 1 );
+  }
+
+  return( 0 );
+}
+
+/* test_example()
+**
+** Walks example.dsd like the other fixtures, then looks some values up in
+** it (one of them twice, to check find() wraps round) and decodes the
+** binary strings that all spell the same octets, one way or another.
+*/
+
+static int test_example( unsigned char * example, size_t length ) {
+  static const char * binary[] = {
+    "some binary data", "same binary data", "binary data, part two", "binary data, part deux", NULL
+  };
+  tTextCurCursor root, map, inner;
+  tTextCurValue value;
+  unsigned char first[ 128 ], octets[ 128 ];
+  size_t first_length = 0, octets_length;
+  long long integer = 0;
+  double real = 0;
+  int boolean = 0, failed = 0;
+  unsigned int i;
+
+  printf( "; TEST (%zu) example.dsd\n", length );
+  failed |= test_fixture( (char *) example, length, 1 );
+
+  textcur_init( & root, example, length );
+  failed |= ( TEXTLEX_E_NOERR != textcur_next( & root, NULL, & value ) ) || ( TEXTLEX_E_NOERR != textcur_enter( & map, & value ) );
+
+  failed |= ( TEXTLEX_E_NOERR != textcur_find( & map, "magic number", & value ) ) || ! textcur_integer( & value, & integer ) || ( 0xB1 != integer );
+  printf( ";  magic number = %lld\n", integer );
+  failed |= ( TEXTLEX_E_NOERR != textcur_find( & map, "revision", & value ) ) || ! textcur_integer( & value, & integer ) || ( 55 != integer );
+  printf( ";  revision = %lld\n", integer );
+  failed |= ( TEXTLEX_E_NOERR != textcur_find( & map, "percent complete", & value ) ) || ! textcur_float( & value, & real ) || ( 87.95 != real );
+  printf( ";  percent complete = %g\n", real );
+  failed |= ( TEXTLEX_E_NOERR != textcur_find( & map, "booleans in DSD are case insensitive", & value ) ) || ! textcur_boolean( & value, & boolean ) || ( 1 != boolean );
+  printf( ";  booleans in DSD are case insensitive = %d\n", boolean );
+  failed |= ( TEXTLEX_E_NOERR != textcur_find( & map, "i am an array", & value ) ) || ( TEXTLEX_E_NOERR != textcur_enter( & inner, & value ) );
+  for( i = 0; ( i < 5 ) && ( TEXTLEX_E_NOERR == textcur_next( & inner, NULL, & value ) ); i++ );
+  failed |= ! textcur_float( & value, & real ) || ( 3.14 != real );
+  printf( ";  i am an array[ 4 ] = %g\n", real );
+  failed |= ( TEXTLEX_E_NOERR != textcur_find( & map, "yet another dictionary", & value ) ) || ( TEXTLEX_E_NOERR != textcur_enter( & inner, & value ) );
+  failed |= ( TEXTLEX_E_NOERR != textcur_find( & inner, "two", & value ) ) || ! textcur_integer( & value, & integer ) || ( 2 != integer );
+  printf( ";  yet another dictionary.two = %lld\n", integer );
+  failed |= ( TEXTLEX_E_NOERR != textcur_find( & map, "not there", & value ) ) || ( TEXTLEX_T_END != value.type );
+  failed |= ( TEXTLEX_E_NOERR != textcur_find( & map, "revision", & value ) ) || ! textcur_integer( & value, & integer ) || ( 55 != integer );
+
+  for( i = 0; NULL != binary[ i ]; i++ ) {
+    if( TEXTLEX_E_NOERR != textcur_find( & map, binary[ i ], & value ) ) {
+      failed = 1;
+      break;
+    }
+    octets_length = textcur_octets( & value, octets, sizeof( octets ) );
+    printf( ";  %s = (%zu octets)\n", binary[ i ], octets_length );
+    if( 0 == i ) {
+      memcpy( first, octets, first_length = octets_length );
+    } else {
+      failed |= ( first_length != octets_length ) || ( 0 != memcmp( first, octets, first_length ) );
+    }
+  }
+
+  if( failed ) {
+    printf( ";  MISMATCH\n" );
+  }
+
+  return( failed );
+}
+
+/* test_lazy()
+**
+** The cursor doesn't look inside values it skips, so an error in one of
+** them goes unnoticed unless you ask for it.
+*/
+
+static int test_lazy( void ) {
+  char * fixture = "{ \"skipped\" = [ 1 ? 2 ] \"wanted\" = 'QUJD' }";
+  tTextCurCursor root, map;
+  tTextCurValue value;
+  unsigned char octets[ 3 ];
+  int failed;
+
+  printf( "; TEST (%03zu) %s\n", strlen( fixture ), fixture );
+
+  textcur_init( & root, (unsigned char *) fixture, strlen( fixture ) );
+  failed = ( TEXTLEX_E_NOERR != textcur_next( & root, NULL, & value ) ) || ( TEXTLEX_E_NOERR != textcur_enter( & map, & value ) ) ||
+    ( TEXTLEX_E_NOERR != textcur_find( & map, "wanted", & value ) ) || ( 3 != textcur_octets( & value, octets, sizeof( octets ) ) ) ||
+    ( 0 != memcmp( octets, "ABC", 3 ) );
+
+  printf( ";  wanted = %.3s\n", octets );
+
+  if( failed ) {
+    printf( ";  MISMATCH\n" );
+  }
+
+  return( failed );
+}
+
+static unsigned char * load_file( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * data = NULL;
+  long size;
+
+  if( NULL == ( file = fopen( path, "rb" ) ) ) {
+    return( NULL );
+  }
+
+  do {
+    if( ( 0 != fseek( file, 0, SEEK_END ) ) || ( ( size = ftell( file ) ) <= 0 ) || ( 0 != fseek( file, 0, SEEK_SET ) ) ) {
+      break;
+    }
+
+    if( NULL == ( data = malloc( size ) ) ) {
+      break;
+    }
+
+    if( (size_t) size != fread( data, 1, size, file ) ) {
+      free( data );
+      data = NULL;
+      break;
+    }
+
+    * length = size;
+  } while( 0 );
+
+  fclose( file );
+
+  return( data );
+}
@@ -0,0 +1,369 @@
+/* test_textdec.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests the base16 and base64 decoders in textscan.c and the
+** lexxer's decoded binary mode. First it decodes random octets with each
+** decoder this CPU has (into a separate buffer and in place) and checks
+** they come back out the same. Then it lexes a document of
+** random base16 and base64 strings, with comments, white space and other
+** values mixed in, with the decoded callback set. It does that in pieces of
+** several sizes, with and without span mode and with buffers small enough
+** that long strings overflow them, and checks the octets that come out are
+** the ones that went in and (when nothing overflows) that the tokens come
+** in the same order they do without decoding. Last, it checks the errors
+** for strings that don't decode.
+**
+** Linked with textlex_dfa.o instead of textlex.o, it tests the table driven
+** lexxer's decoded binary mode.
+*/
+
+/* Macro Definitions */
+
+#define TEST_OCTETS    300
+#define TEST_STRINGS   400
+#define TEST_DOCUMENT  ( 256 * 1024 )
+#define TEST_SEQUENCE  65536
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "textlex.h"
+#include "textscan.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  unsigned char * octets;
+  size_t          length;
+  char *          sequence;
+  size_t          tokens;
+} tTestRun;
+
+/* Function Prototypes */
+
+static unsigned long long next( void );
+static size_t encode( char * out, const unsigned char * octets, size_t length, int base64 );
+static int test_scan( unsigned int isa );
+static int test_lexer( tTextLexCount size, int span, size_t chunk );
+static int test_errors( void );
+static tTextLexErr lex( tTextLexCount size, int span, int decoding, size_t chunk, const char * text, size_t length );
+static tTextLexErr decoded_callback( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr token_callback( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr span_callback( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+
+/* Global Variables */
+
+static const char * separators [] = {
+  " ", "\n", " # a comment\n", " 42 ", " \"a string\" ", " $BEEF ", " [ ", " ] ", NULL
+};
+
+static unsigned long long state = 88172645463325252ULL;
+static char document[ TEST_DOCUMENT ];
+static size_t document_length;
+static unsigned char expected[ TEST_DOCUMENT ];
+static size_t expected_length;
+static char plain[ TEST_SEQUENCE ];
+static size_t plain_tokens;
+static tTestRun run;
+
+int main( int argc, char * argv [] ) {
+  static const tTextLexCount sizes [] = { 256, 9, 4 };
+  static const size_t chunks [] = { 0, 1, 2, 3, 7 };
+  unsigned char octets[ TEST_OCTETS ];
+  unsigned int isa, i, j, k;
+  size_t length;
+  int failed = 0;
+
+  printf( "; BEGIN TESTS\n" );
+
+  for( isa = TEXTSCAN_ISA_SCALAR; isa < TEXTSCAN_C_ISAS; isa++ ) {
+    if( isa == textscan_select( isa ) ) {
+      failed |= test_scan( isa );
+    }
+  }
+  textscan_select( TEXTSCAN_ISA_AUTO );
+
+  /* Random strings of random octets, with something between each one. */
+
+  for( i = 0; i < TEST_STRINGS; i++ ) {
+    length = ( 0 == i % 50 ) ? 0 : next() % ( ( 0 == i % 7 ) ? TEST_OCTETS : 40 );
+    for( k = 0; k < length; k++ ) {
+      octets[ k ] = (unsigned char) next();
+    }
+    memcpy( expected + expected_length, octets, length );
+    expected_length += length;
+    document_length += encode( document + document_length, octets, length, i & 1 );
+    document_length += sprintf( document + document_length, "%s", separators[ next() % 8 ] );
+  }
+
+  if( TEXTLEX_E_NOERR != lex( 256, 0, 0, 0, document, document_length ) ) {
+    printf( "; TEST PLAIN FAILED\n" );
+    return( 2 );
+  }
+  memcpy( plain, run.sequence, run.tokens );
+  plain_tokens = run.tokens;
+
+  for( i = 0; i < sizeof( sizes ) / sizeof( sizes[ 0 ] ); i++ ) {
+    for( j = 0; j < 2; j++ ) {
+      for( k = 0; k < sizeof( chunks ) / sizeof( chunks[ 0 ] ); k++ ) {
+        failed |= test_lexer( sizes[ i ], j, chunks[ k ] );
+      }
+    }
+  }
+
+  failed |= test_errors();
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+static unsigned long long next( void ) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+  return( state );
+}
+
+/* encode()
+**
+** Writes octets as a base64 string (with padding and the odd line break) or
+** as a base16 string in either case, with white space and comments thrown
+** in, some of them between the two digits of an octet. Returns the length.
+*/
+
+static size_t encode( char * out, const unsigned char * octets, size_t length, int base64 ) {
+  static const char alphabet [] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  static const char * digits [] = { "0123456789abcdef", "0123456789ABCDEF" };
+  unsigned long quad;
+  size_t i, k, o = 0;
+  unsigned long long r;
+
+  if( base64 ) {
+    out[ o++ ] = '\'';
+    for( i = 0; i < length; i += 3 ) {
+      quad = (unsigned long) octets[ i ] << 16;
+      quad |= ( i + 1 < length ) ? (unsigned long) octets[ i + 1 ] << 8 : 0;
+      quad |= ( i + 2 < length ) ? (unsigned long) octets[ i + 2 ] : 0;
+      for( k = 0; k < 4; k++ ) {
+        out[ o++ ] = ( k <= length - i ) ? alphabet[ ( quad >> ( 18 - 6 * k ) ) & 63 ] : '=';
+      }
+      if( 0 == next() % 16 ) {
+        out[ o++ ] = '\n';
+      }
+    }
+    out[ o++ ] = '\'';
+    return( o );
+  }
+
+  out[ o++ ] = '(';
+  for( i = 0; i < 2 * length; i++ ) {
+    r = next();
+    out[ o++ ] = digits[ ( r >> 8 ) & 1 ][ ( octets[ i >> 1 ] >> ( ( i & 1 ) ? 0 : 4 ) ) & 15 ];
+    switch( r % 24 ) {
+    case 0:
+      o += sprintf( out + o, " # comment\n" );
+      break;
+
+    case 1:
+      o += sprintf( out + o, "#\n" );
+      break;
+
+    case 2:
+      out[ o++ ] = ' ';
+      break;
+
+    case 3:
+      out[ o++ ] = '\n';
+      break;
+    }
+  }
+  out[ o++ ] = ')';
+
+  return( o );
+}
+
+/* test_scan()
+**
+** Decodes random octets of every length up to TEST_OCTETS with the
+** selected decoders and checks they match the originals.
+*/
+
+static int test_scan( unsigned int isa ) {
+  static const char alphabet [] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+  static const char * digits [] = { "0123456789abcdef", "0123456789ABCDEF" };
+  unsigned char octets[ TEST_OCTETS ];
+  unsigned char text[ 2 * TEST_OCTETS ];
+  unsigned char out[ 2 * TEST_OCTETS ];
+  size_t length, made, i, k;
+  unsigned long long r;
+  int failed = 0;
+
+  for( length = 0; length < TEST_OCTETS; length++ ) {
+    for( i = 0; i < length; i++ ) {
+      octets[ i ] = (unsigned char) next();
+    }
+
+    for( i = 0; i < 2 * length; i++ ) {
+      r = next();
+      text[ i ] = digits[ r & 1 ][ ( octets[ i >> 1 ] >> ( ( i & 1 ) ? 0 : 4 ) ) & 15 ];
+    }
+    made = textscan_hex( text, 2 * length, out );
+    failed |= ( length != made ) || ( 0 != memcmp( octets, out, length ) );
+    made = textscan_hex( text, 2 * length, text );
+    failed |= ( length != made ) || ( 0 != memcmp( octets, text, length ) );
+
+    for( i = 0, k = 0; i + 3 <= length; i += 3 ) {
+      r = ( (unsigned long long) octets[ i ] << 16 ) | ( (unsigned long long) octets[ i + 1 ] << 8 ) | octets[ i + 2 ];
+      text[ k++ ] = alphabet[ ( r >> 18 ) & 63 ];
+      text[ k++ ] = alphabet[ ( r >> 12 ) & 63 ];
+      text[ k++ ] = alphabet[ ( r >> 6 ) & 63 ];
+      text[ k++ ] = alphabet[ r & 63 ];
+    }
+    memset( out, 0xA5, sizeof( out ) );
+    made = textscan_base64( text, k, out );
+    failed |= ( i != made ) || ( 0 != memcmp( octets, out, i ) ) || ( 0xA5 != out[ i ] );
+    made = textscan_base64( text, k, text );
+    failed |= ( i != made ) || ( 0 != memcmp( octets, text, i ) );
+  }
+
+  printf( "; TEST SCAN %-6s %s\n", textscan_name( isa ), failed ? "FAILED" : "OK" );
+
+  return( failed );
+}
+
+/* test_lexer()
+**
+** Lexes the document in pieces of chunk octets (or all at once if chunk is
+** zero) with a size octet buffer and checks what comes out.
+*/
+
+static int test_lexer( tTextLexCount size, int span, size_t chunk ) {
+  tTextLexErr err;
+  int failed;
+
+  err = lex( size, span, 1, chunk, document, document_length );
+  failed = ( TEXTLEX_E_NOERR != err ) || ( expected_length != run.length ) || ( 0 != memcmp( expected, run.octets, run.length ) );
+
+  /* Without overflows, the tokens should be the same as without decoding. */
+
+  if( ( 256 == size ) && ( ( plain_tokens != run.tokens ) || ( 0 != memcmp( plain, run.sequence, run.tokens ) ) ) ) {
+    failed = 1;
+  }
+
+  printf( "; TEST LEXER buffer %3u %-5s chunk %zu : %zu octets %s\n", (unsigned int) size, span ? "span" : "token", chunk,
+          run.length, failed ? "FAILED" : "OK" );
+  if( failed ) {
+    printf( ";  err %u, expected %zu octets\n", (unsigned int) err, expected_length );
+  }
+
+  return( failed );
+}
+
+/* test_errors()
+**
+** Strings that don't decode, and some that only just do.
+*/
+
+static int test_errors( void ) {
+  static const struct {
+    const char * text;
+    tTextLexErr  err;
+    const char * octets;
+  } cases [] = {
+    { "(abc)", TEXTLEX_E_BASE16_START, "" },
+    { "(a # c\n)", TEXTLEX_E_BASE16_START, "" },
+    { "(a # c\n # d\n b)", TEXTLEX_E_NOERR, "\xab" },
+    { "(4 # c\n 1 4 # d\n 2)", TEXTLEX_E_NOERR, "AB" },
+    { "'Q'", TEXTLEX_E_BASE64, "" },
+    { "'QUJDR=='", TEXTLEX_E_BASE64, "" },
+    { "'QQ=='", TEXTLEX_E_NOERR, "A" },
+    { "'QUI='", TEXTLEX_E_NOERR, "AB" },
+    { "'QUJD\nRA'", TEXTLEX_E_NOERR, "ABCD" },
+    { "'QQ==QUJD'", TEXTLEX_E_NOERR, "A" },
+    { "$ABC '' ()", TEXTLEX_E_NOERR, "" },
+    { NULL, 0, NULL }
+  };
+  tTextLexErr err;
+  unsigned int i;
+  size_t length;
+  int failed = 0, bad;
+
+  for( i = 0; NULL != cases[ i ].text; i++ ) {
+    err = lex( 256, 0, 1, 0, cases[ i ].text, strlen( cases[ i ].text ) );
+    length = strlen( cases[ i ].octets );
+    bad = ( err != cases[ i ].err ) || ( ( TEXTLEX_E_NOERR == err ) && ( ( length != run.length ) || ( 0 != memcmp( run.octets, cases[ i ].octets, length ) ) ) );
+    printf( "; TEST ERROR %-20.20s err %2u %s\n", cases[ i ].text, (unsigned int) err, bad ? "FAILED" : "OK" );
+    failed |= bad;
+  }
+
+  return( failed );
+}
+
+/* lex()
+**
+** Runs the lexxer over a document, collecting the decoded octets in
+** run.octets and a letter for each token in run.sequence.
+*/
+
+static tTextLexErr lex( tTextLexCount size, int span, int decoding, size_t chunk, const char * text, size_t length ) {
+  static unsigned char octets[ TEST_DOCUMENT ];
+  static char sequence[ TEST_SEQUENCE ];
+  tTextLexBuffer buffer[ 256 ];
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t offset, piece;
+
+  memset( & run, 0, sizeof( tTestRun ) );
+  run.octets = octets;
+  run.sequence = sequence;
+
+  textlex_init( & context, buffer, size );
+  textlex_extend( & context, & extension );
+  if( decoding ) {
+    extension.decoded = decoded_callback;
+  }
+  if( span ) {
+    extension.span = span_callback;
+  } else {
+    context.token = token_callback;
+  }
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += piece ) {
+    piece = ( ( 0 == chunk ) || ( chunk > length - offset ) ) ? length - offset : chunk;
+    err = textlex_update( & context, (tTextLexBuffer *) text + offset, piece );
+  }
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textlex_final( & context );
+  }
+
+  return( err );
+}
+
+static tTextLexErr decoded_callback( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  if( ( TEXTLEX_T_HEX != token ) && ( TEXTLEX_T_BASE64 != token ) ) {
+    return( TEXTLEX_E_ERROR );
+  }
+
+  memcpy( run.octets + run.length, data, length );
+  run.length += length;
+
+  return( token_callback( context, token ) );
+}
+
+static tTextLexErr token_callback( tTextLexContext * context, tTextLexCount token ) {
+  if( run.tokens < TEST_SEQUENCE ) {
+    run.sequence[ run.tokens++ ] = (char) ( 'a' + token );
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr span_callback( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  return( token_callback( context, token ) );
+}
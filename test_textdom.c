@@ -0,0 +1,371 @@
+/* test_textdom.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests the DSD Document Builder. It builds a tree for each
+** fixture (once with the whole fixture and once a few octets at a time)
+** and prints it, checks that the fixtures that should fail do and that
+** some pairs of documents build the same tree, then builds example.dsd and
+** looks a few values up in it. The arena is reset between
+** documents, so the last test checks that building the same document again
+** doesn't need any more memory.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 200809L
+
+#define _STEP 7
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "textdom.h"
+
+/* Function Prototypes */
+
+static int test_fixture( char * fixture, tTextLexErr expected );
+static int test_same( char * fixture, char * same );
+static tTextLexErr build( unsigned char * text, size_t length, size_t step, const tTextDomNode ** root );
+static void dump( const tTextDomNode * node, unsigned int depth, FILE * output );
+static int test_example( void );
+static unsigned char * load_file( char * path, size_t * length );
+
+/* Global Variables */
+
+static char * fixtures [] = {
+  "",
+  "#Comment 01\n",
+  "@t #Comment 04\n",
+  "*false #COMMENT XX",
+  "@m 90125",
+  "3.14 $CAFEB0EF \"This is a \\\"string\\\"\" 'OTyqgu7Aca5sDCBzEoR23A=='",
+  "(\n 41 42 43 44 # ABCD\n 45 46 47 48 # EFGH\n)",
+  "[ 1 -1 2.3 -2.3 4.56 -4.56 78.9 -78.9 ]",
+  "[[] {} [[1 2] [3 4]] { \"a\" = [] }]",
+  "@s { \"one\"=1 \"two\" = 2 \"3\" = \"three\" }",
+  "@t{\"a\"=1}",
+  "{ \"k\" = # why\n @x 1 \"j\" = [ @dangling ] \"l\" = @m { } }",
+  NULL
+};
+
+static struct {
+  char        * fixture;
+  tTextLexErr   err;
+} failures [] = {
+  { "{ \"a\" }", TEXTDOM_E_STRUCTURE },
+  { "{ = 1 }", TEXTDOM_E_STRUCTURE },
+  { "{ \"a\" \"b\" }", TEXTDOM_E_STRUCTURE },
+  { "{ \"a\" = }", TEXTDOM_E_STRUCTURE },
+  { "[ 1 }", TEXTDOM_E_STRUCTURE },
+  { "[ 1 = 2 ]", TEXTDOM_E_STRUCTURE },
+  { "]", TEXTDOM_E_STRUCTURE },
+  { "[ 1 [ 2 ]", TEXTDOM_E_UNCLOSED },
+  { "{ \"a\" = 1", TEXTDOM_E_UNCLOSED },
+  { "[ 1 ? ]", TEXTLEX_E_START },
+  { "{ \"k\" = 1 [ ] \"l\" = 2 }", TEXTDOM_E_STRUCTURE },
+  { "{\"k\"=1[]\"l\"=2}", TEXTDOM_E_STRUCTURE },
+  { NULL, TEXTLEX_E_NOERR }
+};
+
+/* A comment inside a base16 string splits its lexeme, but it's still one
+** string.
+*/
+
+static struct {
+  char        * fixture;
+  char        * same;
+} sames [] = {
+  { "( 41 42 # A\n 43 44 )", "( 41424344 )" },
+  { "[ ( CA # one\n FE # two\n B0 EF ) 1 ]", "[ ( CAFEB0EF ) 1 ]" },
+  { "{ \"k\" = ( 00 # ) \n 01 ) \"l\" = ( # x\n ) }", "{ \"k\" = ( 0001 ) \"l\" = ( ) }" },
+  { NULL, NULL }
+};
+
+static tTextDomArena arena;
+static tTextDomContext context;
+
+int main( int argc, char * argv [] ) {
+  unsigned int i;
+  int failed = 0;
+
+  printf( "; BEGIN TESTS\n" );
+
+  textdom_arena_init( & arena );
+  if( TEXTLEX_E_NOERR != textdom_init( & context, & arena ) ) {
+    printf( ";  ERROR can't initialize the builder\n" );
+    return( 2 );
+  }
+
+  for( i = 0; NULL != fixtures[ i ]; i++ ) {
+    failed |= test_fixture( fixtures[ i ], TEXTLEX_E_NOERR );
+  }
+
+  for( i = 0; NULL != failures[ i ].fixture; i++ ) {
+    failed |= test_fixture( failures[ i ].fixture, failures[ i ].err );
+  }
+
+  for( i = 0; NULL != sames[ i ].fixture; i++ ) {
+    failed |= test_same( sames[ i ].fixture, sames[ i ].same );
+  }
+
+  failed |= test_example();
+
+  textdom_free( & context );
+  textdom_arena_free( & arena );
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+/* test_fixture()
+**
+** Builds a fixture whole and in pieces. The two trees have to print the
+** same way and both builds have to return the expected error.
+*/
+
+static int test_fixture( char * fixture, tTextLexErr expected ) {
+  const tTextDomNode * root = NULL;
+  char * whole = NULL;
+  char * pieces = NULL;
+  size_t whole_length = 0, pieces_length = 0;
+  size_t length = strlen( fixture );
+  tTextLexErr err, err_pieces;
+  FILE * output;
+  int failed = 0;
+
+  printf( "; TEST (%03zu) %s\n", length, fixture );
+
+  err = build( (unsigned char *) fixture, length, length, & root );
+  output = open_memstream( & whole, & whole_length );
+  if( TEXTLEX_E_NOERR == err ) {
+    dump( root, 1, output );
+  }
+  fclose( output );
+
+  err_pieces = build( (unsigned char *) fixture, length, _STEP, & root );
+  output = open_memstream( & pieces, & pieces_length );
+  if( TEXTLEX_E_NOERR == err_pieces ) {
+    dump( root, 1, output );
+  }
+  fclose( output );
+
+  if( TEXTLEX_E_NOERR == err ) {
+    printf( "%s", whole );
+  } else {
+    printf( ";  ERROR %d\n", err );
+  }
+
+  if( ( expected != err ) || ( err != err_pieces ) || ( whole_length != pieces_length ) || ( 0 != memcmp( whole, pieces, whole_length ) ) ) {
+    printf( ";  MISMATCH\n" );
+    failed = 1;
+  }
+
+  free( whole );
+  free( pieces );
+
+  return( failed );
+}
+
+/* test_same()
+**
+** Builds two documents, the first whole and in pieces, and checks all three
+** trees print the same way.
+*/
+
+static int test_same( char * fixture, char * same ) {
+  const tTextDomNode * root = NULL;
+  char * texts[ 3 ] = { NULL, NULL, NULL };
+  size_t lengths[ 3 ] = { 0, 0, 0 };
+  size_t length;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  FILE * output;
+  unsigned int i;
+  int failed = 0;
+
+  printf( "; TEST SAME %s\n", same );
+
+  for( i = 0; i < 3; i++ ) {
+    length = strlen( ( 2 == i ) ? same : fixture );
+    err |= build( (unsigned char *) ( ( 2 == i ) ? same : fixture ), length, ( 1 == i ) ? _STEP : length, & root );
+    output = open_memstream( & texts[ i ], & lengths[ i ] );
+    if( TEXTLEX_E_NOERR == err ) {
+      dump( root, 1, output );
+    }
+    fclose( output );
+  }
+
+  if( ( TEXTLEX_E_NOERR != err ) || ( lengths[ 0 ] != lengths[ 2 ] ) || ( lengths[ 1 ] != lengths[ 2 ] ) ||
+      ( 0 != memcmp( texts[ 0 ], texts[ 2 ], lengths[ 2 ] ) ) || ( 0 != memcmp( texts[ 1 ], texts[ 2 ], lengths[ 2 ] ) ) ) {
+    printf( ";  MISMATCH (error %d)\n%s", err, texts[ 0 ] );
+    failed = 1;
+  }
+
+  for( i = 0; i < 3; i++ ) {
+    free( texts[ i ] );
+  }
+
+  return( failed );
+}
+
+static tTextLexErr build( unsigned char * text, size_t length, size_t step, const tTextDomNode ** root ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t offset, chunk;
+
+  textdom_arena_reset( & arena );
+  textdom_reset( & context );
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += chunk ) {
+    chunk = ( length - offset < step ) ? length - offset : step;
+    err = textdom_update( & context, text + offset, chunk );
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textdom_final( & context, root );
+  }
+
+  return( err );
+}
+
+static void dump( const tTextDomNode * node, unsigned int depth, FILE * output ) {
+  static const char * names[ TEXTLEX_C_TOKENS ] = {
+    "END", "COMMENT", "ANNOTATION", "LITERAL", "INTEGER", "FLOAT", "HEX", "STRING", "BASE64",
+    "ARRAY", "ARRAY_CLOSE", "MAP", "MAP_CLOSE", "EQUALS"
+  };
+  size_t i;
+
+  fprintf( output, ";%*s", (int) depth, "" );
+  if( NULL != node->annotation ) {
+    fprintf( output, "@%s ", node->annotation );
+  }
+
+  if( TEXTDOM_T_ARRAY == node->type ) {
+    fprintf( output, "ARRAY (%zu)\n", node->count );
+    for( i = 0; i < node->count; i++ ) {
+      dump( & node->value.items[ i ], depth + 1, output );
+    }
+  } else if( TEXTDOM_T_MAP == node->type ) {
+    fprintf( output, "MAP (%zu)\n", node->count );
+    for( i = 0; i < node->count * 2; i++ ) {
+      dump( & node->value.items[ i ], depth + 1, output );
+    }
+  } else {
+    fprintf( output, "%s (%03zu) %s\n", names[ node->type ], node->count, node->value.text );
+  }
+}
+
+/* test_example()
+**
+** Builds example.dsd and looks up some of the values in it. Then builds it
+** again and checks the arena didn't need another block.
+*/
+
+static int test_example( void ) {
+  const tTextDomNode * root = NULL;
+  const tTextDomNode * map;
+  tTextDomBlock * block;
+  unsigned char * example;
+  unsigned int blocks = 0;
+  size_t length;
+  long long integer = 0;
+  double real = 0;
+  int boolean = 0, failed = 0;
+  tTextLexErr err;
+
+  if( NULL == ( example = load_file( "example.dsd", & length ) ) ) {
+    printf( ";  ERROR can't read example.dsd\n" );
+    return( 1 );
+  }
+
+  printf( "; TEST (%zu) example.dsd\n", length );
+
+  do {
+    if( TEXTLEX_E_NOERR != ( err = build( example, length, _STEP, & root ) ) ) {
+      printf( ";  ERROR %d\n", err );
+      failed = 1;
+      break;
+    }
+
+    printf( ";  ROOT ARRAY (%zu)\n", root->count );
+    map = textdom_index( root, 0 );
+
+    failed |= ! textdom_integer( textdom_find( map, "revision" ), & integer ) || ( 55 != integer );
+    printf( ";  revision = %lld\n", integer );
+    failed |= ! textdom_integer( textdom_find( map, "magic number" ), & integer ) || ( 0xB1 != integer );
+    printf( ";  magic number = %lld\n", integer );
+    failed |= ! textdom_float( textdom_find( map, "percent complete" ), & real ) || ( 87.95 != real );
+    printf( ";  percent complete = %g\n", real );
+    failed |= ! textdom_boolean( textdom_find( map, "booleans in DSD are case insensitive" ), & boolean ) || ( 1 != boolean );
+    printf( ";  booleans in DSD are case insensitive = %d\n", boolean );
+    failed |= ! textdom_float( textdom_index( textdom_find( map, "i am an array" ), 4 ), & real ) || ( 3.14 != real );
+    printf( ";  i am an array[ 4 ] = %g\n", real );
+    failed |= ! textdom_integer( textdom_find( textdom_find( map, "yet another dictionary" ), "two" ), & integer ) || ( 2 != integer );
+    printf( ";  yet another dictionary.two = %lld\n", integer );
+    failed |= ( NULL != textdom_find( map, "not there" ) ) || ( NULL != textdom_index( root, root->count ) );
+    failed |= ! textdom_integer( textdom_index( root, 5 ), & integer ) || ( 42 != integer );
+    printf( ";  root[ 5 ] = %lld\n", integer );
+
+    for( block = arena.first; NULL != block; block = block->next ) {
+      blocks++;
+    }
+
+    if( TEXTLEX_E_NOERR != ( err = build( example, length, length, & root ) ) ) {
+      printf( ";  ERROR %d\n", err );
+      failed = 1;
+      break;
+    }
+
+    for( block = arena.first; NULL != block; block = block->next ) {
+      blocks--;
+    }
+
+    if( 0 != blocks ) {
+      printf( ";  ARENA GREW\n" );
+      failed = 1;
+    }
+  } while( 0 );
+
+  if( failed ) {
+    printf( ";  MISMATCH\n" );
+  }
+
+  free( example );
+
+  return( failed );
+}
+
+static unsigned char * load_file( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * data = NULL;
+  long size;
+
+  if( NULL == ( file = fopen( path, "rb" ) ) ) {
+    return( NULL );
+  }
+
+  do {
+    if( ( 0 != fseek( file, 0, SEEK_END ) ) || ( ( size = ftell( file ) ) <= 0 ) || ( 0 != fseek( file, 0, SEEK_SET ) ) ) {
+      break;
+    }
+
+    if( NULL == ( data = malloc( size ) ) ) {
+      break;
+    }
+
+    if( (size_t) size != fread( data, 1, size, file ) ) {
+      free( data );
+      data = NULL;
+      break;
+    }
+
+    * length = size;
+  } while( 0 );
+
+  fclose( file );
+
+  return( data );
+}
@@ -0,0 +1,333 @@
+/* test_textenc.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests the DSD Text Writer. It first writes a small document
+** with the writer API in both modes and checks the text it gets. Then it
+** runs each fixture (and example.dsd) through textlex and hands each token
+** to the writer, prints the compact and pretty text it gets and checks that
+** textlex finds the same tokens in them that it found in the original. The
+** output buffer is tiny, so flushing gets a workout.
+*/
+
+/* Macro Definitions */
+
+#define _OUTPUT_SIZE     16
+#define _BUFFER_SIZE   4096
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "textenc.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  unsigned char * data;
+  size_t          length;
+  size_t          size;
+} tResult;
+
+/* Function Prototypes */
+
+static int test_api( unsigned int mode, const char * expected );
+static int test_rewrite( char * name, unsigned char * text, size_t length, int dump );
+static tTextLexErr rewrite( unsigned char * text, size_t length, unsigned int mode, tResult * output );
+static void transcribe( unsigned char * text, size_t length, tResult * transcript );
+static void append( tResult * result, const void * data, size_t length );
+static tTextLexErr _flush( tTextEncContext * context );
+static tTextLexErr _span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr _token( tTextLexContext * context, tTextLexCount token );
+static unsigned char * load_file( char * path, size_t * length );
+
+/* Global Variables */
+
+static char * fixtures [] = {
+  "",
+  "#Comment 01\n",
+  "@t #Comment 04\n",
+  "*false #COMMENT XX",
+  "@m 90125",
+  "3.14 #Hey! I'm a floating point value!",
+  "$CAFEB0EF #Comment 06",
+  "$cafeb0ef $CaFeB0eF $ABC $",
+  "\"This is a \\\"string\\\"\" #Comment 07",
+  "\"\\\\\\\\ back \\\\ slashes \\\"\\\\\\\"\"",
+  "'OTyqgu7Aca5sDCBzEoR23A=='",
+  "( 39 30 31 32 35 )",
+  "(\n 41 42 43 44 # ABCD\n 45 46 47 48 # EFGH\n)",
+  "[ 1 -1 2.3 -2.3 4.56 -4.56 78.9 -78.9 ]",
+  "[ 12.34e5 -12.34e5 6.78e90 -6.78e90 1.0e20 0.000123456789 ]",
+  "[[] {} [[1 2] [3 4]] { \"a\" = [] }]",
+  "@s { \"one\"=1 \"two\" = 2 \"3\" = \"three\" }",
+  "@t{\"a\"=1}",
+  "{ \"k\" = # why\n 1 }",
+  "*undefined@t$ABBA 12$CD#0123456789012345678901",
+  NULL
+};
+
+static tTextEncContext * writer = NULL;
+static tResult * current = NULL;
+
+int main( int argc, char * argv [] ) {
+  unsigned char * example;
+  size_t length;
+  unsigned int i;
+  int failed = 0;
+
+  printf( "; BEGIN TESTS\n" );
+
+  failed |= test_api( TEXTENC_M_COMPACT,
+    "@t{\"key \\\"one\\\"\"=[0 -1 -9223372036854775808 18446744073709551615 3.14 1.5e-7 1.0e21 -0.0]"
+    "\"two\"=$cafe\"three\"=$00FF\"four\"=['Zm9v''Zm8=''Zg==''']#note\n}" );
+  failed |= test_api( TEXTENC_M_PRETTY,
+    "@t {\n"
+    "  \"key \\\"one\\\"\" = [\n"
+    "    0\n    -1\n    -9223372036854775808\n    18446744073709551615\n"
+    "    3.14\n    1.5e-7\n    1.0e21\n    -0.0\n"
+    "  ]\n"
+    "  \"two\" = $cafe\n"
+    "  \"three\" = $00FF\n"
+    "  \"four\" = [\n    'Zm9v'\n    'Zm8='\n    'Zg=='\n    ''\n  ]\n"
+    "  #note\n"
+    "}\n" );
+
+  for( i = 0; NULL != fixtures[ i ]; i++ ) {
+    failed |= test_rewrite( fixtures[ i ], (unsigned char *) fixtures[ i ], strlen( fixtures[ i ] ), 1 );
+  }
+
+  if( NULL != ( example = load_file( "example.dsd", & length ) ) ) {
+    failed |= test_rewrite( "example.dsd", example, length, 0 );
+    free( example );
+  } else {
+    printf( ";  ERROR can't read example.dsd\n" );
+    failed = 1;
+  }
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+static int test_api( unsigned int mode, const char * expected ) {
+  unsigned char buffer[ _OUTPUT_SIZE ];
+  tTextEncContext context;
+  tResult output;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  int failed;
+
+  memset( & output, 0, sizeof( output ) );
+  current = & output;
+
+  textenc_init( & context, buffer, _OUTPUT_SIZE, mode );
+  context.flush = _flush;
+
+  err |= textenc_text( & context, TEXTLEX_T_ANNOTATION, (unsigned char *) "t", 1 );
+  err |= textenc_token( & context, TEXTLEX_T_MAP_OPEN );
+  err |= textenc_text( & context, TEXTLEX_T_STRING, (unsigned char *) "key \"one\"", 9 );
+  err |= textenc_token( & context, TEXTLEX_T_EQUALS );
+  err |= textenc_token( & context, TEXTLEX_T_ARRAY_OPEN );
+  err |= textenc_integer( & context, 0 );
+  err |= textenc_integer( & context, -1 );
+  err |= textenc_integer( & context, -9223372036854775807LL - 1 );
+  err |= textenc_unsigned( & context, 18446744073709551615ULL );
+  err |= textenc_float( & context, 3.14 );
+  err |= textenc_float( & context, 1.5e-7 );
+  err |= textenc_float( & context, 1e21 );
+  err |= textenc_float( & context, -0.0 );
+  err |= textenc_token( & context, TEXTLEX_T_ARRAY_CLOSE );
+  err |= textenc_text( & context, TEXTLEX_T_STRING, (unsigned char *) "two", 3 );
+  err |= textenc_token( & context, TEXTLEX_T_EQUALS );
+  err |= textenc_octets( & context, (unsigned char *) "\xCA\xFE", 2, 0 );
+  err |= textenc_text( & context, TEXTLEX_T_STRING, (unsigned char *) "three", 5 );
+  err |= textenc_token( & context, TEXTLEX_T_EQUALS );
+  err |= textenc_octets( & context, (unsigned char *) "\x00\xFF", 2, 1 );
+  err |= textenc_text( & context, TEXTLEX_T_STRING, (unsigned char *) "four", 4 );
+  err |= textenc_token( & context, TEXTLEX_T_EQUALS );
+  err |= textenc_token( & context, TEXTLEX_T_ARRAY_OPEN );
+  err |= textenc_base64( & context, (unsigned char *) "foo", 3 );
+  err |= textenc_base64( & context, (unsigned char *) "fo", 2 );
+  err |= textenc_base64( & context, (unsigned char *) "f", 1 );
+  err |= textenc_base64( & context, NULL, 0 );
+  err |= textenc_token( & context, TEXTLEX_T_ARRAY_CLOSE );
+  err |= textenc_text( & context, TEXTLEX_T_COMMENT, (unsigned char *) "note", 4 );
+  err |= textenc_token( & context, TEXTLEX_T_MAP_CLOSE );
+  err |= textenc_final( & context );
+
+  failed = ( TEXTLEX_E_NOERR != err ) || ( strlen( expected ) != output.length ) ||
+           ( 0 != memcmp( expected, output.data, output.length ) ) || ( context.written != output.length ) ||
+           ( TEXTLEX_E_ERROR != textenc_float( & context, 1.0 / 0.0 ) ) ||
+           ( TEXTLEX_E_ERROR != textenc_text( & context, TEXTLEX_T_COMMENT, (unsigned char *) "a\nb", 3 ) ) ||
+           ( TEXTLEX_E_ERROR != textenc_token( & context, TEXTLEX_T_STRING ) );
+
+  printf( "; TEST API %s %s\n", ( TEXTENC_M_PRETTY == mode ) ? "PRETTY" : "COMPACT", failed ? "MISMATCH" : "OK" );
+  if( failed ) {
+    printf( "%.*s\n", (int) output.length, output.data );
+  }
+
+  free( output.data );
+
+  return( failed );
+}
+
+static int test_rewrite( char * name, unsigned char * text, size_t length, int dump ) {
+  tResult output, expected, actual;
+  tTextLexErr err;
+  unsigned int mode;
+  int failed = 0;
+
+  memset( & expected, 0, sizeof( expected ) );
+  transcribe( text, length, & expected );
+
+  printf( "; TEST (%03zu) %s\n", length, dump ? name : "example.dsd" );
+
+  for( mode = TEXTENC_M_COMPACT; mode <= TEXTENC_M_PRETTY; mode++ ) {
+    memset( & output, 0, sizeof( output ) );
+    memset( & actual, 0, sizeof( actual ) );
+
+    if( TEXTLEX_E_NOERR != ( err = rewrite( text, length, mode, & output ) ) ) {
+      printf( ";  ERROR %d\n", err );
+      failed = 1;
+    } else {
+      if( dump ) {
+        printf( ";  %s (%03zu)\n%.*s", ( TEXTENC_M_PRETTY == mode ) ? "PRETTY" : "COMPACT", output.length, (int) output.length, output.data );
+        if( ( 0 == output.length ) || ( '\n' != output.data[ output.length - 1 ] ) ) {
+          printf( "\n" );
+        }
+      } else {
+        printf( ";  %s (%zu)\n", ( TEXTENC_M_PRETTY == mode ) ? "PRETTY" : "COMPACT", output.length );
+      }
+
+      transcribe( output.data, output.length, & actual );
+
+      if( ( expected.length != actual.length ) || ( 0 != memcmp( expected.data, actual.data, expected.length ) ) ) {
+        printf( ";  MISMATCH\n" );
+        failed = 1;
+      }
+    }
+
+    free( output.data );
+    free( actual.data );
+  }
+
+  free( expected.data );
+
+  return( failed );
+}
+
+static tTextLexErr rewrite( unsigned char * text, size_t length, unsigned int mode, tResult * output ) {
+  unsigned char buffer[ _OUTPUT_SIZE ];
+  tTextLexBuffer lexxer_buffer[ _BUFFER_SIZE ];
+  tTextLexContext lexxer;
+  tTextLexExtension extension;
+  tTextEncContext context;
+  tTextLexErr err;
+
+  current = output;
+  writer = & context;
+
+  textenc_init( & context, buffer, _OUTPUT_SIZE, mode );
+  context.flush = _flush;
+
+  textlex_init( & lexxer, lexxer_buffer, _BUFFER_SIZE );
+  textlex_extend( & lexxer, & extension );
+  extension.span = _span;
+
+  if( TEXTLEX_E_NOERR == ( err = textlex_update( & lexxer, text, length ) ) ) {
+    err = textlex_final( & lexxer );
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textenc_final( & context );
+  }
+
+  return( err );
+}
+
+static void transcribe( unsigned char * text, size_t length, tResult * transcript ) {
+  tTextLexBuffer buffer[ _BUFFER_SIZE ];
+  tTextLexContext context;
+  tResult * previous = current;
+
+  current = transcript;
+  textlex_init( & context, buffer, _BUFFER_SIZE );
+  context.token = _token;
+  if( ( TEXTLEX_E_NOERR != textlex_update( & context, text, length ) ) || ( TEXTLEX_E_NOERR != textlex_final( & context ) ) ) {
+    append( transcript, "ERROR", 5 );
+  }
+  current = previous;
+}
+
+static void append( tResult * result, const void * data, size_t length ) {
+  if( result->length + length > result->size ) {
+    result->size = ( result->length + length ) * 2;
+    if( NULL == ( result->data = realloc( result->data, result->size ) ) ) {
+      fprintf( stderr, "%%TEST-F-MEMORY; Can't grow result.\n" );
+      exit( 2 );
+    }
+  }
+
+  memcpy( result->data + result->length, data, length );
+  result->length += length;
+}
+
+static tTextLexErr _flush( tTextEncContext * context ) {
+  append( current, context->buffer, context->index );
+  context->index = 0;
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr _span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  if( TEXTLEX_T_END == token ) {
+    return( TEXTLEX_E_NOERR );
+  } else if( token >= TEXTLEX_T_ARRAY_OPEN ) {
+    return( textenc_token( writer, token ) );
+  }
+
+  return( textenc_text( writer, token, data, length ) );
+}
+
+static tTextLexErr _token( tTextLexContext * context, tTextLexCount token ) {
+  unsigned char code = (unsigned char) token;
+
+  append( current, & code, 1 );
+  append( current, context->buffer, context->index );
+  append( current, "|", 1 );
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static unsigned char * load_file( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * data = NULL;
+  long size;
+
+  if( NULL == ( file = fopen( path, "rb" ) ) ) {
+    return( NULL );
+  }
+
+  do {
+    if( ( 0 != fseek( file, 0, SEEK_END ) ) || ( ( size = ftell( file ) ) <= 0 ) || ( 0 != fseek( file, 0, SEEK_SET ) ) ) {
+      break;
+    }
+
+    if( NULL == ( data = malloc( size ) ) ) {
+      break;
+    }
+
+    if( (size_t) size != fread( data, 1, size, file ) ) {
+      free( data );
+      data = NULL;
+      break;
+    }
+
+    * length = size;
+  } while( 0 );
+
+  fclose( file );
+
+  return( data );
+}
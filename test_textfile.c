@@ -0,0 +1,261 @@
+/* test_textfile.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program checks textfile_update() gives the same tokens as a single
+** call to textlex_update() does. It builds a document a few megabytes long
+** out of the fixtures in test_textlex.h and lexes it from memory, from a
+** temporary file (which gets mapped) and from a pipe (which gets read) that
+** a child process writes into a few octets at a time. Then it does the same
+** with a syntax error three quarters of the way through, and checks an
+** empty file lexes to nothing.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 200809L
+
+#define TEST_DOCUMENT_SIZE ( 3 * 1024 * 1024 )
+#define TEST_BUFFER_SIZE   80
+#define TEST_PIPE_PIECE    1021
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "textfile.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  unsigned char * data;
+  size_t          length;
+  size_t          size;
+} tTranscript;
+
+/* Function Prototypes */
+
+static int compare( char * name, unsigned char * document, size_t length );
+static tTextLexErr lex_memory( tTranscript * transcript, unsigned char * document, size_t length, unsigned long long * lexed );
+static tTextLexErr lex_file( tTranscript * transcript, unsigned char * document, size_t length, unsigned long long * lexed );
+static tTextLexErr lex_pipe( tTranscript * transcript, unsigned char * document, size_t length, unsigned long long * lexed );
+static tTextLexErr finish( tTranscript * transcript, tTextLexContext * context, tTextLexErr err );
+static void append( tTranscript * transcript, void * data, size_t length );
+static tTextLexErr _token( tTextLexContext * context, tTextLexCount token );
+
+/* Global Variables */
+
+static const char * fixtures [] = {
+#include "test_textlex.h"
+  NULL
+};
+
+static tTranscript * current = NULL;
+
+int main( int argc, char * argv [] ) {
+  unsigned char * document;
+  size_t length = 0, fixture;
+  unsigned int i;
+  int failed = 0;
+
+  printf( "; BEGIN TESTS\n" );
+
+  if( NULL == ( document = malloc( TEST_DOCUMENT_SIZE + 1024 ) ) ) {
+    fprintf( stderr, "%%TEST-F-MEMORY; Can't allocate test document.\n" );
+    return( 2 );
+  }
+
+  for( i = 0; length < TEST_DOCUMENT_SIZE; i = ( NULL == fixtures[ i + 1 ] ) ? 0 : i + 1 ) {
+    fixture = strlen( fixtures[ i ] );
+    memcpy( document + length, fixtures[ i ], fixture );
+    document[ length + fixture ] = '\n';
+    length += fixture + 1;
+  }
+
+  failed |= compare( "fixtures", document, length );
+
+  memcpy( document + ( length / 4 ) * 3, "\n?\n", 3 );
+  failed |= compare( "error", document, length );
+
+  failed |= compare( "empty", document, 0 );
+
+  free( document );
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+/* compare()
+**
+** Lexes the document all three ways and compares the transcripts and the
+** number of octets each one says it lexed.
+*/
+
+static int compare( char * name, unsigned char * document, size_t length ) {
+  tTranscript expected = { NULL, 0, 0 };
+  tTranscript actual = { NULL, 0, 0 };
+  tTextLexErr expected_err, err;
+  unsigned long long expected_lexed, lexed;
+  int failed = 0;
+
+  expected_err = lex_memory( & expected, document, length, & expected_lexed );
+  if( ( 0 == strcmp( name, "error" ) ) == ( TEXTLEX_E_NOERR == expected_err ) ) {
+    printf( ";  %s: error %u from textlex_update()\n", name, expected_err );
+    failed = 1;
+  }
+
+  err = lex_file( & actual, document, length, & lexed );
+  if( ( err != expected_err ) || ( lexed != expected_lexed ) || ( actual.length != expected.length ) ||
+      ( 0 != memcmp( actual.data, expected.data, expected.length ) ) ) {
+    printf( ";  %s: file gave error %u after %llu octets, not %u after %llu\n", name, err, lexed, expected_err, expected_lexed );
+    failed = 1;
+  }
+
+  actual.length = 0;
+  err = lex_pipe( & actual, document, length, & lexed );
+  if( ( err != expected_err ) || ( lexed != expected_lexed ) || ( actual.length != expected.length ) ||
+      ( 0 != memcmp( actual.data, expected.data, expected.length ) ) ) {
+    printf( ";  %s: pipe gave error %u after %llu octets, not %u after %llu\n", name, err, lexed, expected_err, expected_lexed );
+    failed = 1;
+  }
+
+  printf( "; TEST %-8s %8zu octets %s\n", name, length, failed ? "FAILED" : "OK" );
+
+  free( expected.data );
+  free( actual.data );
+
+  return( failed );
+}
+
+static tTextLexErr lex_memory( tTranscript * transcript, unsigned char * document, size_t length, unsigned long long * lexed ) {
+  tTextLexContext context;
+  tTextLexBuffer buffer[ TEST_BUFFER_SIZE ];
+  tTextLexErr err;
+
+  current = transcript;
+  textlex_init( & context, buffer, TEST_BUFFER_SIZE );
+  context.token = _token;
+
+  err = textlex_update( & context, document, (tTextLexCount) length );
+  * lexed = ( TEXTLEX_E_NOERR == err ) ? length : context.bytes_read;
+
+  return( finish( transcript, & context, err ) );
+}
+
+static tTextLexErr lex_file( tTranscript * transcript, unsigned char * document, size_t length, unsigned long long * lexed ) {
+  tTextLexContext context;
+  tTextLexBuffer buffer[ TEST_BUFFER_SIZE ];
+  tTextLexErr err;
+  char path [] = "/tmp/test_textfile_XXXXXX";
+  FILE * file;
+  int fd;
+
+  if( ( 0 > ( fd = mkstemp( path ) ) ) || ( NULL == ( file = fdopen( fd, "w+b" ) ) ) ) {
+    fprintf( stderr, "%%TEST-F-FILE; Can't make a temporary file.\n" );
+    exit( 2 );
+  }
+  unlink( path );
+
+  if( ( length != fwrite( document, 1, length, file ) ) || ( 0 != fflush( file ) ) ) {
+    fprintf( stderr, "%%TEST-F-FILE; Can't write the temporary file.\n" );
+    exit( 2 );
+  }
+  rewind( file );
+
+  current = transcript;
+  textlex_init( & context, buffer, TEST_BUFFER_SIZE );
+  context.token = _token;
+
+  err = textfile_update( & context, fd, lexed );
+  fclose( file );
+
+  return( finish( transcript, & context, err ) );
+}
+
+static tTextLexErr lex_pipe( tTranscript * transcript, unsigned char * document, size_t length, unsigned long long * lexed ) {
+  tTextLexContext context;
+  tTextLexBuffer buffer[ TEST_BUFFER_SIZE ];
+  tTextLexErr err;
+  size_t offset, piece;
+  ssize_t written;
+  pid_t child;
+  int fds[ 2 ];
+
+  fflush( stdout );
+
+  if( ( 0 != pipe( fds ) ) || ( 0 > ( child = fork() ) ) ) {
+    fprintf( stderr, "%%TEST-F-PIPE; Can't start the writer.\n" );
+    exit( 2 );
+  }
+
+  if( 0 == child ) {
+    close( fds[ 0 ] );
+    for( offset = 0; offset < length; offset += written ) {
+      piece = ( ( length - offset ) < TEST_PIPE_PIECE ) ? ( length - offset ) : TEST_PIPE_PIECE;
+      if( 0 > ( written = write( fds[ 1 ], document + offset, piece ) ) ) {
+        break;
+      }
+    }
+    close( fds[ 1 ] );
+    _exit( 0 );
+  }
+
+  close( fds[ 1 ] );
+
+  current = transcript;
+  textlex_init( & context, buffer, TEST_BUFFER_SIZE );
+  context.token = _token;
+
+  err = textfile_update( & context, fds[ 0 ], lexed );
+
+  close( fds[ 0 ] );
+  waitpid( child, NULL, 0 );
+
+  return( finish( transcript, & context, err ) );
+}
+
+/* finish()
+**
+** Calls textlex_final() if there wasn't an error and adds the error, line
+** and octet to the end of the transcript.
+*/
+
+static tTextLexErr finish( tTranscript * transcript, tTextLexContext * context, tTextLexErr err ) {
+  char summary[ 64 ];
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textlex_final( context );
+  }
+
+  append( transcript, summary, sprintf( summary, "E%u@%u.%u", err, context->line, context->octet ) );
+
+  return( err );
+}
+
+static void append( tTranscript * transcript, void * data, size_t length ) {
+  if( transcript->length + length > transcript->size ) {
+    transcript->size = ( transcript->size + length ) * 2;
+    if( NULL == ( transcript->data = realloc( transcript->data, transcript->size ) ) ) {
+      fprintf( stderr, "%%TEST-F-MEMORY; Can't grow the transcript.\n" );
+      exit( 2 );
+    }
+  }
+
+  memcpy( transcript->data + transcript->length, data, length );
+  transcript->length += length;
+}
+
+static tTextLexErr _token( tTextLexContext * context, tTextLexCount token ) {
+  unsigned char code = (unsigned char) token;
+
+  append( current, & code, 1 );
+  append( current, context->buffer, context->index );
+  append( current, "|", 1 );
+
+  return( TEXTLEX_E_NOERR );
+}
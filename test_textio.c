@@ -0,0 +1,314 @@
+/* test_textio.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program checks the stream ingestion layer gives each stream the same
+** tokens a single call to textlex_update() would. It opens a couple of
+** hundred pipes and socket pairs and has a writer thread dribble a different
+** document into each one, a few octets here and a few thousand there, taking
+** turns between the streams. One document is big enough to fill its pipe,
+** so that stream has to stop being read while its chunks are lexed, and a
+** few have syntax errors in them. It runs once with io_uring and once with
+** epoll, with one worker and with several.
+**
+** Stream zero is a regular file. io_uring reads it like any other, but
+** epoll can't wait on one, so with epoll it should fail with TEXTIO_E_READ.
+**
+** Linked with textio_ring.o instead of textio.o, it runs with a submission
+** queue of 8 and a completion queue of 16, far fewer than the streams.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 200809L
+
+#define TEST_STREAMS      200
+#define TEST_BUFFER_SIZE  80
+#define TEST_BIG_SIZE     ( 300 * 1024 )
+#define TEST_DOCUMENT     8192
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include "textio.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  unsigned char * data;
+  size_t          length;
+  size_t          size;
+} tTranscript;
+
+typedef struct {
+  tTextIoStream   stream;
+  tTextLexBuffer  buffer[ TEST_BUFFER_SIZE ];
+  tTranscript     transcript;
+  unsigned char * document;
+  size_t          length;
+  size_t          written;
+  int             in;
+  int             out;
+  int             done;
+} tTestStream;
+
+/* Function Prototypes */
+
+static int run( unsigned int flags, unsigned int workers );
+static unsigned char * make_document( unsigned int n, size_t * length );
+static void expect( tTranscript * transcript, unsigned char * document, size_t length );
+static void * writer( void * argument );
+static void append( tTranscript * transcript, void * data, size_t length );
+static tTextLexErr _token( tTextLexContext * context, tTextLexCount token );
+static void _done( tTextIoStream * stream, tTextLexErr err );
+
+/* Global Variables */
+
+static const char * fixtures [] = {
+#include "test_textlex.h"
+  NULL
+};
+
+static tTestStream streams[ TEST_STREAMS ];
+
+int main( int argc, char * argv [] ) {
+  int failed = 0;
+
+  signal( SIGPIPE, SIG_IGN );
+
+  printf( "; BEGIN TESTS\n" );
+
+  failed |= run( 0, 1 );
+  failed |= run( 0, 4 );
+  failed |= run( TEXTIO_F_EPOLL, 1 );
+  failed |= run( TEXTIO_F_EPOLL, 4 );
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+static int run( unsigned int flags, unsigned int workers ) {
+  static const char * backends [] = { "NONE", "URING", "EPOLL" };
+  tTextIoContext context;
+  tTranscript expected;
+  pthread_t thread;
+  char path [] = "/tmp/test_textio_XXXXXX";
+  unsigned int i;
+  int fds[ 2 ], failed = 0, bad;
+
+  if( TEXTLEX_E_NOERR != textio_init( & context, workers, flags ) ) {
+    printf( "; TEST %s %u workers FAILED (can't start)\n", ( flags & TEXTIO_F_EPOLL ) ? "EPOLL" : "URING", workers );
+    return( 1 );
+  }
+
+  for( i = 0; i < TEST_STREAMS; i++ ) {
+    tTestStream * test = & streams[ i ];
+
+    memset( test, 0, sizeof( tTestStream ) );
+    test->document = make_document( i, & test->length );
+
+    if( 0 == i ) {
+      if( ( 0 > ( fds[ 0 ] = mkstemp( path ) ) ) || ( (ssize_t) test->length != write( fds[ 0 ], test->document, test->length ) ) ) {
+        fprintf( stderr, "%%TEST-F-FILE; Can't write a temporary file.\n" );
+        exit( 2 );
+      }
+      unlink( path );
+      lseek( fds[ 0 ], 0, SEEK_SET );
+      fds[ 1 ] = -1;
+      test->written = test->length;
+    } else if( ( ( i & 1 ) ? socketpair( AF_UNIX, SOCK_STREAM, 0, fds ) : pipe( fds ) ) ) {
+      fprintf( stderr, "%%TEST-F-PIPE; Can't make a pipe or socket pair.\n" );
+      exit( 2 );
+    }
+    test->in = fds[ 0 ];
+    test->out = fds[ 1 ];
+
+    textlex_init( & test->stream.lexxer, test->buffer, TEST_BUFFER_SIZE );
+    test->stream.lexxer.token = _token;
+    test->stream.done = _done;
+    test->stream.user = test;
+
+    textio_add( & context, & test->stream, test->in );
+  }
+
+  pthread_create( & thread, NULL, writer, NULL );
+  textio_run( & context );
+  pthread_join( thread, NULL );
+
+  for( i = 0; i < TEST_STREAMS; i++ ) {
+    tTestStream * test = & streams[ i ];
+
+    memset( & expected, 0, sizeof( tTranscript ) );
+    if( ( 0 == i ) && ( TEXTIO_B_EPOLL == context.backend ) ) {
+      append( & expected, "E104@0.0", 8 );
+      bad = EPERM != test->stream.error;
+    } else {
+      expect( & expected, test->document, test->length );
+      bad = 0;
+    }
+
+    bad |= ( ! test->done ) || ( expected.length != test->transcript.length ) ||
+      ( 0 != memcmp( expected.data, test->transcript.data, expected.length ) );
+
+    if( bad ) {
+      printf( ";  stream %u: %.*s\n", i, (int) ( ( test->transcript.length > 60 ) ? 60 : test->transcript.length ), test->transcript.data );
+    }
+    failed |= bad;
+
+    free( expected.data );
+    free( test->transcript.data );
+    free( test->document );
+  }
+
+  printf( "; TEST %s %u workers %u streams %s\n", backends[ context.backend ], workers, TEST_STREAMS, failed ? "FAILED" : "OK" );
+
+  textio_free( & context );
+
+  return( failed );
+}
+
+/* make_document()
+**
+** Each stream gets the fixtures starting at a different one. Stream 5 gets a
+** big one and every 17th stream has an error at the end.
+*/
+
+static unsigned char * make_document( unsigned int n, size_t * length ) {
+  size_t size = ( 5 == n ) ? TEST_BIG_SIZE : TEST_DOCUMENT;
+  unsigned char * document;
+  unsigned int i;
+  size_t fixture;
+
+  if( NULL == ( document = malloc( size + 1024 ) ) ) {
+    fprintf( stderr, "%%TEST-F-MEMORY; Can't allocate a document.\n" );
+    exit( 2 );
+  }
+
+  i = n % ( sizeof( fixtures ) / sizeof( fixtures[ 0 ] ) - 1 );
+  for( * length = 0; * length < size; i = ( NULL == fixtures[ i + 1 ] ) ? 0 : i + 1 ) {
+    fixture = strlen( fixtures[ i ] );
+    memcpy( document + * length, fixtures[ i ], fixture );
+    document[ * length + fixture ] = '\n';
+    * length += fixture + 1;
+  }
+
+  if( 3 == ( n % 17 ) ) {
+    memcpy( document + * length, "[ 1 2x ]", 8 );
+    * length += 8;
+  }
+
+  return( document );
+}
+
+static void expect( tTranscript * transcript, unsigned char * document, size_t length ) {
+  tTestStream shadow;
+  tTextLexContext * lexxer = & shadow.stream.lexxer;
+  tTextLexBuffer buffer[ TEST_BUFFER_SIZE ];
+  tTextLexErr err;
+  char summary[ 64 ];
+
+  /* _token() finds the transcript through the stream the context is in. */
+
+  memset( & shadow, 0, sizeof( tTestStream ) );
+  shadow.stream.user = & shadow;
+
+  textlex_init( lexxer, buffer, TEST_BUFFER_SIZE );
+  lexxer->token = _token;
+
+  if( TEXTLEX_E_NOERR == ( err = textlex_update( lexxer, document, (tTextLexCount) length ) ) ) {
+    err = textlex_final( lexxer );
+  }
+
+  append( & shadow.transcript, summary, sprintf( summary, "E%u@%u.%u", err, lexxer->line, lexxer->octet ) );
+  * transcript = shadow.transcript;
+}
+
+/* writer()
+**
+** Writes every stream's document in pieces, a piece per stream per round,
+** then closes the write ends.
+*/
+
+static void * writer( void * argument ) {
+  static const size_t pieces [] = { 1, 7, 100, 1500, 5000, 33 };
+  unsigned int i, round, remaining;
+  size_t piece;
+  ssize_t written;
+
+  for( round = 0, remaining = TEST_STREAMS; 0 < remaining; round++ ) {
+    remaining = 0;
+
+    for( i = 1; i < TEST_STREAMS; i++ ) {
+      tTestStream * test = & streams[ i ];
+
+      if( test->written == test->length ) {
+        continue;
+      }
+
+      piece = pieces[ ( i + round ) % ( sizeof( pieces ) / sizeof( pieces[ 0 ] ) ) ];
+      if( piece > test->length - test->written ) {
+        piece = test->length - test->written;
+      }
+
+      /* Streams with errors can be closed before they're all written. */
+
+      if( 0 > ( written = write( test->out, test->document + test->written, piece ) ) ) {
+        if( EPIPE != errno ) {
+          fprintf( stderr, "%%TEST-F-WRITE; %s\n", strerror( errno ) );
+          exit( 2 );
+        }
+        written = (ssize_t) ( test->length - test->written );
+      }
+
+      test->written += (size_t) written;
+      if( test->written == test->length ) {
+        close( test->out );
+      } else {
+        remaining++;
+      }
+    }
+  }
+
+  return( NULL );
+}
+
+static void append( tTranscript * transcript, void * data, size_t length ) {
+  if( transcript->length + length > transcript->size ) {
+    transcript->size = ( transcript->size + length ) * 2;
+    if( NULL == ( transcript->data = realloc( transcript->data, transcript->size ) ) ) {
+      fprintf( stderr, "%%TEST-F-MEMORY; Can't grow the transcript.\n" );
+      exit( 2 );
+    }
+  }
+
+  memcpy( transcript->data + transcript->length, data, length );
+  transcript->length += length;
+}
+
+static tTextLexErr _token( tTextLexContext * context, tTextLexCount token ) {
+  tTestStream * test = (tTestStream *) ( (tTextIoStream *) context )->user;
+  unsigned char code = (unsigned char) token;
+
+  append( & test->transcript, & code, 1 );
+  append( & test->transcript, context->buffer, context->index );
+  append( & test->transcript, "|", 1 );
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static void _done( tTextIoStream * stream, tTextLexErr err ) {
+  tTestStream * test = (tTestStream *) stream->user;
+  char summary[ 64 ];
+
+  append( & test->transcript, summary, sprintf( summary, "E%u@%u.%u", err, stream->lexxer.line, stream->lexxer.octet ) );
+  close( test->in );
+  test->done = 1;
+}
@@ -4,58 +4,18 @@
 
 static void pretty_print( tTextLexBuffer * string );
 static tTextLexErr parse_this( tTextLexBuffer * string );
+#if defined( _BATCH_MODE ) || defined( _SPAN_MODE )
+static tTextLexErr _span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+#else
 static tTextLexErr _token( tTextLexContext * context, tTextLexCount token );
+#endif
+#ifdef _BATCH_MODE
+static tTextLexErr _batch( tTextLexContext * context, tTextLexToken * tokens, tTextLexCount count );
+#endif
 static unsigned char * token_name( unsigned int token );
 
 tTextLexBuffer * fixtures [] = {
-  "",
-  " ",
-  "#Comment 00",
-  "\n",
-  "\r\n",
-  "#Comment 01\n",
-  "#Comment 02\r\n",
-  "@t",
-  "@t\n",
-  "@t\r\n",
-  "@t #Comment 03",
-  "@t #Comment 04\n",
-  "@t #Comment 05\n\r",
-  "*nil",
-  "*false #COMMENT XX",
-  "*true #Comment YY\n",
-  "@m 90125",
-  "3.14 #Hey! I'm a floating point value!",
-  "$CAFEB0EF #Comment 06",
-  "\"This is a \\\"string\\\"\" #Comment 07",
-  "'OTyqgu7Aca5sDCBzEoR23A=='",
-  "( 39 30 31 32 35 )",
-  "(\n 41 42 43 44 # ABCD\n 45 46 47 48 # EFGH\n)",
-  "[ 3.14 *nil ]",
-  "[ 3.14 *nil ]",
-  "[ 1 -1 2.3 -2.3 4.56 -4.56 78.9 -78.9 ]",
-  "[ 12.34 -12.34 5.6e7 -5.6e7 89.0e1 -89.0e1 ]",
-  "[ 12.34e5 -12.34e5 6.78e90 -6.78e90 ]",
-  "[ 12.34e-5 -12.34e-5 12.34e-56 -12.34e-56 ]",
-  "@s { \"one\"=1 }",
-  "{ \"two\" = 2 }",
-  "{ \"3\" = \"three\"}",
-  "@t{\"3\"=\"three\"}",
-  "*true@u@t$ABBA 12$CD",
-  "*undefined@t$ABBA 12$CD#01234567890123456789",
-  "*undefined@t$ABBA 12$CD#012345678901234567890",
-  "*undefined@t$ABBA 12$CD#0123456789012345678901",
-  "@m\n{\n\"one\" = \"two\"}",
-  "@thisisaverylongannotation @thisistwentycharsabc",
-  "*thisisaverylongliteral*thisistwentycharsabc",
-  "#this comment should be longer than 20 chars\n#thisistwentycharsabc",
-  "01234567890123456789 # Numbers can be as long as you need",
-  "-12.0123012301230123 # Floats can be pretty long too",
-  "-3.1345324532453E568 # Hey look, a big exponent!",
-  "$0123456789ABCDEF0123 $0123456789ABCDEF012345",
-  "'OTyqgu7Aca5sDCBzEoR23A==' 'gu7Aca5sDCBzEoR23A=='",
-  "\"ABCDEFGHIJKLMNOPQRSTUVWXYZ\" \"ABCDEFGHIJKLMNOPQRS\\\"\" \"ABCDEFGHIJKLMNOPQRST\\\"\"",
-  "(00112233445566778899) ( AABBCCDDEEFF00112233 #COMMENTCOMMENTCOMETT\n 12 12) \"test\"",
+#include "test_textlex.h"
   (unsigned char *) NULL
 };
 
@@ -98,17 +58,36 @@ static void pretty_print( unsigned char * string ) {
 #ifndef _BUFFER_SIZE
 #define _BUFFER_SIZE 80
 #endif
+#ifndef _BATCH_SIZE
+#define _BATCH_SIZE 3
+#endif
 static tTextLexErr parse_this( unsigned char * string ) {
   tTextLexErr err;
   tTextLexBuffer buffer[ _BUFFER_SIZE ];
+#ifdef _BATCH_MODE
+  tTextLexToken tokens[ _BATCH_SIZE ];
+#endif
   tTextLexContext context;
+#if defined( _BATCH_MODE ) || defined( _SPAN_MODE )
+  tTextLexExtension extension;
+#endif
   
   do {
     if( TEXTLEX_E_NOERR != ( err = textlex_init( & context, buffer, _BUFFER_SIZE ) ) ) {
       break;
     }
 
+#if defined( _BATCH_MODE )
+    textlex_extend( & context, & extension );
+    extension.tokens = tokens;
+    extension.capacity = _BATCH_SIZE;
+    extension.batch = _batch;
+#elif defined( _SPAN_MODE )
+    textlex_extend( & context, & extension );
+    extension.span = _span;
+#else
     context.token = _token;
+#endif
     
     if( TEXTLEX_E_NOERR != ( err = textlex_update( & context, string, strlen( string ) ) ) ) {
       break;
@@ -126,12 +105,34 @@ static tTextLexErr parse_this( unsigned char * string ) {
   return( err );
 }
 
+#if ! defined( _BATCH_MODE ) && ! defined( _SPAN_MODE )
 static tTextLexErr _token( tTextLexContext * context, tTextLexCount token ) {
   printf( ";  TOKEN %2d %15.15s (%2d) %1s %*.*s\n", token, token_name( token ),
           context->index, ( ( context->index == context->size ) ? "O" : " " ),
           context->index, context->index, context->buffer );
   return( TEXTLEX_E_NOERR );
 }
+#else
+static tTextLexErr _span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  printf( ";  TOKEN %2d %15.15s (%2d) %1s %*.*s\n", token, token_name( token ),
+          length, ( ( length == context->size ) ? "O" : " " ),
+          length, length, data );
+  return( TEXTLEX_E_NOERR );
+}
+#endif
+
+#ifdef _BATCH_MODE
+static tTextLexErr _batch( tTextLexContext * context, tTextLexToken * tokens, tTextLexCount count ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexCount i;
+
+  for( i = 0; ( i < count ) && ( TEXTLEX_E_NOERR == err ); i++ ) {
+    err = _span( context, tokens[ i ].token, tokens[ i ].data, tokens[ i ].length );
+  }
+
+  return( err );
+}
+#endif
 
 static unsigned char * token_name( unsigned int token ) {
   static unsigned char * tokens [] = {
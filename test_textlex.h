@@ -0,0 +1,58 @@
+/* test_textlex.h
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** The DSD text fixtures lexed by test_textlex.c, one string literal per
+** line, each followed by a comma. Include it between the braces of an
+** array initializer so the C and C++ test programs lex the same documents.
+*/
+
+  "",
+  " ",
+  "#Comment 00",
+  "\n",
+  "\r\n",
+  "#Comment 01\n",
+  "#Comment 02\r\n",
+  "@t",
+  "@t\n",
+  "@t\r\n",
+  "@t #Comment 03",
+  "@t #Comment 04\n",
+  "@t #Comment 05\n\r",
+  "*nil",
+  "*false #COMMENT XX",
+  "*true #Comment YY\n",
+  "@m 90125",
+  "3.14 #Hey! I'm a floating point value!",
+  "$CAFEB0EF #Comment 06",
+  "\"This is a \\\"string\\\"\" #Comment 07",
+  "'OTyqgu7Aca5sDCBzEoR23A=='",
+  "( 39 30 31 32 35 )",
+  "(\n 41 42 43 44 # ABCD\n 45 46 47 48 # EFGH\n)",
+  "[ 3.14 *nil ]",
+  "[ 3.14 *nil ]",
+  "[ 1 -1 2.3 -2.3 4.56 -4.56 78.9 -78.9 ]",
+  "[ 12.34 -12.34 5.6e7 -5.6e7 89.0e1 -89.0e1 ]",
+  "[ 12.34e5 -12.34e5 6.78e90 -6.78e90 ]",
+  "[ 12.34e-5 -12.34e-5 12.34e-56 -12.34e-56 ]",
+  "@s { \"one\"=1 }",
+  "{ \"two\" = 2 }",
+  "{ \"3\" = \"three\"}",
+  "@t{\"3\"=\"three\"}",
+  "*true@u@t$ABBA 12$CD",
+  "*undefined@t$ABBA 12$CD#01234567890123456789",
+  "*undefined@t$ABBA 12$CD#012345678901234567890",
+  "*undefined@t$ABBA 12$CD#0123456789012345678901",
+  "@m\n{\n\"one\" = \"two\"}",
+  "@thisisaverylongannotation @thisistwentycharsabc",
+  "*thisisaverylongliteral*thisistwentycharsabc",
+  "#this comment should be longer than 20 chars\n#thisistwentycharsabc",
+  "01234567890123456789 # Numbers can be as long as you need",
+  "-12.0123012301230123 # Floats can be pretty long too",
+  "-3.1345324532453E568 # Hey look, a big exponent!",
+  "$0123456789ABCDEF0123 $0123456789ABCDEF012345",
+  "'OTyqgu7Aca5sDCBzEoR23A==' 'gu7Aca5sDCBzEoR23A=='",
+  "\"ABCDEFGHIJKLMNOPQRSTUVWXYZ\" \"ABCDEFGHIJKLMNOPQRS\\\"\" \"ABCDEFGHIJKLMNOPQRST\\\"\"",
+  "(00112233445566778899) ( AABBCCDDEEFF00112233 #COMMENTCOMMENTCOMETT\n 12 12) \"test\"",
@@ -0,0 +1,331 @@
+/* test_textlexpp.cpp
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests dsd::TextLexer, the C++ lexxer in textlex.hpp. First it
+** lexes the fixtures in test_textlex.h and prints the tokens exactly the way
+** test_textlex_span does, so the two outputs can be compared with diff
+** (leaving out the "SIZE OF" lines.) Then it lexes each fixture again in
+** pieces of a few sizes, with a big buffer and one small enough to
+** overflow, and checks it gets the same tokens the C lexxer's span callback
+** does. Last, it checks a handler without on_comment() and on_annotation()
+** gets everything else, and nothing more.
+*/
+
+/* Macro Definitions */
+
+#define TEST_BUFFER_SIZE 80
+
+/* File Includes */
+
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include "textlex.hpp"
+
+/* Structs, Typedefs, Unions & Enums */
+
+/* PrintHandler prints each token like test_textlex.c's _span() does. */
+
+struct PrintHandler {
+  tTextLexErr print( tTextLexCount token, const tTextLexBuffer * data, tTextLexCount length );
+
+  tTextLexErr on_comment( const tTextLexBuffer * data, tTextLexCount length ) { return( print( TEXTLEX_T_COMMENT, data, length ) ); }
+  tTextLexErr on_annotation( const tTextLexBuffer * data, tTextLexCount length ) { return( print( TEXTLEX_T_ANNOTATION, data, length ) ); }
+  tTextLexErr on_literal( const tTextLexBuffer * data, tTextLexCount length ) { return( print( TEXTLEX_T_LITERAL, data, length ) ); }
+  tTextLexErr on_integer( const tTextLexBuffer * data, tTextLexCount length ) { return( print( TEXTLEX_T_INTEGER, data, length ) ); }
+  tTextLexErr on_float( const tTextLexBuffer * data, tTextLexCount length ) { return( print( TEXTLEX_T_FLOAT, data, length ) ); }
+  tTextLexErr on_hex( const tTextLexBuffer * data, tTextLexCount length ) { return( print( TEXTLEX_T_HEX, data, length ) ); }
+  tTextLexErr on_string( const tTextLexBuffer * data, tTextLexCount length ) { return( print( TEXTLEX_T_STRING, data, length ) ); }
+  tTextLexErr on_base64( const tTextLexBuffer * data, tTextLexCount length ) { return( print( TEXTLEX_T_BASE64, data, length ) ); }
+  tTextLexErr on_end() { return( print( TEXTLEX_T_END, nullptr, 0 ) ); }
+  tTextLexErr on_array_open() { return( print( TEXTLEX_T_ARRAY_OPEN, nullptr, 0 ) ); }
+  tTextLexErr on_array_close() { return( print( TEXTLEX_T_ARRAY_CLOSE, nullptr, 0 ) ); }
+  tTextLexErr on_map_open() { return( print( TEXTLEX_T_MAP_OPEN, nullptr, 0 ) ); }
+  tTextLexErr on_map_close() { return( print( TEXTLEX_T_MAP_CLOSE, nullptr, 0 ) ); }
+  tTextLexErr on_equals() { return( print( TEXTLEX_T_EQUALS, nullptr, 0 ) ); }
+};
+
+/* RecordHandler writes the tokens into a string, one "token:lexeme|" after
+** another, so two runs can be compared.
+*/
+
+struct RecordHandler {
+  std::string record;
+
+  tTextLexErr add( tTextLexCount token, const tTextLexBuffer * data, tTextLexCount length ) {
+    record += std::to_string( token ) + ":" + ( ( nullptr != data ) ? std::string( (const char *) data, length ) : "" ) + "|";
+    return( TEXTLEX_E_NOERR );
+  }
+
+  tTextLexErr on_comment( const tTextLexBuffer * data, tTextLexCount length ) { return( add( TEXTLEX_T_COMMENT, data, length ) ); }
+  tTextLexErr on_annotation( const tTextLexBuffer * data, tTextLexCount length ) { return( add( TEXTLEX_T_ANNOTATION, data, length ) ); }
+  tTextLexErr on_literal( const tTextLexBuffer * data, tTextLexCount length ) { return( add( TEXTLEX_T_LITERAL, data, length ) ); }
+  tTextLexErr on_integer( const tTextLexBuffer * data, tTextLexCount length ) { return( add( TEXTLEX_T_INTEGER, data, length ) ); }
+  tTextLexErr on_float( const tTextLexBuffer * data, tTextLexCount length ) { return( add( TEXTLEX_T_FLOAT, data, length ) ); }
+  tTextLexErr on_hex( const tTextLexBuffer * data, tTextLexCount length ) { return( add( TEXTLEX_T_HEX, data, length ) ); }
+  tTextLexErr on_string( const tTextLexBuffer * data, tTextLexCount length ) { return( add( TEXTLEX_T_STRING, data, length ) ); }
+  tTextLexErr on_base64( const tTextLexBuffer * data, tTextLexCount length ) { return( add( TEXTLEX_T_BASE64, data, length ) ); }
+  tTextLexErr on_end() { return( add( TEXTLEX_T_END, nullptr, 0 ) ); }
+  tTextLexErr on_array_open() { return( add( TEXTLEX_T_ARRAY_OPEN, nullptr, 0 ) ); }
+  tTextLexErr on_array_close() { return( add( TEXTLEX_T_ARRAY_CLOSE, nullptr, 0 ) ); }
+  tTextLexErr on_map_open() { return( add( TEXTLEX_T_MAP_OPEN, nullptr, 0 ) ); }
+  tTextLexErr on_map_close() { return( add( TEXTLEX_T_MAP_CLOSE, nullptr, 0 ) ); }
+  tTextLexErr on_equals() { return( add( TEXTLEX_T_EQUALS, nullptr, 0 ) ); }
+};
+
+/* QuietHandler is a RecordHandler that doesn't want comments or
+** annotations.
+*/
+
+struct QuietHandler {
+  RecordHandler inner;
+
+  tTextLexErr on_literal( const tTextLexBuffer * data, tTextLexCount length ) { return( inner.on_literal( data, length ) ); }
+  tTextLexErr on_integer( const tTextLexBuffer * data, tTextLexCount length ) { return( inner.on_integer( data, length ) ); }
+  tTextLexErr on_float( const tTextLexBuffer * data, tTextLexCount length ) { return( inner.on_float( data, length ) ); }
+  tTextLexErr on_hex( const tTextLexBuffer * data, tTextLexCount length ) { return( inner.on_hex( data, length ) ); }
+  tTextLexErr on_string( const tTextLexBuffer * data, tTextLexCount length ) { return( inner.on_string( data, length ) ); }
+  tTextLexErr on_base64( const tTextLexBuffer * data, tTextLexCount length ) { return( inner.on_base64( data, length ) ); }
+  tTextLexErr on_end() { return( inner.on_end() ); }
+  tTextLexErr on_array_open() { return( inner.on_array_open() ); }
+  tTextLexErr on_array_close() { return( inner.on_array_close() ); }
+  tTextLexErr on_map_open() { return( inner.on_map_open() ); }
+  tTextLexErr on_map_close() { return( inner.on_map_close() ); }
+  tTextLexErr on_equals() { return( inner.on_equals() ); }
+};
+
+static_assert( ! dsd::detail::wants< QuietHandler, TEXTLEX_T_COMMENT >::value, "QuietHandler shouldn't get comments" );
+static_assert( dsd::detail::wants< QuietHandler, TEXTLEX_T_STRING >::value, "QuietHandler should get strings" );
+
+/* Function Prototypes */
+
+static void pretty_print( const char * string );
+static tTextLexErr parse_this( const char * string );
+template< class Handler > static tTextLexErr lex( Handler & handler, const char * string, size_t chunk, tTextLexCount size );
+static tTextLexErr lex_c( std::string & record, const char * string, size_t chunk, tTextLexCount size );
+static tTextLexErr record_span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static std::string without_comments( const std::string & record );
+static const char * token_name( unsigned int token );
+
+/* Global Variables */
+
+static std::string * c_record = nullptr;
+
+static const char * fixtures [] = {
+#include "test_textlex.h"
+  nullptr
+};
+
+int main( int argc, char * argv [] ) {
+  static const size_t chunks [] = { 0, 1, 2, 3, 7 };
+  static const tTextLexCount sizes [] = { TEST_BUFFER_SIZE, 5 };
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  unsigned int i, j, k;
+  int failed = 0;
+
+  printf( "; BEGIN TESTS\n" );
+
+  printf( "; SIZE OF LEXER: %zu\n", sizeof( dsd::TextLexer< PrintHandler > ) );
+
+  for( i = 0; nullptr != fixtures[ i ]; i++ ) {
+    printf( "; TEST %3d (%03zu) ", i, strlen( fixtures[ i ] ) );
+    pretty_print( fixtures[ i ] );
+    printf( "\n" );
+
+    if( TEXTLEX_E_NOERR != ( err = parse_this( fixtures[ i ] ) ) ) {
+      break;
+    }
+  }
+
+  for( j = 0; j < sizeof( sizes ) / sizeof( sizes[ 0 ] ); j++ ) {
+    for( k = 0; k < sizeof( chunks ) / sizeof( chunks[ 0 ] ); k++ ) {
+      int bad = 0;
+
+      for( i = 0; nullptr != fixtures[ i ]; i++ ) {
+        RecordHandler handler;
+        std::string expected;
+        tTextLexErr c_err = lex_c( expected, fixtures[ i ], chunks[ k ], sizes[ j ] );
+
+        if( ( c_err != lex( handler, fixtures[ i ], chunks[ k ], sizes[ j ] ) ) || ( expected != handler.record ) ) {
+          printf( ";  fixture %u: %s\n;    expected %s\n", i, handler.record.c_str(), expected.c_str() );
+          bad = 1;
+        }
+      }
+
+      printf( "; TEST CHUNKS buffer %2u chunk %zu %s\n", (unsigned int) sizes[ j ], chunks[ k ], bad ? "FAILED" : "OK" );
+      failed |= bad;
+    }
+  }
+
+  {
+    int bad = 0;
+
+    for( i = 0; nullptr != fixtures[ i ]; i++ ) {
+      RecordHandler full;
+      QuietHandler quiet;
+
+      lex( full, fixtures[ i ], 3, TEST_BUFFER_SIZE );
+      lex( quiet, fixtures[ i ], 3, TEST_BUFFER_SIZE );
+
+      if( without_comments( full.record ) != quiet.inner.record ) {
+        printf( ";  fixture %u: %s\n", i, quiet.inner.record.c_str() );
+        bad = 1;
+      }
+    }
+
+    printf( "; TEST SKIP COMMENTS %s\n", bad ? "FAILED" : "OK" );
+    failed |= bad;
+  }
+
+  printf( "; END TESTS\n" );
+
+  return( ( ( TEXTLEX_E_NOERR == err ) && ! failed ) ? 0 : 2 );
+}
+
+static void pretty_print( const char * string ) {
+  size_t i, il;
+  unsigned char x;
+
+  il = strlen( string );
+
+  for( i = 0 ; i < il ; i++ ) {
+    x = string[ i ];
+    printf( "%c", ( ( x >= 32 ) && ( x <= 127 ) ) ? x : '~' );
+  }
+}
+
+tTextLexErr PrintHandler::print( tTextLexCount token, const tTextLexBuffer * data, tTextLexCount length ) {
+  printf( ";  TOKEN %2d %15.15s (%2d) %1s %*.*s\n", token, token_name( token ),
+          length, ( ( length == TEST_BUFFER_SIZE ) ? "O" : " " ),
+          length, length, ( nullptr != data ) ? (const char *) data : "" );
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr parse_this( const char * string ) {
+  tTextLexErr err;
+  tTextLexBuffer buffer[ TEST_BUFFER_SIZE ];
+  PrintHandler handler;
+  dsd::TextLexer< PrintHandler > lexer( handler, buffer, TEST_BUFFER_SIZE );
+
+  do {
+    if( TEXTLEX_E_NOERR != ( err = lexer.update( (const tTextLexBuffer *) string, strlen( string ) ) ) ) {
+      break;
+    }
+
+    if( TEXTLEX_E_NOERR != ( err = lexer.final() ) ) {
+      break;
+    }
+  } while( 0 );
+
+  if( TEXTLEX_E_NOERR != err ) {
+    printf( ";  ERROR %d LINE %d OCTET %d\n", err, lexer.line(), lexer.octet() );
+  }
+
+  return( err );
+}
+
+/* lex()
+**
+** Lexes a string with a TextLexer, chunk octets at a time (or all at once
+** if chunk is 0.)
+*/
+
+template< class Handler >
+static tTextLexErr lex( Handler & handler, const char * string, size_t chunk, tTextLexCount size ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexBuffer buffer[ TEST_BUFFER_SIZE ];
+  dsd::TextLexer< Handler > lexer( handler, buffer, size );
+  size_t length = strlen( string );
+  size_t offset, piece;
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += piece ) {
+    piece = ( ( 0 == chunk ) || ( length - offset < chunk ) ) ? length - offset : chunk;
+    err = lexer.update( (const tTextLexBuffer *) string + offset, piece );
+  }
+
+  return( ( TEXTLEX_E_NOERR == err ) ? lexer.final() : err );
+}
+
+/* lex_c()
+**
+** Does the same thing with the C lexxer's span callback.
+*/
+
+static tTextLexErr lex_c( std::string & record, const char * string, size_t chunk, tTextLexCount size ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexBuffer buffer[ TEST_BUFFER_SIZE ];
+  tTextLexContext context;
+  tTextLexExtension extension;
+  size_t length = strlen( string );
+  size_t offset, piece;
+
+  textlex_init( & context, buffer, size );
+  textlex_extend( & context, & extension );
+  extension.span = record_span;
+  c_record = & record;
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += piece ) {
+    piece = ( ( 0 == chunk ) || ( length - offset < chunk ) ) ? length - offset : chunk;
+    err = textlex_update( & context, (tTextLexBuffer *) string + offset, piece );
+  }
+
+  return( ( TEXTLEX_E_NOERR == err ) ? textlex_final( & context ) : err );
+}
+
+static tTextLexErr record_span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  * c_record += std::to_string( token ) + ":" + std::string( (const char *) data, length ) + "|";
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* without_comments()
+**
+** Takes the comments and annotations (and the END tokens after them) out of
+** a record.
+*/
+
+static std::string without_comments( const std::string & record ) {
+  std::string out;
+  size_t start, stop;
+  int skip_end = 0;
+
+  for( start = 0; start < record.size(); start = stop + 1 ) {
+    stop = record.find( '|', start );
+    std::string entry = record.substr( start, stop - start + 1 );
+    unsigned int token = (unsigned int) std::stoul( entry );
+
+    if( ( TEXTLEX_T_COMMENT == token ) || ( TEXTLEX_T_ANNOTATION == token ) ) {
+      skip_end = 1;
+    } else if( skip_end && ( TEXTLEX_T_END == token ) ) {
+      skip_end = 0;
+    } else {
+      out += entry;
+    }
+  }
+
+  return( out );
+}
+
+static const char * token_name( unsigned int token ) {
+  static const char * tokens [] = {
+    "END",
+    "COMMENT",
+    "ANNOTATION",
+    "LITERAL",
+    "INTEGER",
+    "FLOAT",
+    "HEX",
+    "STRING",
+    "BASE64",
+    "ARRAY_OPEN",
+    "ARRAY_CLOSE",
+    "MAP_OPEN",
+    "MAP_CLOSE",
+    "EQUALS",
+    "--UNDEFINED--"
+  };
+
+  return( ( token < TEXTLEX_C_TOKENS ) ? tokens[ token ] : tokens[ TEXTLEX_C_TOKENS ] );
+}
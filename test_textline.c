@@ -0,0 +1,334 @@
+/* test_textline.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests the lexxer's line and octet counts. It lexes each of
+** the fixtures in test_textlex.h (and a few more with lots of line feeds
+** and errors in them) in pieces of several sizes, calling
+** textlex_position() in the token callback, and checks line and octet
+** against a count it makes itself in the callback, after each call to
+** textlex_update() and after textlex_final(). Then it checks batch and
+** pull mode give each token the same line and octet the token callback
+** saw. Last, it checks textscan_count() with each scanner the CPU has.
+**
+** Linked with textlex.o, it tests the ordinary lexxer (and that its
+** idea of where it is matches this program's.) Compiled with
+** -DTEXTLEX_LAZY_LINES and linked with a textlex.o compiled the same way,
+** it tests the lazy line counts; linked with textlex_lazy_dfa.o, it tests
+** the table driven lexxer's.
+*/
+
+/* Macro Definitions */
+
+#define TEST_RECORD 65536
+#define TEST_BATCH  4
+
+/* File Includes */
+
+#include <stdio.h>
+#include <string.h>
+#include "textlex.h"
+#include "textscan.h"
+
+/* Function Prototypes */
+
+static size_t push( char * record, const char * text, size_t chunk, int batch );
+static size_t pull( char * record, const char * text, size_t chunk );
+static int test_count( void );
+static void where( size_t length, int reading, tTextLexCount * line, tTextLexCount * octet );
+static int check( tTextLexContext * context, int reading );
+static tTextLexErr token_callback( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr batch_callback( tTextLexContext * context, tTextLexToken * tokens, tTextLexCount count );
+
+/* Global Variables */
+
+static const char * fixtures [] = {
+#include "test_textlex.h"
+  "\n\n[ 1\n 2\r\n \"a\" ]\n",
+  "# one\n# two\n\n\n  *true\n",
+  "{ \"k\" =\n 1.5e\n }",
+  "( 0a\n 0b # c\n 0c )\n( 0",
+  "\"line\nfeed\"",
+  "[\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n\n 1 ]",
+  "@t\n\n @",
+  NULL
+};
+
+static const char * text;
+static char * recorded;
+static size_t recorded_length;
+static unsigned int mismatched;
+
+int main( int argc, char * argv [] ) {
+  static const size_t chunks [] = { 0, 1, 2, 3, 7, 64 };
+  static char expected[ TEST_RECORD ];
+  static char actual[ TEST_RECORD ];
+  unsigned int i, k;
+  size_t expected_length, actual_length;
+  int failed = 0, bad;
+
+  printf( "; BEGIN TESTS\n" );
+
+  for( k = 0; k < sizeof( chunks ) / sizeof( chunks[ 0 ] ); k++ ) {
+    bad = 0;
+    mismatched = 0;
+
+    for( i = 0; NULL != fixtures[ i ]; i++ ) {
+      expected_length = push( expected, fixtures[ i ], 0, 0 );
+
+      actual_length = push( actual, fixtures[ i ], chunks[ k ], 0 );
+      if( ( expected_length != actual_length ) || ( 0 != memcmp( expected, actual, expected_length ) ) ) {
+        printf( ";  fixture %u token\n;    %.*s\n;    %.*s\n", i, (int) expected_length, expected, (int) actual_length, actual );
+        bad = 1;
+      }
+
+      actual_length = push( actual, fixtures[ i ], chunks[ k ], 1 );
+      if( ( expected_length != actual_length ) || ( 0 != memcmp( expected, actual, expected_length ) ) ) {
+        printf( ";  fixture %u batch\n;    %.*s\n;    %.*s\n", i, (int) expected_length, expected, (int) actual_length, actual );
+        bad = 1;
+      }
+
+      actual_length = pull( actual, fixtures[ i ], chunks[ k ] );
+      if( ( expected_length != actual_length ) || ( 0 != memcmp( expected, actual, expected_length ) ) ) {
+        printf( ";  fixture %u pull\n;    %.*s\n;    %.*s\n", i, (int) expected_length, expected, (int) actual_length, actual );
+        bad = 1;
+      }
+    }
+
+    if( 0 != mismatched ) {
+      printf( ";  %u positions didn't match\n", mismatched );
+      bad = 1;
+    }
+
+    printf( "; TEST LINES chunk %2zu %s\n", chunks[ k ], bad ? "FAILED" : "OK" );
+    failed |= bad;
+  }
+
+  failed |= test_count();
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+/* push()
+**
+** Lexes the text chunk octets at a time (or all at once if chunk is 0)
+** with the token callback (or in batch mode, if batch is set), writing
+** each token's line and octet into record, followed by the error and where
+** the lexxer stopped. Returns the length of the record.
+*/
+
+static size_t push( char * record, const char * source, size_t chunk, int batch ) {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ 80 ];
+  tTextLexToken tokens[ TEST_BATCH ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t length = strlen( source );
+  size_t offset, piece;
+
+  text = source;
+  recorded = record;
+  recorded_length = 0;
+
+  textlex_init( & context, buffer, sizeof( buffer ) );
+  textlex_extend( & context, & extension );
+  if( batch ) {
+    extension.batch = batch_callback;
+    extension.tokens = tokens;
+    extension.capacity = TEST_BATCH;
+  } else {
+    context.token = token_callback;
+  }
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += piece ) {
+    piece = ( ( 0 == chunk ) || ( length - offset < chunk ) ) ? length - offset : chunk;
+    err = textlex_update( & context, (tTextLexBuffer *) source + offset, (tTextLexCount) piece );
+    mismatched += check( & context, TEXTLEX_E_NOERR != err );
+#ifdef TEXTLEX_LAZY_LINES
+    mismatched += ( offset != context.offset );
+#endif
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textlex_final( & context );
+    mismatched += check( & context, 0 );
+#ifdef TEXTLEX_LAZY_LINES
+    mismatched += ( length != context.offset );
+#endif
+  }
+
+  recorded_length += sprintf( recorded + recorded_length, "E%u@%u.%u|", err, context.line, context.octet );
+
+  return( recorded_length );
+}
+
+/* pull()
+**
+** Does the same thing with textlex_next().
+*/
+
+static size_t pull( char * record, const char * source, size_t chunk ) {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ 80 ];
+  tTextLexToken token;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t length = strlen( source );
+  size_t offset = 0, piece;
+  int finished = 0;
+
+  recorded_length = 0;
+
+  textlex_init( & context, buffer, sizeof( buffer ) );
+  textlex_extend( & context, & extension );
+
+  while( 1 ) {
+    err = textlex_next( & context, & token );
+
+    if( TEXTLEX_E_NOERR == err ) {
+      recorded_length += sprintf( record + recorded_length, "%u@%u.%u|", token.token, token.line, token.octet );
+    } else if( TEXTLEX_E_MORE != err ) {
+      break;
+    } else if( offset < length ) {
+      piece = ( ( 0 == chunk ) || ( length - offset < chunk ) ) ? length - offset : chunk;
+      textlex_feed( & context, (tTextLexBuffer *) source + offset, piece );
+      offset += piece;
+    } else if( ! finished ) {
+      finished = 1;
+      if( TEXTLEX_E_NOERR != ( err = textlex_final( & context ) ) ) {
+        break;
+      }
+    } else {
+      err = TEXTLEX_E_NOERR;
+      break;
+    }
+  }
+
+  recorded_length += sprintf( record + recorded_length, "E%u@%u.%u|", err, context.line, context.octet );
+
+  return( recorded_length );
+}
+
+/* test_count()
+**
+** textscan_count() against a plain loop, for every length up to 100 and
+** every starting point in a block of text with line feeds scattered
+** through it.
+*/
+
+static int test_count( void ) {
+  static const unsigned int isas [] = { TEXTSCAN_ISA_SCALAR, TEXTSCAN_ISA_SSE2, TEXTSCAN_ISA_AVX2, TEXTSCAN_ISA_NEON };
+  unsigned char data[ 128 ];
+  unsigned long seed = 2026;
+  size_t start, length, i, count, after, expected_count, expected_after;
+  unsigned int k, selected;
+  int failed = 0, bad;
+
+  for( i = 0; i < sizeof( data ); i++ ) {
+    seed = seed * 1103515245UL + 12345UL;
+    data[ i ] = ( 0 == ( ( seed >> 16 ) % 5 ) ) ? '\n' : (unsigned char) ( 'a' + ( seed >> 20 ) % 26 );
+  }
+
+  for( k = 0; k < sizeof( isas ) / sizeof( isas[ 0 ] ); k++ ) {
+    if( isas[ k ] != ( selected = textscan_select( isas[ k ] ) ) ) {
+      continue;
+    }
+
+    bad = 0;
+
+    for( start = 0; start < 8; start++ ) {
+      for( length = 0; length <= 100; length++ ) {
+        for( i = 0, expected_count = 0, expected_after = 0; i < length; i++ ) {
+          if( '\n' == data[ start + i ] ) {
+            expected_count++;
+            expected_after = i + 1;
+          }
+        }
+
+        count = textscan_count( data + start, length, '\n', & after );
+        if( ( expected_count != count ) || ( expected_after != after ) ) {
+          bad = 1;
+        }
+      }
+    }
+
+    printf( "; TEST COUNT %-6s %s\n", textscan_name( selected ), bad ? "FAILED" : "OK" );
+    failed |= bad;
+  }
+
+  textscan_select( TEXTSCAN_ISA_AUTO );
+
+  return( failed );
+}
+
+/* where()
+**
+** Works out where the lexxer is after reading length octets of the text,
+** the way the octet-at-a-time loop does it: line counts the line feeds
+** and octet counts the octets since the last one, starting with the line
+** feed itself. If reading is set, the last octet is still being read and
+** hasn't been counted in octet yet.
+*/
+
+static void where( size_t length, int reading, tTextLexCount * line, tTextLexCount * octet ) {
+  size_t i;
+
+  * line = 0;
+  * octet = 0;
+
+  for( i = 0; i < length; i++ ) {
+    if( '\n' == text[ i ] ) {
+      ( * line )++;
+      * octet = 0;
+    }
+    if( ( ! reading ) || ( i + 1 < length ) ) {
+      ( * octet )++;
+    }
+  }
+}
+
+/* check()
+**
+** Returns 1 if the context's line and octet aren't what where() says.
+*/
+
+static int check( tTextLexContext * context, int reading ) {
+  tTextLexCount line, octet;
+
+  where( (size_t) ( context->extension->offset + context->bytes_read ), reading, & line, & octet );
+
+  if( ( line != context->line ) || ( octet != context->octet ) ) {
+    printf( ";  at %llu: %u.%u not %u.%u\n", context->extension->offset + context->bytes_read, context->line, context->octet, line, octet );
+    return( 1 );
+  }
+
+  return( 0 );
+}
+
+/* token_callback()
+**
+** Asks where the lexxer is, checks it and records it. In textlex_final(),
+** bytes_read is 0 and the whole text has been read.
+*/
+
+static tTextLexErr token_callback( tTextLexContext * context, tTextLexCount token ) {
+  textlex_position( context );
+  mismatched += check( context, 0 != context->bytes_read );
+
+  recorded_length += sprintf( recorded + recorded_length, "%u@%u.%u|", token, context->line, context->octet );
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr batch_callback( tTextLexContext * context, tTextLexToken * tokens, tTextLexCount count ) {
+  tTextLexCount i;
+
+  for( i = 0; i < count; i++ ) {
+    recorded_length += sprintf( recorded + recorded_length, "%u@%u.%u|", tokens[ i ].token, tokens[ i ].line, tokens[ i ].octet );
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
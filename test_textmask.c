@@ -0,0 +1,193 @@
+/* test_textmask.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests the token mask. It lexes each of the fixtures in
+** test_textlex.h (and a few with errors in them) with everything wanted,
+** takes the comments, the annotations and the TEXTLEX_T_END after each out
+** of what it got, and checks that's what it gets with them masked out:
+** the same tokens, lexemes, lines, octets and errors. It does that in
+** pieces of several sizes, with a buffer big enough for every lexeme and
+** one small enough that long ones overflow. Then it checks a long comment
+** doesn't go to the overflow callback when it's masked out.
+**
+** Linked with textlex_dfa.o instead of textlex.o, it tests the table driven
+** lexxer's token mask.
+*/
+
+/* Macro Definitions */
+
+#define TEST_RECORD 65536
+
+#define TEST_M_SKIP ( TEXTLEX_M( TEXTLEX_T_COMMENT ) | TEXTLEX_M( TEXTLEX_T_ANNOTATION ) )
+
+/* File Includes */
+
+#include <stdio.h>
+#include <string.h>
+#include "textlex.h"
+
+/* Function Prototypes */
+
+static size_t lex( char * record, const char * text, size_t chunk, tTextLexCount size, unsigned int skip );
+static int test_overflow( void );
+static tTextLexErr token_callback( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr overflow_callback( tTextLexContext * context );
+
+/* Global Variables */
+
+static const char * fixtures [] = {
+#include "test_textlex.h"
+  "@t [ 1 2x ]",
+  "# comment\n@m { \"a\" = @ }",
+  "( 01 # odd\n 2 )",
+  "@annotation_that_is_long# comment that is long\r\n*nil",
+  NULL
+};
+
+static char * recorded;
+static size_t recorded_length;
+static int skipping;
+static unsigned int overflows;
+
+int main( int argc, char * argv [] ) {
+  static const tTextLexCount sizes [] = { 80, 5 };
+  static const size_t chunks [] = { 0, 1, 2, 3, 7 };
+  static char expected[ TEST_RECORD ];
+  static char actual[ TEST_RECORD ];
+  unsigned int i, j, k;
+  size_t expected_length, actual_length;
+  int failed = 0, bad;
+
+  printf( "; BEGIN TESTS\n" );
+
+  for( j = 0; j < sizeof( sizes ) / sizeof( sizes[ 0 ] ); j++ ) {
+    for( k = 0; k < sizeof( chunks ) / sizeof( chunks[ 0 ] ); k++ ) {
+      bad = 0;
+
+      for( i = 0; NULL != fixtures[ i ]; i++ ) {
+        expected_length = lex( expected, fixtures[ i ], chunks[ k ], sizes[ j ], 0 );
+        actual_length = lex( actual, fixtures[ i ], chunks[ k ], sizes[ j ], TEST_M_SKIP );
+
+        if( ( expected_length != actual_length ) || ( 0 != memcmp( expected, actual, expected_length ) ) ) {
+          printf( ";  fixture %u\n;    all  %.*s\n;    mask %.*s\n", i, (int) expected_length, expected, (int) actual_length, actual );
+          bad = 1;
+        }
+      }
+
+      printf( "; TEST MASK buffer %2u chunk %zu %s\n", (unsigned int) sizes[ j ], chunks[ k ], bad ? "FAILED" : "OK" );
+      failed |= bad;
+    }
+  }
+
+  failed |= test_overflow();
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+/* lex()
+**
+** Lexes text chunk octets at a time (or all at once if chunk is 0) with
+** the bits in skip cleared from the mask, writing the tokens into record.
+** With nothing masked, the comments and annotations are left out of the
+** record instead. Returns the length of the record.
+*/
+
+static size_t lex( char * record, const char * text, size_t chunk, tTextLexCount size, unsigned int skip ) {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ 80 ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t length = strlen( text );
+  size_t offset, piece;
+
+  recorded = record;
+  recorded_length = 0;
+  skipping = 0;
+
+  textlex_init( & context, buffer, size );
+  textlex_extend( & context, & extension );
+  context.token = token_callback;
+  extension.wanted &= ~ skip;
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += piece ) {
+    piece = ( ( 0 == chunk ) || ( length - offset < chunk ) ) ? length - offset : chunk;
+    err = textlex_update( & context, (tTextLexBuffer *) text + offset, (tTextLexCount) piece );
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textlex_final( & context );
+  }
+
+  recorded_length += sprintf( recorded + recorded_length, "E%u@%u.%u|", err, context.line, context.octet );
+
+  return( recorded_length );
+}
+
+/* test_overflow()
+**
+** A comment ten times longer than the buffer, masked out, doesn't call the
+** overflow callback; the string after it still does.
+*/
+
+static int test_overflow( void ) {
+  static const char text [] = "# abcdefghijklmnopqrstuvwxyzabcdefghijklmnopqrstuvw\n\"0123456789\"\n";
+  static char record[ TEST_RECORD ];
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ 5 ];
+  tTextLexErr err;
+  int bad;
+
+  recorded = record;
+  recorded_length = 0;
+  overflows = 0;
+
+  textlex_init( & context, buffer, sizeof( buffer ) );
+  textlex_extend( & context, & extension );
+  context.token = token_callback;
+  context.overflow = overflow_callback;
+  extension.wanted &= ~ TEXTLEX_M( TEXTLEX_T_COMMENT );
+
+  err = textlex_update( & context, (tTextLexBuffer *) text, sizeof( text ) - 1 );
+  bad = ( TEXTLEX_E_NOERR != err ) || ( 2 != overflows ) || ( NULL != memchr( record, 'q', recorded_length ) ) ||
+    ( NULL == memchr( record, '7', recorded_length ) );
+
+  printf( "; TEST MASK OVERFLOW %u calls %s\n", overflows, bad ? "FAILED" : "OK" );
+
+  return( bad );
+}
+
+/* token_callback()
+**
+** Records the token unless it's a comment or an annotation, or the
+** TEXTLEX_T_END after one (so with nothing masked, it records what it
+** should get with them masked.)
+*/
+
+static tTextLexErr token_callback( tTextLexContext * context, tTextLexCount token ) {
+  if( ( TEXTLEX_T_COMMENT == token ) || ( TEXTLEX_T_ANNOTATION == token ) ) {
+    skipping = 1;
+    return( TEXTLEX_E_NOERR );
+  }
+
+  if( skipping && ( TEXTLEX_T_END == token ) ) {
+    skipping = 0;
+    return( TEXTLEX_E_NOERR );
+  }
+
+  recorded_length += sprintf( recorded + recorded_length, "%u@%u.%u:", token, context->line, context->octet );
+  memcpy( recorded + recorded_length, context->buffer, context->index );
+  recorded_length += context->index;
+  recorded[ recorded_length++ ] = '|';
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr overflow_callback( tTextLexContext * context ) {
+  overflows++;
+  return( textlex_default_overflow( context ) );
+}
@@ -0,0 +1,378 @@
+/* test_textnum.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests the number converter and the lexxer's typed number
+** mode. It converts a list of awkward numbers and checks them against
+** strtoll(), strtoull() and strtod(), then does the same for a million
+** random floats. Then it lexes a document made of those numbers (with
+** comments, strings and base16 strings in between) with the number callback
+** set, in pieces of several sizes, with and without span mode and with
+** buffers small enough that the longer numbers overflow them.
+**
+** Linked with textlex_dfa.o instead of textlex.o, it tests the table driven
+** lexxer's typed number mode.
+*/
+
+/* Macro Definitions */
+
+#define TEST_RANDOM    1000000
+#define TEST_DOCUMENT  4096
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <math.h>
+#include "textlex.h"
+#include "textnum.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  unsigned int    count;
+  unsigned int    base16;
+  unsigned int    failed;
+  int             split;
+} tTestRun;
+
+/* Function Prototypes */
+
+static void expect( const char * text, tTextNumValue * value );
+static int same( const tTextNumValue * a, const tTextNumValue * b, unsigned int token );
+static int test_convert( void );
+static int test_random( void );
+static int test_lexer( tTextLexCount size, int span, size_t chunk );
+static tTextLexErr number_callback( tTextLexContext * context, tTextLexCount token, tTextNumValue * value, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr token_callback( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr span_callback( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+
+/* Global Variables */
+
+static char * numbers [] = {
+  "0", "-0", "1", "-1", "90125", "9223372036854775807", "-9223372036854775808",
+  "9223372036854775808", "-9223372036854775809", "123456789012345678901234567890",
+  "3.14", "-2.3", "6.02E23", "-1.602e-19", "-12.0123012301230123", "-3.1345324532453E568",
+  "1.0e-400", "2.2250738585072011e-308", "4.9406564584124654e-324", "1.7976931348623157e308",
+  "1.7976931348623159e308", "0.1000000000000000055511151231257827021181583404541015625",
+  "9007199254740993.0", "9007199254740993.000000000000000000001", "7.2057594037927933e16", "0.000000000000000000000000000001",
+  "$0", "$CAFEB0EF", "$ffffffffffffffff", "$10000000000000000", "$00000000000000000001",
+  "42", NULL
+};
+
+static char * separators [] = {
+  " ", " # a comment\n", " ( CA FE # ) \n 00 ) ", " \"a string\" ", "\r\n", " [ ", " ] ", NULL
+};
+
+static tTestRun run;
+
+int main( int argc, char * argv [] ) {
+  static const tTextLexCount sizes [] = { 256, 8, 4 };
+  static const size_t chunks [] = { 0, 1, 2, 5 };
+  unsigned int i, j, k;
+  int failed = 0;
+
+  printf( "; BEGIN TESTS\n" );
+
+  failed |= test_convert();
+  failed |= test_random();
+
+  for( i = 0; i < sizeof( sizes ) / sizeof( sizes[ 0 ] ); i++ ) {
+    for( j = 0; j < 2; j++ ) {
+      for( k = 0; k < sizeof( chunks ) / sizeof( chunks[ 0 ] ); k++ ) {
+        failed |= test_lexer( sizes[ i ], j, chunks[ k ] );
+      }
+    }
+  }
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+/* expect()
+**
+** Works out what a number should convert to with the C library. HEX numbers
+** start with a '$'.
+*/
+
+static void expect( const char * text, tTextNumValue * value ) {
+  memset( value, 0, sizeof( tTextNumValue ) );
+  errno = 0;
+
+  if( '$' == text[ 0 ] ) {
+    value->natural = strtoull( text + 1, NULL, 16 );
+    value->overflow = ( ERANGE == errno );
+    value->real = (double) value->natural;
+    return;
+  }
+
+  value->real = strtod( text, NULL );
+
+  if( NULL == strpbrk( text, ".eE" ) ) {
+    errno = 0;
+    value->integer = strtoll( text, NULL, 10 );
+    value->overflow = ( ERANGE == errno );
+  } else {
+    value->overflow = ( ( HUGE_VAL == value->real ) || ( -HUGE_VAL == value->real ) );
+  }
+}
+
+/* same()
+**
+** Compares the parts of two values that matter for a token. Doubles are
+** compared bit for bit, so -0.0 isn't 0.0, but if a is marked inexact its
+** double may be the one next to b's.
+*/
+
+static int same( const tTextNumValue * a, const tTextNumValue * b, unsigned int token ) {
+  unsigned long long x, y;
+
+  memcpy( & x, & a->real, sizeof( double ) );
+  memcpy( & y, & b->real, sizeof( double ) );
+  if( a->inexact && ( ( x == y + 1 ) || ( x + 1 == y ) ) ) {
+    y = x;
+  }
+
+  if( ( a->overflow != b->overflow ) || ( x != y ) ) {
+    return( 0 );
+  }
+
+  switch( token ) {
+  case TEXTLEX_T_INTEGER:
+    return( a->integer == b->integer );
+
+  case TEXTLEX_T_HEX:
+    return( a->natural == b->natural );
+  }
+
+  return( 1 );
+}
+
+/* test_convert()
+**
+** Converts each of the numbers with textnum_scan() and friends.
+*/
+
+static int test_convert( void ) {
+  tTextNumDigits digits;
+  tTextNumValue value, expected;
+  unsigned int i, token;
+  const char * text;
+  size_t length;
+  int failed = 0;
+
+  for( i = 0; NULL != numbers[ i ]; i++ ) {
+    text = numbers[ i ];
+    length = strlen( text );
+    expect( text, & expected );
+
+    if( '$' == text[ 0 ] ) {
+      token = TEXTLEX_T_HEX;
+      textnum_scan( & digits, (const unsigned char *) text + 1, length - 1, 1 );
+      textnum_hex( & digits, & value );
+      printf( "; TEST CONVERT %-32.32s HEX     %llu%s\n", text, value.natural, value.overflow ? " OVERFLOW" : "" );
+    } else if( NULL == strpbrk( text, ".eE" ) ) {
+      token = TEXTLEX_T_INTEGER;
+      textnum_scan( & digits, (const unsigned char *) text, length, 0 );
+      textnum_integer( & digits, (const unsigned char *) text, length, & value );
+      printf( "; TEST CONVERT %-32.32s INTEGER %lld%s\n", text, value.integer, value.overflow ? " OVERFLOW" : "" );
+    } else {
+      token = TEXTLEX_T_FLOAT;
+      textnum_scan( & digits, (const unsigned char *) text, length, 0 );
+      textnum_float( & digits, (const unsigned char *) text, length, & value );
+      printf( "; TEST CONVERT %-32.32s FLOAT   %.17g%s\n", text, value.real, value.overflow ? " OVERFLOW" : "" );
+    }
+
+    if( ! same( & value, & expected, token ) ) {
+      printf( ";  MISMATCH expected %lld %llu %.17g %u\n", expected.integer, expected.natural, expected.real, expected.overflow );
+      failed = 1;
+    }
+  }
+
+  return( failed );
+}
+
+/* test_random()
+**
+** Converts random floats with up to 25 digits and exponents up to 400 and
+** checks them against strtod(), once with their text and once without it
+** (where they may only be one unit in the last place off if they're marked
+** inexact.) The generator is seeded the same way every time, so a failure
+** can be reproduced.
+*/
+
+static int test_random( void ) {
+  unsigned long long state = 88172645463325252ULL;
+  unsigned long long r;
+  tTextNumDigits digits;
+  tTextNumValue value, expected;
+  unsigned long i, bad = 0, inexact = 0;
+  unsigned int count, point, k;
+  char text[ 64 ];
+  size_t length;
+
+  for( i = 0; i < TEST_RANDOM; i++ ) {
+    state ^= state << 13;
+    state ^= state >> 7;
+    state ^= state << 17;
+    r = state;
+
+    length = 0;
+    if( r & 1 ) {
+      text[ length++ ] = '-';
+    }
+    count = 1 + ( r >> 1 ) % 25;
+    point = ( r >> 8 ) % count;
+    for( k = 0; k < count; k++ ) {
+      if( ( 0 != point ) && ( k == point ) ) {
+        text[ length++ ] = '.';
+      }
+      state ^= state << 13;
+      state ^= state >> 7;
+      state ^= state << 17;
+      text[ length++ ] = '0' + state % 10;
+    }
+    if( 0 != ( r >> 16 ) % 3 ) {
+      length += sprintf( text + length, "e%s%u", ( r & 2 ) ? "-" : "", (unsigned int) ( ( r >> 24 ) % 400 ) );
+    }
+    text[ length ] = '\0';
+
+    memset( & expected, 0, sizeof( tTextNumValue ) );
+    expected.real = strtod( text, NULL );
+    expected.overflow = ( ( HUGE_VAL == expected.real ) || ( -HUGE_VAL == expected.real ) );
+
+    textnum_scan( & digits, (const unsigned char *) text, length, 0 );
+    textnum_float( & digits, (const unsigned char *) text, length, & value );
+    if( value.inexact || ! same( & value, & expected, TEXTLEX_T_FLOAT ) ) {
+      if( bad++ < 10 ) {
+        printf( ";  MISMATCH %s %.17g %.17g\n", text, expected.real, value.real );
+      }
+    }
+
+    textnum_float( & digits, NULL, 0, & value );
+    inexact += value.inexact;
+    if( ! same( & value, & expected, TEXTLEX_T_FLOAT ) ) {
+      if( bad++ < 10 ) {
+        printf( ";  MISMATCH %s without text %.17g %.17g\n", text, expected.real, value.real );
+      }
+    }
+  }
+
+  printf( "; TEST RANDOM %d floats, %lu mismatches, %lu inexact without text\n", TEST_RANDOM, bad, inexact );
+
+  return( 0 != bad );
+}
+
+/* test_lexer()
+**
+** Lexes the numbers (with the separators between them) in pieces of chunk
+** octets (or all at once if chunk is zero) with a size octet buffer. The
+** number callback checks each number it gets against the list.
+*/
+
+static int test_lexer( tTextLexCount size, int span, size_t chunk ) {
+  static char document[ TEST_DOCUMENT ];
+  tTextLexBuffer buffer[ 256 ];
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t length = 0, offset, piece;
+  unsigned int i, separated = 0;
+
+  for( i = 0; NULL != numbers[ i ]; i++ ) {
+    length += sprintf( document + length, "%s", numbers[ i ] );
+    if( NULL != numbers[ i + 1 ] ) {
+      length += sprintf( document + length, "%s", separators[ i % 7 ] );
+      separated += ( 2 == i % 7 );
+    }
+  }
+
+  memset( & run, 0, sizeof( tTestRun ) );
+  run.split = ( size < 256 );
+
+  textlex_init( & context, buffer, size );
+  textlex_extend( & context, & extension );
+  extension.number = number_callback;
+  if( span ) {
+    extension.span = span_callback;
+  } else {
+    context.token = token_callback;
+  }
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += piece ) {
+    piece = ( ( 0 == chunk ) || ( chunk > length - offset ) ) ? length - offset : chunk;
+    err = textlex_update( & context, (tTextLexBuffer *) document + offset, piece );
+  }
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textlex_final( & context );
+  }
+
+  printf( "; TEST LEXER buffer %3u %-5s chunk %zu : %u numbers", (unsigned int) size, span ? "span" : "token", chunk, run.count );
+
+  if( ( TEXTLEX_E_NOERR != err ) || run.failed || ( NULL != numbers[ run.count ] ) || ( run.base16 < separated ) ) {
+    printf( " FAILED (err %u, base16 %u)\n", (unsigned int) err, run.base16 );
+    return( 1 );
+  }
+
+  printf( " OK\n" );
+
+  return( 0 );
+}
+
+/* number_callback()
+**
+** Checks the next number in the list came out right. Only numbers whose
+** text was thrown away may be marked inexact.
+*/
+
+static tTextLexErr number_callback( tTextLexContext * context, tTextLexCount token, tTextNumValue * value, tTextLexBuffer * data, tTextLexCount length ) {
+  tTextNumValue expected;
+  const char * text = numbers[ run.count ];
+  unsigned int type;
+
+  if( NULL == text ) {
+    run.failed = 1;
+    return( TEXTLEX_E_ERROR );
+  }
+
+  type = ( '$' == text[ 0 ] ) ? TEXTLEX_T_HEX : ( NULL == strpbrk( text, ".eE" ) ) ? TEXTLEX_T_INTEGER : TEXTLEX_T_FLOAT;
+  expect( text, & expected );
+
+  if( ( type != token ) || ! same( value, & expected, token ) || ( value->inexact && ! run.split ) ) {
+    printf( ";  MISMATCH %s got %u %lld %llu %.17g %u %u\n", text, (unsigned int) token, value->integer, value->natural, value->real,
+            value->overflow, value->inexact );
+    run.failed = 1;
+  }
+
+  run.count++;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* token_callback() and span_callback()
+**
+** Numbers shouldn't come here, but base16 strings should.
+*/
+
+static tTextLexErr token_callback( tTextLexContext * context, tTextLexCount token ) {
+  return( span_callback( context, token, context->buffer, context->index ) );
+}
+
+static tTextLexErr span_callback( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  switch( token ) {
+  case TEXTLEX_T_INTEGER:
+  case TEXTLEX_T_FLOAT:
+    run.failed = 1;
+    break;
+
+  case TEXTLEX_T_HEX:
+    run.base16++;
+    break;
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
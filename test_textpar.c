@@ -0,0 +1,285 @@
+/* test_textpar.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program checks textpar_update() gives the same tokens as
+** textlex_update() does. Each test document is lexed once with
+** textlex_update() and then with textpar_update() using several different
+** thread counts, buffer sizes and callbacks. The tokens (and the line and
+** octet of each END token) are written to a transcript in memory and the
+** transcripts are compared.
+**
+** Lexemes longer than the buffer are delivered in pieces; where the pieces
+** get split doesn't matter, so transcripts join them back together before
+** comparing.
+*/
+
+/* Macro Definitions */
+
+#define TEST_DOCUMENT_SIZE ( 2 * 1024 * 1024 )
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "textpar.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  unsigned char * data;
+  size_t          length;
+  size_t          size;
+  int             pending;
+} tTranscript;
+
+/* Function Prototypes */
+
+static unsigned char * make_document( unsigned char * seed, size_t seed_length, size_t * length );
+static unsigned char * load_file( char * path, size_t * length );
+static int compare( char * name, unsigned char * document, size_t length );
+static int lex( tTranscript * transcript, unsigned char * document, size_t length, unsigned int threads, tTextLexCount size, int spanning );
+static void append( tTranscript * transcript, void * data, size_t length );
+static void record( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr _token( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr _span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+
+/* Global Variables */
+
+/* Strings, base64 and base16 values can all carry on past the end of a line,
+** so this one makes sure chunks get started in every state they can be.
+*/
+
+static char * multiline =
+  "{\n"
+  "  \"key\" = \"a string\n"
+  "that goes on \\\"for\\\" a few\n"
+  "lines\"\n"
+  "  \"b64\" = 'OTyqgu7A\n"
+  "  ca5sDCBzEoR23A=='\n"
+  "  \"b16\" = ( 41 42 43 44 # ABCD\n"
+  "    45 46 47 48 # EFGH\n"
+  "  )\n"
+  "  \"numbers\" = [ 1 -1 2.3 -2.3e-5 $CAFEB0EF *nil @t 90125 ]\n"
+  "}\n";
+
+static unsigned int threads [] = { 1, 2, 3, 4, 8, 0 };
+static tTextLexCount sizes [] = { 80, 4096 };
+
+static tTranscript * current = NULL;
+
+int main( int argc, char * argv [] ) {
+  unsigned char * seed;
+  unsigned char * document;
+  size_t seed_length, length;
+  int failed = 0;
+
+  printf( "; BEGIN TESTS\n" );
+
+  if( NULL != ( seed = load_file( "example.dsd", & seed_length ) ) ) {
+    document = make_document( seed, seed_length, & length );
+    failed |= compare( "example.dsd", document, length );
+    free( document );
+    free( seed );
+  } else {
+    printf( ";  ERROR can't read example.dsd\n" );
+    failed = 1;
+  }
+
+  document = make_document( (unsigned char *) multiline, strlen( multiline ), & length );
+  failed |= compare( "multiline", document, length );
+
+  /* Put a syntax error about three quarters of the way through. */
+
+  memcpy( document + ( length / 4 ) * 3, "\n?\n", 3 );
+  failed |= compare( "error", document, length );
+  free( document );
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+static unsigned char * make_document( unsigned char * seed, size_t seed_length, size_t * length ) {
+  unsigned char * document;
+
+  if( NULL == ( document = malloc( TEST_DOCUMENT_SIZE + seed_length + 1 ) ) ) {
+    fprintf( stderr, "%%TEST-F-MEMORY; Can't allocate test document.\n" );
+    exit( 2 );
+  }
+
+  for( * length = 0; * length < TEST_DOCUMENT_SIZE; * length += seed_length + 1 ) {
+    memcpy( document + * length, seed, seed_length );
+    document[ * length + seed_length ] = '\n';
+  }
+
+  return( document );
+}
+
+static unsigned char * load_file( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * data = NULL;
+  long size;
+
+  if( NULL == ( file = fopen( path, "rb" ) ) ) {
+    return( NULL );
+  }
+
+  do {
+    if( ( 0 != fseek( file, 0, SEEK_END ) ) || ( ( size = ftell( file ) ) <= 0 ) || ( 0 != fseek( file, 0, SEEK_SET ) ) ) {
+      break;
+    }
+
+    if( NULL == ( data = malloc( size ) ) ) {
+      break;
+    }
+
+    if( (size_t) size != fread( data, 1, size, file ) ) {
+      free( data );
+      data = NULL;
+      break;
+    }
+
+    * length = size;
+  } while( 0 );
+
+  fclose( file );
+
+  return( data );
+}
+
+static int compare( char * name, unsigned char * document, size_t length ) {
+  tTranscript expected, actual;
+  unsigned int t, s;
+  int spanning, failed = 0;
+
+  for( s = 0; s < sizeof( sizes ) / sizeof( sizes[ 0 ] ); s++ ) {
+    for( spanning = 0; spanning < 2; spanning++ ) {
+      memset( & expected, 0, sizeof( expected ) );
+      lex( & expected, document, length, 1, sizes[ s ], spanning );
+
+      for( t = 0; t < sizeof( threads ) / sizeof( threads[ 0 ] ); t++ ) {
+        memset( & actual, 0, sizeof( actual ) );
+        lex( & actual, document, length, threads[ t ], sizes[ s ], spanning );
+
+        if( ( expected.length == actual.length ) && ( 0 == memcmp( expected.data, actual.data, expected.length ) ) ) {
+          printf( "; TEST %-12s BUFFER %4d %5s THREADS %d OK\n", name, sizes[ s ], spanning ? "SPAN" : "TOKEN", threads[ t ] );
+        } else {
+          printf( "; TEST %-12s BUFFER %4d %5s THREADS %d MISMATCH\n", name, sizes[ s ], spanning ? "SPAN" : "TOKEN", threads[ t ] );
+          failed = 1;
+        }
+
+        free( actual.data );
+      }
+
+      free( expected.data );
+    }
+  }
+
+  return( failed );
+}
+
+/* lex()
+**
+** Lexes a document into a transcript. A thread count of one means use
+** textlex_update() instead of textpar_update(). The error code, line, octet
+** and bytes read go at the end of the transcript.
+*/
+
+static int lex( tTranscript * transcript, unsigned char * document, size_t length, unsigned int count, tTextLexCount size, int spanning ) {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexErr err;
+  tTextLexBuffer * buffer;
+  tTextLexCount status[ 4 ];
+
+  if( NULL == ( buffer = malloc( size ) ) ) {
+    fprintf( stderr, "%%TEST-F-MEMORY; Can't allocate buffer.\n" );
+    exit( 2 );
+  }
+
+  textlex_init( & context, buffer, size );
+
+  if( spanning ) {
+    textlex_extend( & context, & extension );
+    extension.span = _span;
+  } else {
+    context.token = _token;
+  }
+
+  current = transcript;
+
+  if( 1 == count ) {
+    err = textlex_update( & context, document, (tTextLexCount) length );
+  } else {
+    err = textpar_update( & context, document, length, count );
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textlex_final( & context );
+  }
+
+  status[ 0 ] = err;
+  status[ 1 ] = context.line;
+  status[ 2 ] = context.octet;
+  status[ 3 ] = ( TEXTLEX_E_NOERR == err ) ? 0 : context.bytes_read;
+  append( transcript, status, sizeof( status ) );
+
+  free( buffer );
+
+  return( err );
+}
+
+static void append( tTranscript * transcript, void * data, size_t length ) {
+  if( transcript->length + length > transcript->size ) {
+    for( transcript->size = ( 0 == transcript->size ) ? 65536 : transcript->size; transcript->size < transcript->length + length; transcript->size *= 2 ) {
+    }
+    if( NULL == ( transcript->data = realloc( transcript->data, transcript->size ) ) ) {
+      fprintf( stderr, "%%TEST-F-MEMORY; Can't grow transcript.\n" );
+      exit( 2 );
+    }
+  }
+
+  memcpy( transcript->data + transcript->length, data, length );
+  transcript->length += length;
+}
+
+/* record()
+**
+** The token number is only written at the start of a lexeme, so a lexeme
+** that arrives in several pieces looks the same as one that arrives all at
+** once.
+*/
+
+static void record( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  unsigned char code = (unsigned char) token;
+  tTextLexCount position[ 2 ];
+
+  if( TEXTLEX_T_END == token ) {
+    position[ 0 ] = context->line;
+    position[ 1 ] = context->octet;
+    append( current, & code, 1 );
+    append( current, position, sizeof( position ) );
+    current->pending = 0;
+    return;
+  }
+
+  if( ! current->pending ) {
+    append( current, & code, 1 );
+    current->pending = ( token > TEXTLEX_T_END ) && ( token < TEXTLEX_T_ARRAY_OPEN );
+  }
+
+  append( current, data, length );
+}
+
+static tTextLexErr _token( tTextLexContext * context, tTextLexCount token ) {
+  record( context, token, context->buffer, context->index );
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr _span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  record( context, token, data, length );
+  return( TEXTLEX_E_NOERR );
+}
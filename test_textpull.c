@@ -0,0 +1,264 @@
+/* test_textpull.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests the lexxer's pull mode. It lexes each of the fixtures
+** in test_textlex.h, and a few documents with errors in them, twice: once
+** with the token callback and once with textlex_feed() and textlex_next().
+** It does that in pieces of several sizes, with a buffer big enough for
+** every lexeme and one small enough that long ones overflow, and checks
+** both ways get the same tokens (with the same lexemes, lines and octets)
+** and the same errors. Then it checks textlex_update() picks up where it
+** left off after a callback yields.
+**
+** Linked with textlex_dfa.o instead of textlex.o, it tests the table driven
+** lexxer's pull mode.
+*/
+
+/* Macro Definitions */
+
+#define TEST_RECORD 65536
+
+/* File Includes */
+
+#include <stdio.h>
+#include <string.h>
+#include "textlex.h"
+
+/* Function Prototypes */
+
+static size_t push( char * record, const char * text, size_t chunk, tTextLexCount size );
+static size_t pull( char * record, const char * text, size_t chunk, tTextLexCount size );
+static size_t add( char * record, size_t used, tTextLexCount token, const tTextLexBuffer * data, tTextLexCount length,
+                   tTextLexCount line, tTextLexCount octet );
+static tTextLexErr token_callback( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr yield_callback( tTextLexContext * context, tTextLexCount token );
+static int test_yield( void );
+static int test_plain( void );
+
+/* Global Variables */
+
+static const char * fixtures [] = {
+#include "test_textlex.h"
+  "[ 1 2x ]",
+  "{ \"a\" = \"b\\q\" }",
+  "*nil *ni1",
+  "@t [ 3.14e ]",
+  NULL
+};
+
+static char * pushed;
+static size_t pushed_length;
+static unsigned int yields;
+
+int main( int argc, char * argv [] ) {
+  static const tTextLexCount sizes [] = { 80, 5 };
+  static const size_t chunks [] = { 0, 1, 2, 3, 7 };
+  static char expected[ TEST_RECORD ];
+  static char actual[ TEST_RECORD ];
+  unsigned int i, j, k;
+  size_t expected_length, actual_length;
+  int failed = 0, bad;
+
+  printf( "; BEGIN TESTS\n" );
+
+  for( j = 0; j < sizeof( sizes ) / sizeof( sizes[ 0 ] ); j++ ) {
+    for( k = 0; k < sizeof( chunks ) / sizeof( chunks[ 0 ] ); k++ ) {
+      bad = 0;
+
+      for( i = 0; NULL != fixtures[ i ]; i++ ) {
+        expected_length = push( expected, fixtures[ i ], chunks[ k ], sizes[ j ] );
+        actual_length = pull( actual, fixtures[ i ], chunks[ k ], sizes[ j ] );
+
+        if( ( expected_length != actual_length ) || ( 0 != memcmp( expected, actual, expected_length ) ) ) {
+          printf( ";  fixture %u\n;    push %.*s\n;    pull %.*s\n", i, (int) expected_length, expected, (int) actual_length, actual );
+          bad = 1;
+        }
+      }
+
+      printf( "; TEST PULL buffer %2u chunk %zu %s\n", (unsigned int) sizes[ j ], chunks[ k ], bad ? "FAILED" : "OK" );
+      failed |= bad;
+    }
+  }
+
+  failed |= test_yield();
+  failed |= test_plain();
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+/* push()
+**
+** Lexes text with the token callback, chunk octets at a time (or all at
+** once if chunk is 0), writing the tokens into record. Returns the length of
+** the record.
+*/
+
+static size_t push( char * record, const char * text, size_t chunk, tTextLexCount size ) {
+  tTextLexContext context;
+  tTextLexBuffer buffer[ 80 ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t length = strlen( text );
+  size_t offset, piece;
+
+  pushed = record;
+  pushed_length = 0;
+
+  textlex_init( & context, buffer, size );
+  context.token = token_callback;
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += piece ) {
+    piece = ( ( 0 == chunk ) || ( length - offset < chunk ) ) ? length - offset : chunk;
+    err = textlex_update( & context, (tTextLexBuffer *) text + offset, piece );
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textlex_final( & context );
+  }
+
+  if( TEXTLEX_E_NOERR != err ) {
+    pushed_length += sprintf( pushed + pushed_length, "E%u@%u.%u|", err, context.line, context.octet );
+  }
+
+  return( pushed_length );
+}
+
+/* pull()
+**
+** Does the same thing with textlex_next().
+*/
+
+static size_t pull( char * record, const char * text, size_t chunk, tTextLexCount size ) {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ 80 ];
+  tTextLexToken token;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t length = strlen( text );
+  size_t offset = 0, piece, used = 0;
+  int finished = 0;
+
+  textlex_init( & context, buffer, size );
+  textlex_extend( & context, & extension );
+
+  while( 1 ) {
+    err = textlex_next( & context, & token );
+
+    if( TEXTLEX_E_NOERR == err ) {
+      used = add( record, used, token.token, token.data, token.length, token.line, token.octet );
+    } else if( TEXTLEX_E_MORE != err ) {
+      break;
+    } else if( offset < length ) {
+      piece = ( ( 0 == chunk ) || ( length - offset < chunk ) ) ? length - offset : chunk;
+      textlex_feed( & context, (tTextLexBuffer *) text + offset, piece );
+      offset += piece;
+    } else if( ! finished ) {
+      finished = 1;
+      if( TEXTLEX_E_NOERR != ( err = textlex_final( & context ) ) ) {
+        break;
+      }
+    } else {
+      err = TEXTLEX_E_NOERR;
+      break;
+    }
+  }
+
+  if( TEXTLEX_E_NOERR != err ) {
+    used += sprintf( record + used, "E%u@%u.%u|", err, context.line, context.octet );
+  }
+
+  return( used );
+}
+
+static size_t add( char * record, size_t used, tTextLexCount token, const tTextLexBuffer * data, tTextLexCount length,
+                   tTextLexCount line, tTextLexCount octet ) {
+  used += sprintf( record + used, "%u@%u.%u:", token, line, octet );
+  memcpy( record + used, data, length );
+  used += length;
+  record[ used++ ] = '|';
+
+  return( used );
+}
+
+static tTextLexErr token_callback( tTextLexContext * context, tTextLexCount token ) {
+  pushed_length = add( pushed, pushed_length, token, context->buffer, context->index, context->line, context->octet );
+  return( TEXTLEX_E_NOERR );
+}
+
+/* test_yield()
+**
+** Lexes a document with a token callback that yields after every token,
+** restarting textlex_update() with the rest of the input each time, and
+** checks it gets the same tokens as lexing it all at once.
+*/
+
+static int test_yield( void ) {
+  static const char text [] = "@m { *a = [ 1 -2.5 $FF ] *b = \"xyz\" } # done\n";
+  static char expected[ 1024 ];
+  static char actual[ 1024 ];
+  tTextLexContext context;
+  tTextLexBuffer buffer[ 80 ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t expected_length, offset, length = strlen( text );
+  unsigned int updates = 0;
+  int bad;
+
+  expected_length = push( expected, text, 0, 80 );
+
+  pushed = actual;
+  pushed_length = 0;
+  yields = 0;
+
+  textlex_init( & context, buffer, 80 );
+  context.token = yield_callback;
+
+  for( offset = 0; offset < length; offset += context.bytes_read ) {
+    err = textlex_update( & context, (tTextLexBuffer *) text + offset, length - offset );
+    updates++;
+    if( ( TEXTLEX_E_NOERR != err ) && ( TEXTLEX_E_YIELD != err ) ) {
+      break;
+    }
+  }
+
+  if( ( TEXTLEX_E_NOERR == err ) || ( TEXTLEX_E_YIELD == err ) ) {
+    err = textlex_final( & context );
+  }
+
+  bad = ( TEXTLEX_E_NOERR != err ) || ( expected_length != pushed_length ) || ( 0 != memcmp( expected, actual, expected_length ) ) ||
+    ( updates < 10 );
+
+  printf( "; TEST YIELD %u tokens %u updates %s\n", yields, updates, bad ? "FAILED" : "OK" );
+
+  return( bad );
+}
+
+/* test_plain()
+**
+** Checks textlex_feed() and textlex_next() refuse a context without an
+** extension rather than keeping the tokens somewhere shared.
+*/
+
+static int test_plain( void ) {
+  tTextLexContext context;
+  tTextLexBuffer buffer[ 80 ];
+  tTextLexToken token;
+  int bad;
+
+  textlex_init( & context, buffer, 80 );
+
+  bad = ( TEXTLEX_E_ERROR != textlex_feed( & context, (tTextLexBuffer *) "1 ", 2 ) ) ||
+    ( TEXTLEX_E_ERROR != textlex_next( & context, & token ) );
+
+  printf( "; TEST PLAIN %s\n", bad ? "FAILED" : "OK" );
+
+  return( bad );
+}
+
+static tTextLexErr yield_callback( tTextLexContext * context, tTextLexCount token ) {
+  yields++;
+  token_callback( context, token );
+  return( TEXTLEX_E_YIELD );
+}
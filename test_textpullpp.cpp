@@ -0,0 +1,253 @@
+/* test_textpullpp.cpp
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests dsd::tokens(), the coroutine front end in
+** textpull.hpp. It lexes the fixtures in test_textlex.h (and a few
+** documents with errors in them) through the generator, with the reader
+** handing over pieces of several sizes, and checks it gets the same tokens
+** and errors the token callback does. Then it parses a record with a little
+** recursive descent parser written against the generator's iterator.
+*/
+
+/* Macro Definitions */
+
+#define TEST_BUFFER_SIZE 80
+
+/* File Includes */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "textpull.hpp"
+
+/* Structs, Typedefs, Unions & Enums */
+
+struct tTestRecord {
+  std::string name;
+  long size;
+  long sum;
+};
+
+/* Function Prototypes */
+
+static std::string push( const char * text, size_t chunk, tTextLexCount size );
+static std::string pull( const char * text, size_t chunk, tTextLexCount size );
+static void add( std::string & record, tTextLexCount token, const tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr token_callback( tTextLexContext * context, tTextLexCount token );
+static int test_descent();
+static bool parse_record( dsd::TokenStream::iterator & it, tTestRecord & record );
+
+/* Global Variables */
+
+static const char * fixtures [] = {
+#include "test_textlex.h"
+  "[ 1 2x ]",
+  "{ \"a\" = \"b\\q\" }",
+  "*nil *ni1",
+  nullptr
+};
+
+static std::string * pushed = nullptr;
+
+int main( int argc, char * argv [] ) {
+  static const tTextLexCount sizes [] = { TEST_BUFFER_SIZE, 5 };
+  static const size_t chunks [] = { 0, 1, 3, 7 };
+  unsigned int i, j, k;
+  int failed = 0;
+
+  printf( "; BEGIN TESTS\n" );
+
+  for( j = 0; j < sizeof( sizes ) / sizeof( sizes[ 0 ] ); j++ ) {
+    for( k = 0; k < sizeof( chunks ) / sizeof( chunks[ 0 ] ); k++ ) {
+      int bad = 0;
+
+      for( i = 0; nullptr != fixtures[ i ]; i++ ) {
+        std::string expected = push( fixtures[ i ], chunks[ k ], sizes[ j ] );
+        std::string actual = pull( fixtures[ i ], chunks[ k ], sizes[ j ] );
+
+        if( expected != actual ) {
+          printf( ";  fixture %u\n;    push %s\n;    pull %s\n", i, expected.c_str(), actual.c_str() );
+          bad = 1;
+        }
+      }
+
+      printf( "; TEST GENERATOR buffer %2u chunk %zu %s\n", (unsigned int) sizes[ j ], chunks[ k ], bad ? "FAILED" : "OK" );
+      failed |= bad;
+    }
+  }
+
+  failed |= test_descent();
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+static std::string push( const char * text, size_t chunk, tTextLexCount size ) {
+  std::string record;
+  tTextLexContext context;
+  tTextLexBuffer buffer[ TEST_BUFFER_SIZE ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t length = strlen( text );
+  size_t offset, piece;
+
+  pushed = & record;
+
+  textlex_init( & context, buffer, size );
+  context.token = token_callback;
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += piece ) {
+    piece = ( ( 0 == chunk ) || ( length - offset < chunk ) ) ? length - offset : chunk;
+    err = textlex_update( & context, (tTextLexBuffer *) text + offset, piece );
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textlex_final( & context );
+  }
+
+  if( TEXTLEX_E_NOERR != err ) {
+    record += "E" + std::to_string( err ) + "|";
+  }
+
+  return( record );
+}
+
+static std::string pull( const char * text, size_t chunk, tTextLexCount size ) {
+  std::string record;
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ TEST_BUFFER_SIZE ];
+  size_t length = strlen( text );
+  size_t offset = 0;
+
+  textlex_init( & context, buffer, size );
+  textlex_extend( & context, & extension );
+
+  auto stream = dsd::tokens( context, [&]() {
+    size_t piece = ( ( 0 == chunk ) || ( length - offset < chunk ) ) ? length - offset : chunk;
+    std::span< tTextLexBuffer > out( (tTextLexBuffer *) text + offset, piece );
+    offset += piece;
+    return( out );
+  } );
+
+  for( const tTextLexToken & token : stream ) {
+    add( record, token.token, token.data, token.length );
+  }
+
+  if( TEXTLEX_E_NOERR != stream.error() ) {
+    record += "E" + std::to_string( stream.error() ) + "|";
+  }
+
+  return( record );
+}
+
+static void add( std::string & record, tTextLexCount token, const tTextLexBuffer * data, tTextLexCount length ) {
+  record += std::to_string( token ) + ":" + std::string( (const char *) data, length ) + "|";
+}
+
+static tTextLexErr token_callback( tTextLexContext * context, tTextLexCount token ) {
+  add( * pushed, token, context->buffer, context->index );
+  return( TEXTLEX_E_NOERR );
+}
+
+/* test_descent()
+**
+** Parses an array of records like { *name = "a" *size = 3 *values = [ 1 2 ] }
+** two octets at a time.
+*/
+
+static int test_descent() {
+  static const char text [] = "[ { *name = \"first\" *size = 3 *values = [ 1 2 3 ] } # one\n"
+    "  { *values = [ -4 ] *name = \"second\" *size = 10 } ]";
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ TEST_BUFFER_SIZE ];
+  tTestRecord records[ 2 ];
+  size_t length = strlen( text ), offset = 0;
+  unsigned int count = 0;
+  bool bad = false;
+
+  textlex_init( & context, buffer, TEST_BUFFER_SIZE );
+  textlex_extend( & context, & extension );
+
+  auto stream = dsd::tokens( context, [&]() {
+    size_t piece = ( length - offset < 2 ) ? length - offset : 2;
+    std::span< tTextLexBuffer > out( (tTextLexBuffer *) text + offset, piece );
+    offset += piece;
+    return( out );
+  } );
+
+  auto it = stream.begin();
+
+  if( ( it == stream.end() ) || ( TEXTLEX_T_ARRAY_OPEN != it->token ) ) {
+    bad = true;
+  } else {
+    for( ++it; ( it != stream.end() ) && ( TEXTLEX_T_ARRAY_CLOSE != it->token ); ++it ) {
+      if( TEXTLEX_T_COMMENT == it->token ) {
+        ++it;
+      } else if( ( count >= 2 ) || ! parse_record( it, records[ count++ ] ) ) {
+        bad = true;
+        break;
+      }
+    }
+  }
+
+  bad = bad || ( 2 != count ) || ( TEXTLEX_E_NOERR != stream.error() ) ||
+    ( "first" != records[ 0 ].name ) || ( 3 != records[ 0 ].size ) || ( 6 != records[ 0 ].sum ) ||
+    ( "second" != records[ 1 ].name ) || ( 10 != records[ 1 ].size ) || ( -4 != records[ 1 ].sum );
+
+  printf( "; TEST DESCENT %u records %s\n", count, bad ? "FAILED" : "OK" );
+
+  return( bad ? 1 : 0 );
+}
+
+/* parse_record()
+**
+** Called with it on the record's '{'; leaves it on the '}'. Lexemes short
+** enough for the buffer come out in one piece, so there's no joining to do.
+*/
+
+static bool parse_record( dsd::TokenStream::iterator & it, tTestRecord & record ) {
+  const tTextLexToken * token;
+  std::string key;
+
+  if( TEXTLEX_T_MAP_OPEN != it->token ) {
+    return( false );
+  }
+
+  record.sum = 0;
+
+  for( ++it; TEXTLEX_T_MAP_CLOSE != it->token; ++it ) {
+    if( TEXTLEX_T_LITERAL != it->token ) {
+      return( false );
+    }
+    key.assign( (const char *) it->data, it->length );
+
+    ++it;                                 /* END */
+    if( TEXTLEX_T_EQUALS != ( ++it )->token ) {
+      return( false );
+    }
+
+    token = & * ++it;
+    if( ( "name" == key ) && ( TEXTLEX_T_STRING == token->token ) ) {
+      record.name.assign( (const char *) token->data, token->length );
+      ++it;
+    } else if( ( "size" == key ) && ( TEXTLEX_T_INTEGER == token->token ) ) {
+      record.size = strtol( std::string( (const char *) token->data, token->length ).c_str(), nullptr, 10 );
+      ++it;
+    } else if( ( "values" == key ) && ( TEXTLEX_T_ARRAY_OPEN == token->token ) ) {
+      for( ++it; TEXTLEX_T_ARRAY_CLOSE != it->token; ++it ) {
+        if( TEXTLEX_T_INTEGER == it->token ) {
+          record.sum += strtol( std::string( (const char *) it->data, it->length ).c_str(), nullptr, 10 );
+        }
+      }
+    } else {
+      return( false );
+    }
+  }
+
+  return( true );
+}
@@ -0,0 +1,286 @@
+/* test_textrec.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests the lexxer's record mode. It strings a few hundred
+** documents together into one stream, with white space, comments or
+** nothing at all between them, remembering where each one starts and
+** ends. Then it lexes the stream in pieces of several sizes, with the
+** token callback, the span callback and in batch mode, and checks the
+** record callback is called once for each document with its offsets, and
+** only after the token that ends it. Last, it checks an error from the
+** record callback stops the lexxer.
+**
+** Linked with textlex_dfa.o instead of textlex.o, it tests the table driven
+** lexxer's record mode.
+*/
+
+/* Macro Definitions */
+
+#define TEST_DOCUMENTS 400
+#define TEST_STREAM    ( TEST_DOCUMENTS * 64 )
+#define TEST_BATCH     16
+
+/* File Includes */
+
+#include <stdio.h>
+#include <string.h>
+#include "textlex.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  unsigned long long start;
+  unsigned long long end;
+} tRecord;
+
+/* Function Prototypes */
+
+static size_t make_stream( void );
+static int run( unsigned int mode, size_t chunk );
+static int test_error( void );
+static tTextLexErr token_callback( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr span_callback( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr batch_callback( tTextLexContext * context, tTextLexToken * tokens, tTextLexCount count );
+static tTextLexErr record_callback( tTextLexContext * context, unsigned long long start, unsigned long long end );
+static tTextLexErr stop_callback( tTextLexContext * context, unsigned long long start, unsigned long long end );
+
+/* Global Variables */
+
+/* Each document ends with the token named in its ending[] entry. */
+
+static const char * documents [] = {
+  "@m { \"a\" = 1 \"b\" = [ 1 2 { } ] }",
+  "@t @x [ \"x\" 'AAEC' ( 00 11 # c\n 22 ) ]",
+  "42",
+  "\"str\"",
+  "*true",
+  "$ff",
+  "-1.5e3",
+  "'AAEC'",
+  "( 0a 0b # break\n 0c )",
+  "{ \"deep\" = [ [ [ 1 ] ] ] # ]\n }",
+  "@m{\"k\"=\"v\"}",
+  "@s \"e\\\"scaped\"",
+  "[]"
+};
+
+static const tTextLexCount ending [] = {
+  TEXTLEX_T_MAP_CLOSE, TEXTLEX_T_ARRAY_CLOSE, TEXTLEX_T_END, TEXTLEX_T_END, TEXTLEX_T_END, TEXTLEX_T_END,
+  TEXTLEX_T_END, TEXTLEX_T_END, TEXTLEX_T_END, TEXTLEX_T_MAP_CLOSE, TEXTLEX_T_MAP_CLOSE, TEXTLEX_T_END,
+  TEXTLEX_T_ARRAY_CLOSE
+};
+
+static const char * separators [] = { " ", "\n", "\r\n", "  # between\n", "\t\t", "" };
+
+static char stream[ TEST_STREAM ];
+static tRecord expected[ TEST_DOCUMENTS ];
+static tTextLexCount expected_ending[ TEST_DOCUMENTS ];
+static unsigned int expected_count;
+
+static tRecord records[ TEST_DOCUMENTS ];
+static unsigned int record_count;
+static tTextLexCount last_token;
+static int misordered;
+
+int main( int argc, char * argv [] ) {
+  static const char * modes [] = { "TOKEN", "SPAN ", "BATCH" };
+  static const size_t chunks [] = { 0, 1, 2, 3, 7, 64, 4096 };
+  unsigned int mode, k;
+  int failed = 0;
+
+  printf( "; BEGIN TESTS\n" );
+
+  make_stream();
+
+  for( mode = 0; mode < 3; mode++ ) {
+    for( k = 0; k < sizeof( chunks ) / sizeof( chunks[ 0 ] ); k++ ) {
+      int bad = run( mode, chunks[ k ] );
+      printf( "; TEST RECORD %s chunk %4zu %u documents %s\n", modes[ mode ], chunks[ k ], record_count, bad ? "FAILED" : "OK" );
+      failed |= bad;
+    }
+  }
+
+  failed |= test_error();
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+/* make_stream()
+**
+** Picks documents and separators with a little linear congruential
+** generator. Two documents can only go right next to each other if the
+** first one ends with a closing character or the second one starts with
+** one that ends a number or literal. The stream ends with a number, so the
+** last document is ended by textlex_final().
+*/
+
+static size_t make_stream( void ) {
+  const unsigned int count = sizeof( documents ) / sizeof( documents[ 0 ] );
+  unsigned long seed = 12345;
+  size_t length = 0, size;
+  unsigned int d = 0, previous = 0;
+  const char * separator;
+  char close, open;
+
+  for( expected_count = 0; expected_count < TEST_DOCUMENTS; expected_count++ ) {
+    seed = seed * 1103515245UL + 12345UL;
+    d = ( TEST_DOCUMENTS - 1 == expected_count ) ? 2 : (unsigned int) ( ( seed >> 8 ) % count );
+    separator = separators[ ( seed >> 20 ) % ( sizeof( separators ) / sizeof( separators[ 0 ] ) ) ];
+
+    if( expected_count > 0 ) {
+      size = strlen( documents[ previous ] );
+      close = documents[ previous ][ size - 1 ];
+      open = documents[ d ][ 0 ];
+      if( ( 0 == * separator ) && ( NULL == strchr( "}]\"')", close ) ) && ( NULL == strchr( "{[\"'(@$*", open ) ) ) {
+        separator = " ";
+      }
+      memcpy( stream + length, separator, strlen( separator ) );
+      length += strlen( separator );
+    }
+
+    size = strlen( documents[ d ] );
+    expected[ expected_count ].start = length;
+    expected[ expected_count ].end = length + size;
+    expected_ending[ expected_count ] = ending[ d ];
+    memcpy( stream + length, documents[ d ], size );
+    length += size;
+    previous = d;
+  }
+
+  stream[ length ] = 0;
+
+  return( length );
+}
+
+/* run()
+**
+** Lexes the stream chunk octets at a time (all at once if chunk is 0) and
+** checks the records that come out.
+*/
+
+static int run( unsigned int mode, size_t chunk ) {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ 80 ];
+  tTextLexToken tokens[ TEST_BATCH ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t length = strlen( stream ), offset, piece;
+  unsigned int i;
+  int bad = 0;
+
+  textlex_init( & context, buffer, sizeof( buffer ) );
+  textlex_extend( & context, & extension );
+  extension.record = record_callback;
+  if( 0 == mode ) {
+    context.token = token_callback;
+  } else if( 1 == mode ) {
+    extension.span = span_callback;
+  } else {
+    extension.batch = batch_callback;
+    extension.tokens = tokens;
+    extension.capacity = TEST_BATCH;
+  }
+
+  record_count = 0;
+  last_token = TEXTLEX_T_EQUALS;
+  misordered = 0;
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += piece ) {
+    piece = ( ( 0 == chunk ) || ( length - offset < chunk ) ) ? length - offset : chunk;
+    err = textlex_update( & context, (tTextLexBuffer *) stream + offset, (tTextLexCount) piece );
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textlex_final( & context );
+  }
+
+  if( ( TEXTLEX_E_NOERR != err ) || ( expected_count != record_count ) || misordered || ( length != extension.offset ) ) {
+    printf( ";  error %u, %u of %u documents, %d misordered\n", err, record_count, expected_count, misordered );
+    bad = 1;
+  }
+
+  for( i = 0; ( i < record_count ) && ( i < expected_count ); i++ ) {
+    if( ( expected[ i ].start != records[ i ].start ) || ( expected[ i ].end != records[ i ].end ) ) {
+      printf( ";  document %u: expected %llu..%llu got %llu..%llu \"%.*s\"\n", i, expected[ i ].start, expected[ i ].end,
+              records[ i ].start, records[ i ].end, (int) ( expected[ i ].end - expected[ i ].start ), stream + expected[ i ].start );
+      bad = 1;
+      break;
+    }
+  }
+
+  return( bad );
+}
+
+/* test_error()
+**
+** An error from the record callback is returned by textlex_update() and
+** nothing after the document gets lexed.
+*/
+
+static int test_error( void ) {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ 80 ];
+  tTextLexBuffer text [] = "{ } { } x";
+  tTextLexErr err;
+  int bad;
+
+  textlex_init( & context, buffer, sizeof( buffer ) );
+  textlex_extend( & context, & extension );
+  context.token = token_callback;
+  extension.record = stop_callback;
+  record_count = 0;
+
+  err = textlex_update( & context, text, sizeof( text ) - 1 );
+  bad = ( TEXTLEX_E_ERROR != err ) || ( 1 != record_count ) || ( 3 != context.bytes_read );
+
+  printf( "; TEST RECORD ERROR %s\n", bad ? "FAILED" : "OK" );
+
+  return( bad );
+}
+
+static tTextLexErr token_callback( tTextLexContext * context, tTextLexCount token ) {
+  last_token = token;
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr span_callback( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  last_token = token;
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr batch_callback( tTextLexContext * context, tTextLexToken * tokens, tTextLexCount count ) {
+  if( count > 0 ) {
+    last_token = tokens[ count - 1 ].token;
+  }
+  return( TEXTLEX_E_NOERR );
+}
+
+/* record_callback()
+**
+** Saves the offsets and checks the last token delivered is the one that
+** ended the document.
+*/
+
+static tTextLexErr record_callback( tTextLexContext * context, unsigned long long start, unsigned long long end ) {
+  if( record_count < TEST_DOCUMENTS ) {
+    if( expected_ending[ record_count ] != last_token ) {
+      misordered++;
+    }
+    records[ record_count ].start = start;
+    records[ record_count ].end = end;
+  }
+  record_count++;
+  last_token = TEXTLEX_T_EQUALS;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr stop_callback( tTextLexContext * context, unsigned long long start, unsigned long long end ) {
+  record_count++;
+  return( TEXTLEX_E_ERROR );
+}
@@ -0,0 +1,261 @@
+/* test_textstat.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests the lexxer's statistics. It has to be compiled with
+** -DTEXTLEX_STATS and linked with a textlex.o compiled the same way. It
+** lexes a small document and checks the octets in each state and the
+** tokens of each type come out right, whether it's lexed all at once or an
+** octet at a time, then lexes every fixture in test_textlex.h and checks
+** the counts against what the token callback saw. It checks the longest
+** lexeme is counted whole when the overflow callback throws pieces away or
+** grows the buffer, and that the time adds up. Last, it writes the
+** statistics out with textstat_write() and checks they lex.
+*/
+
+/* Macro Definitions */
+
+#define TEST_OUTPUT 4096
+
+/* File Includes */
+
+#include <stdio.h>
+#include <string.h>
+#include "textstat.h"
+
+/* Function Prototypes */
+
+static int test_states( size_t chunk );
+static int test_fixtures( void );
+static int test_overflow( int grow );
+static int test_write( void );
+static tTextLexErr lex( tTextLexContext * context, const char * text, size_t chunk );
+static tTextLexErr token_callback( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr grow_callback( tTextLexContext * context );
+static tTextLexErr check_callback( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+
+/* Global Variables */
+
+static const char * fixtures [] = {
+#include "test_textlex.h"
+  NULL
+};
+
+static unsigned long long seen[ TEXTLEX_C_TOKENS ];
+static tTextLexCount longest;
+static tTextLexBuffer grown[ 64 ];
+
+int main( int argc, char * argv [] ) {
+  int failed = 0;
+
+  printf( "; BEGIN TESTS\n" );
+
+  failed |= test_states( 0 );
+  failed |= test_states( 1 );
+  failed |= test_fixtures();
+  failed |= test_overflow( 0 );
+  failed |= test_overflow( 1 );
+  failed |= test_write();
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+/* test_states()
+**
+** # hi\n{ "a" = 12 } is read in START (# { space " space = space 1 }),
+** COMMENT (space h i \n), STRING (a ") and NUMBER (2 space).
+*/
+
+static int test_states( size_t chunk ) {
+  static const unsigned long long octets[ TEXTLEX_C_STATES ] = { 9, 0, 4, 0, 0, 2, 0, 0, 0, 0, 0, 0, 2 };
+  static const unsigned long long tokens[ TEXTLEX_C_TOKENS ] = { 3, 1, 0, 0, 1, 0, 0, 1, 0, 0, 0, 1, 1, 1 };
+  tTextLexContext context;
+  tTextLexBuffer buffer[ 80 ];
+  int bad;
+
+  textlex_init( & context, buffer, sizeof( buffer ) );
+  context.token = token_callback;
+
+  bad = ( TEXTLEX_E_NOERR != lex( & context, "# hi\n{ \"a\" = 12 }", chunk ) ) ||
+    ( 0 != memcmp( octets, context.stats.octets, sizeof( octets ) ) ) ||
+    ( 0 != memcmp( tokens, context.stats.tokens, sizeof( tokens ) ) ) ||
+    ( 3 != context.stats.longest ) || ( 0 != context.stats.overflows );
+
+  printf( "; TEST STATS STATES chunk %zu %s\n", chunk, bad ? "FAILED" : "OK" );
+
+  return( bad );
+}
+
+static int test_fixtures( void ) {
+  tTextLexContext context;
+  tTextLexBuffer buffer[ 256 ];
+  unsigned long long octets;
+  size_t length;
+  unsigned int i, k;
+  int bad = 0;
+
+  for( i = 0; NULL != fixtures[ i ]; i++ ) {
+    textlex_init( & context, buffer, sizeof( buffer ) );
+    context.token = token_callback;
+    memset( seen, 0, sizeof( seen ) );
+    longest = 0;
+    length = strlen( fixtures[ i ] );
+
+    if( TEXTLEX_E_NOERR != lex( & context, fixtures[ i ], 7 ) ) {
+      continue;
+    }
+
+    for( k = 0, octets = 0; k < TEXTLEX_C_STATES; k++ ) {
+      octets += context.stats.octets[ k ];
+    }
+
+    if( ( octets != length ) || ( 0 != memcmp( seen, context.stats.tokens, sizeof( seen ) ) ) || ( longest != context.stats.longest ) ) {
+      printf( ";  fixture %u: %llu of %zu octets, longest %llu not %u\n", i, octets, length, context.stats.longest, longest );
+      bad = 1;
+    }
+  }
+
+  printf( "; TEST STATS FIXTURES %s\n", bad ? "FAILED" : "OK" );
+
+  return( bad );
+}
+
+/* test_overflow()
+**
+** With a four octet buffer, the default overflow callback sends a ten
+** character string in three pieces; grow_callback() swaps in a bigger
+** buffer the first time. Either way, the longest lexeme is ten octets.
+*/
+
+static int test_overflow( int grow ) {
+  tTextLexContext context;
+  tTextLexBuffer buffer[ 4 ];
+  int bad;
+
+  textlex_init( & context, buffer, sizeof( buffer ) );
+  context.token = token_callback;
+  if( grow ) {
+    context.overflow = grow_callback;
+  }
+
+  bad = ( TEXTLEX_E_NOERR != lex( & context, "[ \"0123456789\" \"ab\" ]", 3 ) ) ||
+    ( 10 != context.stats.longest ) || ( ( grow ? 1 : 2 ) != context.stats.overflows ) ||
+    ( ( grow ? 2 : 4 ) != context.stats.tokens[ TEXTLEX_T_STRING ] ) ||
+    ( context.stats.ticks < context.stats.callback_ticks + context.stats.overflow_ticks ) ||
+    ( 0 == context.stats.callback_ticks ) || ( 0 == context.stats.overflow_ticks );
+
+  printf( "; TEST STATS OVERFLOW %s %s\n", grow ? "GROW" : "DEFAULT", bad ? "FAILED" : "OK" );
+
+  return( bad );
+}
+
+/* test_write()
+**
+** Writes the statistics for the small document and lexes what comes out,
+** checking "longest" = 3 is in it.
+*/
+
+static int test_write( void ) {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextEncContext writer;
+  tTextLexBuffer buffer[ 80 ];
+  unsigned char output[ TEST_OUTPUT ];
+  int bad;
+
+  textlex_init( & context, buffer, sizeof( buffer ) );
+  context.token = token_callback;
+  lex( & context, "# hi\n{ \"a\" = 12 }", 0 );
+
+  textenc_init( & writer, output, TEST_OUTPUT - 1, TEXTENC_M_PRETTY );
+  bad = ( TEXTLEX_E_NOERR != textstat_write( & writer, & context.stats ) ) || ( TEXTLEX_E_NOERR != textenc_final( & writer ) );
+  output[ writer.index ] = 0;
+
+  textlex_init( & context, buffer, sizeof( buffer ) );
+  textlex_extend( & context, & extension );
+  extension.span = check_callback;
+  longest = 0;
+  bad |= ( TEXTLEX_E_NOERR != lex( & context, (char *) output, 0 ) ) || ( 3 != longest ) ||
+    ( NULL == strstr( (char *) output, "\"octets\" = {" ) ) || ( NULL == strstr( (char *) output, "\"clock\" = \"" TEXTSTAT_CLOCK "\"" ) );
+
+  printf( "; TEST STATS WRITE %s\n", bad ? "FAILED" : "OK" );
+  if( bad ) {
+    printf( "%s", output );
+  }
+
+  return( bad );
+}
+
+static tTextLexErr lex( tTextLexContext * context, const char * text, size_t chunk ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t length = strlen( text ), offset, piece;
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += piece ) {
+    piece = ( ( 0 == chunk ) || ( length - offset < chunk ) ) ? length - offset : chunk;
+    err = textlex_update( context, (tTextLexBuffer *) text + offset, (tTextLexCount) piece );
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textlex_final( context );
+  }
+
+  return( err );
+}
+
+/* token_callback()
+**
+** Counts the tokens and keeps track of the longest lexeme. It also wastes
+** a little time, so there's some to measure.
+*/
+
+static tTextLexErr token_callback( tTextLexContext * context, tTextLexCount token ) {
+  static volatile unsigned int spin;
+  unsigned int i;
+
+  seen[ token ]++;
+  if( context->index > longest ) {
+    longest = context->index;
+  }
+
+  for( i = 0; i < 100; i++ ) {
+    spin++;
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr grow_callback( tTextLexContext * context ) {
+  if( context->buffer == grown ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  memcpy( grown, context->buffer, context->index );
+  context->buffer = grown;
+  context->size = sizeof( grown );
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* check_callback()
+**
+** Remembers the integer after "longest".
+*/
+
+static tTextLexErr check_callback( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  static int want;
+  tTextLexCount i;
+
+  if( TEXTLEX_T_STRING == token ) {
+    want = ( 7 == length ) && ( 0 == memcmp( data, "longest", 7 ) );
+  } else if( want && ( TEXTLEX_T_INTEGER == token ) ) {
+    for( i = 0, longest = 0; i < length; i++ ) {
+      longest = longest * 10 + ( data[ i ] - '0' );
+    }
+    want = 0;
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
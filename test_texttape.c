@@ -0,0 +1,335 @@
+/* test_texttape.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests the DSD Tape Builder. It builds a tape for each
+** fixture (once with the whole fixture and once a few octets at a time),
+** checks that every open word and its close word point at each other and
+** prints the tape. Then it checks the fixtures that should fail do, builds
+** example.dsd and looks a few values up in it. The builder is reused for
+** every document, so the last test checks that building the same document
+** again doesn't move the tape.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 200809L
+
+#define _STEP 7
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "texttape.h"
+
+/* Function Prototypes */
+
+static int test_fixture( char * fixture, tTextLexErr expected );
+static tTextLexErr build( unsigned char * text, size_t length, size_t step );
+static int dump( FILE * output );
+static int test_example( void );
+static unsigned char * load_file( char * path, size_t * length );
+
+/* Global Variables */
+
+static char * fixtures [] = {
+  "",
+  "#Comment 01\n",
+  "@t #Comment 04\n",
+  "*false #COMMENT XX",
+  "@m 90125",
+  "3.14 $CAFEB0EF \"This is a \\\"string\\\"\" 'OTyqgu7Aca5sDCBzEoR23A=='",
+  "(\n 41 42 43 44 # ABCD\n 45 46 47 48 # EFGH\n)",
+  "[ 1 -1 2.3 -2.3 4.56 -4.56 78.9 -78.9 ]",
+  "[ 9223372036854775807 -9223372036854775808 9223372036854775808 ]",
+  "[[] {} [[1 2] [3 4]] { \"a\" = [] }]",
+  "@s { \"one\"=1 \"two\" = 2 \"3\" = \"three\" }",
+  "@t{\"a\"=1}",
+  "{ \"k\" = # why\n @x 1 \"j\" = [ @dangling ] \"l\" = @m { } }",
+  NULL
+};
+
+static struct {
+  char        * fixture;
+  tTextLexErr   err;
+} failures [] = {
+  { "{ \"a\" }", TEXTTAPE_E_STRUCTURE },
+  { "{ = 1 }", TEXTTAPE_E_STRUCTURE },
+  { "{ \"a\" \"b\" }", TEXTTAPE_E_STRUCTURE },
+  { "{ \"a\" = }", TEXTTAPE_E_STRUCTURE },
+  { "[ 1 }", TEXTTAPE_E_STRUCTURE },
+  { "[ 1 = 2 ]", TEXTTAPE_E_STRUCTURE },
+  { "]", TEXTTAPE_E_STRUCTURE },
+  { "[ 1 [ 2 ]", TEXTTAPE_E_UNCLOSED },
+  { "{ \"a\" = 1", TEXTTAPE_E_UNCLOSED },
+  { "[ 1 ? ]", TEXTLEX_E_START },
+  { "{ \"k\" = 1 [ ] \"l\" = 2 }", TEXTTAPE_E_STRUCTURE },
+  { NULL, TEXTLEX_E_NOERR }
+};
+
+static tTextTapeContext context;
+
+int main( int argc, char * argv [] ) {
+  unsigned int i;
+  int failed = 0;
+
+  printf( "; BEGIN TESTS\n" );
+
+  if( TEXTLEX_E_NOERR != texttape_init( & context ) ) {
+    printf( ";  ERROR can't initialize the builder\n" );
+    return( 2 );
+  }
+
+  for( i = 0; NULL != fixtures[ i ]; i++ ) {
+    failed |= test_fixture( fixtures[ i ], TEXTLEX_E_NOERR );
+  }
+
+  for( i = 0; NULL != failures[ i ].fixture; i++ ) {
+    failed |= test_fixture( failures[ i ].fixture, failures[ i ].err );
+  }
+
+  failed |= test_example();
+
+  texttape_free( & context );
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+/* test_fixture()
+**
+** Builds a fixture whole and in pieces. The two tapes have to print the
+** same way and both builds have to return the expected error.
+*/
+
+static int test_fixture( char * fixture, tTextLexErr expected ) {
+  char * whole = NULL;
+  char * pieces = NULL;
+  size_t whole_length = 0, pieces_length = 0;
+  size_t length = strlen( fixture );
+  tTextLexErr err, err_pieces;
+  FILE * output;
+  int failed = 0;
+
+  printf( "; TEST (%03zu) %s\n", length, fixture );
+
+  err = build( (unsigned char *) fixture, length, length );
+  output = open_memstream( & whole, & whole_length );
+  if( TEXTLEX_E_NOERR == err ) {
+    failed |= dump( output );
+  }
+  fclose( output );
+
+  err_pieces = build( (unsigned char *) fixture, length, _STEP );
+  output = open_memstream( & pieces, & pieces_length );
+  if( TEXTLEX_E_NOERR == err_pieces ) {
+    failed |= dump( output );
+  }
+  fclose( output );
+
+  if( TEXTLEX_E_NOERR == err ) {
+    printf( "%s", whole );
+  } else {
+    printf( ";  ERROR %d\n", err );
+  }
+
+  if( failed || ( expected != err ) || ( err != err_pieces ) || ( whole_length != pieces_length ) || ( 0 != memcmp( whole, pieces, whole_length ) ) ) {
+    printf( ";  MISMATCH\n" );
+    failed = 1;
+  }
+
+  free( whole );
+  free( pieces );
+
+  return( failed );
+}
+
+static tTextLexErr build( unsigned char * text, size_t length, size_t step ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t offset, chunk;
+
+  texttape_reset( & context );
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += chunk ) {
+    chunk = ( length - offset < step ) ? length - offset : step;
+    err = texttape_update( & context, text + offset, chunk );
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = texttape_final( & context );
+  }
+
+  return( err );
+}
+
+/* dump()
+**
+** Prints the tape a word at a time, indented by how deep it is. It returns
+** non-zero if an open word and its close word don't agree.
+*/
+
+static int dump( FILE * output ) {
+  static const char * names[ TEXTLEX_C_TOKENS ] = {
+    "END", "COMMENT", "ANNOTATION", "LITERAL", "INTEGER", "FLOAT", "HEX", "STRING", "BASE64",
+    "ARRAY", "ARRAY_CLOSE", "MAP", "MAP_CLOSE", "EQUALS"
+  };
+  tTextTapeWord * words = context.words;
+  tTextTapeWord word;
+  size_t i, end;
+  unsigned int type, depth = 1;
+  double real;
+  int failed = 0;
+
+  if( ( context.count != TEXTTAPE_PAYLOAD( words[ 0 ] ) ) || ( context.count - 1 != TEXTTAPE_PAYLOAD( words[ TEXTTAPE_ROOT ] ) ) ) {
+    return( 1 );
+  }
+
+  for( i = TEXTTAPE_ROOT; i < context.count; i++ ) {
+    word = words[ i ];
+    type = TEXTTAPE_TYPE( word );
+
+    if( ( TEXTTAPE_T_ARRAY_CLOSE == type ) || ( TEXTTAPE_T_MAP_CLOSE == type ) ) {
+      depth--;
+    }
+
+    fprintf( output, "; %04zu%*s%s", i, (int) depth, "", names[ type ] );
+
+    switch( type ) {
+    case TEXTTAPE_T_ARRAY:
+    case TEXTTAPE_T_MAP:
+      end = (size_t) TEXTTAPE_PAYLOAD( word );
+      fprintf( output, " %04zu\n", end );
+      failed |= ( end >= context.count ) || ( TEXTTAPE_TYPE( words[ end ] ) != type + 1 ) || ( i != TEXTTAPE_PAYLOAD( words[ end ] ) );
+      depth++;
+      break;
+
+    case TEXTTAPE_T_ARRAY_CLOSE:
+    case TEXTTAPE_T_MAP_CLOSE:
+      fprintf( output, " %04llu\n", TEXTTAPE_PAYLOAD( word ) );
+      break;
+
+    default:
+      if( TEXTTAPE_IS_TEXT( word ) || ( ( TEXTTAPE_T_INTEGER != type ) && ( TEXTTAPE_T_FLOAT != type ) ) ) {
+        fprintf( output, " (%03llu) %s\n", words[ i + 1 ], context.strings + TEXTTAPE_PAYLOAD( word ) );
+      } else if( TEXTTAPE_T_INTEGER == type ) {
+        fprintf( output, " %lld\n", (long long) words[ i + 1 ] );
+      } else {
+        memcpy( & real, & words[ i + 1 ], sizeof( double ) );
+        fprintf( output, " %.17g\n", real );
+      }
+      i++;
+      break;
+    }
+  }
+
+  return( failed );
+}
+
+/* test_example()
+**
+** Builds example.dsd and looks up some of the values in it. Then builds it
+** again and checks the builder didn't have to move the tape or the text.
+*/
+
+static int test_example( void ) {
+  tTextTapeWord * words;
+  unsigned char * strings;
+  unsigned char * example;
+  size_t length, map, root = TEXTTAPE_ROOT;
+  long long integer = 0;
+  double real = 0;
+  int failed = 0;
+  tTextLexErr err;
+
+  if( NULL == ( example = load_file( "example.dsd", & length ) ) ) {
+    printf( ";  ERROR can't read example.dsd\n" );
+    return( 1 );
+  }
+
+  printf( "; TEST (%zu) example.dsd\n", length );
+
+  do {
+    if( TEXTLEX_E_NOERR != ( err = build( example, length, _STEP ) ) ) {
+      printf( ";  ERROR %d\n", err );
+      failed = 1;
+      break;
+    }
+
+    printf( ";  TAPE (%zu) TEXT (%zu)\n", context.count, context.length );
+    map = texttape_index( & context, root, 0 );
+
+    failed |= ! texttape_integer( & context, texttape_find( & context, map, "revision" ), & integer ) || ( 55 != integer );
+    printf( ";  revision = %lld\n", integer );
+    failed |= ! texttape_integer( & context, texttape_find( & context, map, "magic number" ), & integer ) || ( 0xB1 != integer );
+    printf( ";  magic number = %lld\n", integer );
+    failed |= ! texttape_float( & context, texttape_find( & context, map, "percent complete" ), & real ) || ( 87.95 != real );
+    printf( ";  percent complete = %g\n", real );
+    failed |= ! texttape_float( & context, texttape_index( & context, texttape_find( & context, map, "i am an array" ), 4 ), & real ) || ( 3.14 != real );
+    printf( ";  i am an array[ 4 ] = %g\n", real );
+    failed |= ! texttape_integer( & context, texttape_find( & context, texttape_find( & context, map, "yet another dictionary" ), "two" ), & integer ) || ( 2 != integer );
+    printf( ";  yet another dictionary.two = %lld\n", integer );
+    failed |= ( 0 != texttape_find( & context, map, "not there" ) ) || ( 0 == texttape_index( & context, root, 7 ) ) || ( 0 != texttape_index( & context, root, 8 ) );
+    failed |= ( 0 != texttape_index( & context, texttape_find( & context, map, "not there" ), 0 ) );
+    failed |= ! texttape_integer( & context, texttape_index( & context, root, 5 ), & integer ) || ( 42 != integer );
+    printf( ";  root[ 5 ] = %lld\n", integer );
+    failed |= ( texttape_skip( & context, map ) != texttape_index( & context, root, 1 ) );
+
+    words = context.words;
+    strings = context.strings;
+
+    if( TEXTLEX_E_NOERR != ( err = build( example, length, length ) ) ) {
+      printf( ";  ERROR %d\n", err );
+      failed = 1;
+      break;
+    }
+
+    if( ( words != context.words ) || ( strings != context.strings ) ) {
+      printf( ";  TAPE MOVED\n" );
+      failed = 1;
+    }
+  } while( 0 );
+
+  if( failed ) {
+    printf( ";  MISMATCH\n" );
+  }
+
+  free( example );
+
+  return( failed );
+}
+
+static unsigned char * load_file( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * data = NULL;
+  long size;
+
+  if( NULL == ( file = fopen( path, "rb" ) ) ) {
+    return( NULL );
+  }
+
+  do {
+    if( ( 0 != fseek( file, 0, SEEK_END ) ) || ( ( size = ftell( file ) ) <= 0 ) || ( 0 != fseek( file, 0, SEEK_SET ) ) ) {
+      break;
+    }
+
+    if( NULL == ( data = malloc( size ) ) ) {
+      break;
+    }
+
+    if( (size_t) size != fread( data, 1, size, file ) ) {
+      free( data );
+      data = NULL;
+      break;
+    }
+
+    * length = size;
+  } while( 0 );
+
+  fclose( file );
+
+  return( data );
+}
@@ -0,0 +1,240 @@
+/* test_texttype.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests the typed decoder. It decodes documents whose numbers
+** are right at the edges of each type system (and just past them), checks
+** the values that come out and the errors, and that the annotation only
+** picks the type system for the document it leads. Each document is
+** decoded all at once and in pieces of several sizes, which have to give
+** the same answer.
+**
+** Compiled with -DTEXTTYPE_NO_SMALL -DTEXTTYPE_NO_MEDIUM and linked with a
+** texttype.o compiled the same way, it skips the documents that need the
+** wider type systems and checks asking for them is an error.
+*/
+
+/* Macro Definitions */
+
+#define TEST_RECORD 4096
+
+/* File Includes */
+
+#include <stdio.h>
+#include <string.h>
+#include "texttype.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  unsigned int   needs;
+  const char   * text;
+  const char   * expected;
+} tCase;
+
+/* Function Prototypes */
+
+static size_t decode( char * record, const char * text, size_t chunk, unsigned int fallback );
+static int test_system( void );
+static tTextLexErr value_callback( tTextTypeContext * context, tTextLexCount token, const tTextTypeValue * value );
+static tTextLexErr span_callback( tTextTypeContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+
+/* Global Variables */
+
+/* Values are recorded as the type system's letter, the token and the
+** value; every other token but annotations and comments is just its
+** number (so each annotation leaves the TEXTLEX_T_END after it.) needs is
+** the widest type system the document uses. The base16 string under @t
+** is too long for a uint16_t but isn't a number, so it's fine, and the 1
+** after it is back to the fallback.
+*/
+
+static const tCase cases [] = {
+  { TEXTTYPE_S_TINY,   "@t [ 32767 -32768 0 -0 $FFFF $0 1.5 -2.5e3 ]", "0 9 t4:32767 0 t4:-32768 0 t4:0 0 t4:0 0 t6:65535 0 t6:0 0 t5:1.5 0 t5:-2500 0 10 E0" },
+  { TEXTTYPE_S_TINY,   "@t 32768", "0 E106" },
+  { TEXTTYPE_S_TINY,   "@t -32769", "0 E106" },
+  { TEXTTYPE_S_TINY,   "@t $10000", "0 E106" },
+  { TEXTTYPE_S_TINY,   "@t 1.0e39", "0 E106" },
+  { TEXTTYPE_S_TINY,   "@t 3.4e38", "0 t5:3.39999995e+38 0 E0" },
+  { TEXTTYPE_S_TINY,   "@t { \"a\" = 0000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000000012 }",
+    "0 11 7 0 13 t4:12 0 12 E0" },
+  { TEXTTYPE_S_MEDIUM, "@t ( ffffffffff ) 1", "0 6 0 m4:1 0 E0" },
+  { TEXTTYPE_S_TINY,   "@x @t 7 # tiny\n", "0 0 t4:7 0 0 E0" },
+  { TEXTTYPE_S_SMALL,  "@s [ 2147483647 -2147483648 $FFFFFFFF 1.25 ]", "0 9 s4:2147483647 0 s4:-2147483648 0 s6:4294967295 0 s5:1.25 0 10 E0" },
+  { TEXTTYPE_S_SMALL,  "@s 2147483648", "0 E106" },
+  { TEXTTYPE_S_SMALL,  "@s $100000000", "0 E106" },
+  { TEXTTYPE_S_MEDIUM, "@m [ 9223372036854775807 -9223372036854775808 $FFFFFFFFFFFFFFFF 0.1 ]",
+    "0 9 m4:9223372036854775807 0 m4:-9223372036854775808 0 m6:18446744073709551615 0 m5:0.10000000000000001 0 10 E0" },
+  { TEXTTYPE_S_MEDIUM, "@m 9223372036854775808", "0 E106" },
+  { TEXTTYPE_S_MEDIUM, "@m $10000000000000000", "0 E106" },
+  { TEXTTYPE_S_MEDIUM, "@m 1.0e309", "0 E106" },
+  { TEXTTYPE_S_MEDIUM, "@t 1 70000 @s 70000", "0 t4:1 0 m4:70000 0 0 s4:70000 0 E0" },
+  { TEXTTYPE_S_MEDIUM, "@t [ 1 ] [ 70000 ] @t { \"k\" = @m 70000 }", "0 9 t4:1 0 10 9 m4:70000 0 10 0 11 7 0 13 0 E106" },
+  { TEXTTYPE_S_MEDIUM, "@t \"x\" 70000 *true 70000 ( 00 ) 70000", "0 7 0 m4:70000 0 3 0 m4:70000 0 6 0 m4:70000 0 E0" },
+  { 0, NULL, NULL }
+};
+
+static char * recorded;
+static size_t recorded_length;
+
+int main( int argc, char * argv [] ) {
+  static const size_t chunks [] = { 0, 1, 2, 3, 7 };
+  static char actual[ TEST_RECORD ];
+  unsigned int i, k;
+  size_t length;
+  int failed = 0, bad;
+
+  printf( "; BEGIN TESTS\n" );
+
+  for( k = 0; k < sizeof( chunks ) / sizeof( chunks[ 0 ] ); k++ ) {
+    bad = 0;
+
+    for( i = 0; NULL != cases[ i ].text; i++ ) {
+#ifdef TEXTTYPE_NO_SMALL
+      if( TEXTTYPE_S_SMALL <= cases[ i ].needs ) {
+        continue;
+      }
+#endif
+#ifdef TEXTTYPE_NO_MEDIUM
+      if( TEXTTYPE_S_MEDIUM <= cases[ i ].needs ) {
+        continue;
+      }
+#endif
+      length = decode( actual, cases[ i ].text, chunks[ k ], TEXTTYPE_S_MEDIUM );
+      if( ( strlen( cases[ i ].expected ) != length ) || ( 0 != memcmp( cases[ i ].expected, actual, length ) ) ) {
+        printf( ";  %s\n;    expected %s\n;    got      %.*s\n", cases[ i ].text, cases[ i ].expected, (int) length, actual );
+        bad = 1;
+      }
+    }
+
+    printf( "; TEST TYPED chunk %zu %s\n", chunks[ k ], bad ? "FAILED" : "OK" );
+    failed |= bad;
+  }
+
+  failed |= test_system();
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
+
+/* decode()
+**
+** Decodes the text chunk octets at a time (or all at once if chunk is 0),
+** writing the values and tokens into record, followed by the error.
+** Returns the length of the record.
+*/
+
+static size_t decode( char * record, const char * text, size_t chunk, unsigned int fallback ) {
+  tTextTypeContext context;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t length = strlen( text );
+  size_t offset, piece;
+
+  recorded = record;
+  recorded_length = 0;
+
+  texttype_init( & context );
+  context.value = value_callback;
+  context.span = span_callback;
+  context.fallback = fallback;
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += piece ) {
+    piece = ( ( 0 == chunk ) || ( length - offset < chunk ) ) ? length - offset : chunk;
+    err = texttype_update( & context, (tTextLexBuffer *) text + offset, (tTextLexCount) piece );
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = texttype_final( & context );
+  }
+
+  recorded_length += sprintf( recorded + recorded_length, "E%u", err );
+
+  return( recorded_length );
+}
+
+/* test_system()
+**
+** Without the wider type systems, documents that ask for them (or don't
+** say, when the fallback is one of them) are errors and the fallback is
+** tiny. With them, a fallback that doesn't exist is an error.
+*/
+
+static int test_system( void ) {
+  static char actual[ TEST_RECORD ];
+  int bad = 0;
+
+#if defined( TEXTTYPE_NO_SMALL ) && defined( TEXTTYPE_NO_MEDIUM )
+  tTextTypeContext context;
+
+  texttype_init( & context );
+  bad |= ( TEXTTYPE_S_TINY != context.fallback );
+  bad |= ( 0 != strcmp( "E107", ( decode( actual, "@s 1", 0, TEXTTYPE_S_TINY ), actual ) ) );
+  bad |= ( 0 != strcmp( "E107", ( decode( actual, "@m 1", 0, TEXTTYPE_S_TINY ), actual ) ) );
+  bad |= ( 0 != strcmp( "E107", ( decode( actual, "1", 0, TEXTTYPE_S_MEDIUM ), actual ) ) );
+  bad |= ( 0 != strcmp( "t4:1 0 E0", ( decode( actual, "1", 0, TEXTTYPE_S_TINY ), actual ) ) );
+#else
+  bad |= ( 0 != strcmp( "E107", ( decode( actual, "1", 0, 9 ), actual ) ) );
+  bad |= ( 0 != strcmp( "t4:1 0 E0", ( decode( actual, "1", 0, TEXTTYPE_S_TINY ), actual ) ) );
+#endif
+
+  printf( "; TEST TYPED SYSTEMS %s\n", bad ? "FAILED" : "OK" );
+
+  return( bad );
+}
+
+static tTextLexErr value_callback( tTextTypeContext * context, tTextLexCount token, const tTextTypeValue * value ) {
+  static const char letters [] = "?tsm";
+  char * out = recorded + recorded_length;
+
+  out += sprintf( out, "%c%u:", letters[ value->system ], token );
+
+  switch( value->system ) {
+  case TEXTTYPE_S_TINY:
+    if( TEXTLEX_T_INTEGER == token ) {
+      out += sprintf( out, "%d ", value->as.i16 );
+    } else if( TEXTLEX_T_HEX == token ) {
+      out += sprintf( out, "%u ", value->as.u16 );
+    } else {
+      out += sprintf( out, "%.9g ", value->as.f32 );
+    }
+    break;
+
+#ifndef TEXTTYPE_NO_SMALL
+  case TEXTTYPE_S_SMALL:
+    if( TEXTLEX_T_INTEGER == token ) {
+      out += sprintf( out, "%ld ", (long) value->as.i32 );
+    } else if( TEXTLEX_T_HEX == token ) {
+      out += sprintf( out, "%lu ", (unsigned long) value->as.u32 );
+    } else {
+      out += sprintf( out, "%.9g ", value->as.f32 );
+    }
+    break;
+#endif
+
+#ifndef TEXTTYPE_NO_MEDIUM
+  case TEXTTYPE_S_MEDIUM:
+    if( TEXTLEX_T_INTEGER == token ) {
+      out += sprintf( out, "%lld ", (long long) value->as.i64 );
+    } else if( TEXTLEX_T_HEX == token ) {
+      out += sprintf( out, "%llu ", (unsigned long long) value->as.u64 );
+    } else {
+      out += sprintf( out, "%.17g ", value->as.f64 );
+    }
+    break;
+#endif
+  }
+
+  recorded_length = (size_t) ( out - recorded );
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr span_callback( tTextTypeContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  if( ( TEXTLEX_T_ANNOTATION != token ) && ( TEXTLEX_T_COMMENT != token ) ) {
+    recorded_length += sprintf( recorded + recorded_length, "%u ", token );
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
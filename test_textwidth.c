@@ -0,0 +1,102 @@
+/* test_textwidth.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program tests the lexxers of different widths linked into one
+** program. test_textwidth_lex.c is compiled three times, with
+** -DTEXTLEX_WIDTH=16, 32 and 64, and linked with textlex16.o, textlex32.o
+** and textlex64.o; if their symbols clashed, this wouldn't link. It checks
+** all three lex the fixtures in test_textlex.h the same way in pieces of
+** several sizes, that the contexts get bigger with the width (and that
+** the 16 bit one is just its pointers and counts), that an octet count
+** past 32 bits only survives in the 64 bit lexxer and that the 64 bit
+** lexxer can lex more than 4 gigabytes in one call to textlex_update().
+*/
+
+/* Macro Definitions */
+
+#define TEST_RECORD 65536
+
+/* File Includes */
+
+#include <stdio.h>
+#include <string.h>
+
+/* Function Prototypes */
+
+size_t lex16( char * record, const char * text, size_t chunk, unsigned long long start );
+size_t lex32( char * record, const char * text, size_t chunk, unsigned long long start );
+size_t lex64( char * record, const char * text, size_t chunk, unsigned long long start );
+size_t context16( void );
+size_t context32( void );
+size_t context64( void );
+int huge64( void );
+
+/* Global Variables */
+
+static const char * fixtures [] = {
+#include "test_textlex.h"
+  NULL
+};
+
+int main( int argc, char * argv [] ) {
+  static const size_t chunks [] = { 0, 1, 3, 7 };
+  static char expected[ TEST_RECORD ];
+  static char actual[ TEST_RECORD ];
+  size_t expected_length, actual_length;
+  unsigned int i, k;
+  int failed = 0, bad, huge;
+
+  printf( "; BEGIN TESTS\n" );
+
+  for( k = 0; k < sizeof( chunks ) / sizeof( chunks[ 0 ] ); k++ ) {
+    bad = 0;
+
+    for( i = 0; NULL != fixtures[ i ]; i++ ) {
+      expected_length = lex32( expected, fixtures[ i ], chunks[ k ], 0 );
+
+      actual_length = lex16( actual, fixtures[ i ], chunks[ k ], 0 );
+      if( ( expected_length != actual_length ) || ( 0 != memcmp( expected, actual, expected_length ) ) ) {
+        printf( ";  fixture %u 16\n;    %.*s\n;    %.*s\n", i, (int) expected_length, expected, (int) actual_length, actual );
+        bad = 1;
+      }
+
+      actual_length = lex64( actual, fixtures[ i ], chunks[ k ], 0 );
+      if( ( expected_length != actual_length ) || ( 0 != memcmp( expected, actual, expected_length ) ) ) {
+        printf( ";  fixture %u 64\n;    %.*s\n;    %.*s\n", i, (int) expected_length, expected, (int) actual_length, actual );
+        bad = 1;
+      }
+    }
+
+    printf( "; TEST WIDTHS chunk %zu %s\n", chunks[ k ], bad ? "FAILED" : "OK" );
+    failed |= bad;
+  }
+
+  /* The 16 bit context is four pointers and six counts, plus padding. */
+
+  bad = ! ( ( context16() < context32() ) && ( context32() < context64() ) );
+  bad |= ( context16() > 4 * sizeof( void * ) + 8 * sizeof( unsigned short ) );
+  printf( "; TEST CONTEXT %zu < %zu < %zu %s\n", context16(), context32(), context64(), bad ? "FAILED" : "OK" );
+  failed |= bad;
+
+  /* Five octets after 0xFFFFFFFF (which is 0xFFFF in 16 bits.) */
+
+  bad = 0;
+  lex16( actual, "[ 1 ]", 0, 0xFFFFFFFFULL );
+  bad |= ( 0 != strcmp( "9:@0.65535|4:1@0.2|0:@0.2|10:@0.3|E0@0.4", actual ) );
+  lex32( actual, "[ 1 ]", 0, 0xFFFFFFFFULL );
+  bad |= ( 0 != strcmp( "9:@0.4294967295|4:1@0.2|0:@0.2|10:@0.3|E0@0.4", actual ) );
+  lex64( actual, "[ 1 ]", 0, 0xFFFFFFFFULL );
+  bad |= ( 0 != strcmp( "9:@0.4294967295|4:1@0.4294967298|0:@0.4294967298|10:@0.4294967299|E0@0.4294967300", actual ) );
+  printf( "; TEST WRAP %s\n", bad ? "FAILED" : "OK" );
+  failed |= bad;
+
+  huge = huge64();
+  printf( "; TEST HUGE UPDATE %s\n", ( huge < 0 ) ? "SKIPPED (can't map the input)" : huge ? "FAILED" : "OK" );
+  failed |= ( huge > 0 );
+
+  printf( "; END TESTS\n" );
+
+  return( failed ? 2 : 0 );
+}
@@ -0,0 +1,164 @@
+/* test_textwidth_lex.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** The half of test_textwidth that's compiled once for each width, with
+** -DTEXTLEX_WIDTH=16, 32 or 64. Each copy calls textlex_init() and friends
+** like any other program and gets the lexxer of its own width; its
+** functions get the width on the end of their names so test_textwidth.c
+** can call all three. The 64 bit copy also has huge64(), which lexes
+** more than 4 gigabytes in one call to textlex_update().
+*/
+
+/* Macro Definitions */
+
+#define _GNU_SOURCE
+
+#define TEST_PAGE  ( 1024 * 1024 )
+#define TEST_PAGES 4097
+
+#define WIDTH_PASTE( name, width ) name##width
+#define WIDTH_EXPAND( name, width ) WIDTH_PASTE( name, width )
+#define WIDTH_NAME( name ) WIDTH_EXPAND( name, TEXTLEX_WIDTH )
+
+/* File Includes */
+
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include "textlex.h"
+
+/* Function Prototypes */
+
+size_t WIDTH_NAME( lex )( char * record, const char * text, size_t chunk, unsigned long long start );
+size_t WIDTH_NAME( context )( void );
+#if 64 == TEXTLEX_WIDTH
+int huge64( void );
+static tTextLexErr count_callback( tTextLexContext * context, tTextLexCount token );
+#endif
+static tTextLexErr span_callback( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+
+/* Global Variables */
+
+static char * recorded;
+static size_t recorded_length;
+#if 64 == TEXTLEX_WIDTH
+static unsigned long long counted;
+#endif
+
+/* lex()
+**
+** Lexes the text chunk octets at a time (or all at once if chunk is 0),
+** starting with octet set to start, and writes each token, its lexeme and
+** where the lexxer was into record, followed by the error and where the
+** lexxer stopped. Returns the length of the record.
+*/
+
+size_t WIDTH_NAME( lex )( char * record, const char * text, size_t chunk, unsigned long long start ) {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer buffer[ 80 ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t length = strlen( text );
+  size_t offset, piece;
+
+  recorded = record;
+  recorded_length = 0;
+
+  textlex_init( & context, buffer, sizeof( buffer ) );
+  textlex_extend( & context, & extension );
+  extension.span = span_callback;
+  context.octet = (tTextLexCount) start;
+
+  for( offset = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += piece ) {
+    piece = ( ( 0 == chunk ) || ( length - offset < chunk ) ) ? length - offset : chunk;
+    err = textlex_update( & context, (tTextLexBuffer *) text + offset, (tTextLexCount) piece );
+  }
+
+  if( TEXTLEX_E_NOERR == err ) {
+    err = textlex_final( & context );
+  }
+
+  recorded_length += sprintf( recorded + recorded_length, "E%u@%llu.%llu", (unsigned int) err,
+                              (unsigned long long) context.line, (unsigned long long) context.octet );
+
+  return( recorded_length );
+}
+
+size_t WIDTH_NAME( context )( void ) {
+  return( sizeof( tTextLexContext ) );
+}
+
+#if 64 == TEXTLEX_WIDTH
+
+/* huge64()
+**
+** Maps the same megabyte of a memfd TEST_PAGES times in a row, so there's
+** a little more than 4 gigabytes of input without needing that much
+** memory, and lexes all of it in one call to textlex_update(). Each
+** megabyte is spaces followed by "1\n", so it has to see TEST_PAGES
+** integers and end up on line TEST_PAGES. Returns 0 if it does, 1 if it
+** doesn't and -1 if the input can't be mapped.
+*/
+
+int huge64( void ) {
+  tTextLexContext context;
+  tTextLexBuffer buffer[ 80 ];
+  unsigned char * input, * page;
+  size_t length = (size_t) TEST_PAGE * TEST_PAGES;
+  unsigned int i;
+  int fd, bad = -1;
+
+  if( -1 == ( fd = memfd_create( "test_textwidth", 0 ) ) ) {
+    return( -1 );
+  }
+
+  if( ( 0 != ftruncate( fd, TEST_PAGE ) ) ||
+      ( MAP_FAILED == ( page = mmap( NULL, TEST_PAGE, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0 ) ) ) ) {
+    close( fd );
+    return( -1 );
+  }
+  memset( page, ' ', TEST_PAGE );
+  memcpy( page + TEST_PAGE - 2, "1\n", 2 );
+  munmap( page, TEST_PAGE );
+
+  /* Reserve the whole range, then put the page in each megabyte of it. */
+
+  if( MAP_FAILED != ( input = mmap( NULL, length, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0 ) ) ) {
+    for( i = 0; i < TEST_PAGES; i++ ) {
+      if( MAP_FAILED == mmap( input + (size_t) TEST_PAGE * i, TEST_PAGE, PROT_READ, MAP_SHARED | MAP_FIXED, fd, 0 ) ) {
+        break;
+      }
+    }
+
+    if( TEST_PAGES == i ) {
+      counted = 0;
+      textlex_init( & context, buffer, sizeof( buffer ) );
+      context.token = count_callback;
+      bad = ( TEXTLEX_E_NOERR != textlex_update( & context, input, length ) ) || ( TEXTLEX_E_NOERR != textlex_final( & context ) ) ||
+        ( TEST_PAGES * 2ULL != counted ) || ( TEST_PAGES != context.line );
+    }
+
+    munmap( input, length );
+  }
+
+  close( fd );
+
+  return( bad );
+}
+
+static tTextLexErr count_callback( tTextLexContext * context, tTextLexCount token ) {
+  counted++;
+  return( TEXTLEX_E_NOERR );
+}
+
+#endif
+
+static tTextLexErr span_callback( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  recorded_length += sprintf( recorded + recorded_length, "%u:%.*s@%llu.%llu|", (unsigned int) token, (int) length, (char *) data,
+                              (unsigned long long) context->line, (unsigned long long) context->octet );
+
+  return( TEXTLEX_E_NOERR );
+}
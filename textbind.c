@@ -0,0 +1,640 @@
+/* textbind.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file implements the DSD Struct Binder. Please see textbind.h for
+** more info.
+*/
+
+/* Macro Definitions */
+
+#define _FLOAT          64
+
+/* What an open container expects next. Arrays always expect an item; maps
+** go round from a key to '=' to a value.
+*/
+
+#define _EXPECT_ITEM     0
+#define _EXPECT_EQUALS   1
+#define _EXPECT_VALUE    2
+
+/* What the last value token belonged to, in case the next one carries on
+** where it left off.
+*/
+
+#define _PENDING_NONE    0
+#define _PENDING_KEY     1
+#define _PENDING_VALUE   2
+
+/* File Includes */
+
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+#include "textbind.h"
+
+/* Function Prototypes */
+
+static tTextLexErr _skip( tTextBindContext * context, unsigned int token );
+static tTextLexErr _value( tTextBindContext * context, tTextBindFrame * frame, unsigned int token, const unsigned char * data, size_t length );
+static tTextLexErr _open( tTextBindContext * context, const tTextBindField * field, unsigned char * base, unsigned int token );
+static tTextLexErr _atom( tTextBindContext * context, const tTextBindField * field, unsigned char * base, unsigned char * target, unsigned int token, const unsigned char * data, size_t length );
+static tTextLexErr _piece( tTextBindContext * context, const unsigned char * data, size_t length );
+static tTextLexErr _integer( tTextBindContext * context );
+static tTextLexErr _finish( tTextBindContext * context );
+static int _literal( const unsigned char * data, size_t length, const char * name );
+static tTextLexErr _span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+
+/* Global Variables */
+
+/* Digit values plus one; zero means "not a digit." */
+
+static const unsigned char _hex[ 256 ] = {
+  [ '0' ] = 1, [ '1' ] = 2, [ '2' ] = 3, [ '3' ] = 4, [ '4' ] = 5, [ '5' ] = 6, [ '6' ] = 7, [ '7' ] = 8,
+  [ '8' ] = 9, [ '9' ] = 10, [ 'a' ] = 11, [ 'b' ] = 12, [ 'c' ] = 13, [ 'd' ] = 14, [ 'e' ] = 15, [ 'f' ] = 16,
+  [ 'A' ] = 11, [ 'B' ] = 12, [ 'C' ] = 13, [ 'D' ] = 14, [ 'E' ] = 15, [ 'F' ] = 16
+};
+
+static const unsigned char _sextet[ 256 ] = {
+  [ 'A' ] = 1, [ 'B' ] = 2, [ 'C' ] = 3, [ 'D' ] = 4, [ 'E' ] = 5, [ 'F' ] = 6, [ 'G' ] = 7, [ 'H' ] = 8,
+  [ 'I' ] = 9, [ 'J' ] = 10, [ 'K' ] = 11, [ 'L' ] = 12, [ 'M' ] = 13, [ 'N' ] = 14, [ 'O' ] = 15, [ 'P' ] = 16,
+  [ 'Q' ] = 17, [ 'R' ] = 18, [ 'S' ] = 19, [ 'T' ] = 20, [ 'U' ] = 21, [ 'V' ] = 22, [ 'W' ] = 23, [ 'X' ] = 24,
+  [ 'Y' ] = 25, [ 'Z' ] = 26, [ 'a' ] = 27, [ 'b' ] = 28, [ 'c' ] = 29, [ 'd' ] = 30, [ 'e' ] = 31, [ 'f' ] = 32,
+  [ 'g' ] = 33, [ 'h' ] = 34, [ 'i' ] = 35, [ 'j' ] = 36, [ 'k' ] = 37, [ 'l' ] = 38, [ 'm' ] = 39, [ 'n' ] = 40,
+  [ 'o' ] = 41, [ 'p' ] = 42, [ 'q' ] = 43, [ 'r' ] = 44, [ 's' ] = 45, [ 't' ] = 46, [ 'u' ] = 47, [ 'v' ] = 48,
+  [ 'w' ] = 49, [ 'x' ] = 50, [ 'y' ] = 51, [ 'z' ] = 52, [ '0' ] = 53, [ '1' ] = 54, [ '2' ] = 55, [ '3' ] = 56,
+  [ '4' ] = 57, [ '5' ] = 58, [ '6' ] = 59, [ '7' ] = 60, [ '8' ] = 61, [ '9' ] = 62, [ '+' ] = 63, [ '/' ] = 64
+};
+
+/* Function Definitions */
+
+void textbind_init( tTextBindContext * context, const tTextBindMap * map, void * output ) {
+  context->map = map;
+  textbind_reset( context, output );
+}
+
+void textbind_reset( tTextBindContext * context, void * output ) {
+  textlex_init( & context->text, context->buffer, TEXTBIND_BUFFER );
+  textlex_extend( & context->text, & context->extension );
+  context->extension.span = _span;
+
+  memset( output, 0, context->map->size );
+  context->output = output;
+
+  context->depth = 0;
+  context->done = 0;
+  context->skip = 0;
+  context->skipped = 0;
+  context->open = 0;
+  context->base16 = 0;
+  context->pending = _PENDING_NONE;
+  context->field = NULL;
+  context->target = NULL;
+}
+
+tTextLexErr textbind_update( tTextBindContext * context, tTextLexBuffer * data, tTextLexCount length ) {
+  return( textlex_update( & context->text, data, length ) );
+}
+
+tTextLexErr textbind_final( tTextBindContext * context ) {
+  tTextLexErr err;
+
+  if( TEXTLEX_E_NOERR != ( err = textlex_final( & context->text ) ) ) {
+    return( err );
+  }
+
+  if( TEXTLEX_E_NOERR != ( err = _finish( context ) ) ) {
+    return( err );
+  }
+
+  return( context->done ? TEXTLEX_E_NOERR : ( ( 0 == context->depth ) ? TEXTBIND_E_STRUCTURE : TEXTBIND_E_UNCLOSED ) );
+}
+
+tTextLexErr textbind_token( tTextBindContext * context, unsigned int token, const unsigned char * data, size_t length ) {
+  tTextBindFrame * frame;
+  tTextLexErr err;
+  int index;
+
+  switch( token ) {
+  case TEXTLEX_T_END:
+    context->open = 0;
+    return( TEXTLEX_E_NOERR );
+
+  case TEXTLEX_T_COMMENT:
+    /* A comment inside a base16 string splits it in two. */
+    if( TEXTLEX_S_BASE16_COMMENT == context->text.state ) {
+      context->base16 = 1;
+    }
+    return( TEXTLEX_E_NOERR );
+
+  case TEXTLEX_T_ANNOTATION:
+    return( TEXTLEX_E_NOERR );
+  }
+
+  /* Lexemes bigger than the lexxer's buffer come in pieces with no
+  ** TEXTLEX_T_END between them, and base16 strings come in pieces with
+  ** comments between them. Either way, the next piece carries on from the
+  ** last one.
+  */
+
+  if( ( context->open || context->base16 ) && ( token == context->token ) ) {
+    context->base16 = 0;
+    context->open = 1;
+    if( _PENDING_KEY == context->pending ) {
+      /* No key in the struct is this long. */
+      context->frames[ context->depth - 1 ].field = NULL;
+    } else if( NULL != context->target ) {
+      return( _piece( context, data, length ) );
+    }
+    return( TEXTLEX_E_NOERR );
+  }
+
+  context->base16 = 0;
+
+  if( TEXTLEX_E_NOERR != ( err = _finish( context ) ) ) {
+    return( err );
+  }
+
+  if( 0 != context->skipped ) {
+    return( _skip( context, token ) );
+  }
+
+  if( 0 == context->depth ) {
+    if( context->done || ( TEXTLEX_T_MAP_OPEN != token ) ) {
+      return( TEXTBIND_E_STRUCTURE );
+    }
+    frame = & context->frames[ context->depth++ ];
+    frame->type = TEXTLEX_T_MAP_OPEN;
+    frame->expect = _EXPECT_ITEM;
+    frame->map = context->map;
+    frame->field = NULL;
+    frame->base = (unsigned char *) context->output;
+    return( TEXTLEX_E_NOERR );
+  }
+
+  frame = & context->frames[ context->depth - 1 ];
+
+  if( TEXTLEX_T_ARRAY_OPEN == frame->type ) {
+    switch( token ) {
+    case TEXTLEX_T_ARRAY_CLOSE:
+      context->depth--;
+      return( TEXTLEX_E_NOERR );
+
+    case TEXTLEX_T_MAP_CLOSE:
+    case TEXTLEX_T_EQUALS:
+      return( TEXTBIND_E_STRUCTURE );
+    }
+    return( _value( context, frame, token, data, length ) );
+  }
+
+  switch( frame->expect ) {
+  case _EXPECT_ITEM:
+    if( TEXTLEX_T_MAP_CLOSE == token ) {
+      if( 0 == --context->depth ) {
+        context->done = 1;
+      }
+      return( TEXTLEX_E_NOERR );
+    }
+    if( ( TEXTLEX_T_ARRAY_OPEN == token ) || ( TEXTLEX_T_MAP_OPEN == token ) || ( TEXTLEX_T_ARRAY_CLOSE == token ) || ( TEXTLEX_T_EQUALS == token ) ) {
+      return( TEXTBIND_E_STRUCTURE );
+    }
+    frame->field = NULL;
+    if( ( TEXTLEX_T_STRING == token ) && ( 0 <= ( index = frame->map->lookup( data, length ) ) ) ) {
+      frame->field = & frame->map->fields[ index ];
+    }
+    frame->expect = _EXPECT_EQUALS;
+    context->pending = _PENDING_KEY;
+    context->token = token;
+    context->open = 1;
+    return( TEXTLEX_E_NOERR );
+
+  case _EXPECT_EQUALS:
+    if( TEXTLEX_T_EQUALS != token ) {
+      return( TEXTBIND_E_STRUCTURE );
+    }
+    frame->expect = _EXPECT_VALUE;
+    return( TEXTLEX_E_NOERR );
+
+  default:
+    if( ( TEXTLEX_T_ARRAY_CLOSE == token ) || ( TEXTLEX_T_MAP_CLOSE == token ) || ( TEXTLEX_T_EQUALS == token ) ) {
+      return( TEXTBIND_E_STRUCTURE );
+    }
+    frame->expect = _EXPECT_ITEM;
+    return( _value( context, frame, token, data, length ) );
+  }
+}
+
+tTextLexErr textbind_parse( const tTextBindMap * map, void * output, const unsigned char * data, size_t length ) {
+  tTextBindContext context;
+  tTextLexErr err;
+
+  textbind_init( & context, map, output );
+
+  if( TEXTLEX_E_NOERR != ( err = textbind_update( & context, (tTextLexBuffer *) data, length ) ) ) {
+    return( err );
+  }
+
+  return( textbind_final( & context ) );
+}
+
+/* Function Definitions : Static Functions */
+
+/* _skip()
+**
+** Steps over a value whose key isn't in the struct. skip is a stack of bits,
+** one for each array or map the value has open, so the brackets can be
+** checked without a frame for each of them.
+*/
+
+static tTextLexErr _skip( tTextBindContext * context, unsigned int token ) {
+  unsigned long long bit;
+
+  switch( token ) {
+  case TEXTLEX_T_ARRAY_OPEN:
+  case TEXTLEX_T_MAP_OPEN:
+    if( TEXTBIND_SKIP_DEPTH == context->skipped ) {
+      return( TEXTBIND_E_STRUCTURE );
+    }
+    context->skip = ( context->skip << 1 ) | ( TEXTLEX_T_MAP_OPEN == token );
+    context->skipped++;
+    break;
+
+  case TEXTLEX_T_ARRAY_CLOSE:
+  case TEXTLEX_T_MAP_CLOSE:
+    bit = ( TEXTLEX_T_MAP_CLOSE == token );
+    if( bit != ( context->skip & 1 ) ) {
+      return( TEXTBIND_E_STRUCTURE );
+    }
+    context->skip >>= 1;
+    context->skipped--;
+    break;
+
+  case TEXTLEX_T_EQUALS:
+    break;
+
+  default:
+    context->pending = _PENDING_VALUE;
+    context->token = token;
+    context->target = NULL;
+    context->open = 1;
+    break;
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* _value()
+**
+** Binds a value (or the start of one) to the member the frame says it goes
+** in. In a map, that's the member for the last key; in an array it's the
+** next element.
+*/
+
+static tTextLexErr _value( tTextBindContext * context, tTextBindFrame * frame, unsigned int token, const unsigned char * data, size_t length ) {
+  const tTextBindField * field = frame->field;
+  unsigned char * base = frame->base;
+  unsigned char * target = base;
+  size_t * count;
+  int nil = ( TEXTLEX_T_LITERAL == token ) && _literal( data, length, "nil" );
+
+  if( NULL == field ) {
+    return( _skip( context, token ) );
+  }
+
+  if( TEXTLEX_T_ARRAY_OPEN == frame->type ) {
+    /* A *nil element still takes up its place in the array. */
+    count = (size_t *) ( base + field->count );
+    if( * count == field->items ) {
+      return( TEXTBIND_E_RANGE );
+    }
+    target = base + field->offset + ( * count )++ * field->stride;
+  } else if( nil ) {
+    /* Leave the member alone. */
+  } else if( 0 != field->items ) {
+    if( TEXTLEX_T_ARRAY_OPEN != token ) {
+      return( TEXTBIND_E_TYPE );
+    }
+    * (size_t *) ( base + field->count ) = 0;
+    return( _open( context, field, base, token ) );
+  } else {
+    target = base + field->offset;
+  }
+
+  if( nil ) {
+    return( _skip( context, token ) );
+  }
+
+  if( TEXTBIND_K_MAP == field->kind ) {
+    if( TEXTLEX_T_MAP_OPEN != token ) {
+      return( TEXTBIND_E_TYPE );
+    }
+    return( _open( context, field, target, token ) );
+  }
+
+  if( ( TEXTLEX_T_ARRAY_OPEN == token ) || ( TEXTLEX_T_MAP_OPEN == token ) ) {
+    return( TEXTBIND_E_TYPE );
+  }
+
+  return( _atom( context, field, base, target, token, data, length ) );
+}
+
+static tTextLexErr _open( tTextBindContext * context, const tTextBindField * field, unsigned char * base, unsigned int token ) {
+  tTextBindFrame * frame;
+
+  if( TEXTBIND_DEPTH == context->depth ) {
+    return( TEXTBIND_E_STRUCTURE );
+  }
+
+  frame = & context->frames[ context->depth++ ];
+  frame->type = token;
+  frame->expect = _EXPECT_ITEM;
+  frame->base = base;
+
+  if( TEXTLEX_T_MAP_OPEN == token ) {
+    frame->map = field->map;
+    frame->field = NULL;
+  } else {
+    frame->map = NULL;
+    frame->field = field;
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* _atom()
+**
+** Checks an atom is the right type for its member and starts filling the
+** member in.
+*/
+
+static tTextLexErr _atom( tTextBindContext * context, const tTextBindField * field, unsigned char * base, unsigned char * target, unsigned int token, const unsigned char * data, size_t length ) {
+  int match;
+
+  switch( field->kind ) {
+  case TEXTBIND_K_INT:
+  case TEXTBIND_K_UNSIGNED:
+  case TEXTBIND_K_LONG:
+    match = ( TEXTLEX_T_INTEGER == token ) || ( TEXTLEX_T_HEX == token );
+    break;
+
+  case TEXTBIND_K_DOUBLE:
+    match = ( TEXTLEX_T_FLOAT == token ) || ( TEXTLEX_T_INTEGER == token );
+    break;
+
+  case TEXTBIND_K_BOOLEAN:
+    match = ( TEXTLEX_T_LITERAL == token );
+    break;
+
+  case TEXTBIND_K_OCTETS:
+    match = ( TEXTLEX_T_HEX == token ) || ( TEXTLEX_T_BASE64 == token ) || ( TEXTLEX_T_STRING == token );
+    break;
+
+  case TEXTBIND_K_STRING:
+    match = ( TEXTLEX_T_STRING == token );
+    break;
+
+  default:
+    match = 0;
+    break;
+  }
+
+  if( ! match ) {
+    return( TEXTBIND_E_TYPE );
+  }
+
+  context->pending = _PENDING_VALUE;
+  context->token = token;
+  context->open = 1;
+  context->field = field;
+  context->base = base;
+  context->target = target;
+  context->fill = 0;
+  context->magnitude = 0;
+  context->negative = 0;
+  context->bits = 0;
+  context->nbits = 0;
+
+  if( TEXTBIND_K_OCTETS == field->kind ) {
+    * (size_t *) ( base + field->count ) = 0;
+  } else if( TEXTBIND_K_STRING == field->kind ) {
+    target[ 0 ] = '\0';
+  }
+
+  return( _piece( context, data, length ) );
+}
+
+/* _piece()
+**
+** Writes (a piece of) a value into its member. Numbers are accumulated a
+** digit at a time and stored after every piece, so nothing has to be kept
+** but the running total; binary data is decoded straight into the member.
+*/
+
+static tTextLexErr _piece( tTextBindContext * context, const unsigned char * data, size_t length ) {
+  const tTextBindField * field = context->field;
+  unsigned char * target = context->target;
+  const unsigned char * end = data + length;
+  char number[ _FLOAT ];
+  unsigned int digit;
+  double real;
+  int value;
+
+  switch( field->kind ) {
+  case TEXTBIND_K_INT:
+  case TEXTBIND_K_UNSIGNED:
+  case TEXTBIND_K_LONG:
+    if( TEXTLEX_T_HEX == context->token ) {
+      for( ; data < end; data++ ) {
+        if( 0 != ( context->magnitude >> 60 ) ) {
+          return( TEXTBIND_E_RANGE );
+        }
+        context->magnitude = ( context->magnitude << 4 ) | ( _hex[ * data ] - 1 );
+      }
+    } else {
+      if( ( 0 == context->fill ) && ( data < end ) && ( '-' == * data ) ) {
+        context->negative = 1;
+        data++;
+      }
+      context->fill += length;
+      for( ; data < end; data++ ) {
+        digit = * data - '0';
+        if( context->magnitude > ( ULLONG_MAX - digit ) / 10 ) {
+          return( TEXTBIND_E_RANGE );
+        }
+        context->magnitude = context->magnitude * 10 + digit;
+      }
+    }
+    return( _integer( context ) );
+
+  case TEXTBIND_K_DOUBLE:
+    if( ( 0 != context->fill ) || ( length >= _FLOAT ) ) {
+      return( TEXTBIND_E_RANGE );
+    }
+    context->fill = length;
+    memcpy( number, data, length );
+    number[ length ] = '\0';
+    real = strtod( number, NULL );
+    memcpy( target, & real, sizeof( double ) );
+    return( TEXTLEX_E_NOERR );
+
+  case TEXTBIND_K_BOOLEAN:
+    if( 0 != context->fill ) {
+      return( TEXTBIND_E_TYPE );
+    }
+    context->fill = length;
+    if( _literal( data, length, "true" ) ) {
+      value = 1;
+    } else if( _literal( data, length, "false" ) ) {
+      value = 0;
+    } else {
+      return( TEXTBIND_E_TYPE );
+    }
+    memcpy( target, & value, sizeof( int ) );
+    return( TEXTLEX_E_NOERR );
+
+  case TEXTBIND_K_STRING:
+    if( length > field->size - context->fill ) {
+      return( TEXTBIND_E_RANGE );
+    }
+    memcpy( target + context->fill, data, length );
+    context->fill += length;
+    target[ context->fill ] = '\0';
+    return( TEXTLEX_E_NOERR );
+  }
+
+  /* That leaves octets. bits holds the digits that don't make up a whole
+  ** octet yet and nbits says how many bits of them there are.
+  */
+
+  switch( context->token ) {
+  case TEXTLEX_T_STRING:
+    if( length > field->size - context->fill ) {
+      return( TEXTBIND_E_RANGE );
+    }
+    memcpy( target + context->fill, data, length );
+    context->fill += length;
+    break;
+
+  case TEXTLEX_T_HEX:
+    for( ; data < end; data++ ) {
+      context->bits = ( context->bits << 4 ) | ( _hex[ * data ] - 1 );
+      if( 0 == ( context->nbits ^= 4 ) ) {
+        if( context->fill == field->size ) {
+          return( TEXTBIND_E_RANGE );
+        }
+        target[ context->fill++ ] = (unsigned char) context->bits;
+        context->bits = 0;
+      }
+    }
+    break;
+
+  default:
+    for( ; data < end; data++ ) {
+      if( 0 == ( digit = _sextet[ * data ] ) ) {
+        continue;
+      }
+      context->bits = ( ( context->bits << 6 ) | ( digit - 1 ) ) & 0xFFF;
+      if( ( context->nbits += 6 ) >= 8 ) {
+        context->nbits -= 8;
+        if( context->fill == field->size ) {
+          return( TEXTBIND_E_RANGE );
+        }
+        target[ context->fill++ ] = (unsigned char) ( context->bits >> context->nbits );
+      }
+    }
+    break;
+  }
+
+  * (size_t *) ( context->base + field->count ) = context->fill;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* _integer()
+**
+** Stores the running total of an integer in its member, if it fits.
+*/
+
+static tTextLexErr _integer( tTextBindContext * context ) {
+  unsigned long long magnitude = context->magnitude;
+  unsigned long long limit;
+  long long value;
+  int small;
+  unsigned int unsigned_small;
+
+  switch( context->field->kind ) {
+  case TEXTBIND_K_INT:
+    limit = context->negative ? 0ULL - (unsigned long long) INT_MIN : INT_MAX;
+    break;
+
+  case TEXTBIND_K_UNSIGNED:
+    limit = context->negative ? 0 : UINT_MAX;
+    break;
+
+  default:
+    limit = context->negative ? 0ULL - (unsigned long long) LLONG_MIN : LLONG_MAX;
+    break;
+  }
+
+  if( magnitude > limit ) {
+    return( TEXTBIND_E_RANGE );
+  }
+
+  value = context->negative ? (long long) ( 0ULL - magnitude ) : (long long) magnitude;
+
+  switch( context->field->kind ) {
+  case TEXTBIND_K_INT:
+    small = (int) value;
+    memcpy( context->target, & small, sizeof( int ) );
+    break;
+
+  case TEXTBIND_K_UNSIGNED:
+    unsigned_small = (unsigned int) magnitude;
+    memcpy( context->target, & unsigned_small, sizeof( unsigned int ) );
+    break;
+
+  default:
+    memcpy( context->target, & value, sizeof( long long ) );
+    break;
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* _finish()
+**
+** Called when the next token shows the last value is complete. The only
+** thing left to check is that hex octets didn't end on half an octet.
+*/
+
+static tTextLexErr _finish( tTextBindContext * context ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+
+  if( ( _PENDING_VALUE == context->pending ) && ( NULL != context->target ) && ( TEXTBIND_K_OCTETS == context->field->kind ) &&
+      ( TEXTLEX_T_HEX == context->token ) && ( 0 != context->nbits ) ) {
+    err = TEXTBIND_E_TYPE;
+  }
+
+  context->pending = _PENDING_NONE;
+  context->target = NULL;
+
+  return( err );
+}
+
+/* _literal()
+**
+** Compares a literal with a lower case name, ignoring case.
+*/
+
+static int _literal( const unsigned char * data, size_t length, const char * name ) {
+  size_t i;
+
+  for( i = 0; ( i < length ) && ( '\0' != name[ i ] ) && ( ( data[ i ] | 0x20 ) == name[ i ] ); i++ );
+
+  return( ( i == length ) && ( '\0' == name[ i ] ) );
+}
+
+static tTextLexErr _span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  return( textbind_token( (tTextBindContext *) context, token, data, length ) );
+}
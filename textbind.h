@@ -0,0 +1,195 @@
+/* textbind.h
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file provides the interface to the DSD Struct Binder implemented in
+** textbind.c. The binder reads a document holding one map and writes its
+** values straight into the members of a C struct. It's driven by a table
+** that says where each member is and what it holds, and by a function that
+** turns a key into an index into that table.
+**
+** You don't write the tables by hand: textgen reads a schema and writes a
+** header declaring the struct and a C file holding its tables, with the key
+** lookup compiled down to a trie of switch statements over the key's
+** octets. See textgen.c for the schema format.
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_TEXTBIND
+#define _H_TEXTBIND
+
+/* Macro Definitions : Error Codes
+**
+** The first two have the same values and meanings as TEXTDOM_E_STRUCTURE
+** and TEXTDOM_E_UNCLOSED.
+*/
+
+#define TEXTBIND_E_STRUCTURE    100 /* A token where it doesn't belong */
+#define TEXTBIND_E_UNCLOSED     101 /* Document ended inside the map */
+#define TEXTBIND_E_TYPE         102 /* A value of the wrong type for its member */
+#define TEXTBIND_E_RANGE        103 /* A value too big for its member */
+
+/* Macro Definitions : Member Kinds
+**
+** TEXTBIND_K_OCTETS members are an array of unsigned char with a size_t
+** holding how many of them were filled in. TEXTBIND_K_STRING members are
+** an array of char one longer than the longest string they hold, which is
+** always terminated with a '\0'.
+*/
+
+#define TEXTBIND_K_INT            1 /* int */
+#define TEXTBIND_K_UNSIGNED       2 /* unsigned int */
+#define TEXTBIND_K_LONG           3 /* long long */
+#define TEXTBIND_K_DOUBLE         4 /* double */
+#define TEXTBIND_K_BOOLEAN        5 /* int */
+#define TEXTBIND_K_OCTETS         6 /* unsigned char [ size ] and a size_t */
+#define TEXTBIND_K_STRING         7 /* char [ size + 1 ] */
+#define TEXTBIND_K_MAP            8 /* a nested struct */
+
+/* The lexxer's buffer. It's only used for lexemes that straddle calls to
+** textbind_update(), strings with escapes in them and base16 strings with
+** white space in them; lexemes bigger than this are delivered in pieces,
+** which the binder puts back together.
+*/
+
+#define TEXTBIND_BUFFER         256
+
+/* How deep maps and arrays can be nested in the struct, and how deep values
+** for keys that aren't in the struct can be nested.
+*/
+
+#define TEXTBIND_DEPTH           16
+#define TEXTBIND_SKIP_DEPTH      64
+
+/* File Includes */
+
+#include <stddef.h>
+#include "textlex.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+struct _text_bind_map;
+
+/* One member of a struct. offset is where it is (from offsetof()) and size
+** is how many octets an octets member holds or how many characters a string
+** member holds. For octets members, count is the offset of the size_t that
+** gets the number of octets filled in.
+**
+** A member can also be a fixed size array of the things above (except
+** octets). Then items is how many elements it has, stride is how big each
+** of them is and count is the offset of the size_t that gets the number of
+** elements filled in. items is zero for members that aren't arrays.
+**
+** map describes the struct a TEXTBIND_K_MAP member (or each element of an
+** array of them) holds.
+*/
+
+typedef struct {
+  unsigned int                    kind;
+  size_t                          offset;
+  size_t                          size;
+  size_t                          count;
+  size_t                          items;
+  size_t                          stride;
+  const struct _text_bind_map   * map;
+} tTextBindField;
+
+/* A struct. lookup() returns the index in fields of the member a key
+** belongs to, or -1 for keys that aren't in the struct. size is
+** sizeof() the struct.
+*/
+
+typedef struct _text_bind_map {
+  size_t                          size;
+  int                          ( *lookup )( const unsigned char * key, size_t length );
+  const tTextBindField          * fields;
+} tTextBindMap;
+
+/* An array or map the binder is in the middle of. */
+
+typedef struct {
+  unsigned int                    type;
+  unsigned int                    expect;
+  const tTextBindMap            * map;
+  const tTextBindField          * field;
+  unsigned char                 * base;
+} tTextBindFrame;
+
+/* The binder's context. text is first, so the lexxer's callbacks can find
+** the rest of it. The value fields keep track of the member being filled in
+** while its value arrives in pieces.
+*/
+
+typedef struct {
+  tTextLexContext                 text;
+  tTextLexExtension               extension;
+  tTextLexBuffer                  buffer[ TEXTBIND_BUFFER ];
+  const tTextBindMap            * map;
+  void                          * output;
+  tTextBindFrame                  frames[ TEXTBIND_DEPTH ];
+  unsigned int                    depth;
+  unsigned int                    done;
+  unsigned long long              skip;
+  unsigned int                    skipped;
+  unsigned int                    open;
+  unsigned int                    base16;
+  unsigned int                    pending;
+  unsigned int                    token;
+  const tTextBindField          * field;
+  unsigned char                 * base;
+  unsigned char                 * target;
+  size_t                          fill;
+  unsigned long long              magnitude;
+  unsigned int                    negative;
+  unsigned int                    bits;
+  unsigned int                    nbits;
+} tTextBindContext;
+
+/* Function Prototypes */
+
+/* textbind_init() and textbind_reset()
+**
+** Get a binder ready to fill in output, which should point at the struct
+** map describes. Both zero the struct first, so members whose keys aren't
+** in the document are left zero. Call textbind_reset() to reuse a binder
+** for the next document; nothing is allocated, so there's nothing to free.
+*/
+
+void textbind_init( tTextBindContext * context, const tTextBindMap * map, void * output );
+void textbind_reset( tTextBindContext * context, void * output );
+
+/* textbind_update() and textbind_final()
+**
+** Feed the binder the document, in as many pieces as you like, then call
+** textbind_final(). The document has to be one map (an annotation in front
+** of it is fine.) Keys that aren't in the struct are skipped along with
+** their values; a value of the wrong type for its member returns
+** TEXTBIND_E_TYPE and one that doesn't fit in it returns TEXTBIND_E_RANGE.
+** A *nil value leaves its member alone.
+**
+** Skipped values are only checked for matching brackets. If a key appears
+** more than once, the last value wins.
+*/
+
+tTextLexErr textbind_update( tTextBindContext * context, tTextLexBuffer * data, tTextLexCount length );
+tTextLexErr textbind_final( tTextBindContext * context );
+
+/* textbind_token()
+**
+** Passes one token to the binder, for when the tokens come from somewhere
+** other than the text lexxer, like the DSD/Binary lexxer's span callback.
+*/
+
+tTextLexErr textbind_token( tTextBindContext * context, unsigned int token, const unsigned char * data, size_t length );
+
+/* textbind_parse()
+**
+** Binds a whole document in one call, with a binder on the stack. The
+** functions textgen writes for each schema call this one.
+*/
+
+tTextLexErr textbind_parse( const tTextBindMap * map, void * output, const unsigned char * data, size_t length );
+
+#endif /* _H_TEXTBIND */
@@ -0,0 +1,408 @@
+/* textcorpus.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program writes synthetic DSD/Text for benchmarking the lexxer:
+**
+**   textcorpus <shape> [seed [octets]]
+**
+** writes documents of the given shape to standard output, one after
+** another, until it has written at least octets octets (a megabyte if you
+** don't say.) Everything comes from a xorshift generator started from seed
+** (2026 if you don't say), so the same arguments always write the same
+** text. The shapes are:
+**
+**   deep     arrays and maps nested 32 to 256 deep around a single number
+**   wide     maps with 256 to 1024 keys of short strings, numbers and
+**            literals
+**   strings  arrays of strings between 1 and 64 kilobytes long, with the
+**            odd quote and backslash to escape
+**   numbers  arrays of integers, floats and hex numbers
+**   config   commented maps written one item to a line, like example.dsd
+**   blobs    arrays of base16 and base64 strings of random octets
+**
+** The documents are written with the DSD Text Writer (see textenc.h), so
+** they always lex.
+*/
+
+/* Macro Definitions */
+
+#define CORPUS_OUTPUT_SIZE  ( 64 * 1024 )
+#define CORPUS_BLOB_SIZE    ( 16 * 1024 )
+#define CORPUS_STRING_SIZE  ( 64 * 1024 )
+#define CORPUS_MAX_DEPTH    256
+
+#define CORPUS_S_DEEP       0
+#define CORPUS_S_WIDE       1
+#define CORPUS_S_STRINGS    2
+#define CORPUS_S_NUMBERS    3
+#define CORPUS_S_CONFIG     4
+#define CORPUS_S_BLOBS      5
+#define CORPUS_C_SHAPES     6
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "textenc.h"
+
+/* Function Prototypes */
+
+static unsigned long long next( void );
+static tTextLexErr word( tTextEncContext * writer, unsigned int token, unsigned int count );
+static tTextLexErr deep( tTextEncContext * writer );
+static tTextLexErr wide( tTextEncContext * writer );
+static tTextLexErr strings( tTextEncContext * writer );
+static tTextLexErr numbers( tTextEncContext * writer );
+static tTextLexErr config( tTextEncContext * writer );
+static tTextLexErr blobs( tTextEncContext * writer );
+static tTextLexErr flush( tTextEncContext * context );
+
+/* Global Variables */
+
+static const char * shapes [] = { "deep", "wide", "strings", "numbers", "config", "blobs" };
+
+static tTextLexErr ( * const writers [] )( tTextEncContext * writer ) = {
+  deep, wide, strings, numbers, config, blobs
+};
+
+static const char * words [] = {
+  "alpha", "bravo", "charlie", "delta", "echo", "foxtrot", "golf", "hotel",
+  "india", "juliet", "kilo", "lima", "mike", "november", "oscar", "papa"
+};
+
+static unsigned long long state;
+
+int main( int argc, char * argv [] ) {
+  static unsigned char buffer[ CORPUS_OUTPUT_SIZE ];
+  tTextEncContext writer;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  unsigned long long octets = 1024 * 1024;
+  unsigned int shape;
+
+  for( shape = 0; shape < CORPUS_C_SHAPES; shape++ ) {
+    if( ( argc > 1 ) && ( 0 == strcmp( argv[ 1 ], shapes[ shape ] ) ) ) {
+      break;
+    }
+  }
+
+  if( ( argc < 2 ) || ( argc > 4 ) || ( CORPUS_C_SHAPES == shape ) ) {
+    fprintf( stderr, "%%TEXTCORPUS-F-USAGE; Usage: %s <deep|wide|strings|numbers|config|blobs> [seed [octets]]\n", argv[ 0 ] );
+    return( 1 );
+  }
+
+  state = ( argc > 2 ) ? strtoull( argv[ 2 ], NULL, 0 ) : 2026;
+  if( argc > 3 ) {
+    octets = strtoull( argv[ 3 ], NULL, 0 );
+  }
+
+  /* Xorshift gets stuck at zero, and the first few numbers from a small
+  ** seed are small too, so mix the seed up first.
+  */
+
+  state = ( state ^ 0x9E3779B97F4A7C15ULL ) * 0xBF58476D1CE4E5B9ULL;
+  if( 0 == state ) {
+    state = 1;
+  }
+
+  textenc_init( & writer, buffer, sizeof( buffer ), ( CORPUS_S_CONFIG == shape ) ? TEXTENC_M_PRETTY : TEXTENC_M_COMPACT );
+  writer.flush = flush;
+
+  while( ( TEXTLEX_E_NOERR == err ) && ( writer.written < octets ) ) {
+    err = writers[ shape ]( & writer );
+  }
+
+  if( ( TEXTLEX_E_NOERR != err ) || ( TEXTLEX_E_NOERR != textenc_final( & writer ) ) ) {
+    fprintf( stderr, "%%TEXTCORPUS-F-WRITE; Error %d writing the corpus.\n", err );
+    return( 1 );
+  }
+
+  return( 0 );
+}
+
+static unsigned long long next( void ) {
+  state ^= state << 13;
+  state ^= state >> 7;
+  state ^= state << 17;
+
+  return( state );
+}
+
+/* word()
+**
+** Writes a string, comment or literal made of a few words.
+*/
+
+static tTextLexErr word( tTextEncContext * writer, unsigned int token, unsigned int count ) {
+  char text[ 256 ];
+  size_t length = 0;
+  unsigned int i;
+
+  for( i = 0; i < count; i++ ) {
+    length += sprintf( text + length, "%s%s", ( 0 == i ) ? "" : ( TEXTLEX_T_LITERAL == token ) ? "_" : " ",
+                       words[ next() % ( sizeof( words ) / sizeof( words[ 0 ] ) ) ] );
+  }
+
+  return( textenc_text( writer, token, (unsigned char *) text, length ) );
+}
+
+/* deep()
+**
+** One document: arrays and maps (each with one key) nested 32 to 256 deep
+** around an integer.
+*/
+
+static tTextLexErr deep( tTextEncContext * writer ) {
+  unsigned char stack[ CORPUS_MAX_DEPTH ];
+  unsigned int depth = 32 + (unsigned int) ( next() % ( CORPUS_MAX_DEPTH - 31 ) );
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  unsigned int i;
+
+  for( i = 0; i < depth; i++ ) {
+    if( next() & 1 ) {
+      stack[ i ] = TEXTLEX_T_MAP_CLOSE;
+      err |= textenc_token( writer, TEXTLEX_T_MAP_OPEN );
+      err |= word( writer, TEXTLEX_T_STRING, 1 );
+      err |= textenc_token( writer, TEXTLEX_T_EQUALS );
+    } else {
+      stack[ i ] = TEXTLEX_T_ARRAY_CLOSE;
+      err |= textenc_token( writer, TEXTLEX_T_ARRAY_OPEN );
+    }
+  }
+
+  err |= textenc_integer( writer, (long long) ( next() % 1000000 ) );
+
+  while( i > 0 ) {
+    err |= textenc_token( writer, stack[ --i ] );
+  }
+
+  return( err );
+}
+
+/* wide()
+**
+** One map with 256 to 1024 keys.
+*/
+
+static tTextLexErr wide( tTextEncContext * writer ) {
+  unsigned int keys = 256 + (unsigned int) ( next() % 769 );
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  unsigned long long random;
+  char key[ 32 ];
+  unsigned int i;
+
+  err |= textenc_token( writer, TEXTLEX_T_MAP_OPEN );
+
+  for( i = 0; i < keys; i++ ) {
+    err |= textenc_text( writer, TEXTLEX_T_STRING, (unsigned char *) key, sprintf( key, "field%05u", i ) );
+    err |= textenc_token( writer, TEXTLEX_T_EQUALS );
+
+    switch( ( random = next() ) % 4 ) {
+    case 0:
+      err |= word( writer, TEXTLEX_T_STRING, 1 + (unsigned int) ( ( random >> 8 ) % 3 ) );
+      break;
+
+    case 1:
+      err |= textenc_integer( writer, (long long) ( random >> 40 ) - ( 1LL << 23 ) );
+      break;
+
+    case 2:
+      err |= textenc_float( writer, (double) ( random >> 44 ) / 1024.0 );
+      break;
+
+    default:
+      err |= textenc_text( writer, TEXTLEX_T_LITERAL, (unsigned char *) ( ( random & 0x100 ) ? "true" : "false" ),
+                           ( random & 0x100 ) ? 4 : 5 );
+      break;
+    }
+  }
+
+  err |= textenc_token( writer, TEXTLEX_T_MAP_CLOSE );
+
+  return( err );
+}
+
+/* strings()
+**
+** One array of 16 strings between 1 and 64 kilobytes long: printable
+** characters with a space now and then and one in 256 of them a quote or a
+** backslash.
+*/
+
+static tTextLexErr strings( tTextEncContext * writer ) {
+  static unsigned char text[ CORPUS_STRING_SIZE ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  unsigned long long random;
+  size_t length, k;
+  unsigned int i;
+
+  err |= textenc_token( writer, TEXTLEX_T_ARRAY_OPEN );
+
+  for( i = 0; i < 16; i++ ) {
+    length = 1024 + (size_t) ( next() % ( CORPUS_STRING_SIZE - 1023 ) );
+
+    for( k = 0; k < length; k++ ) {
+      random = next();
+      if( 0 == ( random & 0xFF ) ) {
+        text[ k ] = ( random & 0x100 ) ? '"' : '\\';
+      } else if( 0 == ( random & 0x700 ) ) {
+        text[ k ] = ' ';
+      } else {
+        text[ k ] = (unsigned char) ( '0' + ( random >> 16 ) % 75 );
+        if( ( '"' == text[ k ] ) || ( '\\' == text[ k ] ) ) {
+          text[ k ] = 'x';
+        }
+      }
+    }
+
+    err |= textenc_text( writer, TEXTLEX_T_STRING, text, length );
+  }
+
+  err |= textenc_token( writer, TEXTLEX_T_ARRAY_CLOSE );
+
+  return( err );
+}
+
+/* numbers()
+**
+** One array of 4096 numbers: a mix of integers of every size, floats with
+** and without exponents and hex numbers.
+*/
+
+static tTextLexErr numbers( tTextEncContext * writer ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  unsigned long long random;
+  char hex[ 32 ];
+  unsigned int i;
+
+  err |= textenc_token( writer, TEXTLEX_T_ARRAY_OPEN );
+
+  for( i = 0; i < 4096; i++ ) {
+    random = next();
+
+    switch( random % 4 ) {
+    case 0:
+      err |= textenc_integer( writer, (long long) ( random >> ( 2 + ( random >> 58 ) % 62 ) ) * ( ( random & 4 ) ? -1 : 1 ) );
+      break;
+
+    case 1:
+      err |= textenc_float( writer, (double) ( random >> 20 ) / (double) ( 1ULL << ( ( random >> 8 ) % 48 ) ) );
+      break;
+
+    case 2:
+      err |= textenc_float( writer, (double) ( random >> 11 ) * 1e-300 * (double) ( 1ULL << ( ( random >> 4 ) % 60 ) ) );
+      break;
+
+    default:
+      err |= textenc_text( writer, TEXTLEX_T_HEX, (unsigned char *) hex, sprintf( hex, "%llX", random >> ( ( random >> 3 ) % 60 ) ) );
+      break;
+    }
+  }
+
+  err |= textenc_token( writer, TEXTLEX_T_ARRAY_CLOSE );
+
+  return( err );
+}
+
+/* config()
+**
+** One commented, annotated map of 8 to 40 entries, a few of them maps
+** themselves, with a paragraph of comment in front of most of them.
+*/
+
+static tTextLexErr config( tTextEncContext * writer ) {
+  unsigned int entries = 8 + (unsigned int) ( next() % 33 );
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  unsigned long long random;
+  unsigned int i, k, lines;
+
+  for( k = 0; k < 6; k++ ) {
+    err |= word( writer, TEXTLEX_T_COMMENT, 4 + (unsigned int) ( next() % 10 ) );
+  }
+
+  err |= textenc_text( writer, TEXTLEX_T_ANNOTATION, (unsigned char *) "t", 1 );
+  err |= textenc_token( writer, TEXTLEX_T_MAP_OPEN );
+
+  for( i = 0; i < entries; i++ ) {
+    for( k = 0, lines = (unsigned int) ( next() % 5 ); k < lines; k++ ) {
+      err |= word( writer, TEXTLEX_T_COMMENT, 4 + (unsigned int) ( next() % 10 ) );
+    }
+
+    err |= word( writer, TEXTLEX_T_STRING, 1 + (unsigned int) ( next() % 2 ) );
+    err |= textenc_token( writer, TEXTLEX_T_EQUALS );
+
+    switch( ( random = next() ) % 5 ) {
+    case 0:
+      err |= textenc_integer( writer, (long long) ( ( random >> 8 ) % 65536 ) );
+      break;
+
+    case 1:
+      err |= textenc_text( writer, TEXTLEX_T_LITERAL, (unsigned char *) ( ( random & 0x100 ) ? "true" : "false" ),
+                           ( random & 0x100 ) ? 4 : 5 );
+      break;
+
+    case 2:
+      err |= textenc_token( writer, TEXTLEX_T_MAP_OPEN );
+      for( k = 0; k < 3; k++ ) {
+        err |= word( writer, TEXTLEX_T_STRING, 1 );
+        err |= textenc_token( writer, TEXTLEX_T_EQUALS );
+        err |= textenc_integer( writer, (long long) ( next() % 100 ) );
+      }
+      err |= textenc_token( writer, TEXTLEX_T_MAP_CLOSE );
+      break;
+
+    default:
+      err |= word( writer, TEXTLEX_T_STRING, 1 + (unsigned int) ( ( random >> 8 ) % 6 ) );
+      break;
+    }
+  }
+
+  err |= textenc_token( writer, TEXTLEX_T_MAP_CLOSE );
+
+  return( err );
+}
+
+/* blobs()
+**
+** One array of 8 blobs of 256 octets to 16 kilobytes, base16 and base64
+** by turns.
+*/
+
+static tTextLexErr blobs( tTextEncContext * writer ) {
+  static unsigned char data[ CORPUS_BLOB_SIZE ];
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t length, k;
+  unsigned int i;
+
+  err |= textenc_token( writer, TEXTLEX_T_ARRAY_OPEN );
+
+  for( i = 0; i < 8; i++ ) {
+    length = 256 + (size_t) ( next() % ( CORPUS_BLOB_SIZE - 255 ) );
+
+    for( k = 0; k < length; k++ ) {
+      data[ k ] = (unsigned char) ( next() >> 32 );
+    }
+
+    if( i & 1 ) {
+      err |= textenc_base64( writer, data, length );
+    } else {
+      err |= textenc_octets( writer, data, length, 0 );
+    }
+  }
+
+  err |= textenc_token( writer, TEXTLEX_T_ARRAY_CLOSE );
+
+  return( err );
+}
+
+static tTextLexErr flush( tTextEncContext * context ) {
+  if( context->index != fwrite( context->buffer, 1, context->index, stdout ) ) {
+    return( TEXTLEX_E_ERROR );
+  }
+
+  context->index = 0;
+
+  return( TEXTLEX_E_NOERR );
+}
@@ -0,0 +1,656 @@
+/* textcur.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file implements the DSD Cursor. Please see textcur.h for more info.
+*/
+
+/* Macro Definitions */
+
+#define _FLOAT          64
+
+/* What an octet means to _container() when it's skipping over the inside
+** of an array or map. Everything that isn't in the table (white space,
+** numbers, literals, hex strings and so on) can't contain a bracket, so
+** it's just stepped over.
+*/
+
+#define _S_OTHER         0
+#define _S_OPEN          1
+#define _S_CLOSE         2
+#define _S_STRING        3
+#define _S_BASE64        4
+#define _S_BASE16        5
+#define _S_COMMENT       6
+
+/* File Includes */
+
+#include <stdlib.h>
+#include <string.h>
+#include "textcur.h"
+#include "textscan.h"
+
+/* Function Prototypes */
+
+static tTextLexErr _item( const tTextCurCursor * cursor, const unsigned char * p, tTextCurValue * value );
+static tTextLexErr _value( const unsigned char * p, const unsigned char * end, tTextCurValue * value );
+static const unsigned char * _space( const unsigned char * p, const unsigned char * end );
+static const unsigned char * _nondel( const unsigned char * p, const unsigned char * end );
+static const unsigned char * _string( const unsigned char * p, const unsigned char * end );
+static const unsigned char * _base16( const unsigned char * p, const unsigned char * end );
+static const unsigned char * _container( const unsigned char * p, const unsigned char * end );
+static int _match( const tTextCurValue * value, const char * key );
+static void _put( unsigned char * buffer, size_t size, size_t * length, unsigned long bits, unsigned int count );
+
+/* Global Variables */
+
+static const unsigned char _skip[ 256 ] = {
+  [ '[' ] = _S_OPEN, [ '{' ] = _S_OPEN, [ ']' ] = _S_CLOSE, [ '}' ] = _S_CLOSE,
+  [ '"' ] = _S_STRING, [ '\'' ] = _S_BASE64, [ '(' ] = _S_BASE16, [ '#' ] = _S_COMMENT
+};
+
+/* The octets that end an annotation, literal, number or hex string. */
+
+static const unsigned char _delimiter[ 256 ] = {
+  [ ' ' ] = 1, [ '\t' ] = 1, [ '\n' ] = 1, [ '\r' ] = 1, [ '#' ] = 1, [ '@' ] = 1,
+  [ '*' ] = 1, [ '$' ] = 1, [ '"' ] = 1, [ '\'' ] = 1, [ '(' ] = 1, [ '[' ] = 1,
+  [ ']' ] = 1, [ '{' ] = 1, [ '}' ] = 1, [ '=' ] = 1
+};
+
+/* The value of each hex and base64 digit, plus one, so that everything
+** that isn't a digit is zero.
+*/
+
+static const unsigned char _hex[ 256 ] = {
+  [ '0' ] = 1, [ '1' ] = 2, [ '2' ] = 3, [ '3' ] = 4, [ '4' ] = 5, [ '5' ] = 6, [ '6' ] = 7, [ '7' ] = 8,
+  [ '8' ] = 9, [ '9' ] = 10, [ 'a' ] = 11, [ 'b' ] = 12, [ 'c' ] = 13, [ 'd' ] = 14, [ 'e' ] = 15, [ 'f' ] = 16,
+  [ 'A' ] = 11, [ 'B' ] = 12, [ 'C' ] = 13, [ 'D' ] = 14, [ 'E' ] = 15, [ 'F' ] = 16
+};
+
+static const unsigned char _sextet[ 256 ] = {
+  [ 'A' ] = 1, [ 'B' ] = 2, [ 'C' ] = 3, [ 'D' ] = 4, [ 'E' ] = 5, [ 'F' ] = 6, [ 'G' ] = 7, [ 'H' ] = 8,
+  [ 'I' ] = 9, [ 'J' ] = 10, [ 'K' ] = 11, [ 'L' ] = 12, [ 'M' ] = 13, [ 'N' ] = 14, [ 'O' ] = 15, [ 'P' ] = 16,
+  [ 'Q' ] = 17, [ 'R' ] = 18, [ 'S' ] = 19, [ 'T' ] = 20, [ 'U' ] = 21, [ 'V' ] = 22, [ 'W' ] = 23, [ 'X' ] = 24,
+  [ 'Y' ] = 25, [ 'Z' ] = 26, [ 'a' ] = 27, [ 'b' ] = 28, [ 'c' ] = 29, [ 'd' ] = 30, [ 'e' ] = 31, [ 'f' ] = 32,
+  [ 'g' ] = 33, [ 'h' ] = 34, [ 'i' ] = 35, [ 'j' ] = 36, [ 'k' ] = 37, [ 'l' ] = 38, [ 'm' ] = 39, [ 'n' ] = 40,
+  [ 'o' ] = 41, [ 'p' ] = 42, [ 'q' ] = 43, [ 'r' ] = 44, [ 's' ] = 45, [ 't' ] = 46, [ 'u' ] = 47, [ 'v' ] = 48,
+  [ 'w' ] = 49, [ 'x' ] = 50, [ 'y' ] = 51, [ 'z' ] = 52, [ '0' ] = 53, [ '1' ] = 54, [ '2' ] = 55, [ '3' ] = 56,
+  [ '4' ] = 57, [ '5' ] = 58, [ '6' ] = 59, [ '7' ] = 60, [ '8' ] = 61, [ '9' ] = 62, [ '+' ] = 63, [ '/' ] = 64
+};
+
+/* Function Definitions */
+
+void textcur_init( tTextCurCursor * cursor, const unsigned char * data, size_t length ) {
+  cursor->type = TEXTLEX_T_ARRAY_OPEN;
+  cursor->begin = data;
+  cursor->next = data;
+  cursor->end = data + length;
+}
+
+tTextLexErr textcur_next( tTextCurCursor * cursor, tTextCurValue * key, tTextCurValue * value ) {
+  tTextCurValue ignored;
+  const unsigned char * p;
+  tTextLexErr err;
+
+  if( NULL == key ) {
+    key = & ignored;
+  }
+  key->type = TEXTLEX_T_END;
+
+  if( TEXTLEX_T_MAP_OPEN == cursor->type ) {
+    if( TEXTLEX_E_NOERR != ( err = _item( cursor, cursor->next, key ) ) ) {
+      return( err );
+    }
+
+    if( TEXTLEX_T_END == key->type ) {
+      value->type = TEXTLEX_T_END;
+      return( TEXTLEX_E_NOERR );
+    }
+
+    p = _space( key->end, cursor->end );
+    if( ( p == cursor->end ) || ( '=' != * p ) ) {
+      return( TEXTCUR_E_STRUCTURE );
+    }
+
+    if( TEXTLEX_E_NOERR != ( err = _item( cursor, p + 1, value ) ) ) {
+      return( err );
+    }
+
+    if( TEXTLEX_T_END == value->type ) {
+      return( TEXTCUR_E_STRUCTURE );
+    }
+  } else if( TEXTLEX_E_NOERR != ( err = _item( cursor, cursor->next, value ) ) ) {
+    return( err );
+  }
+
+  if( TEXTLEX_T_END != value->type ) {
+    cursor->next = value->end;
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
+
+tTextLexErr textcur_find( tTextCurCursor * cursor, const char * key, tTextCurValue * value ) {
+  const unsigned char * stop = cursor->next;
+  tTextCurValue found;
+  tTextLexErr err;
+  int wrapped = 0;
+
+  if( TEXTLEX_T_MAP_OPEN != cursor->type ) {
+    return( TEXTCUR_E_STRUCTURE );
+  }
+
+  while( ! wrapped || ( cursor->next < stop ) ) {
+    if( TEXTLEX_E_NOERR != ( err = textcur_next( cursor, & found, value ) ) ) {
+      return( err );
+    }
+
+    if( TEXTLEX_T_END == value->type ) {
+      if( wrapped || ( stop == cursor->begin ) ) {
+        break;
+      }
+      cursor->next = cursor->begin;
+      wrapped = 1;
+      continue;
+    }
+
+    if( ( TEXTLEX_T_STRING == found.type ) && _match( & found, key ) ) {
+      return( TEXTLEX_E_NOERR );
+    }
+  }
+
+  cursor->next = stop;
+  value->type = TEXTLEX_T_END;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+tTextLexErr textcur_enter( tTextCurCursor * cursor, const tTextCurValue * value ) {
+  if( ( TEXTLEX_T_ARRAY_OPEN != value->type ) && ( TEXTLEX_T_MAP_OPEN != value->type ) ) {
+    return( TEXTCUR_E_STRUCTURE );
+  }
+
+  cursor->type = value->type;
+  cursor->begin = value->start + 1;
+  cursor->next = value->start + 1;
+  cursor->end = value->end - 1;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+void textcur_rewind( tTextCurCursor * cursor ) {
+  cursor->next = cursor->begin;
+}
+
+size_t textcur_text( const tTextCurValue * value, unsigned char * buffer, size_t size ) {
+  const unsigned char * p = value->start;
+  const unsigned char * end = value->end;
+  size_t length = 0;
+
+  switch( value->type ) {
+  case TEXTLEX_T_STRING:
+    for( p++, end--; p < end; p++ ) {
+      if( '\\' == * p ) {
+        p++;
+      }
+      if( length < size ) {
+        buffer[ length ] = * p;
+      }
+      length++;
+    }
+    return( length );
+
+  case TEXTLEX_T_BASE64:
+    for( p++, end--; p < end; p++ ) {
+      if( ( '=' == * p ) || _sextet[ * p ] ) {
+        if( length < size ) {
+          buffer[ length ] = * p;
+        }
+        length++;
+      }
+    }
+    return( length );
+
+  case TEXTLEX_T_HEX:
+    if( '$' == * p ) {
+      p++;
+      break;
+    }
+    for( p++, end--; p < end; p++ ) {
+      if( '#' == * p ) {
+        p += textscan_find2( p, end - p, '\n', '\r' );
+      } else if( _hex[ * p ] ) {
+        if( length < size ) {
+          buffer[ length ] = * p;
+        }
+        length++;
+      }
+    }
+    return( length );
+
+  case TEXTLEX_T_LITERAL:
+    p++;
+    break;
+
+  case TEXTLEX_T_INTEGER:
+  case TEXTLEX_T_FLOAT:
+    break;
+
+  default:
+    return( 0 );
+  }
+
+  /* What's left is copied as it is. */
+
+  length = end - p;
+  if( size > 0 ) {
+    memcpy( buffer, p, ( length < size ) ? length : size );
+  }
+
+  return( length );
+}
+
+size_t textcur_octets( const tTextCurValue * value, unsigned char * buffer, size_t size ) {
+  const unsigned char * p = value->start + 1;
+  const unsigned char * end = value->end;
+  unsigned long bits = 0;
+  unsigned int count = 0;
+  size_t length = 0;
+  unsigned int digit;
+
+  if( TEXTLEX_T_HEX == value->type ) {
+    if( '(' == value->start[ 0 ] ) {
+      end--;
+    }
+    for( ; p < end; p++ ) {
+      if( '#' == * p ) {
+        p += textscan_find2( p, end - p, '\n', '\r' );
+      } else if( 0 != ( digit = _hex[ * p ] ) ) {
+        bits = ( bits << 4 ) | ( digit - 1 );
+        if( 0 == ( ++count & 1 ) ) {
+          if( length < size ) {
+            buffer[ length ] = (unsigned char) bits;
+          }
+          length++;
+        }
+      }
+    }
+    return( length );
+  }
+
+  if( TEXTLEX_T_BASE64 != value->type ) {
+    return( 0 );
+  }
+
+  /* Every four base64 digits make three octets; two or three left over at
+  ** the end make one or two more.
+  */
+
+  for( end--; p < end; p++ ) {
+    if( 0 == ( digit = _sextet[ * p ] ) ) {
+      continue;
+    }
+    bits = ( bits << 6 ) | ( digit - 1 );
+    if( 0 == ( ++count & 3 ) ) {
+      _put( buffer, size, & length, bits, 3 );
+      bits = 0;
+    }
+  }
+
+  count &= 3;
+  if( count > 1 ) {
+    _put( buffer, size, & length, bits << ( 6 * ( 4 - count ) ), count - 1 );
+  }
+
+  return( length );
+}
+
+int textcur_integer( const tTextCurValue * value, long long * result ) {
+  const unsigned char * p = value->start;
+  unsigned long long magnitude = 0;
+  unsigned long long limit = 9223372036854775807ULL;
+  unsigned char digits[ 17 ];
+  unsigned int digit;
+  size_t length, i;
+  int negative = 0;
+
+  if( TEXTLEX_T_HEX == value->type ) {
+    if( ( 0 == ( length = textcur_text( value, digits, sizeof( digits ) ) ) ) || ( length > 16 ) ) {
+      return( 0 );
+    }
+    for( i = 0; i < length; i++ ) {
+      magnitude = ( magnitude << 4 ) | ( _hex[ digits[ i ] ] - 1 );
+    }
+    if( magnitude > limit ) {
+      return( 0 );
+    }
+    * result = (long long) magnitude;
+    return( 1 );
+  }
+
+  if( TEXTLEX_T_INTEGER != value->type ) {
+    return( 0 );
+  }
+
+  if( '-' == * p ) {
+    negative = 1;
+    limit++;
+    p++;
+  }
+
+  if( p == value->end ) {
+    return( 0 );
+  }
+
+  for( ; p < value->end; p++ ) {
+    digit = * p - '0';
+    if( ( digit > 9 ) || ( magnitude > ( limit - digit ) / 10 ) ) {
+      return( 0 );
+    }
+    magnitude = magnitude * 10 + digit;
+  }
+
+  * result = negative ? (long long) ( 0ULL - magnitude ) : (long long) magnitude;
+
+  return( 1 );
+}
+
+int textcur_float( const tTextCurValue * value, double * result ) {
+  char number[ _FLOAT ];
+  size_t length = value->end - value->start;
+
+  if( ( ( TEXTLEX_T_FLOAT != value->type ) && ( TEXTLEX_T_INTEGER != value->type ) ) || ( length >= _FLOAT ) ) {
+    return( 0 );
+  }
+
+  memcpy( number, value->start, length );
+  number[ length ] = '\0';
+  * result = strtod( number, NULL );
+
+  return( 1 );
+}
+
+int textcur_boolean( const tTextCurValue * value, int * result ) {
+  static const char * names[ 2 ] = { "false", "true" };
+  const unsigned char * text = value->start + 1;
+  size_t length = value->end - text;
+  unsigned int i, j;
+
+  if( TEXTLEX_T_LITERAL != value->type ) {
+    return( 0 );
+  }
+
+  for( i = 0; i < 2; i++ ) {
+    if( strlen( names[ i ] ) != length ) {
+      continue;
+    }
+    for( j = 0; ( j < length ) && ( ( text[ j ] | 0x20 ) == names[ i ][ j ] ); j++ );
+    if( j == length ) {
+      * result = (int) i;
+      return( 1 );
+    }
+  }
+
+  return( 0 );
+}
+
+/* Function Definitions : Static Functions */
+
+/* _item()
+**
+** Reads the annotation (if there is one) and the value starting at p. If
+** there's another annotation first, that one wins. If the container ends
+** instead, value's type is TEXTLEX_T_END.
+*/
+
+static tTextLexErr _item( const tTextCurCursor * cursor, const unsigned char * p, tTextCurValue * value ) {
+  const unsigned char * end = cursor->end;
+
+  value->annotation = NULL;
+  value->annotation_length = 0;
+
+  while( ( ( p = _space( p, end ) ) < end ) && ( '@' == * p ) ) {
+    value->annotation = p + 1;
+    p = _nondel( p + 1, end );
+    value->annotation_length = p - value->annotation;
+  }
+
+  if( p == end ) {
+    value->type = TEXTLEX_T_END;
+    value->start = p;
+    value->end = p;
+    return( TEXTLEX_E_NOERR );
+  }
+
+  return( _value( p, end, value ) );
+}
+
+/* _value()
+**
+** Works out what kind of value starts at p and finds where it ends, without
+** looking any closer at it than that.
+*/
+
+static tTextLexErr _value( const unsigned char * p, const unsigned char * end, tTextCurValue * value ) {
+  const unsigned char * q;
+
+  value->start = p;
+
+  switch( * p ) {
+  case '[':
+    value->type = TEXTLEX_T_ARRAY_OPEN;
+    q = _container( p + 1, end );
+    break;
+
+  case '{':
+    value->type = TEXTLEX_T_MAP_OPEN;
+    q = _container( p + 1, end );
+    break;
+
+  case '"':
+    value->type = TEXTLEX_T_STRING;
+    q = _string( p + 1, end );
+    break;
+
+  case '\'':
+    value->type = TEXTLEX_T_BASE64;
+    q = memchr( p + 1, '\'', end - p - 1 );
+    q = ( NULL == q ) ? NULL : q + 1;
+    break;
+
+  case '(':
+    value->type = TEXTLEX_T_HEX;
+    q = _base16( p + 1, end );
+    break;
+
+  case '$':
+    value->type = TEXTLEX_T_HEX;
+    q = _nondel( p + 1, end );
+    break;
+
+  case '*':
+    value->type = TEXTLEX_T_LITERAL;
+    q = _nondel( p + 1, end );
+    break;
+
+  case ']':
+  case '}':
+  case '=':
+    return( TEXTCUR_E_STRUCTURE );
+
+  default:
+    if( ( '-' != * p ) && ( ( * p < '0' ) || ( * p > '9' ) ) ) {
+      return( TEXTLEX_E_START );
+    }
+    value->type = TEXTLEX_T_INTEGER;
+    for( q = p + 1; ( q < end ) && ! _delimiter[ * q ]; q++ ) {
+      if( ( '.' == * q ) || ( 'e' == * q ) || ( 'E' == * q ) ) {
+        value->type = TEXTLEX_T_FLOAT;
+      }
+    }
+    break;
+  }
+
+  if( NULL == q ) {
+    return( TEXTCUR_E_UNCLOSED );
+  }
+
+  value->end = q;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* _space()
+**
+** Skips white space and comments.
+*/
+
+static const unsigned char * _space( const unsigned char * p, const unsigned char * end ) {
+  while( p < end ) {
+    switch( * p ) {
+    case ' ':
+    case '\t':
+    case '\n':
+    case '\r':
+      p++;
+      break;
+
+    case '#':
+      p++;
+      p += textscan_find2( p, end - p, '\n', '\r' );
+      break;
+
+    default:
+      return( p );
+    }
+  }
+
+  return( p );
+}
+
+static const unsigned char * _nondel( const unsigned char * p, const unsigned char * end ) {
+  while( ( p < end ) && ! _delimiter[ * p ] ) {
+    p++;
+  }
+
+  return( p );
+}
+
+/* _string(), _base16() and _container()
+**
+** Take a pointer just past the opening quote or bracket and return one
+** just past the closing one, or NULL if the document ends first.
+*/
+
+static const unsigned char * _string( const unsigned char * p, const unsigned char * end ) {
+  while( ( p += textscan_find2( p, end - p, '"', '\\' ) ) < end ) {
+    if( '"' == * p ) {
+      return( p + 1 );
+    }
+    if( ++p == end ) {
+      break;
+    }
+    p++;
+  }
+
+  return( NULL );
+}
+
+static const unsigned char * _base16( const unsigned char * p, const unsigned char * end ) {
+  while( ( p += textscan_find2( p, end - p, ')', '#' ) ) < end ) {
+    if( ')' == * p ) {
+      return( p + 1 );
+    }
+    p++;
+    p += textscan_find2( p, end - p, '\n', '\r' );
+  }
+
+  return( NULL );
+}
+
+static const unsigned char * _container( const unsigned char * p, const unsigned char * end ) {
+  unsigned int depth = 1;
+
+  while( p < end ) {
+    switch( _skip[ * p ] ) {
+    case _S_OTHER:
+      for( p++; ( p < end ) && ( _S_OTHER == _skip[ * p ] ); p++ );
+      break;
+
+    case _S_OPEN:
+      depth++;
+      p++;
+      break;
+
+    case _S_CLOSE:
+      p++;
+      if( 0 == --depth ) {
+        return( p );
+      }
+      break;
+
+    case _S_STRING:
+      if( NULL == ( p = _string( p + 1, end ) ) ) {
+        return( NULL );
+      }
+      break;
+
+    case _S_BASE64:
+      if( NULL == ( p = memchr( p + 1, '\'', end - p - 1 ) ) ) {
+        return( NULL );
+      }
+      p++;
+      break;
+
+    case _S_BASE16:
+      if( NULL == ( p = _base16( p + 1, end ) ) ) {
+        return( NULL );
+      }
+      break;
+
+    case _S_COMMENT:
+      p++;
+      p += textscan_find2( p, end - p, '\n', '\r' );
+      break;
+    }
+  }
+
+  return( NULL );
+}
+
+/* _match()
+**
+** Compares a string value with key without unescaping it first.
+*/
+
+static int _match( const tTextCurValue * value, const char * key ) {
+  const unsigned char * p = value->start + 1;
+  const unsigned char * end = value->end - 1;
+
+  for( ; p < end; p++, key++ ) {
+    if( '\\' == * p ) {
+      p++;
+    }
+    if( * p != (unsigned char) * key ) {
+      return( 0 );
+    }
+  }
+
+  return( '\0' == * key );
+}
+
+/* _put()
+**
+** Stores the top count octets of a 24-bit group, as far as they fit.
+*/
+
+static void _put( unsigned char * buffer, size_t size, size_t * length, unsigned long bits, unsigned int count ) {
+  unsigned int i;
+
+  for( i = 0; i < count; i++, ( * length )++ ) {
+    if( * length < size ) {
+      buffer[ * length ] = (unsigned char) ( bits >> ( 16 - 8 * i ) );
+    }
+  }
+}
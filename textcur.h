@@ -0,0 +1,148 @@
+/* textcur.h
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file provides the interface to the DSD Cursor implemented in
+** textcur.c. The cursor reads values straight out of a document that's
+** already in memory, and only the ones you ask for. Where the lexxer and
+** the builders on top of it look at (and copy) every octet of every token,
+** the cursor hops over the values you don't ask about: it finds the end of
+** a string, a base64 or base16 string (comments and all) or a whole array
+** or map without unescaping, decoding or copying anything. Values you do
+** ask about aren't decoded until you call one of the conversion functions.
+**
+** The price of being lazy is that the cursor only checks the parts of the
+** document it reads. Values it skips over are only checked for matching
+** brackets and closing quotes, so a document with an error in a value you
+** never look at may not return an error at all. Use the lexxer if you need
+** the whole document checked.
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_TEXTCUR
+#define _H_TEXTCUR
+
+/* Macro Definitions : Error Codes
+**
+** These have the same values and meanings as TEXTDOM_E_STRUCTURE and
+** TEXTDOM_E_UNCLOSED. Octets that can't start a token return
+** TEXTLEX_E_START, as they do from the lexxer.
+*/
+
+#define TEXTCUR_E_STRUCTURE     100 /* A token where it doesn't belong */
+#define TEXTCUR_E_UNCLOSED      101 /* Document ended inside a value */
+
+/* File Includes */
+
+#include <stddef.h>
+#include "textlex.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+/* A value the cursor has found. type is the token type it would have lexed
+** as (TEXTLEX_T_ARRAY_OPEN and TEXTLEX_T_MAP_OPEN for arrays and maps, and
+** TEXTLEX_T_END when there are no more values.) start and end bound the
+** whole value in the document, sigils, quotes and brackets included. If
+** there's an annotation in front of the value, annotation points at its
+** name (without the '@') and annotation_length is its length; otherwise
+** annotation is NULL.
+*/
+
+typedef struct {
+  unsigned int            type;
+  const unsigned char   * start;
+  const unsigned char   * end;
+  const unsigned char   * annotation;
+  size_t                  annotation_length;
+} tTextCurValue;
+
+/* A cursor over the items in an array or the entries in a map. begin and
+** end bound the inside of the container (end is the closing bracket, or
+** the end of the document for the top level) and next is where the next
+** item starts.
+*/
+
+typedef struct {
+  unsigned int            type;
+  const unsigned char   * begin;
+  const unsigned char   * next;
+  const unsigned char   * end;
+} tTextCurCursor;
+
+/* Function Prototypes */
+
+/* textcur_init()
+**
+** Points a cursor at the top level of a document. Like the document
+** builder, the cursor treats the top level as an array.
+*/
+
+void textcur_init( tTextCurCursor * cursor, const unsigned char * data, size_t length );
+
+/* textcur_next()
+**
+** Moves the cursor past the next item in an array or entry in a map. For
+** maps, key gets the key and value gets its value; for arrays, value gets
+** the item (key can be NULL if you don't care.) Skipped values aren't
+** decoded. At the end of the container, value->type is TEXTLEX_T_END.
+*/
+
+tTextLexErr textcur_next( tTextCurCursor * cursor, tTextCurValue * key, tTextCurValue * value );
+
+/* textcur_find()
+**
+** Finds the value for the first string key in a map that matches key. It
+** searches from the cursor to the end of the map and then from the start
+** of the map back to the cursor, so looking keys up in the order they're
+** in the document takes one trip through the map. The cursor is left just
+** past the entry it found. If the key isn't there, value->type is
+** TEXTLEX_T_END.
+*/
+
+tTextLexErr textcur_find( tTextCurCursor * cursor, const char * key, tTextCurValue * value );
+
+/* textcur_enter() and textcur_rewind()
+**
+** Point a cursor at the inside of an array or map value (returning
+** TEXTCUR_E_STRUCTURE for anything else) or back at the start of the
+** container it's already in.
+*/
+
+tTextLexErr textcur_enter( tTextCurCursor * cursor, const tTextCurValue * value );
+void textcur_rewind( tTextCurCursor * cursor );
+
+/* textcur_text()
+**
+** Copies an atom into buffer just the way the lexxer would have delivered
+** it: without its sigil or quotes, with string escapes undone and with
+** anything that isn't a digit left out of base16 and base64 strings. It
+** returns the length of the whole atom, even if that's more than size (in
+** which case only size octets are copied.) It returns zero for arrays and
+** maps.
+*/
+
+size_t textcur_text( const tTextCurValue * value, unsigned char * buffer, size_t size );
+
+/* textcur_octets()
+**
+** Decodes a hex, base16 or base64 string into buffer and returns how many
+** octets it holds (copying at most size of them.) It returns zero for
+** anything else.
+*/
+
+size_t textcur_octets( const tTextCurValue * value, unsigned char * buffer, size_t size );
+
+/* textcur_integer(), textcur_float() and textcur_boolean()
+**
+** Convert an atom. They accept the same types textdom_integer(),
+** textdom_float() and textdom_boolean() do and return zero if value is the
+** wrong type or out of range.
+*/
+
+int textcur_integer( const tTextCurValue * value, long long * result );
+int textcur_float( const tTextCurValue * value, double * result );
+int textcur_boolean( const tTextCurValue * value, int * result );
+
+#endif /* _H_TEXTCUR */
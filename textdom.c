@@ -0,0 +1,544 @@
+/* textdom.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file implements the DSD Document Builder. Please see textdom.h for
+** more info.
+*/
+
+/* Macro Definitions */
+
+#define _ALIGN           8
+#define _BUFFER_SIZE  4096
+#define _NODES          64
+#define _FRAMES         16
+
+/* What an open container expects next. Arrays always expect an item; maps
+** go round from a key to '=' to a value.
+*/
+
+#define _EXPECT_ITEM     0
+#define _EXPECT_EQUALS   1
+#define _EXPECT_VALUE    2
+
+/* File Includes */
+
+#include <stdlib.h>
+#include <string.h>
+#include "textdom.h"
+
+/* Function Prototypes */
+
+static tTextLexErr _push( tTextDomContext * context, tTextDomNode * node );
+static tTextLexErr _open( tTextDomContext * context, unsigned int type );
+static tTextLexErr _close( tTextDomContext * context, unsigned int type );
+static tTextLexErr _items( tTextDomContext * context, tTextDomFrame * frame, tTextDomNode * node );
+static const unsigned char * _copy( tTextDomArena * arena, const unsigned char * data, size_t length );
+static tTextLexErr _base16( tTextDomContext * context, const unsigned char * data, size_t length );
+static tTextLexErr _span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr _grow( tTextLexContext * context );
+
+/* Function Definitions : Arena */
+
+void textdom_arena_init( tTextDomArena * arena ) {
+  memset( arena, 0, sizeof( tTextDomArena ) );
+}
+
+void * textdom_arena_alloc( tTextDomArena * arena, size_t size ) {
+  tTextDomBlock * next;
+  size_t bytes;
+  void * result;
+
+  /* Even an empty array gets a pointer of its own. */
+
+  size = ( 0 == size ) ? _ALIGN : ( size + _ALIGN - 1 ) & ~( (size_t) _ALIGN - 1 );
+
+  if( size > (size_t) ( arena->limit - arena->cursor ) ) {
+    /* Move on to the next block, slipping a new one in if it's missing or
+    ** too small.
+    */
+
+    next = ( NULL == arena->current ) ? arena->first : arena->current->next;
+
+    if( ( NULL == next ) || ( next->size < size ) ) {
+      bytes = ( size > TEXTDOM_BLOCK_SIZE ) ? size : TEXTDOM_BLOCK_SIZE;
+      if( NULL == ( next = malloc( sizeof( tTextDomBlock ) + bytes ) ) ) {
+        return( NULL );
+      }
+      next->size = bytes;
+      if( NULL == arena->current ) {
+        next->next = arena->first;
+        arena->first = next;
+      } else {
+        next->next = arena->current->next;
+        arena->current->next = next;
+      }
+    }
+
+    arena->current = next;
+    arena->cursor = (unsigned char *) ( next + 1 );
+    arena->limit = arena->cursor + next->size;
+  }
+
+  result = arena->cursor;
+  arena->cursor += size;
+
+  return( result );
+}
+
+void textdom_arena_reset( tTextDomArena * arena ) {
+  arena->current = NULL;
+  arena->cursor = NULL;
+  arena->limit = NULL;
+}
+
+void textdom_arena_free( tTextDomArena * arena ) {
+  tTextDomBlock * block;
+
+  while( NULL != ( block = arena->first ) ) {
+    arena->first = block->next;
+    free( block );
+  }
+
+  textdom_arena_init( arena );
+}
+
+/* Function Definitions : Builder */
+
+tTextLexErr textdom_init( tTextDomContext * context, tTextDomArena * arena ) {
+  memset( context, 0, sizeof( tTextDomContext ) );
+  context->arena = arena;
+
+  do {
+    if( NULL == ( context->text.buffer = malloc( _BUFFER_SIZE ) ) ) {
+      break;
+    }
+
+    if( NULL == ( context->nodes = malloc( _NODES * sizeof( tTextDomNode ) ) ) ) {
+      break;
+    }
+
+    if( NULL == ( context->frames = malloc( _FRAMES * sizeof( tTextDomFrame ) ) ) ) {
+      break;
+    }
+
+    context->text.size = _BUFFER_SIZE;
+    context->node_size = _NODES;
+    context->frame_size = _FRAMES;
+
+    textdom_reset( context );
+
+    return( TEXTLEX_E_NOERR );
+  } while( 0 );
+
+  textdom_free( context );
+
+  return( TEXTLEX_E_MEMORY );
+}
+
+tTextLexErr textdom_update( tTextDomContext * context, tTextLexBuffer * data, tTextLexCount length ) {
+  return( textlex_update( & context->text, data, length ) );
+}
+
+tTextLexErr textdom_final( tTextDomContext * context, const tTextDomNode ** root ) {
+  tTextDomNode * node;
+  tTextLexErr err;
+
+  if( TEXTLEX_E_NOERR != ( err = textlex_final( & context->text ) ) ) {
+    return( err );
+  }
+
+  if( 1 != context->frame_count ) {
+    return( TEXTDOM_E_UNCLOSED );
+  }
+
+  if( NULL == ( node = textdom_arena_alloc( context->arena, sizeof( tTextDomNode ) ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  if( TEXTLEX_E_NOERR != ( err = _items( context, & context->frames[ 0 ], node ) ) ) {
+    return( err );
+  }
+
+  * root = node;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+tTextLexErr textdom_token( tTextDomContext * context, unsigned int token, const unsigned char * data, size_t length ) {
+  tTextDomFrame * frame = & context->frames[ context->frame_count - 1 ];
+  tTextDomNode node;
+
+  switch( token ) {
+  case TEXTLEX_T_END:
+    return( TEXTLEX_E_NOERR );
+
+  case TEXTLEX_T_COMMENT:
+    /* A comment inside a base16 string splits it into two HEX tokens. */
+    context->base16 = ( TEXTLEX_S_BASE16_COMMENT == context->text.state );
+    return( TEXTLEX_E_NOERR );
+
+  case TEXTLEX_T_HEX:
+    if( context->base16 ) {
+      context->base16 = 0;
+      return( _base16( context, data, length ) );
+    }
+    break;
+
+  case TEXTLEX_T_ANNOTATION:
+    /* It belongs to the next node. If there's another annotation first,
+    ** that one wins.
+    */
+    if( NULL == ( context->annotation = (const char *) _copy( context->arena, data, length ) ) ) {
+      return( TEXTLEX_E_MEMORY );
+    }
+    return( TEXTLEX_E_NOERR );
+
+  case TEXTLEX_T_ARRAY_OPEN:
+  case TEXTLEX_T_MAP_OPEN:
+    return( _open( context, token ) );
+
+  case TEXTLEX_T_ARRAY_CLOSE:
+    return( _close( context, TEXTDOM_T_ARRAY ) );
+
+  case TEXTLEX_T_MAP_CLOSE:
+    return( _close( context, TEXTDOM_T_MAP ) );
+
+  case TEXTLEX_T_EQUALS:
+    if( ( TEXTDOM_T_MAP != frame->type ) || ( _EXPECT_EQUALS != frame->expect ) ) {
+      return( TEXTDOM_E_STRUCTURE );
+    }
+    frame->expect = _EXPECT_VALUE;
+    return( TEXTLEX_E_NOERR );
+
+  case TEXTLEX_T_LITERAL:
+  case TEXTLEX_T_INTEGER:
+  case TEXTLEX_T_FLOAT:
+  case TEXTLEX_T_STRING:
+  case TEXTLEX_T_BASE64:
+    break;
+
+  default:
+    return( TEXTLEX_E_ERROR );
+  }
+
+  node.type = token;
+  node.count = length;
+  node.annotation = context->annotation;
+  if( NULL == ( node.value.text = _copy( context->arena, data, length ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  return( _push( context, & node ) );
+}
+
+void textdom_reset( tTextDomContext * context ) {
+  textlex_init( & context->text, context->text.buffer, context->text.size );
+  textlex_extend( & context->text, & context->extension );
+  context->extension.span = _span;
+  context->text.overflow = _grow;
+
+  /* The document itself is an array. */
+
+  context->node_count = 0;
+  context->frame_count = 1;
+  context->frames[ 0 ].type = TEXTDOM_T_ARRAY;
+  context->frames[ 0 ].expect = _EXPECT_ITEM;
+  context->frames[ 0 ].start = 0;
+  context->frames[ 0 ].annotation = NULL;
+  context->annotation = NULL;
+  context->base16 = 0;
+}
+
+void textdom_free( tTextDomContext * context ) {
+  free( context->text.buffer );
+  free( context->nodes );
+  free( context->frames );
+  context->text.buffer = NULL;
+  context->nodes = NULL;
+  context->frames = NULL;
+}
+
+/* Function Definitions : Lookups */
+
+const tTextDomNode * textdom_find( const tTextDomNode * node, const char * key ) {
+  const tTextDomNode * items;
+  size_t length, i;
+
+  if( ( NULL == node ) || ( TEXTDOM_T_MAP != node->type ) ) {
+    return( NULL );
+  }
+
+  length = strlen( key );
+  items = node->value.items;
+
+  for( i = 0; i < node->count; i++, items += 2 ) {
+    if( ( TEXTDOM_T_STRING == items->type ) && ( length == items->count ) && ( 0 == memcmp( key, items->value.text, length ) ) ) {
+      return( items + 1 );
+    }
+  }
+
+  return( NULL );
+}
+
+const tTextDomNode * textdom_index( const tTextDomNode * node, size_t index ) {
+  if( ( NULL == node ) || ( TEXTDOM_T_ARRAY != node->type ) || ( index >= node->count ) ) {
+    return( NULL );
+  }
+
+  return( & node->value.items[ index ] );
+}
+
+int textdom_integer( const tTextDomNode * node, long long * value ) {
+  const unsigned char * text;
+  unsigned long long magnitude = 0;
+  unsigned long long limit = 9223372036854775807ULL;
+  unsigned int digit;
+  size_t i = 0;
+  int negative = 0;
+
+  if( NULL == node ) {
+    return( 0 );
+  }
+
+  text = node->value.text;
+
+  if( TEXTDOM_T_HEX == node->type ) {
+    if( ( 0 == node->count ) || ( node->count > 16 ) ) {
+      return( 0 );
+    }
+    for( ; i < node->count; i++ ) {
+      digit = text[ i ];
+      digit = ( digit <= '9' ) ? digit - '0' : ( digit | 0x20 ) - 'a' + 10;
+      magnitude = ( magnitude << 4 ) | digit;
+    }
+    if( magnitude > limit ) {
+      return( 0 );
+    }
+    * value = (long long) magnitude;
+    return( 1 );
+  }
+
+  if( ( TEXTDOM_T_INTEGER != node->type ) || ( 0 == node->count ) ) {
+    return( 0 );
+  }
+
+  if( '-' == text[ 0 ] ) {
+    negative = 1;
+    limit++;
+    i++;
+  }
+
+  if( i == node->count ) {
+    return( 0 );
+  }
+
+  for( ; i < node->count; i++ ) {
+    digit = text[ i ] - '0';
+    if( magnitude > ( limit - digit ) / 10 ) {
+      return( 0 );
+    }
+    magnitude = magnitude * 10 + digit;
+  }
+
+  * value = negative ? (long long) ( 0ULL - magnitude ) : (long long) magnitude;
+
+  return( 1 );
+}
+
+int textdom_float( const tTextDomNode * node, double * value ) {
+  if( ( NULL == node ) || ( ( TEXTDOM_T_FLOAT != node->type ) && ( TEXTDOM_T_INTEGER != node->type ) ) ) {
+    return( 0 );
+  }
+
+  * value = strtod( (const char *) node->value.text, NULL );
+
+  return( 1 );
+}
+
+int textdom_boolean( const tTextDomNode * node, int * value ) {
+  static const char * names[ 2 ] = { "false", "true" };
+  unsigned int i, j;
+
+  if( ( NULL == node ) || ( TEXTDOM_T_LITERAL != node->type ) ) {
+    return( 0 );
+  }
+
+  for( i = 0; i < 2; i++ ) {
+    if( strlen( names[ i ] ) != node->count ) {
+      continue;
+    }
+    for( j = 0; ( j < node->count ) && ( ( node->value.text[ j ] | 0x20 ) == names[ i ][ j ] ); j++ );
+    if( j == node->count ) {
+      * value = (int) i;
+      return( 1 );
+    }
+  }
+
+  return( 0 );
+}
+
+/* Function Definitions : Static Functions */
+
+/* _push()
+**
+** Adds a finished node to the container that's open, after checking that
+** the container was expecting one.
+*/
+
+static tTextLexErr _push( tTextDomContext * context, tTextDomNode * node ) {
+  tTextDomFrame * frame = & context->frames[ context->frame_count - 1 ];
+  tTextDomNode * nodes;
+
+  if( TEXTDOM_T_MAP == frame->type ) {
+    if( _EXPECT_EQUALS == frame->expect ) {
+      return( TEXTDOM_E_STRUCTURE );
+    }
+    frame->expect = ( _EXPECT_ITEM == frame->expect ) ? _EXPECT_EQUALS : _EXPECT_ITEM;
+  }
+
+  if( context->node_count == context->node_size ) {
+    if( NULL == ( nodes = realloc( context->nodes, context->node_size * 2 * sizeof( tTextDomNode ) ) ) ) {
+      return( TEXTLEX_E_MEMORY );
+    }
+    context->nodes = nodes;
+    context->node_size *= 2;
+  }
+
+  context->nodes[ context->node_count++ ] = * node;
+  context->annotation = NULL;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr _open( tTextDomContext * context, unsigned int type ) {
+  tTextDomFrame * frame = & context->frames[ context->frame_count - 1 ];
+  tTextDomFrame * frames;
+
+  if( ( TEXTDOM_T_MAP == frame->type ) && ( _EXPECT_EQUALS == frame->expect ) ) {
+    return( TEXTDOM_E_STRUCTURE );
+  }
+
+  if( context->frame_count == context->frame_size ) {
+    if( NULL == ( frames = realloc( context->frames, context->frame_size * 2 * sizeof( tTextDomFrame ) ) ) ) {
+      return( TEXTLEX_E_MEMORY );
+    }
+    context->frames = frames;
+    context->frame_size *= 2;
+  }
+
+  frame = & context->frames[ context->frame_count++ ];
+  frame->type = type;
+  frame->expect = _EXPECT_ITEM;
+  frame->start = context->node_count;
+  frame->annotation = context->annotation;
+  context->annotation = NULL;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr _close( tTextDomContext * context, unsigned int type ) {
+  tTextDomFrame * frame = & context->frames[ context->frame_count - 1 ];
+  tTextDomNode node;
+  tTextLexErr err;
+
+  if( ( context->frame_count < 2 ) || ( type != frame->type ) || ( _EXPECT_ITEM != frame->expect ) ) {
+    return( TEXTDOM_E_STRUCTURE );
+  }
+
+  if( TEXTLEX_E_NOERR != ( err = _items( context, frame, & node ) ) ) {
+    return( err );
+  }
+
+  context->frame_count--;
+
+  return( _push( context, & node ) );
+}
+
+/* _items()
+**
+** Copies the nodes of the container described by frame off the stack and
+** into the arena and fills in node to point at them.
+*/
+
+static tTextLexErr _items( tTextDomContext * context, tTextDomFrame * frame, tTextDomNode * node ) {
+  size_t count = context->node_count - frame->start;
+  tTextDomNode * items;
+
+  if( NULL == ( items = textdom_arena_alloc( context->arena, count * sizeof( tTextDomNode ) ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  memcpy( items, & context->nodes[ frame->start ], count * sizeof( tTextDomNode ) );
+  context->node_count = frame->start;
+
+  node->type = frame->type;
+  node->count = ( TEXTDOM_T_MAP == frame->type ) ? count / 2 : count;
+  node->annotation = frame->annotation;
+  node->value.items = items;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static const unsigned char * _copy( tTextDomArena * arena, const unsigned char * data, size_t length ) {
+  unsigned char * copy;
+
+  if( NULL == ( copy = textdom_arena_alloc( arena, length + 1 ) ) ) {
+    return( NULL );
+  }
+
+  if( length > 0 ) {
+    memcpy( copy, data, length );
+  }
+  copy[ length ] = '\0';
+
+  return( copy );
+}
+
+/* _base16()
+**
+** Adds the rest of a base16 string (after a comment) to the text of the
+** node holding the first part, which is the last node on the stack.
+*/
+
+static tTextLexErr _base16( tTextDomContext * context, const unsigned char * data, size_t length ) {
+  tTextDomNode * node = & context->nodes[ context->node_count - 1 ];
+  unsigned char * text;
+
+  if( NULL == ( text = textdom_arena_alloc( context->arena, node->count + length + 1 ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  memcpy( text, node->value.text, node->count );
+  if( length > 0 ) {
+    memcpy( text + node->count, data, length );
+  }
+  node->count += length;
+  text[ node->count ] = '\0';
+  node->value.text = text;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr _span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  return( textdom_token( (tTextDomContext *) context, token, data, length ) );
+}
+
+static tTextLexErr _grow( tTextLexContext * context ) {
+  tTextLexBuffer * buffer;
+  tTextLexCount size = context->size * 2;
+
+  if( size <= context->size ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  if( NULL == ( buffer = realloc( context->buffer, size ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  context->buffer = buffer;
+  context->size = size;
+
+  return( TEXTLEX_E_NOERR );
+}
@@ -0,0 +1,206 @@
+/* textdom.h
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file provides the interface to the DSD Document Builder implemented
+** in textdom.c. The builder sits on top of the text lexxer and turns a
+** document into a tree of nodes, so you can look values up by key or index
+** instead of writing a state machine over the tokens yourself.
+**
+** Every node and every octet of text in the tree comes out of an arena: a
+** chain of big blocks handed out from front to back. Resetting the arena
+** throws the whole tree away at once and keeps the blocks for the next
+** document, so once the arena has grown big enough for your messages,
+** building a tree doesn't call malloc() at all.
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_TEXTDOM
+#define _H_TEXTDOM
+
+/* Macro Definitions : Error Codes
+**
+** These pick up where the DSD Binary Lexxer's error codes leave off.
+*/
+
+#define TEXTDOM_E_STRUCTURE     100 /* A token where it doesn't belong */
+#define TEXTDOM_E_UNCLOSED      101 /* Document ended inside an array or map */
+
+/* Macro Definitions : Node Types
+**
+** Atoms use the token type they were lexed from. Hex and base64 strings are
+** the two spellings of binary data, so with literals, integers, floats and
+** strings that's the five atomic types.
+*/
+
+#define TEXTDOM_T_LITERAL       TEXTLEX_T_LITERAL
+#define TEXTDOM_T_INTEGER       TEXTLEX_T_INTEGER
+#define TEXTDOM_T_FLOAT         TEXTLEX_T_FLOAT
+#define TEXTDOM_T_HEX           TEXTLEX_T_HEX
+#define TEXTDOM_T_STRING        TEXTLEX_T_STRING
+#define TEXTDOM_T_BASE64        TEXTLEX_T_BASE64
+#define TEXTDOM_T_ARRAY         TEXTLEX_T_ARRAY_OPEN
+#define TEXTDOM_T_MAP           TEXTLEX_T_MAP_OPEN
+
+/* The arena allocates blocks at least this big. */
+
+#define TEXTDOM_BLOCK_SIZE      ( 64 * 1024 )
+
+/* File Includes */
+
+#include <stddef.h>
+#include "textlex.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+/* A node in the tree. For atoms, text points at the lexeme (just as textlex
+** delivered it, with a '\0' after it) and count is its length. For arrays,
+** items points at count nodes. For maps, items points at 2 * count nodes:
+** each key followed by its value. annotation is the annotation that came
+** right before the node (without the '@' and with a '\0' after it) or NULL.
+*/
+
+typedef struct _text_dom_node {
+  unsigned int                  type;
+  size_t                        count;
+  const char                  * annotation;
+  union {
+    const unsigned char         * text;
+    const struct _text_dom_node * items;
+  } value;
+} tTextDomNode;
+
+/* The arena. It's a linked list of blocks; cursor and limit bound the free
+** space in the current one. Blocks are only freed by textdom_arena_free().
+*/
+
+typedef struct _text_dom_block {
+  struct _text_dom_block * next;
+  size_t                   size;
+} tTextDomBlock;
+
+typedef struct {
+  tTextDomBlock * first;
+  tTextDomBlock * current;
+  unsigned char * cursor;
+  unsigned char * limit;
+} tTextDomArena;
+
+/* The builder keeps the nodes of every array and map that's still open on
+** a stack, then copies them into the arena in one go when it closes. Each
+** open container has a frame saying where its nodes start on the stack and
+** what it expects next. Both stacks only ever grow, so they're reused from
+** one document to the next.
+*/
+
+typedef struct {
+  unsigned int   type;
+  unsigned int   expect;
+  size_t         start;
+  const char   * annotation;
+} tTextDomFrame;
+
+/* The builder's context. The lexxer's context comes first so the lexxer's
+** callbacks can find the builder. base16 is set between the two halves of a
+** base16 string with a comment in the middle.
+*/
+
+typedef struct _text_dom_context {
+  tTextLexContext   text;
+  tTextLexExtension extension;
+  tTextDomArena   * arena;
+  tTextDomNode    * nodes;
+  size_t            node_count;
+  size_t            node_size;
+  tTextDomFrame   * frames;
+  size_t            frame_count;
+  size_t            frame_size;
+  const char      * annotation;
+  unsigned int      base16;
+} tTextDomContext;
+
+/* Function Prototypes */
+
+/* textdom_arena_init(), textdom_arena_alloc(), textdom_arena_reset() and
+** textdom_arena_free()
+**
+** Set up an empty arena, hand out size octets from it (aligned for any of
+** the node types, or NULL if malloc() fails), forget everything handed out
+** so far and give all the arena's memory back to the system.
+*/
+
+void textdom_arena_init( tTextDomArena * arena );
+void * textdom_arena_alloc( tTextDomArena * arena, size_t size );
+void textdom_arena_reset( tTextDomArena * arena );
+void textdom_arena_free( tTextDomArena * arena );
+
+/* textdom_init()
+**
+** Sets up a builder that allocates its tree from arena. It allocates the
+** lexxer's buffer and the builder's stacks, so check for TEXTLEX_E_MEMORY.
+*/
+
+tTextLexErr textdom_init( tTextDomContext * context, tTextDomArena * arena );
+
+/* textdom_update() and textdom_final()
+**
+** Feed the builder a document, in as many pieces as you like, then call
+** textdom_final() to get the root of the tree. The root is an array holding
+** each of the top level values in the document. Lexxer errors come back
+** just like textlex_update() returns them; the builder adds
+** TEXTDOM_E_STRUCTURE and TEXTDOM_E_UNCLOSED.
+*/
+
+tTextLexErr textdom_update( tTextDomContext * context, tTextLexBuffer * data, tTextLexCount length );
+tTextLexErr textdom_final( tTextDomContext * context, const tTextDomNode ** root );
+
+/* textdom_token()
+**
+** This is what the builder calls for each token the lexxer produces (in span
+** mode.) Call it yourself to build a tree from some other token source, like
+** the binary lexxer.
+*/
+
+tTextLexErr textdom_token( tTextDomContext * context, unsigned int token, const unsigned char * data, size_t length );
+
+/* textdom_reset()
+**
+** Gets the builder ready for the next document. Reset the arena too, unless
+** you want to keep the last tree around.
+*/
+
+void textdom_reset( tTextDomContext * context );
+
+/* textdom_free()
+**
+** Frees the lexxer's buffer and the builder's stacks. It doesn't touch the
+** arena.
+*/
+
+void textdom_free( tTextDomContext * context );
+
+/* textdom_find() and textdom_index()
+**
+** Return the value for the first string key in a map that matches key, or
+** the item at index in an array. They return NULL if there's no such value
+** or node isn't a map (or array.)
+*/
+
+const tTextDomNode * textdom_find( const tTextDomNode * node, const char * key );
+const tTextDomNode * textdom_index( const tTextDomNode * node, size_t index );
+
+/* textdom_integer(), textdom_float() and textdom_boolean()
+**
+** Convert an atom. textdom_integer() accepts integers and hex strings,
+** textdom_float() accepts floats and integers and textdom_boolean() accepts
+** the literals *TRUE and *FALSE (in any case.) They return zero if node is
+** the wrong type or out of range.
+*/
+
+int textdom_integer( const tTextDomNode * node, long long * value );
+int textdom_float( const tTextDomNode * node, double * value );
+int textdom_boolean( const tTextDomNode * node, int * value );
+
+#endif /* _H_TEXTDOM */
@@ -0,0 +1,522 @@
+/* textenc.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file implements the DSD Text Writer. Please see textenc.h for more
+** info.
+**
+** Binary data is turned into text a block at a time: each pass of the inner
+** loops writes straight into the output buffer, using a table that holds
+** both hex digits for an octet and another that holds the two base64
+** characters for 12 bits of input. Strings are copied in runs found with
+** the bulk scanner, so only the '"' and '\' octets that need escaping are
+** looked at individually.
+*/
+
+/* Macro Definitions */
+
+#define _B64_PAD '='
+
+/* Macro Definitions : Tables
+**
+** One row of each lookup table: every pair that starts with the character
+** c. The tables are built out of these at compile time, so there's nothing
+** to set up before the first context is initialised.
+*/
+
+#define _HEX_LOWER( c ) \
+  { c, '0' }, { c, '1' }, { c, '2' }, { c, '3' }, { c, '4' }, { c, '5' }, { c, '6' }, { c, '7' }, \
+  { c, '8' }, { c, '9' }, { c, 'a' }, { c, 'b' }, { c, 'c' }, { c, 'd' }, { c, 'e' }, { c, 'f' }
+
+#define _HEX_UPPER( c ) \
+  { c, '0' }, { c, '1' }, { c, '2' }, { c, '3' }, { c, '4' }, { c, '5' }, { c, '6' }, { c, '7' }, \
+  { c, '8' }, { c, '9' }, { c, 'A' }, { c, 'B' }, { c, 'C' }, { c, 'D' }, { c, 'E' }, { c, 'F' }
+
+#define _B64_ROW( c ) \
+  { c, 'A' }, { c, 'B' }, { c, 'C' }, { c, 'D' }, { c, 'E' }, { c, 'F' }, { c, 'G' }, { c, 'H' }, \
+  { c, 'I' }, { c, 'J' }, { c, 'K' }, { c, 'L' }, { c, 'M' }, { c, 'N' }, { c, 'O' }, { c, 'P' }, \
+  { c, 'Q' }, { c, 'R' }, { c, 'S' }, { c, 'T' }, { c, 'U' }, { c, 'V' }, { c, 'W' }, { c, 'X' }, \
+  { c, 'Y' }, { c, 'Z' }, { c, 'a' }, { c, 'b' }, { c, 'c' }, { c, 'd' }, { c, 'e' }, { c, 'f' }, \
+  { c, 'g' }, { c, 'h' }, { c, 'i' }, { c, 'j' }, { c, 'k' }, { c, 'l' }, { c, 'm' }, { c, 'n' }, \
+  { c, 'o' }, { c, 'p' }, { c, 'q' }, { c, 'r' }, { c, 's' }, { c, 't' }, { c, 'u' }, { c, 'v' }, \
+  { c, 'w' }, { c, 'x' }, { c, 'y' }, { c, 'z' }, { c, '0' }, { c, '1' }, { c, '2' }, { c, '3' }, \
+  { c, '4' }, { c, '5' }, { c, '6' }, { c, '7' }, { c, '8' }, { c, '9' }, { c, '+' }, { c, '/' }
+
+/* File Includes */
+
+#include <string.h>
+#include "textenc.h"
+#include "textscan.h"
+
+/* Function Prototypes */
+
+static tTextLexErr _room( tTextEncContext * context );
+static tTextLexErr _put( tTextEncContext * context, const unsigned char * data, size_t length );
+static tTextLexErr _separate( tTextEncContext * context, unsigned int token );
+static tTextLexErr _indent( tTextEncContext * context, int newline );
+static tTextLexErr _escape( tTextEncContext * context, const unsigned char * data, size_t length );
+static tTextLexErr _hex( tTextEncContext * context, const unsigned char * data, size_t length, int upper );
+static tTextLexErr _base64( tTextEncContext * context, const unsigned char * data, size_t length );
+
+/* Global Variables */
+
+/* The octets written before and after the lexeme for each token. */
+
+static const unsigned char _prefix[ TEXTLEX_C_TOKENS ] = {
+  0, '#', '@', '*', 0, 0, '$', '"', '\'', '[', ']', '{', '}', '='
+};
+
+static const unsigned char _suffix[ TEXTLEX_C_TOKENS ] = {
+  0, '\n', 0, 0, 0, 0, 0, '"', '\'', 0, 0, 0, 0, 0
+};
+
+/* Tokens that don't end with a delimiter of their own. A number written
+** right after one of these would run into it, so there has to be a space
+** between them.
+*/
+
+static const unsigned char _open_ended[ TEXTLEX_C_TOKENS ] = {
+  0, 0, 1, 1, 1, 1, 1, 0, 0, 0, 0, 0, 0, 0
+};
+
+static const char _b64_digits[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+static const char _spaces[] = "                                ";
+
+/* Both hex digits for each octet, lower and upper case, and the two base64
+** characters for each 12 bits.
+*/
+
+static const unsigned char _hex_pairs[ 2 ][ 256 ][ 2 ] = {
+  {
+    _HEX_LOWER( '0' ), _HEX_LOWER( '1' ), _HEX_LOWER( '2' ), _HEX_LOWER( '3' ), _HEX_LOWER( '4' ),
+    _HEX_LOWER( '5' ), _HEX_LOWER( '6' ), _HEX_LOWER( '7' ), _HEX_LOWER( '8' ), _HEX_LOWER( '9' ),
+    _HEX_LOWER( 'a' ), _HEX_LOWER( 'b' ), _HEX_LOWER( 'c' ), _HEX_LOWER( 'd' ), _HEX_LOWER( 'e' ),
+    _HEX_LOWER( 'f' )
+  }, {
+    _HEX_UPPER( '0' ), _HEX_UPPER( '1' ), _HEX_UPPER( '2' ), _HEX_UPPER( '3' ), _HEX_UPPER( '4' ),
+    _HEX_UPPER( '5' ), _HEX_UPPER( '6' ), _HEX_UPPER( '7' ), _HEX_UPPER( '8' ), _HEX_UPPER( '9' ),
+    _HEX_UPPER( 'A' ), _HEX_UPPER( 'B' ), _HEX_UPPER( 'C' ), _HEX_UPPER( 'D' ), _HEX_UPPER( 'E' ),
+    _HEX_UPPER( 'F' )
+  }
+};
+
+static const unsigned char _b64_pairs[ 4096 ][ 2 ] = {
+  _B64_ROW( 'A' ), _B64_ROW( 'B' ), _B64_ROW( 'C' ), _B64_ROW( 'D' ), _B64_ROW( 'E' ),
+  _B64_ROW( 'F' ), _B64_ROW( 'G' ), _B64_ROW( 'H' ), _B64_ROW( 'I' ), _B64_ROW( 'J' ),
+  _B64_ROW( 'K' ), _B64_ROW( 'L' ), _B64_ROW( 'M' ), _B64_ROW( 'N' ), _B64_ROW( 'O' ),
+  _B64_ROW( 'P' ), _B64_ROW( 'Q' ), _B64_ROW( 'R' ), _B64_ROW( 'S' ), _B64_ROW( 'T' ),
+  _B64_ROW( 'U' ), _B64_ROW( 'V' ), _B64_ROW( 'W' ), _B64_ROW( 'X' ), _B64_ROW( 'Y' ),
+  _B64_ROW( 'Z' ), _B64_ROW( 'a' ), _B64_ROW( 'b' ), _B64_ROW( 'c' ), _B64_ROW( 'd' ),
+  _B64_ROW( 'e' ), _B64_ROW( 'f' ), _B64_ROW( 'g' ), _B64_ROW( 'h' ), _B64_ROW( 'i' ),
+  _B64_ROW( 'j' ), _B64_ROW( 'k' ), _B64_ROW( 'l' ), _B64_ROW( 'm' ), _B64_ROW( 'n' ),
+  _B64_ROW( 'o' ), _B64_ROW( 'p' ), _B64_ROW( 'q' ), _B64_ROW( 'r' ), _B64_ROW( 's' ),
+  _B64_ROW( 't' ), _B64_ROW( 'u' ), _B64_ROW( 'v' ), _B64_ROW( 'w' ), _B64_ROW( 'x' ),
+  _B64_ROW( 'y' ), _B64_ROW( 'z' ), _B64_ROW( '0' ), _B64_ROW( '1' ), _B64_ROW( '2' ),
+  _B64_ROW( '3' ), _B64_ROW( '4' ), _B64_ROW( '5' ), _B64_ROW( '6' ), _B64_ROW( '7' ),
+  _B64_ROW( '8' ), _B64_ROW( '9' ), _B64_ROW( '+' ), _B64_ROW( '/' )
+};
+
+/* Function Definitions */
+
+tTextLexErr textenc_init( tTextEncContext * context, unsigned char * buffer, size_t size, unsigned int mode ) {
+  memset( context, 0, sizeof( tTextEncContext ) );
+  context->buffer = buffer;
+  context->size = size;
+  context->mode = mode;
+  context->last = TEXTLEX_T_END;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+tTextLexErr textenc_token( tTextEncContext * context, unsigned int token ) {
+  tTextLexErr err;
+
+  if( ( token < TEXTLEX_T_ARRAY_OPEN ) || ( token >= TEXTLEX_C_TOKENS ) ) {
+    return( TEXTLEX_E_ERROR );
+  }
+
+  if( TEXTLEX_E_NOERR != ( err = _separate( context, token ) ) ) {
+    return( err );
+  }
+
+  return( _put( context, & _prefix[ token ], 1 ) );
+}
+
+tTextLexErr textenc_integer( tTextEncContext * context, long long value ) {
+  char text[ TEXTNUM_C_TEXT ];
+  size_t length;
+
+  if( value < 0 ) {
+    length = textnum_integer_text( 0ULL - (unsigned long long) value, 1, text );
+  } else {
+    length = textnum_integer_text( (unsigned long long) value, 0, text );
+  }
+
+  return( textenc_text( context, TEXTLEX_T_INTEGER, (unsigned char *) text, length ) );
+}
+
+tTextLexErr textenc_unsigned( tTextEncContext * context, unsigned long long value ) {
+  char text[ TEXTNUM_C_TEXT ];
+  size_t length = textnum_integer_text( value, 0, text );
+
+  return( textenc_text( context, TEXTLEX_T_INTEGER, (unsigned char *) text, length ) );
+}
+
+tTextLexErr textenc_float( tTextEncContext * context, double value ) {
+  char text[ TEXTNUM_C_TEXT ];
+  size_t length;
+
+  if( 0 == ( length = textnum_float_text( value, text ) ) ) {
+    return( TEXTLEX_E_ERROR );
+  }
+
+  return( textenc_text( context, TEXTLEX_T_FLOAT, (unsigned char *) text, length ) );
+}
+
+tTextLexErr textenc_text( tTextEncContext * context, unsigned int token, const unsigned char * data, size_t length ) {
+  tTextLexErr err;
+
+  if( ( token < TEXTLEX_T_COMMENT ) || ( token > TEXTLEX_T_BASE64 ) ) {
+    return( TEXTLEX_E_ERROR );
+  }
+
+  if( ( TEXTLEX_T_COMMENT == token ) && ( length != textscan_find2( data, length, '\n', '\r' ) ) ) {
+    return( TEXTLEX_E_ERROR );
+  }
+
+  do {
+    if( TEXTLEX_E_NOERR != ( err = _separate( context, token ) ) ) {
+      break;
+    }
+
+    if( ( 0 != _prefix[ token ] ) && ( TEXTLEX_E_NOERR != ( err = _put( context, & _prefix[ token ], 1 ) ) ) ) {
+      break;
+    }
+
+    if( TEXTLEX_T_STRING == token ) {
+      err = _escape( context, data, length );
+    } else {
+      err = _put( context, data, length );
+    }
+
+    if( TEXTLEX_E_NOERR != err ) {
+      break;
+    }
+
+    if( 0 != _suffix[ token ] ) {
+      err = _put( context, & _suffix[ token ], 1 );
+    }
+  } while( 0 );
+
+  return( err );
+}
+
+tTextLexErr textenc_octets( tTextEncContext * context, const unsigned char * data, size_t length, int upper ) {
+  tTextLexErr err;
+
+  if( TEXTLEX_E_NOERR != ( err = _separate( context, TEXTLEX_T_HEX ) ) ) {
+    return( err );
+  }
+
+  if( TEXTLEX_E_NOERR != ( err = _put( context, & _prefix[ TEXTLEX_T_HEX ], 1 ) ) ) {
+    return( err );
+  }
+
+  return( _hex( context, data, length, upper ) );
+}
+
+tTextLexErr textenc_base64( tTextEncContext * context, const unsigned char * data, size_t length ) {
+  tTextLexErr err;
+
+  do {
+    if( TEXTLEX_E_NOERR != ( err = _separate( context, TEXTLEX_T_BASE64 ) ) ) {
+      break;
+    }
+
+    if( TEXTLEX_E_NOERR != ( err = _put( context, & _prefix[ TEXTLEX_T_BASE64 ], 1 ) ) ) {
+      break;
+    }
+
+    if( TEXTLEX_E_NOERR != ( err = _base64( context, data, length ) ) ) {
+      break;
+    }
+
+    err = _put( context, & _suffix[ TEXTLEX_T_BASE64 ], 1 );
+  } while( 0 );
+
+  return( err );
+}
+
+tTextLexErr textenc_final( tTextEncContext * context ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+
+  if( ( TEXTENC_M_PRETTY == context->mode ) && ( TEXTLEX_T_END != context->last ) && ( TEXTLEX_T_COMMENT != context->last ) ) {
+    err = _put( context, (unsigned char *) "\n", 1 );
+    context->last = TEXTLEX_T_END;
+  }
+
+  if( ( TEXTLEX_E_NOERR == err ) && ( context->index > 0 ) && ( NULL != context->flush ) ) {
+    err = context->flush( context );
+  }
+
+  return( err );
+}
+
+/* _room()
+**
+** Makes sure there's at least one free octet in the output buffer.
+*/
+
+static tTextLexErr _room( tTextEncContext * context ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+
+  if( context->index < context->size ) {
+    return( TEXTLEX_E_NOERR );
+  }
+
+  if( ( NULL == context->flush ) || ( TEXTLEX_E_NOERR != ( err = context->flush( context ) ) ) ) {
+    return( ( TEXTLEX_E_NOERR == err ) ? TEXTLEX_E_MEMORY : err );
+  }
+
+  return( ( context->index < context->size ) ? TEXTLEX_E_NOERR : TEXTLEX_E_ERROR );
+}
+
+/* _put()
+**
+** Appends octets to the output buffer, flushing it whenever it fills up.
+*/
+
+static tTextLexErr _put( tTextEncContext * context, const unsigned char * data, size_t length ) {
+  tTextLexErr err;
+  size_t chunk;
+
+  context->written += length;
+
+  if( length <= context->size - context->index ) {
+    memcpy( & context->buffer[ context->index ], data, length );
+    context->index += length;
+    return( TEXTLEX_E_NOERR );
+  }
+
+  while( length > 0 ) {
+    if( TEXTLEX_E_NOERR != ( err = _room( context ) ) ) {
+      return( err );
+    }
+    chunk = context->size - context->index;
+    if( chunk > length ) {
+      chunk = length;
+    }
+    memcpy( & context->buffer[ context->index ], data, chunk );
+    context->index += chunk;
+    data += chunk;
+    length -= chunk;
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* _separate()
+**
+** Writes whatever white space belongs in front of token and keeps track of
+** the nesting depth. In compact mode that's nothing except the space
+** between a number and an open ended token in front of it. In pretty mode
+** every item starts a new line, except that '=' gets a space on either side
+** and an annotation shares its line with whatever it annotates.
+*/
+
+static tTextLexErr _separate( tTextEncContext * context, unsigned int token ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  unsigned int last = context->last;
+  int closing = ( TEXTLEX_T_ARRAY_CLOSE == token ) || ( TEXTLEX_T_MAP_CLOSE == token );
+
+  context->last = token;
+
+  if( closing && ( context->depth > 0 ) ) {
+    context->depth--;
+  }
+
+  if( TEXTENC_M_COMPACT == context->mode ) {
+    if( _open_ended[ last ] && ( ( TEXTLEX_T_INTEGER == token ) || ( TEXTLEX_T_FLOAT == token ) ) ) {
+      err = _put( context, (unsigned char *) " ", 1 );
+    }
+  } else if( TEXTLEX_T_END == last ) {
+    /* The first item in the document doesn't need anything. */
+  } else if( closing && ( ( TEXTLEX_T_ARRAY_OPEN == last ) || ( TEXTLEX_T_MAP_OPEN == last ) ) ) {
+    /* Neither does the end of an empty array or map. */
+  } else if( ( TEXTLEX_T_EQUALS == token ) || ( TEXTLEX_T_EQUALS == last ) || ( TEXTLEX_T_ANNOTATION == last ) ) {
+    err = _put( context, (unsigned char *) " ", 1 );
+  } else {
+    err = _indent( context, TEXTLEX_T_COMMENT != last );
+  }
+
+  if( ( TEXTLEX_T_ARRAY_OPEN == token ) || ( TEXTLEX_T_MAP_OPEN == token ) ) {
+    context->depth++;
+  }
+
+  return( err );
+}
+
+static tTextLexErr _indent( tTextEncContext * context, int newline ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t count = context->depth * TEXTENC_INDENT;
+  size_t chunk;
+
+  if( newline ) {
+    err = _put( context, (unsigned char *) "\n", 1 );
+  }
+
+  while( ( count > 0 ) && ( TEXTLEX_E_NOERR == err ) ) {
+    chunk = ( count < sizeof( _spaces ) - 1 ) ? count : sizeof( _spaces ) - 1;
+    err = _put( context, (const unsigned char *) _spaces, chunk );
+    count -= chunk;
+  }
+
+  return( err );
+}
+
+/* _escape()
+**
+** Writes the body of a string, putting a backslash in front of every '"' and
+** '\' in it.
+*/
+
+static tTextLexErr _escape( tTextEncContext * context, const unsigned char * data, size_t length ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  unsigned char escape[ 2 ] = { '\\', 0 };
+  size_t run;
+
+  while( ( length > 0 ) && ( TEXTLEX_E_NOERR == err ) ) {
+    run = textscan_find2( data, length, '"', '\\' );
+
+    if( ( run > 0 ) && ( TEXTLEX_E_NOERR != ( err = _put( context, data, run ) ) ) ) {
+      break;
+    }
+
+    if( run < length ) {
+      escape[ 1 ] = data[ run ];
+      err = _put( context, escape, 2 );
+      run++;
+    }
+
+    data += run;
+    length -= run;
+  }
+
+  return( err );
+}
+
+/* _hex()
+**
+** Writes the hex digits for length octets straight into the output buffer,
+** as many as will fit between flushes.
+*/
+
+static tTextLexErr _hex( tTextEncContext * context, const unsigned char * data, size_t length, int upper ) {
+  const unsigned char ( * pairs )[ 2 ] = _hex_pairs[ upper ? 1 : 0 ];
+  tTextLexErr err;
+  unsigned char * output;
+  size_t count, i;
+
+  while( length > 0 ) {
+    if( TEXTLEX_E_NOERR != ( err = _room( context ) ) ) {
+      return( err );
+    }
+
+    count = ( context->size - context->index ) / 2;
+
+    if( 0 == count ) {
+      /* Only one octet of room; let _put() split the pair across a flush. */
+      if( TEXTLEX_E_NOERR != ( err = _put( context, pairs[ * data ], 2 ) ) ) {
+        return( err );
+      }
+      data++;
+      length--;
+      continue;
+    }
+
+    if( count > length ) {
+      count = length;
+    }
+
+    output = & context->buffer[ context->index ];
+    for( i = 0; i < count; i++ ) {
+      memcpy( & output[ i * 2 ], pairs[ data[ i ] ], 2 );
+    }
+
+    context->index += count * 2;
+    context->written += count * 2;
+    data += count;
+    length -= count;
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* _base64()
+**
+** Writes the base64 encoding of length octets. Every three octets of input
+** turn into four characters, looked up twelve bits at a time. The last
+** group is padded with '='.
+*/
+
+static tTextLexErr _base64( tTextEncContext * context, const unsigned char * data, size_t length ) {
+  tTextLexErr err;
+  unsigned char group[ 4 ];
+  unsigned char * output;
+  unsigned long bits;
+  size_t count, i;
+
+  while( length >= 3 ) {
+    if( TEXTLEX_E_NOERR != ( err = _room( context ) ) ) {
+      return( err );
+    }
+
+    count = ( context->size - context->index ) / 4;
+    if( count > length / 3 ) {
+      count = length / 3;
+    }
+
+    if( 0 == count ) {
+      bits = ( (unsigned long) data[ 0 ] << 16 ) | ( (unsigned long) data[ 1 ] << 8 ) | data[ 2 ];
+      memcpy( & group[ 0 ], _b64_pairs[ bits >> 12 ], 2 );
+      memcpy( & group[ 2 ], _b64_pairs[ bits & 0xFFF ], 2 );
+      if( TEXTLEX_E_NOERR != ( err = _put( context, group, 4 ) ) ) {
+        return( err );
+      }
+      data += 3;
+      length -= 3;
+      continue;
+    }
+
+    output = & context->buffer[ context->index ];
+    for( i = 0; i < count; i++ ) {
+      bits = ( (unsigned long) data[ 0 ] << 16 ) | ( (unsigned long) data[ 1 ] << 8 ) | data[ 2 ];
+      memcpy( & output[ 0 ], _b64_pairs[ bits >> 12 ], 2 );
+      memcpy( & output[ 2 ], _b64_pairs[ bits & 0xFFF ], 2 );
+      output += 4;
+      data += 3;
+    }
+
+    context->index += count * 4;
+    context->written += count * 4;
+    length -= count * 3;
+  }
+
+  if( 0 == length ) {
+    return( TEXTLEX_E_NOERR );
+  }
+
+  bits = (unsigned long) data[ 0 ] << 16;
+  if( 2 == length ) {
+    bits |= (unsigned long) data[ 1 ] << 8;
+  }
+
+  group[ 0 ] = _b64_digits[ bits >> 18 ];
+  group[ 1 ] = _b64_digits[ ( bits >> 12 ) & 63 ];
+  group[ 2 ] = ( 2 == length ) ? _b64_digits[ ( bits >> 6 ) & 63 ] : _B64_PAD;
+  group[ 3 ] = _B64_PAD;
+
+  return( _put( context, group, 4 ) );
+}
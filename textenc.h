@@ -0,0 +1,116 @@
+/* textenc.h
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file provides the interface to the DSD Text Writer implemented in
+** textenc.c. It works like the DSD Binary Encoder (see binenc.h): you supply
+** an output buffer and a flush callback and the writer fills the buffer with
+** DSD/Text, calling flush whenever it runs out of room. It can write compact
+** text (like @t{"a"=1}) or indent it so people can read it.
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_TEXTENC
+#define _H_TEXTENC
+
+/* Macro Definitions : Output Modes */
+
+#define TEXTENC_M_COMPACT 0 /* No more white space than it takes */
+#define TEXTENC_M_PRETTY  1 /* One item per line, indented */
+
+/* How many spaces each level of nesting is indented in TEXTENC_M_PRETTY. */
+
+#define TEXTENC_INDENT    2
+
+/* File Includes */
+
+#include <stddef.h>
+#include "textlex.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+/* The writer's context. buffer, size, index, written and flush work just
+** like they do in the binary encoder's context. The flush callback can
+** either write out the buffer and set index back to zero or, if you want
+** the whole document in memory, realloc() a bigger buffer and update
+** buffer and size. Either way, there has to be room in the buffer when it
+** returns.
+**
+** mode is one of the TEXTENC_M_* values. depth and last are how deeply
+** nested the writer is and the last token it wrote; they decide what white
+** space goes in front of the next item.
+*/
+
+typedef struct _text_enc_context {
+  unsigned char  * buffer;
+  size_t           size;
+  size_t           index;
+  size_t           written;
+  tTextLexErr    (*flush)( struct _text_enc_context * context );
+  unsigned int     mode;
+  unsigned int     depth;
+  unsigned int     last;
+} tTextEncContext;
+
+/* Function Prototypes */
+
+/* textenc_init()
+**
+** Initializes a writer context to write into buffer using one of the
+** TEXTENC_M_* modes. Set the flush callback afterwards.
+*/
+
+tTextLexErr textenc_init( tTextEncContext * context, unsigned char * buffer, size_t size, unsigned int mode );
+
+/* textenc_token()
+**
+** Writes one of the fixed tokens: TEXTLEX_T_ARRAY_OPEN, TEXTLEX_T_ARRAY_CLOSE,
+** TEXTLEX_T_MAP_OPEN, TEXTLEX_T_MAP_CLOSE or TEXTLEX_T_EQUALS.
+*/
+
+tTextLexErr textenc_token( tTextEncContext * context, unsigned int token );
+
+/* textenc_integer(), textenc_unsigned() and textenc_float()
+**
+** Write a number. Floats are written with the fewest digits that read back
+** as the same double and always have a decimal point, so they read back as
+** floats. Infinities and NaNs have no DSD/Text representation, so
+** textenc_float() returns TEXTLEX_E_ERROR for them.
+*/
+
+tTextLexErr textenc_integer( tTextEncContext * context, long long value );
+tTextLexErr textenc_unsigned( tTextEncContext * context, unsigned long long value );
+tTextLexErr textenc_float( tTextEncContext * context, double value );
+
+/* textenc_text()
+**
+** Writes a lexeme the way textlex would have delivered it, as one of the
+** TEXTLEX_T_* value tokens (everything from TEXTLEX_T_COMMENT to
+** TEXTLEX_T_BASE64.) The writer adds the punctuation: the '#' and line feed
+** around a comment, the quotes around a string (escaping any '"' or '\'
+** inside it) and so on. Comments can't contain a carriage return or a line
+** feed; you get TEXTLEX_E_ERROR if they do.
+*/
+
+tTextLexErr textenc_text( tTextEncContext * context, unsigned int token, const unsigned char * data, size_t length );
+
+/* textenc_octets() and textenc_base64()
+**
+** Write length octets of binary data, either as a hex string (with upper
+** case digits if upper is non-zero) or as a base64 string.
+*/
+
+tTextLexErr textenc_octets( tTextEncContext * context, const unsigned char * data, size_t length, int upper );
+tTextLexErr textenc_base64( tTextEncContext * context, const unsigned char * data, size_t length );
+
+/* textenc_final()
+**
+** Ends the last line (in TEXTENC_M_PRETTY) and flushes whatever is left in
+** the buffer.
+*/
+
+tTextLexErr textenc_final( tTextEncContext * context );
+
+#endif /* _H_TEXTENC */
@@ -0,0 +1,116 @@
+/* textfile.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file implements the file front end described in textfile.h.
+**
+** A mapped file is lexed straight out of the page cache, so nothing gets
+** copied on the way in, and with the sequential hint the kernel reads ahead
+** of the lexxer. textlex_update() counts in tTextLexCount, so a mapping is
+** handed over in pieces of up to TEXTFILE_MAX_UPDATE octets; the lexxer
+** doesn't care where the pieces start and end.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 200112L
+
+#define TEXTFILE_MAX_UPDATE ( 1024 * 1024 * 1024 )
+
+/* File Includes */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "textfile.h"
+
+/* Function Prototypes */
+
+static tTextLexErr _mapped( tTextLexContext * context, tTextLexBuffer * data, size_t size, unsigned long long * length );
+static tTextLexErr _read( tTextLexContext * context, int fd, unsigned long long * length );
+
+/* Function Definitions */
+
+tTextLexErr textfile_update( tTextLexContext * context, int fd, unsigned long long * length ) {
+  tTextLexErr err;
+  struct stat status;
+  void * data;
+  unsigned long long ignored;
+
+  if( NULL == length ) {
+    length = & ignored;
+  }
+
+  * length = 0;
+
+  if( 0 != fstat( fd, & status ) ) {
+    return( TEXTFILE_E_READ );
+  }
+
+  /* Empty files (and files in /proc, which say they're empty) are read. */
+
+  if( S_ISREG( status.st_mode ) && ( status.st_size > 0 ) && ( (unsigned long long) status.st_size <= SIZE_MAX ) ) {
+    data = mmap( NULL, (size_t) status.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+    if( MAP_FAILED != data ) {
+      posix_madvise( data, (size_t) status.st_size, POSIX_MADV_SEQUENTIAL );
+      err = _mapped( context, (tTextLexBuffer *) data, (size_t) status.st_size, length );
+      munmap( data, (size_t) status.st_size );
+      return( err );
+    }
+  }
+
+  return( _read( context, fd, length ) );
+}
+
+static tTextLexErr _mapped( tTextLexContext * context, tTextLexBuffer * data, size_t size, unsigned long long * length ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  size_t offset, piece;
+
+  for( offset = 0; ( offset < size ) && ( TEXTLEX_E_NOERR == err ); offset += piece ) {
+    piece = ( ( size - offset ) > TEXTFILE_MAX_UPDATE ) ? TEXTFILE_MAX_UPDATE : ( size - offset );
+    err = textlex_update( context, data + offset, (tTextLexCount) piece );
+    * length += ( TEXTLEX_E_NOERR == err ) ? piece : context->bytes_read;
+  }
+
+  return( err );
+}
+
+/* _read()
+**
+** The fallback for pipes and the like. A pipe hands over whatever's in it
+** when read() is called, so the buffer is lexed as soon as anything comes
+** in rather than waiting for it to fill.
+*/
+
+static tTextLexErr _read( tTextLexContext * context, int fd, unsigned long long * length ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  void * buffer;
+  ssize_t got;
+
+  if( 0 != posix_memalign( & buffer, TEXTFILE_READ_ALIGN, TEXTFILE_READ_SIZE ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  while( TEXTLEX_E_NOERR == err ) {
+    got = read( fd, buffer, TEXTFILE_READ_SIZE );
+
+    if( got < 0 ) {
+      if( EINTR != errno ) {
+        err = TEXTFILE_E_READ;
+      }
+    } else if( 0 == got ) {
+      break;
+    } else {
+      err = textlex_update( context, (tTextLexBuffer *) buffer, (tTextLexCount) got );
+      * length += ( TEXTLEX_E_NOERR == err ) ? (unsigned long long) got : context->bytes_read;
+    }
+  }
+
+  free( buffer );
+
+  return( err );
+}
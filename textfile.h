@@ -0,0 +1,60 @@
+/* textfile.h
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file provides the interface to the file front end implemented in
+** textfile.c. It feeds everything in a file descriptor to the text lexxer in
+** one pass: regular files are memory mapped and handed to textlex_update()
+** whole, and anything that can't be mapped (pipes, sockets, terminals) is
+** read in big chunks instead of a line or a few dozen octets at a time.
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_TEXTFILE
+#define _H_TEXTFILE
+
+/* Macro Definitions : Error Codes
+**
+** These pick up where the struct binder's error codes leave off.
+*/
+
+#define TEXTFILE_E_READ         104 /* fstat() or read() failed; see errno */
+
+/* Input that can't be mapped is read this many octets at a time, into a
+** buffer aligned on TEXTFILE_READ_ALIGN octets.
+*/
+
+#ifndef TEXTFILE_READ_SIZE
+#define TEXTFILE_READ_SIZE      ( 1024 * 1024 )
+#endif
+
+#define TEXTFILE_READ_ALIGN     4096
+
+/* File Includes */
+
+#include "textlex.h"
+
+/* Function Prototypes */
+
+/* textfile_update()
+**
+** Lexes everything that can be read from fd, calling the callbacks in
+** context as textlex_update() would. The context should have been set up
+** with textlex_init() and its callbacks set, and you should call
+** textlex_final() afterwards. The callbacks can't return TEXTLEX_E_YIELD,
+** so this doesn't work with pull mode.
+**
+** If fd is a regular file, it's mapped with mmap() and the kernel is told
+** it'll be read sequentially. Otherwise, or if mapping it fails, it's read
+** with read() until end of file. Either way, if length isn't NULL the number
+** of octets lexed is stored there, even if there was an error.
+**
+** Returns TEXTFILE_E_READ if fstat() or read() fails, TEXTLEX_E_MEMORY if
+** it can't allocate the read buffer, or whatever textlex_update() returns.
+*/
+
+tTextLexErr textfile_update( tTextLexContext * context, int fd, unsigned long long * length );
+
+#endif /* _H_TEXTFILE */
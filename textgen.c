@@ -0,0 +1,647 @@
+/* textgen.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This program reads a schema describing a C struct and writes the code
+** that binds DSD maps to it with the DSD Struct Binder (see textbind.h):
+**
+**   textgen example_bind.dsd example_bind
+**
+** writes example_bind.h, which declares the struct (and any structs nested
+** in it), the table describing it and a function to parse a document into
+** it, and example_bind.c, which defines them. The schema is itself a DSD
+** document holding one map:
+**
+**   {
+**     "struct" = "tBindStruct"
+**     "fields" = [
+**       { "key" = "secret" "type" = "octets" "size" = 20 }
+**       { "key" = "iterations" "type" = "unsigned" }
+**       { "key" = "owner" "type" = "map" "struct" = "tOwner" "fields" = [ ... ] }
+**       { "key" = "rounds" "type" = "array" "size" = 8 "items" = { "type" = "int" } }
+**     ]
+**   }
+**
+** Each field has a "key" and a "type": int, unsigned, long, double,
+** boolean, octets, string, map or array. The member's name is the key,
+** with anything that can't go in a C identifier turned into an underscore,
+** unless the field has a "name". Octets, string and array fields need a
+** "size": the most octets, characters or elements they hold. Octets members
+** get a size_t named after them with "_length" on the end, and arrays get
+** one with "_count" on the end. A map field has "fields" of its own and may
+** name its struct (the default is the parent's name, an underscore and the
+** member's name.) An array field's "items" says what its elements are, the
+** same way a field does, but without a key; they can't be arrays or octets.
+**
+** The lookup function for each struct is a trie: a switch on the key's
+** length, then switches on whichever octet tells the remaining keys apart
+** best, until there's only one key left to compare with memcmp().
+*/
+
+/* Macro Definitions */
+
+#define _MAX_STRUCTS    64
+#define _MAX_FIELDS     256
+
+/* File Includes */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "textdom.h"
+#include "textbind.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  const unsigned char * key;
+  size_t                key_length;
+  char                  member[ 128 ];
+  unsigned int          kind;
+  long long             size;
+  long long             items;
+  int                   nested;
+} tGenField;
+
+typedef struct {
+  char                  name[ 128 ];
+  tGenField           * fields;
+  size_t                count;
+} tGenStruct;
+
+/* Function Prototypes */
+
+static int _struct( const tTextDomNode * node, const char * name );
+static int _field( const tTextDomNode * node, const char * parent, tGenField * field, int item );
+static const char * _text( const tTextDomNode * node, const char * key );
+static int _identifier( const char * name );
+static void _header( FILE * output, const char * prefix, const char * schema );
+static void _code( FILE * output, const char * prefix, const char * schema );
+static void _member( FILE * output, const tGenField * field );
+static void _trie( FILE * output, const tGenStruct * s, size_t * keys, size_t count, unsigned int depth );
+static void _literal( FILE * output, const unsigned char * text, size_t length );
+static unsigned char * load_file( char * path, size_t * length );
+
+/* Global Variables */
+
+static const struct {
+  const char   * name;
+  unsigned int   kind;
+  const char   * type;
+  const char   * macro;
+} kinds [] = {
+  { "int", TEXTBIND_K_INT, "int", "TEXTBIND_K_INT" },
+  { "unsigned", TEXTBIND_K_UNSIGNED, "unsigned int", "TEXTBIND_K_UNSIGNED" },
+  { "long", TEXTBIND_K_LONG, "long long", "TEXTBIND_K_LONG" },
+  { "double", TEXTBIND_K_DOUBLE, "double", "TEXTBIND_K_DOUBLE" },
+  { "boolean", TEXTBIND_K_BOOLEAN, "int", "TEXTBIND_K_BOOLEAN" },
+  { "octets", TEXTBIND_K_OCTETS, "unsigned char", "TEXTBIND_K_OCTETS" },
+  { "string", TEXTBIND_K_STRING, "char", "TEXTBIND_K_STRING" },
+  { "map", TEXTBIND_K_MAP, NULL, "TEXTBIND_K_MAP" },
+  { NULL, 0, NULL, NULL }
+};
+
+/* Structs are added once all the structs nested in them have been, so
+** they can be written out in order.
+*/
+
+static tGenStruct structs[ _MAX_STRUCTS ];
+static size_t struct_count = 0;
+
+int main( int argc, char * argv [] ) {
+  tTextDomArena arena;
+  tTextDomContext builder;
+  const tTextDomNode * root;
+  const tTextDomNode * schema;
+  const char * name;
+  const char * prefix;
+  unsigned char * data;
+  char path[ 1024 ];
+  FILE * output;
+  size_t length;
+  tTextLexErr err;
+  int failed = 1;
+
+  if( 3 != argc ) {
+    fprintf( stderr, "%%TEXTGEN-F-USAGE; Usage: %s <schema> <output name>\n", argv[ 0 ] );
+    return( 1 );
+  }
+
+  prefix = ( NULL == ( prefix = strrchr( argv[ 2 ], '/' ) ) ) ? argv[ 2 ] : prefix + 1;
+  if( ! _identifier( prefix ) || ( strlen( argv[ 2 ] ) + 3 > sizeof( path ) ) ) {
+    fprintf( stderr, "%%TEXTGEN-F-NAME; %s won't make a C identifier.\n", prefix );
+    return( 1 );
+  }
+
+  if( NULL == ( data = load_file( argv[ 1 ], & length ) ) ) {
+    fprintf( stderr, "%%TEXTGEN-F-INPUT; Can't read the schema from %s.\n", argv[ 1 ] );
+    return( 1 );
+  }
+
+  textdom_arena_init( & arena );
+
+  do {
+    if( TEXTLEX_E_NOERR != ( err = textdom_init( & builder, & arena ) ) ) {
+      fprintf( stderr, "%%TEXTGEN-F-MEMORY; Can't initialize the builder.\n" );
+      break;
+    }
+
+    if( ( TEXTLEX_E_NOERR != ( err = textdom_update( & builder, data, length ) ) ) ||
+        ( TEXTLEX_E_NOERR != ( err = textdom_final( & builder, & root ) ) ) ) {
+      fprintf( stderr, "%%TEXTGEN-F-PARSE; Error %d on line %u of %s.\n", err, builder.text.line + 1, argv[ 1 ] );
+      textdom_free( & builder );
+      break;
+    }
+
+    schema = textdom_index( root, 0 );
+    if( ( NULL == ( name = _text( schema, "struct" ) ) ) || ( 0 != _struct( schema, name ) ) ) {
+      if( NULL == name ) {
+        fprintf( stderr, "%%TEXTGEN-F-SCHEMA; The schema needs to be a map with a \"struct\" name.\n" );
+      }
+      textdom_free( & builder );
+      break;
+    }
+
+    sprintf( path, "%s.h", argv[ 2 ] );
+    if( NULL == ( output = fopen( path, "w" ) ) ) {
+      fprintf( stderr, "%%TEXTGEN-F-OUTPUT; Can't write to %s.\n", path );
+      textdom_free( & builder );
+      break;
+    }
+    _header( output, prefix, argv[ 1 ] );
+    fclose( output );
+
+    sprintf( path, "%s.c", argv[ 2 ] );
+    if( NULL == ( output = fopen( path, "w" ) ) ) {
+      fprintf( stderr, "%%TEXTGEN-F-OUTPUT; Can't write to %s.\n", path );
+      textdom_free( & builder );
+      break;
+    }
+    _code( output, prefix, argv[ 1 ] );
+    fclose( output );
+
+    textdom_free( & builder );
+    failed = 0;
+  } while( 0 );
+
+  /* The keys point into the arena, so it goes last. */
+
+  while( struct_count > 0 ) {
+    free( structs[ --struct_count ].fields );
+  }
+  textdom_arena_free( & arena );
+  free( data );
+
+  return( failed );
+}
+
+/* _struct()
+**
+** Reads the fields of a map (or the top of the schema) and adds its struct
+** to the list, after any structs nested in it. Returns non-zero after
+** printing an error.
+*/
+
+static int _struct( const tTextDomNode * node, const char * name ) {
+  const tTextDomNode * fields = textdom_find( node, "fields" );
+  tGenField * list;
+  size_t i, j, count;
+
+  if( ! _identifier( name ) ) {
+    fprintf( stderr, "%%TEXTGEN-F-SCHEMA; \"%s\" won't make a struct name.\n", name );
+    return( 1 );
+  }
+
+  for( i = 0; i < struct_count; i++ ) {
+    if( 0 == strcmp( name, structs[ i ].name ) ) {
+      fprintf( stderr, "%%TEXTGEN-F-SCHEMA; There's more than one %s.\n", name );
+      return( 1 );
+    }
+  }
+
+  if( ( NULL == fields ) || ( TEXTDOM_T_ARRAY != fields->type ) || ( 0 == fields->count ) || ( fields->count > _MAX_FIELDS ) ) {
+    fprintf( stderr, "%%TEXTGEN-F-SCHEMA; %s needs an array of between 1 and %d \"fields\".\n", name, _MAX_FIELDS );
+    return( 1 );
+  }
+
+  count = fields->count;
+  if( NULL == ( list = calloc( count, sizeof( tGenField ) ) ) ) {
+    fprintf( stderr, "%%TEXTGEN-F-MEMORY; Out of memory.\n" );
+    return( 1 );
+  }
+
+  for( i = 0; i < count; i++ ) {
+    if( 0 != _field( textdom_index( fields, i ), name, & list[ i ], 0 ) ) {
+      free( list );
+      return( 1 );
+    }
+
+    for( j = 0; j < i; j++ ) {
+      if( ( list[ i ].key_length == list[ j ].key_length ) && ( 0 == memcmp( list[ i ].key, list[ j ].key, list[ i ].key_length ) ) ) {
+        fprintf( stderr, "%%TEXTGEN-F-SCHEMA; %s has the key \"%s\" twice.\n", name, list[ i ].key );
+        free( list );
+        return( 1 );
+      }
+      if( 0 == strcmp( list[ i ].member, list[ j ].member ) ) {
+        fprintf( stderr, "%%TEXTGEN-F-SCHEMA; %s has two members named %s.\n", name, list[ i ].member );
+        free( list );
+        return( 1 );
+      }
+    }
+  }
+
+  if( _MAX_STRUCTS == struct_count ) {
+    fprintf( stderr, "%%TEXTGEN-F-SCHEMA; More than %d structs.\n", _MAX_STRUCTS );
+    free( list );
+    return( 1 );
+  }
+
+  strcpy( structs[ struct_count ].name, name );
+  structs[ struct_count ].fields = list;
+  structs[ struct_count ].count = count;
+  struct_count++;
+
+  return( 0 );
+}
+
+/* _field()
+**
+** Reads one field into field, or just the items of an array field when
+** item is set. Returns non-zero after printing an error.
+*/
+
+static int _field( const tTextDomNode * node, const char * parent, tGenField * field, int item ) {
+  const tTextDomNode * key;
+  const char * type, * text;
+  char nested[ 256 ];
+  long long size = 0;
+  unsigned int i;
+
+  if( ( NULL == node ) || ( TEXTDOM_T_MAP != node->type ) ) {
+    fprintf( stderr, "%%TEXTGEN-F-SCHEMA; The fields of %s (and their items) need to be maps.\n", parent );
+    return( 1 );
+  }
+
+  if( ! item ) {
+    key = textdom_find( node, "key" );
+    if( ( NULL == key ) || ( TEXTDOM_T_STRING != key->type ) || ( key->count >= TEXTBIND_BUFFER ) ) {
+      fprintf( stderr, "%%TEXTGEN-F-SCHEMA; Every field of %s needs a \"key\" shorter than %d octets.\n", parent, TEXTBIND_BUFFER );
+      return( 1 );
+    }
+    field->key = key->value.text;
+    field->key_length = key->count;
+
+    if( NULL != ( text = _text( node, "name" ) ) ) {
+      if( strlen( text ) >= sizeof( field->member ) - 8 ) {
+        text = "";
+      }
+      strcpy( field->member, text );
+    } else if( key->count < sizeof( field->member ) - 8 ) {
+      for( i = 0; i < key->count; i++ ) {
+        field->member[ i ] = ( ( '_' == key->value.text[ i ] ) || ( ( key->value.text[ i ] | 0x20 ) >= 'a' && ( key->value.text[ i ] | 0x20 ) <= 'z' ) ||
+                               ( key->value.text[ i ] >= '0' && key->value.text[ i ] <= '9' && i > 0 ) ) ? key->value.text[ i ] : '_';
+      }
+      field->member[ i ] = '\0';
+    }
+
+    if( ! _identifier( field->member ) ) {
+      fprintf( stderr, "%%TEXTGEN-F-SCHEMA; The key \"%s\" in %s needs a \"name\" that will make a C identifier.\n", field->key, parent );
+      return( 1 );
+    }
+  }
+
+  if( NULL == ( type = _text( node, "type" ) ) ) {
+    type = "";
+  }
+
+  if( NULL != textdom_find( node, "size" ) ) {
+    if( ! textdom_integer( textdom_find( node, "size" ), & size ) || ( size < 1 ) || ( size > 0xFFFFFF ) ) {
+      fprintf( stderr, "%%TEXTGEN-F-SCHEMA; The size of %s.%s needs to be between 1 and %d.\n", parent, field->member, 0xFFFFFF );
+      return( 1 );
+    }
+  }
+
+  if( ( ! item ) && ( 0 == strcmp( "array", type ) ) ) {
+    if( 0 == size ) {
+      fprintf( stderr, "%%TEXTGEN-F-SCHEMA; The array %s.%s needs a size.\n", parent, field->member );
+      return( 1 );
+    }
+    field->items = size;
+    return( _field( textdom_find( node, "items" ), parent, field, 1 ) );
+  }
+
+  for( i = 0; ( NULL != kinds[ i ].name ) && ( 0 != strcmp( kinds[ i ].name, type ) ); i++ );
+
+  if( ( NULL == kinds[ i ].name ) || ( item && ( TEXTBIND_K_OCTETS == kinds[ i ].kind ) ) ) {
+    fprintf( stderr, "%%TEXTGEN-F-SCHEMA; %s.%s%s can't have the type \"%s\".\n", parent, field->member, item ? "'s items" : "", type );
+    return( 1 );
+  }
+
+  field->kind = kinds[ i ].kind;
+
+  switch( field->kind ) {
+  case TEXTBIND_K_OCTETS:
+  case TEXTBIND_K_STRING:
+    if( 0 == size ) {
+      fprintf( stderr, "%%TEXTGEN-F-SCHEMA; %s.%s needs a size.\n", parent, field->member );
+      return( 1 );
+    }
+    field->size = size;
+    break;
+
+  case TEXTBIND_K_MAP:
+    if( NULL == ( text = _text( node, "struct" ) ) ) {
+      snprintf( nested, sizeof( nested ), "%s_%s", parent, field->member );
+      text = nested;
+    }
+    if( strlen( text ) >= sizeof( structs[ 0 ].name ) ) {
+      fprintf( stderr, "%%TEXTGEN-F-SCHEMA; The struct name %s is too long.\n", text );
+      return( 1 );
+    }
+    if( 0 != _struct( node, text ) ) {
+      return( 1 );
+    }
+    field->nested = (int) struct_count - 1;
+    break;
+  }
+
+  return( 0 );
+}
+
+static const char * _text( const tTextDomNode * node, const char * key ) {
+  const tTextDomNode * value = textdom_find( node, key );
+
+  return( ( ( NULL != value ) && ( TEXTDOM_T_STRING == value->type ) ) ? (const char *) value->value.text : NULL );
+}
+
+static int _identifier( const char * name ) {
+  size_t i;
+
+  for( i = 0; '\0' != name[ i ]; i++ ) {
+    if( ! ( ( '_' == name[ i ] ) || ( ( ( name[ i ] | 0x20 ) >= 'a' ) && ( ( name[ i ] | 0x20 ) <= 'z' ) ) ||
+            ( ( i > 0 ) && ( name[ i ] >= '0' ) && ( name[ i ] <= '9' ) ) ) ) {
+      return( 0 );
+    }
+  }
+
+  return( i > 0 );
+}
+
+/* _header()
+**
+** Writes the header: the structs, innermost first, the root struct's table
+** and the parse function.
+*/
+
+static void _header( FILE * output, const char * prefix, const char * schema ) {
+  const tGenStruct * root = & structs[ struct_count - 1 ];
+  char guard[ 256 ];
+  size_t i, j;
+
+  for( i = 0; ( '\0' != prefix[ i ] ) && ( i < sizeof( guard ) - 1 ); i++ ) {
+    guard[ i ] = ( prefix[ i ] >= 'a' && prefix[ i ] <= 'z' ) ? prefix[ i ] - 'a' + 'A' : prefix[ i ];
+  }
+  guard[ i ] = '\0';
+
+  fprintf( output, "/* %s.h\n**\n** This file was written by textgen from %s.\n** Change the schema and run textgen again rather than editing it.\n*/\n\n", prefix, schema );
+  fprintf( output, "/* Macro Definitions */\n\n#ifndef _H_%s\n#define _H_%s\n\n", guard, guard );
+  fprintf( output, "/* File Includes */\n\n#include <stddef.h>\n#include \"textbind.h\"\n\n" );
+  fprintf( output, "/* Structs, Typedefs, Unions & Enums */\n\n" );
+
+  for( i = 0; i < struct_count; i++ ) {
+    fprintf( output, "typedef struct {\n" );
+    for( j = 0; j < structs[ i ].count; j++ ) {
+      _member( output, & structs[ i ].fields[ j ] );
+    }
+    fprintf( output, "} %s;\n\n", structs[ i ].name );
+  }
+
+  fprintf( output, "/* Global Variables */\n\nextern const tTextBindMap %s_map;\n\n", prefix );
+  fprintf( output, "/* Function Prototypes */\n\n" );
+  fprintf( output, "tTextLexErr %s_parse( %s * output, const unsigned char * data, size_t length );\n\n", prefix, root->name );
+  fprintf( output, "#endif /* _H_%s */\n", guard );
+}
+
+static void _member( FILE * output, const tGenField * field ) {
+  const char * type = ( TEXTBIND_K_MAP == field->kind ) ? structs[ field->nested ].name : NULL;
+  unsigned int i;
+
+  for( i = 0; NULL == type; i++ ) {
+    if( kinds[ i ].kind == field->kind ) {
+      type = kinds[ i ].type;
+    }
+  }
+
+  fprintf( output, "  %s %s", type, field->member );
+  if( 0 != field->items ) {
+    fprintf( output, "[ %lld ]", field->items );
+  }
+  if( TEXTBIND_K_OCTETS == field->kind ) {
+    fprintf( output, "[ %lld ];\n  size_t %s_length", field->size, field->member );
+  } else if( TEXTBIND_K_STRING == field->kind ) {
+    fprintf( output, "[ %lld ]", field->size + 1 );
+  }
+  fprintf( output, ";\n" );
+  if( 0 != field->items ) {
+    fprintf( output, "  size_t %s_count;\n", field->member );
+  }
+}
+
+/* _code()
+**
+** Writes the tables and the lookup functions.
+*/
+
+static void _code( FILE * output, const char * prefix, const char * schema ) {
+  const tGenStruct * s;
+  const tGenField * field;
+  size_t keys[ _MAX_FIELDS ];
+  size_t i, j, k, count, length, next;
+
+  fprintf( output, "/* %s.c\n**\n** This file was written by textgen from %s.\n** Change the schema and run textgen again rather than editing it.\n*/\n\n", prefix, schema );
+  fprintf( output, "/* File Includes */\n\n#include <stddef.h>\n#include <string.h>\n#include \"%s.h\"\n\n", prefix );
+
+  fprintf( output, "/* Function Prototypes */\n\n" );
+  for( i = 0; i < struct_count; i++ ) {
+    fprintf( output, "static int _lookup_%s( const unsigned char * key, size_t length );\n", structs[ i ].name );
+  }
+
+  fprintf( output, "\n/* Global Variables */\n" );
+  for( i = 0; i < struct_count; i++ ) {
+    s = & structs[ i ];
+    fprintf( output, "\nstatic const tTextBindField _fields_%s[ %zu ] = {\n", s->name, s->count );
+    for( j = 0; j < s->count; j++ ) {
+      field = & s->fields[ j ];
+      for( k = 0; kinds[ k ].kind != field->kind; k++ );
+      fprintf( output, "  { %s, offsetof( %s, %s ), %lld, ", kinds[ k ].macro, s->name, field->member, field->size );
+      if( 0 != field->items ) {
+        fprintf( output, "offsetof( %s, %s_count ), %lld, ", s->name, field->member, field->items );
+        if( TEXTBIND_K_STRING == field->kind ) {
+          fprintf( output, "%lld, ", field->size + 1 );
+        } else {
+          fprintf( output, "sizeof( %s ), ", ( TEXTBIND_K_MAP == field->kind ) ? structs[ field->nested ].name : kinds[ k ].type );
+        }
+      } else if( TEXTBIND_K_OCTETS == field->kind ) {
+        fprintf( output, "offsetof( %s, %s_length ), 0, 0, ", s->name, field->member );
+      } else {
+        fprintf( output, "0, 0, 0, " );
+      }
+      if( TEXTBIND_K_MAP == field->kind ) {
+        fprintf( output, "& _map_%s },\n", structs[ field->nested ].name );
+      } else {
+        fprintf( output, "NULL },\n" );
+      }
+    }
+    fprintf( output, "};\n\n" );
+
+    if( i == struct_count - 1 ) {
+      fprintf( output, "const tTextBindMap %s_map = { sizeof( %s ), _lookup_%s, _fields_%s };\n", prefix, s->name, s->name, s->name );
+    } else {
+      fprintf( output, "static const tTextBindMap _map_%s = { sizeof( %s ), _lookup_%s, _fields_%s };\n", s->name, s->name, s->name, s->name );
+    }
+  }
+
+  fprintf( output, "\n/* Function Definitions */\n\n" );
+  fprintf( output, "tTextLexErr %s_parse( %s * output, const unsigned char * data, size_t length ) {\n", prefix, structs[ struct_count - 1 ].name );
+  fprintf( output, "  return( textbind_parse( & %s_map, output, data, length ) );\n}\n", prefix );
+
+  /* Each lookup function switches on the length first, shortest keys
+  ** first.
+  */
+
+  for( i = 0; i < struct_count; i++ ) {
+    s = & structs[ i ];
+    fprintf( output, "\nstatic int _lookup_%s( const unsigned char * key, size_t length ) {\n  switch( length ) {\n", s->name );
+
+    for( length = 0; ; length = next ) {
+      next = (size_t) -1;
+      count = 0;
+      for( j = 0; j < s->count; j++ ) {
+        if( s->fields[ j ].key_length == length ) {
+          keys[ count++ ] = j;
+        } else if( ( s->fields[ j ].key_length > length ) && ( s->fields[ j ].key_length < next ) ) {
+          next = s->fields[ j ].key_length;
+        }
+      }
+      if( 0 != count ) {
+        fprintf( output, "  case %zu:\n", length );
+        _trie( output, s, keys, count, 2 );
+      }
+      if( (size_t) -1 == next ) {
+        break;
+      }
+    }
+
+    fprintf( output, "  }\n\n  return( -1 );\n}\n" );
+  }
+}
+
+/* _trie()
+**
+** Writes the code that picks one of count keys, all the same length. If
+** there's more than one, it switches on the octet with the most different
+** values among them and does the same again for each value.
+*/
+
+static void _trie( FILE * output, const tGenStruct * s, size_t * keys, size_t count, unsigned int depth ) {
+  const tGenField * field = & s->fields[ keys[ 0 ] ];
+  size_t length = field->key_length;
+  size_t group[ _MAX_FIELDS ];
+  unsigned char seen[ 256 ];
+  size_t position = 0, best = 0, distinct, i, j, n;
+  unsigned int octet;
+
+  if( 1 == count ) {
+    if( 0 == length ) {
+      fprintf( output, "%*sreturn( %zu );\n", depth * 2, "", keys[ 0 ] );
+    } else {
+      fprintf( output, "%*sreturn( ( 0 == memcmp( key, ", depth * 2, "" );
+      _literal( output, field->key, length );
+      fprintf( output, ", %zu ) ) ? %zu : -1 );\n", length, keys[ 0 ] );
+    }
+    return;
+  }
+
+  for( i = 0; i < length; i++ ) {
+    memset( seen, 0, sizeof( seen ) );
+    for( distinct = 0, j = 0; j < count; j++ ) {
+      octet = s->fields[ keys[ j ] ].key[ i ];
+      distinct += ! seen[ octet ];
+      seen[ octet ] = 1;
+    }
+    if( distinct > best ) {
+      best = distinct;
+      position = i;
+    }
+  }
+
+  fprintf( output, "%*sswitch( key[ %zu ] ) {\n", depth * 2, "", position );
+
+  for( octet = 0; octet < 256; octet++ ) {
+    for( n = 0, j = 0; j < count; j++ ) {
+      if( s->fields[ keys[ j ] ].key[ position ] == octet ) {
+        group[ n++ ] = keys[ j ];
+      }
+    }
+    if( 0 == n ) {
+      continue;
+    }
+    if( ( octet >= ' ' ) && ( octet < 127 ) && ( '\'' != octet ) && ( '\\' != octet ) ) {
+      fprintf( output, "%*scase '%c':\n", depth * 2, "", octet );
+    } else {
+      fprintf( output, "%*scase 0x%02X:\n", depth * 2, "", octet );
+    }
+    _trie( output, s, group, n, depth + 1 );
+  }
+
+  fprintf( output, "%*s}\n%*sbreak;\n", depth * 2, "", depth * 2, "" );
+}
+
+static void _literal( FILE * output, const unsigned char * text, size_t length ) {
+  size_t i;
+
+  fputc( '"', output );
+  for( i = 0; i < length; i++ ) {
+    if( ( text[ i ] < ' ' ) || ( text[ i ] >= 127 ) || ( '?' == text[ i ] ) ) {
+      fprintf( output, "\\%03o", text[ i ] );
+    } else if( ( '"' == text[ i ] ) || ( '\\' == text[ i ] ) ) {
+      fprintf( output, "\\%c", text[ i ] );
+    } else {
+      fputc( text[ i ], output );
+    }
+  }
+  fputc( '"', output );
+}
+
+static unsigned char * load_file( char * path, size_t * length ) {
+  FILE * file;
+  unsigned char * data = NULL;
+  long size;
+
+  if( NULL == ( file = fopen( path, "rb" ) ) ) {
+    return( NULL );
+  }
+
+  do {
+    if( ( 0 != fseek( file, 0, SEEK_END ) ) || ( ( size = ftell( file ) ) <= 0 ) || ( 0 != fseek( file, 0, SEEK_SET ) ) ) {
+      break;
+    }
+
+    if( NULL == ( data = malloc( size ) ) ) {
+      break;
+    }
+
+    if( (size_t) size != fread( data, 1, size, file ) ) {
+      free( data );
+      data = NULL;
+      break;
+    }
+
+    * length = size;
+  } while( 0 );
+
+  fclose( file );
+
+  return( data );
+}
@@ -0,0 +1,679 @@
+/* textio.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file implements the stream ingestion layer described in textio.h.
+**
+** Everything about a stream that more than one thread looks at is guarded by
+** the context's lock. The I/O thread (the one in textio_run()) owns the ring
+** or epoll and is the only thread that starts reads; the workers only ever
+** lex chunks and hand streams back. A stream's chunks are a little ring of
+** their own: the workers take them from head, and the I/O thread reads into
+** the one at head + count, which stays put while a worker moves head along.
+**
+** When a worker frees up a chunk (or a stream fails) it puts the stream on
+** the check list and writes to an eventfd to wake the I/O thread, which
+** starts the next read. A stream is closed once it's hit end of file (or an
+** error), it has no read outstanding and all its chunks have been lexed;
+** then a worker calls textlex_final() and the done callback, after which
+** nothing here touches the stream again.
+**
+** Without liburing, the ring is set up with the raw system calls. Compile
+** with -DTEXTIO_NO_URING to leave it out and always use epoll.
+*/
+
+/* Macro Definitions */
+
+#define _GNU_SOURCE
+
+#define TEXTIO_S_READING    0x01  /* A read is outstanding */
+#define TEXTIO_S_EOF        0x02  /* read() returned zero */
+#define TEXTIO_S_FAILED     0x04  /* A read or the lexxer failed */
+#define TEXTIO_S_SCHEDULED  0x08  /* On the run list or being lexed */
+#define TEXTIO_S_CLOSING    0x10  /* Waiting for textlex_final() and done */
+#define TEXTIO_S_REGISTERED 0x20  /* In the epoll set */
+#define TEXTIO_S_CHECKING   0x40  /* On the check list */
+
+/* File Includes */
+
+#include <errno.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#ifndef TEXTIO_NO_URING
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+#endif
+#include "textio.h"
+
+/* Function Prototypes */
+
+static void * _worker( void * argument );
+static void _check( tTextIoContext * context, tTextIoStream * stream );
+static void _ready( tTextIoContext * context, tTextIoStream * stream, long got );
+static void _wake( tTextIoContext * context );
+static tTextLexErr _run_epoll( tTextIoContext * context );
+#ifndef TEXTIO_NO_URING
+static int _uring_init( tTextIoContext * context );
+static void _uring_free( tTextIoContext * context );
+static int _uring_read( tTextIoContext * context, int fd, void * buffer, unsigned int length, void * tag );
+static int _uring_enter( tTextIoContext * context, unsigned int wait );
+static tTextLexErr _run_uring( tTextIoContext * context );
+#endif
+
+/* Function Definitions */
+
+tTextLexErr textio_init( tTextIoContext * context, unsigned int workers, unsigned int flags ) {
+  struct epoll_event event;
+  unsigned int i;
+  long online;
+
+  memset( context, 0, sizeof( tTextIoContext ) );
+  context->ring = -1;
+  context->poll = -1;
+  context->wake = -1;
+
+  if( 0 == workers ) {
+    online = sysconf( _SC_NPROCESSORS_ONLN );
+    workers = ( online > 0 ) ? (unsigned int) online : 1;
+  }
+
+  if( ( 0 != pthread_mutex_init( & context->lock, NULL ) ) || ( 0 != pthread_cond_init( & context->ready, NULL ) ) ||
+      ( NULL == ( context->threads = malloc( workers * sizeof( pthread_t ) ) ) ) ) {
+    return( TEXTIO_E_SETUP );
+  }
+
+  do {
+#ifndef TEXTIO_NO_URING
+    if( ( 0 == ( flags & TEXTIO_F_EPOLL ) ) && ( 0 == _uring_init( context ) ) ) {
+      if( ( 0 > ( context->wake = eventfd( 0, EFD_CLOEXEC ) ) ) ||
+          ( 0 != _uring_read( context, context->wake, & context->wake_count, sizeof( context->wake_count ), NULL ) ) ) {
+        break;
+      }
+      context->backend = TEXTIO_B_URING;
+    }
+#endif
+
+    if( 0 == context->backend ) {
+      if( ( 0 > ( context->poll = epoll_create1( EPOLL_CLOEXEC ) ) ) ||
+          ( 0 > ( context->wake = eventfd( 0, EFD_CLOEXEC | EFD_NONBLOCK ) ) ) ) {
+        break;
+      }
+      memset( & event, 0, sizeof( event ) );
+      event.events = EPOLLIN;
+      event.data.ptr = NULL;
+      if( 0 != epoll_ctl( context->poll, EPOLL_CTL_ADD, context->wake, & event ) ) {
+        break;
+      }
+      context->backend = TEXTIO_B_EPOLL;
+    }
+
+    for( i = 0; i < workers; i++ ) {
+      if( 0 != pthread_create( & context->threads[ i ], NULL, _worker, context ) ) {
+        break;
+      }
+      context->workers++;
+    }
+
+    if( workers == context->workers ) {
+      return( TEXTLEX_E_NOERR );
+    }
+  } while( 0 );
+
+  textio_free( context );
+
+  return( TEXTIO_E_SETUP );
+}
+
+tTextLexErr textio_add( tTextIoContext * context, tTextIoStream * stream, int fd ) {
+  stream->fd = fd;
+  stream->error = 0;
+  stream->head = 0;
+  stream->count = 0;
+  stream->flags = TEXTIO_S_CHECKING;
+  stream->err = TEXTLEX_E_NOERR;
+  stream->next_run = NULL;
+  stream->next_check = NULL;
+
+  pthread_mutex_lock( & context->lock );
+  context->live++;
+  if( NULL == context->check_head ) {
+    context->check_head = stream;
+  } else {
+    context->check_tail->next_check = stream;
+  }
+  context->check_tail = stream;
+  pthread_mutex_unlock( & context->lock );
+
+  _wake( context );
+
+  return( TEXTLEX_E_NOERR );
+}
+
+tTextLexErr textio_run( tTextIoContext * context ) {
+#ifndef TEXTIO_NO_URING
+  if( TEXTIO_B_URING == context->backend ) {
+    return( _run_uring( context ) );
+  }
+#endif
+  return( _run_epoll( context ) );
+}
+
+void textio_free( tTextIoContext * context ) {
+  unsigned int i;
+
+  pthread_mutex_lock( & context->lock );
+  context->stopping = 1;
+  pthread_cond_broadcast( & context->ready );
+  pthread_mutex_unlock( & context->lock );
+
+  for( i = 0; i < context->workers; i++ ) {
+    pthread_join( context->threads[ i ], NULL );
+  }
+
+#ifndef TEXTIO_NO_URING
+  _uring_free( context );
+#endif
+
+  if( 0 <= context->poll ) {
+    close( context->poll );
+  }
+  if( 0 <= context->wake ) {
+    close( context->wake );
+  }
+
+  free( context->threads );
+  pthread_cond_destroy( & context->ready );
+  pthread_mutex_destroy( & context->lock );
+
+  context->threads = NULL;
+  context->workers = 0;
+  context->poll = -1;
+  context->wake = -1;
+}
+
+/* _worker()
+**
+** Takes streams off the run list and lexes their chunks until there aren't
+** any more, then gives the stream back to the I/O thread (or, if it's
+** closing, finishes it off).
+*/
+
+static void * _worker( void * argument ) {
+  tTextIoContext * context = (tTextIoContext *) argument;
+  tTextIoStream * stream;
+  tTextLexErr err;
+  unsigned int head;
+  int changed;
+
+  pthread_mutex_lock( & context->lock );
+
+  while( 1 ) {
+    while( ( NULL == context->run_head ) && ( ! context->stopping ) ) {
+      pthread_cond_wait( & context->ready, & context->lock );
+    }
+
+    if( NULL == ( stream = context->run_head ) ) {
+      break;
+    }
+
+    if( NULL == ( context->run_head = stream->next_run ) ) {
+      context->run_tail = NULL;
+    }
+
+    changed = 0;
+
+    while( 0 < stream->count ) {
+      head = stream->head;
+
+      if( 0 == ( stream->flags & TEXTIO_S_FAILED ) ) {
+        pthread_mutex_unlock( & context->lock );
+        err = textlex_update( & stream->lexxer, stream->chunks[ head ], stream->lengths[ head ] );
+        pthread_mutex_lock( & context->lock );
+
+        if( TEXTLEX_E_NOERR != err ) {
+          stream->err = err;
+          stream->flags |= TEXTIO_S_FAILED;
+        }
+      }
+
+      stream->head = ( head + 1 ) % TEXTIO_C_CHUNKS;
+      stream->count--;
+      changed = 1;
+    }
+
+    if( stream->flags & TEXTIO_S_CLOSING ) {
+      pthread_mutex_unlock( & context->lock );
+
+      err = stream->err;
+      if( TEXTLEX_E_NOERR == err ) {
+        err = textlex_final( & stream->lexxer );
+      }
+      if( NULL != stream->done ) {
+        stream->done( stream, err );
+      }
+
+      pthread_mutex_lock( & context->lock );
+      if( 0 == --context->live ) {
+        _wake( context );
+      }
+      continue;
+    }
+
+    stream->flags &= ~TEXTIO_S_SCHEDULED;
+
+    if( changed && ( 0 == ( stream->flags & TEXTIO_S_CHECKING ) ) ) {
+      stream->flags |= TEXTIO_S_CHECKING;
+      stream->next_check = NULL;
+      if( NULL == context->check_head ) {
+        context->check_head = stream;
+      } else {
+        context->check_tail->next_check = stream;
+      }
+      context->check_tail = stream;
+      _wake( context );
+    }
+  }
+
+  pthread_mutex_unlock( & context->lock );
+
+  return( NULL );
+}
+
+/* _check()
+**
+** Called by the I/O thread, holding the lock, whenever something's happened
+** to a stream. Starts a read if there's room for one, and hands the stream
+** to a worker if it has chunks to lex or is ready to close.
+*/
+
+static void _check( tTextIoContext * context, tTextIoStream * stream ) {
+  struct epoll_event event;
+  int finished, wanted;
+
+  if( stream->flags & TEXTIO_S_CLOSING ) {
+    return;
+  }
+
+  finished = 0 != ( stream->flags & ( TEXTIO_S_EOF | TEXTIO_S_FAILED ) );
+  wanted = ( ! finished ) && ( TEXTIO_C_CHUNKS > stream->count );
+
+  if( TEXTIO_B_EPOLL == context->backend ) {
+    if( wanted && ( 0 == ( stream->flags & TEXTIO_S_REGISTERED ) ) ) {
+      memset( & event, 0, sizeof( event ) );
+      event.events = EPOLLIN;
+      event.data.ptr = stream;
+      if( 0 == epoll_ctl( context->poll, EPOLL_CTL_ADD, stream->fd, & event ) ) {
+        stream->flags |= TEXTIO_S_REGISTERED;
+      } else {
+        stream->error = errno;
+        stream->err = TEXTIO_E_READ;
+        stream->flags |= TEXTIO_S_FAILED;
+        finished = 1;
+      }
+    } else if( ( ! wanted ) && ( stream->flags & TEXTIO_S_REGISTERED ) ) {
+      epoll_ctl( context->poll, EPOLL_CTL_DEL, stream->fd, NULL );
+      stream->flags &= ~TEXTIO_S_REGISTERED;
+    }
+  }
+#ifndef TEXTIO_NO_URING
+  else if( wanted && ( 0 == ( stream->flags & TEXTIO_S_READING ) ) ) {
+    unsigned int tail = ( stream->head + stream->count ) % TEXTIO_C_CHUNKS;
+
+    switch( _uring_read( context, stream->fd, stream->chunks[ tail ], TEXTIO_CHUNK_SIZE, stream ) ) {
+    case 0:
+      stream->flags |= TEXTIO_S_READING;
+      break;
+
+    case 1:
+      /* No room in the ring; try again on the I/O thread's next time round. */
+
+      if( 0 == ( stream->flags & TEXTIO_S_CHECKING ) ) {
+        stream->flags |= TEXTIO_S_CHECKING;
+        stream->next_check = NULL;
+        if( NULL == context->check_head ) {
+          context->check_head = stream;
+        } else {
+          context->check_tail->next_check = stream;
+        }
+        context->check_tail = stream;
+      }
+      break;
+
+    default:
+      stream->error = errno;
+      stream->err = TEXTIO_E_READ;
+      stream->flags |= TEXTIO_S_FAILED;
+      finished = 1;
+      break;
+    }
+  }
+#endif
+
+  /* A stream that's on the check list gets looked at again soon; closing it
+  ** now could let a worker hand it back before the check list is done with
+  ** it.
+  */
+
+  if( finished && ( 0 == stream->count ) &&
+      ( 0 == ( stream->flags & ( TEXTIO_S_READING | TEXTIO_S_REGISTERED | TEXTIO_S_CHECKING ) ) ) ) {
+    stream->flags |= TEXTIO_S_CLOSING;
+  }
+
+  if( ( ( 0 < stream->count ) || ( stream->flags & TEXTIO_S_CLOSING ) ) && ( 0 == ( stream->flags & TEXTIO_S_SCHEDULED ) ) ) {
+    stream->flags |= TEXTIO_S_SCHEDULED;
+    stream->next_run = NULL;
+    if( NULL == context->run_head ) {
+      context->run_head = stream;
+    } else {
+      context->run_tail->next_run = stream;
+    }
+    context->run_tail = stream;
+    pthread_cond_signal( & context->ready );
+  }
+}
+
+/* _ready()
+**
+** Called by the I/O thread, holding the lock, when a read finishes. got is
+** what read() returned, or minus the errno.
+*/
+
+static void _ready( tTextIoContext * context, tTextIoStream * stream, long got ) {
+  stream->flags &= ~TEXTIO_S_READING;
+
+  if( 0 < got ) {
+    if( 0 == ( stream->flags & TEXTIO_S_FAILED ) ) {
+      stream->lengths[ ( stream->head + stream->count ) % TEXTIO_C_CHUNKS ] = (tTextLexCount) got;
+      stream->count++;
+    }
+  } else if( 0 == got ) {
+    stream->flags |= TEXTIO_S_EOF;
+  } else if( ( -EINTR != got ) && ( -EAGAIN != got ) ) {
+    stream->error = (int) -got;
+    stream->err = TEXTIO_E_READ;
+    stream->flags |= TEXTIO_S_FAILED;
+  }
+
+  _check( context, stream );
+}
+
+static void _wake( tTextIoContext * context ) {
+  uint64_t one = 1;
+  ssize_t written;
+
+  written = write( context->wake, & one, sizeof( one ) );
+  (void) written;
+}
+
+/* _run_epoll()
+**
+** The epoll backend's I/O loop. Descriptors are level triggered and only in
+** the set while their stream has a free chunk; each event gets one read().
+*/
+
+static tTextLexErr _run_epoll( tTextIoContext * context ) {
+  struct epoll_event events[ TEXTIO_C_EVENTS ];
+  tTextIoStream * stream;
+  unsigned int tail;
+  int count, i;
+  ssize_t got;
+
+  pthread_mutex_lock( & context->lock );
+
+  while( 0 < context->live ) {
+    while( NULL != ( stream = context->check_head ) ) {
+      context->check_head = stream->next_check;
+      stream->flags &= ~TEXTIO_S_CHECKING;
+      _check( context, stream );
+    }
+    context->check_tail = NULL;
+
+    pthread_mutex_unlock( & context->lock );
+    count = epoll_wait( context->poll, events, TEXTIO_C_EVENTS, -1 );
+    pthread_mutex_lock( & context->lock );
+
+    if( 0 > count ) {
+      if( EINTR == errno ) {
+        continue;
+      }
+      pthread_mutex_unlock( & context->lock );
+      return( TEXTIO_E_SETUP );
+    }
+
+    for( i = 0; i < count; i++ ) {
+      if( NULL == ( stream = (tTextIoStream *) events[ i ].data.ptr ) ) {
+        got = read( context->wake, & context->wake_count, sizeof( context->wake_count ) );
+        continue;
+      }
+
+      if( ( 0 == ( stream->flags & TEXTIO_S_REGISTERED ) ) || ( TEXTIO_C_CHUNKS == stream->count ) ) {
+        continue;
+      }
+
+      tail = ( stream->head + stream->count ) % TEXTIO_C_CHUNKS;
+      stream->flags |= TEXTIO_S_READING;
+
+      pthread_mutex_unlock( & context->lock );
+      got = read( stream->fd, stream->chunks[ tail ], TEXTIO_CHUNK_SIZE );
+      if( 0 > got ) {
+        got = -errno;
+      }
+      pthread_mutex_lock( & context->lock );
+
+      _ready( context, stream, (long) got );
+    }
+  }
+
+  pthread_mutex_unlock( & context->lock );
+
+  return( TEXTLEX_E_NOERR );
+}
+
+#ifndef TEXTIO_NO_URING
+
+/* _uring_init()
+**
+** Sets up the ring and maps its queues. Returns -1 if the kernel doesn't
+** have io_uring or won't let us use it.
+*/
+
+static int _uring_init( tTextIoContext * context ) {
+  struct io_uring_params params;
+  long ring;
+
+  memset( & params, 0, sizeof( params ) );
+  params.flags = IORING_SETUP_CQSIZE;
+  params.cq_entries = TEXTIO_CQ_SIZE;
+
+  if( 0 > ( ring = syscall( __NR_io_uring_setup, TEXTIO_SQ_SIZE, & params ) ) ) {
+    return( -1 );
+  }
+
+  context->ring = (int) ring;
+  context->sq_ring_size = params.sq_off.array + params.sq_entries * sizeof( unsigned int );
+  context->cq_ring_size = params.cq_off.cqes + params.cq_entries * sizeof( struct io_uring_cqe );
+  context->sqes_size = params.sq_entries * sizeof( struct io_uring_sqe );
+
+  if( params.features & IORING_FEAT_SINGLE_MMAP ) {
+    if( context->cq_ring_size > context->sq_ring_size ) {
+      context->sq_ring_size = context->cq_ring_size;
+    }
+    context->cq_ring_size = 0;
+  }
+
+  context->sq_ring = mmap( NULL, context->sq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, context->ring, IORING_OFF_SQ_RING );
+  context->cq_ring = ( 0 == context->cq_ring_size ) ? context->sq_ring :
+    mmap( NULL, context->cq_ring_size, PROT_READ | PROT_WRITE, MAP_SHARED, context->ring, IORING_OFF_CQ_RING );
+  context->sqes = mmap( NULL, context->sqes_size, PROT_READ | PROT_WRITE, MAP_SHARED, context->ring, IORING_OFF_SQES );
+
+  if( ( MAP_FAILED == context->sq_ring ) || ( MAP_FAILED == context->cq_ring ) || ( MAP_FAILED == context->sqes ) ) {
+    _uring_free( context );
+    return( -1 );
+  }
+
+  context->sq_head = (unsigned int *) ( (char *) context->sq_ring + params.sq_off.head );
+  context->sq_tail = (unsigned int *) ( (char *) context->sq_ring + params.sq_off.tail );
+  context->sq_array = (unsigned int *) ( (char *) context->sq_ring + params.sq_off.array );
+  context->sq_mask = * (unsigned int *) ( (char *) context->sq_ring + params.sq_off.ring_mask );
+  context->sq_entries = params.sq_entries;
+  context->cq_head = (unsigned int *) ( (char *) context->cq_ring + params.cq_off.head );
+  context->cq_tail = (unsigned int *) ( (char *) context->cq_ring + params.cq_off.tail );
+  context->cq_mask = * (unsigned int *) ( (char *) context->cq_ring + params.cq_off.ring_mask );
+  context->cqes = (char *) context->cq_ring + params.cq_off.cqes;
+
+  return( 0 );
+}
+
+static void _uring_free( tTextIoContext * context ) {
+  if( ( NULL != context->sqes ) && ( MAP_FAILED != context->sqes ) ) {
+    munmap( context->sqes, context->sqes_size );
+  }
+  if( ( 0 != context->cq_ring_size ) && ( NULL != context->cq_ring ) && ( MAP_FAILED != context->cq_ring ) ) {
+    munmap( context->cq_ring, context->cq_ring_size );
+  }
+  if( ( NULL != context->sq_ring ) && ( MAP_FAILED != context->sq_ring ) ) {
+    munmap( context->sq_ring, context->sq_ring_size );
+  }
+  if( 0 <= context->ring ) {
+    close( context->ring );
+  }
+
+  context->sqes = NULL;
+  context->cq_ring = NULL;
+  context->sq_ring = NULL;
+  context->ring = -1;
+}
+
+/* _uring_read()
+**
+** Queues a read; it's submitted the next time the I/O thread enters the
+** ring. tag comes back with the completion (NULL is the eventfd). If the
+** submission queue is full, the reads in it are submitted first. Returns 1
+** if the kernel won't take them yet (because too many completions are
+** waiting to be reaped), in which case the read has to be tried again
+** after the I/O thread has reaped some, and -1 if the ring is broken.
+*/
+
+static int _uring_read( tTextIoContext * context, int fd, void * buffer, unsigned int length, void * tag ) {
+  struct io_uring_sqe * sqe;
+  unsigned int tail, index;
+
+  tail = * context->sq_tail;
+  if( context->sq_entries == tail - __atomic_load_n( context->sq_head, __ATOMIC_ACQUIRE ) ) {
+    if( 0 != _uring_enter( context, 0 ) ) {
+      return( -1 );
+    }
+    if( context->sq_entries == tail - __atomic_load_n( context->sq_head, __ATOMIC_ACQUIRE ) ) {
+      return( 1 );
+    }
+  }
+
+  index = tail & context->sq_mask;
+  sqe = (struct io_uring_sqe *) context->sqes + index;
+  memset( sqe, 0, sizeof( struct io_uring_sqe ) );
+  sqe->opcode = IORING_OP_READ;
+  sqe->fd = fd;
+  sqe->addr = (uint64_t) (uintptr_t) buffer;
+  sqe->len = length;
+  sqe->off = (uint64_t) -1;
+  sqe->user_data = (uint64_t) (uintptr_t) tag;
+
+  context->sq_array[ index ] = index;
+  __atomic_store_n( context->sq_tail, tail + 1, __ATOMIC_RELEASE );
+  context->pending++;
+
+  return( 0 );
+}
+
+/* _uring_enter()
+**
+** Submits queued reads and, if wait is set, waits for one to finish. If
+** the kernel is busy, nothing is submitted and it's up to the caller to
+** reap completions and try again.
+*/
+
+static int _uring_enter( tTextIoContext * context, unsigned int wait ) {
+  long submitted;
+
+  submitted = syscall( __NR_io_uring_enter, context->ring, context->pending, wait, wait ? IORING_ENTER_GETEVENTS : 0, NULL, 0 );
+
+  if( 0 > submitted ) {
+    return( ( ( EINTR == errno ) || ( EAGAIN == errno ) || ( EBUSY == errno ) ) ? 0 : -1 );
+  }
+
+  context->pending -= (unsigned int) submitted;
+
+  return( 0 );
+}
+
+/* _run_uring()
+**
+** The io_uring backend's I/O loop. Every stream with a free chunk has a
+** read in the ring, and so does the eventfd. Reads that didn't fit in the
+** ring go back on the check list (or, for the eventfd, set rearm), and the
+** loop doesn't wait for a completion until they're all in.
+*/
+
+static tTextLexErr _run_uring( tTextIoContext * context ) {
+  struct io_uring_cqe * cqe;
+  tTextIoStream * stream, * next;
+  unsigned int head, tail, wait;
+  int rearm = 0;
+
+  pthread_mutex_lock( & context->lock );
+
+  while( 0 < context->live ) {
+    if( rearm ) {
+      rearm = ( 0 != _uring_read( context, context->wake, & context->wake_count, sizeof( context->wake_count ), NULL ) );
+    }
+
+    /* Take the whole list, so streams _check() puts back wait for the next
+    ** time round.
+    */
+
+    stream = context->check_head;
+    context->check_head = NULL;
+    context->check_tail = NULL;
+
+    for( ; NULL != stream; stream = next ) {
+      next = stream->next_check;
+      stream->flags &= ~TEXTIO_S_CHECKING;
+      _check( context, stream );
+    }
+
+    wait = ( ! rearm ) && ( NULL == context->check_head );
+
+    pthread_mutex_unlock( & context->lock );
+    if( 0 != _uring_enter( context, wait ) ) {
+      return( TEXTIO_E_SETUP );
+    }
+    pthread_mutex_lock( & context->lock );
+
+    head = * context->cq_head;
+    tail = __atomic_load_n( context->cq_tail, __ATOMIC_ACQUIRE );
+
+    for( ; head != tail; head++ ) {
+      cqe = (struct io_uring_cqe *) context->cqes + ( head & context->cq_mask );
+
+      if( 0 == cqe->user_data ) {
+        rearm = ( 0 != _uring_read( context, context->wake, & context->wake_count, sizeof( context->wake_count ), NULL ) );
+      } else {
+        _ready( context, (tTextIoStream *) (uintptr_t) cqe->user_data, (long) cqe->res );
+      }
+    }
+
+    __atomic_store_n( context->cq_head, head, __ATOMIC_RELEASE );
+  }
+
+  pthread_mutex_unlock( & context->lock );
+
+  return( TEXTLEX_E_NOERR );
+}
+
+#endif
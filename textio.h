@@ -0,0 +1,192 @@
+/* textio.h
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file provides the interface to the stream ingestion layer implemented
+** in textio.c. It reads DSD/Text from many file descriptors at once (sockets,
+** pipes, anything you can read()) and lexes each one with its own lexxer
+** context, so you don't need a thread blocked in read() for every
+** connection.
+**
+** One thread, the one that calls textio_run(), does all the reading: with
+** io_uring if the kernel has it and with epoll if it doesn't. Each chunk it
+** reads is handed to a fixed pool of worker threads that call
+** textlex_update() on it. A stream is only ever being lexed by one worker at
+** a time and its chunks are lexed in the order they were read, so the
+** callbacks for each stream see its tokens in order, just like they would
+** with blocking reads; callbacks for different streams run at the same time
+** on different workers.
+**
+** This is Linux only.
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_TEXTIO
+#define _H_TEXTIO
+
+/* Macro Definitions : Error Codes
+**
+** These pick up where the struct binder's error codes leave off.
+*/
+
+#define TEXTIO_E_READ           104 /* read() failed; see the stream's error */
+#define TEXTIO_E_SETUP          105 /* Couldn't make the ring, epoll or threads */
+
+/* Macro Definitions : Flags for textio_init() */
+
+#define TEXTIO_F_EPOLL          1   /* Use epoll even if io_uring works */
+
+/* Macro Definitions : Backends */
+
+#define TEXTIO_B_URING          1
+#define TEXTIO_B_EPOLL          2
+
+/* Each stream has TEXTIO_C_CHUNKS buffers of TEXTIO_CHUNK_SIZE octets. While
+** one is being lexed the next can be read into; once they're all full, the
+** stream isn't read again until a worker is done with one.
+*/
+
+#ifndef TEXTIO_CHUNK_SIZE
+#define TEXTIO_CHUNK_SIZE       4096
+#endif
+
+#define TEXTIO_C_CHUNKS         2
+
+/* Size of the io_uring submission and completion queues. Each stream has
+** at most one read outstanding and so does the eventfd, so with fewer than
+** TEXTIO_CQ_SIZE streams every completion fits (10,000 streams use a
+** sixth of it.) With more, the kernel holds on to the extras and refuses
+** new reads until the I/O thread has reaped enough of them. A read that
+** doesn't fit in the submission queue waits on the check list until the
+** I/O thread has submitted the ones ahead of it.
+*/
+
+#ifndef TEXTIO_SQ_SIZE
+#define TEXTIO_SQ_SIZE          4096
+#endif
+
+#ifndef TEXTIO_CQ_SIZE
+#define TEXTIO_CQ_SIZE          65536
+#endif
+
+/* The epoll backend asks for this many events at a time. */
+
+#define TEXTIO_C_EVENTS         256
+
+/* File Includes */
+
+#include <pthread.h>
+#include "textlex.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+/* tTextIoStream
+**
+** One of these for each file descriptor. Set up lexxer with textlex_init()
+** and set its callbacks and done, then pass it to textio_add(). lexxer is
+** the first member, so a callback can cast the tTextLexContext pointer it's
+** given back to the stream (and to whatever struct you embedded the stream
+** at the start of) to find its own state.
+**
+** done is called on a worker thread when the stream's finished: after
+** end of file and textlex_final(), or after an error. err is the error
+** (TEXTLEX_E_NOERR if there wasn't one); for TEXTIO_E_READ, error is the
+** errno. Once done has been called, the stream is yours again; you can
+** close the file descriptor and free the stream.
+*/
+
+typedef struct _text_io_stream {
+  tTextLexContext           lexxer;
+  void                      (*done)( struct _text_io_stream * stream, tTextLexErr err );
+  void *                    user;
+  int                       error;
+
+  /* The rest belongs to textio.c. */
+
+  int                       fd;
+  tTextLexBuffer            chunks[ TEXTIO_C_CHUNKS ][ TEXTIO_CHUNK_SIZE ];
+  tTextLexCount             lengths[ TEXTIO_C_CHUNKS ];
+  unsigned int              head;
+  unsigned int              count;
+  unsigned int              flags;
+  tTextLexErr               err;
+  struct _text_io_stream *  next_run;
+  struct _text_io_stream *  next_check;
+} tTextIoStream;
+
+typedef struct {
+  unsigned int              backend;
+  unsigned int              workers;
+  unsigned long             live;
+  int                       stopping;
+  int                       wake;
+  int                       poll;
+  unsigned long long        wake_count;
+
+  pthread_mutex_t           lock;
+  pthread_cond_t            ready;
+  pthread_t *               threads;
+
+  tTextIoStream *           run_head;
+  tTextIoStream *           run_tail;
+  tTextIoStream *           check_head;
+  tTextIoStream *           check_tail;
+
+  /* io_uring */
+
+  int                       ring;
+  void *                    sq_ring;
+  void *                    cq_ring;
+  void *                    sqes;
+  size_t                    sq_ring_size;
+  size_t                    cq_ring_size;
+  size_t                    sqes_size;
+  unsigned int *            sq_head;
+  unsigned int *            sq_tail;
+  unsigned int *            sq_array;
+  unsigned int              sq_mask;
+  unsigned int              sq_entries;
+  unsigned int *            cq_head;
+  unsigned int *            cq_tail;
+  unsigned int              cq_mask;
+  void *                    cqes;
+  unsigned int              pending;
+} tTextIoContext;
+
+/* Function Prototypes */
+
+/* textio_init()
+**
+** Sets up the ring (or epoll) and starts workers worker threads; zero means
+** one per online CPU. Returns TEXTIO_E_SETUP if it can't.
+*/
+
+tTextLexErr textio_init( tTextIoContext * context, unsigned int workers, unsigned int flags );
+
+/* textio_add()
+**
+** Starts reading fd into stream. This can be called before textio_run() or
+** while it's running, from any thread, including from callbacks.
+*/
+
+tTextLexErr textio_add( tTextIoContext * context, tTextIoStream * stream, int fd );
+
+/* textio_run()
+**
+** Reads and lexes until every stream that's been added is done, then
+** returns. Call it from one thread at a time.
+*/
+
+tTextLexErr textio_run( tTextIoContext * context );
+
+/* textio_free()
+**
+** Stops the workers and closes the ring (or epoll). Don't call it while
+** textio_run() is running.
+*/
+
+void textio_free( tTextIoContext * context );
+
+#endif /* _H_TEXTIO */
@@ -10,8 +10,277 @@
 /* Macro Definitions */
 
 #define SET_STATE( x ) context->state = x
-#define COPY_TO_BUFFER context->buffer[ context->index++ ] = current; if( context->index >= context->size ) { err = context->overflow( context ); }
-#define TOKEN( x ) if( NULL != context->token ) { err = context->token( context, x ); } context->index = 0
+
+/* Extensions. The optional modes keep their callbacks and state in the
+** context's extension, which each function that needs it keeps in a local
+** named extension. EXTENSION is the context's, or _plain if it hasn't got
+** one, so the callbacks can be checked without checking for NULL first.
+** OFFSET adds the octets the last update read to the extension's count
+** (and the context's, with lazy lines.)
+*/
+
+#define EXTENSION ( ( NULL != context->extension ) ? context->extension : & _plain )
+#define OFFSET if( NULL != context->extension ) { context->extension->offset += context->bytes_read; } LINES_OFFSET; context->bytes_read = 0
+
+/* Hooks. Copying an octet into the buffer could write anywhere as far as
+** the compiler knows, so a check on the extension inside the loop loads
+** it again for every octet. textlex_update() works out which of the modes
+** that are checked on every octet are on before the loop starts and keeps
+** the answer (and a copy of the token mask) in locals instead.
+*/
+
+#define HOOK_MARK   1 /* Lexemes are marked, not copied (ZERO_COPY) */
+#define HOOK_NUMBER 2 /* Digits are added up for the number callback */
+#define HOOK_RECORD 4 /* Documents are framed for the record callback */
+
+#define HOOKS ( ( ZERO_COPY ? HOOK_MARK : 0 ) | ( ( NULL != extension->number ) ? HOOK_NUMBER : 0 ) | \
+    ( ( NULL != extension->record ) ? HOOK_RECORD : 0 ) )
+
+#define BUFFER_COPY context->buffer[ context->index++ ] = current; if( context->index >= context->size ) { OVERFLOW; }
+#define EMIT( x ) if( NULL != extension->batch ) { BATCH( x, context->buffer, context->index ); } else if( NULL != extension->span ) { TIMED( err = extension->span( context, x, context->buffer, context->index ) ); } else if( NULL != context->token ) { TIMED( err = context->token( context, x ) ); }
+#define SPAN( x ) if( NULL != extension->batch ) { BATCH( x, mark, context->index ); } else { TIMED( err = extension->span( context, x, mark, context->index ) ); }
+#define ZERO_COPY ( ( NULL != extension->span ) || ( NULL != extension->batch ) )
+
+/* Batch mode. When the batch callback is set, tokens are written to the
+** extension's token array instead of being sent one at a time, and the whole
+** array goes to the batch callback when it fills up or textlex_update()
+** returns. A lexeme sitting in the buffer is sent along with everything
+** before it straight away, since the buffer is about to be reused.
+*/
+
+#define BATCH( x, d, n ) do { \
+    tTextLexToken * record = & extension->tokens[ extension->count++ ]; \
+    POSITION; \
+    record->token = ( x ); \
+    record->length = ( n ); \
+    record->line = context->line; \
+    record->octet = context->octet; \
+    record->data = ( d ); \
+    if( ( extension->count >= extension->capacity ) || ( ( 0 != ( n ) ) && ( context->buffer == ( d ) ) ) ) { \
+      err = _flush( context ); \
+    } \
+  } while( 0 )
+
+/* When the span (or batch) callback is set, the lexxer doesn't copy a
+** lexeme into the buffer as long as it's a contiguous run of octets in the
+** input passed to textlex_update(). Instead it just remembers where the run
+** started (in mark) and counts its length in index. If the run is broken
+** (by a string escape or white space in a base16 string) or the input ends
+** before the lexeme does, whatever's been marked so far is spilled into the
+** buffer and the lexxer carries on copying like it normally does.
+*/
+
+#define COPY_TO_BUFFER if( 0 == ( hooks & HOOK_MARK ) ) { \
+    BUFFER_COPY; \
+  } else if( NULL != mark ) { \
+    if( & data[ i ] == mark + context->index ) { \
+      context->index++; \
+    } else { \
+      err = _spill( context, mark ); \
+      mark = NULL; \
+      BUFFER_COPY; \
+    } \
+  } else if( 0 == context->index ) { \
+    mark = & data[ i ]; \
+    context->index = 1; \
+  } else { \
+    BUFFER_COPY; \
+  }
+
+/* A value token is followed by an END token (and sometimes a close), so
+** TOKEN() does nothing once a callback has returned an error; otherwise the
+** next token would overwrite it. TEXTLEX_E_YIELD isn't an error: the rest
+** of the tokens for the octet still go out, and textlex_update() stops
+** after it (see textlex_next().)
+*/
+
+#define TOKEN( x ) if( ( TEXTLEX_E_NOERR == err ) || ( TEXTLEX_E_YIELD == err ) ) { STAT_TOKEN( x ); if( NUMERIC( x ) ) { err = _number( context, x, mark ); } else if( DECODED( x ) ) { err = _decode( context, x, mark, 0 ); } else if( NULL != mark ) { SPAN( x ); } else { EMIT( x ); } RECORD( x ); } mark = NULL; context->index = 0
+
+/* Token mask. Comments and annotations whose bits are clear in
+** extension->wanted are never copied into the buffer (the rest of a comment
+** is skipped with the bulk scanner), and LEXEME() sends neither them nor
+** the TEXTLEX_T_END after them. The token is a constant everywhere but in
+** the DFA engine, so SKIPPED() folds away for all the other tokens.
+*/
+
+#define WANTED( x ) ( 0 != ( wanted & TEXTLEX_M( x ) ) )
+#define SKIPPED( x ) ( ( ( TEXTLEX_T_COMMENT == ( x ) ) || ( TEXTLEX_T_ANNOTATION == ( x ) ) ) && ! WANTED( x ) )
+#define LEXEME( x ) if( ! SKIPPED( x ) ) { TOKEN( x ); TOKEN( TEXTLEX_T_END ); }
+
+/* Statistics. When the lexxer is compiled with -DTEXTLEX_STATS, STAT()
+** counts things in context->stats, TIMED() charges the time a callback
+** takes to callback_ticks and OVERFLOW charges the overflow callback's
+** time (less any callbacks it makes) to overflow_ticks. carried is how
+** much of the lexeme has already gone to the overflow callback, so
+** STAT_TOKEN() can work out the length of the whole thing. Without
+** -DTEXTLEX_STATS, they're just the calls.
+*/
+
+#ifdef TEXTLEX_STATS
+#define STAT( x ) x
+#define STAT_TOKEN( x ) context->stats.tokens[ x ]++; \
+  if( context->stats.carried + context->index > context->stats.longest ) { context->stats.longest = context->stats.carried + context->index; } \
+  context->stats.carried = 0
+#define TIMED( x ) { unsigned long long tick = TEXTSTAT_TICKS(); x; context->stats.callback_ticks += TEXTSTAT_TICKS() - tick; }
+#define OVERFLOW { \
+    unsigned long long tick = TEXTSTAT_TICKS(), inner = context->stats.callback_ticks; \
+    unsigned long long carried = context->stats.carried + context->index; \
+    context->stats.overflows++; \
+    err = context->overflow( context ); \
+    context->stats.carried = carried - context->index; \
+    context->stats.overflow_ticks += TEXTSTAT_TICKS() - tick - ( context->stats.callback_ticks - inner ); \
+  }
+#else
+#define STAT( x )
+#define STAT_TOKEN( x )
+#define TIMED( x ) x
+#define OVERFLOW err = context->overflow( context )
+#endif
+
+/* Lazy lines. Normally LINE_FEED and OCTETS() keep line and octet up to
+** date as each octet is read. With -DTEXTLEX_LAZY_LINES they're nothing;
+** LINES_BEGIN remembers where the data and the count started and
+** LINES_END brings the count up to the end of the data (or to the octet
+** with the error in it) once the loop is done with it. Callbacks in
+** between call textlex_position() to bring it up to the octet being read.
+** The recount only ever covers the data passed to this update, so counted
+** fits in a tTextLexCount; LINES_OFFSET keeps the 64 bit total of the
+** octets read before it in the context's offset.
+*/
+
+#ifndef TEXTLEX_LAZY_LINES
+#define LINE_FEED if( '\n' == current ) { context->line++; context->octet = 0; }
+#define OCTETS( n ) context->octet += ( n )
+#define POSITION
+#define LINES_OFFSET
+#define LINES_BEGIN
+#define LINES_END
+#else
+#define LINE_FEED
+#define OCTETS( n )
+#define POSITION textlex_position( context )
+#define LINES_OFFSET context->offset += context->bytes_read
+#define LINES_BEGIN context->lines = data; \
+  context->counted = 0; \
+  context->counted_line = context->line; \
+  context->counted_octet = context->octet
+#define LINES_END if( ( TEXTLEX_E_NOERR == err ) || ( TEXTLEX_E_YIELD == err ) ) { \
+    _count( context, context->bytes_read ); \
+    context->line = context->counted_line; \
+    context->octet = context->counted_octet; \
+  } else { \
+    textlex_position( context ); \
+  } \
+  context->lines = NULL
+#endif
+
+/* Typed number mode. When the number callback is set, the digits of a
+** number are added up in extension->digits as they're copied, and TOKEN()
+** sends integers, floats and hex numbers to _number() to be converted. The
+** token is a constant nearly everywhere TOKEN() is used, so NUMERIC()
+** usually folds away to nothing. A TEXTLEX_T_HEX token is only a number if
+** it came from the TEXTLEX_S_HEX state; base16 strings are hex tokens too.
+*/
+
+#define NUMERIC( x ) ( ( NULL != extension->number ) && ( ( TEXTLEX_T_INTEGER == ( x ) ) || ( TEXTLEX_T_FLOAT == ( x ) ) || \
+    ( ( TEXTLEX_T_HEX == ( x ) ) && ( TEXTLEX_S_HEX == context->state ) ) ) )
+#define INTEGER_DIGIT if( 0 != ( hooks & HOOK_NUMBER ) ) { TEXTNUM_DIGIT( & extension->digits, current, 0 ); }
+#define FRACTION_DIGIT if( 0 != ( hooks & HOOK_NUMBER ) ) { TEXTNUM_DIGIT( & extension->digits, current, 1 ); }
+#define EXPONENT_DIGIT if( 0 != ( hooks & HOOK_NUMBER ) ) { TEXTNUM_EXPONENT( & extension->digits, current ); }
+#define HEX_DIGIT if( 0 != ( hooks & HOOK_NUMBER ) ) { TEXTNUM_NIBBLE( & extension->digits, current ); }
+#define SIGN( f ) if( 0 != ( hooks & HOOK_NUMBER ) ) { extension->digits.flags |= f; }
+
+/* Decoded binary mode. When the decoded callback is set, TOKEN() sends
+** base64 strings and base16 strings to _decode(). A base16 string that
+** stops for a comment is marked with DECODE_BREAK first so an odd digit
+** before the comment is saved (in the low four bits of extension->decoding)
+** for the next piece instead of being an error.
+*/
+
+#define DECODED( x ) ( ( NULL != extension->decoded ) && ( ( TEXTLEX_T_BASE64 == ( x ) ) || \
+    ( ( TEXTLEX_T_HEX == ( x ) ) && ( TEXTLEX_S_BASE16_START == context->state ) ) ) )
+#define DECODE_BREAK_HERE if( NULL != extension->decoded ) { extension->decoding |= DECODE_BREAK; } \
+  if( ( NULL != extension->record ) && ( 0 == extension->depth ) ) { extension->framing |= RECORD_BREAK; }
+
+#define DECODE_NIBBLE 0x10 /* A hex digit is waiting in the low four bits */
+#define DECODE_BREAK  0x20 /* The base16 string is stopping for a comment */
+#define DECODE_PADDED 0x40 /* The base64 string got to its '=' */
+
+#define NIBBLE( c ) ( ( ( c ) <= '9' ) ? ( ( c ) - '0' ) : ( ( ( c ) | 0x20 ) - 'a' + 10 ) )
+#define SEXTET( c ) ( ( ( c ) >= 'a' ) ? ( ( c ) - 71 ) : ( ( c ) >= 'A' ) ? ( ( c ) - 65 ) : \
+    ( ( c ) >= '0' ) ? ( ( c ) + 4 ) : ( '+' == ( c ) ) ? 62 : 63 )
+
+/* Record mode. When the record callback is set, the opens and closes
+** TOKEN() sends, and every other token at the top level, also go to
+** _record(), which keeps track of how deep in arrays and maps the lexxer
+** is and calls the record callback when a top level value ends. Inside a
+** value, the other tokens don't matter, so they don't cost a call.
+** A document starts at the first octet the START state sees that isn't
+** white space or a comment (RECORD_BEGIN), or right where the last one
+** ended if the octet that ended it starts the next one too. The base16
+** string that stops for a comment is marked with RECORD_BREAK by
+** DECODE_BREAK_HERE so its TEXTLEX_T_END doesn't end the document.
+*/
+
+#define RECORD( x ) if( ( NULL != extension->record ) && ( ( 0 == extension->depth ) || ( ( ( x ) >= TEXTLEX_T_ARRAY_OPEN ) && ( ( x ) <= TEXTLEX_T_MAP_CLOSE ) ) ) && \
+    ( ( TEXTLEX_E_NOERR == err ) || ( TEXTLEX_E_YIELD == err ) ) ) { err = _record( context, x, err ); }
+#define RECORD_BEGIN if( 0 == ( extension->framing & RECORD_OPEN ) ) { extension->record_start = extension->offset + context->bytes_read - 1; extension->framing |= RECORD_OPEN; }
+
+#define RECORD_OPEN  1 /* A document has started */
+#define RECORD_BREAK 2 /* The base16 string is stopping for a comment */
+
+#ifndef TEXTLEX_NO_SCAN
+#define DECODE( t, d, n, o ) ( ( TEXTLEX_T_HEX == ( t ) ) ? textscan_hex( d, n, o ) : textscan_base64( d, n, o ) )
+#else
+#define DECODE( t, d, n, o ) _scalar_decode( t, d, n, o )
+#endif
+
+/* SKIP_RUN and COPY_RUN are the fast path for long runs of octets that don't
+** change the lexxer's state: white space, comments and the bodies of strings.
+** The argument is the length of the run following the current octet (found
+** with the bulk scanner in textscan.c.) They advance i to the last octet of
+** the run, keeping octet and bytes_read exactly where the octet-at-a-time
+** loop would have left them. COPY_RUN also memcpy()s the run into the buffer,
+** calling the overflow callback at the same points COPY_TO_BUFFER would (or
+** just extends the marked span, if there is one.) Runs
+** never include a line feed, so line doesn't need updating.
+**
+** Compile with -DTEXTLEX_NO_SCAN to step through every octet instead.
+*/
+
+#ifndef TEXTLEX_NO_SCAN
+#define SKIP_RUN( n ) run = n; \
+  i += run; \
+  OCTETS( run ); \
+  context->bytes_read += run; \
+  STAT( context->stats.octets[ context->state ] += run )
+
+#define COPY_RUN( n ) run = n; \
+  while( ( run > 0 ) && ( TEXTLEX_E_NOERR == err ) ) { \
+    if( ( NULL == mark ) && ( 0 != ( hooks & HOOK_MARK ) ) && ( 0 == context->index ) ) { \
+      mark = & data[ i + 1 ]; \
+    } \
+    if( NULL != mark ) { \
+      chunk = run; \
+    } else if( context->index < context->size ) { \
+      chunk = context->size - context->index; \
+      if( chunk > run ) { chunk = run; } \
+      memcpy( & context->buffer[ context->index ], & data[ i + 1 ], chunk ); \
+    } else { \
+      break; \
+    } \
+    context->index += chunk; \
+    i += chunk; \
+    OCTETS( chunk ); \
+    context->bytes_read += chunk; \
+    STAT( context->stats.octets[ context->state ] += chunk ); \
+    run -= chunk; \
+    if( ( NULL == mark ) && ( context->index >= context->size ) ) { OVERFLOW; } \
+  }
+#else
+#define SKIP_RUN( n )
+#define COPY_RUN( n )
+#endif
 
 #define WS ' ': \
   case '\t'
@@ -91,90 +360,76 @@
 
 #define NONDEL( t ) case WS: \
   case LF: \
-    TOKEN( t ); \
-    TOKEN( TEXTLEX_T_END ); \
+    LEXEME( t ); \
     SET_STATE( TEXTLEX_S_START ); \
     break; \
 \
   case CR: \
-    TOKEN( t ); \
-    TOKEN( TEXTLEX_T_END ); \
+    LEXEME( t ); \
     SET_STATE( TEXTLEX_S_EOLLF ); \
     break; \
 \
   case '#': \
-    TOKEN( t ); \
-    TOKEN( TEXTLEX_T_END ); \
+    LEXEME( t ); \
     SET_STATE( TEXTLEX_S_COMMENT ); \
     break; \
 \
   case '@': \
-    TOKEN( t ); \
-    TOKEN( TEXTLEX_T_END ); \
+    LEXEME( t ); \
     SET_STATE( TEXTLEX_S_ANNOTATE ); \
     break; \
 \
   case '*': \
-    TOKEN( t ); \
-    TOKEN( TEXTLEX_T_END ); \
+    LEXEME( t ); \
     SET_STATE( TEXTLEX_S_LITERAL ); \
     break; \
 \
  case '$':      \
-    TOKEN( t ); \
-    TOKEN( TEXTLEX_T_END ); \
+    LEXEME( t ); \
     SET_STATE( TEXTLEX_S_HEX ); \
     break; \
 \
   case '"': \
-    TOKEN( t ); \
-    TOKEN( TEXTLEX_T_END ); \
+    LEXEME( t ); \
     SET_STATE( TEXTLEX_S_STRING ); \
     break; \
 \
   case '\'': \
-    TOKEN( t ); \
-    TOKEN( TEXTLEX_T_END ); \
+    LEXEME( t ); \
     SET_STATE( TEXTLEX_S_BASE64 ); \
     break; \
 \
   case '(': \
-    TOKEN( t ); \
-    TOKEN( TEXTLEX_T_END ); \
+    LEXEME( t ); \
     SET_STATE( TEXTLEX_S_BASE16_START ); \
     break; \
 \
   case '[': \
-    TOKEN( t ); \
-    TOKEN( TEXTLEX_T_END ); \
+    LEXEME( t ); \
     TOKEN( TEXTLEX_T_ARRAY_OPEN ); \
     SET_STATE( TEXTLEX_S_START ); \
     break; \
 \
   case ']': \
-    TOKEN( t ); \
-    TOKEN( TEXTLEX_T_END ); \
+    LEXEME( t ); \
     TOKEN( TEXTLEX_T_ARRAY_CLOSE ); \
     SET_STATE( TEXTLEX_S_START ); \
     break; \
 \
   case '{': \
-    TOKEN( t ); \
-    TOKEN( TEXTLEX_T_END ); \
+    LEXEME( t ); \
     TOKEN( TEXTLEX_T_MAP_OPEN ); \
     SET_STATE( TEXTLEX_S_START ); \
     break; \
 \
   case '}': \
-    TOKEN( t ); \
-    TOKEN( TEXTLEX_T_END ); \
+    LEXEME( t ); \
     TOKEN( TEXTLEX_T_MAP_CLOSE ); \
     SET_STATE( TEXTLEX_S_START ); \
     break; \
 \
   case '=': \
-    TOKEN( t ); \
-    TOKEN( TEXTLEX_T_END ); \
+    LEXEME( t ); \
     TOKEN( TEXTLEX_T_EQUALS ); \
     SET_STATE( TEXTLEX_S_START ); \
     break;
@@ -184,6 +439,43 @@
 #include "textlex.h"
 #include <string.h>
 
+#if ! defined( TEXTLEX_NO_SCAN ) || defined( TEXTLEX_LAZY_LINES )
+#include "textscan.h"
+#endif
+
+#ifdef TEXTLEX_STATS
+#include "textstat.h"
+#endif
+
+/* Function Prototypes */
+
+static tTextLexErr _spill( tTextLexContext * context, tTextLexBuffer * mark );
+static tTextLexErr _flush( tTextLexContext * context );
+static tTextLexErr _pull( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr _number( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * mark );
+static tTextLexErr _decode( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * mark, int piece );
+static tTextLexErr _record( tTextLexContext * context, tTextLexCount token, tTextLexErr err );
+
+#ifdef TEXTLEX_LAZY_LINES
+static void _count( tTextLexContext * context, tTextLexCount n );
+#endif
+
+#ifdef TEXTLEX_NO_SCAN
+static size_t _scalar_decode( tTextLexCount token, const tTextLexBuffer * data, size_t length, tTextLexBuffer * out );
+#endif
+
+#ifdef TEXTLEX_DFA
+static void _digit( tTextNumDigits * digits, tTextLexState next, unsigned char current );
+#endif
+
+/* Global Variables */
+
+/* The extension the lexxer uses when the context hasn't got one. All its
+** callbacks are NULL, so nothing ever writes to it.
+*/
+
+static tTextLexExtension _plain = { .wanted = TEXTLEX_M_ALL };
+
 /* Function Definitions */
 
 tTextLexErr textlex_init( tTextLexContext * context, tTextLexBuffer * buffer, tTextLexCount size ) {
@@ -195,28 +487,52 @@ tTextLexErr textlex_init( tTextLexContext * context, tTextLexBuffer * buffer, tT
   return( TEXTLEX_E_NOERR );
 }
 
+tTextLexErr textlex_extend( tTextLexContext * context, tTextLexExtension * extension ) {
+  memset( extension, 0, sizeof( tTextLexExtension ) );
+  extension->wanted = TEXTLEX_M_ALL;
+  context->extension = extension;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+#ifndef TEXTLEX_DFA
+
 tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tTextLexCount length ) {
   tTextLexErr err = TEXTLEX_E_NOERR;
-  unsigned int i;
+  tTextLexCount i;
   unsigned char current;
+  tTextLexBuffer * mark = NULL;
+  tTextLexExtension * extension = EXTENSION;
+  unsigned int hooks = HOOKS;
+  unsigned int wanted = extension->wanted;
+#ifndef TEXTLEX_NO_SCAN
+  size_t run, chunk;
+#endif
+#ifdef TEXTLEX_STATS
+  unsigned long long ticks = TEXTSTAT_TICKS();
+#endif
 
-  context->bytes_read = 0;
+  OFFSET;
+  LINES_BEGIN;
   
   for( i = 0; i < length; i++ ) {
     current = data[ i ];
     context->bytes_read += 1;
+    STAT( context->stats.octets[ context->state ]++ );
     
-    if( '\n' == current ) {
-      context->line++;
-      context->octet = 0;
-    }
+    LINE_FEED;
 
     switch( context->state ) {
     case TEXTLEX_S_START:
+      if( ( 0 != ( hooks & HOOK_RECORD ) ) && ( current > ' ' ) && ( '#' != current ) ) {
+        RECORD_BEGIN;
+      }
+
       switch( current ) {
       case WS:
       case LF:
         SET_STATE( TEXTLEX_S_START );
+        SKIP_RUN( textscan_span2( & data[ i + 1 ], length - i - 1, ' ', '\t' ) );
         break;
 
       case CR:
@@ -236,8 +552,14 @@ tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tT
         break;
 
       case DIGIT:
+        COPY_TO_BUFFER;
+        INTEGER_DIGIT;
+        SET_STATE( TEXTLEX_S_NUMBER );
+        break;
+        
       case '-':
         COPY_TO_BUFFER;
+        SIGN( TEXTNUM_F_NEGATIVE );
         SET_STATE( TEXTLEX_S_NUMBER );
         break;
         
@@ -303,19 +625,22 @@ tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tT
     case TEXTLEX_S_COMMENT:
       switch( current ) {
       case LF:
-        TOKEN( TEXTLEX_T_COMMENT );
-        TOKEN( TEXTLEX_T_END );
+        LEXEME( TEXTLEX_T_COMMENT );
         SET_STATE( TEXTLEX_S_START );
         break;
         
       case CR:
-        TOKEN( TEXTLEX_T_COMMENT );
-        TOKEN( TEXTLEX_T_END );
+        LEXEME( TEXTLEX_T_COMMENT );
         SET_STATE( TEXTLEX_S_EOLLF );
         break;
 
       default:
-        COPY_TO_BUFFER;
+        if( WANTED( TEXTLEX_T_COMMENT ) ) {
+          COPY_TO_BUFFER;
+          COPY_RUN( textscan_find2( & data[ i + 1 ], length - i - 1, LF, CR ) );
+        } else {
+          SKIP_RUN( textscan_find2( & data[ i + 1 ], length - i - 1, LF, CR ) );
+        }
         break;
       }
       break;
@@ -324,7 +649,9 @@ tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tT
       switch( current ) {
       case ALPHA:
       case DIGIT:
-        COPY_TO_BUFFER;
+        if( WANTED( TEXTLEX_T_ANNOTATION ) ) {
+          COPY_TO_BUFFER;
+        }
         SET_STATE( TEXTLEX_S_ANNOTATE );
         break;
 
@@ -355,6 +682,7 @@ tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tT
       switch( current ) {
       case DIGIT:
         COPY_TO_BUFFER;
+        INTEGER_DIGIT;
         SET_STATE( TEXTLEX_S_NUMBER );
         break;
 
@@ -375,6 +703,7 @@ tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tT
       switch( current ) {
       case DIGIT:
         COPY_TO_BUFFER;
+        FRACTION_DIGIT;
         SET_STATE( TEXTLEX_S_FLOAT );
         break;
         
@@ -388,6 +717,7 @@ tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tT
       switch( current ) {
       case DIGIT:
         COPY_TO_BUFFER;
+        FRACTION_DIGIT;
         SET_STATE( TEXTLEX_S_FLOAT );
         break;
 
@@ -409,11 +739,13 @@ tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tT
       switch( current ) {
       case '-':
         COPY_TO_BUFFER;
+        SIGN( TEXTNUM_F_EXPONENT_NEG );
         SET_STATE( TEXTLEX_S_EXPONENT_NEG );
         break;
 
       case DIGIT:
         COPY_TO_BUFFER;
+        EXPONENT_DIGIT;
         SET_STATE( TEXTLEX_S_EXPONENT );
         break;
         
@@ -427,6 +759,7 @@ tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tT
       switch( current ) {
       case DIGIT:
         COPY_TO_BUFFER;
+        EXPONENT_DIGIT;
         SET_STATE( TEXTLEX_S_EXPONENT );
         break;
 
@@ -440,6 +773,7 @@ tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tT
       switch( current ) {
       case DIGIT:
         COPY_TO_BUFFER;
+        EXPONENT_DIGIT;
         SET_STATE( TEXTLEX_S_EXPONENT );
         break;
 
@@ -455,6 +789,7 @@ tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tT
       switch( current ) {
       case HEXDIGIT:
         COPY_TO_BUFFER;
+        HEX_DIGIT;
         SET_STATE( TEXTLEX_S_HEX );
         break;
 
@@ -480,6 +815,7 @@ tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tT
         
       default:
         COPY_TO_BUFFER;
+        COPY_RUN( textscan_find3( & data[ i + 1 ], length - i - 1, '"', '\\', LF ) );
         break;
       }
       break;
@@ -525,6 +861,7 @@ tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tT
         break;
 
       case '#':
+        DECODE_BREAK_HERE;
         TOKEN( TEXTLEX_T_HEX );
         TOKEN( TEXTLEX_T_END );
         SET_STATE( TEXTLEX_S_BASE16_COMMENT );
@@ -541,19 +878,22 @@ tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tT
     case TEXTLEX_S_BASE16_COMMENT:
       switch( current ) {
       case LF:
-        TOKEN( TEXTLEX_T_COMMENT );
-        TOKEN( TEXTLEX_T_END );
+        LEXEME( TEXTLEX_T_COMMENT );
         SET_STATE( TEXTLEX_S_BASE16_START );
         break;
         
       case CR:
-        TOKEN( TEXTLEX_T_COMMENT );
-        TOKEN( TEXTLEX_T_END );
+        LEXEME( TEXTLEX_T_COMMENT );
         SET_STATE( TEXTLEX_S_BASE16_EOLLF );
         break;
 
       default:
-        COPY_TO_BUFFER;
+        if( WANTED( TEXTLEX_T_COMMENT ) ) {
+          COPY_TO_BUFFER;
+          COPY_RUN( textscan_find2( & data[ i + 1 ], length - i - 1, LF, CR ) );
+        } else {
+          SKIP_RUN( textscan_find2( & data[ i + 1 ], length - i - 1, LF, CR ) );
+        }
         break;
       }
       break;
@@ -572,27 +912,509 @@ tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tT
     }
 
     if( TEXTLEX_E_NOERR != err ) {
+      if( TEXTLEX_E_YIELD == err ) {
+        OCTETS( 1 );
+      }
+      break;
+    }
+
+    OCTETS( 1 );
+  }
+
+  LINES_END;
+
+  if( NULL != mark ) {
+    tTextLexErr spill_err = _spill( context, mark );
+    if( TEXTLEX_E_NOERR == err ) {
+      err = spill_err;
+    }
+  }
+
+  if( ( NULL != extension->batch ) && ( extension->count > 0 ) ) {
+    tTextLexErr flush_err = _flush( context );
+    if( TEXTLEX_E_NOERR == err ) {
+      err = flush_err;
+    }
+  }
+
+  STAT( context->stats.ticks += TEXTSTAT_TICKS() - ticks );
+  
+  return( err );
+}
+
+#else /* TEXTLEX_DFA */
+
+/* This is the table driven version of textlex_update(). It implements
+** exactly the same state machine as the switch statements above, but each
+** input octet is first mapped to one of the DFA_C_CLASSES character classes
+** with _dfa_class[] and then the (state, class) pair is looked up in
+** _dfa_action[]. Each entry in the action table packs an action, a token
+** and the next state into 16 bits:
+**
+**   bits 12-15 : what to do (one of the DFA_A_* actions below)
+**   bits  8-11 : the token to send (for DFA_A_TOKEN, _EMIT & _STRUCT)
+**   bits  0- 7 : the next state
+**
+** Compile with -DTEXTLEX_DFA to use this engine instead of the switch.
+*/
+
+#define DFA_A_GO      0 /* Just change state */
+#define DFA_A_COPY    1 /* COPY_TO_BUFFER */
+#define DFA_A_ERROR   2 /* Syntax error; see _dfa_error[] */
+#define DFA_A_TOKEN   3 /* Send a fixed length token */
+#define DFA_A_EMIT    4 /* Send a variable length token and TEXTLEX_T_END */
+#define DFA_A_STRUCT  5 /* Like DFA_A_EMIT, followed by a fixed length token */
+#define DFA_A_SKIPWS  6 /* Skip a run of white space */
+#define DFA_A_COMMENT 7 /* COPY_TO_BUFFER and copy the rest of the comment */
+#define DFA_A_STRING  8 /* COPY_TO_BUFFER and copy the rest of the string */
+
+#define DFA_ENTRY( a, t, s ) ( ( ( a ) << 12 ) | ( ( t ) << 8 ) | ( s ) )
+#define DFA_ACTION( e ) ( ( e ) >> 12 )
+#define DFA_TOKEN( e ) ( ( ( e ) >> 8 ) & 15 )
+#define DFA_NEXT( e ) ( ( e ) & 255 )
+
+#define GO( s ) DFA_ENTRY( DFA_A_GO, 0, TEXTLEX_S_##s )
+#define CP( s ) DFA_ENTRY( DFA_A_COPY, 0, TEXTLEX_S_##s )
+#define ER( s ) DFA_ENTRY( DFA_A_ERROR, 0, TEXTLEX_S_##s )
+#define TK( t ) DFA_ENTRY( DFA_A_TOKEN, TEXTLEX_T_##t, TEXTLEX_S_START )
+#define EM( t, s ) DFA_ENTRY( DFA_A_EMIT, TEXTLEX_T_##t, TEXTLEX_S_##s )
+#define ES( t ) DFA_ENTRY( DFA_A_STRUCT, TEXTLEX_T_##t, TEXTLEX_S_START )
+#define SW( s ) DFA_ENTRY( DFA_A_SKIPWS, 0, TEXTLEX_S_##s )
+#define CC( s ) DFA_ENTRY( DFA_A_COMMENT, 0, TEXTLEX_S_##s )
+#define CS( s ) DFA_ENTRY( DFA_A_STRING, 0, TEXTLEX_S_##s )
+
+/* Character classes. K_EXP is 'E' or 'e', K_HEXALPHA is the rest of the hex
+** letters and K_ALPHA is the non-hex letters. K_LBRACK through K_EQUALS
+** are in the same order as TEXTLEX_T_ARRAY_OPEN through TEXTLEX_T_EQUALS
+** so DFA_A_STRUCT can work out which token to send from the class.
+*/
+
+#define DFA_C_CLASSES 26
+#define K_OTHER     0
+#define K_WS        1
+#define K_LF        2
+#define K_CR        3
+#define K_HASH      4
+#define K_AT        5
+#define K_STAR      6
+#define K_DIGIT     7
+#define K_MINUS     8
+#define K_DOLLAR    9
+#define K_DQUOTE   10
+#define K_SQUOTE   11
+#define K_LPAREN   12
+#define K_RPAREN   13
+#define K_LBRACK   14
+#define K_RBRACK   15
+#define K_LBRACE   16
+#define K_RBRACE   17
+#define K_EQUALS   18
+#define K_EXP      19
+#define K_HEXALPHA 20
+#define K_ALPHA    21
+#define K_DOT      22
+#define K_BSLASH   23
+#define K_PLUS     24
+#define K_SLASH    25
+
+static const unsigned char _dfa_class[ 256 ] = {
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* 00 */
+  K_OTHER,    K_WS,       K_LF,       K_OTHER,    K_OTHER,    K_CR,       K_OTHER,    K_OTHER, /* 08 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* 10 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* 18 */
+  K_WS,       K_OTHER,    K_DQUOTE,   K_HASH,     K_DOLLAR,   K_OTHER,    K_OTHER,    K_SQUOTE, /* 20 */
+  K_LPAREN,   K_RPAREN,   K_STAR,     K_PLUS,     K_OTHER,    K_MINUS,    K_DOT,      K_SLASH, /* 28 */
+  K_DIGIT,    K_DIGIT,    K_DIGIT,    K_DIGIT,    K_DIGIT,    K_DIGIT,    K_DIGIT,    K_DIGIT, /* 30 */
+  K_DIGIT,    K_DIGIT,    K_OTHER,    K_OTHER,    K_OTHER,    K_EQUALS,   K_OTHER,    K_OTHER, /* 38 */
+  K_AT,       K_HEXALPHA, K_HEXALPHA, K_HEXALPHA, K_HEXALPHA, K_EXP,      K_HEXALPHA, K_ALPHA, /* 40 */
+  K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA, /* 48 */
+  K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA, /* 50 */
+  K_ALPHA,    K_ALPHA,    K_ALPHA,    K_LBRACK,   K_BSLASH,   K_RBRACK,   K_OTHER,    K_OTHER, /* 58 */
+  K_OTHER,    K_HEXALPHA, K_HEXALPHA, K_HEXALPHA, K_HEXALPHA, K_EXP,      K_HEXALPHA, K_ALPHA, /* 60 */
+  K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA, /* 68 */
+  K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA,    K_ALPHA, /* 70 */
+  K_ALPHA,    K_ALPHA,    K_ALPHA,    K_LBRACE,   K_OTHER,    K_RBRACE,   K_OTHER,    K_OTHER, /* 78 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* 80 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* 88 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* 90 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* 98 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* A0 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* A8 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* B0 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* B8 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* C0 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* C8 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* D0 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* D8 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* E0 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* E8 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER, /* F0 */
+  K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER,    K_OTHER  /* F8 */
+};
+
+/* The columns in each row are in character class order:
+**
+**   OTHER      WS         LF         CR
+**   HASH       AT         STAR       DIGIT
+**   MINUS      DOLLAR     DQUOTE     SQUOTE
+**   LPAREN     RPAREN     LBRACK     RBRACK
+**   LBRACE     RBRACE     EQUALS     EXP
+**   HEXALPHA   ALPHA      DOT        BSLASH
+**   PLUS       SLASH
+*/
+
+static const unsigned short _dfa_action[ TEXTLEX_C_STATES ][ DFA_C_CLASSES ] = {
+  /* TEXTLEX_S_START */
+  {
+    ER( START ),              SW( START ),              SW( START ),              GO( EOLLF ),
+    GO( COMMENT ),            GO( ANNOTATE ),           GO( LITERAL ),            CP( NUMBER ),
+    CP( NUMBER ),             GO( HEX ),                GO( STRING ),             GO( BASE64 ),
+    GO( BASE16_START ),       ER( START ),              TK( ARRAY_OPEN ),         TK( ARRAY_CLOSE ),
+    TK( MAP_OPEN ),           TK( MAP_CLOSE ),          TK( EQUALS ),             ER( START ),
+    ER( START ),              ER( START ),              ER( START ),              ER( START ),
+    ER( START ),              ER( START )
+  },
+
+  /* TEXTLEX_S_EOLLF */
+  {
+    ER( EOLLF ),              ER( EOLLF ),              GO( START ),              ER( EOLLF ),
+    ER( EOLLF ),              ER( EOLLF ),              ER( EOLLF ),              ER( EOLLF ),
+    ER( EOLLF ),              ER( EOLLF ),              ER( EOLLF ),              ER( EOLLF ),
+    ER( EOLLF ),              ER( EOLLF ),              ER( EOLLF ),              ER( EOLLF ),
+    ER( EOLLF ),              ER( EOLLF ),              ER( EOLLF ),              ER( EOLLF ),
+    ER( EOLLF ),              ER( EOLLF ),              ER( EOLLF ),              ER( EOLLF ),
+    ER( EOLLF ),              ER( EOLLF )
+  },
+
+  /* TEXTLEX_S_COMMENT */
+  {
+    CC( COMMENT ),            CC( COMMENT ),            EM( COMMENT, START ),     EM( COMMENT, EOLLF ),
+    CC( COMMENT ),            CC( COMMENT ),            CC( COMMENT ),            CC( COMMENT ),
+    CC( COMMENT ),            CC( COMMENT ),            CC( COMMENT ),            CC( COMMENT ),
+    CC( COMMENT ),            CC( COMMENT ),            CC( COMMENT ),            CC( COMMENT ),
+    CC( COMMENT ),            CC( COMMENT ),            CC( COMMENT ),            CC( COMMENT ),
+    CC( COMMENT ),            CC( COMMENT ),            CC( COMMENT ),            CC( COMMENT ),
+    CC( COMMENT ),            CC( COMMENT )
+  },
+
+  /* TEXTLEX_S_ANNOTATE */
+  {
+    ER( ANNOTATE ),           EM( ANNOTATION, START ),  EM( ANNOTATION, START ),  EM( ANNOTATION, EOLLF ),
+    EM( ANNOTATION, COMMENT ),EM( ANNOTATION, ANNOTATE ),EM( ANNOTATION, LITERAL ),CP( ANNOTATE ),
+    ER( ANNOTATE ),           EM( ANNOTATION, HEX ),    EM( ANNOTATION, STRING ), EM( ANNOTATION, BASE64 ),
+    EM( ANNOTATION, BASE16_START ),ER( ANNOTATE ),           ES( ANNOTATION ),         ES( ANNOTATION ),
+    ES( ANNOTATION ),         ES( ANNOTATION ),         ES( ANNOTATION ),         CP( ANNOTATE ),
+    CP( ANNOTATE ),           CP( ANNOTATE ),           ER( ANNOTATE ),           ER( ANNOTATE ),
+    ER( ANNOTATE ),           ER( ANNOTATE )
+  },
+
+  /* TEXTLEX_S_LITERAL */
+  {
+    ER( LITERAL ),            EM( LITERAL, START ),     EM( LITERAL, START ),     EM( LITERAL, EOLLF ),
+    EM( LITERAL, COMMENT ),   EM( LITERAL, ANNOTATE ),  EM( LITERAL, LITERAL ),   ER( LITERAL ),
+    ER( LITERAL ),            EM( LITERAL, HEX ),       EM( LITERAL, STRING ),    EM( LITERAL, BASE64 ),
+    EM( LITERAL, BASE16_START ),ER( LITERAL ),            ES( LITERAL ),            ES( LITERAL ),
+    ES( LITERAL ),            ES( LITERAL ),            ES( LITERAL ),            CP( LITERAL ),
+    CP( LITERAL ),            CP( LITERAL ),            ER( LITERAL ),            ER( LITERAL ),
+    ER( LITERAL ),            ER( LITERAL )
+  },
+
+  /* TEXTLEX_S_NUMBER */
+  {
+    ER( NUMBER ),             EM( INTEGER, START ),     EM( INTEGER, START ),     EM( INTEGER, EOLLF ),
+    EM( INTEGER, COMMENT ),   EM( INTEGER, ANNOTATE ),  EM( INTEGER, LITERAL ),   CP( NUMBER ),
+    ER( NUMBER ),             EM( INTEGER, HEX ),       EM( INTEGER, STRING ),    EM( INTEGER, BASE64 ),
+    EM( INTEGER, BASE16_START ),ER( NUMBER ),             ES( INTEGER ),            ES( INTEGER ),
+    ES( INTEGER ),            ES( INTEGER ),            ES( INTEGER ),            ER( NUMBER ),
+    ER( NUMBER ),             ER( NUMBER ),             CP( FLOAT_START ),        ER( NUMBER ),
+    ER( NUMBER ),             ER( NUMBER )
+  },
+
+  /* TEXTLEX_S_FLOAT_START */
+  {
+    ER( FLOAT_START ),        ER( FLOAT_START ),        ER( FLOAT_START ),        ER( FLOAT_START ),
+    ER( FLOAT_START ),        ER( FLOAT_START ),        ER( FLOAT_START ),        CP( FLOAT ),
+    ER( FLOAT_START ),        ER( FLOAT_START ),        ER( FLOAT_START ),        ER( FLOAT_START ),
+    ER( FLOAT_START ),        ER( FLOAT_START ),        ER( FLOAT_START ),        ER( FLOAT_START ),
+    ER( FLOAT_START ),        ER( FLOAT_START ),        ER( FLOAT_START ),        ER( FLOAT_START ),
+    ER( FLOAT_START ),        ER( FLOAT_START ),        ER( FLOAT_START ),        ER( FLOAT_START ),
+    ER( FLOAT_START ),        ER( FLOAT_START )
+  },
+
+  /* TEXTLEX_S_FLOAT */
+  {
+    ER( FLOAT ),              EM( FLOAT, START ),       EM( FLOAT, START ),       EM( FLOAT, EOLLF ),
+    EM( FLOAT, COMMENT ),     EM( FLOAT, ANNOTATE ),    EM( FLOAT, LITERAL ),     CP( FLOAT ),
+    ER( FLOAT ),              EM( FLOAT, HEX ),         EM( FLOAT, STRING ),      EM( FLOAT, BASE64 ),
+    EM( FLOAT, BASE16_START ),ER( FLOAT ),              ES( FLOAT ),              ES( FLOAT ),
+    ES( FLOAT ),              ES( FLOAT ),              ES( FLOAT ),              CP( EXPONENT_START ),
+    ER( FLOAT ),              ER( FLOAT ),              ER( FLOAT ),              ER( FLOAT ),
+    ER( FLOAT ),              ER( FLOAT )
+  },
+
+  /* TEXTLEX_S_EXPONENT_START */
+  {
+    ER( EXPONENT_START ),     ER( EXPONENT_START ),     ER( EXPONENT_START ),     ER( EXPONENT_START ),
+    ER( EXPONENT_START ),     ER( EXPONENT_START ),     ER( EXPONENT_START ),     CP( EXPONENT ),
+    CP( EXPONENT_NEG ),       ER( EXPONENT_START ),     ER( EXPONENT_START ),     ER( EXPONENT_START ),
+    ER( EXPONENT_START ),     ER( EXPONENT_START ),     ER( EXPONENT_START ),     ER( EXPONENT_START ),
+    ER( EXPONENT_START ),     ER( EXPONENT_START ),     ER( EXPONENT_START ),     ER( EXPONENT_START ),
+    ER( EXPONENT_START ),     ER( EXPONENT_START ),     ER( EXPONENT_START ),     ER( EXPONENT_START ),
+    ER( EXPONENT_START ),     ER( EXPONENT_START )
+  },
+
+  /* TEXTLEX_S_EXPONENT_NEG */
+  {
+    ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),
+    ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),       CP( EXPONENT ),
+    ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),
+    ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),
+    ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),
+    ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),       ER( EXPONENT_NEG ),
+    ER( EXPONENT_NEG ),       ER( EXPONENT_NEG )
+  },
+
+  /* TEXTLEX_S_EXPONENT */
+  {
+    ER( EXPONENT ),           EM( FLOAT, START ),       EM( FLOAT, START ),       EM( FLOAT, EOLLF ),
+    EM( FLOAT, COMMENT ),     EM( FLOAT, ANNOTATE ),    EM( FLOAT, LITERAL ),     CP( EXPONENT ),
+    ER( EXPONENT ),           EM( FLOAT, HEX ),         EM( FLOAT, STRING ),      EM( FLOAT, BASE64 ),
+    EM( FLOAT, BASE16_START ),ER( EXPONENT ),           ES( FLOAT ),              ES( FLOAT ),
+    ES( FLOAT ),              ES( FLOAT ),              ES( FLOAT ),              ER( EXPONENT ),
+    ER( EXPONENT ),           ER( EXPONENT ),           ER( EXPONENT ),           ER( EXPONENT ),
+    ER( EXPONENT ),           ER( EXPONENT )
+  },
+
+  /* TEXTLEX_S_HEX */
+  {
+    ER( HEX ),                EM( HEX, START ),         EM( HEX, START ),         EM( HEX, EOLLF ),
+    EM( HEX, COMMENT ),       EM( HEX, ANNOTATE ),      EM( HEX, LITERAL ),       CP( HEX ),
+    ER( HEX ),                EM( HEX, HEX ),           EM( HEX, STRING ),        EM( HEX, BASE64 ),
+    EM( HEX, BASE16_START ),  ER( HEX ),                ES( HEX ),                ES( HEX ),
+    ES( HEX ),                ES( HEX ),                ES( HEX ),                CP( HEX ),
+    CP( HEX ),                ER( HEX ),                ER( HEX ),                ER( HEX ),
+    ER( HEX ),                ER( HEX )
+  },
+
+  /* TEXTLEX_S_STRING */
+  {
+    CS( STRING ),             CS( STRING ),             CS( STRING ),             CS( STRING ),
+    CS( STRING ),             CS( STRING ),             CS( STRING ),             CS( STRING ),
+    CS( STRING ),             CS( STRING ),             EM( STRING, START ),      CS( STRING ),
+    CS( STRING ),             CS( STRING ),             CS( STRING ),             CS( STRING ),
+    CS( STRING ),             CS( STRING ),             CS( STRING ),             CS( STRING ),
+    CS( STRING ),             CS( STRING ),             CS( STRING ),             GO( STRING_ESCAPE ),
+    CS( STRING ),             CS( STRING )
+  },
+
+  /* TEXTLEX_S_STRING_ESCAPE */
+  {
+    ER( STRING_ESCAPE ),      ER( STRING_ESCAPE ),      ER( STRING_ESCAPE ),      ER( STRING_ESCAPE ),
+    ER( STRING_ESCAPE ),      ER( STRING_ESCAPE ),      ER( STRING_ESCAPE ),      ER( STRING_ESCAPE ),
+    ER( STRING_ESCAPE ),      ER( STRING_ESCAPE ),      CP( STRING ),             ER( STRING_ESCAPE ),
+    ER( STRING_ESCAPE ),      ER( STRING_ESCAPE ),      ER( STRING_ESCAPE ),      ER( STRING_ESCAPE ),
+    ER( STRING_ESCAPE ),      ER( STRING_ESCAPE ),      ER( STRING_ESCAPE ),      ER( STRING_ESCAPE ),
+    ER( STRING_ESCAPE ),      ER( STRING_ESCAPE ),      ER( STRING_ESCAPE ),      CP( STRING ),
+    ER( STRING_ESCAPE ),      ER( STRING_ESCAPE )
+  },
+
+  /* TEXTLEX_S_BASE64 */
+  {
+    GO( BASE64 ),             GO( BASE64 ),             GO( BASE64 ),             GO( BASE64 ),
+    GO( BASE64 ),             GO( BASE64 ),             GO( BASE64 ),             CP( BASE64 ),
+    GO( BASE64 ),             GO( BASE64 ),             GO( BASE64 ),             EM( BASE64, START ),
+    GO( BASE64 ),             GO( BASE64 ),             GO( BASE64 ),             GO( BASE64 ),
+    GO( BASE64 ),             GO( BASE64 ),             CP( BASE64 ),             CP( BASE64 ),
+    CP( BASE64 ),             CP( BASE64 ),             GO( BASE64 ),             GO( BASE64 ),
+    CP( BASE64 ),             CP( BASE64 )
+  },
+
+  /* TEXTLEX_S_BASE16_START */
+  {
+    GO( BASE16_START ),       GO( BASE16_START ),       GO( BASE16_START ),       GO( BASE16_START ),
+    EM( HEX, BASE16_COMMENT ),GO( BASE16_START ),       GO( BASE16_START ),       CP( BASE16_START ),
+    GO( BASE16_START ),       GO( BASE16_START ),       GO( BASE16_START ),       GO( BASE16_START ),
+    GO( BASE16_START ),       EM( HEX, START ),         GO( BASE16_START ),       GO( BASE16_START ),
+    GO( BASE16_START ),       GO( BASE16_START ),       GO( BASE16_START ),       CP( BASE16_START ),
+    CP( BASE16_START ),       GO( BASE16_START ),       GO( BASE16_START ),       GO( BASE16_START ),
+    GO( BASE16_START ),       GO( BASE16_START )
+  },
+
+  /* TEXTLEX_S_BASE16_COMMENT */
+  {
+    CC( BASE16_COMMENT ),     CC( BASE16_COMMENT ),     EM( COMMENT, BASE16_START ),EM( COMMENT, BASE16_EOLLF ),
+    CC( BASE16_COMMENT ),     CC( BASE16_COMMENT ),     CC( BASE16_COMMENT ),     CC( BASE16_COMMENT ),
+    CC( BASE16_COMMENT ),     CC( BASE16_COMMENT ),     CC( BASE16_COMMENT ),     CC( BASE16_COMMENT ),
+    CC( BASE16_COMMENT ),     CC( BASE16_COMMENT ),     CC( BASE16_COMMENT ),     CC( BASE16_COMMENT ),
+    CC( BASE16_COMMENT ),     CC( BASE16_COMMENT ),     CC( BASE16_COMMENT ),     CC( BASE16_COMMENT ),
+    CC( BASE16_COMMENT ),     CC( BASE16_COMMENT ),     CC( BASE16_COMMENT ),     CC( BASE16_COMMENT ),
+    CC( BASE16_COMMENT ),     CC( BASE16_COMMENT )
+  },
+
+  /* TEXTLEX_S_BASE16_EOLLF */
+  {
+    ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),       GO( BASE16_START ),
+    ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),
+    ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),
+    ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),
+    ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),
+    ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),       ER( BASE16_EOLLF ),
+    ER( BASE16_EOLLF ),       ER( BASE16_EOLLF )
+  }
+};
+
+/* The error returned for a DFA_A_ERROR action in each state. (Yes, an error
+** in the EOLLF state returns TEXTLEX_E_START. That's what the switch does.)
+*/
+
+static const unsigned char _dfa_error[ TEXTLEX_C_STATES ] = {
+  TEXTLEX_E_START, TEXTLEX_E_START, TEXTLEX_E_NOERR, TEXTLEX_E_ANNOTATE,
+  TEXTLEX_E_LITERAL, TEXTLEX_E_NUMBER, TEXTLEX_E_FLOAT_START, TEXTLEX_E_FLOAT,
+  TEXTLEX_E_EXPONENT_START, TEXTLEX_E_EXPONENT_NEG, TEXTLEX_E_EXPONENT, TEXTLEX_E_HEX,
+  TEXTLEX_E_NOERR, TEXTLEX_E_STRING_ESCAPE, TEXTLEX_E_NOERR, TEXTLEX_E_NOERR,
+  TEXTLEX_E_NOERR, TEXTLEX_E_BASE16_EOLLF
+};
+
+tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tTextLexCount length ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexCount i;
+  unsigned char current;
+  unsigned char class;
+  unsigned short entry;
+  tTextLexBuffer * mark = NULL;
+  tTextLexExtension * extension = EXTENSION;
+  unsigned int hooks = HOOKS;
+  unsigned int wanted = extension->wanted;
+#ifndef TEXTLEX_NO_SCAN
+  size_t run, chunk;
+#endif
+#ifdef TEXTLEX_STATS
+  unsigned long long ticks = TEXTSTAT_TICKS();
+#endif
+
+  OFFSET;
+  LINES_BEGIN;
+  
+  for( i = 0; i < length; i++ ) {
+    current = data[ i ];
+    context->bytes_read += 1;
+    STAT( context->stats.octets[ context->state ]++ );
+    
+    LINE_FEED;
+
+    class = _dfa_class[ current ];
+    entry = _dfa_action[ context->state ][ class ];
+
+    if( ( 0 != ( hooks & HOOK_RECORD ) ) && ( TEXTLEX_S_START == context->state ) && ( class > K_HASH ) ) {
+      RECORD_BEGIN;
+    }
+
+    switch( DFA_ACTION( entry ) ) {
+    case DFA_A_GO:
+      break;
+
+    case DFA_A_COPY:
+      if( ( TEXTLEX_S_ANNOTATE == context->state ) && ! WANTED( TEXTLEX_T_ANNOTATION ) ) {
+        break;
+      }
+      COPY_TO_BUFFER;
+      if( 0 != ( hooks & HOOK_NUMBER ) ) {
+        _digit( & extension->digits, DFA_NEXT( entry ), current );
+      }
+      break;
+
+    case DFA_A_ERROR:
+      err = _dfa_error[ context->state ];
+      break;
+
+    case DFA_A_TOKEN:
+      TOKEN( DFA_TOKEN( entry ) );
+      break;
+
+    case DFA_A_EMIT:
+      if( TEXTLEX_S_BASE16_COMMENT == DFA_NEXT( entry ) ) {
+        DECODE_BREAK_HERE;
+      }
+      LEXEME( DFA_TOKEN( entry ) );
+      break;
+
+    case DFA_A_STRUCT:
+      LEXEME( DFA_TOKEN( entry ) );
+      TOKEN( class - K_LBRACK + TEXTLEX_T_ARRAY_OPEN );
+      break;
+
+    case DFA_A_SKIPWS:
+      SKIP_RUN( textscan_span2( & data[ i + 1 ], length - i - 1, ' ', '\t' ) );
+      break;
+
+    case DFA_A_COMMENT:
+      if( WANTED( TEXTLEX_T_COMMENT ) ) {
+        COPY_TO_BUFFER;
+        COPY_RUN( textscan_find2( & data[ i + 1 ], length - i - 1, LF, CR ) );
+      } else {
+        SKIP_RUN( textscan_find2( & data[ i + 1 ], length - i - 1, LF, CR ) );
+      }
+      break;
+
+    case DFA_A_STRING:
+      COPY_TO_BUFFER;
+      COPY_RUN( textscan_find3( & data[ i + 1 ], length - i - 1, '"', '\\', LF ) );
+      break;
+    }
+
+    SET_STATE( DFA_NEXT( entry ) );
+
+    if( TEXTLEX_E_NOERR != err ) {
+      if( TEXTLEX_E_YIELD == err ) {
+        OCTETS( 1 );
+      }
       break;
     }
 
-    context->octet++;
+    OCTETS( 1 );
+  }
+
+  LINES_END;
+
+  if( NULL != mark ) {
+    tTextLexErr spill_err = _spill( context, mark );
+    if( TEXTLEX_E_NOERR == err ) {
+      err = spill_err;
+    }
+  }
+
+  if( ( NULL != extension->batch ) && ( extension->count > 0 ) ) {
+    tTextLexErr flush_err = _flush( context );
+    if( TEXTLEX_E_NOERR == err ) {
+      err = flush_err;
+    }
   }
+
+  STAT( context->stats.ticks += TEXTSTAT_TICKS() - ticks );
   
   return( err );
 }
 
+#endif /* TEXTLEX_DFA */
+
 tTextLexErr textlex_final( tTextLexContext * context ) {
   tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexBuffer * mark = NULL; /* spans never outlive textlex_update() */
+  tTextLexExtension * extension = EXTENSION;
+  unsigned int wanted = extension->wanted;
+#ifdef TEXTLEX_STATS
+  unsigned long long ticks = TEXTSTAT_TICKS();
+#endif
+
+  OFFSET;
 
   switch( context->state ) {
   case TEXTLEX_S_COMMENT:
-    TOKEN( TEXTLEX_T_COMMENT );
-    TOKEN( TEXTLEX_T_END );
+    LEXEME( TEXTLEX_T_COMMENT );
     break;
     
   case TEXTLEX_S_ANNOTATE:
-    TOKEN( TEXTLEX_T_ANNOTATION );
-    TOKEN( TEXTLEX_T_END );
+    LEXEME( TEXTLEX_T_ANNOTATION );
     break;
     
   case TEXTLEX_S_LITERAL:
@@ -616,12 +1438,70 @@ tTextLexErr textlex_final( tTextLexContext * context ) {
     TOKEN( TEXTLEX_T_END );
     break;
   }
+
+  if( TEXTLEX_E_YIELD == err ) {
+    err = TEXTLEX_E_NOERR;
+  }
+
+  if( ( TEXTLEX_E_NOERR == err ) && ( NULL != extension->batch ) && ( extension->count > 0 ) ) {
+    err = _flush( context );
+  }
+
+  STAT( context->stats.ticks += TEXTSTAT_TICKS() - ticks );
   
   return( err );
 }
 
+void textlex_position( tTextLexContext * context ) {
+#ifdef TEXTLEX_LAZY_LINES
+  tTextLexCount n;
+
+  if( ( NULL == context->lines ) || ( 0 == context->bytes_read ) ) {
+    return;
+  }
+
+  /* The octet being read has been counted in line if it's a line feed,
+  ** but not in octet.
+  */
+
+  n = context->bytes_read - 1;
+  _count( context, n );
+  context->line = context->counted_line;
+  context->octet = context->counted_octet;
+
+  if( '\n' == context->lines[ n ] ) {
+    context->line++;
+    context->octet = 0;
+  }
+#endif
+}
+
 tTextLexErr textlex_default_overflow( tTextLexContext * context ) {
   tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexBuffer * mark = NULL;
+  tTextLexExtension * extension = EXTENSION;
+
+  /* In typed number mode, the digits are already being added up, so the
+  ** front of a long number's text can just be thrown away.
+  */
+
+  if( ( NULL != extension->number ) && ( context->state >= TEXTLEX_S_NUMBER ) && ( context->state <= TEXTLEX_S_HEX ) ) {
+    extension->digits.flags |= TEXTNUM_F_SPLIT;
+    context->index = 0;
+    return( err );
+  }
+
+  /* In decoded binary mode, what's in the buffer so far is decoded and the
+  ** few characters left over are kept at the front.
+  */
+
+  if( NULL != extension->decoded ) {
+    if( TEXTLEX_S_BASE64 == context->state ) {
+      return( _decode( context, TEXTLEX_T_BASE64, NULL, 1 ) );
+    } else if( TEXTLEX_S_BASE16_START == context->state ) {
+      return( _decode( context, TEXTLEX_T_HEX, NULL, 1 ) );
+    }
+  }
 
   switch( context->state ) {
   case TEXTLEX_S_COMMENT:
@@ -640,7 +1520,10 @@ tTextLexErr textlex_default_overflow( tTextLexContext * context ) {
     TOKEN( TEXTLEX_T_INTEGER );
     break;
     
+  case TEXTLEX_S_FLOAT_START:
   case TEXTLEX_S_FLOAT:
+  case TEXTLEX_S_EXPONENT_START:
+  case TEXTLEX_S_EXPONENT_NEG:
   case TEXTLEX_S_EXPONENT:
     TOKEN( TEXTLEX_T_FLOAT );
     break;
@@ -671,3 +1554,434 @@ tTextLexErr textlex_default_overflow( tTextLexContext * context ) {
   
   return( err );
 }
+
+tTextLexErr textlex_feed( tTextLexContext * context, tTextLexBuffer * data, tTextLexCount length ) {
+  tTextLexExtension * extension = context->extension;
+
+  if( NULL == extension ) {
+    return( TEXTLEX_E_ERROR );
+  }
+
+  context->token = _pull;
+  extension->input = data;
+  extension->remaining = length;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+tTextLexErr textlex_next( tTextLexContext * context, tTextLexToken * token ) {
+  tTextLexExtension * extension = context->extension;
+  tTextLexErr err;
+
+  if( NULL == extension ) {
+    return( TEXTLEX_E_ERROR );
+  }
+
+  if( extension->pulled_next >= extension->pulled_count ) {
+    extension->pulled_next = 0;
+    extension->pulled_count = 0;
+
+    if( 0 == extension->remaining ) {
+      return( TEXTLEX_E_MORE );
+    }
+
+    err = textlex_update( context, extension->input, extension->remaining );
+    extension->input += context->bytes_read;
+    extension->remaining -= context->bytes_read;
+
+    if( ( TEXTLEX_E_NOERR != err ) && ( TEXTLEX_E_YIELD != err ) ) {
+      return( err );
+    }
+
+    if( 0 == extension->pulled_count ) {
+      return( TEXTLEX_E_MORE );
+    }
+  }
+
+  * token = extension->pulled[ extension->pulled_next++ ];
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* _spill()
+**
+** Copies the marked span into the buffer, calling the overflow callback if
+** it fills up. Afterwards, the lexeme is being buffered like normal.
+*/
+
+static tTextLexErr _spill( tTextLexContext * context, tTextLexBuffer * mark ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexCount count = context->index;
+  tTextLexCount k;
+
+  context->index = 0;
+
+  for( k = 0; ( k < count ) && ( TEXTLEX_E_NOERR == err ); k++ ) {
+    context->buffer[ context->index++ ] = mark[ k ];
+    if( context->index >= context->size ) {
+      OVERFLOW;
+    }
+  }
+
+  return( err );
+}
+
+/* _flush()
+**
+** Sends the tokens written so far to the batch callback and empties the
+** array.
+*/
+
+static tTextLexErr _flush( tTextLexContext * context ) {
+  tTextLexExtension * extension = context->extension;
+  tTextLexCount count = extension->count;
+  tTextLexErr err;
+
+  extension->count = 0;
+  TIMED( err = extension->batch( context, extension->tokens, count ) );
+
+  return( err );
+}
+
+/* _pull()
+**
+** The token callback in pull mode. It saves the token for textlex_next()
+** and asks the lexxer to stop after this octet. There's only room for the
+** tokens one octet can end, so calling textlex_final() before
+** textlex_next() has handed them all out is an error.
+*/
+
+static tTextLexErr _pull( tTextLexContext * context, tTextLexCount token ) {
+  tTextLexExtension * extension = context->extension;
+  tTextLexToken * record;
+
+  if( extension->pulled_count >= TEXTLEX_C_PULLED ) {
+    return( TEXTLEX_E_ERROR );
+  }
+
+  POSITION;
+  record = & extension->pulled[ extension->pulled_count++ ];
+  record->token = token;
+  record->length = context->index;
+  record->line = context->line;
+  record->octet = context->octet;
+  record->data = context->buffer;
+
+  return( TEXTLEX_E_YIELD );
+}
+
+/* _number()
+**
+** Converts the number that just ended and sends it to the number callback,
+** then clears the digits for the next one. If the default overflow handler
+** threw away the front of the number, the converter doesn't get its text.
+*/
+
+static tTextLexErr _number( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * mark ) {
+  tTextLexExtension * extension = context->extension;
+  tTextLexErr err;
+  tTextNumValue value;
+  tTextLexBuffer * data = ( NULL != mark ) ? mark : context->buffer;
+  const unsigned char * text = ( 0 != ( extension->digits.flags & TEXTNUM_F_SPLIT ) ) ? NULL : data;
+
+  switch( token ) {
+  case TEXTLEX_T_INTEGER:
+    textnum_integer( & extension->digits, text, context->index, & value );
+    break;
+
+  case TEXTLEX_T_FLOAT:
+    textnum_float( & extension->digits, text, context->index, & value );
+    break;
+
+  default:
+    textnum_hex( & extension->digits, & value );
+    break;
+  }
+
+  memset( & extension->digits, 0, sizeof( tTextNumDigits ) );
+
+  if( ( NULL != extension->batch ) && ( extension->count > 0 ) && ( TEXTLEX_E_NOERR != ( err = _flush( context ) ) ) ) {
+    return( err );
+  }
+
+  TIMED( err = extension->number( context, token, & value, data, context->index ) );
+
+  return( err );
+}
+
+/* _decode()
+**
+** Decodes the base16 or base64 string that just ended (or the piece of it
+** in the buffer, when piece is 1) and sends the octets to the decoded
+** callback. Strings in the buffer are decoded in place; a marked string is
+** decoded into the buffer, a buffer full at a time. The characters at the
+** end of a piece that don't make a whole octet (or three) are moved to the
+** front of the buffer to wait for the rest.
+*/
+
+static tTextLexErr _decode( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * mark, int piece ) {
+  tTextLexExtension * extension = context->extension;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexBuffer * in = ( NULL != mark ) ? mark : context->buffer;
+  tTextLexBuffer * out = context->buffer;
+  tTextLexBuffer * pad;
+  tTextLexBuffer rest[ 3 ];
+  tTextLexCount length = context->index;
+  tTextLexCount group = ( TEXTLEX_T_HEX == token ) ? 2 : 4;
+  tTextLexCount octets = ( TEXTLEX_T_HEX == token ) ? 1 : 3;
+  tTextLexCount used = 0, made = 0, count, k;
+  unsigned long tail = 0;
+  int last = ( ! piece ) && ( 0 == ( extension->decoding & DECODE_BREAK ) );
+
+  if( ( NULL != extension->batch ) && ( extension->count > 0 ) && ( TEXTLEX_E_NOERR != ( err = _flush( context ) ) ) ) {
+    return( err );
+  }
+
+  if( 0 != ( extension->decoding & DECODE_PADDED ) ) {
+    length = 0;
+  } else if( ( TEXTLEX_T_BASE64 == token ) && ( NULL != ( pad = memchr( in, '=', length ) ) ) ) {
+    length = (tTextLexCount) ( pad - in );
+    extension->decoding |= DECODE_PADDED;
+  }
+
+  if( ( 0 != ( extension->decoding & DECODE_NIBBLE ) ) && ( length > 0 ) ) {
+    out[ made++ ] = (tTextLexBuffer) ( ( ( extension->decoding & 15 ) << 4 ) | NIBBLE( in[ 0 ] ) );
+    extension->decoding &= ~ ( DECODE_NIBBLE | 15 );
+    used = 1;
+  }
+
+  while( length - used >= group ) {
+    count = ( length - used ) / group;
+    if( ( NULL != mark ) && ( count > ( context->size - made ) / octets ) ) {
+      count = ( context->size - made ) / octets;
+    }
+    if( 0 == count ) {
+      TIMED( err = extension->decoded( context, token, out, made ) );
+      if( TEXTLEX_E_NOERR != err ) {
+        return( err );
+      }
+      made = 0;
+      continue;
+    }
+    made += (tTextLexCount) DECODE( token, & in[ used ], count * group, & out[ made ] );
+    used += count * group;
+  }
+
+  count = length - used;
+  memcpy( rest, & in[ used ], count );
+
+  if( TEXTLEX_T_HEX == token ) {
+    if( ( 1 == count ) && ( ! piece ) ) {
+      if( last ) {
+        return( TEXTLEX_E_BASE16_START );
+      }
+      extension->decoding |= DECODE_NIBBLE | NIBBLE( rest[ 0 ] );
+      count = 0;
+    }
+    if( last && ( 0 != ( extension->decoding & DECODE_NIBBLE ) ) ) {
+      return( TEXTLEX_E_BASE16_START );
+    }
+  } else if( ( count > 0 ) && ( last || ( 0 != ( extension->decoding & DECODE_PADDED ) ) ) ) {
+    if( 1 == count ) {
+      return( TEXTLEX_E_BASE64 );
+    }
+    for( k = 0; k < count; k++ ) {
+      tail = ( tail << 6 ) | SEXTET( rest[ k ] );
+    }
+    tail <<= 6 * ( 4 - count );
+    if( made + 2 > context->size ) {
+      TIMED( err = extension->decoded( context, token, out, made ) );
+      if( TEXTLEX_E_NOERR != err ) {
+        return( err );
+      }
+      made = 0;
+    }
+    out[ made++ ] = (tTextLexBuffer) ( tail >> 16 );
+    if( 3 == count ) {
+      out[ made++ ] = (tTextLexBuffer) ( tail >> 8 );
+    }
+    count = 0;
+  }
+
+  if( ( ! piece ) || ( made > 0 ) ) {
+    TIMED( err = extension->decoded( context, token, out, made ) );
+  }
+
+  if( piece ) {
+    memcpy( context->buffer, rest, count );
+    context->index = count;
+  } else if( last ) {
+    extension->decoding = 0;
+  } else {
+    extension->decoding &= ~ DECODE_BREAK;
+  }
+
+  return( err );
+}
+
+/* _record()
+**
+** Called for each token in record mode, after it's been delivered. Opens
+** and closes count depth, and the document ends when the last close comes
+** or when a value's TEXTLEX_T_END comes at the top level. The value ended
+** at the octet before this one if it's a number or literal (the octet that
+** ended it isn't part of it, and isn't there at all in textlex_final()),
+** or at this one if it's a string.
+*/
+
+static tTextLexErr _record( tTextLexContext * context, tTextLexCount token, tTextLexErr err ) {
+  tTextLexExtension * extension = context->extension;
+  unsigned long long end = extension->offset + context->bytes_read;
+  tTextLexCount last = extension->last;
+  tTextLexErr record_err;
+
+  extension->last = token;
+
+  switch( token ) {
+  case TEXTLEX_T_COMMENT:
+    return( err );
+
+  case TEXTLEX_T_END:
+    if( 0 != ( extension->framing & RECORD_BREAK ) ) {
+      extension->framing &= ~ RECORD_BREAK;
+      return( err );
+    }
+    if( ( 0 != extension->depth ) || ( last < TEXTLEX_T_LITERAL ) || ( last > TEXTLEX_T_BASE64 ) ) {
+      return( err );
+    }
+    if( ( context->state < TEXTLEX_S_STRING ) && ( context->bytes_read > 0 ) ) {
+      end--;
+    }
+    break;
+
+  case TEXTLEX_T_ARRAY_OPEN:
+  case TEXTLEX_T_MAP_OPEN:
+    extension->depth++;
+    extension->framing |= RECORD_OPEN;
+    return( err );
+
+  case TEXTLEX_T_ARRAY_CLOSE:
+  case TEXTLEX_T_MAP_CLOSE:
+    if( ( 0 == extension->depth ) || ( 0 != --extension->depth ) ) {
+      return( err );
+    }
+    break;
+
+  default:
+    extension->framing |= RECORD_OPEN;
+    return( err );
+  }
+
+  if( ( NULL != extension->batch ) && ( extension->count > 0 ) && ( TEXTLEX_E_NOERR != ( record_err = _flush( context ) ) ) ) {
+    return( record_err );
+  }
+
+  TIMED( record_err = extension->record( context, extension->record_start, end ) );
+  extension->framing &= ~ RECORD_OPEN;
+  extension->record_start = end;
+
+  return( ( TEXTLEX_E_NOERR != record_err ) ? record_err : err );
+}
+
+#ifdef TEXTLEX_LAZY_LINES
+
+/* _count()
+**
+** Counts the line feeds in the octets of the data passed to
+** textlex_update() between where it left off last time and n, leaving
+** counted_line and counted_octet where the eager lexxer would have had line
+** and octet after reading them. Every octet after a line feed counts, the
+** line feed included.
+*/
+
+static void _count( tTextLexContext * context, tTextLexCount n ) {
+  size_t after, feeds;
+  tTextLexCount length;
+
+  if( n <= context->counted ) {
+    return;
+  }
+
+  length = n - context->counted;
+  feeds = textscan_count( & context->lines[ context->counted ], length, '\n', & after );
+
+  if( 0 != feeds ) {
+    context->counted_line += (tTextLexCount) feeds;
+    context->counted_octet = length - (tTextLexCount) after + 1;
+  } else {
+    context->counted_octet += length;
+  }
+
+  context->counted = n;
+}
+
+#endif
+
+#ifdef TEXTLEX_NO_SCAN
+
+/* _scalar_decode()
+**
+** What textscan_hex() and textscan_base64() do, for when textscan.c isn't
+** there.
+*/
+
+static size_t _scalar_decode( tTextLexCount token, const tTextLexBuffer * data, size_t length, tTextLexBuffer * out ) {
+  size_t i, o = 0;
+  unsigned long quad;
+
+  if( TEXTLEX_T_HEX == token ) {
+    for( i = 0; i + 2 <= length; i += 2 ) {
+      out[ o++ ] = (tTextLexBuffer) ( ( NIBBLE( data[ i ] ) << 4 ) | NIBBLE( data[ i + 1 ] ) );
+    }
+  } else {
+    for( i = 0; i + 4 <= length; i += 4 ) {
+      quad = ( (unsigned long) SEXTET( data[ i ] ) << 18 ) | ( (unsigned long) SEXTET( data[ i + 1 ] ) << 12 ) |
+        ( (unsigned long) SEXTET( data[ i + 2 ] ) << 6 ) | (unsigned long) SEXTET( data[ i + 3 ] );
+      out[ o++ ] = (tTextLexBuffer) ( quad >> 16 );
+      out[ o++ ] = (tTextLexBuffer) ( quad >> 8 );
+      out[ o++ ] = (tTextLexBuffer) quad;
+    }
+  }
+
+  return( o );
+}
+
+#endif /* TEXTLEX_NO_SCAN */
+
+#ifdef TEXTLEX_DFA
+
+/* _digit()
+**
+** The table driven lexxer's version of INTEGER_DIGIT and friends. Which one
+** applies follows from the state the octet takes the lexxer to.
+*/
+
+static void _digit( tTextNumDigits * digits, tTextLexState next, unsigned char current ) {
+  switch( next ) {
+  case TEXTLEX_S_NUMBER:
+    if( '-' == current ) {
+      digits->flags |= TEXTNUM_F_NEGATIVE;
+    } else {
+      TEXTNUM_DIGIT( digits, current, 0 );
+    }
+    break;
+
+  case TEXTLEX_S_FLOAT:
+    TEXTNUM_DIGIT( digits, current, 1 );
+    break;
+
+  case TEXTLEX_S_EXPONENT_NEG:
+    digits->flags |= TEXTNUM_F_EXPONENT_NEG;
+    break;
+
+  case TEXTLEX_S_EXPONENT:
+    TEXTNUM_EXPONENT( digits, current );
+    break;
+
+  case TEXTLEX_S_HEX:
+    TEXTNUM_NIBBLE( digits, current );
+    break;
+  }
+}
+
+#endif /* TEXTLEX_DFA */
@@ -17,6 +17,8 @@
 #define TEXTLEX_E_NOERR           0 /* No Error */
 #define TEXTLEX_E_ERROR           1 /* Generic Internal Error */
 #define TEXTLEX_E_MEMORY          2 /* For use by the overflow callback */
+#define TEXTLEX_E_YIELD           3 /* Callback wants textlex_update() to stop */
+#define TEXTLEX_E_MORE            4 /* textlex_next() needs more input */
 
 /* Macro Definitions : Error Codes Associated with Parsing States */
 
@@ -32,6 +34,8 @@
 #define TEXTLEX_E_EXPONENT       74
 #define TEXTLEX_E_HEX            75
 #define TEXTLEX_E_STRING_ESCAPE  77
+#define TEXTLEX_E_BASE64         78
+#define TEXTLEX_E_BASE16_START   79
 #define TEXTLEX_E_BASE16_EOLLF   81
 
 /* Macro Definitions : Parser States */
@@ -56,6 +60,14 @@
 #define TEXTLEX_S_BASE16_COMMENT 16
 #define TEXTLEX_S_BASE16_EOLLF   17
 
+/* Macro Definitions : Pull Mode
+**
+** An octet ends at most one value, its END and a bracket, brace or equals,
+** so that's all textlex_next() ever has to hold.
+*/
+
+#define TEXTLEX_C_PULLED          3
+
 /* Macro Definitions : Token Types */
 
 #define TEXTLEX_C_TOKENS         14
@@ -74,13 +86,44 @@
 #define TEXTLEX_T_MAP_CLOSE      12
 #define TEXTLEX_T_EQUALS         13
 
+/* Macro Definitions : Token Mask
+**
+** Bits for the extension's wanted member (see Token Mask, below.)
+*/
+
+#define TEXTLEX_M( t )            ( 1u << ( t ) )
+#define TEXTLEX_M_ALL             ( TEXTLEX_M( TEXTLEX_C_TOKENS ) - 1 )
+
 /* These are the defaults for the types used in the API. If you want to change
 ** them, create a header file named "tltypes.h" that defines your preferred
 ** type definitions and compile textlex.c (and your application) with the
 ** -DTEXTLEX_TYPE_OVERRIDE command line option.
+**
+** Or compile textlex.c (and your application) with -DTEXTLEX_WIDTH=16, 32 or
+** 64 to pick the width of the counts, which is also the biggest lexeme, input
+** and line count the lexxer can keep track of. Its functions are renamed to
+** match (textlex16_init(), textlex64_update() and so on, see Width Prefixes,
+** below) so lexxers of different widths can be linked into the same program.
 */
 
-#ifndef TEXTLEX_TYPE_OVERRIDE
+#if defined( TEXTLEX_WIDTH )
+#  if 16 == TEXTLEX_WIDTH
+  typedef unsigned short      tTextLexErr;
+  typedef unsigned short      tTextLexState;
+  typedef unsigned short      tTextLexCount;
+#  elif 32 == TEXTLEX_WIDTH
+  typedef unsigned int        tTextLexErr;
+  typedef unsigned int        tTextLexState;
+  typedef unsigned int        tTextLexCount;
+#  elif 64 == TEXTLEX_WIDTH
+  typedef unsigned int        tTextLexErr;
+  typedef unsigned int        tTextLexState;
+  typedef unsigned long long  tTextLexCount;
+#  else
+#    error "TEXTLEX_WIDTH must be 16, 32 or 64"
+#  endif
+  typedef unsigned char       tTextLexBuffer;
+#elif ! defined( TEXTLEX_TYPE_OVERRIDE )
   typedef unsigned int    tTextLexErr;
   typedef unsigned int    tTextLexState;
   typedef unsigned int    tTextLexCount;
@@ -89,8 +132,106 @@
 #include "tltypes.h"
 #endif
 
+/* Macro Definitions : Width Prefixes
+**
+** With -DTEXTLEX_WIDTH, every function textlex.c exports gets the width in
+** its name. Code compiled with the same flag calls textlex_init() and the
+** rest as usual and gets the lexxer it was compiled for; a program that
+** wants more than one width keeps the code for each in its own file.
+** TEXTLEX_NAME( init ) is the real name of textlex_init(), if you need it.
+*/
+
+#ifdef TEXTLEX_WIDTH
+#define TEXTLEX_PASTE( width, name ) textlex##width##_##name
+#define TEXTLEX_EXPAND( width, name ) TEXTLEX_PASTE( width, name )
+#define TEXTLEX_NAME( name ) TEXTLEX_EXPAND( TEXTLEX_WIDTH, name )
+
+#define textlex_init              TEXTLEX_NAME( init )
+#define textlex_extend            TEXTLEX_NAME( extend )
+#define textlex_update            TEXTLEX_NAME( update )
+#define textlex_final             TEXTLEX_NAME( final )
+#define textlex_feed              TEXTLEX_NAME( feed )
+#define textlex_next              TEXTLEX_NAME( next )
+#define textlex_position          TEXTLEX_NAME( position )
+#define textlex_default_overflow  TEXTLEX_NAME( default_overflow )
+#else
+#define TEXTLEX_NAME( name ) textlex_##name
+#endif
+
+/* File Includes */
+
+#include "textnum.h"
+
 /* Structs, Typedefs, Unions & Enums */
 
+/* One token written by the lexxer in batch mode (or handed out by
+** textlex_next().) data and length are what the span callback would have
+** got; line and octet are where the lexxer was when it sent the token
+** (which is usually the octet after the lexeme.)
+*/
+
+typedef struct {
+  tTextLexCount    token;
+  tTextLexCount    length;
+  tTextLexCount    line;
+  tTextLexCount    octet;
+  tTextLexBuffer * data;
+} tTextLexToken;
+
+/* What the lexxer counts when it's compiled with -DTEXTLEX_STATS (see
+** Statistics, below.) octets counts the octets read in each state and
+** tokens the tokens sent of each type. longest is the longest lexeme,
+** counting the pieces sent to or thrown away by the overflow callback.
+** The ticks are from textstat_ticks() (see textstat.h): ticks is the time
+** spent in textlex_update() and textlex_final(), callback_ticks the part
+** of it spent in your callbacks and overflow_ticks the part spent in the
+** overflow callback (not counting any callbacks it made.)
+*/
+
+typedef struct {
+  unsigned long long octets[ TEXTLEX_C_STATES ];
+  unsigned long long tokens[ TEXTLEX_C_TOKENS ];
+  unsigned long long overflows;
+  unsigned long long longest;
+  unsigned long long carried;
+  unsigned long long ticks;
+  unsigned long long callback_ticks;
+  unsigned long long overflow_ticks;
+} tTextLexStats;
+
+/* The state the lexxer's optional modes need: span, typed number, decoded
+** binary, batch, pull and record mode and the token mask (see Extensions,
+** below.) A lexxer that only uses the token callback doesn't need one, so
+** it isn't part of the context; you allocate it and hand it to
+** textlex_extend(), and set the callbacks and the rest in it.
+*/
+
+struct _text_lex_context;
+
+typedef struct _text_lex_extension {
+  unsigned int     wanted;
+  tTextLexErr    (*span)( struct _text_lex_context * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+  tTextLexErr    (*number)( struct _text_lex_context * context, tTextLexCount token, tTextNumValue * value, tTextLexBuffer * data, tTextLexCount length );
+  tTextNumDigits   digits;
+  tTextLexErr    (*decoded)( struct _text_lex_context * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+  unsigned int     decoding;
+  tTextLexErr    (*batch)( struct _text_lex_context * context, tTextLexToken * tokens, tTextLexCount count );
+  tTextLexToken *  tokens;
+  tTextLexCount    capacity;
+  tTextLexCount    count;
+  tTextLexBuffer * input;
+  tTextLexCount    remaining;
+  tTextLexToken    pulled[ TEXTLEX_C_PULLED ];
+  tTextLexCount    pulled_count;
+  tTextLexCount    pulled_next;
+  tTextLexErr    (*record)( struct _text_lex_context * context, unsigned long long start, unsigned long long end );
+  unsigned long long offset;
+  unsigned long long record_start;
+  tTextLexCount    depth;
+  tTextLexCount    last;
+  unsigned int     framing;
+} tTextLexExtension;
+
 /* This is the lexxer's context structure. It gets initialized with a call to
 ** textlex_init() and updated with every call to textlex_update() and
 ** textlex_final(). You should probably treat this as an opaque data structure
@@ -107,6 +248,17 @@ typedef struct _text_lex_context {
   tTextLexCount    bytes_read;
   tTextLexErr    (*token)( struct _text_lex_context * context, tTextLexCount token );
   tTextLexErr    (*overflow)( struct _text_lex_context * context );
+  tTextLexExtension * extension;
+#ifdef TEXTLEX_STATS
+  tTextLexStats    stats;
+#endif
+#ifdef TEXTLEX_LAZY_LINES
+  unsigned long long offset;
+  tTextLexBuffer * lines;
+  tTextLexCount    counted;
+  tTextLexCount    counted_line;
+  tTextLexCount    counted_octet;
+#endif
 } tTextLexContext;
 
 /* Function Prototypes */
@@ -123,6 +275,16 @@ typedef struct _text_lex_context {
 
 tTextLexErr textlex_init( tTextLexContext * context, tTextLexBuffer * buffer, tTextLexCount size );
 
+/* textlex_extend()
+**
+** Clears the extension, sets its wanted member to TEXTLEX_M_ALL and hands
+** it to the context. Call it after textlex_init() (which forgets it) and
+** before you set anything in the extension. Like the buffer, it has to
+** last as long as the context does.
+*/
+
+tTextLexErr textlex_extend( tTextLexContext * context, tTextLexExtension * extension );
+
 /* textlex_update()
 **
 ** Pass a context, a pointer to DSD text to parse and the length of the text
@@ -136,7 +298,9 @@ tTextLexErr textlex_init( tTextLexContext * context, tTextLexBuffer * buffer, tT
 ** If the document parsed is well formed, this function *should* return a
 ** TEXTLEX_E_NOERR error code. If the document contains a syntax error, it
 ** will return an error code > 64, associated with the state the lexxer was
-** in when it encountered the error.
+** in when it encountered the error. If a callback returns an error, that's
+** what it returns, and no more callbacks are made, even for a token that
+** ends on the same octet (like the "]" in "1]".)
 */
 
 tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tTextLexCount length );
@@ -150,6 +314,38 @@ tTextLexErr textlex_update( tTextLexContext * context, tTextLexBuffer * data, tT
 
 tTextLexErr textlex_final( tTextLexContext * context );
 
+/* textlex_feed()
+**
+** Hands the lexxer the next piece of a document for textlex_next() to lex.
+** The data isn't copied, so it has to stay put until textlex_next() returns
+** TEXTLEX_E_MORE; then feed it the next piece (or call textlex_final() if
+** there isn't one.) This sets the token callback. The tokens are kept in
+** the extension, so it returns TEXTLEX_E_ERROR if the context hasn't got
+** one.
+*/
+
+tTextLexErr textlex_feed( tTextLexContext * context, tTextLexBuffer * data, tTextLexCount length );
+
+/* textlex_next()
+**
+** Lexes just far enough into the input passed to textlex_feed() to find the
+** next token and writes it into token. Returns TEXTLEX_E_NOERR if it found
+** one, TEXTLEX_E_MORE if it got to the end of the input first, or the error
+** textlex_update() would have returned. Like textlex_feed(), it returns
+** TEXTLEX_E_ERROR if the context hasn't got an extension.
+*/
+
+tTextLexErr textlex_next( tTextLexContext * context, tTextLexToken * token );
+
+/* textlex_position()
+**
+** Brings the context's line and octet up to date. Only a lexxer compiled
+** with -DTEXTLEX_LAZY_LINES ever needs this, and then only in a callback
+** (see Lazy Lines, below); otherwise it does nothing.
+*/
+
+void textlex_position( tTextLexContext * context );
+
 /* textlex_default_overflow()
 **
 ** This is the default overflow handler that's setup with the call to
@@ -161,4 +357,208 @@ tTextLexErr textlex_final( tTextLexContext * context );
 
 tTextLexErr textlex_default_overflow( tTextLexContext * context );
 
+/* Extensions
+**
+** The modes below all keep their callbacks and state in a
+** tTextLexExtension, so the context stays small for the lexxers that
+** don't use them (see the Width Prefixes above.) To use one, give the
+** context an extension and set the callback in that:
+**
+**   tTextLexContext context;
+**   tTextLexExtension extension;
+**
+**   textlex_init( & context, buffer, sizeof( buffer ) );
+**   textlex_extend( & context, & extension );
+**   extension.span = my_span_callback;
+**
+** Callbacks can get at it with context->extension. One extension can't be
+** shared between contexts.
+*/
+
+/* Zero-Copy Span Mode
+**
+** If you set the span callback (in the extension), the lexxer
+** calls it instead of the token callback. It gets the same sequence of
+** tokens, but each one comes with a pointer to the lexeme and its length.
+** When the lexeme is a contiguous run of octets entirely inside the data
+** passed to textlex_update(), the pointer points directly into that data and
+** nothing is copied into the buffer. Lexemes that straddle a call to
+** textlex_update(), strings containing a backslash escape and base16
+** strings with white space in them are copied into the buffer like normal,
+** and the pointer points at the buffer. TEXTLEX_T_END and the fixed length tokens
+** are passed a length of zero.
+**
+** Don't hang on to the pointer after the callback returns; it's only valid
+** until the next time the buffer or your input changes.
+*/
+
+/* Batch Mode
+**
+** If you point tokens at an array of capacity tTextLexTokens and set the
+** batch callback, the lexxer writes each token into the array instead of
+** calling the token or span callback, and calls the batch callback with
+** the tokens written so far when the array fills up and before
+** textlex_update() and textlex_final() return. The tokens are the same ones
+** the span callback would get, TEXTLEX_T_END included, and their data
+** pointers are good until the batch callback returns. A lexeme that had to
+** be copied into the buffer is sent (along with the tokens before it) as
+** soon as it's written, so the batch can be shorter than the array. The
+** number and decoded callbacks still get called as each value ends, after
+** the tokens before it have been sent. The parallel lexxer in textpar.c
+** doesn't batch tokens.
+*/
+
+/* Pull Mode
+**
+** Instead of having the lexxer call you, you can call it. Give the context
+** an extension, pass the input to textlex_feed() and call textlex_next()
+** for each token:
+**
+**   textlex_feed( & context, data, length );
+**   while( TEXTLEX_E_NOERR == ( err = textlex_next( & context, & token ) ) ) {
+**     ...
+**   }
+**
+** When it returns TEXTLEX_E_MORE, feed it the next piece of the document,
+** or call textlex_final() and then textlex_next() until it returns
+** TEXTLEX_E_MORE again to get the last token. The tokens are the ones the
+** token callback would get, in tTextLexTokens like batch mode's, with data
+** pointing into the buffer; it's good until textlex_next() hands out the
+** next token with a lexeme. Long lexemes come out in pieces with the
+** default overflow handler, like they do for the token callback.
+**
+** textlex_next() is built on TEXTLEX_E_YIELD. When the token (or overflow)
+** callback returns it, the lexxer finishes the octet it's on, including
+** any other tokens the octet ends, and textlex_update() returns
+** TEXTLEX_E_YIELD with bytes_read saying how much of the input it used. Call
+** textlex_update() with the rest to carry on. Pull mode doesn't mix with
+** the span, batch, number or decoded callbacks, and the parallel lexxer
+** in textpar.c doesn't yield.
+*/
+
+/* Typed Number Mode
+**
+** If you set the number callback, the lexxer adds up the digits of each
+** integer, float and hex ($) number while it's reading it and calls the
+** number callback instead of the token or span callback, passing the value
+** already converted (see tTextNumValue in textnum.h) along with the lexeme.
+** TEXTLEX_T_END still goes to the token or span callback, as do base16
+** strings, which are TEXTLEX_T_HEX tokens too. The value's overflow flag is
+** set for integers that don't fit in a long long, hex numbers longer than 64
+** bits and floats too big for a double.
+**
+** Numbers longer than the buffer are only a problem with the default
+** overflow handler, which throws away the front of the number's text (the
+** value is still right, but a float with more than 19 digits can be one
+** unit in the last place off, in which case value->inexact is set.) The
+** parallel lexxer in textpar.c doesn't add up digits; it delivers numbers
+** as text.
+*/
+
+/* Decoded Binary Mode
+**
+** If you set the decoded callback, base64 strings and base16 strings (the
+** TEXTLEX_T_BASE64 and TEXTLEX_T_HEX tokens that don't come from $ hex
+** numbers) are decoded to raw octets before they're delivered. The decoded
+** callback is called instead of the token or span callback, with the
+** octets in data. It's called at the same points the token callback would
+** have been: a base16 string with comments in it arrives in several pieces
+** (each followed by a TEXTLEX_T_END), and a hex digit left over before a
+** comment is held back and joined with the first digit after it. With the
+** default overflow handler, long strings arrive in pieces too, without a
+** TEXTLEX_T_END between them. The decoding uses the vector decoders in
+** textscan.c, and data points into the lexxer's buffer, which has to be at
+** least four octets long.
+**
+** Base64 decoding stops at the first '='. A base16 string with an odd
+** number of digits gets a TEXTLEX_E_BASE16_START error and a base64 string
+** whose length leaves a single character over gets TEXTLEX_E_BASE64. The
+** parallel lexxer in textpar.c delivers these strings undecoded.
+*/
+
+/* Record Mode
+**
+** A stream is often a lot of documents one after the other, each an
+** annotation or two and one top level value:
+**
+**   @m { "seq" = 1 ... } @m { "seq" = 2 ... } ...
+**
+** If you set the record callback, the lexxer keeps track of how deep it is
+** in arrays and maps and calls the record callback each time a top level
+** value ends: at the '}' or ']' that closes it, or at the TEXTLEX_T_END
+** after a top level string, number or literal. start and end are offsets
+** from the start of the stream (counting every octet passed to
+** textlex_update() since textlex_extend()); the document is the octets from
+** start up to but not including end. It starts at the first octet of its
+** first annotation or value and ends just after the last octet of its
+** value, so white space and comments between documents aren't in either.
+**
+** The record callback is called after the token, span or batch callback
+** (the batch is sent first) has seen the token that ends the document, so
+** you can hand the octets and whatever you built from the tokens to
+** another thread. If it returns an error, the lexxer stops like it does
+** for any other callback. The extension's offset is the number of octets
+** passed to earlier calls to textlex_update(), so a document that started
+** in the data you were just passed starts at data[ start - offset ].
+**
+** The lexxer doesn't check that the brackets match; a close bracket at the
+** top level is ignored. In pull mode the callback is called when the
+** lexxer gets to the end of the document, which can be before
+** textlex_next() has handed out its last tokens. The parallel lexxer in
+** textpar.c doesn't frame records.
+*/
+
+/* Token Mask
+**
+** textlex_extend() sets the extension's wanted member to TEXTLEX_M_ALL. Clear
+** the bits for the comments or annotations (or both) after that and the
+** lexxer skips over them without copying them into the buffer, calling
+** the overflow callback for long ones or sending them (or the
+** TEXTLEX_T_END after them) to any callback:
+**
+**   extension.wanted &= ~ ( TEXTLEX_M( TEXTLEX_T_COMMENT ) | TEXTLEX_M( TEXTLEX_T_ANNOTATION ) );
+**
+** They still have to be well formed. The bits for the other tokens are
+** ignored; everything else is always sent. The parallel lexxer in
+** textpar.c sends everything.
+*/
+
+/* Statistics
+**
+** Compile textlex.c (and everything that includes textlex.h) with
+** -DTEXTLEX_STATS and the context gets a stats member (a tTextLexStats)
+** that the lexxer keeps up to date as it goes: how many octets it read in
+** each state, how many tokens of each type it sent, how many times it
+** called the overflow callback and the longest lexeme it saw. It also
+** times itself, so you can tell how much of textlex_update() was the
+** lexxer and how much was your callbacks. Without -DTEXTLEX_STATS, none
+** of this is compiled in. textstat_write() in textstat.c writes the
+** statistics out as DSD/Text. The parallel lexxer in textpar.c doesn't
+** count the tokens it replays.
+*/
+
+/* Lazy Lines
+**
+** Normally the lexxer checks every octet for a line feed to keep line and
+** octet up to date. Compile textlex.c (and everything that includes
+** textlex.h) with -DTEXTLEX_LAZY_LINES and it doesn't: it only counts the
+** octets it reads, and counts the line feeds in the data passed to
+** textlex_update() with textscan_count() when it's done with it. After
+** textlex_update() or textlex_final() returns, line and octet are exactly
+** what they would have been, errors included. In a token, span or other
+** callback they're still where they were when textlex_update() was
+** called; call textlex_position() first if you want them. The lexxer does
+** that itself for every token in batch and pull mode, which costs about
+** as much as it saves. The parallel lexxer in textpar.c needs the line
+** numbers its workers see, so it has to be linked with a lexxer that
+** keeps them up to date as it goes.
+**
+** The context's offset is the number of octets read before the current
+** call to textlex_update() (or all of them, after textlex_final()). It's
+** 64 bits whatever the width of the other counts, so the octet being read
+** is offset + bytes_read - 1 from the start of the stream. line and octet
+** are only ever recounted over the data passed to one update, so they
+** don't need it.
+*/
+
 #endif /* _H_TEXTLEX */
@@ -0,0 +1,891 @@
+/* textlex.hpp
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file is a header-only C++17 front end to the DSD Text Lexxer. The C
+** lexxer in textlex.c calls its callbacks through function pointers in the
+** context, so the compiler can never see what they do. dsd::TextLexer takes
+** its handler as a template parameter instead, and the whole state machine
+** is here in the header, so each handler gets its own copy of the lexxer
+** with the handler's code inlined into it.
+**
+** The handler is any class with some of these members:
+**
+**   tTextLexErr on_comment( const tTextLexBuffer * data, tTextLexCount length );
+**   tTextLexErr on_annotation( ... );     same parameters as on_comment()
+**   tTextLexErr on_literal( ... );
+**   tTextLexErr on_integer( ... );
+**   tTextLexErr on_float( ... );
+**   tTextLexErr on_hex( ... );            $ hex numbers and base16 strings
+**   tTextLexErr on_string( ... );
+**   tTextLexErr on_base64( ... );
+**   tTextLexErr on_end();
+**   tTextLexErr on_array_open();
+**   tTextLexErr on_array_close();
+**   tTextLexErr on_map_open();
+**   tTextLexErr on_map_close();
+**   tTextLexErr on_equals();
+**
+** They get the same tokens, in the same order, as the C lexxer's span
+** callback with the default overflow handler: the lexeme points into the
+** input passed to update() when it can and into the buffer when it can't,
+** every variable length token is followed by on_end(), and lexemes longer
+** than the buffer come in pieces. If the handler leaves out one of the
+** variable length tokens, the lexxer doesn't keep track of its lexemes at
+** all and doesn't send the on_end() that would have followed it; leave out
+** on_comment() and comments are skipped over like white space. Returning
+** anything but TEXTLEX_E_NOERR stops the lexxer, like it does in C.
+**
+** The typed number, decoded binary and batch modes are C only; this lexxer
+** always hands over text. It uses the bulk scanner in textscan.c, so link
+** with textscan.o (or compile with -DTEXTLEX_NO_SCAN to do without.)
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_TEXTLEX_HPP
+#define _H_TEXTLEX_HPP
+
+/* File Includes */
+
+#include <cstring>
+#include <type_traits>
+#include <utility>
+
+extern "C" {
+#include "textlex.h"
+#ifndef TEXTLEX_NO_SCAN
+#include "textscan.h"
+#endif
+}
+
+/* Macro Definitions : Handler Detection
+**
+** TEXTLEXPP_HAS_VALUE( on_x ) and TEXTLEXPP_HAS_FIXED( on_x ) declare a
+** trait class has_on_x< H > that says whether H has a member named on_x
+** that takes a lexeme (or nothing.)
+*/
+
+#define TEXTLEXPP_HAS_VALUE( name ) \
+  template< class H, class = void > struct has_##name : std::false_type {}; \
+  template< class H > struct has_##name< H, std::void_t< decltype( std::declval< H & >().name( \
+    std::declval< const tTextLexBuffer * >(), std::declval< tTextLexCount >() ) ) > > : std::true_type {}
+
+#define TEXTLEXPP_HAS_FIXED( name ) \
+  template< class H, class = void > struct has_##name : std::false_type {}; \
+  template< class H > struct has_##name< H, std::void_t< decltype( std::declval< H & >().name() ) > > : std::true_type {}
+
+namespace dsd {
+
+namespace detail {
+
+TEXTLEXPP_HAS_VALUE( on_comment );
+TEXTLEXPP_HAS_VALUE( on_annotation );
+TEXTLEXPP_HAS_VALUE( on_literal );
+TEXTLEXPP_HAS_VALUE( on_integer );
+TEXTLEXPP_HAS_VALUE( on_float );
+TEXTLEXPP_HAS_VALUE( on_hex );
+TEXTLEXPP_HAS_VALUE( on_string );
+TEXTLEXPP_HAS_VALUE( on_base64 );
+TEXTLEXPP_HAS_FIXED( on_end );
+TEXTLEXPP_HAS_FIXED( on_array_open );
+TEXTLEXPP_HAS_FIXED( on_array_close );
+TEXTLEXPP_HAS_FIXED( on_map_open );
+TEXTLEXPP_HAS_FIXED( on_map_close );
+TEXTLEXPP_HAS_FIXED( on_equals );
+
+/* wants< H, T >::value is true if H has a member for token T. */
+
+template< class H, tTextLexCount T > struct wants : std::integral_constant< bool,
+  ( TEXTLEX_T_COMMENT == T ) ? has_on_comment< H >::value :
+  ( TEXTLEX_T_ANNOTATION == T ) ? has_on_annotation< H >::value :
+  ( TEXTLEX_T_LITERAL == T ) ? has_on_literal< H >::value :
+  ( TEXTLEX_T_INTEGER == T ) ? has_on_integer< H >::value :
+  ( TEXTLEX_T_FLOAT == T ) ? has_on_float< H >::value :
+  ( TEXTLEX_T_HEX == T ) ? has_on_hex< H >::value :
+  ( TEXTLEX_T_STRING == T ) ? has_on_string< H >::value :
+  ( TEXTLEX_T_BASE64 == T ) ? has_on_base64< H >::value :
+  ( TEXTLEX_T_END == T ) ? has_on_end< H >::value :
+  ( TEXTLEX_T_ARRAY_OPEN == T ) ? has_on_array_open< H >::value :
+  ( TEXTLEX_T_ARRAY_CLOSE == T ) ? has_on_array_close< H >::value :
+  ( TEXTLEX_T_MAP_OPEN == T ) ? has_on_map_open< H >::value :
+  ( TEXTLEX_T_MAP_CLOSE == T ) ? has_on_map_close< H >::value :
+  ( TEXTLEX_T_EQUALS == T ) ? has_on_equals< H >::value : false > {};
+
+} /* namespace detail */
+
+/* Structs, Typedefs, Unions & Enums */
+
+template< class Handler >
+class TextLexer {
+public:
+
+  /* Like textlex_init(), the lexxer doesn't allocate anything; pass it a
+  ** buffer of at least one octet that lives as long as it does.
+  */
+
+  TextLexer( Handler & handler, tTextLexBuffer * buffer, tTextLexCount size ) :
+    _handler( handler ), _buffer( buffer ), _size( size ), _index( 0 ), _state( TEXTLEX_S_START ), _line( 0 ), _octet( 0 ) {
+  }
+
+  tTextLexErr update( const tTextLexBuffer * data, tTextLexCount length );
+  tTextLexErr final();
+
+  tTextLexState state() const { return( _state ); }
+  tTextLexCount line() const { return( _line ); }
+  tTextLexCount octet() const { return( _octet ); }
+
+private:
+
+  template< tTextLexCount T > static constexpr bool _wants() { return( detail::wants< Handler, T >::value ); }
+
+  template< tTextLexCount T > tTextLexErr _send( const tTextLexBuffer * data, tTextLexCount length );
+  tTextLexErr _spill( const tTextLexBuffer * mark );
+  tTextLexErr _overflow();
+
+  Handler &        _handler;
+  tTextLexBuffer * _buffer;
+  tTextLexCount    _size;
+  tTextLexCount    _index;
+  tTextLexState    _state;
+  tTextLexCount    _line;
+  tTextLexCount    _octet;
+};
+
+/* Macro Definitions : State Machine
+**
+** These are the C lexxer's macros, less the modes this lexxer doesn't
+** have. The lexeme is always marked when it can be (as in span mode), and
+** KEEP( t ) is only true when the handler wants token t, so the lexemes of
+** tokens nobody wants are never marked or copied. An integer doesn't know
+** it's a float until it gets to the '.', so the two are kept together.
+*/
+
+#define TEXTLEXPP_KEEP( t ) ( ( ( TEXTLEX_T_INTEGER == t ) || ( TEXTLEX_T_FLOAT == t ) ) ? \
+    ( _wants< TEXTLEX_T_INTEGER >() || _wants< TEXTLEX_T_FLOAT >() ) : _wants< t >() )
+
+#define TEXTLEXPP_BUFFER_COPY _buffer[ _index++ ] = current; if( _index >= _size ) { err = _overflow(); }
+
+#define TEXTLEXPP_COPY( t ) if constexpr( TEXTLEXPP_KEEP( t ) ) { \
+    if( nullptr != mark ) { \
+      if( & data[ i ] == mark + _index ) { \
+        _index++; \
+      } else { \
+        err = _spill( mark ); \
+        mark = nullptr; \
+        TEXTLEXPP_BUFFER_COPY; \
+      } \
+    } else if( 0 == _index ) { \
+      mark = & data[ i ]; \
+      _index = 1; \
+    } else { \
+      TEXTLEXPP_BUFFER_COPY; \
+    } \
+  }
+
+#define TEXTLEXPP_TOKEN( t ) if( TEXTLEX_E_NOERR == err ) { \
+    err = _send< t >( ( nullptr != mark ) ? mark : _buffer, _index ); \
+  } \
+  mark = nullptr; \
+  _index = 0
+
+/* A variable length token and the TEXTLEX_T_END that follows it, which is
+** only sent if the token was.
+*/
+
+#define TEXTLEXPP_VALUE( t ) TEXTLEXPP_TOKEN( t ); \
+  if constexpr( _wants< t >() ) { TEXTLEXPP_TOKEN( TEXTLEX_T_END ); }
+
+#ifndef TEXTLEX_NO_SCAN
+#define TEXTLEXPP_SKIP_RUN( n ) run = n; \
+  i += (tTextLexCount) run; \
+  _octet += (tTextLexCount) run
+
+#define TEXTLEXPP_COPY_RUN( t, n ) if constexpr( TEXTLEXPP_KEEP( t ) ) { \
+    run = n; \
+    while( ( run > 0 ) && ( TEXTLEX_E_NOERR == err ) ) { \
+      if( ( nullptr == mark ) && ( 0 == _index ) ) { \
+        mark = & data[ i + 1 ]; \
+      } \
+      if( nullptr != mark ) { \
+        chunk = run; \
+      } else if( _index < _size ) { \
+        chunk = _size - _index; \
+        if( chunk > run ) { chunk = run; } \
+        std::memcpy( & _buffer[ _index ], & data[ i + 1 ], chunk ); \
+      } else { \
+        break; \
+      } \
+      _index += (tTextLexCount) chunk; \
+      i += (tTextLexCount) chunk; \
+      _octet += (tTextLexCount) chunk; \
+      run -= chunk; \
+      if( ( nullptr == mark ) && ( _index >= _size ) ) { err = _overflow(); } \
+    } \
+  } else { \
+    TEXTLEXPP_SKIP_RUN( n ); \
+  }
+#else
+#define TEXTLEXPP_SKIP_RUN( n )
+#define TEXTLEXPP_COPY_RUN( t, n )
+#endif
+
+#define TEXTLEXPP_DIGIT '0': \
+  case '1' : \
+  case '2' : \
+  case '3' : \
+  case '4' : \
+  case '5' : \
+  case '6' : \
+  case '7' : \
+  case '8' : \
+  case '9'
+
+#define TEXTLEXPP_HEXALPHA 'A' : \
+  case 'a' : \
+  case 'B' : \
+  case 'b' : \
+  case 'C' : \
+  case 'c' : \
+  case 'D' : \
+  case 'd' : \
+  case 'E' : \
+  case 'e' : \
+  case 'F' : \
+  case 'f'
+
+/* Letters are a range here; the C lexxer spells all 52 of them out. */
+
+#define TEXTLEXPP_ALPHA 'A' ... 'Z': \
+  case 'a' ... 'z'
+
+/* The octets that end a number, literal or annotation (see NONDEL() in
+** textlex.c.)
+*/
+
+#define TEXTLEXPP_NONDEL( t ) case ' ': \
+  case '\t': \
+  case '\n': \
+    TEXTLEXPP_VALUE( t ); \
+    _state = TEXTLEX_S_START; \
+    break; \
+\
+  case '\r': \
+    TEXTLEXPP_VALUE( t ); \
+    _state = TEXTLEX_S_EOLLF; \
+    break; \
+\
+  case '#': \
+    TEXTLEXPP_VALUE( t ); \
+    _state = TEXTLEX_S_COMMENT; \
+    break; \
+\
+  case '@': \
+    TEXTLEXPP_VALUE( t ); \
+    _state = TEXTLEX_S_ANNOTATE; \
+    break; \
+\
+  case '*': \
+    TEXTLEXPP_VALUE( t ); \
+    _state = TEXTLEX_S_LITERAL; \
+    break; \
+\
+  case '$': \
+    TEXTLEXPP_VALUE( t ); \
+    _state = TEXTLEX_S_HEX; \
+    break; \
+\
+  case '"': \
+    TEXTLEXPP_VALUE( t ); \
+    _state = TEXTLEX_S_STRING; \
+    break; \
+\
+  case '\'': \
+    TEXTLEXPP_VALUE( t ); \
+    _state = TEXTLEX_S_BASE64; \
+    break; \
+\
+  case '(': \
+    TEXTLEXPP_VALUE( t ); \
+    _state = TEXTLEX_S_BASE16_START; \
+    break; \
+\
+  case '[': \
+    TEXTLEXPP_VALUE( t ); \
+    TEXTLEXPP_TOKEN( TEXTLEX_T_ARRAY_OPEN ); \
+    _state = TEXTLEX_S_START; \
+    break; \
+\
+  case ']': \
+    TEXTLEXPP_VALUE( t ); \
+    TEXTLEXPP_TOKEN( TEXTLEX_T_ARRAY_CLOSE ); \
+    _state = TEXTLEX_S_START; \
+    break; \
+\
+  case '{': \
+    TEXTLEXPP_VALUE( t ); \
+    TEXTLEXPP_TOKEN( TEXTLEX_T_MAP_OPEN ); \
+    _state = TEXTLEX_S_START; \
+    break; \
+\
+  case '}': \
+    TEXTLEXPP_VALUE( t ); \
+    TEXTLEXPP_TOKEN( TEXTLEX_T_MAP_CLOSE ); \
+    _state = TEXTLEX_S_START; \
+    break; \
+\
+  case '=': \
+    TEXTLEXPP_VALUE( t ); \
+    TEXTLEXPP_TOKEN( TEXTLEX_T_EQUALS ); \
+    _state = TEXTLEX_S_START; \
+    break;
+
+/* Function Definitions */
+
+template< class Handler >
+tTextLexErr TextLexer< Handler >::update( const tTextLexBuffer * data, tTextLexCount length ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexCount i;
+  unsigned char current;
+  size_t run, chunk;
+  const tTextLexBuffer * mark = nullptr;
+
+  (void) run;
+  (void) chunk;
+
+  for( i = 0; i < length; i++ ) {
+    current = data[ i ];
+
+    if( '\n' == current ) {
+      _line++;
+      _octet = 0;
+    }
+
+    switch( _state ) {
+    case TEXTLEX_S_START:
+      switch( current ) {
+      case ' ':
+      case '\t':
+      case '\n':
+        TEXTLEXPP_SKIP_RUN( textscan_span2( & data[ i + 1 ], length - i - 1, ' ', '\t' ) );
+        break;
+
+      case '\r':
+        _state = TEXTLEX_S_EOLLF;
+        break;
+
+      case '#':
+        _state = TEXTLEX_S_COMMENT;
+        break;
+
+      case '@':
+        _state = TEXTLEX_S_ANNOTATE;
+        break;
+
+      case '*':
+        _state = TEXTLEX_S_LITERAL;
+        break;
+
+      case TEXTLEXPP_DIGIT:
+      case '-':
+        TEXTLEXPP_COPY( TEXTLEX_T_INTEGER );
+        _state = TEXTLEX_S_NUMBER;
+        break;
+
+      case '$':
+        _state = TEXTLEX_S_HEX;
+        break;
+
+      case '"':
+        _state = TEXTLEX_S_STRING;
+        break;
+
+      case '\'':
+        _state = TEXTLEX_S_BASE64;
+        break;
+
+      case '(':
+        _state = TEXTLEX_S_BASE16_START;
+        break;
+
+      case '[':
+        TEXTLEXPP_TOKEN( TEXTLEX_T_ARRAY_OPEN );
+        break;
+
+      case ']':
+        TEXTLEXPP_TOKEN( TEXTLEX_T_ARRAY_CLOSE );
+        break;
+
+      case '{':
+        TEXTLEXPP_TOKEN( TEXTLEX_T_MAP_OPEN );
+        break;
+
+      case '}':
+        TEXTLEXPP_TOKEN( TEXTLEX_T_MAP_CLOSE );
+        break;
+
+      case '=':
+        TEXTLEXPP_TOKEN( TEXTLEX_T_EQUALS );
+        break;
+
+      default:
+        err = TEXTLEX_E_START;
+        break;
+      }
+      break;
+
+    case TEXTLEX_S_EOLLF:
+      if( '\n' == current ) {
+        _state = TEXTLEX_S_START;
+      } else {
+        err = TEXTLEX_E_START;
+      }
+      break;
+
+    case TEXTLEX_S_COMMENT:
+      switch( current ) {
+      case '\n':
+        TEXTLEXPP_VALUE( TEXTLEX_T_COMMENT );
+        _state = TEXTLEX_S_START;
+        break;
+
+      case '\r':
+        TEXTLEXPP_VALUE( TEXTLEX_T_COMMENT );
+        _state = TEXTLEX_S_EOLLF;
+        break;
+
+      default:
+        TEXTLEXPP_COPY( TEXTLEX_T_COMMENT );
+        TEXTLEXPP_COPY_RUN( TEXTLEX_T_COMMENT, textscan_find2( & data[ i + 1 ], length - i - 1, '\n', '\r' ) );
+        break;
+      }
+      break;
+
+    case TEXTLEX_S_ANNOTATE:
+      switch( current ) {
+      case TEXTLEXPP_ALPHA:
+      case TEXTLEXPP_DIGIT:
+        TEXTLEXPP_COPY( TEXTLEX_T_ANNOTATION );
+        break;
+
+      TEXTLEXPP_NONDEL( TEXTLEX_T_ANNOTATION );
+
+      default:
+        err = TEXTLEX_E_ANNOTATE;
+        break;
+      }
+      break;
+
+    case TEXTLEX_S_LITERAL:
+      switch( current ) {
+      case TEXTLEXPP_ALPHA:
+        TEXTLEXPP_COPY( TEXTLEX_T_LITERAL );
+        break;
+
+      TEXTLEXPP_NONDEL( TEXTLEX_T_LITERAL );
+
+      default:
+        err = TEXTLEX_E_LITERAL;
+        break;
+      }
+      break;
+
+    case TEXTLEX_S_NUMBER:
+      switch( current ) {
+      case TEXTLEXPP_DIGIT:
+        TEXTLEXPP_COPY( TEXTLEX_T_INTEGER );
+        break;
+
+      case '.':
+        TEXTLEXPP_COPY( TEXTLEX_T_FLOAT );
+        _state = TEXTLEX_S_FLOAT_START;
+        break;
+
+      TEXTLEXPP_NONDEL( TEXTLEX_T_INTEGER );
+
+      default:
+        err = TEXTLEX_E_NUMBER;
+        break;
+      }
+      break;
+
+    case TEXTLEX_S_FLOAT_START:
+      switch( current ) {
+      case TEXTLEXPP_DIGIT:
+        TEXTLEXPP_COPY( TEXTLEX_T_FLOAT );
+        _state = TEXTLEX_S_FLOAT;
+        break;
+
+      default:
+        err = TEXTLEX_E_FLOAT_START;
+        break;
+      }
+      break;
+
+    case TEXTLEX_S_FLOAT:
+      switch( current ) {
+      case TEXTLEXPP_DIGIT:
+        TEXTLEXPP_COPY( TEXTLEX_T_FLOAT );
+        break;
+
+      case 'E':
+      case 'e':
+        TEXTLEXPP_COPY( TEXTLEX_T_FLOAT );
+        _state = TEXTLEX_S_EXPONENT_START;
+        break;
+
+      TEXTLEXPP_NONDEL( TEXTLEX_T_FLOAT );
+
+      default:
+        err = TEXTLEX_E_FLOAT;
+        break;
+      }
+      break;
+
+    case TEXTLEX_S_EXPONENT_START:
+      switch( current ) {
+      case '-':
+        TEXTLEXPP_COPY( TEXTLEX_T_FLOAT );
+        _state = TEXTLEX_S_EXPONENT_NEG;
+        break;
+
+      case TEXTLEXPP_DIGIT:
+        TEXTLEXPP_COPY( TEXTLEX_T_FLOAT );
+        _state = TEXTLEX_S_EXPONENT;
+        break;
+
+      default:
+        err = TEXTLEX_E_EXPONENT_START;
+        break;
+      }
+      break;
+
+    case TEXTLEX_S_EXPONENT_NEG:
+      switch( current ) {
+      case TEXTLEXPP_DIGIT:
+        TEXTLEXPP_COPY( TEXTLEX_T_FLOAT );
+        _state = TEXTLEX_S_EXPONENT;
+        break;
+
+      default:
+        err = TEXTLEX_E_EXPONENT_NEG;
+        break;
+      }
+      break;
+
+    case TEXTLEX_S_EXPONENT:
+      switch( current ) {
+      case TEXTLEXPP_DIGIT:
+        TEXTLEXPP_COPY( TEXTLEX_T_FLOAT );
+        break;
+
+      TEXTLEXPP_NONDEL( TEXTLEX_T_FLOAT );
+
+      default:
+        err = TEXTLEX_E_EXPONENT;
+        break;
+      }
+      break;
+
+    case TEXTLEX_S_HEX:
+      switch( current ) {
+      case TEXTLEXPP_DIGIT:
+      case TEXTLEXPP_HEXALPHA:
+        TEXTLEXPP_COPY( TEXTLEX_T_HEX );
+        break;
+
+      TEXTLEXPP_NONDEL( TEXTLEX_T_HEX );
+
+      default:
+        err = TEXTLEX_E_HEX;
+        break;
+      }
+      break;
+
+    case TEXTLEX_S_STRING:
+      switch( current ) {
+      case '\\':
+        _state = TEXTLEX_S_STRING_ESCAPE;
+        break;
+
+      case '"':
+        TEXTLEXPP_VALUE( TEXTLEX_T_STRING );
+        _state = TEXTLEX_S_START;
+        break;
+
+      default:
+        TEXTLEXPP_COPY( TEXTLEX_T_STRING );
+        TEXTLEXPP_COPY_RUN( TEXTLEX_T_STRING, textscan_find3( & data[ i + 1 ], length - i - 1, '"', '\\', '\n' ) );
+        break;
+      }
+      break;
+
+    case TEXTLEX_S_STRING_ESCAPE:
+      switch( current ) {
+      case '\\':
+      case '"':
+        TEXTLEXPP_COPY( TEXTLEX_T_STRING );
+        _state = TEXTLEX_S_STRING;
+        break;
+
+      default:
+        err = TEXTLEX_E_STRING_ESCAPE;
+        break;
+      }
+      break;
+
+    case TEXTLEX_S_BASE64:
+      switch( current ) {
+      case TEXTLEXPP_ALPHA:
+      case TEXTLEXPP_DIGIT:
+      case '+':
+      case '/':
+      case '=':
+        TEXTLEXPP_COPY( TEXTLEX_T_BASE64 );
+        break;
+
+      case '\'':
+        TEXTLEXPP_VALUE( TEXTLEX_T_BASE64 );
+        _state = TEXTLEX_S_START;
+        break;
+      }
+      break;
+
+    case TEXTLEX_S_BASE16_START:
+      switch( current ) {
+      case TEXTLEXPP_DIGIT:
+      case TEXTLEXPP_HEXALPHA:
+        TEXTLEXPP_COPY( TEXTLEX_T_HEX );
+        break;
+
+      case '#':
+        TEXTLEXPP_VALUE( TEXTLEX_T_HEX );
+        _state = TEXTLEX_S_BASE16_COMMENT;
+        break;
+
+      case ')':
+        TEXTLEXPP_VALUE( TEXTLEX_T_HEX );
+        _state = TEXTLEX_S_START;
+        break;
+      }
+      break;
+
+    case TEXTLEX_S_BASE16_COMMENT:
+      switch( current ) {
+      case '\n':
+        TEXTLEXPP_VALUE( TEXTLEX_T_COMMENT );
+        _state = TEXTLEX_S_BASE16_START;
+        break;
+
+      case '\r':
+        TEXTLEXPP_VALUE( TEXTLEX_T_COMMENT );
+        _state = TEXTLEX_S_BASE16_EOLLF;
+        break;
+
+      default:
+        TEXTLEXPP_COPY( TEXTLEX_T_COMMENT );
+        TEXTLEXPP_COPY_RUN( TEXTLEX_T_COMMENT, textscan_find2( & data[ i + 1 ], length - i - 1, '\n', '\r' ) );
+        break;
+      }
+      break;
+
+    case TEXTLEX_S_BASE16_EOLLF:
+      if( '\r' == current ) {
+        _state = TEXTLEX_S_BASE16_START;
+      } else {
+        err = TEXTLEX_E_BASE16_EOLLF;
+      }
+      break;
+    }
+
+    if( TEXTLEX_E_NOERR != err ) {
+      break;
+    }
+
+    _octet++;
+  }
+
+  if( nullptr != mark ) {
+    tTextLexErr spill_err = _spill( mark );
+    if( TEXTLEX_E_NOERR == err ) {
+      err = spill_err;
+    }
+  }
+
+  return( err );
+}
+
+template< class Handler >
+tTextLexErr TextLexer< Handler >::final() {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  const tTextLexBuffer * mark = nullptr;
+
+  switch( _state ) {
+  case TEXTLEX_S_COMMENT:
+    TEXTLEXPP_VALUE( TEXTLEX_T_COMMENT );
+    break;
+
+  case TEXTLEX_S_ANNOTATE:
+    TEXTLEXPP_VALUE( TEXTLEX_T_ANNOTATION );
+    break;
+
+  case TEXTLEX_S_LITERAL:
+    TEXTLEXPP_VALUE( TEXTLEX_T_LITERAL );
+    break;
+
+  case TEXTLEX_S_NUMBER:
+    TEXTLEXPP_VALUE( TEXTLEX_T_INTEGER );
+    break;
+
+  case TEXTLEX_S_FLOAT:
+  case TEXTLEX_S_EXPONENT:
+    TEXTLEXPP_VALUE( TEXTLEX_T_FLOAT );
+    break;
+
+  case TEXTLEX_S_HEX:
+    TEXTLEXPP_VALUE( TEXTLEX_T_HEX );
+    break;
+  }
+
+  return( err );
+}
+
+/* _send()
+**
+** Calls the handler's member for token T, if it has one.
+*/
+
+template< class Handler >
+template< tTextLexCount T >
+tTextLexErr TextLexer< Handler >::_send( const tTextLexBuffer * data, tTextLexCount length ) {
+  if constexpr( ! _wants< T >() ) {
+    return( TEXTLEX_E_NOERR );
+  } else if constexpr( TEXTLEX_T_COMMENT == T ) {
+    return( _handler.on_comment( data, length ) );
+  } else if constexpr( TEXTLEX_T_ANNOTATION == T ) {
+    return( _handler.on_annotation( data, length ) );
+  } else if constexpr( TEXTLEX_T_LITERAL == T ) {
+    return( _handler.on_literal( data, length ) );
+  } else if constexpr( TEXTLEX_T_INTEGER == T ) {
+    return( _handler.on_integer( data, length ) );
+  } else if constexpr( TEXTLEX_T_FLOAT == T ) {
+    return( _handler.on_float( data, length ) );
+  } else if constexpr( TEXTLEX_T_HEX == T ) {
+    return( _handler.on_hex( data, length ) );
+  } else if constexpr( TEXTLEX_T_STRING == T ) {
+    return( _handler.on_string( data, length ) );
+  } else if constexpr( TEXTLEX_T_BASE64 == T ) {
+    return( _handler.on_base64( data, length ) );
+  } else if constexpr( TEXTLEX_T_END == T ) {
+    return( _handler.on_end() );
+  } else if constexpr( TEXTLEX_T_ARRAY_OPEN == T ) {
+    return( _handler.on_array_open() );
+  } else if constexpr( TEXTLEX_T_ARRAY_CLOSE == T ) {
+    return( _handler.on_array_close() );
+  } else if constexpr( TEXTLEX_T_MAP_OPEN == T ) {
+    return( _handler.on_map_open() );
+  } else if constexpr( TEXTLEX_T_MAP_CLOSE == T ) {
+    return( _handler.on_map_close() );
+  } else {
+    return( _handler.on_equals() );
+  }
+}
+
+/* _spill()
+**
+** Copies the marked part of a lexeme into the buffer, like _spill() in
+** textlex.c.
+*/
+
+template< class Handler >
+tTextLexErr TextLexer< Handler >::_spill( const tTextLexBuffer * mark ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextLexCount count = _index;
+  tTextLexCount k;
+
+  _index = 0;
+
+  for( k = 0; ( k < count ) && ( TEXTLEX_E_NOERR == err ); k++ ) {
+    _buffer[ _index++ ] = mark[ k ];
+    if( _index >= _size ) {
+      err = _overflow();
+    }
+  }
+
+  return( err );
+}
+
+/* _overflow()
+**
+** Sends what's in the buffer as a piece of the lexeme it belongs to, like
+** textlex_default_overflow().
+*/
+
+template< class Handler >
+tTextLexErr TextLexer< Handler >::_overflow() {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+
+  switch( _state ) {
+  case TEXTLEX_S_COMMENT:
+  case TEXTLEX_S_BASE16_COMMENT:
+    err = _send< TEXTLEX_T_COMMENT >( _buffer, _index );
+    break;
+
+  case TEXTLEX_S_ANNOTATE:
+    err = _send< TEXTLEX_T_ANNOTATION >( _buffer, _index );
+    break;
+
+  case TEXTLEX_S_LITERAL:
+    err = _send< TEXTLEX_T_LITERAL >( _buffer, _index );
+    break;
+
+  case TEXTLEX_S_NUMBER:
+    err = _send< TEXTLEX_T_INTEGER >( _buffer, _index );
+    break;
+
+  case TEXTLEX_S_FLOAT_START:
+  case TEXTLEX_S_FLOAT:
+  case TEXTLEX_S_EXPONENT_START:
+  case TEXTLEX_S_EXPONENT_NEG:
+  case TEXTLEX_S_EXPONENT:
+    err = _send< TEXTLEX_T_FLOAT >( _buffer, _index );
+    break;
+
+  case TEXTLEX_S_HEX:
+  case TEXTLEX_S_BASE16_START:
+    err = _send< TEXTLEX_T_HEX >( _buffer, _index );
+    break;
+
+  case TEXTLEX_S_STRING:
+  case TEXTLEX_S_STRING_ESCAPE:
+    err = _send< TEXTLEX_T_STRING >( _buffer, _index );
+    break;
+
+  case TEXTLEX_S_BASE64:
+    err = _send< TEXTLEX_T_BASE64 >( _buffer, _index );
+    break;
+  }
+
+  _index = 0;
+
+  return( err );
+}
+
+} /* namespace dsd */
+
+#undef TEXTLEXPP_HAS_VALUE
+#undef TEXTLEXPP_HAS_FIXED
+#undef TEXTLEXPP_KEEP
+#undef TEXTLEXPP_BUFFER_COPY
+#undef TEXTLEXPP_COPY
+#undef TEXTLEXPP_TOKEN
+#undef TEXTLEXPP_VALUE
+#undef TEXTLEXPP_SKIP_RUN
+#undef TEXTLEXPP_COPY_RUN
+#undef TEXTLEXPP_DIGIT
+#undef TEXTLEXPP_HEXALPHA
+#undef TEXTLEXPP_ALPHA
+#undef TEXTLEXPP_NONDEL
+
+#endif /* _H_TEXTLEX_HPP */
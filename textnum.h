@@ -0,0 +1,187 @@
+/* textnum.h
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file provides the interface to the number converter implemented in
+** textnum.c. The lexxer uses it for its typed number mode (see textlex.h),
+** where it adds up the digits of integer, float and hex numbers while it's
+** reading them and turns them into a long long, unsigned long long or double
+** when the number ends, instead of leaving that to strtod() and friends.
+**
+** Floats are converted with the Eisel-Lemire algorithm: the (up to) 19
+** digit decimal mantissa is multiplied by a 128-bit approximation of the
+** right power of ten, which gives the correctly rounded double almost every
+** time. When it can't tell (because the product lands too close to halfway
+** between two doubles or the mantissa had more than 19 digits and they
+** disagree about which double it is) the text is handed to strtod().
+** Without the text, the digits past the 19th only count as a sticky bit
+** (see textnum_float()).
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_TEXTNUM
+#define _H_TEXTNUM
+
+/* How many significant digits fit in the mantissa. Digits after these are
+** dropped, but they're remembered with TEXTNUM_F_TRUNCATED if any of them
+** weren't zero.
+*/
+
+#define TEXTNUM_DIGITS           19
+
+/* Exponents and the scale stop growing once they get this big, which is
+** far past where doubles go to zero or infinity.
+*/
+
+#define TEXTNUM_SATURATE     100000
+
+/* The text textnum_integer_text() and textnum_float_text() write is never
+** longer than this.
+*/
+
+#define TEXTNUM_C_TEXT           32
+
+/* Macro Definitions : Flags */
+
+#define TEXTNUM_F_NEGATIVE        1 /* There was a leading '-' */
+#define TEXTNUM_F_EXPONENT_NEG    2 /* The exponent had a '-' */
+#define TEXTNUM_F_TRUNCATED       4 /* A non-zero digit didn't fit in the mantissa */
+#define TEXTNUM_F_HEX_OVERFLOW    8 /* A hex number had more than 16 digits */
+#define TEXTNUM_F_SPLIT          16 /* The text was delivered in pieces */
+
+/* Macro Definitions : Digit Accumulators
+**
+** These add one more character of a number to a tTextNumDigits. They're
+** macros so the lexxer's inner loop doesn't pay for a function call on
+** every digit. TEXTNUM_DIGIT() takes a decimal digit of the mantissa;
+** fraction is 1 after the decimal point and 0 before it.
+** TEXTNUM_EXPONENT() takes a digit of the exponent and TEXTNUM_NIBBLE() a
+** hex digit.
+*/
+
+#define TEXTNUM_DIGIT( d, c, fraction ) do { \
+    if( ( d )->count < TEXTNUM_DIGITS ) { \
+      ( d )->mantissa = ( d )->mantissa * 10 + ( ( c ) - '0' ); \
+      ( d )->count += ( 0 != ( d )->mantissa ); \
+      ( d )->scale -= ( fraction ); \
+    } else { \
+      if( '0' != ( c ) ) { ( d )->flags |= TEXTNUM_F_TRUNCATED; } \
+      if( ( 0 == ( fraction ) ) && ( ( d )->scale < TEXTNUM_SATURATE ) ) { ( d )->scale++; } \
+    } \
+  } while( 0 )
+
+#define TEXTNUM_EXPONENT( d, c ) do { \
+    if( ( d )->exponent < TEXTNUM_SATURATE ) { \
+      ( d )->exponent = ( d )->exponent * 10 + ( ( c ) - '0' ); \
+    } \
+  } while( 0 )
+
+#define TEXTNUM_NIBBLE( d, c ) do { \
+    if( 0 != ( ( d )->mantissa >> 60 ) ) { ( d )->flags |= TEXTNUM_F_HEX_OVERFLOW; } \
+    ( d )->mantissa = ( ( d )->mantissa << 4 ) | \
+      (unsigned int) ( ( ( c ) <= '9' ) ? ( ( c ) - '0' ) : ( ( ( c ) | 0x20 ) - 'a' + 10 ) ); \
+  } while( 0 )
+
+/* File Includes */
+
+#include <stddef.h>
+
+/* Structs, Typedefs, Unions & Enums */
+
+/* The digits of a number read so far. The value is mantissa times ten to
+** the power of scale plus (or minus) exponent; scale counts digits after the
+** decimal point (down) and digits that didn't fit in the mantissa (up.)
+** count is how many significant digits are in the mantissa; leading zeros
+** aren't counted. Hex numbers are shifted straight into the mantissa.
+** Zero it before the first digit.
+*/
+
+typedef struct {
+  unsigned long long    mantissa;
+  int                   scale;
+  unsigned int          count;
+  unsigned int          exponent;
+  unsigned int          flags;
+} tTextNumDigits;
+
+/* A converted number. Integers go in integer, hex numbers in natural and
+** every number, including those, goes in real (as near as a double gets.)
+** overflow is 1 if the number didn't fit: an integer outside the range of a
+** long long (integer is the nearest one that fits), a hex number longer
+** than 64 bits (natural is the biggest unsigned long long, and real matches
+** it) or a float too big for a double (real is an infinity.) inexact is 1
+** if real might be one unit in the last place off, which can only happen
+** when the text wasn't available (see textnum_float().)
+*/
+
+typedef struct {
+  long long             integer;
+  unsigned long long    natural;
+  double                real;
+  unsigned int          overflow;
+  unsigned int          inexact;
+} tTextNumValue;
+
+/* Function Prototypes */
+
+/* textnum_integer(), textnum_hex() and textnum_float()
+**
+** Turn the digits read so far into a value. text and length are the
+** number's text, which textnum_integer() and textnum_float() hand to strtod()
+** in the rare cases the fast path can't decide how to round. If the text
+** isn't available (because it was delivered in pieces) pass NULL. The
+** first 19 digits are converted on their own, along with whether any of
+** the digits after them weren't zero. That rounds correctly unless the
+** halfway point between two doubles falls strictly inside the digits
+** that were dropped; then real is the nearer guess, never more than one
+** unit in the last place off, and value->inexact is set.
+*/
+
+void textnum_integer( const tTextNumDigits * digits, const unsigned char * text, size_t length, tTextNumValue * value );
+void textnum_hex( const tTextNumDigits * digits, tTextNumValue * value );
+void textnum_float( const tTextNumDigits * digits, const unsigned char * text, size_t length, tTextNumValue * value );
+
+/* textnum_scan()
+**
+** Reads the digits of a number the lexxer has already checked, like the
+** lexeme of an INTEGER or FLOAT token (or a HEX token's, without the '$',
+** when hex is non-zero.) For when you've got the text but not the digits.
+*/
+
+void textnum_scan( tTextNumDigits * digits, const unsigned char * text, size_t length, int hex );
+
+/* textnum_eisel_lemire()
+**
+** Multiplies a decimal mantissa by ten to the power exp10 and puts the
+** correctly rounded double in result. Returns 0 if it couldn't be sure
+** how to round (or the result is subnormal), in which case result is left
+** alone. It's here for the benchmark and the tests.
+*/
+
+int textnum_eisel_lemire( unsigned long long mantissa, int exp10, int negative, double * result );
+
+/* textnum_integer_text()
+**
+** Writes the decimal text for an integer (with a leading minus sign if
+** negative is non-zero and magnitude isn't zero) into text, which must have
+** room for TEXTNUM_C_TEXT octets. Returns the length. This is the
+** text binlex and the DSD/Text writer produce for integers.
+*/
+
+size_t textnum_integer_text( unsigned long long magnitude, int negative, char * text );
+
+/* textnum_float_text()
+**
+** Writes the shortest decimal text that reads back as value into text
+** (which must have room for TEXTNUM_C_TEXT octets) and returns its
+** length, or zero if value is infinite or not a number. The text always has
+** a decimal point and at least one digit after it; values with a decimal
+** exponent outside -5 to 14 are written with an exponent (e.g. "1.5e-7".)
+** This is the text binlex and the DSD/Text writer produce for floats.
+*/
+
+size_t textnum_float_text( double value, char * text );
+
+#endif /* _H_TEXTNUM */
@@ -0,0 +1,638 @@
+/* textpar.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file implements the parallel DSD Text lexxer described in textpar.h.
+**
+** The document is cut into one chunk per thread, each starting just after a
+** line feed. Each worker thread lexes its chunk with an ordinary textlex
+** context, recording tokens (and copies of their lexemes) instead of
+** delivering them. Since we don't know what state the lexxer will be in at
+** the start of a chunk until the previous chunk has been lexed, each chunk is
+** lexed once from every state it could start in. The first of these, from
+** TEXTLEX_S_START, is the "primary" run and is always lexed to the end of the
+** chunk. The others are usually only needed for a line or two: as soon as one
+** of them is back in TEXTLEX_S_START with an empty buffer at the same point
+** the primary run was, the rest of its tokens would be the same as the
+** primary's, so it stops and remembers where it joined. If the primary run
+** ends in an error instead, the others are lexed to the end of the chunk.
+**
+** Once all the workers are done, the calling thread walks the chunks in
+** order, picks the run that started in the state the previous chunk ended in
+** and replays its tokens through the caller's context.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 200112L
+
+#define TEXTPAR_C_ENTRIES   4
+#define TEXTPAR_NO_JOIN     ( (size_t) -1 )
+#define TEXTPAR_MAX_UPDATE  ( 1024 * 1024 * 1024 )
+
+#define SPANNING( c ) ( ( NULL != ( c )->extension ) && ( NULL != ( c )->extension->span ) )
+
+/* File Includes */
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "textpar.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  unsigned char   token;
+  unsigned char   direct;
+  tTextLexCount   line;
+  tTextLexCount   octet;
+  tTextLexCount   length;
+  size_t          offset;
+} tTextParEvent;
+
+typedef struct {
+  size_t          offset;
+  size_t          events;
+} tTextParSync;
+
+/* The context has to be the first thing in a run so the callbacks can find
+** the rest of the run from the context pointer they're passed.
+*/
+
+typedef struct {
+  tTextLexContext context;
+  tTextLexExtension extension;
+  tTextLexBuffer * data;
+  size_t          length;
+  unsigned int    entry;
+  size_t          offset;
+  int             done;
+  int             failed;
+  tTextLexErr     err;
+  size_t          join;
+  size_t          cursor;
+  tTextParEvent * events;
+  size_t          count;
+  size_t          capacity;
+  unsigned char * bytes;
+  size_t          used;
+  size_t          space;
+  tTextParSync  * syncs;
+  size_t          sync_count;
+  size_t          sync_capacity;
+} tTextParRun;
+
+typedef struct {
+  tTextLexBuffer * data;
+  size_t          length;
+  tTextParRun     runs[ TEXTPAR_C_ENTRIES + 1 ];
+  unsigned int    run_count;
+  int             spanning;
+  pthread_t       thread;
+} tTextParChunk;
+
+/* Function Prototypes */
+
+static tTextLexErr _record( tTextLexContext * context, tTextLexCount token );
+static tTextLexErr _record_span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr _store( tTextParRun * run, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr _grow( tTextLexContext * context );
+static tTextParRun * _start( tTextParChunk * chunk, unsigned int entry );
+static void _advance( tTextParChunk * chunk, tTextParRun * run, size_t limit );
+static void * _worker( void * argument );
+static tTextLexErr _replay( tTextLexContext * context, tTextParRun * run, size_t first, tTextLexCount base_line, tTextLexCount base_octet );
+static tTextLexErr _copy( tTextLexContext * context, unsigned char * source, size_t length, unsigned int token, unsigned int state );
+static tTextLexErr _emit( tTextLexContext * context, unsigned int token );
+static void _free( tTextParChunk * chunk );
+
+/* Global Variables */
+
+static const unsigned int _entries[ TEXTPAR_C_ENTRIES ] = {
+  TEXTLEX_S_START,
+  TEXTLEX_S_STRING,
+  TEXTLEX_S_BASE64,
+  TEXTLEX_S_BASE16_START
+};
+
+/* Which state to put the caller's context in while a lexeme of a given token
+** type is being copied into its buffer. The default overflow handler uses
+** this to pick which token to send.
+*/
+
+static const unsigned char _token_state[ TEXTLEX_C_TOKENS ] = {
+  TEXTLEX_S_START,     /* END */
+  TEXTLEX_S_COMMENT,   /* COMMENT */
+  TEXTLEX_S_ANNOTATE,  /* ANNOTATION */
+  TEXTLEX_S_LITERAL,   /* LITERAL */
+  TEXTLEX_S_NUMBER,    /* INTEGER */
+  TEXTLEX_S_FLOAT,     /* FLOAT */
+  TEXTLEX_S_HEX,       /* HEX */
+  TEXTLEX_S_STRING,    /* STRING */
+  TEXTLEX_S_BASE64,    /* BASE64 */
+  TEXTLEX_S_START,     /* ARRAY_OPEN */
+  TEXTLEX_S_START,     /* ARRAY_CLOSE */
+  TEXTLEX_S_START,     /* MAP_OPEN */
+  TEXTLEX_S_START,     /* MAP_CLOSE */
+  TEXTLEX_S_START      /* EQUALS */
+};
+
+/* And the other way around, for a lexeme that's still being read at the end
+** of a chunk. Numbers only get here if the chunk ended in an error.
+*/
+
+static const unsigned char _pending[ TEXTLEX_C_STATES ] = {
+  TEXTLEX_T_END,       /* START */
+  TEXTLEX_T_END,       /* EOLLF */
+  TEXTLEX_T_COMMENT,   /* COMMENT */
+  TEXTLEX_T_ANNOTATION,/* ANNOTATE */
+  TEXTLEX_T_LITERAL,   /* LITERAL */
+  TEXTLEX_T_INTEGER,   /* NUMBER */
+  TEXTLEX_T_FLOAT,     /* FLOAT_START */
+  TEXTLEX_T_FLOAT,     /* FLOAT */
+  TEXTLEX_T_FLOAT,     /* EXPONENT_START */
+  TEXTLEX_T_FLOAT,     /* EXPONENT_NEG */
+  TEXTLEX_T_FLOAT,     /* EXPONENT */
+  TEXTLEX_T_HEX,       /* HEX */
+  TEXTLEX_T_STRING,    /* STRING */
+  TEXTLEX_T_STRING,    /* STRING_ESCAPE */
+  TEXTLEX_T_BASE64,    /* BASE64 */
+  TEXTLEX_T_HEX,       /* BASE16_START */
+  TEXTLEX_T_COMMENT,   /* BASE16_COMMENT */
+  TEXTLEX_T_HEX        /* BASE16_EOLLF */
+};
+
+/* Function Definitions */
+
+tTextLexErr textpar_update( tTextLexContext * context, tTextLexBuffer * data, size_t length, unsigned int threads ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextParChunk * chunks = NULL;
+  tTextParRun * run;
+  tTextParRun * last;
+  unsigned int count, i, j;
+  size_t offset, split, k, total;
+  tTextLexCount base_line, base_octet;
+  unsigned char * newline;
+
+  if( 0 == threads ) {
+    long online = sysconf( _SC_NPROCESSORS_ONLN );
+    threads = ( online > 0 ) ? (unsigned int) online : 1;
+  }
+
+  count = ( length / TEXTPAR_MIN_CHUNK < threads ) ? (unsigned int) ( length / TEXTPAR_MIN_CHUNK ) : threads;
+
+  /* Small documents (or a single thread) don't need any of this. */
+
+  if( count < 2 ) {
+    for( offset = 0, total = 0; ( offset < length ) && ( TEXTLEX_E_NOERR == err ); offset += k ) {
+      k = ( ( length - offset ) < TEXTPAR_MAX_UPDATE ) ? ( length - offset ) : TEXTPAR_MAX_UPDATE;
+      err = textlex_update( context, data + offset, (tTextLexCount) k );
+      total += context->bytes_read;
+    }
+    context->bytes_read = (tTextLexCount) total;
+    return( err );
+  }
+
+  do {
+    if( NULL == ( chunks = calloc( count, sizeof( tTextParChunk ) ) ) ) {
+      err = TEXTLEX_E_MEMORY;
+      break;
+    }
+
+    /* Find the chunk boundaries. Each one gets moved forward to just after
+    ** the next line feed. If there isn't one, the chunks run out early.
+    */
+
+    for( i = 0, offset = 0; ( i < count ) && ( offset < length ); i++ ) {
+      split = ( i + 1 == count ) ? length : ( length / count ) * ( i + 1 );
+      if( split < offset ) {
+        split = offset;
+      }
+      if( split < length ) {
+        newline = memchr( data + split, '\n', length - split );
+        split = ( NULL == newline ) ? length : (size_t) ( newline - data ) + 1;
+      }
+      chunks[ i ].data = data + offset;
+      chunks[ i ].length = split - offset;
+      chunks[ i ].spanning = SPANNING( context );
+      offset = split;
+    }
+    count = i;
+
+    for( i = 0; i < count; i++ ) {
+      for( j = 0; j < TEXTPAR_C_ENTRIES; j++ ) {
+        _start( & chunks[ i ], _entries[ j ] );
+      }
+    }
+
+    for( i = 1; i < count; i++ ) {
+      if( 0 != pthread_create( & chunks[ i ].thread, NULL, _worker, & chunks[ i ] ) ) {
+        /* No thread? We'll just lex it ourselves. */
+        chunks[ i ].thread = pthread_self();
+        _worker( & chunks[ i ] );
+      }
+    }
+
+    _worker( & chunks[ 0 ] );
+
+    for( i = 1; i < count; i++ ) {
+      if( ! pthread_equal( chunks[ i ].thread, pthread_self() ) ) {
+        pthread_join( chunks[ i ].thread, NULL );
+      }
+    }
+
+    /* Now stitch everything together, replaying each chunk's tokens through
+    ** the caller's context.
+    */
+
+    base_line = context->line;
+    base_octet = context->octet;
+
+    for( i = 0, total = 0; ( i < count ) && ( TEXTLEX_E_NOERR == err ); i++ ) {
+      for( run = NULL, j = 0; j < chunks[ i ].run_count; j++ ) {
+        if( chunks[ i ].runs[ j ].entry == context->state ) {
+          run = & chunks[ i ].runs[ j ];
+          break;
+        }
+      }
+
+      if( NULL == run ) {
+        run = _start( & chunks[ i ], context->state );
+      }
+
+      if( NULL == run ) {
+        err = TEXTLEX_E_MEMORY;
+        break;
+      }
+
+      _advance( & chunks[ i ], run, chunks[ i ].length );
+
+      /* A converged run's tokens are its own up to the point it joined the
+      ** primary run, and the primary's after that.
+      */
+
+      last = ( TEXTPAR_NO_JOIN == run->join ) ? run : & chunks[ i ].runs[ 0 ];
+
+      if( run->failed || last->failed ) {
+        err = TEXTLEX_E_MEMORY;
+        break;
+      }
+
+      err = _replay( context, run, 0, base_line, base_octet );
+
+      if( ( TEXTLEX_E_NOERR == err ) && ( last != run ) ) {
+        err = _replay( context, last, run->join, base_line, base_octet );
+      }
+
+      if( TEXTLEX_E_NOERR != err ) {
+        break;
+      }
+
+      /* Bring the caller's context up to where the chunk left off: the same
+      ** position, the same state and the same partial lexeme (if any.)
+      */
+
+      context->line = base_line + last->context.line;
+      context->octet = ( 0 == last->context.line ) ? base_octet + last->context.octet : last->context.octet;
+
+      /* In span mode, the lexxer spills a lexeme into the buffer all at once
+      ** when the input runs out, after it's reached its last state.
+      */
+
+      context->state = last->context.state;
+      err = _copy( context, last->context.buffer, last->context.index, SPANNING( context ) ? TEXTLEX_T_END : _pending[ context->state ], context->state );
+
+      if( ( TEXTLEX_E_NOERR == err ) && ( TEXTLEX_E_NOERR != last->err ) ) {
+        context->state = last->context.state;
+        context->bytes_read = (tTextLexCount) ( total + last->offset + last->context.bytes_read );
+        err = last->err;
+      }
+
+      if( TEXTLEX_E_NOERR != err ) {
+        break;
+      }
+
+      base_line = context->line;
+      base_octet = context->octet;
+      total += chunks[ i ].length;
+      context->bytes_read = (tTextLexCount) total;
+    }
+  } while( 0 );
+
+  if( NULL != chunks ) {
+    for( i = 0; i < count; i++ ) {
+      _free( & chunks[ i ] );
+    }
+    free( chunks );
+  }
+
+  return( err );
+}
+
+static void * _worker( void * argument ) {
+  tTextParChunk * chunk = (tTextParChunk *) argument;
+  size_t limit = TEXTPAR_SPECULATE;
+  unsigned int i;
+
+  _advance( chunk, & chunk->runs[ 0 ], chunk->length );
+
+  /* If the primary run stopped with an error, the chunk probably didn't
+  ** start in TEXTLEX_S_START (it started in the middle of a string, say.)
+  ** The other runs can't join it after the error, so the right one has to
+  ** be lexed to the end of the chunk; better here than on the calling
+  ** thread.
+  */
+
+  if( chunk->runs[ 0 ].failed || ( TEXTLEX_E_NOERR != chunk->runs[ 0 ].err ) ) {
+    limit = chunk->length;
+  }
+
+  for( i = 1; i < chunk->run_count; i++ ) {
+    _advance( chunk, & chunk->runs[ i ], limit );
+  }
+
+  return( NULL );
+}
+
+static tTextParRun * _start( tTextParChunk * chunk, unsigned int entry ) {
+  tTextParRun * run;
+  tTextLexBuffer * buffer;
+
+  if( chunk->run_count > TEXTPAR_C_ENTRIES ) {
+    return( NULL );
+  }
+
+  if( NULL == ( buffer = malloc( 256 ) ) ) {
+    return( NULL );
+  }
+
+  run = & chunk->runs[ chunk->run_count++ ];
+  memset( run, 0, sizeof( tTextParRun ) );
+  textlex_init( & run->context, buffer, 256 );
+  run->context.state = entry;
+  if( chunk->spanning ) {
+    textlex_extend( & run->context, & run->extension );
+    run->extension.span = _record_span;
+  } else {
+    run->context.token = _record;
+  }
+  run->context.overflow = _grow;
+  run->data = chunk->data;
+  run->length = chunk->length;
+  run->entry = entry;
+  run->join = TEXTPAR_NO_JOIN;
+
+  return( run );
+}
+
+static void _advance( tTextParChunk * chunk, tTextParRun * run, size_t limit ) {
+  tTextParRun * primary = & chunk->runs[ 0 ];
+  tTextParSync * syncs;
+  size_t end;
+  unsigned char * newline;
+  tTextLexErr err;
+
+  while( ( ! run->done ) && ( run->offset < limit ) ) {
+    end = run->offset + TEXTPAR_SEGMENT;
+    if( end >= chunk->length ) {
+      end = chunk->length;
+    } else {
+      newline = memchr( chunk->data + end, '\n', chunk->length - end );
+      end = ( NULL == newline ) ? chunk->length : (size_t) ( newline - chunk->data ) + 1;
+    }
+    if( end - run->offset > TEXTPAR_MAX_UPDATE ) {
+      end = run->offset + TEXTPAR_MAX_UPDATE;
+    }
+
+    err = textlex_update( & run->context, chunk->data + run->offset, (tTextLexCount) ( end - run->offset ) );
+
+    if( run->failed ) {
+      run->done = 1;
+      break;
+    }
+
+    if( TEXTLEX_E_NOERR != err ) {
+      run->err = err;
+      run->done = 1;
+      break;
+    }
+
+    run->offset = end;
+    run->context.bytes_read = 0;
+
+    if( end == chunk->length ) {
+      run->done = 1;
+      break;
+    }
+
+    if( ( '\n' != chunk->data[ end - 1 ] ) || ( TEXTLEX_S_START != run->context.state ) || ( 0 != run->context.index ) ) {
+      continue;
+    }
+
+    if( run == primary ) {
+      if( run->sync_count == run->sync_capacity ) {
+        run->sync_capacity = ( 0 == run->sync_capacity ) ? 64 : run->sync_capacity * 2;
+        if( NULL == ( syncs = realloc( run->syncs, run->sync_capacity * sizeof( tTextParSync ) ) ) ) {
+          run->failed = 1;
+          run->done = 1;
+          break;
+        }
+        run->syncs = syncs;
+      }
+      run->syncs[ run->sync_count ].offset = end;
+      run->syncs[ run->sync_count ].events = run->count;
+      run->sync_count++;
+    } else {
+      while( ( run->cursor < primary->sync_count ) && ( primary->syncs[ run->cursor ].offset < end ) ) {
+        run->cursor++;
+      }
+      if( ( run->cursor < primary->sync_count ) && ( primary->syncs[ run->cursor ].offset == end ) ) {
+        run->join = primary->syncs[ run->cursor ].events;
+        run->done = 1;
+      }
+    }
+  }
+}
+
+static tTextLexErr _record( tTextLexContext * context, tTextLexCount token ) {
+  return( _store( (tTextParRun *) context, token, context->buffer, context->index ) );
+}
+
+static tTextLexErr _record_span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  return( _store( (tTextParRun *) context, token, data, length ) );
+}
+
+/* _store()
+**
+** Adds a token to a run. Lexemes that are sitting in the chunk's input (which
+** only happens in span mode) are remembered by their offset; everything else
+** gets copied.
+*/
+
+static tTextLexErr _store( tTextParRun * run, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  tTextParEvent * events;
+  tTextParEvent * event;
+  unsigned char * bytes;
+  size_t space;
+
+  if( run->count == run->capacity ) {
+    run->capacity = ( 0 == run->capacity ) ? 1024 : run->capacity * 2;
+    if( NULL == ( events = realloc( run->events, run->capacity * sizeof( tTextParEvent ) ) ) ) {
+      run->failed = 1;
+      return( TEXTLEX_E_MEMORY );
+    }
+    run->events = events;
+  }
+
+  event = & run->events[ run->count++ ];
+  event->token = (unsigned char) token;
+  event->line = run->context.line;
+  event->octet = run->context.octet;
+  event->length = length;
+  event->direct = ( length > 0 ) && ( data >= run->data ) && ( data + length <= run->data + run->length );
+
+  if( event->direct ) {
+    event->offset = (size_t) ( data - run->data );
+    return( TEXTLEX_E_NOERR );
+  }
+
+  if( run->used + length > run->space ) {
+    for( space = ( 0 == run->space ) ? 16384 : run->space; space < run->used + length; space *= 2 ) {
+    }
+    if( NULL == ( bytes = realloc( run->bytes, space ) ) ) {
+      run->failed = 1;
+      return( TEXTLEX_E_MEMORY );
+    }
+    run->bytes = bytes;
+    run->space = space;
+  }
+
+  event->offset = run->used;
+  if( length > 0 ) {
+    memcpy( run->bytes + run->used, data, length );
+  }
+  run->used += length;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr _grow( tTextLexContext * context ) {
+  tTextParRun * run = (tTextParRun *) context;
+  tTextLexBuffer * buffer;
+
+  if( NULL == ( buffer = realloc( context->buffer, context->size * 2 ) ) ) {
+    run->failed = 1;
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  context->buffer = buffer;
+  context->size *= 2;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* _replay()
+**
+** Sends a run's recorded tokens, starting with the first'th, through the
+** caller's context. Line numbers in a run are relative to the start of its
+** chunk, as are octet numbers on the chunk's first line.
+*/
+
+static tTextLexErr _replay( tTextLexContext * context, tTextParRun * run, size_t first, tTextLexCount base_line, tTextLexCount base_octet ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  tTextParEvent * event;
+  size_t i;
+
+  for( i = first; ( i < run->count ) && ( TEXTLEX_E_NOERR == err ); i++ ) {
+    event = & run->events[ i ];
+    context->line = base_line + event->line;
+    context->octet = ( 0 == event->line ) ? base_octet + event->octet : event->octet;
+    if( event->direct && ( 0 == context->index ) ) {
+      err = context->extension->span( context, event->token, run->data + event->offset, event->length );
+      continue;
+    }
+    if( ( event->token > TEXTLEX_T_END ) && ( event->token < TEXTLEX_T_ARRAY_OPEN ) ) {
+      err = _copy( context, ( event->direct ? run->data : run->bytes ) + event->offset, event->length, event->token, _token_state[ event->token ] );
+    }
+    if( TEXTLEX_E_NOERR == err ) {
+      err = _emit( context, event->token );
+    }
+  }
+
+  return( err );
+}
+
+/* _copy()
+**
+** Copies a lexeme into the caller's buffer the way the lexxer would have,
+** calling the overflow callback each time the buffer fills up. The context
+** is put in the state the lexxer would have been in when it copied the
+** octet that filled the buffer.
+*/
+
+static tTextLexErr _copy( tTextLexContext * context, unsigned char * source, size_t length, unsigned int token, unsigned int state ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  unsigned char * dot = NULL;
+  size_t copied = 0;
+  size_t chunk;
+
+  if( TEXTLEX_T_FLOAT == token ) {
+    dot = memchr( source, '.', length );
+  }
+
+  while( ( copied < length ) && ( TEXTLEX_E_NOERR == err ) ) {
+    if( context->index >= context->size ) {
+      err = TEXTLEX_E_ERROR;
+      break;
+    }
+
+    chunk = context->size - context->index;
+    if( chunk > length - copied ) {
+      chunk = length - copied;
+    }
+
+    memcpy( context->buffer + context->index, source + copied, chunk );
+    context->index += chunk;
+    copied += chunk;
+
+    if( context->index >= context->size ) {
+      context->state = state;
+      if( ( ( TEXTLEX_T_INTEGER == token ) || ( TEXTLEX_T_FLOAT == token ) ) && ( 1 == copied ) ) {
+        context->state = TEXTLEX_S_START;
+      } else if( ( NULL != dot ) && ( source + copied - 1 <= dot ) ) {
+        context->state = TEXTLEX_S_NUMBER;
+      }
+      err = context->overflow( context );
+    }
+  }
+
+  return( err );
+}
+
+static tTextLexErr _emit( tTextLexContext * context, unsigned int token ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+
+  if( SPANNING( context ) ) {
+    err = context->extension->span( context, token, context->buffer, context->index );
+  } else if( NULL != context->token ) {
+    err = context->token( context, token );
+  }
+
+  context->index = 0;
+
+  return( err );
+}
+
+static void _free( tTextParChunk * chunk ) {
+  unsigned int i;
+  tTextParRun * run;
+
+  for( i = 0; i < chunk->run_count; i++ ) {
+    run = & chunk->runs[ i ];
+    free( run->context.buffer );
+    free( run->events );
+    free( run->bytes );
+    free( run->syncs );
+  }
+}
@@ -0,0 +1,73 @@
+/* textpar.h
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file provides the interface to the parallel DSD Text lexxer
+** implemented in textpar.c. It splits a complete, in-memory document into
+** chunks, lexes each chunk on its own thread and then feeds the tokens to
+** your callbacks in order, exactly as if textlex_update() had been called on
+** the whole document.
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_TEXTPAR
+#define _H_TEXTPAR
+
+/* Chunks are never smaller than this. Documents smaller than two chunks are
+** lexed on the calling thread with textlex_update().
+*/
+
+#define TEXTPAR_MIN_CHUNK   ( 64 * 1024 )
+
+/* Each chunk is lexed in segments of about this many octets. Segments end
+** right after a line feed, which is where a speculative run is checked to see
+** if it's rejoined the main one.
+*/
+
+#define TEXTPAR_SEGMENT     ( 16 * 1024 )
+
+/* A worker thread will lex this much of a chunk from each of the unlikely
+** starting states before giving up on it, unless lexing it from
+** TEXTLEX_S_START ended in an error, in which case it lexes all of it. If
+** it turns out one of them was the right one after all, it gets finished
+** off while the tokens are being delivered.
+*/
+
+#define TEXTPAR_SPECULATE   ( 256 * 1024 )
+
+/* File Includes */
+
+#include <stddef.h>
+#include "textlex.h"
+
+/* Function Prototypes */
+
+/* textpar_update()
+**
+** Lexes length octets of data using up to threads threads (pass zero to use
+** one per online CPU) and calls the token (or span) callback in context for
+** each token, in document order. The context should have been set up with
+** textlex_init() and its callbacks set, just like for textlex_update(), and
+** you should call textlex_final() afterwards.
+**
+** Chunks are split just after a line feed, so a chunk can only start in the
+** TEXTLEX_S_START, TEXTLEX_S_STRING, TEXTLEX_S_BASE64 or
+** TEXTLEX_S_BASE16_START states; a comment never survives a line feed. Each
+** chunk is lexed from all four. Once the state at the end of the previous
+** chunk is known, the matching token stream is picked, so you get the same
+** tokens, line and octet values and error codes you would have from a single
+** call to textlex_update(). Lexemes are copied into the context's buffer
+** before each call to the token callback and the overflow callback is called
+** when it fills up.
+**
+** Callbacks are only ever called from the thread that called this function.
+**
+** Returns TEXTLEX_E_MEMORY if it can't allocate memory for the worker
+** threads' token streams.
+*/
+
+tTextLexErr textpar_update( tTextLexContext * context, tTextLexBuffer * data, size_t length, unsigned int threads );
+
+#endif /* _H_TEXTPAR */
@@ -0,0 +1,144 @@
+/* textpull.hpp
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file is a C++20 coroutine front end to the lexxer's pull mode.
+** dsd::tokens() returns a generator of the tokens in a document, reading
+** the document a piece at a time from a reader you pass it:
+**
+**   auto stream = dsd::tokens( context, [&]() { return( next_piece() ); } );
+**
+**   for( const tTextLexToken & token : stream ) {
+**     ...
+**   }
+**
+**   if( TEXTLEX_E_NOERR != stream.error() ) { ... }
+**
+** The context has to have been set up with textlex_init() and
+** textlex_extend() and has to last as long as the generator (and so does
+** its extension.) The reader returns a std::span of the next
+** piece of the document, or an empty span when there isn't any more; the
+** piece has to stay put until the reader is called again. Each token's data
+** points into the lexxer's buffer, like it does for textlex_next().
+**
+** A recursive descent parser can hold on to the iterator instead, calling
+** ++ on it each time it wants another token, and keep its own state in
+** local variables instead of in a state machine.
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_TEXTPULL_HPP
+#define _H_TEXTPULL_HPP
+
+/* File Includes */
+
+#include <coroutine>
+#include <exception>
+#include <iterator>
+#include <span>
+#include <utility>
+
+extern "C" {
+#include "textlex.h"
+}
+
+namespace dsd {
+
+/* Structs, Typedefs, Unions & Enums */
+
+class TokenStream {
+public:
+
+  struct promise_type {
+    const tTextLexToken * current = nullptr;
+    tTextLexErr error = TEXTLEX_E_NOERR;
+
+    TokenStream get_return_object() { return( TokenStream( std::coroutine_handle< promise_type >::from_promise( * this ) ) ); }
+    std::suspend_always initial_suspend() noexcept { return( std::suspend_always() ); }
+    std::suspend_always final_suspend() noexcept { return( std::suspend_always() ); }
+    std::suspend_always yield_value( const tTextLexToken & token ) noexcept { current = & token; return( std::suspend_always() ); }
+    void return_value( tTextLexErr err ) noexcept { error = err; }
+    void unhandled_exception() { std::terminate(); }
+  };
+
+  class iterator {
+  public:
+    using iterator_category = std::input_iterator_tag;
+    using difference_type = std::ptrdiff_t;
+    using value_type = tTextLexToken;
+
+    iterator() = default;
+    explicit iterator( std::coroutine_handle< promise_type > handle ) : _handle( handle ) {}
+
+    const tTextLexToken & operator*() const { return( * _handle.promise().current ); }
+    const tTextLexToken * operator->() const { return( _handle.promise().current ); }
+    iterator & operator++() { _handle.resume(); return( * this ); }
+    void operator++( int ) { _handle.resume(); }
+    bool operator==( std::default_sentinel_t ) const { return( ( ! _handle ) || _handle.done() ); }
+
+  private:
+    std::coroutine_handle< promise_type > _handle;
+  };
+
+  explicit TokenStream( std::coroutine_handle< promise_type > handle ) : _handle( handle ) {}
+  TokenStream( TokenStream && other ) noexcept : _handle( std::exchange( other._handle, {} ) ) {}
+  TokenStream( const TokenStream & ) = delete;
+  TokenStream & operator=( const TokenStream & ) = delete;
+  ~TokenStream() { if( _handle ) { _handle.destroy(); } }
+
+  /* begin() runs the lexxer up to the first token, so call it once. */
+
+  iterator begin() { _handle.resume(); return( iterator( _handle ) ); }
+  std::default_sentinel_t end() { return( std::default_sentinel ); }
+
+  /* The error that stopped the lexxer, once the stream has ended. */
+
+  tTextLexErr error() const { return( _handle.promise().error ); }
+
+private:
+  std::coroutine_handle< promise_type > _handle;
+};
+
+/* Function Definitions */
+
+/* tokens()
+**
+** Feeds the lexxer what the reader returns and yields each token
+** textlex_next() finds, calling textlex_final() when the reader runs out.
+*/
+
+template< class Reader >
+TokenStream tokens( tTextLexContext & context, Reader reader ) {
+  tTextLexToken token;
+  tTextLexErr err;
+  bool finished = false;
+
+  while( true ) {
+    err = textlex_next( & context, & token );
+
+    if( TEXTLEX_E_NOERR == err ) {
+      co_yield token;
+    } else if( TEXTLEX_E_MORE != err ) {
+      co_return err;
+    } else if( finished ) {
+      co_return TEXTLEX_E_NOERR;
+    } else {
+      std::span< tTextLexBuffer > piece = reader();
+
+      if( piece.empty() ) {
+        finished = true;
+        if( TEXTLEX_E_NOERR != ( err = textlex_final( & context ) ) ) {
+          co_return err;
+        }
+      } else {
+        textlex_feed( & context, piece.data(), (tTextLexCount) piece.size() );
+      }
+    }
+  }
+}
+
+} /* namespace dsd */
+
+#endif /* _H_TEXTPULL_HPP */
@@ -0,0 +1,676 @@
+/* textscan.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file implements the bulk octet scanner described in textscan.h. There
+** are scalar, SSE2, AVX2 and NEON versions of each scan function. The one
+** that gets used is picked at run time the first time the scanner is called.
+** The base16 decoder has scalar, SSE2 and AVX2 versions and the base64
+** decoder scalar and AVX2 ones; the others fall back to the scalar decoders.
+**
+** Compile with -DTEXTSCAN_SCALAR_ONLY if your compiler chokes on the vector
+** intrinsics or you're building for a target without them.
+*/
+
+/* Macro Definitions */
+
+#if ! defined( TEXTSCAN_SCALAR_ONLY ) && defined( __GNUC__ ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+#define TEXTSCAN_X86
+#endif
+
+#if ! defined( TEXTSCAN_SCALAR_ONLY ) && ( defined( __ARM_NEON ) || defined( __ARM_NEON__ ) )
+#define TEXTSCAN_NEON
+#endif
+
+/* textscan_select() can run on one thread while another is scanning, so
+** the pointer to the selected implementation is read and written
+** atomically where the compiler can do it.
+*/
+
+#ifdef __GNUC__
+#define LOAD_OPS() __atomic_load_n( & _ops, __ATOMIC_ACQUIRE )
+#define STORE_OPS( x ) __atomic_store_n( & _ops, ( x ), __ATOMIC_RELEASE )
+#else
+#define LOAD_OPS() _ops
+#define STORE_OPS( x ) _ops = ( x )
+#endif
+
+/* File Includes */
+
+#include <string.h>
+#include "textscan.h"
+
+#ifdef TEXTSCAN_X86
+#include <immintrin.h>
+#endif
+
+#ifdef TEXTSCAN_NEON
+#include <arm_neon.h>
+#endif
+
+/* Macro Definitions : Decoding
+**
+** The value of a hex digit or base64 character that's already been checked.
+** Or'ing in 0x20 makes 'A' through 'F' lower case without touching digits.
+*/
+
+#define NIBBLE( c ) ( ( ( c ) <= '9' ) ? ( ( c ) - '0' ) : ( ( ( c ) | 0x20 ) - 'a' + 10 ) )
+#define SEXTET( c ) ( ( ( c ) >= 'a' ) ? ( ( c ) - 71 ) : ( ( c ) >= 'A' ) ? ( ( c ) - 65 ) : \
+    ( ( c ) >= '0' ) ? ( ( c ) + 4 ) : ( '+' == ( c ) ) ? 62 : 63 )
+
+/* Macro Definitions : AVX2
+**
+** Below this many octets the AVX2 versions hand the whole job to the scalar
+** ones. Setting up the 256 bit constants and clearing the upper halves of
+** the registers on the way out costs more than a short scan. Each AVX2
+** version issues vzeroupper before it returns or falls back to code that
+** wasn't compiled for AVX2, so the SSE2 and scalar code after it doesn't
+** pay for the transition.
+*/
+
+#ifndef TEXTSCAN_AVX2_MIN
+#define TEXTSCAN_AVX2_MIN 32
+#endif
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef struct {
+  unsigned int isa;
+  size_t    (*find2)( const unsigned char * data, size_t length, unsigned char a, unsigned char b );
+  size_t    (*find3)( const unsigned char * data, size_t length, unsigned char a, unsigned char b, unsigned char c );
+  size_t    (*span2)( const unsigned char * data, size_t length, unsigned char a, unsigned char b );
+  size_t    (*count)( const unsigned char * data, size_t length, unsigned char a, size_t * after );
+  size_t    (*hex)( const unsigned char * data, size_t length, unsigned char * out );
+  size_t    (*base64)( const unsigned char * data, size_t length, unsigned char * out );
+} tTextScanOps;
+
+/* Function Definitions : Scalar */
+
+static size_t _scalar_find2( const unsigned char * data, size_t length, unsigned char a, unsigned char b ) {
+  size_t i;
+
+  for( i = 0; i < length; i++ ) {
+    if( ( a == data[ i ] ) || ( b == data[ i ] ) ) {
+      break;
+    }
+  }
+
+  return( i );
+}
+
+static size_t _scalar_find3( const unsigned char * data, size_t length, unsigned char a, unsigned char b, unsigned char c ) {
+  size_t i;
+
+  for( i = 0; i < length; i++ ) {
+    if( ( a == data[ i ] ) || ( b == data[ i ] ) || ( c == data[ i ] ) ) {
+      break;
+    }
+  }
+
+  return( i );
+}
+
+static size_t _scalar_span2( const unsigned char * data, size_t length, unsigned char a, unsigned char b ) {
+  size_t i;
+
+  for( i = 0; i < length; i++ ) {
+    if( ( a != data[ i ] ) && ( b != data[ i ] ) ) {
+      break;
+    }
+  }
+
+  return( i );
+}
+
+/* The count functions only touch after when they find something, so the
+** vector versions can hand their leftovers to the scalar one. Even the
+** scalar one does eight octets at a time: or'ing the low seven bits of
+** each octet (less a) into its high bit leaves the high bit clear only in
+** the ones equal to a, and multiplying the clear bits down adds them up.
+*/
+
+static size_t _scalar_count( const unsigned char * data, size_t length, unsigned char a, size_t * after ) {
+  const unsigned long long ones = 0x0101010101010101ULL;
+  const unsigned long long low = 0x7F7F7F7F7F7F7F7FULL;
+  unsigned long long word;
+  size_t i = 0, count = 0;
+
+  for( ; i + 8 <= length; i += 8 ) {
+    memcpy( & word, data + i, 8 );
+    word ^= ones * a;
+    word = ~ ( ( ( word & low ) + low ) | word ) & ~ low;
+    count += (size_t) ( ( ( word >> 7 ) * ones ) >> 56 );
+  }
+
+  for( ; i < length; i++ ) {
+    count += ( a == data[ i ] );
+  }
+
+  for( i = length; ( i > 0 ) && ( 0 != count ); i-- ) {
+    if( a == data[ i - 1 ] ) {
+      * after = i;
+      break;
+    }
+  }
+
+  return( count );
+}
+
+static size_t _scalar_hex( const unsigned char * data, size_t length, unsigned char * out ) {
+  size_t i;
+
+  for( i = 0; i + 2 <= length; i += 2 ) {
+    out[ i >> 1 ] = (unsigned char) ( ( NIBBLE( data[ i ] ) << 4 ) | NIBBLE( data[ i + 1 ] ) );
+  }
+
+  return( length >> 1 );
+}
+
+static size_t _scalar_base64( const unsigned char * data, size_t length, unsigned char * out ) {
+  size_t i, o = 0;
+  unsigned long quad;
+
+  for( i = 0; i + 4 <= length; i += 4 ) {
+    quad = ( (unsigned long) SEXTET( data[ i ] ) << 18 ) | ( (unsigned long) SEXTET( data[ i + 1 ] ) << 12 ) |
+      ( (unsigned long) SEXTET( data[ i + 2 ] ) << 6 ) | (unsigned long) SEXTET( data[ i + 3 ] );
+    out[ o++ ] = (unsigned char) ( quad >> 16 );
+    out[ o++ ] = (unsigned char) ( quad >> 8 );
+    out[ o++ ] = (unsigned char) quad;
+  }
+
+  return( o );
+}
+
+static const tTextScanOps _scalar_ops = {
+  TEXTSCAN_ISA_SCALAR, _scalar_find2, _scalar_find3, _scalar_span2, _scalar_count, _scalar_hex, _scalar_base64
+};
+
+/* Function Definitions : SSE2 & AVX2 */
+
+#ifdef TEXTSCAN_X86
+
+__attribute__(( target( "sse2" ) ))
+static size_t _sse2_find2( const unsigned char * data, size_t length, unsigned char a, unsigned char b ) {
+  size_t i = 0;
+  int mask;
+  __m128i v;
+  __m128i va = _mm_set1_epi8( (char) a );
+  __m128i vb = _mm_set1_epi8( (char) b );
+
+  for( ; i + 16 <= length; i += 16 ) {
+    v = _mm_loadu_si128( (const __m128i *) ( data + i ) );
+    mask = _mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( v, va ), _mm_cmpeq_epi8( v, vb ) ) );
+    if( 0 != mask ) {
+      return( i + __builtin_ctz( mask ) );
+    }
+  }
+
+  return( i + _scalar_find2( data + i, length - i, a, b ) );
+}
+
+__attribute__(( target( "sse2" ) ))
+static size_t _sse2_find3( const unsigned char * data, size_t length, unsigned char a, unsigned char b, unsigned char c ) {
+  size_t i = 0;
+  int mask;
+  __m128i v;
+  __m128i va = _mm_set1_epi8( (char) a );
+  __m128i vb = _mm_set1_epi8( (char) b );
+  __m128i vc = _mm_set1_epi8( (char) c );
+
+  for( ; i + 16 <= length; i += 16 ) {
+    v = _mm_loadu_si128( (const __m128i *) ( data + i ) );
+    mask = _mm_movemask_epi8( _mm_or_si128( _mm_or_si128( _mm_cmpeq_epi8( v, va ), _mm_cmpeq_epi8( v, vb ) ),
+                                            _mm_cmpeq_epi8( v, vc ) ) );
+    if( 0 != mask ) {
+      return( i + __builtin_ctz( mask ) );
+    }
+  }
+
+  return( i + _scalar_find3( data + i, length - i, a, b, c ) );
+}
+
+__attribute__(( target( "sse2" ) ))
+static size_t _sse2_span2( const unsigned char * data, size_t length, unsigned char a, unsigned char b ) {
+  size_t i = 0;
+  int mask;
+  __m128i v;
+  __m128i va = _mm_set1_epi8( (char) a );
+  __m128i vb = _mm_set1_epi8( (char) b );
+
+  for( ; i + 16 <= length; i += 16 ) {
+    v = _mm_loadu_si128( (const __m128i *) ( data + i ) );
+    mask = 0xFFFF & ~ _mm_movemask_epi8( _mm_or_si128( _mm_cmpeq_epi8( v, va ), _mm_cmpeq_epi8( v, vb ) ) );
+    if( 0 != mask ) {
+      return( i + __builtin_ctz( mask ) );
+    }
+  }
+
+  return( i + _scalar_span2( data + i, length - i, a, b ) );
+}
+
+__attribute__(( target( "sse2" ) ))
+static size_t _sse2_count( const unsigned char * data, size_t length, unsigned char a, size_t * after ) {
+  size_t i = 0, count = 0, tail = 0;
+  unsigned int mask;
+  __m128i va = _mm_set1_epi8( (char) a );
+
+  for( ; i + 16 <= length; i += 16 ) {
+    mask = (unsigned int) _mm_movemask_epi8( _mm_cmpeq_epi8( _mm_loadu_si128( (const __m128i *) ( data + i ) ), va ) );
+    if( 0 != mask ) {
+      count += (size_t) __builtin_popcount( mask );
+      * after = i + 32 - (size_t) __builtin_clz( mask );
+    }
+  }
+
+  if( 0 != length - i ) {
+    count += _scalar_count( data + i, length - i, a, & tail );
+    if( 0 != tail ) {
+      * after = i + tail;
+    }
+  }
+
+  return( count );
+}
+
+/* Sixteen hex digits at a time: lower case them, subtract '0' and another
+** 39 from the letters, then glue each pair of nibbles together in a 16 bit
+** lane and pack the lanes down to octets.
+*/
+
+__attribute__(( target( "sse2" ) ))
+static size_t _sse2_hex( const unsigned char * data, size_t length, unsigned char * out ) {
+  size_t i = 0;
+  __m128i v;
+  __m128i lower = _mm_set1_epi8( 0x20 );
+  __m128i nine = _mm_set1_epi8( '9' );
+  __m128i zero = _mm_set1_epi8( '0' );
+  __m128i gap = _mm_set1_epi8( 'a' - '0' - 10 );
+  __m128i low = _mm_set1_epi16( 0x00FF );
+
+  for( ; i + 16 <= length; i += 16 ) {
+    v = _mm_or_si128( _mm_loadu_si128( (const __m128i *) ( data + i ) ), lower );
+    v = _mm_sub_epi8( _mm_sub_epi8( v, zero ), _mm_and_si128( _mm_cmpgt_epi8( v, nine ), gap ) );
+    v = _mm_or_si128( _mm_slli_epi16( _mm_and_si128( v, low ), 4 ), _mm_srli_epi16( v, 8 ) );
+    _mm_storel_epi64( (__m128i *) ( out + ( i >> 1 ) ), _mm_packus_epi16( v, v ) );
+  }
+
+  return( ( i >> 1 ) + _scalar_hex( data + i, length - i, out + ( i >> 1 ) ) );
+}
+
+static const tTextScanOps _sse2_ops = {
+  TEXTSCAN_ISA_SSE2, _sse2_find2, _sse2_find3, _sse2_span2, _sse2_count, _sse2_hex, _scalar_base64
+};
+
+__attribute__(( target( "avx2" ) ))
+static size_t _avx2_find2( const unsigned char * data, size_t length, unsigned char a, unsigned char b ) {
+  size_t i = 0;
+  unsigned int mask;
+  __m256i v, va, vb;
+
+  if( length < TEXTSCAN_AVX2_MIN ) {
+    return( _scalar_find2( data, length, a, b ) );
+  }
+
+  va = _mm256_set1_epi8( (char) a );
+  vb = _mm256_set1_epi8( (char) b );
+
+  for( ; i + 32 <= length; i += 32 ) {
+    v = _mm256_loadu_si256( (const __m256i *) ( data + i ) );
+    mask = (unsigned int) _mm256_movemask_epi8( _mm256_or_si256( _mm256_cmpeq_epi8( v, va ), _mm256_cmpeq_epi8( v, vb ) ) );
+    if( 0 != mask ) {
+      _mm256_zeroupper();
+      return( i + __builtin_ctz( mask ) );
+    }
+  }
+
+  _mm256_zeroupper();
+
+  return( i + _scalar_find2( data + i, length - i, a, b ) );
+}
+
+__attribute__(( target( "avx2" ) ))
+static size_t _avx2_find3( const unsigned char * data, size_t length, unsigned char a, unsigned char b, unsigned char c ) {
+  size_t i = 0;
+  unsigned int mask;
+  __m256i v, va, vb, vc;
+
+  if( length < TEXTSCAN_AVX2_MIN ) {
+    return( _scalar_find3( data, length, a, b, c ) );
+  }
+
+  va = _mm256_set1_epi8( (char) a );
+  vb = _mm256_set1_epi8( (char) b );
+  vc = _mm256_set1_epi8( (char) c );
+
+  for( ; i + 32 <= length; i += 32 ) {
+    v = _mm256_loadu_si256( (const __m256i *) ( data + i ) );
+    mask = (unsigned int) _mm256_movemask_epi8( _mm256_or_si256( _mm256_or_si256( _mm256_cmpeq_epi8( v, va ), _mm256_cmpeq_epi8( v, vb ) ),
+                                                                 _mm256_cmpeq_epi8( v, vc ) ) );
+    if( 0 != mask ) {
+      _mm256_zeroupper();
+      return( i + __builtin_ctz( mask ) );
+    }
+  }
+
+  _mm256_zeroupper();
+
+  return( i + _scalar_find3( data + i, length - i, a, b, c ) );
+}
+
+__attribute__(( target( "avx2" ) ))
+static size_t _avx2_span2( const unsigned char * data, size_t length, unsigned char a, unsigned char b ) {
+  size_t i = 0;
+  unsigned int mask;
+  __m256i v, va, vb;
+
+  if( length < TEXTSCAN_AVX2_MIN ) {
+    return( _scalar_span2( data, length, a, b ) );
+  }
+
+  va = _mm256_set1_epi8( (char) a );
+  vb = _mm256_set1_epi8( (char) b );
+
+  for( ; i + 32 <= length; i += 32 ) {
+    v = _mm256_loadu_si256( (const __m256i *) ( data + i ) );
+    mask = ~ (unsigned int) _mm256_movemask_epi8( _mm256_or_si256( _mm256_cmpeq_epi8( v, va ), _mm256_cmpeq_epi8( v, vb ) ) );
+    if( 0 != mask ) {
+      _mm256_zeroupper();
+      return( i + __builtin_ctz( mask ) );
+    }
+  }
+
+  _mm256_zeroupper();
+
+  return( i + _scalar_span2( data + i, length - i, a, b ) );
+}
+
+__attribute__(( target( "avx2" ) ))
+static size_t _avx2_count( const unsigned char * data, size_t length, unsigned char a, size_t * after ) {
+  size_t i = 0, count = 0, tail = 0;
+  unsigned int mask;
+  __m256i va;
+
+  if( length < TEXTSCAN_AVX2_MIN ) {
+    return( _scalar_count( data, length, a, after ) );
+  }
+
+  va = _mm256_set1_epi8( (char) a );
+
+  for( ; i + 32 <= length; i += 32 ) {
+    mask = (unsigned int) _mm256_movemask_epi8( _mm256_cmpeq_epi8( _mm256_loadu_si256( (const __m256i *) ( data + i ) ), va ) );
+    if( 0 != mask ) {
+      count += (size_t) __builtin_popcount( mask );
+      * after = i + 32 - (size_t) __builtin_clz( mask );
+    }
+  }
+
+  _mm256_zeroupper();
+
+  if( 0 != length - i ) {
+    count += _scalar_count( data + i, length - i, a, & tail );
+    if( 0 != tail ) {
+      * after = i + tail;
+    }
+  }
+
+  return( count );
+}
+
+__attribute__(( target( "avx2" ) ))
+static size_t _avx2_hex( const unsigned char * data, size_t length, unsigned char * out ) {
+  size_t i = 0;
+  __m256i v, lower, nine, zero, gap, low;
+
+  if( length < TEXTSCAN_AVX2_MIN ) {
+    return( _scalar_hex( data, length, out ) );
+  }
+
+  lower = _mm256_set1_epi8( 0x20 );
+  nine = _mm256_set1_epi8( '9' );
+  zero = _mm256_set1_epi8( '0' );
+  gap = _mm256_set1_epi8( 'a' - '0' - 10 );
+  low = _mm256_set1_epi16( 0x00FF );
+
+  for( ; i + 32 <= length; i += 32 ) {
+    v = _mm256_or_si256( _mm256_loadu_si256( (const __m256i *) ( data + i ) ), lower );
+    v = _mm256_sub_epi8( _mm256_sub_epi8( v, zero ), _mm256_and_si256( _mm256_cmpgt_epi8( v, nine ), gap ) );
+    v = _mm256_or_si256( _mm256_slli_epi16( _mm256_and_si256( v, low ), 4 ), _mm256_srli_epi16( v, 8 ) );
+    v = _mm256_permute4x64_epi64( _mm256_packus_epi16( v, v ), 0x08 );
+    _mm_storeu_si128( (__m128i *) ( out + ( i >> 1 ) ), _mm256_castsi256_si128( v ) );
+  }
+
+  _mm256_zeroupper();
+
+  return( ( i >> 1 ) + _scalar_hex( data + i, length - i, out + ( i >> 1 ) ) );
+}
+
+/* Thirty two base64 characters at a time. The high nibble of each
+** character (bumped by one for '/', which shares one with '+') picks the
+** offset that turns it into its sextet. Two multiply-adds pack each four
+** sextets into 24 bits of a 32 bit lane, and the shuffle and permute
+** squeeze the 24 useful octets to the front. The store writes 32 octets,
+** so the loop stops while there's still room after the last 24.
+*/
+
+__attribute__(( target( "avx2" ) ))
+static size_t _avx2_base64( const unsigned char * data, size_t length, unsigned char * out ) {
+  size_t i = 0, o = 0;
+  __m256i v, hi, nibble, slash, roll, pack, squeeze;
+
+  if( length < 2 * TEXTSCAN_AVX2_MIN ) {
+    return( _scalar_base64( data, length, out ) );
+  }
+
+  nibble = _mm256_set1_epi8( 0x0F );
+  slash = _mm256_set1_epi8( '/' );
+  roll = _mm256_setr_epi8( 0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0,
+                           0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0 );
+  pack = _mm256_setr_epi8( 2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1,
+                           2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1 );
+  squeeze = _mm256_setr_epi32( 0, 1, 2, 4, 5, 6, 7, 7 );
+
+  for( ; i + 64 <= length; i += 32, o += 24 ) {
+    v = _mm256_loadu_si256( (const __m256i *) ( data + i ) );
+    hi = _mm256_and_si256( _mm256_srli_epi32( v, 4 ), nibble );
+    hi = _mm256_add_epi8( hi, _mm256_cmpeq_epi8( v, slash ) );
+    v = _mm256_add_epi8( v, _mm256_shuffle_epi8( roll, hi ) );
+    v = _mm256_maddubs_epi16( v, _mm256_set1_epi32( 0x01400140 ) );
+    v = _mm256_madd_epi16( v, _mm256_set1_epi32( 0x00011000 ) );
+    v = _mm256_permutevar8x32_epi32( _mm256_shuffle_epi8( v, pack ), squeeze );
+    _mm256_storeu_si256( (__m256i *) ( out + o ), v );
+  }
+
+  _mm256_zeroupper();
+
+  return( o + _scalar_base64( data + i, length - i, out + o ) );
+}
+
+static const tTextScanOps _avx2_ops = {
+  TEXTSCAN_ISA_AVX2, _avx2_find2, _avx2_find3, _avx2_span2, _avx2_count, _avx2_hex, _avx2_base64
+};
+
+#endif /* TEXTSCAN_X86 */
+
+/* Function Definitions : NEON */
+
+#ifdef TEXTSCAN_NEON
+
+/* NEON doesn't have a movemask instruction. Narrowing each 16 bit lane by 4
+** bits leaves a 64 bit value with one nibble per input octet, which is just
+** as good for finding the first match.
+*/
+
+static unsigned long long _neon_mask( uint8x16_t match ) {
+  return( vget_lane_u64( vreinterpret_u64_u8( vshrn_n_u16( vreinterpretq_u16_u8( match ), 4 ) ), 0 ) );
+}
+
+static size_t _neon_find2( const unsigned char * data, size_t length, unsigned char a, unsigned char b ) {
+  size_t i = 0;
+  unsigned long long mask;
+  uint8x16_t v;
+  uint8x16_t va = vdupq_n_u8( a );
+  uint8x16_t vb = vdupq_n_u8( b );
+
+  for( ; i + 16 <= length; i += 16 ) {
+    v = vld1q_u8( data + i );
+    mask = _neon_mask( vorrq_u8( vceqq_u8( v, va ), vceqq_u8( v, vb ) ) );
+    if( 0 != mask ) {
+      return( i + ( __builtin_ctzll( mask ) >> 2 ) );
+    }
+  }
+
+  return( i + _scalar_find2( data + i, length - i, a, b ) );
+}
+
+static size_t _neon_find3( const unsigned char * data, size_t length, unsigned char a, unsigned char b, unsigned char c ) {
+  size_t i = 0;
+  unsigned long long mask;
+  uint8x16_t v;
+  uint8x16_t va = vdupq_n_u8( a );
+  uint8x16_t vb = vdupq_n_u8( b );
+  uint8x16_t vc = vdupq_n_u8( c );
+
+  for( ; i + 16 <= length; i += 16 ) {
+    v = vld1q_u8( data + i );
+    mask = _neon_mask( vorrq_u8( vorrq_u8( vceqq_u8( v, va ), vceqq_u8( v, vb ) ), vceqq_u8( v, vc ) ) );
+    if( 0 != mask ) {
+      return( i + ( __builtin_ctzll( mask ) >> 2 ) );
+    }
+  }
+
+  return( i + _scalar_find3( data + i, length - i, a, b, c ) );
+}
+
+static size_t _neon_span2( const unsigned char * data, size_t length, unsigned char a, unsigned char b ) {
+  size_t i = 0;
+  unsigned long long mask;
+  uint8x16_t v;
+  uint8x16_t va = vdupq_n_u8( a );
+  uint8x16_t vb = vdupq_n_u8( b );
+
+  for( ; i + 16 <= length; i += 16 ) {
+    v = vld1q_u8( data + i );
+    mask = ~ _neon_mask( vorrq_u8( vceqq_u8( v, va ), vceqq_u8( v, vb ) ) );
+    if( 0 != mask ) {
+      return( i + ( __builtin_ctzll( mask ) >> 2 ) );
+    }
+  }
+
+  return( i + _scalar_span2( data + i, length - i, a, b ) );
+}
+
+static size_t _neon_count( const unsigned char * data, size_t length, unsigned char a, size_t * after ) {
+  size_t i = 0, count = 0, tail = 0;
+  unsigned long long mask;
+  uint8x16_t va = vdupq_n_u8( a );
+
+  for( ; i + 16 <= length; i += 16 ) {
+    mask = _neon_mask( vceqq_u8( vld1q_u8( data + i ), va ) );
+    if( 0 != mask ) {
+      count += (size_t) ( __builtin_popcountll( mask ) >> 2 );
+      * after = i + 16 - (size_t) ( __builtin_clzll( mask ) >> 2 );
+    }
+  }
+
+  if( 0 != length - i ) {
+    count += _scalar_count( data + i, length - i, a, & tail );
+    if( 0 != tail ) {
+      * after = i + tail;
+    }
+  }
+
+  return( count );
+}
+
+static const tTextScanOps _neon_ops = {
+  TEXTSCAN_ISA_NEON, _neon_find2, _neon_find3, _neon_span2, _neon_count, _scalar_hex, _scalar_base64
+};
+
+#endif /* TEXTSCAN_NEON */
+
+/* Function Definitions : Dispatch */
+
+static const tTextScanOps * _ops = NULL;
+
+/* _current()
+**
+** Returns the selected implementation, picking one the first time through.
+** Two threads making their first call at once may both pick one, but they
+** pick the same one, and the release store and acquire load mean a thread
+** that sees the pointer also sees the table it points at.
+*/
+
+static const tTextScanOps * _current( void ) {
+  const tTextScanOps * ops = LOAD_OPS();
+
+  if( NULL == ops ) {
+    textscan_select( TEXTSCAN_ISA_AUTO );
+    ops = LOAD_OPS();
+  }
+
+  return( ops );
+}
+
+unsigned int textscan_select( unsigned int isa ) {
+  const tTextScanOps * ops = & _scalar_ops;
+
+#ifdef TEXTSCAN_X86
+  __builtin_cpu_init();
+
+  if( ( ( TEXTSCAN_ISA_AUTO == isa ) || ( TEXTSCAN_ISA_AVX2 == isa ) ) && __builtin_cpu_supports( "avx2" ) ) {
+    ops = & _avx2_ops;
+  } else if( ( ( TEXTSCAN_ISA_AUTO == isa ) || ( TEXTSCAN_ISA_SSE2 == isa ) ) && __builtin_cpu_supports( "sse2" ) ) {
+    ops = & _sse2_ops;
+  }
+#endif
+
+#ifdef TEXTSCAN_NEON
+  if( ( TEXTSCAN_ISA_AUTO == isa ) || ( TEXTSCAN_ISA_NEON == isa ) ) {
+    ops = & _neon_ops;
+  }
+#endif
+
+  STORE_OPS( ops );
+
+  return( ops->isa );
+}
+
+const char * textscan_name( unsigned int isa ) {
+  static const char * names [] = {
+    "auto",
+    "scalar",
+    "sse2",
+    "avx2",
+    "neon",
+    "--UNDEFINED--"
+  };
+
+  return( ( isa < TEXTSCAN_C_ISAS ) ? names[ isa ] : names[ TEXTSCAN_C_ISAS ] );
+}
+
+size_t textscan_find2( const unsigned char * data, size_t length, unsigned char a, unsigned char b ) {
+  return( _current()->find2( data, length, a, b ) );
+}
+
+size_t textscan_find3( const unsigned char * data, size_t length, unsigned char a, unsigned char b, unsigned char c ) {
+  return( _current()->find3( data, length, a, b, c ) );
+}
+
+size_t textscan_span2( const unsigned char * data, size_t length, unsigned char a, unsigned char b ) {
+  return( _current()->span2( data, length, a, b ) );
+}
+
+size_t textscan_count( const unsigned char * data, size_t length, unsigned char a, size_t * after ) {
+  * after = 0;
+
+  return( _current()->count( data, length, a, after ) );
+}
+
+size_t textscan_hex( const unsigned char * data, size_t length, unsigned char * out ) {
+  return( _current()->hex( data, length, out ) );
+}
+
+size_t textscan_base64( const unsigned char * data, size_t length, unsigned char * out ) {
+  return( _current()->base64( data, length, out ) );
+}
@@ -0,0 +1,94 @@
+/* textscan.h
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file provides the interface to the bulk octet scanner implemented in
+** textscan.c. The lexxer uses it to hop over long runs of "uninteresting"
+** octets (the bodies of strings and comments and runs of white space) 16 or
+** 32 octets at a time instead of running its state machine on each octet.
+** It also decodes base16 and base64 strings, 16 or 32 characters at a
+** time, for the lexxer's decoded binary mode.
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_TEXTSCAN
+#define _H_TEXTSCAN
+
+/* Macro Definitions : Instruction Set Selectors */
+
+#define TEXTSCAN_ISA_AUTO         0 /* Pick the best one this CPU supports */
+#define TEXTSCAN_ISA_SCALAR       1 /* Plain C, one octet at a time */
+#define TEXTSCAN_ISA_SSE2         2 /* x86 SSE2, 16 octets at a time */
+#define TEXTSCAN_ISA_AVX2         3 /* x86 AVX2, 32 octets at a time */
+#define TEXTSCAN_ISA_NEON         4 /* ARM NEON, 16 octets at a time */
+#define TEXTSCAN_C_ISAS           5
+
+/* File Includes */
+
+#include <stddef.h>
+
+/* Function Prototypes */
+
+/* textscan_find2() & textscan_find3()
+**
+** Return the offset of the first octet in data that's equal to one of the
+** delimiters passed in. If none of the delimiters are found, length is
+** returned.
+*/
+
+size_t textscan_find2( const unsigned char * data, size_t length, unsigned char a, unsigned char b );
+size_t textscan_find3( const unsigned char * data, size_t length, unsigned char a, unsigned char b, unsigned char c );
+
+/* textscan_span2()
+**
+** Returns the length of the prefix of data made up entirely of the octets a
+** and b. It's used to skip over runs of spaces and tabs.
+*/
+
+size_t textscan_span2( const unsigned char * data, size_t length, unsigned char a, unsigned char b );
+
+/* textscan_count()
+**
+** Returns how many octets in data are equal to a and sets after to the
+** offset just past the last one (or 0 if there aren't any.) The lexxer
+** uses it to count line feeds when it's compiled with -DTEXTLEX_LAZY_LINES.
+*/
+
+size_t textscan_count( const unsigned char * data, size_t length, unsigned char a, size_t * after );
+
+/* textscan_hex() & textscan_base64()
+**
+** Decode binary data the lexxer has already checked. textscan_hex() turns
+** each pair of hex digits in data into an octet and returns how many
+** octets it wrote (length / 2); an odd digit at the end is ignored.
+** textscan_base64() turns each group of four base64 characters into three
+** octets and returns how many it wrote (3 * ( length / 4 )); leftover
+** characters are ignored and there mustn't be any '=' padding. out can be
+** the same as data, since the octets never get ahead of the characters
+** they came from, and nothing is written past the octets returned.
+*/
+
+size_t textscan_hex( const unsigned char * data, size_t length, unsigned char * out );
+size_t textscan_base64( const unsigned char * data, size_t length, unsigned char * out );
+
+/* textscan_select()
+**
+** The scanner picks an implementation the first time it's called by asking
+** the CPU what it supports. Call this function to override that choice (the
+** benchmark does this to compare implementations.) If the instruction set
+** you ask for isn't available, you get the scalar implementation. Returns
+** the TEXTSCAN_ISA_* value actually selected.
+*/
+
+unsigned int textscan_select( unsigned int isa );
+
+/* textscan_name()
+**
+** Returns a printable name for a TEXTSCAN_ISA_* value.
+*/
+
+const char * textscan_name( unsigned int isa );
+
+#endif /* _H_TEXTSCAN */
@@ -0,0 +1,118 @@
+/* textstat.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file writes out the lexxer's statistics. Please see textstat.h for
+** more info.
+*/
+
+/* Macro Definitions */
+
+#define _POSIX_C_SOURCE 199309L
+
+/* File Includes */
+
+#include <string.h>
+#include <time.h>
+#include "textstat.h"
+
+/* Function Prototypes */
+
+static tTextLexErr _key( tTextEncContext * writer, const char * key );
+static tTextLexErr _counts( tTextEncContext * writer, const char * key, const char * const * names,
+                            const unsigned long long * counts, unsigned int count );
+
+/* Global Variables */
+
+static const char * const _states [ TEXTLEX_C_STATES ] = {
+  "start", "eollf", "comment", "annotate", "literal", "number", "float_start", "float", "exponent_start",
+  "exponent_neg", "exponent", "hex", "string", "string_escape", "base64", "base16_start", "base16_comment",
+  "base16_eollf"
+};
+
+static const char * const _tokens [ TEXTLEX_C_TOKENS ] = {
+  "end", "comment", "annotation", "literal", "integer", "float", "hex", "string", "base64", "array_open",
+  "array_close", "map_open", "map_close", "equals"
+};
+
+/* Function Definitions */
+
+unsigned long long textstat_ticks( void ) {
+#if defined( __x86_64__ ) || defined( __i386__ )
+  return( __rdtsc() );
+#else
+  struct timespec now;
+
+  clock_gettime( CLOCK_MONOTONIC, & now );
+
+  return( (unsigned long long) now.tv_sec * 1000000000ULL + (unsigned long long) now.tv_nsec );
+#endif
+}
+
+tTextLexErr textstat_write( tTextEncContext * writer, const tTextLexStats * stats ) {
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  unsigned long long lexer = stats->ticks - stats->callback_ticks - stats->overflow_ticks;
+
+  err |= textenc_token( writer, TEXTLEX_T_MAP_OPEN );
+
+  err |= _key( writer, "clock" );
+  err |= textenc_text( writer, TEXTLEX_T_STRING, (const unsigned char *) TEXTSTAT_CLOCK, strlen( TEXTSTAT_CLOCK ) );
+
+  err |= _counts( writer, "octets", _states, stats->octets, TEXTLEX_C_STATES );
+  err |= _counts( writer, "tokens", _tokens, stats->tokens, TEXTLEX_C_TOKENS );
+
+  err |= _key( writer, "overflows" );
+  err |= textenc_unsigned( writer, stats->overflows );
+  err |= _key( writer, "longest" );
+  err |= textenc_unsigned( writer, stats->longest );
+
+  err |= _key( writer, "ticks" );
+  err |= textenc_token( writer, TEXTLEX_T_MAP_OPEN );
+  err |= _key( writer, "total" );
+  err |= textenc_unsigned( writer, stats->ticks );
+  err |= _key( writer, "lexer" );
+  err |= textenc_unsigned( writer, lexer );
+  err |= _key( writer, "callback" );
+  err |= textenc_unsigned( writer, stats->callback_ticks );
+  err |= _key( writer, "overflow" );
+  err |= textenc_unsigned( writer, stats->overflow_ticks );
+  err |= textenc_token( writer, TEXTLEX_T_MAP_CLOSE );
+
+  err |= textenc_token( writer, TEXTLEX_T_MAP_CLOSE );
+
+  return( ( TEXTLEX_E_NOERR == err ) ? err : TEXTLEX_E_ERROR );
+}
+
+/* _key()
+**
+** Writes a key and the '=' after it.
+*/
+
+static tTextLexErr _key( tTextEncContext * writer, const char * key ) {
+  tTextLexErr err = textenc_text( writer, TEXTLEX_T_STRING, (const unsigned char *) key, strlen( key ) );
+
+  return( err | textenc_token( writer, TEXTLEX_T_EQUALS ) );
+}
+
+/* _counts()
+**
+** Writes the non-zero counts as a map from their names.
+*/
+
+static tTextLexErr _counts( tTextEncContext * writer, const char * key, const char * const * names,
+                            const unsigned long long * counts, unsigned int count ) {
+  tTextLexErr err = _key( writer, key );
+  unsigned int i;
+
+  err |= textenc_token( writer, TEXTLEX_T_MAP_OPEN );
+  for( i = 0; i < count; i++ ) {
+    if( 0 != counts[ i ] ) {
+      err |= _key( writer, names[ i ] );
+      err |= textenc_unsigned( writer, counts[ i ] );
+    }
+  }
+  err |= textenc_token( writer, TEXTLEX_T_MAP_CLOSE );
+
+  return( err );
+}
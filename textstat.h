@@ -0,0 +1,67 @@
+/* textstat.h
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file provides the interface to textstat.c, which writes out the
+** statistics a lexxer compiled with -DTEXTLEX_STATS keeps in its context
+** (see Statistics in textlex.h), and to the clock the lexxer times itself
+** with.
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_TEXTSTAT
+#define _H_TEXTSTAT
+
+/* Macro Definitions : Clock
+**
+** On x86 the lexxer reads the time stamp counter, which counts at a fixed
+** rate close to the CPU's nominal clock and takes a few dozen cycles to
+** read. Everywhere else it uses clock_gettime( CLOCK_MONOTONIC ), in
+** nanoseconds. TEXTSTAT_CLOCK says which.
+*/
+
+#if defined( __x86_64__ ) || defined( __i386__ )
+#include <x86intrin.h>
+#define TEXTSTAT_TICKS() __rdtsc()
+#define TEXTSTAT_CLOCK "tsc"
+#else
+#define TEXTSTAT_TICKS() textstat_ticks()
+#define TEXTSTAT_CLOCK "ns"
+#endif
+
+/* File Includes */
+
+#include "textlex.h"
+#include "textenc.h"
+
+/* Function Prototypes */
+
+/* textstat_ticks()
+**
+** Reads the clock TEXTSTAT_TICKS() reads.
+*/
+
+unsigned long long textstat_ticks( void );
+
+/* textstat_write()
+**
+** Writes stats as a DSD/Text map, with the writer in textenc.c:
+**
+**   {
+**     "clock" = "tsc"
+**     "octets" = { "start" = 1180 "comment" = 20530 ... }
+**     "tokens" = { "end" = 812 "comment" = 301 ... }
+**     "overflows" = 0
+**     "longest" = 118
+**     "ticks" = { "total" = 912811 "lexer" = 700213 "callback" = 212598 "overflow" = 0 }
+**   }
+**
+** States and token types that never came up are left out. It doesn't call
+** textenc_final(), so you can write it inside something else.
+*/
+
+tTextLexErr textstat_write( tTextEncContext * writer, const tTextLexStats * stats );
+
+#endif /* _H_TEXTSTAT */
@@ -0,0 +1,638 @@
+/* texttape.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file implements the DSD Tape Builder. Please see texttape.h for more
+** info.
+*/
+
+/* Macro Definitions */
+
+#define _BUFFER_SIZE  4096
+#define _WORDS        1024
+#define _TEXT         4096
+#define _FLOAT          64
+
+/* While a container is open, its open word doesn't know where it ends yet,
+** so its payload holds the index of the container it's in (shifted up two
+** bits) and what it expects next (in the bottom two.) That keeps the stack
+** of open containers on the tape itself. Arrays always expect an item; maps
+** go round from a key to '=' to a value.
+*/
+
+#define _EXPECT_ITEM     0
+#define _EXPECT_EQUALS   1
+#define _EXPECT_VALUE    2
+#define _EXPECT_MASK     3
+
+#define _WORD( t, p )    ( ( (tTextTapeWord) ( t ) << 56 ) | ( p ) )
+
+/* File Includes */
+
+#include <stdlib.h>
+#include <string.h>
+#include "texttape.h"
+
+/* Function Prototypes */
+
+static tTextLexErr _expect( tTextTapeContext * context );
+static tTextLexErr _open( tTextTapeContext * context, unsigned int type );
+static tTextLexErr _close( tTextTapeContext * context, unsigned int type );
+static tTextLexErr _atom( tTextTapeContext * context, unsigned int token, const unsigned char * data, size_t length );
+static tTextLexErr _base16( tTextTapeContext * context, const unsigned char * data, size_t length );
+static unsigned char * _room( tTextTapeContext * context, size_t length );
+static int _integer( const unsigned char * data, size_t length, long long * value );
+static int _hex( const unsigned char * data, size_t length, long long * value );
+static tTextTapeWord * _words( tTextTapeContext * context, size_t count );
+static tTextLexErr _span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+static tTextLexErr _grow( tTextLexContext * context );
+
+/* Function Definitions : Builder */
+
+tTextLexErr texttape_init( tTextTapeContext * context ) {
+  memset( context, 0, sizeof( tTextTapeContext ) );
+
+  do {
+    if( NULL == ( context->text.buffer = malloc( _BUFFER_SIZE ) ) ) {
+      break;
+    }
+
+    if( NULL == ( context->words = malloc( _WORDS * sizeof( tTextTapeWord ) ) ) ) {
+      break;
+    }
+
+    if( NULL == ( context->strings = malloc( _TEXT ) ) ) {
+      break;
+    }
+
+    context->text.size = _BUFFER_SIZE;
+    context->size = _WORDS;
+    context->capacity = _TEXT;
+
+    texttape_reset( context );
+
+    return( TEXTLEX_E_NOERR );
+  } while( 0 );
+
+  texttape_free( context );
+
+  return( TEXTLEX_E_MEMORY );
+}
+
+tTextLexErr texttape_update( tTextTapeContext * context, tTextLexBuffer * data, tTextLexCount length ) {
+  return( textlex_update( & context->text, data, length ) );
+}
+
+tTextLexErr texttape_final( tTextTapeContext * context ) {
+  tTextTapeWord * word;
+  tTextLexErr err;
+
+  if( TEXTLEX_E_NOERR != ( err = textlex_final( & context->text ) ) ) {
+    return( err );
+  }
+
+  if( TEXTTAPE_ROOT != context->open ) {
+    return( TEXTTAPE_E_UNCLOSED );
+  }
+
+  if( 0 != context->annotation ) {
+    context->count = context->annotation;
+    context->annotation = 0;
+  }
+
+  if( NULL == ( word = _words( context, 1 ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  context->words[ TEXTTAPE_ROOT ] = _WORD( TEXTTAPE_T_ARRAY, context->count - 1 );
+  * word = _WORD( TEXTTAPE_T_ARRAY_CLOSE, TEXTTAPE_ROOT );
+  context->words[ 0 ] = _WORD( TEXTLEX_T_END, context->count );
+
+  return( TEXTLEX_E_NOERR );
+}
+
+tTextLexErr texttape_token( tTextTapeContext * context, unsigned int token, const unsigned char * data, size_t length ) {
+  tTextTapeWord * open = & context->words[ context->open ];
+  tTextLexErr err;
+
+  switch( token ) {
+  case TEXTLEX_T_END:
+    return( TEXTLEX_E_NOERR );
+
+  case TEXTLEX_T_COMMENT:
+    /* A comment inside a base16 string splits it into two HEX tokens. */
+    context->base16 = ( TEXTLEX_S_BASE16_COMMENT == context->text.state );
+    return( TEXTLEX_E_NOERR );
+
+  case TEXTLEX_T_HEX:
+    if( context->base16 ) {
+      context->base16 = 0;
+      return( _base16( context, data, length ) );
+    }
+    break;
+
+  case TEXTLEX_T_ANNOTATION:
+    /* It goes right in front of the next value. If there's another
+    ** annotation first, that one wins.
+    */
+    if( 0 != context->annotation ) {
+      context->count = context->annotation;
+    }
+    context->annotation = context->count;
+    return( _atom( context, token, data, length ) );
+
+  case TEXTLEX_T_ARRAY_OPEN:
+  case TEXTLEX_T_MAP_OPEN:
+    return( _open( context, token ) );
+
+  case TEXTLEX_T_ARRAY_CLOSE:
+  case TEXTLEX_T_MAP_CLOSE:
+    return( _close( context, token ) );
+
+  case TEXTLEX_T_EQUALS:
+    if( ( TEXTTAPE_T_MAP != TEXTTAPE_TYPE( * open ) ) || ( _EXPECT_EQUALS != ( * open & _EXPECT_MASK ) ) ) {
+      return( TEXTTAPE_E_STRUCTURE );
+    }
+    * open = ( * open & ~ (tTextTapeWord) _EXPECT_MASK ) | _EXPECT_VALUE;
+    return( TEXTLEX_E_NOERR );
+
+  case TEXTLEX_T_LITERAL:
+  case TEXTLEX_T_INTEGER:
+  case TEXTLEX_T_FLOAT:
+  case TEXTLEX_T_STRING:
+  case TEXTLEX_T_BASE64:
+    break;
+
+  default:
+    return( TEXTLEX_E_ERROR );
+  }
+
+  if( TEXTLEX_E_NOERR != ( err = _expect( context ) ) ) {
+    return( err );
+  }
+
+  context->annotation = 0;
+
+  return( _atom( context, token, data, length ) );
+}
+
+void texttape_reset( tTextTapeContext * context ) {
+  textlex_init( & context->text, context->text.buffer, context->text.size );
+  textlex_extend( & context->text, & context->extension );
+  context->extension.span = _span;
+  context->text.overflow = _grow;
+
+  /* The document itself is an array. */
+
+  context->words[ 0 ] = _WORD( TEXTLEX_T_END, 0 );
+  context->words[ TEXTTAPE_ROOT ] = _WORD( TEXTTAPE_T_ARRAY, _EXPECT_ITEM );
+  context->count = 2;
+  context->length = 0;
+  context->open = TEXTTAPE_ROOT;
+  context->annotation = 0;
+  context->base16 = 0;
+}
+
+void texttape_free( tTextTapeContext * context ) {
+  free( context->text.buffer );
+  free( context->words );
+  free( context->strings );
+  context->text.buffer = NULL;
+  context->words = NULL;
+  context->strings = NULL;
+}
+
+/* Function Definitions : Walking the Tape */
+
+size_t texttape_value( const tTextTapeContext * tape, size_t index ) {
+  while( TEXTTAPE_T_ANNOTATION == TEXTTAPE_TYPE( tape->words[ index ] ) ) {
+    index += 2;
+  }
+
+  return( index );
+}
+
+const char * texttape_annotation( const tTextTapeContext * tape, size_t index ) {
+  const char * annotation = NULL;
+
+  for( ; TEXTTAPE_T_ANNOTATION == TEXTTAPE_TYPE( tape->words[ index ] ); index += 2 ) {
+    annotation = (const char *) tape->strings + TEXTTAPE_PAYLOAD( tape->words[ index ] );
+  }
+
+  return( annotation );
+}
+
+size_t texttape_skip( const tTextTapeContext * tape, size_t index ) {
+  tTextTapeWord word = tape->words[ index = texttape_value( tape, index ) ];
+
+  switch( TEXTTAPE_TYPE( word ) ) {
+  case TEXTTAPE_T_ARRAY:
+  case TEXTTAPE_T_MAP:
+    return( (size_t) TEXTTAPE_PAYLOAD( word ) + 1 );
+
+  case TEXTTAPE_T_ARRAY_CLOSE:
+  case TEXTTAPE_T_MAP_CLOSE:
+    return( index );
+
+  default:
+    return( index + 2 );
+  }
+}
+
+size_t texttape_find( const tTextTapeContext * tape, size_t map, const char * key ) {
+  size_t length, end, i, k;
+
+  if( ( 0 == map ) || ( TEXTTAPE_T_MAP != TEXTTAPE_TYPE( tape->words[ map = texttape_value( tape, map ) ] ) ) ) {
+    return( 0 );
+  }
+
+  length = strlen( key );
+  end = (size_t) TEXTTAPE_PAYLOAD( tape->words[ map ] );
+
+  for( i = map + 1; i < end; ) {
+    k = texttape_value( tape, i );
+    i = texttape_skip( tape, k );
+    if( ( TEXTTAPE_T_STRING == TEXTTAPE_TYPE( tape->words[ k ] ) ) && ( length == tape->words[ k + 1 ] ) &&
+        ( 0 == memcmp( key, tape->strings + TEXTTAPE_PAYLOAD( tape->words[ k ] ), length ) ) ) {
+      return( i );
+    }
+    i = texttape_skip( tape, i );
+  }
+
+  return( 0 );
+}
+
+size_t texttape_index( const tTextTapeContext * tape, size_t array, size_t item ) {
+  size_t end, i;
+
+  if( ( 0 == array ) || ( TEXTTAPE_T_ARRAY != TEXTTAPE_TYPE( tape->words[ array = texttape_value( tape, array ) ] ) ) ) {
+    return( 0 );
+  }
+
+  end = (size_t) TEXTTAPE_PAYLOAD( tape->words[ array ] );
+
+  for( i = array + 1; ( i < end ) && ( item > 0 ); item-- ) {
+    i = texttape_skip( tape, i );
+  }
+
+  return( ( i < end ) ? i : 0 );
+}
+
+int texttape_integer( const tTextTapeContext * tape, size_t index, long long * value ) {
+  tTextTapeWord word;
+
+  if( 0 == index ) {
+    return( 0 );
+  }
+
+  word = tape->words[ index = texttape_value( tape, index ) ];
+
+  switch( TEXTTAPE_TYPE( word ) ) {
+  case TEXTTAPE_T_INTEGER:
+    if( TEXTTAPE_IS_TEXT( word ) ) {
+      return( 0 );
+    }
+    * value = (long long) tape->words[ index + 1 ];
+    return( 1 );
+
+  case TEXTTAPE_T_HEX:
+    return( _hex( tape->strings + TEXTTAPE_PAYLOAD( word ), (size_t) tape->words[ index + 1 ], value ) );
+
+  default:
+    return( 0 );
+  }
+}
+
+int texttape_float( const tTextTapeContext * tape, size_t index, double * value ) {
+  tTextTapeWord word;
+
+  if( 0 == index ) {
+    return( 0 );
+  }
+
+  word = tape->words[ index = texttape_value( tape, index ) ];
+
+  if( ( TEXTTAPE_T_FLOAT != TEXTTAPE_TYPE( word ) ) && ( TEXTTAPE_T_INTEGER != TEXTTAPE_TYPE( word ) ) ) {
+    return( 0 );
+  }
+
+  if( TEXTTAPE_IS_TEXT( word ) ) {
+    * value = strtod( (const char *) tape->strings + TEXTTAPE_PAYLOAD( word ), NULL );
+  } else if( TEXTTAPE_T_FLOAT == TEXTTAPE_TYPE( word ) ) {
+    memcpy( value, & tape->words[ index + 1 ], sizeof( double ) );
+  } else {
+    * value = (double) (long long) tape->words[ index + 1 ];
+  }
+
+  return( 1 );
+}
+
+const unsigned char * texttape_text( const tTextTapeContext * tape, size_t index, size_t * length ) {
+  tTextTapeWord word;
+
+  if( 0 == index ) {
+    return( NULL );
+  }
+
+  word = tape->words[ index = texttape_value( tape, index ) ];
+
+  switch( TEXTTAPE_TYPE( word ) ) {
+  case TEXTTAPE_T_ARRAY:
+  case TEXTTAPE_T_ARRAY_CLOSE:
+  case TEXTTAPE_T_MAP:
+  case TEXTTAPE_T_MAP_CLOSE:
+    return( NULL );
+
+  case TEXTTAPE_T_INTEGER:
+  case TEXTTAPE_T_FLOAT:
+    if( ! TEXTTAPE_IS_TEXT( word ) ) {
+      return( NULL );
+    }
+    break;
+  }
+
+  * length = (size_t) tape->words[ index + 1 ];
+
+  return( tape->strings + TEXTTAPE_PAYLOAD( word ) );
+}
+
+/* Function Definitions : Static Functions */
+
+/* _expect()
+**
+** Checks that the container that's open was expecting a value and moves it
+** on to what it expects after one.
+*/
+
+static tTextLexErr _expect( tTextTapeContext * context ) {
+  tTextTapeWord * open = & context->words[ context->open ];
+  unsigned int expect = (unsigned int) ( * open & _EXPECT_MASK );
+
+  if( TEXTTAPE_T_MAP == TEXTTAPE_TYPE( * open ) ) {
+    if( _EXPECT_EQUALS == expect ) {
+      return( TEXTTAPE_E_STRUCTURE );
+    }
+    expect = ( _EXPECT_ITEM == expect ) ? _EXPECT_EQUALS : _EXPECT_ITEM;
+    * open = ( * open & ~ (tTextTapeWord) _EXPECT_MASK ) | expect;
+  }
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr _open( tTextTapeContext * context, unsigned int type ) {
+  tTextTapeWord * word;
+  tTextLexErr err;
+
+  if( TEXTLEX_E_NOERR != ( err = _expect( context ) ) ) {
+    return( err );
+  }
+
+  if( NULL == ( word = _words( context, 1 ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  * word = _WORD( type, ( (tTextTapeWord) context->open << 2 ) | _EXPECT_ITEM );
+  context->open = context->count - 1;
+  context->annotation = 0;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+static tTextLexErr _close( tTextTapeContext * context, unsigned int type ) {
+  tTextTapeWord open = context->words[ context->open ];
+  tTextTapeWord * word;
+
+  if( ( TEXTTAPE_ROOT == context->open ) || ( type != TEXTTAPE_TYPE( open ) + 1 ) || ( _EXPECT_ITEM != ( open & _EXPECT_MASK ) ) ) {
+    return( TEXTTAPE_E_STRUCTURE );
+  }
+
+  /* An annotation with nothing after it is dropped. */
+
+  if( 0 != context->annotation ) {
+    context->count = context->annotation;
+    context->annotation = 0;
+  }
+
+  if( NULL == ( word = _words( context, 1 ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  * word = _WORD( type, context->open );
+  context->words[ context->open ] = _WORD( type - 1, context->count - 1 );
+  context->open = (size_t) ( TEXTTAPE_PAYLOAD( open ) >> 2 );
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* _atom()
+**
+** Puts an atom on the tape. Integers and floats go on the tape themselves
+** if they can; everything else is copied into the text buffer.
+*/
+
+static tTextLexErr _atom( tTextTapeContext * context, unsigned int token, const unsigned char * data, size_t length ) {
+  tTextTapeWord * word;
+  unsigned char * text;
+  char number[ _FLOAT ];
+  long long integer;
+  double real;
+
+  if( NULL == ( word = _words( context, 2 ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  if( ( TEXTLEX_T_INTEGER == token ) && _integer( data, length, & integer ) ) {
+    word[ 0 ] = _WORD( token, 0 );
+    word[ 1 ] = (tTextTapeWord) integer;
+    return( TEXTLEX_E_NOERR );
+  }
+
+  if( ( TEXTLEX_T_FLOAT == token ) && ( length < _FLOAT ) ) {
+    memcpy( number, data, length );
+    number[ length ] = '\0';
+    real = strtod( number, NULL );
+    word[ 0 ] = _WORD( token, 0 );
+    memcpy( & word[ 1 ], & real, sizeof( double ) );
+    return( TEXTLEX_E_NOERR );
+  }
+
+  if( NULL == ( text = _room( context, length + 1 ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  if( length > 0 ) {
+    memcpy( text, data, length );
+  }
+  text[ length ] = '\0';
+
+  word[ 0 ] = _WORD( token, context->length );
+  if( ( TEXTLEX_T_INTEGER == token ) || ( TEXTLEX_T_FLOAT == token ) ) {
+    word[ 0 ] |= TEXTTAPE_F_TEXT;
+  }
+  word[ 1 ] = length;
+
+  context->length += length + 1;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* _base16()
+**
+** Adds the rest of a base16 string (after a comment) to the first part.
+** Comments don't go on the tape, so the first part is still the last atom
+** on the tape and the last text in the text buffer.
+*/
+
+static tTextLexErr _base16( tTextTapeContext * context, const unsigned char * data, size_t length ) {
+  unsigned char * text;
+
+  if( NULL == ( text = _room( context, length ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  if( length > 0 ) {
+    memcpy( text - 1, data, length );
+  }
+  text[ length - 1 ] = '\0';
+
+  context->words[ context->count - 1 ] += length;
+  context->length += length;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* _room()
+**
+** Makes sure there's room for length more octets in the text buffer and
+** returns a pointer to where they go.
+*/
+
+static unsigned char * _room( tTextTapeContext * context, size_t length ) {
+  unsigned char * strings;
+  size_t capacity;
+
+  if( context->length + length > context->capacity ) {
+    for( capacity = context->capacity * 2; context->length + length > capacity; capacity *= 2 );
+    if( NULL == ( strings = realloc( context->strings, capacity ) ) ) {
+      return( NULL );
+    }
+    context->strings = strings;
+    context->capacity = capacity;
+  }
+
+  return( context->strings + context->length );
+}
+
+/* _integer() and _hex()
+**
+** Convert an integer or the text of a hex string to a long long. They
+** return zero if it doesn't fit.
+*/
+
+static tTextLexErr _base16( tTextTapeContext * context, const unsigned char * data, size_t length );
+static unsigned char * _room( tTextTapeContext * context, size_t length );
+static int _integer( const unsigned char * data, size_t length, long long * value ) {
+  unsigned long long magnitude = 0;
+  unsigned long long limit = 9223372036854775807ULL;
+  unsigned int digit;
+  size_t i = 0;
+  int negative = 0;
+
+  if( 0 == length ) {
+    return( 0 );
+  }
+
+  if( '-' == data[ 0 ] ) {
+    negative = 1;
+    limit++;
+    i++;
+  }
+
+  if( i == length ) {
+    return( 0 );
+  }
+
+  for( ; i < length; i++ ) {
+    digit = data[ i ] - '0';
+    if( ( digit > 9 ) || ( magnitude > ( limit - digit ) / 10 ) ) {
+      return( 0 );
+    }
+    magnitude = magnitude * 10 + digit;
+  }
+
+  * value = negative ? (long long) ( 0ULL - magnitude ) : (long long) magnitude;
+
+  return( 1 );
+}
+
+static int _hex( const unsigned char * data, size_t length, long long * value ) {
+  unsigned long long magnitude = 0;
+  unsigned int digit;
+  size_t i;
+
+  if( ( 0 == length ) || ( length > 16 ) ) {
+    return( 0 );
+  }
+
+  for( i = 0; i < length; i++ ) {
+    digit = data[ i ];
+    digit = ( digit <= '9' ) ? digit - '0' : ( digit | 0x20 ) - 'a' + 10;
+    magnitude = ( magnitude << 4 ) | digit;
+  }
+
+  if( magnitude > 9223372036854775807ULL ) {
+    return( 0 );
+  }
+
+  * value = (long long) magnitude;
+
+  return( 1 );
+}
+
+/* _words()
+**
+** Makes room for count more words at the end of the tape and returns a
+** pointer to the first of them.
+*/
+
+static tTextTapeWord * _words( tTextTapeContext * context, size_t count ) {
+  tTextTapeWord * words;
+  size_t size;
+
+  if( context->count + count > context->size ) {
+    for( size = context->size * 2; context->count + count > size; size *= 2 );
+    if( NULL == ( words = realloc( context->words, size * sizeof( tTextTapeWord ) ) ) ) {
+      return( NULL );
+    }
+    context->words = words;
+    context->size = size;
+  }
+
+  words = & context->words[ context->count ];
+  context->count += count;
+
+  return( words );
+}
+
+static tTextLexErr _span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  return( texttape_token( (tTextTapeContext *) context, token, data, length ) );
+}
+
+static tTextLexErr _grow( tTextLexContext * context ) {
+  tTextLexBuffer * buffer;
+  tTextLexCount size = context->size * 2;
+
+  if( size <= context->size ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  if( NULL == ( buffer = realloc( context->buffer, size ) ) ) {
+    return( TEXTLEX_E_MEMORY );
+  }
+
+  context->buffer = buffer;
+  context->size = size;
+
+  return( TEXTLEX_E_NOERR );
+}
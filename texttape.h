@@ -0,0 +1,180 @@
+/* texttape.h
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file provides the interface to the DSD Tape Builder implemented in
+** texttape.c. It's an alternative to the document builder (see textdom.h)
+** for programs that scan documents rather than poke around in them. Instead
+** of a tree, the document becomes a "tape:" one array of 64-bit words with
+** the values in document order, plus one buffer holding the text of the
+** atoms. Every array and map on the tape knows where it ends, so skipping
+** one you're not interested in is a single jump.
+**
+** Each word has a type in its top eight bits and a payload in the rest.
+**
+**   ARRAY, MAP              payload is the index of the matching close word
+**   ARRAY_CLOSE, MAP_CLOSE  payload is the index of the matching open word
+**   INTEGER, FLOAT          the next word holds the value itself (an int64
+**                           or the bits of a double)
+**   everything else         payload is the offset of the text in the text
+**                           buffer; the next word holds its length
+**
+** So containers take one word at each end and atoms take two. An integer
+** that doesn't fit in 64 bits or a float too long to convert is kept as
+** text like the other atoms, with TEXTTAPE_F_TEXT set in its first word. An
+** annotation is stored as an atom right in front of the value it annotates.
+** Each text in the text buffer is followed by a '\0'.
+**
+** The first word on the tape is an END word whose payload is the number of
+** words on the tape. The second (at TEXTTAPE_ROOT) opens an array holding
+** the document's top level values and the last word closes it. Since no
+** value is ever at index zero, the lookups below use it to mean "not found."
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_TEXTTAPE
+#define _H_TEXTTAPE
+
+/* Macro Definitions : Error Codes
+**
+** These have the same values and meanings as TEXTDOM_E_STRUCTURE and
+** TEXTDOM_E_UNCLOSED.
+*/
+
+#define TEXTTAPE_E_STRUCTURE    100 /* A token where it doesn't belong */
+#define TEXTTAPE_E_UNCLOSED     101 /* Document ended inside an array or map */
+
+/* Macro Definitions : Word Types */
+
+#define TEXTTAPE_T_ANNOTATION   TEXTLEX_T_ANNOTATION
+#define TEXTTAPE_T_LITERAL      TEXTLEX_T_LITERAL
+#define TEXTTAPE_T_INTEGER      TEXTLEX_T_INTEGER
+#define TEXTTAPE_T_FLOAT        TEXTLEX_T_FLOAT
+#define TEXTTAPE_T_HEX          TEXTLEX_T_HEX
+#define TEXTTAPE_T_STRING       TEXTLEX_T_STRING
+#define TEXTTAPE_T_BASE64       TEXTLEX_T_BASE64
+#define TEXTTAPE_T_ARRAY        TEXTLEX_T_ARRAY_OPEN
+#define TEXTTAPE_T_ARRAY_CLOSE  TEXTLEX_T_ARRAY_CLOSE
+#define TEXTTAPE_T_MAP          TEXTLEX_T_MAP_OPEN
+#define TEXTTAPE_T_MAP_CLOSE    TEXTLEX_T_MAP_CLOSE
+
+/* Macro Definitions : Taking Words Apart */
+
+#define TEXTTAPE_ROOT           1
+
+#define TEXTTAPE_F_TEXT         0x0080000000000000ULL
+#define TEXTTAPE_TYPE( w )      ( (unsigned int) ( ( w ) >> 56 ) )
+#define TEXTTAPE_PAYLOAD( w )   ( ( w ) & 0x007FFFFFFFFFFFFFULL )
+#define TEXTTAPE_IS_TEXT( w )   ( 0 != ( ( w ) & TEXTTAPE_F_TEXT ) )
+
+/* File Includes */
+
+#include <stddef.h>
+#include "textlex.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+typedef unsigned long long tTextTapeWord;
+
+/* The tape builder's context. words and text are the tape and the text
+** buffer; count and length say how much of each is in use and size and
+** capacity how big they are. They only ever grow, so a context that's
+** reused for one message after another stops allocating memory once it's
+** seen the biggest one. open is the index of the innermost open container
+** and annotation is the index of an annotation that hasn't found its value
+** yet (or zero.) base16 is set between the two halves of a base16 string
+** with a comment in the middle.
+**
+** The lexxer's context comes first so the lexxer's callbacks can find the
+** tape.
+*/
+
+typedef struct _text_tape_context {
+  tTextLexContext   text;
+  tTextLexExtension extension;
+  tTextTapeWord   * words;
+  size_t            count;
+  size_t            size;
+  unsigned char   * strings;
+  size_t            length;
+  size_t            capacity;
+  size_t            open;
+  size_t            annotation;
+  unsigned int      base16;
+} tTextTapeContext;
+
+/* Function Prototypes */
+
+/* texttape_init()
+**
+** Sets up a tape builder. It allocates the tape, the text buffer and the
+** lexxer's buffer, so check for TEXTLEX_E_MEMORY.
+*/
+
+tTextLexErr texttape_init( tTextTapeContext * context );
+
+/* texttape_update() and texttape_final()
+**
+** Feed the builder a document, in as many pieces as you like, then call
+** texttape_final() to finish the tape. Lexxer errors come back just like
+** textlex_update() returns them; the builder adds TEXTTAPE_E_STRUCTURE and
+** TEXTTAPE_E_UNCLOSED.
+*/
+
+tTextLexErr texttape_update( tTextTapeContext * context, tTextLexBuffer * data, tTextLexCount length );
+tTextLexErr texttape_final( tTextTapeContext * context );
+
+/* texttape_token()
+**
+** This is what the builder calls for each token the lexxer produces (in span
+** mode.) Call it yourself to build a tape from some other token source, like
+** the binary lexxer.
+*/
+
+tTextLexErr texttape_token( tTextTapeContext * context, unsigned int token, const unsigned char * data, size_t length );
+
+/* texttape_reset() and texttape_free()
+**
+** Get the builder ready for the next document (keeping all its memory) or
+** give its memory back.
+*/
+
+void texttape_reset( tTextTapeContext * context );
+void texttape_free( tTextTapeContext * context );
+
+/* Walking the Tape
+**
+** These take the index of a value on a finished tape. If there are
+** annotations in front of the value, pass the index of the first one;
+** everything skips over them to get to the value.
+**
+** texttape_value() returns the index of the value itself, after any
+** annotations, and texttape_annotation() returns the text of the last
+** annotation in front of it (or NULL.)
+**
+** texttape_skip() returns the index of whatever follows the value, which is
+** the close word of the container it's in if it was the last one.
+**
+** texttape_find() returns the index of the value for the first string key
+** in a map that matches key, and texttape_index() the index of an item in
+** an array. They return zero (which is never the index of a value) if
+** there's no such thing.
+**
+** texttape_integer(), texttape_float() and texttape_text() get at atoms.
+** The first two return zero if the value isn't an integer (or a float or
+** integer) that fits; texttape_text() returns NULL for containers and
+** numbers that weren't kept as text.
+*/
+
+size_t texttape_value( const tTextTapeContext * tape, size_t index );
+const char * texttape_annotation( const tTextTapeContext * tape, size_t index );
+size_t texttape_skip( const tTextTapeContext * tape, size_t index );
+size_t texttape_find( const tTextTapeContext * tape, size_t map, const char * key );
+size_t texttape_index( const tTextTapeContext * tape, size_t array, size_t item );
+int texttape_integer( const tTextTapeContext * tape, size_t index, long long * value );
+int texttape_float( const tTextTapeContext * tape, size_t index, double * value );
+const unsigned char * texttape_text( const tTextTapeContext * tape, size_t index, size_t * length );
+
+#endif /* _H_TEXTTAPE */
@@ -0,0 +1,389 @@
+/* texttype.c
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file implements the DSD Typed Decoder. Please see texttype.h for
+** more info.
+*/
+
+/* Macro Definitions */
+
+/* Where a float's digits are going. */
+
+#define _PHASE_MANTISSA  0
+#define _PHASE_FRACTION  1
+#define _PHASE_EXPONENT  2
+
+/* TEXTTYPE_VARIANT() writes the accumulators for one type system: name is
+** the member of the context's magnitude union (and the prefix of the
+** functions), signed_type and unsigned_type are its widths, max is the
+** biggest signed_type and i and u are the members of tTextTypeValue's as
+** union it fills in. The magnitude is checked against the limit before
+** every digit is added, so it never needs to be any wider than the type
+** system's integers.
+*/
+
+#define TEXTTYPE_VARIANT( name, signed_type, unsigned_type, max, i, u ) \
+static tTextLexErr _##name##_digits( tTextTypeContext * context, const unsigned char * data, size_t length ) { \
+  unsigned_type magnitude = context->magnitude.name; \
+  unsigned_type limit = (unsigned_type) ( (unsigned_type) ( max ) + (unsigned_type) context->negative ); \
+  unsigned int digit; \
+  size_t k; \
+\
+  for( k = 0; k < length; k++ ) { \
+    if( '-' == data[ k ] ) { \
+      context->negative = 1; \
+      limit++; \
+      continue; \
+    } \
+    digit = (unsigned int) ( data[ k ] - '0' ); \
+    if( magnitude > ( limit - digit ) / 10 ) { \
+      return( TEXTTYPE_E_RANGE ); \
+    } \
+    magnitude = (unsigned_type) ( magnitude * 10 + digit ); \
+  } \
+\
+  context->magnitude.name = magnitude; \
+\
+  return( TEXTLEX_E_NOERR ); \
+} \
+\
+static tTextLexErr _##name##_nibbles( tTextTypeContext * context, const unsigned char * data, size_t length ) { \
+  unsigned_type magnitude = context->magnitude.name; \
+  size_t k; \
+\
+  for( k = 0; k < length; k++ ) { \
+    if( 0 != ( magnitude >> ( sizeof( unsigned_type ) * 8 - 4 ) ) ) { \
+      return( TEXTTYPE_E_RANGE ); \
+    } \
+    magnitude = (unsigned_type) ( ( magnitude << 4 ) | (unsigned_type) ( _hex[ data[ k ] ] - 1 ) ); \
+  } \
+\
+  context->magnitude.name = magnitude; \
+\
+  return( TEXTLEX_E_NOERR ); \
+} \
+\
+static void _##name##_finish( tTextTypeContext * context, tTextLexCount token, tTextTypeValue * value ) { \
+  unsigned_type magnitude = context->magnitude.name; \
+\
+  if( TEXTLEX_T_HEX == token ) { \
+    value->as.u = magnitude; \
+  } else if( context->negative && ( 0 != magnitude ) ) { \
+    value->as.i = (signed_type) ( - (signed_type) ( magnitude - 1 ) - 1 ); \
+  } else { \
+    value->as.i = (signed_type) magnitude; \
+  } \
+}
+
+/* File Includes */
+
+#include <float.h>
+#include <string.h>
+#include "texttype.h"
+
+/* Function Prototypes */
+
+static tTextLexErr _piece( tTextTypeContext * context, tTextLexCount token, const unsigned char * data, size_t length );
+static tTextLexErr _number( tTextTypeContext * context );
+static void _float( tTextTypeContext * context, const unsigned char * data, size_t length );
+static tTextLexErr _narrow( double real, tTextTypeValue * value );
+#ifndef TEXTTYPE_NO_MEDIUM
+static tTextLexErr _wide( double real, tTextTypeValue * value );
+#endif
+static tTextLexErr _span( tTextLexContext * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+
+/* Global Variables */
+
+/* Digit values plus one; zero means "not a digit." */
+
+static const unsigned char _hex[ 256 ] = {
+  [ '0' ] = 1, [ '1' ] = 2, [ '2' ] = 3, [ '3' ] = 4, [ '4' ] = 5, [ '5' ] = 6, [ '6' ] = 7, [ '7' ] = 8,
+  [ '8' ] = 9, [ '9' ] = 10, [ 'a' ] = 11, [ 'b' ] = 12, [ 'c' ] = 13, [ 'd' ] = 14, [ 'e' ] = 15, [ 'f' ] = 16,
+  [ 'A' ] = 11, [ 'B' ] = 12, [ 'C' ] = 13, [ 'D' ] = 14, [ 'E' ] = 15, [ 'F' ] = 16
+};
+
+/* Function Definitions : Type Systems */
+
+TEXTTYPE_VARIANT( tiny, int16_t, uint16_t, INT16_MAX, i16, u16 )
+
+static const tTextTypeOps _tiny_ops = {
+  TEXTTYPE_S_TINY, _tiny_digits, _tiny_nibbles, _tiny_finish, _narrow
+};
+
+#ifndef TEXTTYPE_NO_SMALL
+TEXTTYPE_VARIANT( small, int32_t, uint32_t, INT32_MAX, i32, u32 )
+
+static const tTextTypeOps _small_ops = {
+  TEXTTYPE_S_SMALL, _small_digits, _small_nibbles, _small_finish, _narrow
+};
+#endif
+
+#ifndef TEXTTYPE_NO_MEDIUM
+TEXTTYPE_VARIANT( medium, int64_t, uint64_t, INT64_MAX, i64, u64 )
+
+static const tTextTypeOps _medium_ops = {
+  TEXTTYPE_S_MEDIUM, _medium_digits, _medium_nibbles, _medium_finish, _wide
+};
+#endif
+
+/* Indexed by TEXTTYPE_S_*; NULL for the ones that aren't compiled in. */
+
+static const tTextTypeOps * const _systems [] = {
+  NULL,
+  & _tiny_ops,
+#ifndef TEXTTYPE_NO_SMALL
+  & _small_ops,
+#else
+  NULL,
+#endif
+#ifndef TEXTTYPE_NO_MEDIUM
+  & _medium_ops
+#else
+  NULL
+#endif
+};
+
+/* Function Definitions */
+
+void texttype_init( tTextTypeContext * context ) {
+  textlex_init( & context->text, context->buffer, TEXTTYPE_BUFFER );
+  textlex_extend( & context->text, & context->extension );
+  context->extension.span = _span;
+
+  context->value = NULL;
+  context->span = NULL;
+#ifndef TEXTTYPE_NO_MEDIUM
+  context->fallback = TEXTTYPE_S_MEDIUM;
+#elif ! defined( TEXTTYPE_NO_SMALL )
+  context->fallback = TEXTTYPE_S_SMALL;
+#else
+  context->fallback = TEXTTYPE_S_TINY;
+#endif
+  context->ops = NULL;
+  context->depth = 0;
+  context->pending = TEXTLEX_T_END;
+  context->last = TEXTLEX_T_END;
+}
+
+tTextLexErr texttype_update( tTextTypeContext * context, tTextLexBuffer * data, tTextLexCount length ) {
+  return( textlex_update( & context->text, data, length ) );
+}
+
+tTextLexErr texttype_final( tTextTypeContext * context ) {
+  return( textlex_final( & context->text ) );
+}
+
+unsigned int texttype_system( const unsigned char * data, size_t length ) {
+  if( 1 != length ) {
+    return( 0 );
+  }
+
+  switch( data[ 0 ] ) {
+  case 't':
+    return( TEXTTYPE_S_TINY );
+
+  case 's':
+    return( TEXTTYPE_S_SMALL );
+
+  case 'm':
+    return( TEXTTYPE_S_MEDIUM );
+  }
+
+  return( 0 );
+}
+
+/* _piece()
+**
+** Adds a piece of a number to what's been read of it so far. The first
+** piece starts it over, picking the fallback type system if the document
+** didn't pick one, and is remembered, so a float that arrives all at once
+** can be handed to textnum_float() whole.
+*/
+
+static tTextLexErr _piece( tTextTypeContext * context, tTextLexCount token, const unsigned char * data, size_t length ) {
+  if( TEXTLEX_T_END == context->pending ) {
+    if( ( NULL == context->ops ) && ( ( context->fallback > TEXTTYPE_S_MEDIUM ) || ( NULL == ( context->ops = _systems[ context->fallback ] ) ) ) ) {
+      return( TEXTTYPE_E_SYSTEM );
+    }
+    context->pending = token;
+    context->negative = 0;
+    context->phase = _PHASE_MANTISSA;
+    memset( & context->magnitude, 0, sizeof( context->magnitude ) );
+    memset( & context->digits, 0, sizeof( tTextNumDigits ) );
+    context->whole = data;
+    context->length = length;
+  } else {
+    context->whole = NULL;
+  }
+
+  switch( token ) {
+  case TEXTLEX_T_INTEGER:
+    return( context->ops->digits( context, data, length ) );
+
+  case TEXTLEX_T_HEX:
+    return( context->ops->nibbles( context, data, length ) );
+  }
+
+  _float( context, data, length );
+
+  return( TEXTLEX_E_NOERR );
+}
+
+/* _number()
+**
+** Called at the TEXTLEX_T_END after a number. Stores it in a value and
+** sends it to the value callback.
+*/
+
+static tTextLexErr _number( tTextTypeContext * context ) {
+  tTextTypeValue value;
+  tTextNumValue real;
+  tTextLexErr err;
+
+  value.system = context->ops->system;
+
+  if( TEXTLEX_T_FLOAT == context->pending ) {
+    textnum_float( & context->digits, context->whole, context->length, & real );
+    if( real.overflow ) {
+      return( TEXTTYPE_E_RANGE );
+    }
+    if( TEXTLEX_E_NOERR != ( err = context->ops->real( real.real, & value ) ) ) {
+      return( err );
+    }
+  } else {
+    context->ops->finish( context, context->pending, & value );
+  }
+
+  return( ( NULL != context->value ) ? context->value( context, context->pending, & value ) : TEXTLEX_E_NOERR );
+}
+
+/* _float()
+**
+** Adds a piece of a float to its digits. The lexxer has already checked
+** it, so a '-' is the mantissa's sign until there's been an 'e'.
+*/
+
+static void _float( tTextTypeContext * context, const unsigned char * data, size_t length ) {
+  size_t k;
+
+  for( k = 0; k < length; k++ ) {
+    switch( data[ k ] ) {
+    case '-':
+      context->digits.flags |= ( _PHASE_EXPONENT == context->phase ) ? TEXTNUM_F_EXPONENT_NEG : TEXTNUM_F_NEGATIVE;
+      break;
+
+    case '.':
+      context->phase = _PHASE_FRACTION;
+      break;
+
+    case 'e':
+    case 'E':
+      context->phase = _PHASE_EXPONENT;
+      break;
+
+    default:
+      if( _PHASE_EXPONENT == context->phase ) {
+        TEXTNUM_EXPONENT( & context->digits, data[ k ] );
+      } else {
+        TEXTNUM_DIGIT( & context->digits, data[ k ], _PHASE_FRACTION == context->phase );
+      }
+      break;
+    }
+  }
+}
+
+/* _narrow() and _wide()
+**
+** Store a float for the tiny and small type systems (which have to check
+** it fits in a float first) and for the medium one.
+*/
+
+static tTextLexErr _narrow( double real, tTextTypeValue * value ) {
+  if( ( real > FLT_MAX ) || ( real < - FLT_MAX ) ) {
+    return( TEXTTYPE_E_RANGE );
+  }
+
+  value->as.f32 = (float) real;
+
+  return( TEXTLEX_E_NOERR );
+}
+
+#ifndef TEXTTYPE_NO_MEDIUM
+static tTextLexErr _wide( double real, tTextTypeValue * value ) {
+  value->as.f64 = real;
+
+  return( TEXTLEX_E_NOERR );
+}
+#endif
+
+/* _span()
+**
+** Numbers go to _piece() and, at their TEXTLEX_T_END, _number(); the
+** tokens around them keep track of the depth and pick the type system.
+** Everything else goes straight to the span callback. Hex tokens are only
+** numbers if they came from the lexxer's TEXTLEX_S_HEX state; base16
+** strings are hex tokens too.
+*/
+
+static tTextLexErr _span( tTextLexContext * text, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length ) {
+  tTextTypeContext * context = (tTextTypeContext *) text;
+  tTextLexErr err = TEXTLEX_E_NOERR;
+  unsigned int system;
+  int ended = 0;
+
+  switch( token ) {
+  case TEXTLEX_T_INTEGER:
+  case TEXTLEX_T_FLOAT:
+    context->last = token;
+    return( _piece( context, token, data, length ) );
+
+  case TEXTLEX_T_HEX:
+    if( TEXTLEX_S_HEX == text->state ) {
+      context->last = token;
+      return( _piece( context, token, data, length ) );
+    }
+    break;
+
+  case TEXTLEX_T_END:
+    if( TEXTLEX_T_END != context->pending ) {
+      err = _number( context );
+      context->pending = TEXTLEX_T_END;
+    }
+    ended = ( 0 == context->depth ) && ( context->last >= TEXTLEX_T_LITERAL ) && ( context->last <= TEXTLEX_T_BASE64 );
+    break;
+
+  case TEXTLEX_T_ANNOTATION:
+    /* Only the first piece of an annotation can be a type system. */
+    if( ( 0 == context->depth ) && ( TEXTLEX_T_ANNOTATION != context->last ) && ( 0 != ( system = texttype_system( data, length ) ) ) &&
+        ( NULL == ( context->ops = _systems[ system ] ) ) ) {
+      return( TEXTTYPE_E_SYSTEM );
+    }
+    break;
+
+  case TEXTLEX_T_ARRAY_OPEN:
+  case TEXTLEX_T_MAP_OPEN:
+    context->depth++;
+    break;
+
+  case TEXTLEX_T_ARRAY_CLOSE:
+  case TEXTLEX_T_MAP_CLOSE:
+    ended = ( context->depth > 0 ) && ( 0 == --context->depth );
+    break;
+  }
+
+  context->last = token;
+
+  if( ( TEXTLEX_E_NOERR == err ) && ( NULL != context->span ) ) {
+    err = context->span( context, token, data, length );
+  }
+
+  /* The next document goes back to the fallback unless it says otherwise. */
+
+  if( ended ) {
+    context->ops = NULL;
+  }
+
+  return( err );
+}
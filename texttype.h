@@ -0,0 +1,168 @@
+/* texttype.h
+**
+** Copyright (C) 2026 Meadhbh S. Hamrick
+** Released under a BSD License; see license.txt for details.
+**
+** This file provides the interface to the DSD Typed Decoder implemented in
+** texttype.c. A document's leading annotation names the type system its
+** numbers belong to, and the decoder reads each number straight into a
+** value of that width:
+**
+**   @t  tiny    integers are int16_t, hex numbers uint16_t, floats float
+**   @s  small   integers are int32_t, hex numbers uint32_t, floats float
+**   @m  medium  integers are int64_t, hex numbers uint64_t, floats double
+**
+** Each type system has its own version of the digit accumulators, built
+** from the same macro, so the tiny one only ever does 16 bit arithmetic
+** and a number that doesn't fit is an error as soon as the lexxer hands
+** over the digit that makes it too big. Documents without one of these
+** annotations are read with the context's fallback type system.
+**
+** Compile with -DTEXTTYPE_NO_MEDIUM (and -DTEXTTYPE_NO_SMALL) to leave the
+** wider type systems out altogether, for targets where 32 or 64 bit
+** arithmetic is expensive. A document that asks for one that isn't there
+** gets TEXTTYPE_E_SYSTEM. Floats are converted by textnum.c, which always
+** works in 64 bits, and the tiny and small type systems narrow the double
+** it gives back.
+*/
+
+/* Macro Definitions */
+
+#ifndef _H_TEXTTYPE
+#define _H_TEXTTYPE
+
+/* Macro Definitions : Error Codes */
+
+#define TEXTTYPE_E_RANGE        106 /* A number too big for its type system */
+#define TEXTTYPE_E_SYSTEM       107 /* A type system that isn't compiled in */
+
+/* Macro Definitions : Type Systems */
+
+#define TEXTTYPE_S_TINY           1
+#define TEXTTYPE_S_SMALL          2
+#define TEXTTYPE_S_MEDIUM         3
+
+/* The lexxer's buffer. Numbers longer than this (or that straddle calls to
+** texttype_update()) arrive in pieces, which the accumulators carry on
+** from.
+*/
+
+#define TEXTTYPE_BUFFER          80
+
+/* File Includes */
+
+#include <stdint.h>
+#include "textlex.h"
+
+/* Structs, Typedefs, Unions & Enums */
+
+/* A number. system is the type system it was read in and the token says
+** whether it's an integer, a hex number or a float; between them they say
+** which member of as holds it.
+*/
+
+typedef struct {
+  unsigned int                    system;
+  union {
+    int16_t                       i16;
+    uint16_t                      u16;
+#ifndef TEXTTYPE_NO_SMALL
+    int32_t                       i32;
+    uint32_t                      u32;
+#endif
+    float                         f32;
+#ifndef TEXTTYPE_NO_MEDIUM
+    int64_t                       i64;
+    uint64_t                      u64;
+    double                        f64;
+#endif
+  } as;
+} tTextTypeValue;
+
+struct _text_type_context;
+
+/* The accumulators for one type system. There's one of these for each
+** type system compiled in; ops in the context points at the one the
+** document's annotation picked (or is NULL, for the fallback.) digits()
+** and nibbles() add a piece of an integer or hex number to the magnitude,
+** finish() stores it in value and real() narrows a float.
+*/
+
+typedef struct {
+  unsigned int                    system;
+  tTextLexErr                  ( *digits )( struct _text_type_context * context, const unsigned char * data, size_t length );
+  tTextLexErr                  ( *nibbles )( struct _text_type_context * context, const unsigned char * data, size_t length );
+  void                         ( *finish )( struct _text_type_context * context, tTextLexCount token, tTextTypeValue * value );
+  tTextLexErr                  ( *real )( double real, tTextTypeValue * value );
+} tTextTypeOps;
+
+/* The decoder's context. text is first, so the lexxer's callbacks can find
+** the rest of it. Set the value callback to get the numbers and the span
+** callback to get every other token (including the TEXTLEX_T_END after
+** each number); either can be NULL. fallback is the type system for
+** documents that don't say; texttype_init() sets it to the widest one
+** compiled in.
+**
+** The rest keeps track of the number being read while it arrives in
+** pieces (pending is its token, or TEXTLEX_T_END between numbers), and of
+** how deep in arrays and maps the decoder is and the last token it saw,
+** since only annotations at the top level pick a type system and the
+** fallback comes back when the value after them ends.
+*/
+
+typedef struct _text_type_context {
+  tTextLexContext                 text;
+  tTextLexExtension               extension;
+  tTextLexBuffer                  buffer[ TEXTTYPE_BUFFER ];
+  tTextLexErr                  ( *value )( struct _text_type_context * context, tTextLexCount token, const tTextTypeValue * value );
+  tTextLexErr                  ( *span )( struct _text_type_context * context, tTextLexCount token, tTextLexBuffer * data, tTextLexCount length );
+  unsigned int                    fallback;
+  const tTextTypeOps            * ops;
+  tTextLexCount                   depth;
+  tTextLexCount                   pending;
+  tTextLexCount                   last;
+  unsigned int                    negative;
+  unsigned int                    phase;
+  union {
+    uint16_t                      tiny;
+#ifndef TEXTTYPE_NO_SMALL
+    uint32_t                      small;
+#endif
+#ifndef TEXTTYPE_NO_MEDIUM
+    uint64_t                      medium;
+#endif
+  } magnitude;
+  tTextNumDigits                  digits;
+  const unsigned char           * whole;
+  size_t                          length;
+} tTextTypeContext;
+
+/* Function Prototypes */
+
+/* texttype_init()
+**
+** Gets a decoder ready for a stream of documents. Nothing is allocated, so
+** there's nothing to free.
+*/
+
+void texttype_init( tTextTypeContext * context );
+
+/* texttype_update() and texttype_final()
+**
+** Feed the decoder the documents, in as many pieces as you like, then call
+** texttype_final(). A number too big for its type system stops the lexxer
+** with TEXTTYPE_E_RANGE, with line and octet saying where it ended.
+*/
+
+tTextLexErr texttype_update( tTextTypeContext * context, tTextLexBuffer * data, tTextLexCount length );
+tTextLexErr texttype_final( tTextTypeContext * context );
+
+/* texttype_system()
+**
+** Returns the TEXTTYPE_S_* value for an annotation's text ("t", "s" or
+** "m"), or 0 if it isn't one.
+*/
+
+unsigned int texttype_system( const unsigned char * data, size_t length );
+
+#endif /* _H_TEXTTYPE */